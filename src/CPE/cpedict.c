@@ -49,11 +49,16 @@
 
 struct cpe_dict_model *cpe_dict_model_import_source(struct oscap_source *source)
 {
+	struct cpe_dict_model *dict = oscap_source_cache_load(source, OSCAP_CONTENT_CACHE_CPE_DICT,
+			(oscap_content_cache_read_func) cpe_dict_model_cache_read, (oscap_destruct_func) cpe_dict_model_free);
+	if (dict != NULL) {
+		dict->origin_file = oscap_strdup(oscap_source_readable_origin(source));
+		return dict;
+	}
 	xmlTextReader *reader = oscap_source_get_xmlTextReader(source);
 	if (reader == NULL) {
 		return NULL;
 	}
-	struct cpe_dict_model *dict = NULL;
 	struct cpe_parser_ctx *ctx = cpe_parser_ctx_from_reader(reader);
 	if (ctx) {
 		xmlTextReaderNextNode(cpe_parser_ctx_get_reader(ctx));
@@ -64,6 +69,8 @@ struct cpe_dict_model *cpe_dict_model_import_source(struct oscap_source *source)
 	}
 	cpe_parser_ctx_free(ctx);
 	xmlFreeTextReader(reader);
+	oscap_source_cache_store(source, OSCAP_CONTENT_CACHE_CPE_DICT,
+			(oscap_content_cache_write_func) cpe_dict_model_cache_write, dict);
 	return dict;
 }
 
@@ -174,8 +181,8 @@ char *cpe_dict_detect_version_priv(xmlTextReader *reader)
 {
 	char *version = NULL;
 	/* find root element */
-	while (xmlTextReaderRead(reader) == 1
-	       && xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT);
+	while (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT
+	       && xmlTextReaderRead(reader) == 1);
 
 	const char* elm_name = (const char *) xmlTextReaderConstLocalName(reader);
 	if (!elm_name || strcmp("cpe-list", elm_name)) {
@@ -33,6 +33,7 @@
 
 #include "common/_error.h"
 #include "common/list.h"
+#include "common/oscap_content_cache.h"
 #include "common/util.h"
 #include "common/xmlns_priv.h"
 #include "common/xmltext_priv.h"
@@ -315,5 +316,49 @@ void cpe23_item_free(struct cpe23_item *item)
 	}
 }
 
+void cpe23_item_cache_write(struct oscap_buffer *buf, const struct cpe23_item *item)
+{
+	oscap_cache_write_str(buf, item->name);
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(item->deprecations));
+	struct oscap_iterator *it = oscap_iterator_new(item->deprecations);
+	while (oscap_iterator_has_more(it)) {
+		const struct cpe_ext_deprecation *deprecation = oscap_iterator_next(it);
+		oscap_cache_write_str(buf, deprecation->date);
+		oscap_cache_write_u32(buf, oscap_list_get_itemcount(deprecation->deprecatedbys));
+		struct oscap_iterator *by_it = oscap_iterator_new(deprecation->deprecatedbys);
+		while (oscap_iterator_has_more(by_it)) {
+			const struct cpe_ext_deprecatedby *by = oscap_iterator_next(by_it);
+			oscap_cache_write_str(buf, by->name);
+			oscap_cache_write_u32(buf, by->type);
+		}
+		oscap_iterator_free(by_it);
+	}
+	oscap_iterator_free(it);
+}
+
+struct cpe23_item *cpe23_item_cache_read(struct oscap_cache_reader *reader)
+{
+	struct cpe23_item *item = cpe23_item_new();
+	item->name = oscap_cache_read_str(reader);
+	uint32_t count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct cpe_ext_deprecation *deprecation = cpe_ext_deprecation_new();
+		deprecation->date = oscap_cache_read_str(reader);
+		uint32_t by_count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+		for (uint32_t j = 0; j < by_count && !reader->failed; ++j) {
+			struct cpe_ext_deprecatedby *by = cpe_ext_deprecatedby_new();
+			by->name = oscap_cache_read_str(reader);
+			by->type = oscap_cache_read_u32(reader);
+			oscap_list_add(deprecation->deprecatedbys, by);
+		}
+		oscap_list_add(item->deprecations, deprecation);
+	}
+	if (reader->failed) {
+		cpe23_item_free(item);
+		return NULL;
+	}
+	return item;
+}
+
 OSCAP_IGETINS_GEN(cpe_ext_deprecatedby, cpe_ext_deprecation, deprecatedbys, deprecatedby);
 OSCAP_IGETINS_GEN(cpe_ext_deprecation, cpe23_item, deprecations, deprecation);
@@ -56,4 +56,21 @@ int cpe23_item_export(const struct cpe23_item *item, xmlTextWriterPtr writer);
 void cpe23_item_free(struct cpe23_item *item);
 
 
+struct oscap_buffer;
+struct oscap_cache_reader;
+
+/**
+ * Serialize cpe23-item representation for the content cache
+ * @param buf buffer to append to
+ * @param item cpe23-item to serialize
+ */
+void cpe23_item_cache_write(struct oscap_buffer *buf, const struct cpe23_item *item);
+
+/**
+ * Rebuild cpe23-item representation from the content cache
+ * @param reader cache entry reader
+ * @returns newly created cpe23-item or NULL if the entry is malformed
+ */
+struct cpe23_item *cpe23_item_cache_read(struct oscap_cache_reader *reader);
+
 #endif
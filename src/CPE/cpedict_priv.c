@@ -48,6 +48,7 @@
 
 #include "common/list.h"
 #include "common/elements.h"
+#include "common/oscap_content_cache.h"
 #include "common/text_priv.h"
 #include "common/util.h"
 #include "common/_error.h"
@@ -1464,3 +1465,263 @@ void cpe_itemmetadata_free(struct cpe_item_metadata *meta)
 /* End of free functions
  * */
 /***************************************************************************/
+
+/***************************************************************************/
+/* Serialization of CPE structures for the content cache
+ * The payload follows the structures field by field, lists are preceded by
+ * their item count.
+ * */
+
+static void cpe_name_cache_write(struct oscap_buffer *buf, const struct cpe_name *name)
+{
+	char *str = name != NULL ? cpe_name_get_as_str(name) : NULL;
+	oscap_cache_write_str(buf, str);
+	free(str);
+}
+
+static bool cpe_name_cache_read(struct oscap_cache_reader *reader, struct cpe_name **name)
+{
+	const char *str = oscap_cache_read_cstr(reader);
+	*name = NULL;
+	if (str != NULL) {
+		*name = cpe_name_new(str);
+		if (*name == NULL)
+			reader->failed = true;
+	}
+	return !reader->failed;
+}
+
+static void cpe_item_cache_write(struct oscap_buffer *buf, const struct cpe_item *item)
+{
+	cpe_name_cache_write(buf, item->name);
+	oscap_cache_write_text_list(buf, item->titles);
+	oscap_cache_write_bool(buf, item->deprecated);
+	oscap_cache_write_bool(buf, item->export.deprecated);
+	cpe_name_cache_write(buf, item->deprecated_by);
+	oscap_cache_write_str(buf, item->deprecation_date);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(item->references));
+	struct oscap_iterator *it = oscap_iterator_new(item->references);
+	while (oscap_iterator_has_more(it)) {
+		const struct cpe_reference *ref = oscap_iterator_next(it);
+		oscap_cache_write_str(buf, ref->href);
+		oscap_cache_write_str(buf, ref->content);
+	}
+	oscap_iterator_free(it);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(item->checks));
+	it = oscap_iterator_new(item->checks);
+	while (oscap_iterator_has_more(it)) {
+		const struct cpe_check *check = oscap_iterator_next(it);
+		oscap_cache_write_str(buf, check->system);
+		oscap_cache_write_str(buf, check->href);
+		oscap_cache_write_str(buf, check->identifier);
+	}
+	oscap_iterator_free(it);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(item->notes));
+	it = oscap_iterator_new(item->notes);
+	while (oscap_iterator_has_more(it)) {
+		const struct cpe_notes *notes = oscap_iterator_next(it);
+		oscap_cache_write_str(buf, notes->lang);
+		oscap_cache_write_string_list(buf, notes->notes);
+	}
+	oscap_iterator_free(it);
+
+	oscap_cache_write_bool(buf, item->metadata != NULL);
+	if (item->metadata != NULL) {
+		oscap_cache_write_str(buf, item->metadata->modification_date);
+		oscap_cache_write_str(buf, item->metadata->status);
+		oscap_cache_write_str(buf, item->metadata->nvd_id);
+		oscap_cache_write_str(buf, item->metadata->deprecated_by_nvd_id);
+	}
+
+	oscap_cache_write_bool(buf, item->cpe23_item != NULL);
+	if (item->cpe23_item != NULL)
+		cpe23_item_cache_write(buf, item->cpe23_item);
+}
+
+static struct cpe_item *cpe_item_cache_read(struct oscap_cache_reader *reader)
+{
+	struct cpe_item *item = cpe_item_new();
+
+	cpe_name_cache_read(reader, &item->name);
+	oscap_cache_read_text_list(reader, item->titles);
+	item->deprecated = oscap_cache_read_bool(reader);
+	item->export.deprecated = oscap_cache_read_bool(reader);
+	cpe_name_cache_read(reader, &item->deprecated_by);
+	item->deprecation_date = oscap_cache_read_str(reader);
+
+	uint32_t count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct cpe_reference *ref = cpe_reference_new();
+		ref->href = oscap_cache_read_str(reader);
+		ref->content = oscap_cache_read_str(reader);
+		oscap_list_add(item->references, ref);
+	}
+
+	count = oscap_cache_read_count(reader, 3 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct cpe_check *check = cpe_check_new();
+		check->system = oscap_cache_read_str(reader);
+		check->href = oscap_cache_read_str(reader);
+		check->identifier = oscap_cache_read_str(reader);
+		oscap_list_add(item->checks, check);
+	}
+
+	count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct cpe_notes *notes = cpe_notes_new();
+		notes->lang = oscap_cache_read_str(reader);
+		oscap_cache_read_string_list(reader, notes->notes);
+		oscap_list_add(item->notes, notes);
+	}
+
+	if (oscap_cache_read_bool(reader)) {
+		item->metadata = cpe_item_metadata_new();
+		item->metadata->modification_date = oscap_cache_read_str(reader);
+		item->metadata->status = oscap_cache_read_str(reader);
+		item->metadata->nvd_id = oscap_cache_read_str(reader);
+		item->metadata->deprecated_by_nvd_id = oscap_cache_read_str(reader);
+	}
+
+	if (oscap_cache_read_bool(reader))
+		item->cpe23_item = cpe23_item_cache_read(reader);
+
+	if (reader->failed) {
+		cpe_item_free(item);
+		return NULL;
+	}
+	return item;
+}
+
+/* The vendor tree is regular, every level holds a value and a list of the
+ * next level, the languages close it. */
+static void cpe_vendor_cache_write(struct oscap_buffer *buf, const struct cpe_vendor *vendor)
+{
+	oscap_cache_write_str(buf, vendor->value);
+	oscap_cache_write_text_list(buf, vendor->titles);
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(vendor->products));
+	OSCAP_FOR(cpe_product, product, cpe_vendor_get_products(vendor)) {
+		oscap_cache_write_str(buf, product->value);
+		oscap_cache_write_u32(buf, product->part);
+		oscap_cache_write_u32(buf, oscap_list_get_itemcount(product->versions));
+		OSCAP_FOR(cpe_version, version, cpe_product_get_versions(product)) {
+			oscap_cache_write_str(buf, version->value);
+			oscap_cache_write_u32(buf, oscap_list_get_itemcount(version->updates));
+			OSCAP_FOR(cpe_update, update, cpe_version_get_updates(version)) {
+				oscap_cache_write_str(buf, update->value);
+				oscap_cache_write_u32(buf, oscap_list_get_itemcount(update->editions));
+				OSCAP_FOR(cpe_edition, edition, cpe_update_get_editions(update)) {
+					oscap_cache_write_str(buf, edition->value);
+					oscap_cache_write_u32(buf, oscap_list_get_itemcount(edition->languages));
+					OSCAP_FOR(cpe_language, language, cpe_edition_get_languages(edition))
+						oscap_cache_write_str(buf, language->value);
+				}
+			}
+		}
+	}
+}
+
+static struct cpe_vendor *cpe_vendor_cache_read(struct oscap_cache_reader *reader)
+{
+	struct cpe_vendor *vendor = cpe_vendor_new();
+
+	vendor->value = oscap_cache_read_str(reader);
+	oscap_cache_read_text_list(reader, vendor->titles);
+	uint32_t products = oscap_cache_read_count(reader, 3 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < products && !reader->failed; ++i) {
+		struct cpe_product *product = cpe_product_new();
+		oscap_list_add(vendor->products, product);
+		product->value = oscap_cache_read_str(reader);
+		product->part = oscap_cache_read_u32(reader);
+		uint32_t versions = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+		for (uint32_t j = 0; j < versions && !reader->failed; ++j) {
+			struct cpe_version *version = cpe_version_new();
+			oscap_list_add(product->versions, version);
+			version->value = oscap_cache_read_str(reader);
+			uint32_t updates = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+			for (uint32_t k = 0; k < updates && !reader->failed; ++k) {
+				struct cpe_update *update = cpe_update_new();
+				oscap_list_add(version->updates, update);
+				update->value = oscap_cache_read_str(reader);
+				uint32_t editions = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+				for (uint32_t l = 0; l < editions && !reader->failed; ++l) {
+					struct cpe_edition *edition = cpe_edition_new();
+					oscap_list_add(update->editions, edition);
+					edition->value = oscap_cache_read_str(reader);
+					uint32_t languages = oscap_cache_read_count(reader, sizeof(uint32_t));
+					for (uint32_t m = 0; m < languages && !reader->failed; ++m) {
+						struct cpe_language *language = cpe_language_new();
+						language->value = oscap_cache_read_str(reader);
+						oscap_list_add(edition->languages, language);
+					}
+				}
+			}
+		}
+	}
+
+	if (reader->failed) {
+		cpe_vendor_free(vendor);
+		return NULL;
+	}
+	return vendor;
+}
+
+void cpe_dict_model_cache_write(struct oscap_buffer *buf, const struct cpe_dict_model *dict)
+{
+	oscap_cache_write_int(buf, dict->base_version);
+	oscap_cache_write_bool(buf, dict->generator != NULL);
+	if (dict->generator != NULL) {
+		oscap_cache_write_str(buf, dict->generator->product_name);
+		oscap_cache_write_str(buf, dict->generator->product_version);
+		oscap_cache_write_str(buf, dict->generator->schema_version);
+		oscap_cache_write_str(buf, dict->generator->timestamp);
+	}
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(dict->items));
+	OSCAP_FOR(cpe_item, item, cpe_dict_model_get_items(dict))
+		cpe_item_cache_write(buf, item);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(dict->vendors));
+	OSCAP_FOR(cpe_vendor, vendor, cpe_dict_model_get_vendors(dict))
+		cpe_vendor_cache_write(buf, vendor);
+}
+
+struct cpe_dict_model *cpe_dict_model_cache_read(struct oscap_cache_reader *reader)
+{
+	struct cpe_dict_model *dict = cpe_dict_model_new();
+
+	dict->base_version = oscap_cache_read_int(reader);
+	if (oscap_cache_read_bool(reader)) {
+		dict->generator = cpe_generator_new();
+		dict->generator->product_name = oscap_cache_read_str(reader);
+		dict->generator->product_version = oscap_cache_read_str(reader);
+		dict->generator->schema_version = oscap_cache_read_str(reader);
+		dict->generator->timestamp = oscap_cache_read_str(reader);
+	}
+
+	uint32_t count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct cpe_item *item = cpe_item_cache_read(reader);
+		if (item != NULL)
+			oscap_list_add(dict->items, item);
+	}
+
+	count = oscap_cache_read_count(reader, 3 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct cpe_vendor *vendor = cpe_vendor_cache_read(reader);
+		if (vendor != NULL)
+			oscap_list_add(dict->vendors, vendor);
+	}
+
+	if (reader->failed) {
+		cpe_dict_model_free(dict);
+		return NULL;
+	}
+	return dict;
+}
+
+/* End of cache serialization
+ * */
+/***************************************************************************/
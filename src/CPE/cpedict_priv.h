@@ -134,6 +134,23 @@ bool cpe_dict_model_set_origin_file(struct cpe_dict_model* dict, const char* ori
  */
 const char* cpe_dict_model_get_origin_file(const struct cpe_dict_model* dict);
 
+struct oscap_buffer;
+struct oscap_cache_reader;
+
+/**
+ * Serialize CPE dictionary for the content cache
+ * @param buf buffer to append to
+ * @param dict CPE dictionary
+ */
+void cpe_dict_model_cache_write(struct oscap_buffer *buf, const struct cpe_dict_model *dict);
+
+/**
+ * Rebuild CPE dictionary from the content cache, the origin file is left unset
+ * @param reader cache entry reader
+ * @return new CPE dictionary or NULL if the entry is malformed
+ */
+struct cpe_dict_model *cpe_dict_model_cache_read(struct oscap_cache_reader *reader);
+
 /* <cpe-list>
  * */
 struct cpe_dict_model {		// the main node
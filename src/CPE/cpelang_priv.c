@@ -41,6 +41,7 @@
 
 #include "common/util.h"
 #include "common/list.h"
+#include "common/oscap_content_cache.h"
 #include "common/text_priv.h"
 #include "common/elements.h"
 #include "common/_error.h"
@@ -218,8 +219,14 @@ struct cpe_platform *cpe_platform_new()
 
 struct cpe_lang_model *cpe_lang_model_import_source(struct oscap_source *source)
 {
+	struct cpe_lang_model *ret = oscap_source_cache_load(source, OSCAP_CONTENT_CACHE_CPE_LANG,
+			(oscap_content_cache_read_func) cpe_lang_model_cache_read, (oscap_destruct_func) cpe_lang_model_free);
+	if (ret != NULL) {
+		cpe_lang_model_set_origin_file(ret, oscap_source_readable_origin(source));
+		return ret;
+	}
+
 	xmlTextReaderPtr reader = oscap_source_get_xmlTextReader(source);
-	struct cpe_lang_model *ret = NULL;
 
 	if (reader != NULL) {
 		xmlTextReaderNextNode(reader);
@@ -229,6 +236,8 @@ struct cpe_lang_model *cpe_lang_model_import_source(struct oscap_source *source)
 		}
 	}
 	xmlFreeTextReader(reader);
+	oscap_source_cache_store(source, OSCAP_CONTENT_CACHE_CPE_LANG,
+			(oscap_content_cache_write_func) cpe_lang_model_cache_write, ret);
 	return ret;
 }
 
@@ -761,3 +770,129 @@ const char* cpe_lang_model_get_origin_file(const struct cpe_lang_model* lang_mod
 {
 	return lang_model->origin_file;
 }
+
+/***************************************************************************/
+/* Serialization of CPE language structures for the content cache
+ * */
+
+static void cpe_testexpr_cache_write(struct oscap_buffer *buf, const struct cpe_testexpr *expr)
+{
+	oscap_cache_write_u32(buf, expr->oper);
+	switch (expr->oper & CPE_LANG_OPER_MASK) {
+	case CPE_LANG_OPER_AND:
+	case CPE_LANG_OPER_OR:
+		oscap_cache_write_bool(buf, expr->meta.expr != NULL);
+		if (expr->meta.expr != NULL) {
+			oscap_cache_write_u32(buf, oscap_list_get_itemcount(expr->meta.expr));
+			struct oscap_iterator *it = oscap_iterator_new(expr->meta.expr);
+			while (oscap_iterator_has_more(it))
+				cpe_testexpr_cache_write(buf, oscap_iterator_next(it));
+			oscap_iterator_free(it);
+		}
+		break;
+	case CPE_LANG_OPER_MATCH: {
+		char *name = expr->meta.cpe != NULL ? cpe_name_get_as_str(expr->meta.cpe) : NULL;
+		oscap_cache_write_str(buf, name);
+		free(name);
+		break;
+	}
+	case CPE_LANG_OPER_CHECK:
+		oscap_cache_write_str(buf, expr->meta.check.system);
+		oscap_cache_write_str(buf, expr->meta.check.href);
+		oscap_cache_write_str(buf, expr->meta.check.id);
+		break;
+	default:
+		break;
+	}
+}
+
+static struct cpe_testexpr *cpe_testexpr_cache_read(struct oscap_cache_reader *reader)
+{
+	struct cpe_testexpr *ret = cpe_testexpr_new();
+	cpe_lang_oper_t oper = oscap_cache_read_u32(reader);
+
+	switch (oper & CPE_LANG_OPER_MASK) {
+	case CPE_LANG_OPER_AND:
+	case CPE_LANG_OPER_OR:
+		if (oscap_cache_read_bool(reader)) {
+			ret->meta.expr = oscap_list_new();
+			uint32_t count = oscap_cache_read_count(reader, sizeof(uint32_t));
+			for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+				struct cpe_testexpr *sub = cpe_testexpr_cache_read(reader);
+				if (sub != NULL)
+					oscap_list_add(ret->meta.expr, sub);
+			}
+		}
+		break;
+	case CPE_LANG_OPER_MATCH: {
+		const char *name = oscap_cache_read_cstr(reader);
+		if (name != NULL) {
+			ret->meta.cpe = cpe_name_new(name);
+			if (ret->meta.cpe == NULL)
+				reader->failed = true;
+		}
+		break;
+	}
+	case CPE_LANG_OPER_CHECK:
+		ret->meta.check.system = oscap_cache_read_str(reader);
+		ret->meta.check.href = oscap_cache_read_str(reader);
+		ret->meta.check.id = oscap_cache_read_str(reader);
+		break;
+	case CPE_LANG_OPER_INVALID:
+		break;
+	default:
+		reader->failed = true;
+		break;
+	}
+	/* set after the metadata so that the free function matches them */
+	ret->oper = oper;
+
+	if (reader->failed) {
+		cpe_testexpr_free(ret);
+		return NULL;
+	}
+	return ret;
+}
+
+void cpe_lang_model_cache_write(struct oscap_buffer *buf, const struct cpe_lang_model *lang)
+{
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(lang->platforms));
+	struct oscap_iterator *it = oscap_iterator_new(lang->platforms);
+	while (oscap_iterator_has_more(it)) {
+		const struct cpe_platform *platform = oscap_iterator_next(it);
+		oscap_cache_write_str(buf, platform->id);
+		oscap_cache_write_str(buf, platform->remark);
+		oscap_cache_write_text_list(buf, platform->titles);
+		oscap_cache_write_bool(buf, platform->expr != NULL);
+		if (platform->expr != NULL)
+			cpe_testexpr_cache_write(buf, platform->expr);
+	}
+	oscap_iterator_free(it);
+}
+
+struct cpe_lang_model *cpe_lang_model_cache_read(struct oscap_cache_reader *reader)
+{
+	struct cpe_lang_model *ret = cpe_lang_model_new();
+
+	uint32_t count = oscap_cache_read_count(reader, 3 * sizeof(uint32_t) + 1);
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct cpe_platform *platform = cpe_platform_new();
+		platform->id = oscap_cache_read_str(reader);
+		platform->remark = oscap_cache_read_str(reader);
+		oscap_cache_read_text_list(reader, platform->titles);
+		cpe_testexpr_free(platform->expr);
+		platform->expr = oscap_cache_read_bool(reader) ? cpe_testexpr_cache_read(reader) : NULL;
+		if (reader->failed || !cpe_lang_model_add_platform(ret, platform))
+			cpe_platform_free(platform);
+	}
+
+	if (reader->failed) {
+		cpe_lang_model_free(ret);
+		return NULL;
+	}
+	return ret;
+}
+
+/* End of cache serialization
+ * */
+/***************************************************************************/
@@ -121,6 +121,23 @@ void cpe_platform_export(const struct cpe_platform *platform, xmlTextWriterPtr w
  */
 void cpe_testexpr_export(const struct cpe_testexpr *expr, xmlTextWriterPtr writer);
 
+struct oscap_buffer;
+struct oscap_cache_reader;
+
+/**
+ * Serialize CPE language model for the content cache
+ * @param buf buffer to append to
+ * @param lang CPE language model
+ */
+void cpe_lang_model_cache_write(struct oscap_buffer *buf, const struct cpe_lang_model *lang);
+
+/**
+ * Rebuild CPE language model from the content cache, the origin file is left unset
+ * @param reader cache entry reader
+ * @return new CPE language model or NULL if the entry is malformed
+ */
+struct cpe_lang_model *cpe_lang_model_cache_read(struct oscap_cache_reader *reader);
+
 char *cpe_lang_model_detect_version_priv(xmlTextReader *reader);
 
 /**
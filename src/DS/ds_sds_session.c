@@ -29,6 +29,7 @@
 #include "common/elements.h"
 #include "common/_error.h"
 #include "common/list.h"
+#include "common/oscap_content_cache.h"
 #include "common/oscapxml.h"
 #include "common/public/oscap.h"
 #include "common/util.h"
@@ -36,6 +37,7 @@
 #include "ds_sds_session.h"
 #include "ds_sds_session_priv.h"
 #include "sds_index_priv.h"
+#include "sds_map_priv.h"
 #include "sds_priv.h"
 #include "source/oscap_source_priv.h"
 #include "source/public/oscap_source.h"
@@ -46,6 +48,8 @@
 struct ds_sds_session {
 	struct oscap_source *source;            ///< Source DataStream raw representation
 	struct ds_sds_index *index;             ///< Source DataStream index
+	struct ds_sds_map *map;                 ///< Source DataStream map, if the components are parsed on demand
+	bool map_tried;                         ///< Mapping of the source has been attempted
 	char *temp_dir;                         ///< Temp directory managed by the session
 	const char *target_dir;                 ///< Target directory for current split
 	const char *datastream_id;              ///< ID of selected datastream
@@ -84,6 +88,7 @@ void ds_sds_session_free(struct ds_sds_session *sds_session)
 {
 	if (sds_session != NULL) {
 		ds_sds_index_free(sds_session->index);
+		ds_sds_map_free(sds_session->map);
 		if (sds_session->temp_dir != NULL) {
 			oscap_acquire_cleanup_dir(&(sds_session->temp_dir));
 		}
@@ -108,7 +113,9 @@ void ds_sds_session_reset(struct ds_sds_session *session)
 struct ds_sds_index *ds_sds_session_get_sds_idx(struct ds_sds_session *session)
 {
 	if (session->index == NULL) {
-		xmlTextReader *reader = oscap_source_get_xmlTextReader(session->source);
+		struct ds_sds_map *map = ds_sds_session_get_map(session);
+		xmlTextReader *reader = map != NULL ? xmlReaderWalker(ds_sds_map_get_skeleton(map))
+			: oscap_source_get_xmlTextReader(session->source);
 		if (reader == NULL) {
 			return NULL;
 		}
@@ -251,7 +258,7 @@ struct oscap_source *ds_sds_session_select_tailoring(struct ds_sds_session *sess
 
 xmlNode *ds_sds_session_get_selected_datastream(struct ds_sds_session *session)
 {
-	xmlDoc *doc = oscap_source_get_xmlDoc(session->source);
+	xmlDoc *doc = ds_sds_session_get_xmlDoc(session);
 	xmlNode *datastream = ds_sds_lookup_datastream_in_collection(doc, session->datastream_id);
 	if (datastream == NULL) {
 		char *error = session->datastream_id ?
@@ -263,11 +270,52 @@ xmlNode *ds_sds_session_get_selected_datastream(struct ds_sds_session *session)
 	return datastream;
 }
 
+struct ds_sds_map *ds_sds_session_get_map(struct ds_sds_session *session)
+{
+	if (!session->map_tried) {
+		session->map_tried = true;
+		// No point in mapping the file once its full DOM has been built
+		const char *filepath = oscap_source_get_unparsed_filepath(session->source);
+		if (filepath != NULL) {
+			uint8_t digest[OSCAP_CONTENT_CACHE_DIGEST_SIZE];
+			bool cached = oscap_content_cache_dir() != NULL && oscap_source_get_digest(session->source, digest);
+			session->map = ds_sds_map_new(filepath, cached ? digest : NULL);
+		}
+	}
+	return session->map;
+}
+
 xmlDoc *ds_sds_session_get_xmlDoc(struct ds_sds_session *session)
 {
+	struct ds_sds_map *map = ds_sds_session_get_map(session);
+	if (map != NULL) {
+		return ds_sds_map_get_skeleton(map);
+	}
 	return oscap_source_get_xmlDoc(session->source);
 }
 
+bool ds_sds_session_may_be_signed(struct ds_sds_session *session)
+{
+	struct ds_sds_map *map = ds_sds_session_get_map(session);
+	if (map == NULL) {
+		// Only the full DOM can tell
+		return true;
+	}
+	// The signature of a data stream collection is a child of its root
+	xmlNode *root = xmlDocGetRootElement(ds_sds_map_get_skeleton(map));
+	for (xmlNode *child = root->children; child != NULL; child = child->next) {
+		if (child->type == XML_ELEMENT_NODE && child->ns != NULL &&
+				oscap_streq((const char *) child->name, "Signature") &&
+				oscap_streq((const char *) child->ns->href, "http://www.w3.org/2000/09/xmldsig#")) {
+			// Evaluate the very DOM the signature is going to be verified on
+			ds_sds_map_free(session->map);
+			session->map = NULL;
+			return true;
+		}
+	}
+	return false;
+}
+
 int ds_sds_session_register_component_source(struct ds_sds_session *session, const char *relative_filepath, struct oscap_source *component)
 {
 	if (!oscap_htable_add(session->component_sources, relative_filepath, component)) {
@@ -33,7 +33,21 @@
 
 
 xmlNode *ds_sds_session_get_selected_datastream(struct ds_sds_session *session);
+/**
+ * Get the DOM of the source DataStream. If the components are parsed on demand,
+ * it doesn't contain the component contents, see ds_sds_session_get_map().
+ */
 xmlDoc *ds_sds_session_get_xmlDoc(struct ds_sds_session *session);
+/**
+ * Get the map of the source DataStream, or NULL if the full DOM is used.
+ */
+struct ds_sds_map *ds_sds_session_get_map(struct ds_sds_session *session);
+/**
+ * Check whether the source DataStream may carry a signature. It returns false
+ * only if it's known without building the full DOM that there is none. A signed
+ * DataStream isn't parsed on demand anymore, the full DOM is used instead.
+ */
+bool ds_sds_session_may_be_signed(struct ds_sds_session *session);
 int ds_sds_session_register_component_source(struct ds_sds_session *session, const char *relative_filepath, struct oscap_source *component);
 const char *ds_sds_session_get_target_dir(struct ds_sds_session *session);
 struct oscap_htable *ds_sds_session_get_component_sources(struct ds_sds_session *session);
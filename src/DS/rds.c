@@ -32,6 +32,7 @@
 #include "common/util.h"
 #include "common/list.h"
 #include "common/debug_priv.h"
+#include "common/elements.h"
 
 #include "ds_common.h"
 #include "ds_rds_session.h"
@@ -40,6 +41,7 @@
 #include "sds_priv.h"
 #include "source/public/oscap_source.h"
 #include "source/oscap_source_priv.h"
+#include "OVAL/results/oval_results_impl.h"
 
 #include <sys/stat.h>
 #include <time.h>
@@ -661,16 +663,8 @@ static void ds_rds_add_xccdf_test_results(xmlDocPtr doc, xmlNodePtr reports,
 	}
 }
 
-static int _ds_rds_create_from_dom(xmlDocPtr *ret, xmlDocPtr sds_doc,
-		xmlDocPtr tailoring_doc, const char *tailoring_filepath,
-		char *tailoring_doc_timestamp, xmlDocPtr xccdf_result_file_doc,
-		struct oscap_htable *oval_result_sources,
-		struct oscap_htable *oval_result_mapping,
-		struct oscap_htable *arf_report_mapping,
-		bool clone)
+static xmlDocPtr ds_rds_new_collection(xmlNodePtr *relationships, xmlNodePtr *report_requests, xmlNodePtr *assets)
 {
-	*ret = NULL;
-
 	xmlDocPtr doc = xmlNewDoc(BAD_CAST "1.0");
 	xmlNodePtr root = xmlNewNode(NULL, BAD_CAST "asset-report-collection");
 	xmlDocSetRootElement(doc, root);
@@ -681,15 +675,35 @@ static int _ds_rds_create_from_dom(xmlDocPtr *ret, xmlDocPtr sds_doc,
 	xmlNsPtr core_ns = xmlNewNs(root, BAD_CAST core_ns_uri, BAD_CAST "core");
 	xmlNewNs(root, BAD_CAST ai_ns_uri, BAD_CAST "ai");
 
-	xmlNodePtr relationships = xmlNewNode(core_ns, BAD_CAST "relationships");
-	xmlNewNs(relationships, BAD_CAST arfvocab_ns_uri, BAD_CAST "arfvocab");
-	xmlAddChild(root, relationships);
+	*relationships = xmlNewNode(core_ns, BAD_CAST "relationships");
+	xmlNewNs(*relationships, BAD_CAST arfvocab_ns_uri, BAD_CAST "arfvocab");
+	xmlAddChild(root, *relationships);
+
+	*report_requests = xmlNewNode(arf_ns, BAD_CAST "report-requests");
+	xmlAddChild(root, *report_requests);
+
+	*assets = xmlNewNode(arf_ns, BAD_CAST "assets");
+	xmlAddChild(root, *assets);
+
+	return doc;
+}
 
-	xmlNodePtr report_requests = xmlNewNode(arf_ns, BAD_CAST "report-requests");
-	xmlAddChild(root, report_requests);
+static int _ds_rds_create_from_dom(xmlDocPtr *ret, xmlDocPtr sds_doc,
+		xmlDocPtr tailoring_doc, const char *tailoring_filepath,
+		char *tailoring_doc_timestamp, xmlDocPtr xccdf_result_file_doc,
+		struct oscap_htable *oval_result_sources,
+		struct oscap_htable *oval_result_mapping,
+		struct oscap_htable *arf_report_mapping,
+		bool clone)
+{
+	*ret = NULL;
 
-	xmlNodePtr assets = xmlNewNode(arf_ns, BAD_CAST "assets");
-	xmlAddChild(root, assets);
+	xmlNodePtr relationships = NULL;
+	xmlNodePtr report_requests = NULL;
+	xmlNodePtr assets = NULL;
+	xmlDocPtr doc = ds_rds_new_collection(&relationships, &report_requests, &assets);
+	xmlNodePtr root = xmlDocGetRootElement(doc);
+	xmlNsPtr arf_ns = root->ns;
 
 	xmlNodePtr report_request = xmlNewNode(arf_ns, BAD_CAST "report-request");
 	xmlSetProp(report_request, BAD_CAST "id", BAD_CAST "collection1");
@@ -863,6 +877,98 @@ struct oscap_source *ds_rds_create_source(struct oscap_source *sds_source, struc
 	return oscap_source_new_from_xmlDoc(rds_doc, target_file);
 }
 
+int ds_rds_export_stream(struct oscap_source *sds_source, struct oscap_source *xccdf_result_source, struct oscap_htable *oval_results_models, struct oscap_htable *arf_report_mapping, const char *target_file)
+{
+	xmlDoc *sds_doc = oscap_source_get_xmlDoc(sds_source);
+	if (sds_doc == NULL) {
+		return -1;
+	}
+
+	xmlDoc *result_file_doc = oscap_source_get_xmlDoc(xccdf_result_source);
+	if (result_file_doc == NULL) {
+		return -1;
+	}
+
+	// The document gets everything but the data stream and the OVAL results,
+	// those two are written straight from their sources.
+	xmlNodePtr relationships = NULL;
+	xmlNodePtr report_requests = NULL;
+	xmlNodePtr assets = NULL;
+	xmlDocPtr doc = ds_rds_new_collection(&relationships, &report_requests, &assets);
+	xmlNodePtr root = xmlDocGetRootElement(doc);
+	xmlNsPtr arf_ns = root->ns;
+
+	xmlNodePtr report_request = xmlNewChild(report_requests, arf_ns, BAD_CAST "report-request", NULL);
+	xmlSetProp(report_request, BAD_CAST "id", BAD_CAST "collection1");
+	xmlNodePtr arf_content = xmlNewChild(report_request, arf_ns, BAD_CAST "content", NULL);
+
+	xmlNodePtr reports = xmlNewChild(root, arf_ns, BAD_CAST "reports", NULL);
+	ds_rds_add_xccdf_test_results(doc, reports, result_file_doc,
+			relationships, assets, "collection1", arf_report_mapping);
+
+	xmlTextWriterPtr writer = oscap_xml_writer_new_filename(target_file);
+	if (writer == NULL) {
+		xmlFreeDoc(doc);
+		return -1;
+	}
+
+	int ret = 0;
+	oscap_xml_writer_start_node(writer, root);
+	oscap_xml_writer_write_node(writer, doc, relationships);
+	oscap_xml_writer_start_node(writer, report_requests);
+	oscap_xml_writer_start_node(writer, report_request);
+	oscap_xml_writer_start_node(writer, arf_content);
+
+	xmlNodePtr sds_root = xmlDocGetRootElement(sds_doc);
+	oscap_xml_writer_start_node(writer, sds_root);
+	for (xmlNodePtr child = sds_root->children; child != NULL; child = child->next) {
+		if (xmlIsBlankNode(child))
+			continue;
+		oscap_xml_writer_write_node(writer, sds_doc, child);
+	}
+	oscap_xml_writer_end_node(writer); // data-stream-collection
+	oscap_xml_writer_end_node(writer); // content
+	oscap_xml_writer_end_node(writer); // report-request
+	oscap_xml_writer_end_node(writer); // report-requests
+
+	oscap_xml_writer_write_node(writer, doc, assets);
+
+	oscap_xml_writer_start_node(writer, reports);
+	oscap_xml_writer_flush_children(writer, doc, reports);
+
+	struct oscap_htable_iterator *hit = oscap_htable_iterator_new(arf_report_mapping);
+	while (ret == 0 && oscap_htable_iterator_has_more(hit)) {
+		const struct oscap_htable_item *report_mapping_item = oscap_htable_iterator_next(hit);
+		const char *oval_filename = report_mapping_item->key;
+		const char *report_id = report_mapping_item->value;
+		struct oval_results_model *results_model = oscap_htable_get(oval_results_models, oval_filename);
+		if (results_model == NULL) {
+			oscap_seterr(OSCAP_EFAMILY_OSCAP, "No OVAL results available for '%s'.", oval_filename);
+			ret = -1;
+			break;
+		}
+
+		xmlNodePtr report = xmlNewChild(reports, arf_ns, BAD_CAST "report", NULL);
+		xmlSetProp(report, BAD_CAST "id", BAD_CAST report_id);
+		xmlNodePtr report_content = xmlNewChild(report, arf_ns, BAD_CAST "content", NULL);
+		oscap_xml_writer_start_node(writer, report);
+		oscap_xml_writer_start_node(writer, report_content);
+		ret = oval_results_model_write(results_model, NULL, writer);
+		oscap_xml_writer_end_node(writer); // content
+		oscap_xml_writer_end_node(writer); // report
+		xmlUnlinkNode(report);
+		xmlFreeNode(report);
+	}
+	oscap_htable_iterator_free(hit);
+	oscap_xml_writer_end_node(writer); // reports
+
+	if (oscap_xml_writer_close(writer) != 1) {
+		ret = -1;
+	}
+	xmlFreeDoc(doc);
+	return ret;
+}
+
 int ds_rds_create(const char* sds_file, const char* xccdf_result_file, const char** oval_result_files, const char* target_file)
 {
 	struct oscap_source *sds_source = oscap_source_new_from_file(sds_file);
@@ -37,6 +37,16 @@ xmlNode *ds_rds_lookup_container(xmlDocPtr doc, const char *container_name);
 xmlNode *ds_rds_lookup_component(xmlDocPtr doc, const char *container_name, const char *component_name, const char *id);
 int ds_rds_dump_arf_content(struct ds_rds_session *session, const char *container_name, const char *component_name, const char *content_id);
 struct oscap_source *ds_rds_create_source(struct oscap_source *sds_source, struct oscap_source *tailoring_source, struct oscap_source *xccdf_result_source, struct oscap_htable *oval_result_sources, struct oscap_htable *oval_result_mapping, struct oscap_htable *arf_report_mapping, const char *target_file);
+/**
+ * Write the result data stream to target_file as it is assembled, without
+ * building it in memory. The source data stream is copied component by
+ * component and the OVAL reports are serialized from the results models.
+ * Tailoring is not supported, use ds_rds_create_source() when it's needed.
+ * @param oval_results_models mapping OVAL filename to struct oval_results_model
+ * @param arf_report_mapping mapping OVAL filename to ARF report ID
+ * @return 0 on success, -1 on failure
+ */
+int ds_rds_export_stream(struct oscap_source *sds_source, struct oscap_source *xccdf_result_source, struct oscap_htable *oval_results_models, struct oscap_htable *arf_report_mapping, const char *target_file);
 xmlNodePtr ds_rds_create_report(xmlDocPtr target_doc, xmlNodePtr reports_node, xmlDocPtr source_doc, const char* report_id);
 
 int ds_rds_create_from_dom(xmlDocPtr* ret, xmlDocPtr sds_doc, xmlDocPtr tailoring_doc, const char* tailoring_filepath, char *tailoring_doc_timestamp, xmlDocPtr xccdf_result_file_doc, struct oscap_htable* oval_result_sources, struct oscap_htable* oval_result_mapping, struct oscap_htable *arf_report_mapping);
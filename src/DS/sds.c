@@ -34,12 +34,15 @@
 #include "ds_common.h"
 #include "ds_sds_session_priv.h"
 #include "sds_priv.h"
+#include "sds_map_priv.h"
 
 #include "common/debug_priv.h"
 #include "common/_error.h"
 #include "common/util.h"
 #include "common/list.h"
 #include "common/oscap_acquire.h"
+#include "common/oscap_content_cache.h"
+#include "source/doc_type_priv.h"
 #include "source/oscap_source_priv.h"
 #include "source/public/oscap_source.h"
 #include "oscap_helpers.h"
@@ -291,8 +294,83 @@ static xmlNodePtr ds_sds_get_component_root_by_id(xmlDoc *doc, const char* compo
 	return node_get_child_element(component, NULL);
 }
 
+struct ds_sds_deferred_component {
+	struct ds_sds_map *map;
+	char *component_id;
+};
+
+static void ds_sds_deferred_component_free(void *arg)
+{
+	struct ds_sds_deferred_component *component = arg;
+	ds_sds_map_free(component->map);
+	free(component->component_id);
+	free(component);
+}
+
+static xmlDoc *ds_sds_deferred_component_load(void *arg)
+{
+	struct ds_sds_deferred_component *component = arg;
+	xmlDoc *doc = ds_sds_map_load_component(component->map, component->component_id);
+	if (doc == NULL) {
+		return NULL;
+	}
+	xmlDoc *new_doc = NULL;
+	xmlNodePtr inner_root = ds_sds_get_component_root_by_id(doc, component->component_id);
+	if (inner_root != NULL) {
+		new_doc = ds_doc_from_foreign_node(inner_root, doc);
+	}
+	xmlFreeDoc(doc);
+	return new_doc;
+}
+
+/*
+ * With the content cache in use, the component isn't parsed until its DOM is
+ * needed, its model may come from the cache instead. Returns false if the
+ * component has to be parsed right away.
+ */
+static bool ds_sds_register_deferred(struct ds_sds_session *session, struct ds_sds_map *map, const char *component_id, const char *relative_filepath)
+{
+	uint8_t digest[OSCAP_CONTENT_CACHE_DIGEST_SIZE];
+	oscap_document_type_t scap_type;
+
+	if (oscap_content_cache_dir() == NULL || !ds_sds_map_get_component_digest(map, component_id, digest)) {
+		return false;
+	}
+	const char *root_name = ds_sds_map_get_component_root(map, component_id);
+	if (root_name == NULL || oscap_determine_document_type_name(root_name, &scap_type) != 0) {
+		// Scripts and unknown documents are handled right away
+		return false;
+	}
+
+	struct ds_sds_deferred_component *component = malloc(sizeof(struct ds_sds_deferred_component));
+	component->map = ds_sds_map_ref(map);
+	component->component_id = oscap_strdup(component_id);
+	struct oscap_source *component_source = oscap_source_new_deferred(relative_filepath, scap_type, digest,
+			ds_sds_deferred_component_load, component, ds_sds_deferred_component_free);
+	if (ds_sds_session_register_component_source(session, relative_filepath, component_source) != 0) {
+		oscap_source_free(component_source);
+	}
+	return true;
+}
+
 static int ds_sds_dump_local_component(const char* component_id, struct ds_sds_session *session, const char *target_filename_dirname, const char *relative_filepath)
 {
+	struct ds_sds_map *map = ds_sds_session_get_map(session);
+	if (map != NULL) {
+		if (ds_sds_register_deferred(session, map, component_id, relative_filepath)) {
+			return 0;
+		}
+		// Parse just this component from the mapped file
+		xmlDoc *doc = ds_sds_map_load_component(map, component_id);
+		if (doc == NULL) {
+			return -1;
+		}
+		xmlNodePtr inner_root = ds_sds_get_component_root_by_id(doc, component_id);
+		int ret = ds_sds_register_component(session, doc, inner_root, component_id, target_filename_dirname, relative_filepath);
+		xmlFreeDoc(doc);
+		return ret;
+	}
+
 	xmlDoc *doc = ds_sds_session_get_xmlDoc(session);
 
 	xmlNodePtr inner_root = ds_sds_get_component_root_by_id(doc, component_id);
@@ -1316,7 +1394,7 @@ int ds_sds_compose_from_xccdf(const char *xccdf_file, const char *target_datastr
 char *ds_sds_detect_version(xmlTextReader *reader)
 {
 	/* find root element */
-	while (xmlTextReaderRead(reader) == 1 && xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT)
+	while (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT && xmlTextReaderRead(reader) == 1)
 		;
 
 	char *element_name = (char *) xmlTextReaderConstLocalName(reader);
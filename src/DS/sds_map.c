@@ -0,0 +1,533 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#ifdef HAVE_MMAN_H
+#include <sys/mman.h>
+#endif
+#ifndef OS_WINDOWS
+#include <unistd.h>
+#endif
+
+#include <libxml/parser.h>
+#include <libxml/parserInternals.h>
+#include <libxml/SAX2.h>
+
+#include "common/_error.h"
+#include "common/debug_priv.h"
+#include "common/list.h"
+#include "common/oscap_content_cache.h"
+#include "common/util.h"
+#include "source/bz2_priv.h"
+#include "oscap_helpers.h"
+#include "sds_map_priv.h"
+
+struct ds_sds_map_range {
+	size_t start;
+	size_t end;
+	char *root_name;                        ///< Local name of the component root element
+};
+
+struct ds_sds_map {
+	int refs;
+	char *filepath;
+	char *data;                             ///< The mapped file
+	size_t size;
+	xmlDoc *skeleton;                       ///< DOM of the collection without component contents
+	struct oscap_htable *components;        ///< component ID -> struct ds_sds_map_range
+	struct ds_sds_map_range root_tag;       ///< Start tag of the collection root element
+	char *root_end_tag;                     ///< End tag of the collection root element
+	bool digest_known;
+	uint8_t digest[OSCAP_CONTENT_CACHE_DIGEST_SIZE]; ///< Digest of the file, the key of the content cache
+};
+
+static void ds_sds_map_range_free(void *ptr)
+{
+	struct ds_sds_map_range *range = ptr;
+	if (range == NULL)
+		return;
+	free(range->root_name);
+	free(range);
+}
+
+/* Input of a parser made of up to three consecutive pieces of memory */
+struct ds_sds_map_input {
+	const char *piece[3];
+	size_t size[3];
+	int current;
+	size_t pos;
+};
+
+static int ds_sds_map_input_read(void *context, char *buffer, int len)
+{
+	struct ds_sds_map_input *input = context;
+	int ret = 0;
+
+	while (ret < len && input->current < 3) {
+		size_t left = input->size[input->current] - input->pos;
+		if (left == 0) {
+			input->current++;
+			input->pos = 0;
+			continue;
+		}
+		size_t n = left < (size_t) (len - ret) ? left : (size_t) (len - ret);
+		memcpy(buffer + ret, input->piece[input->current] + input->pos, n);
+		input->pos += n;
+		ret += n;
+	}
+	return ret;
+}
+
+static int ds_sds_map_input_close(void *context)
+{
+	return 0;
+}
+
+static xmlParserCtxtPtr ds_sds_map_parser_new(xmlSAXHandler *sax, struct ds_sds_map_input *input)
+{
+	xmlParserCtxtPtr ctxt = xmlCreateIOParserCtxt(sax, NULL, ds_sds_map_input_read,
+			ds_sds_map_input_close, input, XML_CHAR_ENCODING_NONE);
+	if (ctxt != NULL)
+		xmlCtxtUseOptions(ctxt, 0);
+	return ctxt;
+}
+
+/* State of the streaming pass over the whole file */
+struct ds_sds_map_state {
+	struct ds_sds_map *map;
+	int depth;                      ///< Depth of the current element, the root has 1
+	int component_depth;            ///< Depth of the component being skipped, 0 if none
+	bool benchmark_stub;            ///< The Benchmark of the component is being kept
+	char *component_id;
+	char *component_root;           ///< Local name of the first element in the component
+	size_t component_start;
+	bool failed;
+};
+
+/* Position of the '<' which starts the tag the parser is at */
+static size_t ds_sds_map_tag_start(const struct ds_sds_map *map, xmlParserCtxtPtr ctxt)
+{
+	long pos = xmlByteConsumed(ctxt);
+	size_t i = pos < 0 ? 0 : (size_t) pos;
+
+	if (i > map->size)
+		i = map->size;
+	while (i > 0 && map->data[i - 1] != '<')
+		--i;
+	return i > 0 ? i - 1 : 0;
+}
+
+/* Position following the '>' which ends the tag the parser is at */
+static size_t ds_sds_map_tag_end(const struct ds_sds_map *map, xmlParserCtxtPtr ctxt)
+{
+	long pos = xmlByteConsumed(ctxt);
+	size_t i = pos < 0 ? 0 : (size_t) pos;
+
+	if (i > 0 && i <= map->size && map->data[i - 1] == '>')
+		return i;
+	while (i < map->size && map->data[i] != '>')
+		++i;
+	return i < map->size ? i + 1 : map->size;
+}
+
+static char *ds_sds_map_get_attribute(const xmlChar **attributes, int nb_attributes, const char *name)
+{
+	for (int i = 0; i < nb_attributes; ++i) {
+		const xmlChar **attr = attributes + i * 5;
+		/* localname, prefix, URI, value, end */
+		if (attr[1] == NULL && strcmp((const char *) attr[0], name) == 0)
+			return strndup((const char *) attr[3], attr[4] - attr[3]);
+	}
+	return NULL;
+}
+
+static void ds_sds_map_start_element(void *ctx, const xmlChar *localname, const xmlChar *prefix,
+		const xmlChar *URI, int nb_namespaces, const xmlChar **namespaces,
+		int nb_attributes, int nb_defaulted, const xmlChar **attributes)
+{
+	xmlParserCtxtPtr ctxt = ctx;
+	struct ds_sds_map_state *state = ctxt->_private;
+	struct ds_sds_map *map = state->map;
+
+	state->depth++;
+	if (state->component_depth > 0) {
+		if (state->depth == state->component_depth + 1 && state->component_root == NULL)
+			state->component_root = oscap_strdup((const char *) localname);
+		if (state->depth == state->component_depth + 1 && strcmp((const char *) localname, "Benchmark") == 0) {
+			state->benchmark_stub = true;
+			xmlSAX2StartElementNs(ctx, localname, prefix, URI, nb_namespaces, namespaces,
+					nb_attributes, nb_defaulted, attributes);
+		}
+		return;
+	}
+
+	xmlSAX2StartElementNs(ctx, localname, prefix, URI, nb_namespaces, namespaces,
+			nb_attributes, nb_defaulted, attributes);
+	if (state->depth == 1) {
+		map->root_tag.start = ds_sds_map_tag_start(map, ctxt);
+		map->root_tag.end = ds_sds_map_tag_end(map, ctxt);
+		map->root_end_tag = prefix != NULL ?
+			oscap_sprintf("</%s:%s>", (const char *) prefix, (const char *) localname) :
+			oscap_sprintf("</%s>", (const char *) localname);
+	} else if (state->depth == 2 && (strcmp((const char *) localname, "component") == 0 ||
+			strcmp((const char *) localname, "extended-component") == 0)) {
+		state->component_depth = state->depth;
+		state->component_start = ds_sds_map_tag_start(map, ctxt);
+		state->component_id = ds_sds_map_get_attribute(attributes, nb_attributes, "id");
+	}
+}
+
+static void ds_sds_map_end_element(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI)
+{
+	xmlParserCtxtPtr ctxt = ctx;
+	struct ds_sds_map_state *state = ctxt->_private;
+	struct ds_sds_map *map = state->map;
+
+	if (state->component_depth == 0) {
+		xmlSAX2EndElementNs(ctx, localname, prefix, URI);
+	} else if (state->depth == state->component_depth + 1 && state->benchmark_stub) {
+		state->benchmark_stub = false;
+		xmlSAX2EndElementNs(ctx, localname, prefix, URI);
+	} else if (state->depth == state->component_depth) {
+		struct ds_sds_map_range *range = malloc(sizeof(struct ds_sds_map_range));
+		range->start = state->component_start;
+		range->end = ds_sds_map_tag_end(map, ctxt);
+		range->root_name = state->component_root;
+		state->component_root = NULL;
+		/* The first component of given ID wins, like in lookup_component_in_collection() */
+		if (state->component_id == NULL || !oscap_htable_add(map->components, state->component_id, range))
+			ds_sds_map_range_free(range);
+		free(state->component_id);
+		state->component_id = NULL;
+		state->component_depth = 0;
+		xmlSAX2EndElementNs(ctx, localname, prefix, URI);
+	}
+	state->depth--;
+}
+
+static void ds_sds_map_characters(void *ctx, const xmlChar *ch, int len)
+{
+	struct ds_sds_map_state *state = ((xmlParserCtxtPtr) ctx)->_private;
+
+	if (state->component_depth == 0)
+		xmlSAX2Characters(ctx, ch, len);
+}
+
+static void ds_sds_map_cdata_block(void *ctx, const xmlChar *value, int len)
+{
+	struct ds_sds_map_state *state = ((xmlParserCtxtPtr) ctx)->_private;
+
+	if (state->component_depth == 0)
+		xmlSAX2CDataBlock(ctx, value, len);
+}
+
+static void ds_sds_map_comment(void *ctx, const xmlChar *value)
+{
+	struct ds_sds_map_state *state = ((xmlParserCtxtPtr) ctx)->_private;
+
+	if (state->component_depth == 0)
+		xmlSAX2Comment(ctx, value);
+}
+
+static void ds_sds_map_processing_instruction(void *ctx, const xmlChar *target, const xmlChar *data)
+{
+	struct ds_sds_map_state *state = ((xmlParserCtxtPtr) ctx)->_private;
+
+	if (state->component_depth == 0)
+		xmlSAX2ProcessingInstruction(ctx, target, data);
+}
+
+static void ds_sds_map_internal_subset(void *ctx, const xmlChar *name, const xmlChar *ExternalID, const xmlChar *SystemID)
+{
+	struct ds_sds_map_state *state = ((xmlParserCtxtPtr) ctx)->_private;
+
+	/* Entities declared in a DTD couldn't be resolved in the components */
+	state->failed = true;
+	xmlStopParser(ctx);
+}
+
+static void ds_sds_map_error(void *ctx, xmlErrorPtr error)
+{
+	/* The file is parsed again as a whole, which reports the error */
+	dD("Can't map the Source DataStream: %s", error->message);
+}
+
+struct ds_sds_map *ds_sds_map_ref(struct ds_sds_map *map)
+{
+	map->refs++;
+	return map;
+}
+
+void ds_sds_map_free(struct ds_sds_map *map)
+{
+	if (map == NULL || --map->refs > 0)
+		return;
+#ifdef HAVE_MMAN_H
+	if (map->data != NULL)
+		munmap(map->data, map->size);
+#endif
+	if (map->skeleton != NULL)
+		xmlFreeDoc(map->skeleton);
+	oscap_htable_free(map->components, ds_sds_map_range_free);
+	free(map->root_end_tag);
+	free(map->filepath);
+	free(map);
+}
+
+static bool ds_sds_map_read(struct ds_sds_map *map)
+{
+	struct ds_sds_map_input input = {
+		.piece = { map->data },
+		.size = { map->size },
+	};
+	struct ds_sds_map_state state = { .map = map };
+	xmlSAXHandler sax;
+
+	xmlSAXVersion(&sax, 2);
+	sax.startElementNs = ds_sds_map_start_element;
+	sax.endElementNs = ds_sds_map_end_element;
+	sax.characters = ds_sds_map_characters;
+	sax.ignorableWhitespace = ds_sds_map_characters;
+	sax.cdataBlock = ds_sds_map_cdata_block;
+	sax.comment = ds_sds_map_comment;
+	sax.processingInstruction = ds_sds_map_processing_instruction;
+	sax.internalSubset = ds_sds_map_internal_subset;
+	sax.serror = ds_sds_map_error;
+
+	xmlParserCtxtPtr ctxt = ds_sds_map_parser_new(&sax, &input);
+	if (ctxt == NULL)
+		return false;
+	ctxt->_private = &state;
+	xmlParseDocument(ctxt);
+
+	bool ok = ctxt->wellFormed && !state.failed && map->root_end_tag != NULL;
+	/* The byte ranges are valid only if no conversion took place */
+	if (ctxt->input != NULL && ctxt->input->buf != NULL && ctxt->input->buf->encoder != NULL) {
+		dD("The Source DataStream isn't encoded in UTF-8, it can't be mapped.");
+		ok = false;
+	}
+	map->skeleton = ctxt->myDoc;
+	ctxt->myDoc = NULL;
+	free(state.component_id);
+	free(state.component_root);
+	xmlFreeParserCtxt(ctxt);
+	return ok;
+}
+
+/*
+ * The map is cached as: size of the file, serialized skeleton, range of the root
+ * start tag, root end tag and the list of components with their ranges.
+ */
+static void ds_sds_map_store(const struct ds_sds_map *map)
+{
+	xmlChar *skeleton = NULL;
+	int skeleton_size = 0;
+
+	xmlDocDumpMemory(map->skeleton, &skeleton, &skeleton_size);
+	if (skeleton == NULL)
+		return;
+
+	struct oscap_buffer *buf = oscap_buffer_new();
+	oscap_cache_write_u64(buf, map->size);
+	oscap_cache_write_str(buf, (const char *) skeleton);
+	oscap_cache_write_u64(buf, map->root_tag.start);
+	oscap_cache_write_u64(buf, map->root_tag.end);
+	oscap_cache_write_str(buf, map->root_end_tag);
+	oscap_cache_write_u32(buf, oscap_htable_itemcount(map->components));
+	struct oscap_htable_iterator *hit = oscap_htable_iterator_new(map->components);
+	while (oscap_htable_iterator_has_more(hit)) {
+		const char *id;
+		void *value;
+		oscap_htable_iterator_next_kv(hit, &id, &value);
+		const struct ds_sds_map_range *range = value;
+		oscap_cache_write_str(buf, id);
+		oscap_cache_write_u64(buf, range->start);
+		oscap_cache_write_u64(buf, range->end);
+		oscap_cache_write_str(buf, range->root_name);
+	}
+	oscap_htable_iterator_free(hit);
+	xmlFree(skeleton);
+
+	oscap_content_cache_store(OSCAP_CONTENT_CACHE_SDS_MAP, map->digest, buf);
+	oscap_buffer_free(buf);
+}
+
+static bool ds_sds_map_range_valid(const struct ds_sds_map *map, size_t start, size_t end)
+{
+	return start <= end && end <= map->size;
+}
+
+static bool ds_sds_map_load(struct ds_sds_map *map)
+{
+	struct oscap_content_cache_entry *entry = oscap_content_cache_open(OSCAP_CONTENT_CACHE_SDS_MAP, map->digest);
+	if (entry == NULL)
+		return false;
+
+	struct oscap_cache_reader reader;
+	oscap_cache_reader_init(&reader, entry);
+	uint64_t size = oscap_cache_read_u64(&reader);
+	const char *skeleton = oscap_cache_read_cstr(&reader);
+	map->root_tag.start = oscap_cache_read_u64(&reader);
+	map->root_tag.end = oscap_cache_read_u64(&reader);
+	map->root_end_tag = oscap_cache_read_str(&reader);
+	if (reader.failed || skeleton == NULL || map->root_end_tag == NULL || size != map->size ||
+			!ds_sds_map_range_valid(map, map->root_tag.start, map->root_tag.end))
+		goto fail;
+
+	uint32_t count = oscap_cache_read_count(&reader, 3 * sizeof(uint64_t));
+	for (uint32_t i = 0; i < count && !reader.failed; ++i) {
+		const char *id = oscap_cache_read_cstr(&reader);
+		struct ds_sds_map_range *range = malloc(sizeof(struct ds_sds_map_range));
+		range->start = oscap_cache_read_u64(&reader);
+		range->end = oscap_cache_read_u64(&reader);
+		range->root_name = oscap_cache_read_str(&reader);
+		if (reader.failed || id == NULL || !ds_sds_map_range_valid(map, range->start, range->end) ||
+				!oscap_htable_add(map->components, id, range)) {
+			ds_sds_map_range_free(range);
+			goto fail;
+		}
+	}
+	if (reader.failed)
+		goto fail;
+
+	map->skeleton = xmlReadMemory(skeleton, strlen(skeleton), NULL, NULL, 0);
+	if (map->skeleton == NULL)
+		goto fail;
+	oscap_content_cache_close(entry);
+	return true;
+
+fail:
+	dW("Ignoring the cached map of the Source DataStream '%s', it doesn't match the file.", map->filepath);
+	oscap_htable_free(map->components, ds_sds_map_range_free);
+	map->components = oscap_htable_new();
+	free(map->root_end_tag);
+	map->root_end_tag = NULL;
+	oscap_content_cache_close(entry);
+	return false;
+}
+
+struct ds_sds_map *ds_sds_map_new(const char *filepath, const uint8_t digest[OSCAP_CONTENT_CACHE_DIGEST_SIZE])
+{
+#ifdef HAVE_MMAN_H
+	struct stat st;
+	int fd = open(filepath, O_RDONLY);
+	if (fd == -1)
+		return NULL;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+		close(fd);
+		return NULL;
+	}
+	void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED)
+		return NULL;
+
+	struct ds_sds_map *map = calloc(1, sizeof(struct ds_sds_map));
+	map->refs = 1;
+	map->filepath = oscap_strdup(filepath);
+	map->data = data;
+	map->size = st.st_size;
+	map->components = oscap_htable_new();
+	if (digest != NULL) {
+		map->digest_known = true;
+		memcpy(map->digest, digest, sizeof(map->digest));
+		if (ds_sds_map_load(map)) {
+			dI("Mapped Source DataStream '%s' from the content cache.", filepath);
+			return map;
+		}
+	}
+
+	if (bz2_memory_is_bzip(map->data, map->size) || !ds_sds_map_read(map)) {
+		dD("Source DataStream '%s' can't be mapped, using its full DOM.", filepath);
+		ds_sds_map_free(map);
+		return NULL;
+	}
+	if (map->digest_known)
+		ds_sds_map_store(map);
+#ifdef MADV_DONTNEED
+	/* Release the pages read so far, only the components in use are read again */
+	madvise(map->data, map->size, MADV_DONTNEED);
+#endif
+	dI("Mapped Source DataStream '%s', components are parsed on demand.", filepath);
+	return map;
+#else
+	return NULL;
+#endif
+}
+
+xmlDoc *ds_sds_map_get_skeleton(struct ds_sds_map *map)
+{
+	return map->skeleton;
+}
+
+xmlDoc *ds_sds_map_load_component(struct ds_sds_map *map, const char *component_id)
+{
+	struct ds_sds_map_range *range = oscap_htable_get(map->components, component_id);
+	if (range == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_XML, "Component of given id '%s' was not found in the document.", component_id);
+		return NULL;
+	}
+
+	/* The root start tag brings in all the namespace declarations in scope */
+	struct ds_sds_map_input input = {
+		.piece = { map->data + map->root_tag.start, map->data + range->start, map->root_end_tag },
+		.size = { map->root_tag.end - map->root_tag.start, range->end - range->start, strlen(map->root_end_tag) },
+	};
+	xmlParserCtxtPtr ctxt = ds_sds_map_parser_new(NULL, &input);
+	if (ctxt == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_XML, "Could not create parser context for component '%s'.", component_id);
+		return NULL;
+	}
+	xmlParseDocument(ctxt);
+
+	xmlDoc *doc = ctxt->myDoc;
+	ctxt->myDoc = NULL;
+	if (!ctxt->wellFormed) {
+		oscap_setxmlerr(xmlCtxtGetLastError(ctxt));
+		oscap_seterr(OSCAP_EFAMILY_XML, "Unable to parse component '%s' of '%s'.", component_id, map->filepath);
+		if (doc != NULL)
+			xmlFreeDoc(doc);
+		doc = NULL;
+	}
+	xmlFreeParserCtxt(ctxt);
+	return doc;
+}
+
+const char *ds_sds_map_get_component_root(struct ds_sds_map *map, const char *component_id)
+{
+	struct ds_sds_map_range *range = oscap_htable_get(map->components, component_id);
+	return range != NULL ? range->root_name : NULL;
+}
+
+bool ds_sds_map_get_component_digest(struct ds_sds_map *map, const char *component_id, uint8_t digest[OSCAP_CONTENT_CACHE_DIGEST_SIZE])
+{
+	if (!map->digest_known)
+		return false;
+	oscap_content_cache_key(map->digest, component_id, digest);
+	return true;
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ */
+#ifndef OSCAP_DS_SDS_MAP_PRIV_H
+#define OSCAP_DS_SDS_MAP_PRIV_H
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <libxml/tree.h>
+
+#include "common/oscap_content_cache.h"
+
+/**
+ * Map of a Source DataStream file which allows to parse its components
+ * one at a time. The file is mapped into memory and read once by a streaming
+ * parser, which records the byte range of every component and builds
+ * a skeleton DOM of the collection. The skeleton contains everything but the
+ * component contents, only an empty Benchmark element is kept in components
+ * holding one, so that the Benchmark ID can be mapped to the component.
+ */
+struct ds_sds_map;
+
+/**
+ * Map the Source DataStream file at filepath. If the digest of the file is
+ * given, the map is taken from the content cache or stored there, so that the
+ * file doesn't have to be read again.
+ * @returns the map or NULL if the file can't be mapped, e.g. because it isn't
+ * well-formed, isn't encoded in UTF-8 or uses a DTD. The full DOM of the file
+ * has to be used then.
+ */
+struct ds_sds_map *ds_sds_map_new(const char *filepath, const uint8_t digest[OSCAP_CONTENT_CACHE_DIGEST_SIZE]);
+
+/**
+ * Take another reference to the map, each of them is released by ds_sds_map_free().
+ */
+struct ds_sds_map *ds_sds_map_ref(struct ds_sds_map *map);
+
+void ds_sds_map_free(struct ds_sds_map *map);
+
+/**
+ * Get the skeleton DOM of the collection, owned by the map.
+ */
+xmlDoc *ds_sds_map_get_skeleton(struct ds_sds_map *map);
+
+/**
+ * Parse the component of given ID from the mapped file.
+ * @returns new document, its root element is a copy of the collection root
+ * element and the component is its only child. The caller owns the document.
+ */
+xmlDoc *ds_sds_map_load_component(struct ds_sds_map *map, const char *component_id);
+
+/**
+ * Get the local name of the root element of the component of given ID.
+ * @returns the name owned by the map or NULL if it isn't known
+ */
+const char *ds_sds_map_get_component_root(struct ds_sds_map *map, const char *component_id);
+
+/**
+ * Get the digest of the component of given ID, which identifies it in the
+ * content cache. It's derived from the digest of the whole file.
+ * @returns true if the digest of the file was given to ds_sds_map_new()
+ */
+bool ds_sds_map_get_component_digest(struct ds_sds_map *map, const char *component_id, uint8_t digest[OSCAP_CONTENT_CACHE_DIGEST_SIZE]);
+
+#endif
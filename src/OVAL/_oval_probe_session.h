@@ -33,6 +33,8 @@
 #include "public/oval_probe_session.h"
 #include "_oval_probe_handler.h"
 #include "oval_probe_ext.h"
+#include "oval_collection_cache.h"
+#include "adt/oval_string_map_impl.h"
 
 /** OVAL probe session structure.
  * This structure holds all the library side state information associated with
@@ -45,6 +47,8 @@ struct oval_probe_session {
         struct oval_syschar_model *sys_model; /**< system characteristics model */
         char         *dir;  /**< probe session directory */
         uint32_t      flg;  /**< probe session flags */
+        struct oval_collection_cache *cache; /**< persistent collection cache, kept across reinit */
+        struct oval_string_map *varref_values; /**< variable values converted to S-exps, by variable ID and datatype */
 };
 
 #endif /* _OVAL_PROBE_SESSION */
@@ -28,62 +28,74 @@
 #include "oval_definitions_impl.h"
 #include "adt/oval_string_map_impl.h"
 
-static void _var_collect_var_refs(struct oval_variable *var, struct oval_string_map *vm);
+static void _var_collect_refs(struct oval_variable *var, struct oval_refs *refs);
+static void _obj_collect_refs(struct oval_object *obj, struct oval_refs *refs);
+static void _ste_collect_refs(struct oval_state *ste, struct oval_refs *refs);
 
-static void _comp_collect_var_refs(struct oval_component *comp, struct oval_string_map *vm)
+/* Returns true if the item hasn't been seen yet. Items of a kind which
+ * isn't collected are always walked. */
+static bool _refs_add(struct oval_string_map *map, char *id, void *item)
+{
+	if (map == NULL)
+		return true;
+	if (oval_string_map_get_value(map, id) != NULL)
+		return false;
+	oval_string_map_put(map, id, item);
+	return true;
+}
+
+static void _comp_collect_refs(struct oval_component *comp, struct oval_refs *refs)
 {
 	struct oval_object *obj;
 	struct oval_variable *var;
 	struct oval_component_iterator *cmp_itr;
+	oval_component_type_t type;
 
-	switch (oval_component_get_type(comp)) {
+	type = oval_component_get_type(comp);
+	switch (type) {
 	case OVAL_COMPONENT_OBJECTREF:
 		obj = oval_component_get_object(comp);
-		oval_obj_collect_var_refs(obj, vm);
+		if (obj != NULL)
+			_obj_collect_refs(obj, refs);
 		break;
 	case OVAL_COMPONENT_VARREF:
 		var = oval_component_get_variable(comp);
-		_var_collect_var_refs(var, vm);
+		if (var != NULL)
+			_var_collect_refs(var, refs);
 		break;
-	case OVAL_FUNCTION_ARITHMETIC:
-	case OVAL_FUNCTION_BEGIN:
-	case OVAL_FUNCTION_CONCAT:
-	case OVAL_FUNCTION_END:
-	case OVAL_FUNCTION_ESCAPE_REGEX:
-	case OVAL_FUNCTION_REGEX_CAPTURE:
-	case OVAL_FUNCTION_SPLIT:
-	case OVAL_FUNCTION_SUBSTRING:
-	case OVAL_FUNCTION_TIMEDIF:
+	default:
+		if (type <= OVAL_FUNCTION)
+			break;
 		cmp_itr = oval_component_get_function_components(comp);
 		while (oval_component_iterator_has_more(cmp_itr)) {
 			struct oval_component *cmp;
 
 			cmp = oval_component_iterator_next(cmp_itr);
-			_comp_collect_var_refs(cmp, vm);
+			_comp_collect_refs(cmp, refs);
 		}
 		oval_component_iterator_free(cmp_itr);
 		break;
-	default:
-		break;
 	}
 }
 
-static void _var_collect_var_refs(struct oval_variable *var, struct oval_string_map *vm)
+static void _var_collect_refs(struct oval_variable *var, struct oval_refs *refs)
 {
 	char *var_id;
 
 	var_id = oval_variable_get_id(var);
-	oval_string_map_put(vm, var_id, var);
+	if (!_refs_add(refs->variables, var_id, var))
+		return;
 
 	if (oval_variable_get_type(var) == OVAL_VARIABLE_LOCAL) {
 		struct oval_component *comp;
 
 		comp = oval_variable_get_component(var);
-		_comp_collect_var_refs(comp, vm);
+		if (comp != NULL)
+			_comp_collect_refs(comp, refs);
 	}
 }
 
-static void _ent_collect_var_refs(struct oval_entity *ent, struct oval_string_map *vm)
+static void _ent_collect_refs(struct oval_entity *ent, struct oval_refs *refs)
 {
 	oval_entity_varref_type_t vrt;
 
@@ -93,27 +105,42 @@ static void _ent_collect_var_refs(struct oval_entity *ent, struct oval_string_ma
 		struct oval_variable *var;
 
 		var = oval_entity_get_variable(ent);
-		_var_collect_var_refs(var, vm);
+		if (var != NULL)
+			_var_collect_refs(var, refs);
 	}
 }
 
-void oval_ste_collect_var_refs(struct oval_state *ste, struct oval_string_map *vm)
+static void _ste_collect_refs(struct oval_state *ste, struct oval_refs *refs)
 {
 	struct oval_state_content_iterator *cont_itr;
 
+	if (!_refs_add(refs->states, oval_state_get_id(ste), ste))
+		return;
+
 	cont_itr = oval_state_get_contents(ste);
 	while (oval_state_content_iterator_has_more(cont_itr)) {
 		struct oval_state_content *cont;
 		struct oval_entity *ent;
+		struct oval_record_field_iterator *rf_itr;
 
 		cont = oval_state_content_iterator_next(cont_itr);
 		ent = oval_state_content_get_entity(cont);
-		_ent_collect_var_refs(ent, vm);
+		_ent_collect_refs(ent, refs);
+
+		rf_itr = oval_state_content_get_record_fields(cont);
+		while (oval_record_field_iterator_has_more(rf_itr)) {
+			struct oval_variable *var;
+
+			var = oval_record_field_get_variable(oval_record_field_iterator_next(rf_itr));
+			if (var != NULL)
+				_var_collect_refs(var, refs);
+		}
+		oval_record_field_iterator_free(rf_itr);
 	}
 	oval_state_content_iterator_free(cont_itr);
 }
 
-static void _set_collect_var_refs(struct oval_setobject *set, struct oval_string_map *vm)
+static void _set_collect_refs(struct oval_setobject *set, struct oval_refs *refs)
 {
 	struct oval_setobject_iterator *subset_itr;
 	struct oval_object_iterator *obj_itr;
@@ -126,7 +153,7 @@ static void _set_collect_var_refs(struct oval_setobject *set, struct oval_string
 			struct oval_setobject *subset;
 
 			subset = oval_setobject_iterator_next(subset_itr);
-			_set_collect_var_refs(subset, vm);
+			_set_collect_refs(subset, refs);
 		}
 		oval_setobject_iterator_free(subset_itr);
 		break;
@@ -136,7 +163,7 @@ static void _set_collect_var_refs(struct oval_setobject *set, struct oval_string
 			struct oval_object *obj;
 
 			obj = oval_object_iterator_next(obj_itr);
-			oval_obj_collect_var_refs(obj, vm);
+			_obj_collect_refs(obj, refs);
 		}
 		oval_object_iterator_free(obj_itr);
 		fil_itr = oval_setobject_get_filters(set);
@@ -146,7 +173,8 @@ static void _set_collect_var_refs(struct oval_setobject *set, struct oval_string
 
 			fil = oval_filter_iterator_next(fil_itr);
 			ste = oval_filter_get_state(fil);
-			oval_ste_collect_var_refs(ste, vm);
+			if (ste != NULL)
+				_ste_collect_refs(ste, refs);
 		}
 		oval_filter_iterator_free(fil_itr);
 		break;
@@ -155,9 +183,18 @@ static void _set_collect_var_refs(struct oval_setobject *set, struct oval_string
 	}
 }
 
-void oval_obj_collect_var_refs(struct oval_object *obj, struct oval_string_map *vm)
+static void _obj_collect_refs(struct oval_object *obj, struct oval_refs *refs)
 {
 	struct oval_object_content_iterator *cont_itr;
+	struct oval_object *base_obj;
+
+	if (!_refs_add(refs->objects, oval_object_get_id(obj), obj))
+		return;
+
+	/* objects created by the filter propagation are collected through their origin */
+	base_obj = oval_object_get_base_obj(obj);
+	if (base_obj != NULL && refs->objects != NULL)
+		_obj_collect_refs(base_obj, refs);
 
 	cont_itr = oval_object_get_object_contents(obj);
 	while (oval_object_content_iterator_has_more(cont_itr)) {
@@ -172,16 +209,17 @@ void oval_obj_collect_var_refs(struct oval_object *obj, struct oval_string_map *
 		switch (oval_object_content_get_type(cont)) {
 		case OVAL_OBJECTCONTENT_ENTITY:
 			ent = oval_object_content_get_entity(cont);
-			_ent_collect_var_refs(ent, vm);
+			_ent_collect_refs(ent, refs);
 			break;
 		case OVAL_OBJECTCONTENT_SET:
 			set = oval_object_content_get_setobject(cont);
-			_set_collect_var_refs(set, vm);
+			_set_collect_refs(set, refs);
 			break;
 		case OVAL_OBJECTCONTENT_FILTER:
 			flt = oval_object_content_get_filter(cont);
 			ste = oval_filter_get_state(flt);
-			oval_ste_collect_var_refs(ste, vm);
+			if (ste != NULL)
+				_ste_collect_refs(ste, refs);
 			break;
 		default:
 			break;
@@ -189,3 +227,75 @@ void oval_obj_collect_var_refs(struct oval_object *obj, struct oval_string_map *
 	}
 	oval_object_content_iterator_free(cont_itr);
 }
+
+static void _tst_collect_refs(struct oval_test *tst, struct oval_refs *refs)
+{
+	struct oval_object *obj;
+	struct oval_state_iterator *ste_itr;
+
+	if (!_refs_add(refs->tests, oval_test_get_id(tst), tst))
+		return;
+
+	obj = oval_test_get_object(tst);
+	if (obj != NULL)
+		_obj_collect_refs(obj, refs);
+
+	ste_itr = oval_test_get_states(tst);
+	while (oval_state_iterator_has_more(ste_itr))
+		_ste_collect_refs(oval_state_iterator_next(ste_itr), refs);
+	oval_state_iterator_free(ste_itr);
+}
+
+static void _crit_collect_refs(struct oval_criteria_node *node, struct oval_refs *refs)
+{
+	struct oval_criteria_node_iterator *subnode_itr;
+	struct oval_test *tst;
+	struct oval_definition *def;
+
+	switch (oval_criteria_node_get_type(node)) {
+	case OVAL_NODETYPE_CRITERIA:
+		subnode_itr = oval_criteria_node_get_subnodes(node);
+		while (oval_criteria_node_iterator_has_more(subnode_itr))
+			_crit_collect_refs(oval_criteria_node_iterator_next(subnode_itr), refs);
+		oval_criteria_node_iterator_free(subnode_itr);
+		break;
+	case OVAL_NODETYPE_CRITERION:
+		tst = oval_criteria_node_get_test(node);
+		if (tst != NULL)
+			_tst_collect_refs(tst, refs);
+		break;
+	case OVAL_NODETYPE_EXTENDDEF:
+		def = oval_criteria_node_get_definition(node);
+		if (def != NULL)
+			oval_def_collect_refs(def, refs);
+		break;
+	default:
+		break;
+	}
+}
+
+void oval_def_collect_refs(struct oval_definition *def, struct oval_refs *refs)
+{
+	struct oval_criteria_node *criteria;
+
+	if (!_refs_add(refs->definitions, oval_definition_get_id(def), def))
+		return;
+
+	criteria = oval_definition_get_criteria(def);
+	if (criteria != NULL)
+		_crit_collect_refs(criteria, refs);
+}
+
+void oval_ste_collect_var_refs(struct oval_state *ste, struct oval_string_map *vm)
+{
+	struct oval_refs refs = { .variables = vm };
+
+	_ste_collect_refs(ste, &refs);
+}
+
+void oval_obj_collect_var_refs(struct oval_object *obj, struct oval_string_map *vm)
+{
+	struct oval_refs refs = { .variables = vm };
+
+	_obj_collect_refs(obj, &refs);
+}
@@ -34,5 +34,20 @@
 void oval_obj_collect_var_refs(struct oval_object *obj, struct oval_string_map *vm);
 void oval_ste_collect_var_refs(struct oval_state *ste, struct oval_string_map *vm);
 
+/* Maps of the items reachable from a definition, stored as pairs of
+ * (id, pointer). Kinds whose map is NULL aren't collected.
+ */
+struct oval_refs {
+	struct oval_string_map *definitions;
+	struct oval_string_map *tests;
+	struct oval_string_map *objects;
+	struct oval_string_map *states;
+	struct oval_string_map *variables;
+};
+
+/* Collect the items the definition depends on, including itself, recursively.
+ */
+void oval_def_collect_refs(struct oval_definition *def, struct oval_refs *refs);
+
 
 #endif
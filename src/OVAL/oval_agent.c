@@ -32,6 +32,7 @@
 #include <config.h>
 #endif
 
+#include <stdlib.h>
 #include <string.h>
 #include <time.h>
 
@@ -140,6 +141,13 @@ oval_agent_session_t * oval_agent_new_session(struct oval_definition_model *mode
 	return ag_sess;
 }
 
+void oval_agent_set_collection_cache(oval_agent_session_t *ag_sess, bool enabled)
+{
+#if defined(OVAL_PROBES_ENABLED)
+	oval_probe_session_set_collection_cache(ag_sess->psess, enabled);
+#endif
+}
+
 struct oval_definition_model* oval_agent_get_definition_model(oval_agent_session_t* ag_sess)
 {
 	return ag_sess->def_model;
@@ -286,6 +294,45 @@ int oval_agent_abort_session(oval_agent_session_t *ag_sess)
 #endif
 }
 
+#if defined(OVAL_PROBES_ENABLED)
+/*
+ * Prepare the results of all definitions, evaluate them at once and report
+ * them afterwards in the order of the definition model.
+ */
+static int _oval_agent_eval_system_parallel(oval_agent_session_t *ag_sess, agent_reporter cb, void *arg, unsigned int threads)
+{
+	struct oval_result_system *rsystem = _oval_agent_get_first_result_system(ag_sess);
+	struct oval_definition_iterator *oval_def_it;
+	size_t count = 0, capacity = 0;
+	struct oval_result_definition **definitions = NULL;
+	int ret = 0;
+
+	oval_def_it = oval_definition_model_get_definitions(ag_sess->def_model);
+	while (oval_definition_iterator_has_more(oval_def_it)) {
+		struct oval_definition *oval_def = oval_definition_iterator_next(oval_def_it);
+		struct oval_result_definition *res_def = oval_result_system_prepare_definition(rsystem, oval_definition_get_id(oval_def));
+		if (res_def == NULL) {
+			ret = -1;
+			break;
+		}
+		if (count == capacity) {
+			capacity = capacity ? 2 * capacity : 64;
+			definitions = realloc(definitions, capacity * sizeof(struct oval_result_definition *));
+		}
+		definitions[count++] = res_def;
+	}
+	oval_definition_iterator_free(oval_def_it);
+
+	if (ret == 0)
+		ret = oval_result_system_eval_definitions(rsystem, definitions, count, threads);
+
+	for (size_t i = 0; ret == 0 && cb != NULL && i < count; i++)
+		ret = cb(definitions[i], arg);
+	free(definitions);
+	return ret;
+}
+#endif
+
 int oval_agent_eval_system(oval_agent_session_t * ag_sess, agent_reporter cb, void *arg) {
 	struct oval_definition *oval_def;
 	struct oval_definition_iterator *oval_def_it;
@@ -293,6 +340,35 @@ int oval_agent_eval_system(oval_agent_session_t * ag_sess, agent_reporter cb, vo
 	int ret = 0;
 
 	dI("OVAL agent started to evaluate OVAL definitions on your system.");
+#if defined(OVAL_PROBES_ENABLED)
+	/*
+	 * Optionally collect the independent objects of all definitions up
+	 * front, running probes of different types concurrently. Whatever
+	 * is left is collected on demand by the evaluation below.
+	 */
+	const char *threads_env = getenv("OSCAP_PROBE_COLLECTION_THREADS");
+	if (threads_env != NULL) {
+		long threads = strtol(threads_env, NULL, 10);
+		if (threads > 1) {
+			if (oval_probe_query_definitions(ag_sess->psess, ag_sess->def_model, (unsigned int) threads) != 0)
+				dW("Parallel object collection failed, continuing sequentially.");
+			oscap_clearerr();
+		}
+	}
+	/*
+	 * Optionally evaluate the tests in parallel once their objects are
+	 * collected.
+	 */
+	const char *eval_threads_env = getenv("OSCAP_EVALUATION_THREADS");
+	if (eval_threads_env != NULL) {
+		long threads = strtol(eval_threads_env, NULL, 10);
+		if (threads > 1) {
+			ret = _oval_agent_eval_system_parallel(ag_sess, cb, arg, (unsigned int) threads);
+			dI("OVAL agent finished evaluation.");
+			return ret;
+		}
+	}
+#endif
 	oval_def_it = oval_definition_model_get_definitions(ag_sess->def_model);
 	while (oval_definition_iterator_has_more(oval_def_it)) {
 		oval_def = oval_definition_iterator_next(oval_def_it);
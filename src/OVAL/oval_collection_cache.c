@@ -0,0 +1,612 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "oval_collection_cache.h"
+#include "_probe-api.h"
+#include "probe/icache.h"
+#include "common/debug_priv.h"
+#include "common/MurmurHash3.h"
+#include "common/oscap_buffer.h"
+#include "common/util.h"
+
+#define OVAL_COLLECTION_CACHE_MAGIC "OSCAPCC1"
+#define OVAL_COLLECTION_CACHE_MAXDEPTH 64
+
+struct oval_collection_cache {
+	char *dir;
+	pthread_mutex_t lock; /* guards the statistics */
+	unsigned int hits;
+	unsigned int misses;
+	unsigned int stale;
+	unsigned int stored;
+};
+
+struct oval_collection_cache_slot {
+	char *path;
+	struct oscap_buffer *key;
+	SEXP_t *tokens;      /* tokens taken before the collection */
+	bool probe_tokens;   /* the probe has to provide tokens as well */
+};
+
+/* The first one of these directories which exists holds the rpm database */
+static const char *rpmdb_dirs[] = { "/usr/lib/sysimage/rpm", "/var/lib/rpm", NULL };
+static const char *rpmdb_files[] = { "rpmdb.sqlite", "rpmdb.sqlite-wal", "Packages", "Packages.db", NULL };
+
+static bool _oval_collection_cache_subtype(oval_subtype_t subtype, bool *probe_tokens)
+{
+	switch (subtype) {
+	case OVAL_UNIX_FILE:
+	case OVAL_UNIX_FILEEXTENDEDATTRIBUTE:
+	case OVAL_INDEPENDENT_FILE_MD5:
+	case OVAL_INDEPENDENT_FILE_HASH:
+	case OVAL_INDEPENDENT_FILE_HASH58:
+	case OVAL_INDEPENDENT_TEXT_FILE_CONTENT:
+	case OVAL_INDEPENDENT_TEXT_FILE_CONTENT_54:
+	case OVAL_INDEPENDENT_XML_FILE_CONTENT:
+	case OVAL_INDEPENDENT_YAML_FILE_CONTENT:
+		/* these probes read everything through oval_fts */
+		*probe_tokens = true;
+		return true;
+	case OVAL_LINUX_RPM_INFO:
+		*probe_tokens = false;
+		return true;
+	default:
+		return false;
+	}
+}
+
+static SEXP_t *_oval_collection_cache_rpmdb_tokens(void)
+{
+	struct stat st;
+
+	for (int i = 0; rpmdb_dirs[i] != NULL; ++i) {
+		if (stat(rpmdb_dirs[i], &st) != 0 || !S_ISDIR(st.st_mode))
+			continue;
+
+		SEXP_t *tokens = SEXP_list_new(NULL);
+		SEXP_t *token = probe_token_new_path(rpmdb_dirs[i]);
+		SEXP_list_add(tokens, token);
+		SEXP_free(token);
+		for (int j = 0; rpmdb_files[j] != NULL; ++j) {
+			char *path = oscap_path_join(rpmdb_dirs[i], rpmdb_files[j]);
+			token = probe_token_new_path(path);
+			SEXP_list_add(tokens, token);
+			SEXP_free(token);
+			free(path);
+		}
+		return tokens;
+	}
+	return NULL;
+}
+
+/*
+ * S-exp serialization: an optional datatype ('D', length, name) followed by
+ * a string ('S', length, bytes), a number ('N', type, 64 bits) or a list
+ * ('L', count, members). The cache is local to the host, so the numbers are
+ * kept in the native byte order.
+ */
+static void _sexp_write(struct oscap_buffer *buf, const SEXP_t *s_exp)
+{
+	const char *dt = SEXP_datatype(s_exp);
+
+	if (dt != NULL) {
+		uint16_t dt_len = strlen(dt);
+		oscap_buffer_append_char(buf, 'D');
+		oscap_buffer_append_binary_data(buf, (const char *) &dt_len, sizeof(dt_len));
+		oscap_buffer_append_binary_data(buf, dt, dt_len);
+	}
+
+	switch (SEXP_typeof(s_exp)) {
+	case SEXP_TYPE_STRING: {
+		uint32_t len = SEXP_string_length(s_exp);
+		char *str = SEXP_string_cstr(s_exp);
+		oscap_buffer_append_char(buf, 'S');
+		oscap_buffer_append_binary_data(buf, (const char *) &len, sizeof(len));
+		oscap_buffer_append_binary_data(buf, str, len);
+		free(str);
+		break;
+	}
+	case SEXP_TYPE_NUMBER: {
+		uint8_t type = SEXP_number_type(s_exp);
+		uint64_t n;
+		int64_t i;
+		double f;
+
+		switch (type) {
+		case SEXP_NUM_BOOL:
+			n = SEXP_number_getb(s_exp);
+			break;
+		case SEXP_NUM_INT8:
+		case SEXP_NUM_INT16:
+		case SEXP_NUM_INT32:
+		case SEXP_NUM_INT64:
+			i = SEXP_number_geti_64(s_exp);
+			memcpy(&n, &i, sizeof(n));
+			break;
+		case SEXP_NUM_DOUBLE:
+			f = SEXP_number_getf(s_exp);
+			memcpy(&n, &f, sizeof(n));
+			break;
+		default:
+			n = SEXP_number_getu_64(s_exp);
+			break;
+		}
+		oscap_buffer_append_char(buf, 'N');
+		oscap_buffer_append_binary_data(buf, (const char *) &type, sizeof(type));
+		oscap_buffer_append_binary_data(buf, (const char *) &n, sizeof(n));
+		break;
+	}
+	case SEXP_TYPE_LIST: {
+		uint32_t count = SEXP_list_length(s_exp);
+		oscap_buffer_append_char(buf, 'L');
+		oscap_buffer_append_binary_data(buf, (const char *) &count, sizeof(count));
+		if (count > 0) {
+			SEXP_list_it *it = SEXP_list_it_new(s_exp);
+			for (uint32_t i = 0; i < count; ++i)
+				_sexp_write(buf, SEXP_list_it_next(it));
+			SEXP_list_it_free(it);
+		}
+		break;
+	}
+	default:
+		/* never produced by the probes */
+		oscap_buffer_append_char(buf, 'L');
+		oscap_buffer_append_binary_data(buf, "\0\0\0\0", sizeof(uint32_t));
+		break;
+	}
+}
+
+static bool _read(const uint8_t **p, const uint8_t *end, void *dst, size_t len)
+{
+	if ((size_t) (end - *p) < len)
+		return false;
+	memcpy(dst, *p, len);
+	*p += len;
+	return true;
+}
+
+static SEXP_t *_sexp_read(const uint8_t **p, const uint8_t *end, int depth)
+{
+	char tag, dt[256];
+	bool has_dt = false;
+	SEXP_t *s_exp = NULL;
+
+	if (depth > OVAL_COLLECTION_CACHE_MAXDEPTH || !_read(p, end, &tag, 1))
+		return NULL;
+
+	if (tag == 'D') {
+		uint16_t dt_len;
+		if (!_read(p, end, &dt_len, sizeof(dt_len)) || dt_len >= sizeof(dt)
+		    || !_read(p, end, dt, dt_len) || !_read(p, end, &tag, 1))
+			return NULL;
+		dt[dt_len] = '\0';
+		has_dt = true;
+	}
+
+	switch (tag) {
+	case 'S': {
+		uint32_t len;
+		if (!_read(p, end, &len, sizeof(len)) || (size_t) (end - *p) < len)
+			return NULL;
+		s_exp = SEXP_string_new(*p, len);
+		*p += len;
+		break;
+	}
+	case 'N': {
+		uint8_t type;
+		uint64_t n;
+		int64_t i;
+		double f;
+
+		if (!_read(p, end, &type, sizeof(type)) || !_read(p, end, &n, sizeof(n)))
+			return NULL;
+		memcpy(&i, &n, sizeof(i));
+		switch (type) {
+		case SEXP_NUM_BOOL:   s_exp = SEXP_number_newb(n != 0); break;
+		case SEXP_NUM_INT8:   s_exp = SEXP_number_newi_8((int8_t) i); break;
+		case SEXP_NUM_UINT8:  s_exp = SEXP_number_newu_8((uint8_t) n); break;
+		case SEXP_NUM_INT16:  s_exp = SEXP_number_newi_16((int16_t) i); break;
+		case SEXP_NUM_UINT16: s_exp = SEXP_number_newu_16((uint16_t) n); break;
+		case SEXP_NUM_INT32:  s_exp = SEXP_number_newi_32((int32_t) i); break;
+		case SEXP_NUM_UINT32: s_exp = SEXP_number_newu_32((uint32_t) n); break;
+		case SEXP_NUM_INT64:  s_exp = SEXP_number_newi_64(i); break;
+		case SEXP_NUM_UINT64: s_exp = SEXP_number_newu_64(n); break;
+		case SEXP_NUM_DOUBLE:
+			memcpy(&f, &n, sizeof(f));
+			s_exp = SEXP_number_newf(f);
+			break;
+		default:
+			return NULL;
+		}
+		break;
+	}
+	case 'L': {
+		uint32_t count;
+		if (!_read(p, end, &count, sizeof(count)))
+			return NULL;
+		s_exp = SEXP_list_new(NULL);
+		for (uint32_t i = 0; i < count; ++i) {
+			SEXP_t *memb = _sexp_read(p, end, depth + 1);
+			if (memb == NULL) {
+				SEXP_free(s_exp);
+				return NULL;
+			}
+			SEXP_list_add(s_exp, memb);
+			SEXP_free(memb);
+		}
+		break;
+	}
+	default:
+		return NULL;
+	}
+
+	if (has_dt)
+		SEXP_datatype_set(s_exp, dt);
+	return s_exp;
+}
+
+/*
+ * Everything the reply depends on apart from the state of the system
+ */
+static struct oscap_buffer *_oval_collection_cache_key(oval_subtype_t subtype, const SEXP_t *s_obj)
+{
+	struct oscap_buffer *key = oscap_buffer_new();
+	const char *ignored_paths = getenv("OSCAP_PROBE_IGNORE_PATHS");
+	char header[64];
+
+	snprintf(header, sizeof(header), "%s %d\n", oscap_get_version(), (int) subtype);
+	oscap_buffer_append_string(key, header);
+	if (ignored_paths != NULL)
+		oscap_buffer_append_string(key, ignored_paths);
+	oscap_buffer_append_char(key, '\n');
+	_sexp_write(key, s_obj);
+	return key;
+}
+
+static char *_oval_collection_cache_path(struct oval_collection_cache *cache, struct oscap_buffer *key)
+{
+	uint64_t hash[2];
+	char name[40];
+
+	MurmurHash3_x64_128(oscap_buffer_get_raw(key), oscap_buffer_get_length(key), 0, hash);
+	snprintf(name, sizeof(name), "%016" PRIx64 "%016" PRIx64 ".cc", hash[0], hash[1]);
+	return oscap_path_join(cache->dir, name);
+}
+
+static uint8_t *_read_file(const char *path, size_t *size)
+{
+	struct stat st;
+	uint8_t *data;
+	size_t done = 0;
+	int fd;
+
+	fd = open(path, O_RDONLY | O_CLOEXEC | O_NOFOLLOW);
+	if (fd < 0)
+		return NULL;
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+		close(fd);
+		return NULL;
+	}
+	if (!oscap_stat_is_private(&st)) {
+		dW("Ignoring the collection cache entry '%s', it isn't owned by the user or it is writable by others.", path);
+		close(fd);
+		return NULL;
+	}
+	data = malloc(st.st_size > 0 ? st.st_size : 1);
+	while (done < (size_t) st.st_size) {
+		ssize_t ret = read(fd, data + done, st.st_size - done);
+		if (ret < 0 && errno == EINTR)
+			continue;
+		if (ret <= 0)
+			break;
+		done += ret;
+	}
+	close(fd);
+	if (done != (size_t) st.st_size) {
+		free(data);
+		return NULL;
+	}
+	*size = done;
+	return data;
+}
+
+static bool _oval_collection_cache_tokens_valid(const SEXP_t *tokens)
+{
+	uint32_t count = SEXP_list_length(tokens);
+	bool valid = true;
+
+	if (count == 0)
+		return true;
+	SEXP_list_it *it = SEXP_list_it_new(tokens);
+	for (uint32_t i = 0; i < count && valid; ++i)
+		valid = probe_token_valid(SEXP_list_it_next(it));
+	SEXP_list_it_free(it);
+	return valid;
+}
+
+/*
+ * Load the entry. Returns NULL if there is none, *stale is set if there was
+ * one which doesn't match the current state of the system.
+ */
+static SEXP_t *_oval_collection_cache_load(const char *path, struct oscap_buffer *key, bool *stale)
+{
+	const uint8_t *p, *end;
+	uint8_t *data;
+	size_t size;
+	uint32_t key_len;
+	SEXP_t *tokens, *cobj = NULL;
+
+	*stale = false;
+	data = _read_file(path, &size);
+	if (data == NULL)
+		return NULL;
+	p = data;
+	end = data + size;
+
+	*stale = true;
+	if (size < strlen(OVAL_COLLECTION_CACHE_MAGIC)
+	    || memcmp(p, OVAL_COLLECTION_CACHE_MAGIC, strlen(OVAL_COLLECTION_CACHE_MAGIC)) != 0)
+		goto cleanup;
+	p += strlen(OVAL_COLLECTION_CACHE_MAGIC);
+	/* the file name is just a hash of the key */
+	if (!_read(&p, end, &key_len, sizeof(key_len)) || key_len != oscap_buffer_get_length(key)
+	    || (size_t) (end - p) < key_len || memcmp(p, oscap_buffer_get_raw(key), key_len) != 0)
+		goto cleanup;
+	p += key_len;
+
+	tokens = _sexp_read(&p, end, 0);
+	if (tokens == NULL)
+		goto cleanup;
+	if (_oval_collection_cache_tokens_valid(tokens)) {
+		cobj = _sexp_read(&p, end, 0);
+		*stale = false;
+	}
+	SEXP_free(tokens);
+
+	if (cobj != NULL) {
+		/* The item IDs are only unique within the run which stored them */
+		SEXP_t *items = probe_cobj_get_items(cobj);
+		uint32_t count = items != NULL ? SEXP_list_length(items) : 0;
+		if (count > 0) {
+			SEXP_list_it *it = SEXP_list_it_new(items);
+			for (uint32_t i = 0; i < count; ++i)
+				probe_icache_item_renew_id(SEXP_list_it_next(it));
+			SEXP_list_it_free(it);
+		}
+		SEXP_free(items);
+	}
+cleanup:
+	free(data);
+	return cobj;
+}
+
+static int _oval_collection_cache_store(const char *path, struct oscap_buffer *key,
+		const SEXP_t *tokens, const SEXP_t *cobj)
+{
+	struct oscap_buffer *buf = oscap_buffer_new();
+	uint32_t key_len = oscap_buffer_get_length(key);
+	size_t tmp_size = strlen(path) + sizeof(".XXXXXX");
+	char *tmp_path = malloc(tmp_size);
+	const char *data;
+	size_t len, done = 0;
+	int fd, ret = -1;
+
+	snprintf(tmp_path, tmp_size, "%s.XXXXXX", path);
+	oscap_buffer_append_string(buf, OVAL_COLLECTION_CACHE_MAGIC);
+	oscap_buffer_append_binary_data(buf, (const char *) &key_len, sizeof(key_len));
+	oscap_buffer_append_binary_data(buf, oscap_buffer_get_raw(key), key_len);
+	_sexp_write(buf, tokens);
+	_sexp_write(buf, cobj);
+
+	/* write a new file and rename it, concurrent readers see either version */
+	fd = mkstemp(tmp_path);
+	if (fd < 0)
+		goto cleanup;
+	data = oscap_buffer_get_raw(buf);
+	len = oscap_buffer_get_length(buf);
+	while (done < len) {
+		ssize_t w = write(fd, data + done, len - done);
+		if (w < 0 && errno == EINTR)
+			continue;
+		if (w <= 0)
+			break;
+		done += w;
+	}
+	if (close(fd) == 0 && done == len && rename(tmp_path, path) == 0)
+		ret = 0;
+	else
+		unlink(tmp_path);
+cleanup:
+	if (ret != 0)
+		dW("Can't store the collection cache entry '%s': %s", path, strerror(errno));
+	free(tmp_path);
+	oscap_buffer_free(buf);
+	return ret;
+}
+
+struct oval_collection_cache *oval_collection_cache_new(const char *dir)
+{
+	struct stat st;
+
+	if (mkdir(dir, 0700) != 0 && errno != EEXIST) {
+		dW("Can't create the collection cache directory '%s': %s", dir, strerror(errno));
+		return NULL;
+	}
+	if (stat(dir, &st) != 0 || !S_ISDIR(st.st_mode) || access(dir, R_OK | W_OK | X_OK) != 0) {
+		dW("The collection cache directory '%s' isn't usable.", dir);
+		return NULL;
+	}
+	/* Anybody who can write to the cache can forge the collected objects */
+	if (!oscap_stat_is_private(&st)) {
+		dW("Not using the collection cache directory '%s', it isn't owned by the user "
+		   "or it is writable by others.", dir);
+		return NULL;
+	}
+
+	struct oval_collection_cache *cache = calloc(1, sizeof(struct oval_collection_cache));
+	cache->dir = oscap_strdup(dir);
+	pthread_mutex_init(&cache->lock, NULL);
+	probe_tokens_enable(true);
+	dI("Using the collection cache in '%s'.", dir);
+	return cache;
+}
+
+struct oval_collection_cache *oval_collection_cache_new_from_env(void)
+{
+	const char *dir = getenv("OSCAP_COLLECTION_CACHE_DIR");
+
+	if (dir == NULL || *dir == '\0')
+		return NULL;
+	/* The tokens are taken relative to our root, not the scanned one */
+	if (getenv("OSCAP_PROBE_ROOT") != NULL) {
+		dI("The collection cache isn't used for offline scans.");
+		return NULL;
+	}
+	return oval_collection_cache_new(dir);
+}
+
+void oval_collection_cache_free(struct oval_collection_cache *cache)
+{
+	if (cache == NULL)
+		return;
+
+	dI("Collection cache '%s': %u hits, %u misses (%u stale), %u stored.",
+	   cache->dir, cache->hits, cache->misses, cache->stale, cache->stored);
+	probe_tokens_enable(false);
+	pthread_mutex_destroy(&cache->lock);
+	free(cache->dir);
+	free(cache);
+}
+
+SEXP_t *oval_collection_cache_get(struct oval_collection_cache *cache, oval_subtype_t subtype,
+		const SEXP_t *s_obj, struct oval_collection_cache_slot **slot)
+{
+	struct oval_collection_cache_slot *s;
+	struct oscap_buffer *key;
+	bool probe_tokens, stale;
+	SEXP_t *cobj, *tokens;
+	char *path;
+
+	*slot = NULL;
+	if (!_oval_collection_cache_subtype(subtype, &probe_tokens))
+		return NULL;
+
+	key = _oval_collection_cache_key(subtype, s_obj);
+	path = _oval_collection_cache_path(cache, key);
+	cobj = _oval_collection_cache_load(path, key, &stale);
+
+	pthread_mutex_lock(&cache->lock);
+	if (cobj != NULL) {
+		cache->hits++;
+	} else {
+		cache->misses++;
+		if (stale)
+			cache->stale++;
+	}
+	pthread_mutex_unlock(&cache->lock);
+
+	if (cobj != NULL) {
+		dD("Collection cache hit: '%s'.", path);
+		oscap_buffer_free(key);
+		free(path);
+		return cobj;
+	}
+
+	/* The state of the package database has to be taken before the probe reads it */
+	tokens = probe_tokens ? SEXP_list_new(NULL) : _oval_collection_cache_rpmdb_tokens();
+	if (tokens == NULL) {
+		oscap_buffer_free(key);
+		free(path);
+		return NULL;
+	}
+
+	s = malloc(sizeof(struct oval_collection_cache_slot));
+	s->path = path;
+	s->key = key;
+	s->tokens = tokens;
+	s->probe_tokens = probe_tokens;
+	*slot = s;
+	return NULL;
+}
+
+void oval_collection_cache_put(struct oval_collection_cache *cache,
+		struct oval_collection_cache_slot *slot, const SEXP_t *s_sys)
+{
+	if (slot == NULL)
+		return;
+
+	if (s_sys != NULL) {
+		oval_syschar_collection_flag_t flag = probe_cobj_get_flag(s_sys);
+		bool cacheable = flag == SYSCHAR_FLAG_COMPLETE || flag == SYSCHAR_FLAG_DOES_NOT_EXIST;
+
+		if (cacheable && slot->probe_tokens) {
+			SEXP_t *probe_tokens = probe_cobj_get_tokens(s_sys);
+			uint32_t count = probe_tokens != NULL ? SEXP_list_length(probe_tokens) : 0;
+
+			/* Without any token, nothing would ever invalidate the entry */
+			cacheable = count > 0;
+			if (cacheable) {
+				SEXP_list_it *it = SEXP_list_it_new(probe_tokens);
+				for (uint32_t i = 0; i < count; ++i)
+					SEXP_list_add(slot->tokens, SEXP_list_it_next(it));
+				SEXP_list_it_free(it);
+			}
+			SEXP_free(probe_tokens);
+		}
+
+		if (cacheable) {
+			SEXP_t *r0 = SEXP_list_nth(s_sys, 1), *r1 = probe_cobj_get_msgs(s_sys);
+			SEXP_t *r2 = probe_cobj_get_items(s_sys), *r3 = probe_cobj_get_mask(s_sys);
+			SEXP_t *cobj = SEXP_list_new(r0, r1, r2, r3, NULL);
+
+			if (_oval_collection_cache_store(slot->path, slot->key, slot->tokens, cobj) == 0) {
+				pthread_mutex_lock(&cache->lock);
+				cache->stored++;
+				pthread_mutex_unlock(&cache->lock);
+			}
+			SEXP_free(cobj);
+			SEXP_free(r0);
+			SEXP_free(r1);
+			SEXP_free(r2);
+			SEXP_free(r3);
+		}
+	}
+
+	SEXP_free(slot->tokens);
+	oscap_buffer_free(slot->key);
+	free(slot->path);
+	free(slot);
+}
@@ -0,0 +1,73 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef OVAL_COLLECTION_CACHE_H
+#define OVAL_COLLECTION_CACHE_H
+
+#include <sexp.h>
+#include "public/oval_types.h"
+
+/*
+ * Persistent cache of collected objects, kept in a directory across runs.
+ * An entry is keyed by the probe request and stores the reply of the probe
+ * together with validity tokens: the state of the rpm database for package
+ * objects and the state of every file and directory a file based probe has
+ * looked at. An entry is used only while all its tokens are still valid.
+ * Objects of other types are never cached.
+ */
+struct oval_collection_cache;
+
+/* A lookup which missed, to be completed by oval_collection_cache_put() */
+struct oval_collection_cache_slot;
+
+/*
+ * Open the cache in dir, the directory is created if needed. Returns NULL
+ * if the cache can't be used, the directory has to be owned by the user and
+ * mustn't be writable by others. Entries which aren't private to the user
+ * are ignored as well.
+ */
+struct oval_collection_cache *oval_collection_cache_new(const char *dir);
+
+/*
+ * Open the cache configured by OSCAP_COLLECTION_CACHE_DIR, if any. The cache
+ * isn't used for offline scans.
+ */
+struct oval_collection_cache *oval_collection_cache_new_from_env(void);
+
+/*
+ * Log the statistics and dispose the cache
+ */
+void oval_collection_cache_free(struct oval_collection_cache *cache);
+
+/*
+ * Return the cached collected object for the request s_obj, or NULL. On
+ * a miss of a cacheable object, *slot is set and has to be passed to
+ * oval_collection_cache_put() afterwards.
+ */
+SEXP_t *oval_collection_cache_get(struct oval_collection_cache *cache, oval_subtype_t subtype,
+		const SEXP_t *s_obj, struct oval_collection_cache_slot **slot);
+
+/*
+ * Store the collected object s_sys in the slot and dispose the slot. s_sys
+ * may be NULL if the collection failed.
+ */
+void oval_collection_cache_put(struct oval_collection_cache *cache,
+		struct oval_collection_cache_slot *slot, const SEXP_t *s_sys);
+
+#endif /* OVAL_COLLECTION_CACHE_H */
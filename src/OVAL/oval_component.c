@@ -1581,6 +1581,19 @@ static oval_syschar_collection_flag_t _oval_component_evaluate_END(oval_argu_t *
 	return flag;
 }
 
+/*
+ * One operand of a concatenation: the texts of its values and their lengths,
+ * so that every combination is copied into one buffer instead of being built
+ * by strlen() and strcat() of all the operands.
+ */
+struct concat_operand {
+	char **texts;
+	size_t *lens;
+	size_t count;
+	size_t idx;	/* value used by the current combination */
+	size_t max_len;
+};
+
 static oval_syschar_collection_flag_t _oval_component_evaluate_CONCAT(oval_argu_t *argu,
 								      struct oval_component *component,
 								      struct oval_collection *value_collection)
@@ -1598,78 +1611,68 @@ static oval_syschar_collection_flag_t _oval_component_evaluate_CONCAT(oval_argu_
 		flag = _AGG_FLAG(flag, subflag);
 		component_colls[idx0] = subcoll;
 	}
-	bool not_finished = (len_subcomps > 0) && _HAS_VALUES(flag);
-	if (not_finished) {
-		struct oval_value_iterator **values = malloc(len_subcomps * sizeof(struct oval_value_iterator *));
-		/* bool has_some[len_subcomps]; <-- unused variable */
-		not_finished = false;
-		char **texts = malloc(len_subcomps * sizeof(char *));
-		int *counts = malloc(len_subcomps * sizeof(int));
-		int catnum = 1;
+	if ((len_subcomps > 0) && _HAS_VALUES(flag)) {
+		/* operands without values don't take part in the concatenation */
+		struct concat_operand *ops = calloc(len_subcomps, sizeof(struct concat_operand));
+		int len_ops = 0;
+		size_t max_len = 1;
 		for (idx0 = 0; idx0 < len_subcomps; idx0++) {
 			struct oval_value_iterator *comp_values =
 			    (struct oval_value_iterator *)oval_collection_iterator(component_colls[idx0]);
-			counts[idx0] = oval_value_iterator_remaining(comp_values);
-			if (counts[idx0]) {
-				/* int dbgnum = catnum; <-- unused variable */
-				catnum = catnum * counts[idx0];
-				values[idx0] = comp_values;
-				texts[idx0] = oval_value_get_text(oval_value_iterator_next(comp_values));
-				not_finished = true;
-			} else {
-				oval_value_iterator_free(comp_values);
-				oval_collection_free_items(component_colls[idx0],
-							   (oscap_destruct_func) oval_value_free);
-				component_colls[idx0] = NULL;
-				values[idx0] = NULL;
-				texts[idx0] = NULL;
+			size_t count = oval_value_iterator_remaining(comp_values);
+			if (count) {
+				struct concat_operand *op = &ops[len_ops++];
+				op->texts = malloc(count * sizeof(char *));
+				op->lens = malloc(count * sizeof(size_t));
+				while (oval_value_iterator_has_more(comp_values)) {
+					char *text = oval_value_get_text(oval_value_iterator_next(comp_values));
+					op->texts[op->count] = text;
+					op->lens[op->count] = text ? strlen(text) : 0;
+					if (op->lens[op->count] > op->max_len)
+						op->max_len = op->lens[op->count];
+					op->count++;
+				}
+				max_len += op->max_len;
 			}
+			oval_value_iterator_free(comp_values);
 		}
-		for (int passnum = 1; passnum - 1 < catnum; passnum++) {
-			int len_cat = 1;
-			for (idx0 = 0; idx0 < len_subcomps; idx0++)
-				if (texts[idx0])
-					len_cat += strlen(texts[idx0]);
-			char *concat = malloc(len_cat);
-			*concat = '\0';
-			for (idx0 = 0; idx0 < len_subcomps; idx0++)
-				if (texts[idx0])
-					strcat(concat, texts[idx0]);
-			struct oval_value *value = oval_value_new(OVAL_DATATYPE_STRING, concat);
-			free(concat);
-			oval_collection_add(value_collection, value);
-			bool rotate = true;
-			if (passnum < catnum) {
-				for (idx0 = 0; idx0 < len_subcomps && rotate; idx0++) {
-					if (texts[idx0]) {
-						if (oval_value_iterator_has_more(values[idx0])) {
-							rotate = false;
-						} else {
-							oval_value_iterator_free(values[idx0]);
-							values[idx0] =
-							    (struct oval_value_iterator *)
-							    oval_collection_iterator(component_colls[idx0]);
-						}
-						texts[idx0] =
-						    oval_value_get_text(oval_value_iterator_next(values[idx0]));
-					}
+		/*
+		 * Walk the cartesian product of the operands, the first operand
+		 * changes the fastest. Every combination is written to the same
+		 * buffer, which is long enough for the longest one.
+		 */
+		char *concat = malloc(max_len);
+		bool more = true;
+		while (more) {
+			size_t len_cat = 0;
+			for (idx0 = 0; idx0 < len_ops; idx0++) {
+				struct concat_operand *op = &ops[idx0];
+				if (op->lens[op->idx]) {
+					memcpy(concat + len_cat, op->texts[op->idx], op->lens[op->idx]);
+					len_cat += op->lens[op->idx];
 				}
 			}
-		}
-		for (idx0 = 0; idx0 < len_subcomps; idx0++) {
-			if (counts[idx0]) {
-				oval_value_iterator_free(values[idx0]);
-				oval_collection_free_items(component_colls[idx0],
-							   (oscap_destruct_func) oval_value_free);
+			concat[len_cat] = '\0';
+			oval_collection_add(value_collection, oval_value_new(OVAL_DATATYPE_STRING, concat));
+
+			more = false;
+			for (idx0 = 0; idx0 < len_ops && !more; idx0++) {
+				struct concat_operand *op = &ops[idx0];
+				if (++op->idx < op->count)
+					more = true;
+				else
+					op->idx = 0;
 			}
 		}
-		free(counts);
-		free(texts);
-		free(values);
-	} else {
-		for (idx0 = 0; idx0 < len_subcomps; ++idx0)
-			oval_collection_free_items(component_colls[idx0], (oscap_destruct_func) oval_value_free);
+		free(concat);
+		for (idx0 = 0; idx0 < len_ops; idx0++) {
+			free(ops[idx0].texts);
+			free(ops[idx0].lens);
+		}
+		free(ops);
 	}
+	for (idx0 = 0; idx0 < len_subcomps; ++idx0)
+		oval_collection_free_items(component_colls[idx0], (oscap_destruct_func) oval_value_free);
 	free(component_colls);
 	oval_component_iterator_free(subcomps);
 	return flag;
@@ -1984,7 +1987,7 @@ static bool _match(const char *pattern, const char *string)
 	oscap_pcre_t *re;
 	char *error;
 	int erroffset = -1, ovector[60], ovector_len = sizeof (ovector) / sizeof (ovector[0]);
-	re = oscap_pcre_compile(pattern, OSCAP_PCRE_OPTS_UTF8, &error, &erroffset);
+	re = oscap_pcre_compile_cached(pattern, OSCAP_PCRE_OPTS_UTF8, &error, &erroffset);
 	if (re == NULL) {
 		oscap_pcre_err_free(error);
 		return false;
@@ -2217,7 +2220,7 @@ static oval_syschar_collection_flag_t _oval_component_evaluate_REGEX_CAPTURE(ova
 	char *error;
 
 	pattern = oval_component_get_regex_pattern(component);
-	re = oscap_pcre_compile(pattern, OSCAP_PCRE_OPTS_UTF8, &error, &erroffset);
+	re = oscap_pcre_compile_cached(pattern, OSCAP_PCRE_OPTS_UTF8, &error, &erroffset);
 	if (re == NULL) {
 		dE("oscap_pcre_compile() failed: \"%s\".", error);
 		oscap_pcre_err_free(error);
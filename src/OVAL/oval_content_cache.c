@@ -0,0 +1,979 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Serialization of OVAL definition model for the content cache. Definitions,
+ * tests, objects, states and variables are stored one after another, the
+ * references among them are stored as ids. The reader resolves the ids with
+ * oval_definition_model_get_new_*() like the parser does, so that the order
+ * of the entities doesn't matter. Everything the reader creates is attached
+ * to the model right away, a malformed entry is disposed of by freeing it.
+ *
+ * Only the content of the document is stored, values of local and external
+ * variables are computed or bound later and aren't part of the entry.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdlib.h>
+
+#include "oval_definitions_impl.h"
+#include "adt/oval_collection_impl.h"
+#include "common/list.h"
+#include "common/oscap_content_cache.h"
+
+static uint32_t _remaining(void *iterator)
+{
+	return oval_collection_iterator_remaining((struct oval_iterator *) iterator);
+}
+
+static void _write_strings(struct oscap_buffer *buf, struct oval_string_iterator *strings)
+{
+	oscap_cache_write_u32(buf, _remaining(strings));
+	while (oval_string_iterator_has_more(strings))
+		oscap_cache_write_str(buf, oval_string_iterator_next(strings));
+	oval_string_iterator_free(strings);
+}
+
+/* An id which the reader passes to oval_definition_model_get_new_*() */
+static const char *_read_id(struct oscap_cache_reader *reader)
+{
+	const char *id = oscap_cache_read_cstr(reader);
+	if (id == NULL)
+		reader->failed = true;
+	return id;
+}
+
+static void _write_value(struct oscap_buffer *buf, struct oval_value *value)
+{
+	oscap_cache_write_u32(buf, oval_value_get_datatype(value));
+	oscap_cache_write_str(buf, oval_value_get_text(value));
+}
+
+static struct oval_value *_read_value(struct oscap_cache_reader *reader)
+{
+	oval_datatype_t datatype = oscap_cache_read_u32(reader);
+	const char *text = oscap_cache_read_cstr(reader);
+	if (reader->failed)
+		return NULL;
+	return oval_value_new(datatype, (char *) text);
+}
+
+static void _write_entity(struct oscap_buffer *buf, struct oval_entity *entity)
+{
+	struct oval_variable *variable = oval_entity_get_variable(entity);
+	struct oval_value *value = oval_entity_get_value(entity);
+
+	oscap_cache_write_str(buf, oval_entity_get_name(entity));
+	oscap_cache_write_u32(buf, oval_entity_get_type(entity));
+	oscap_cache_write_u32(buf, oval_entity_get_datatype(entity));
+	oscap_cache_write_u32(buf, oval_entity_get_operation(entity));
+	oscap_cache_write_int(buf, oval_entity_get_mask(entity));
+	oscap_cache_write_bool(buf, oval_entity_get_xsi_nil(entity));
+	oscap_cache_write_u32(buf, oval_entity_get_varref_type(entity));
+	oscap_cache_write_str(buf, variable != NULL ? oval_variable_get_id(variable) : NULL);
+	oscap_cache_write_bool(buf, value != NULL);
+	if (value != NULL)
+		_write_value(buf, value);
+}
+
+static struct oval_entity *_read_entity(struct oscap_cache_reader *reader, struct oval_definition_model *model)
+{
+	struct oval_entity *entity = oval_entity_new(model);
+
+	oval_entity_set_name(entity, (char *) oscap_cache_read_cstr(reader));
+	oval_entity_set_type(entity, oscap_cache_read_u32(reader));
+	oval_entity_set_datatype(entity, oscap_cache_read_u32(reader));
+	oval_entity_set_operation(entity, oscap_cache_read_u32(reader));
+	oval_entity_set_mask(entity, oscap_cache_read_int(reader));
+	oval_entity_set_xsi_nil(entity, oscap_cache_read_bool(reader));
+	oval_entity_set_varref_type(entity, oscap_cache_read_u32(reader));
+	const char *variable_id = oscap_cache_read_cstr(reader);
+	if (variable_id != NULL)
+		oval_entity_set_variable(entity, oval_definition_model_get_new_variable(model, variable_id, OVAL_VARIABLE_UNKNOWN));
+	if (oscap_cache_read_bool(reader))
+		oval_entity_set_value(entity, _read_value(reader));
+	return entity;
+}
+
+static void _write_record_field(struct oscap_buffer *buf, struct oval_record_field *rf)
+{
+	struct oval_variable *variable = oval_record_field_get_variable(rf);
+
+	oscap_cache_write_str(buf, oval_record_field_get_name(rf));
+	oscap_cache_write_str(buf, oval_record_field_get_value(rf));
+	oscap_cache_write_u32(buf, oval_record_field_get_datatype(rf));
+	oscap_cache_write_int(buf, oval_record_field_get_mask(rf));
+	oscap_cache_write_u32(buf, oval_record_field_get_operation(rf));
+	oscap_cache_write_str(buf, variable != NULL ? oval_variable_get_id(variable) : NULL);
+	oscap_cache_write_u32(buf, oval_record_field_get_var_check(rf));
+	oscap_cache_write_u32(buf, oval_record_field_get_ent_check(rf));
+}
+
+static struct oval_record_field *_read_record_field(struct oscap_cache_reader *reader, struct oval_definition_model *model)
+{
+	struct oval_record_field *rf = oval_record_field_new(OVAL_RECORD_FIELD_STATE);
+
+	oval_record_field_set_name(rf, (char *) oscap_cache_read_cstr(reader));
+	oval_record_field_set_value(rf, (char *) oscap_cache_read_cstr(reader));
+	oval_record_field_set_datatype(rf, oscap_cache_read_u32(reader));
+	oval_record_field_set_mask(rf, oscap_cache_read_int(reader));
+	oval_record_field_set_operation(rf, oscap_cache_read_u32(reader));
+	const char *variable_id = oscap_cache_read_cstr(reader);
+	if (variable_id != NULL)
+		oval_record_field_set_variable(rf, oval_definition_model_get_new_variable(model, variable_id, OVAL_VARIABLE_UNKNOWN));
+	oval_record_field_set_var_check(rf, oscap_cache_read_u32(reader));
+	oval_record_field_set_ent_check(rf, oscap_cache_read_u32(reader));
+	return rf;
+}
+
+static void _write_filter(struct oscap_buffer *buf, struct oval_filter *filter)
+{
+	struct oval_state *state = oval_filter_get_state(filter);
+
+	oscap_cache_write_u32(buf, oval_filter_get_filter_action(filter));
+	oscap_cache_write_str(buf, state != NULL ? oval_state_get_id(state) : NULL);
+}
+
+static struct oval_filter *_read_filter(struct oscap_cache_reader *reader, struct oval_definition_model *model)
+{
+	struct oval_filter *filter = oval_filter_new(model);
+
+	oval_filter_set_filter_action(filter, oscap_cache_read_u32(reader));
+	const char *state_id = oscap_cache_read_cstr(reader);
+	if (state_id != NULL)
+		oval_filter_set_state(filter, oval_definition_model_get_new_state(model, state_id));
+	return filter;
+}
+
+static void _write_setobject(struct oscap_buffer *buf, struct oval_setobject *set)
+{
+	oval_setobject_type_t type = oval_setobject_get_type(set);
+
+	oscap_cache_write_u32(buf, type);
+	oscap_cache_write_u32(buf, oval_setobject_get_operation(set));
+	if (type == OVAL_SET_AGGREGATE) {
+		struct oval_setobject_iterator *subsets = oval_setobject_get_subsets(set);
+		oscap_cache_write_u32(buf, _remaining(subsets));
+		while (oval_setobject_iterator_has_more(subsets))
+			_write_setobject(buf, oval_setobject_iterator_next(subsets));
+		oval_setobject_iterator_free(subsets);
+	} else if (type == OVAL_SET_COLLECTIVE) {
+		struct oval_object_iterator *objects = oval_setobject_get_objects(set);
+		oscap_cache_write_u32(buf, _remaining(objects));
+		while (oval_object_iterator_has_more(objects))
+			oscap_cache_write_str(buf, oval_object_get_id(oval_object_iterator_next(objects)));
+		oval_object_iterator_free(objects);
+
+		struct oval_filter_iterator *filters = oval_setobject_get_filters(set);
+		oscap_cache_write_u32(buf, _remaining(filters));
+		while (oval_filter_iterator_has_more(filters))
+			_write_filter(buf, oval_filter_iterator_next(filters));
+		oval_filter_iterator_free(filters);
+	}
+}
+
+static void _read_setobject(struct oscap_cache_reader *reader, struct oval_setobject *set, struct oval_definition_model *model)
+{
+	oval_setobject_type_t type = oscap_cache_read_u32(reader);
+
+	oval_setobject_set_operation(set, oscap_cache_read_u32(reader));
+	if (type == OVAL_SET_AGGREGATE) {
+		oval_setobject_set_type(set, type);
+		uint32_t count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+		for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+			struct oval_setobject *subset = oval_setobject_new(model);
+			oval_setobject_add_subset(set, subset);
+			_read_setobject(reader, subset, model);
+		}
+	} else if (type == OVAL_SET_COLLECTIVE) {
+		oval_setobject_set_type(set, type);
+		uint32_t count = oscap_cache_read_count(reader, sizeof(uint32_t));
+		for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+			const char *object_id = _read_id(reader);
+			if (object_id != NULL)
+				oval_setobject_add_object(set, oval_definition_model_get_new_object(model, object_id));
+		}
+		count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+		for (uint32_t i = 0; i < count && !reader->failed; ++i)
+			oval_setobject_add_filter(set, _read_filter(reader, model));
+	} else if (type != OVAL_SET_UNKNOWN) {
+		reader->failed = true;
+	}
+}
+
+static void _write_object_content(struct oscap_buffer *buf, struct oval_object_content *content)
+{
+	oval_object_content_type_t type = oval_object_content_get_type(content);
+
+	oscap_cache_write_u32(buf, type);
+	oscap_cache_write_str(buf, oval_object_content_get_field_name(content));
+	switch (type) {
+	case OVAL_OBJECTCONTENT_ENTITY:
+		_write_entity(buf, oval_object_content_get_entity(content));
+		oscap_cache_write_u32(buf, oval_object_content_get_varCheck(content));
+		break;
+	case OVAL_OBJECTCONTENT_SET:
+		_write_setobject(buf, oval_object_content_get_setobject(content));
+		break;
+	case OVAL_OBJECTCONTENT_FILTER:
+		_write_filter(buf, oval_object_content_get_filter(content));
+		break;
+	default:
+		break;
+	}
+}
+
+static void _read_object_content(struct oscap_cache_reader *reader, struct oval_object *object, struct oval_definition_model *model)
+{
+	oval_object_content_type_t type = oscap_cache_read_u32(reader);
+	if (type != OVAL_OBJECTCONTENT_ENTITY && type != OVAL_OBJECTCONTENT_SET && type != OVAL_OBJECTCONTENT_FILTER) {
+		reader->failed = true;
+		return;
+	}
+
+	struct oval_object_content *content = oval_object_content_new(model, type);
+	oval_object_add_object_content(object, content);
+	oval_object_content_set_field_name(content, (char *) oscap_cache_read_cstr(reader));
+	switch (type) {
+	case OVAL_OBJECTCONTENT_ENTITY:
+		oval_object_content_set_entity(content, _read_entity(reader, model));
+		oval_object_content_set_varCheck(content, oscap_cache_read_u32(reader));
+		break;
+	case OVAL_OBJECTCONTENT_SET: {
+		struct oval_setobject *set = oval_setobject_new(model);
+		oval_object_content_set_setobject(content, set);
+		_read_setobject(reader, set, model);
+		break;
+	}
+	case OVAL_OBJECTCONTENT_FILTER:
+		oval_object_content_set_filter(content, _read_filter(reader, model));
+		break;
+	default:
+		break;
+	}
+}
+
+static void _write_state_content(struct oscap_buffer *buf, struct oval_state_content *content)
+{
+	_write_entity(buf, oval_state_content_get_entity(content));
+	oscap_cache_write_u32(buf, oval_state_content_get_var_check(content));
+	oscap_cache_write_u32(buf, oval_state_content_get_ent_check(content));
+	oscap_cache_write_u32(buf, oval_state_content_get_check_existence(content));
+
+	struct oval_record_field_iterator *rfs = oval_state_content_get_record_fields(content);
+	oscap_cache_write_u32(buf, _remaining(rfs));
+	while (oval_record_field_iterator_has_more(rfs))
+		_write_record_field(buf, oval_record_field_iterator_next(rfs));
+	oval_record_field_iterator_free(rfs);
+}
+
+static void _read_state_content(struct oscap_cache_reader *reader, struct oval_state *state, struct oval_definition_model *model)
+{
+	struct oval_state_content *content = oval_state_content_new(model);
+	oval_state_add_content(state, content);
+
+	oval_state_content_set_entity(content, _read_entity(reader, model));
+	oval_state_content_set_varcheck(content, oscap_cache_read_u32(reader));
+	oval_state_content_set_entcheck(content, oscap_cache_read_u32(reader));
+	oval_state_content_set_check_existence(content, oscap_cache_read_u32(reader));
+
+	uint32_t count = oscap_cache_read_count(reader, 8 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i)
+		oval_state_content_add_record_field(content, _read_record_field(reader, model));
+}
+
+static void _write_component(struct oscap_buffer *buf, struct oval_component *component)
+{
+	oval_component_type_t type = oval_component_get_type(component);
+
+	oscap_cache_write_u32(buf, type);
+	switch (type) {
+	case OVAL_COMPONENT_LITERAL: {
+		struct oval_value *value = oval_component_get_literal_value(component);
+		oscap_cache_write_bool(buf, value != NULL);
+		if (value != NULL)
+			_write_value(buf, value);
+		break;
+	}
+	case OVAL_COMPONENT_OBJECTREF: {
+		struct oval_object *object = oval_component_get_object(component);
+		oscap_cache_write_str(buf, object != NULL ? oval_object_get_id(object) : NULL);
+		oscap_cache_write_str(buf, oval_component_get_item_field(component));
+		oscap_cache_write_str(buf, oval_component_get_record_field(component));
+		break;
+	}
+	case OVAL_COMPONENT_VARREF: {
+		struct oval_variable *variable = oval_component_get_variable(component);
+		oscap_cache_write_str(buf, variable != NULL ? oval_variable_get_id(variable) : NULL);
+		break;
+	}
+	case OVAL_FUNCTION_ARITHMETIC:
+		oscap_cache_write_u32(buf, oval_component_get_arithmetic_operation(component));
+		break;
+	case OVAL_FUNCTION_BEGIN:
+		oscap_cache_write_str(buf, oval_component_get_prefix(component));
+		break;
+	case OVAL_FUNCTION_END:
+		oscap_cache_write_str(buf, oval_component_get_suffix(component));
+		break;
+	case OVAL_FUNCTION_SPLIT:
+		oscap_cache_write_str(buf, oval_component_get_split_delimiter(component));
+		break;
+	case OVAL_FUNCTION_GLOB_TO_REGEX:
+		oscap_cache_write_bool(buf, oval_component_get_glob_to_regex_glob_noescape(component));
+		break;
+	case OVAL_FUNCTION_SUBSTRING:
+		oscap_cache_write_int(buf, oval_component_get_substring_start(component));
+		oscap_cache_write_int(buf, oval_component_get_substring_length(component));
+		break;
+	case OVAL_FUNCTION_TIMEDIF:
+		oscap_cache_write_u32(buf, oval_component_get_timedif_format_1(component));
+		oscap_cache_write_u32(buf, oval_component_get_timedif_format_2(component));
+		break;
+	case OVAL_FUNCTION_REGEX_CAPTURE:
+		oscap_cache_write_str(buf, oval_component_get_regex_pattern(component));
+		break;
+	default:
+		break;
+	}
+
+	if (type > OVAL_FUNCTION) {
+		struct oval_component_iterator *subcomps = oval_component_get_function_components(component);
+		oscap_cache_write_u32(buf, _remaining(subcomps));
+		while (oval_component_iterator_has_more(subcomps))
+			_write_component(buf, oval_component_iterator_next(subcomps));
+		oval_component_iterator_free(subcomps);
+	}
+}
+
+static struct oval_component *_read_component(struct oscap_cache_reader *reader, struct oval_definition_model *model)
+{
+	oval_component_type_t type = oscap_cache_read_u32(reader);
+	if (reader->failed || type == OVAL_COMPONENT_UNKNOWN || type == OVAL_COMPONENT_FUNCTION
+	    || type >= OVAL_FUNCTION_LAST) {
+		reader->failed = true;
+		return NULL;
+	}
+
+	struct oval_component *component = oval_component_new(model, type);
+	switch (type) {
+	case OVAL_COMPONENT_LITERAL:
+		if (oscap_cache_read_bool(reader))
+			oval_component_set_literal_value(component, _read_value(reader));
+		break;
+	case OVAL_COMPONENT_OBJECTREF: {
+		const char *object_id = oscap_cache_read_cstr(reader);
+		if (object_id != NULL)
+			oval_component_set_object(component, oval_definition_model_get_new_object(model, object_id));
+		oval_component_set_item_field(component, (char *) oscap_cache_read_cstr(reader));
+		oval_component_set_record_field(component, (char *) oscap_cache_read_cstr(reader));
+		break;
+	}
+	case OVAL_COMPONENT_VARREF: {
+		const char *variable_id = oscap_cache_read_cstr(reader);
+		if (variable_id != NULL)
+			oval_component_set_variable(component, oval_definition_model_get_new_variable(model, variable_id, OVAL_VARIABLE_UNKNOWN));
+		break;
+	}
+	case OVAL_FUNCTION_ARITHMETIC:
+		oval_component_set_arithmetic_operation(component, oscap_cache_read_u32(reader));
+		break;
+	case OVAL_FUNCTION_BEGIN:
+		oval_component_set_prefix(component, (char *) oscap_cache_read_cstr(reader));
+		break;
+	case OVAL_FUNCTION_END:
+		oval_component_set_suffix(component, (char *) oscap_cache_read_cstr(reader));
+		break;
+	case OVAL_FUNCTION_SPLIT:
+		oval_component_set_split_delimiter(component, (char *) oscap_cache_read_cstr(reader));
+		break;
+	case OVAL_FUNCTION_GLOB_TO_REGEX:
+		oval_component_set_glob_to_regex_glob_noescape(component, oscap_cache_read_bool(reader));
+		break;
+	case OVAL_FUNCTION_SUBSTRING:
+		oval_component_set_substring_start(component, oscap_cache_read_int(reader));
+		oval_component_set_substring_length(component, oscap_cache_read_int(reader));
+		break;
+	case OVAL_FUNCTION_TIMEDIF:
+		oval_component_set_timedif_format_1(component, oscap_cache_read_u32(reader));
+		oval_component_set_timedif_format_2(component, oscap_cache_read_u32(reader));
+		break;
+	case OVAL_FUNCTION_REGEX_CAPTURE:
+		oval_component_set_regex_pattern(component, (char *) oscap_cache_read_cstr(reader));
+		break;
+	default:
+		break;
+	}
+
+	if (type > OVAL_FUNCTION) {
+		uint32_t count = oscap_cache_read_count(reader, sizeof(uint32_t));
+		for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+			struct oval_component *subcomp = _read_component(reader, model);
+			if (subcomp != NULL)
+				oval_component_add_function_component(component, subcomp);
+		}
+	}
+	return component;
+}
+
+static void _write_criteria_node(struct oscap_buffer *buf, struct oval_criteria_node *node)
+{
+	oval_criteria_node_type_t type = oval_criteria_node_get_type(node);
+
+	oscap_cache_write_u32(buf, type);
+	oscap_cache_write_str(buf, oval_criteria_node_get_comment(node));
+	oscap_cache_write_bool(buf, oval_criteria_node_get_negate(node));
+	oscap_cache_write_bool(buf, oval_criteria_node_get_applicability_check(node));
+	switch (type) {
+	case OVAL_NODETYPE_CRITERIA: {
+		oscap_cache_write_u32(buf, oval_criteria_node_get_operator(node));
+		struct oval_criteria_node_iterator *subnodes = oval_criteria_node_get_subnodes(node);
+		oscap_cache_write_u32(buf, _remaining(subnodes));
+		while (oval_criteria_node_iterator_has_more(subnodes))
+			_write_criteria_node(buf, oval_criteria_node_iterator_next(subnodes));
+		oval_criteria_node_iterator_free(subnodes);
+		break;
+	}
+	case OVAL_NODETYPE_CRITERION: {
+		struct oval_test *test = oval_criteria_node_get_test(node);
+		oscap_cache_write_str(buf, test != NULL ? oval_test_get_id(test) : NULL);
+		break;
+	}
+	case OVAL_NODETYPE_EXTENDDEF: {
+		struct oval_definition *definition = oval_criteria_node_get_definition(node);
+		oscap_cache_write_str(buf, definition != NULL ? oval_definition_get_id(definition) : NULL);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+static struct oval_criteria_node *_read_criteria_node(struct oscap_cache_reader *reader, struct oval_definition_model *model)
+{
+	oval_criteria_node_type_t type = oscap_cache_read_u32(reader);
+	if (type != OVAL_NODETYPE_CRITERIA && type != OVAL_NODETYPE_CRITERION && type != OVAL_NODETYPE_EXTENDDEF) {
+		reader->failed = true;
+		return NULL;
+	}
+
+	struct oval_criteria_node *node = oval_criteria_node_new(model, type);
+	oval_criteria_node_set_comment(node, (char *) oscap_cache_read_cstr(reader));
+	oval_criteria_node_set_negate(node, oscap_cache_read_bool(reader));
+	oval_criteria_node_set_applicability_check(node, oscap_cache_read_bool(reader));
+	switch (type) {
+	case OVAL_NODETYPE_CRITERIA: {
+		oval_criteria_node_set_operator(node, oscap_cache_read_u32(reader));
+		uint32_t count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+		for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+			struct oval_criteria_node *subnode = _read_criteria_node(reader, model);
+			if (subnode != NULL)
+				oval_criteria_node_add_subnode(node, subnode);
+		}
+		break;
+	}
+	case OVAL_NODETYPE_CRITERION: {
+		const char *test_id = oscap_cache_read_cstr(reader);
+		if (test_id != NULL)
+			oval_criteria_node_set_test(node, oval_definition_model_get_new_test(model, test_id));
+		break;
+	}
+	case OVAL_NODETYPE_EXTENDDEF: {
+		const char *definition_id = oscap_cache_read_cstr(reader);
+		if (definition_id != NULL)
+			oval_criteria_node_set_definition(node, oval_definition_model_get_new_definition(model, definition_id));
+		break;
+	}
+	default:
+		break;
+	}
+	return node;
+}
+
+static void _write_generator(struct oscap_buffer *buf, struct oval_generator *generator)
+{
+	oscap_cache_write_str(buf, oval_generator_get_product_name(generator));
+	oscap_cache_write_str(buf, oval_generator_get_product_version(generator));
+	oscap_cache_write_str(buf, oval_generator_get_core_schema_version(generator));
+	oscap_cache_write_str(buf, oval_generator_get_timestamp(generator));
+	oscap_cache_write_str(buf, oval_generator_get_anyxml(generator));
+
+	struct oscap_htable_iterator *versions = oval_generator_get_platform_schema_versions(generator);
+	while (oscap_htable_iterator_has_more(versions)) {
+		const char *platform;
+		void *version;
+		oscap_htable_iterator_next_kv(versions, &platform, &version);
+		oscap_cache_write_bool(buf, true);
+		oscap_cache_write_str(buf, platform);
+		oscap_cache_write_str(buf, version);
+	}
+	oscap_htable_iterator_free(versions);
+	oscap_cache_write_bool(buf, false);
+}
+
+static void _read_generator(struct oscap_cache_reader *reader, struct oval_generator *generator)
+{
+	oval_generator_set_product_name(generator, oscap_cache_read_cstr(reader));
+	oval_generator_set_product_version(generator, oscap_cache_read_cstr(reader));
+	oval_generator_set_core_schema_version(generator, oscap_cache_read_cstr(reader));
+	oval_generator_set_timestamp(generator, oscap_cache_read_cstr(reader));
+	oval_generator_set_anyxml(generator, oscap_cache_read_cstr(reader));
+
+	while (oscap_cache_read_bool(reader)) {
+		const char *platform = _read_id(reader);
+		const char *version = oscap_cache_read_cstr(reader);
+		if (platform != NULL)
+			oval_generator_add_platform_schema_version(generator, platform, version);
+	}
+}
+
+static void _write_definition(struct oscap_buffer *buf, struct oval_definition *definition)
+{
+	struct oval_criteria_node *criteria = oval_definition_get_criteria(definition);
+
+	oscap_cache_write_str(buf, oval_definition_get_id(definition));
+	oscap_cache_write_int(buf, oval_definition_get_version(definition));
+	oscap_cache_write_u32(buf, oval_definition_get_class(definition));
+	oscap_cache_write_bool(buf, oval_definition_get_deprecated(definition));
+	oscap_cache_write_str(buf, oval_definition_get_title(definition));
+	oscap_cache_write_str(buf, oval_definition_get_description(definition));
+
+	struct oval_affected_iterator *affecteds = oval_definition_get_affected(definition);
+	oscap_cache_write_u32(buf, _remaining(affecteds));
+	while (oval_affected_iterator_has_more(affecteds)) {
+		struct oval_affected *affected = oval_affected_iterator_next(affecteds);
+		oscap_cache_write_u32(buf, oval_affected_get_family(affected));
+		_write_strings(buf, oval_affected_get_platforms(affected));
+		_write_strings(buf, oval_affected_get_products(affected));
+	}
+	oval_affected_iterator_free(affecteds);
+
+	struct oval_reference_iterator *references = oval_definition_get_references(definition);
+	oscap_cache_write_u32(buf, _remaining(references));
+	while (oval_reference_iterator_has_more(references)) {
+		struct oval_reference *reference = oval_reference_iterator_next(references);
+		oscap_cache_write_str(buf, oval_reference_get_source(reference));
+		oscap_cache_write_str(buf, oval_reference_get_id(reference));
+		oscap_cache_write_str(buf, oval_reference_get_url(reference));
+	}
+	oval_reference_iterator_free(references);
+
+	_write_strings(buf, oval_definition_get_notes(definition));
+	oscap_cache_write_str(buf, oval_definition_get_anyxml(definition));
+	oscap_cache_write_bool(buf, criteria != NULL);
+	if (criteria != NULL)
+		_write_criteria_node(buf, criteria);
+}
+
+static void _read_definition(struct oscap_cache_reader *reader, struct oval_definition_model *model)
+{
+	const char *id = _read_id(reader);
+	if (id == NULL)
+		return;
+
+	struct oval_definition *definition = oval_definition_model_get_new_definition(model, id);
+	oval_definition_set_version(definition, oscap_cache_read_int(reader));
+	oval_definition_set_class(definition, oscap_cache_read_u32(reader));
+	oval_definition_set_deprecated(definition, oscap_cache_read_bool(reader));
+	oval_definition_set_title(definition, (char *) oscap_cache_read_cstr(reader));
+	oval_definition_set_description(definition, (char *) oscap_cache_read_cstr(reader));
+
+	uint32_t count = oscap_cache_read_count(reader, 3 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct oval_affected *affected = oval_affected_new(model);
+		oval_definition_add_affected(definition, affected);
+		oval_affected_set_family(affected, oscap_cache_read_u32(reader));
+		uint32_t platforms = oscap_cache_read_count(reader, sizeof(uint32_t));
+		for (uint32_t j = 0; j < platforms && !reader->failed; ++j)
+			oval_affected_add_platform(affected, (char *) oscap_cache_read_cstr(reader));
+		uint32_t products = oscap_cache_read_count(reader, sizeof(uint32_t));
+		for (uint32_t j = 0; j < products && !reader->failed; ++j)
+			oval_affected_add_product(affected, (char *) oscap_cache_read_cstr(reader));
+	}
+
+	count = oscap_cache_read_count(reader, 3 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct oval_reference *reference = oval_reference_new(model);
+		oval_definition_add_reference(definition, reference);
+		oval_reference_set_source(reference, (char *) oscap_cache_read_cstr(reader));
+		oval_reference_set_id(reference, (char *) oscap_cache_read_cstr(reader));
+		oval_reference_set_url(reference, (char *) oscap_cache_read_cstr(reader));
+	}
+
+	count = oscap_cache_read_count(reader, sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i)
+		oval_definition_add_note(definition, oscap_cache_read_str(reader));
+
+	oval_definition_set_anyxml(definition, oscap_cache_read_cstr(reader));
+	if (oscap_cache_read_bool(reader))
+		oval_definition_set_criteria(definition, _read_criteria_node(reader, model));
+}
+
+static void _write_test(struct oscap_buffer *buf, struct oval_test *test)
+{
+	struct oval_object *object = oval_test_get_object(test);
+
+	oscap_cache_write_str(buf, oval_test_get_id(test));
+	oscap_cache_write_u32(buf, oval_test_get_subtype(test));
+	oscap_cache_write_str(buf, oval_test_get_comment(test));
+	oscap_cache_write_bool(buf, oval_test_get_deprecated(test));
+	oscap_cache_write_int(buf, oval_test_get_version(test));
+	oscap_cache_write_u32(buf, oval_test_get_existence(test));
+	oscap_cache_write_u32(buf, oval_test_get_check(test));
+	oscap_cache_write_u32(buf, oval_test_get_state_operator(test));
+	_write_strings(buf, oval_test_get_notes(test));
+	oscap_cache_write_str(buf, object != NULL ? oval_object_get_id(object) : NULL);
+
+	struct oval_state_iterator *states = oval_test_get_states(test);
+	oscap_cache_write_u32(buf, _remaining(states));
+	while (oval_state_iterator_has_more(states))
+		oscap_cache_write_str(buf, oval_state_get_id(oval_state_iterator_next(states)));
+	oval_state_iterator_free(states);
+}
+
+static void _read_test(struct oscap_cache_reader *reader, struct oval_definition_model *model)
+{
+	const char *id = _read_id(reader);
+	if (id == NULL)
+		return;
+
+	struct oval_test *test = oval_definition_model_get_new_test(model, id);
+	oval_test_set_subtype(test, oscap_cache_read_u32(reader));
+	const char *comment = oscap_cache_read_cstr(reader);
+	if (comment != NULL)
+		oval_test_set_comment(test, (char *) comment);
+	oval_test_set_deprecated(test, oscap_cache_read_bool(reader));
+	oval_test_set_version(test, oscap_cache_read_int(reader));
+	oval_test_set_existence(test, oscap_cache_read_u32(reader));
+	oval_test_set_check(test, oscap_cache_read_u32(reader));
+	oval_test_set_state_operator(test, oscap_cache_read_u32(reader));
+
+	uint32_t count = oscap_cache_read_count(reader, sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i)
+		oval_test_add_note(test, (char *) oscap_cache_read_cstr(reader));
+
+	const char *object_id = oscap_cache_read_cstr(reader);
+	if (object_id != NULL)
+		oval_test_set_object(test, oval_definition_model_get_new_object(model, object_id));
+
+	count = oscap_cache_read_count(reader, sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		const char *state_id = _read_id(reader);
+		if (state_id != NULL)
+			oval_test_add_state(test, oval_definition_model_get_new_state(model, state_id));
+	}
+}
+
+static void _write_object(struct oscap_buffer *buf, struct oval_object *object)
+{
+	oscap_cache_write_str(buf, oval_object_get_id(object));
+	oscap_cache_write_u32(buf, oval_object_get_subtype(object));
+	oscap_cache_write_str(buf, oval_object_get_comment(object));
+	oscap_cache_write_bool(buf, oval_object_get_deprecated(object));
+	oscap_cache_write_int(buf, oval_object_get_version(object));
+	_write_strings(buf, oval_object_get_notes(object));
+
+	struct oval_object_content_iterator *contents = oval_object_get_object_contents(object);
+	oscap_cache_write_u32(buf, _remaining(contents));
+	while (oval_object_content_iterator_has_more(contents))
+		_write_object_content(buf, oval_object_content_iterator_next(contents));
+	oval_object_content_iterator_free(contents);
+
+	struct oval_behavior_iterator *behaviors = oval_object_get_behaviors(object);
+	oscap_cache_write_u32(buf, _remaining(behaviors));
+	while (oval_behavior_iterator_has_more(behaviors)) {
+		struct oval_behavior *behavior = oval_behavior_iterator_next(behaviors);
+		oscap_cache_write_str(buf, oval_behavior_get_key(behavior));
+		oscap_cache_write_str(buf, oval_behavior_get_value(behavior));
+	}
+	oval_behavior_iterator_free(behaviors);
+}
+
+static void _read_object(struct oscap_cache_reader *reader, struct oval_definition_model *model)
+{
+	const char *id = _read_id(reader);
+	if (id == NULL)
+		return;
+
+	struct oval_object *object = oval_definition_model_get_new_object(model, id);
+	oval_object_set_subtype(object, oscap_cache_read_u32(reader));
+	oval_object_set_comment(object, (char *) oscap_cache_read_cstr(reader));
+	oval_object_set_deprecated(object, oscap_cache_read_bool(reader));
+	oval_object_set_version(object, oscap_cache_read_int(reader));
+
+	uint32_t count = oscap_cache_read_count(reader, sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i)
+		oval_object_add_note(object, (char *) oscap_cache_read_cstr(reader));
+
+	count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i)
+		_read_object_content(reader, object, model);
+
+	count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct oval_behavior *behavior = oval_behavior_new(model);
+		oval_object_add_behavior(object, behavior);
+		const char *key = oscap_cache_read_cstr(reader);
+		const char *value = oscap_cache_read_cstr(reader);
+		oval_behavior_set_keyval(behavior, key, value);
+	}
+}
+
+static void _write_state(struct oscap_buffer *buf, struct oval_state *state)
+{
+	oscap_cache_write_str(buf, oval_state_get_id(state));
+	oscap_cache_write_u32(buf, oval_state_get_subtype(state));
+	oscap_cache_write_str(buf, oval_state_get_comment(state));
+	oscap_cache_write_bool(buf, oval_state_get_deprecated(state));
+	oscap_cache_write_int(buf, oval_state_get_version(state));
+	oscap_cache_write_u32(buf, oval_state_get_operator(state));
+	_write_strings(buf, oval_state_get_notes(state));
+
+	struct oval_state_content_iterator *contents = oval_state_get_contents(state);
+	oscap_cache_write_u32(buf, _remaining(contents));
+	while (oval_state_content_iterator_has_more(contents))
+		_write_state_content(buf, oval_state_content_iterator_next(contents));
+	oval_state_content_iterator_free(contents);
+}
+
+static void _read_state(struct oscap_cache_reader *reader, struct oval_definition_model *model)
+{
+	const char *id = _read_id(reader);
+	if (id == NULL)
+		return;
+
+	struct oval_state *state = oval_definition_model_get_new_state(model, id);
+	oval_state_set_subtype(state, oscap_cache_read_u32(reader));
+	const char *comment = oscap_cache_read_cstr(reader);
+	if (comment != NULL)
+		oval_state_set_comment(state, (char *) comment);
+	oval_state_set_deprecated(state, oscap_cache_read_bool(reader));
+	oval_state_set_version(state, oscap_cache_read_int(reader));
+	oval_state_set_operator(state, oscap_cache_read_u32(reader));
+
+	uint32_t count = oscap_cache_read_count(reader, sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i)
+		oval_state_add_note(state, (char *) oscap_cache_read_cstr(reader));
+
+	count = oscap_cache_read_count(reader, 12 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i)
+		_read_state_content(reader, state, model);
+}
+
+static void _write_variable(struct oscap_buffer *buf, struct oval_variable *variable)
+{
+	oval_variable_type_t type = oval_variable_get_type(variable);
+
+	oscap_cache_write_str(buf, oval_variable_get_id(variable));
+	oscap_cache_write_u32(buf, type);
+	oscap_cache_write_str(buf, oval_variable_get_comment(variable));
+	oscap_cache_write_bool(buf, oval_variable_get_deprecated(variable));
+	oscap_cache_write_int(buf, oval_variable_get_version(variable));
+	oscap_cache_write_u32(buf, oval_variable_get_datatype(variable));
+
+	switch (type) {
+	case OVAL_VARIABLE_CONSTANT: {
+		struct oval_value_iterator *values = oval_variable_get_values(variable);
+		oscap_cache_write_u32(buf, _remaining(values));
+		while (oval_value_iterator_has_more(values))
+			_write_value(buf, oval_value_iterator_next(values));
+		oval_value_iterator_free(values);
+		break;
+	}
+	case OVAL_VARIABLE_EXTERNAL: {
+		struct oval_variable_possible_value_iterator *pvs = oval_variable_get_possible_values2(variable);
+		oscap_cache_write_u32(buf, _remaining(pvs));
+		while (oval_variable_possible_value_iterator_has_more(pvs)) {
+			struct oval_variable_possible_value *pv = oval_variable_possible_value_iterator_next(pvs);
+			oscap_cache_write_str(buf, oval_variable_possible_value_get_hint(pv));
+			oscap_cache_write_str(buf, oval_variable_possible_value_get_value(pv));
+		}
+		oval_variable_possible_value_iterator_free(pvs);
+
+		struct oval_variable_possible_restriction_iterator *prs = oval_variable_get_possible_restrictions2(variable);
+		oscap_cache_write_u32(buf, _remaining(prs));
+		while (oval_variable_possible_restriction_iterator_has_more(prs)) {
+			struct oval_variable_possible_restriction *pr = oval_variable_possible_restriction_iterator_next(prs);
+			oscap_cache_write_u32(buf, oval_variable_possible_restriction_get_operator(pr));
+			oscap_cache_write_str(buf, oval_variable_possible_restriction_get_hint(pr));
+
+			struct oval_variable_restriction_iterator *rs = oval_variable_possible_restriction_get_restrictions2(pr);
+			oscap_cache_write_u32(buf, _remaining(rs));
+			while (oval_variable_restriction_iterator_has_more(rs)) {
+				struct oval_variable_restriction *r = oval_variable_restriction_iterator_next(rs);
+				oscap_cache_write_u32(buf, oval_variable_restriction_get_operation(r));
+				oscap_cache_write_str(buf, oval_variable_restriction_get_value(r));
+			}
+			oval_variable_restriction_iterator_free(rs);
+		}
+		oval_variable_possible_restriction_iterator_free(prs);
+		break;
+	}
+	case OVAL_VARIABLE_LOCAL: {
+		struct oval_component *component = oval_variable_get_component(variable);
+		oscap_cache_write_bool(buf, component != NULL);
+		if (component != NULL)
+			_write_component(buf, component);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+static void _read_variable(struct oscap_cache_reader *reader, struct oval_definition_model *model)
+{
+	const char *id = _read_id(reader);
+	oval_variable_type_t type = oscap_cache_read_u32(reader);
+	if (id == NULL || type > OVAL_VARIABLE_LOCAL) {
+		reader->failed = true;
+		return;
+	}
+
+	/* The variable may have been created as a reference of unknown type */
+	struct oval_variable *variable = oval_definition_model_get_new_variable(model, id, type);
+	if (oval_variable_get_type(variable) != type) {
+		reader->failed = true;
+		return;
+	}
+	const char *comment = oscap_cache_read_cstr(reader);
+	if (comment != NULL)
+		oval_variable_set_comment(variable, (char *) comment);
+	oval_variable_set_deprecated(variable, oscap_cache_read_bool(reader));
+	oval_variable_set_version(variable, oscap_cache_read_int(reader));
+	oval_variable_set_datatype(variable, oscap_cache_read_u32(reader));
+
+	switch (type) {
+	case OVAL_VARIABLE_CONSTANT: {
+		uint32_t count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+		for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+			struct oval_value *value = _read_value(reader);
+			if (value != NULL)
+				oval_variable_add_value(variable, value);
+		}
+		break;
+	}
+	case OVAL_VARIABLE_EXTERNAL: {
+		uint32_t count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+		for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+			const char *hint = oscap_cache_read_cstr(reader);
+			const char *value = oscap_cache_read_cstr(reader);
+			oval_variable_add_possible_value(variable, oval_variable_possible_value_new(hint, value));
+		}
+
+		count = oscap_cache_read_count(reader, 3 * sizeof(uint32_t));
+		for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+			oval_operator_t operator = oscap_cache_read_u32(reader);
+			const char *hint = oscap_cache_read_cstr(reader);
+			struct oval_variable_possible_restriction *pr = oval_variable_possible_restriction_new(operator, hint);
+			oval_variable_add_possible_restriction(variable, pr);
+
+			uint32_t restrictions = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+			for (uint32_t j = 0; j < restrictions && !reader->failed; ++j) {
+				oval_operation_t operation = oscap_cache_read_u32(reader);
+				const char *value = oscap_cache_read_cstr(reader);
+				oval_variable_possible_restriction_add_restriction(pr, oval_variable_restriction_new(operation, value));
+			}
+		}
+		break;
+	}
+	case OVAL_VARIABLE_LOCAL:
+		if (oscap_cache_read_bool(reader)) {
+			struct oval_component *component = _read_component(reader, model);
+			if (component != NULL)
+				oval_variable_set_component(variable, component);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void oval_definition_model_cache_write(struct oscap_buffer *buf, struct oval_definition_model *model)
+{
+	_write_generator(buf, oval_definition_model_get_generator(model));
+
+	struct oval_definition_iterator *definitions = oval_definition_model_get_definitions(model);
+	oscap_cache_write_u32(buf, _remaining(definitions));
+	while (oval_definition_iterator_has_more(definitions))
+		_write_definition(buf, oval_definition_iterator_next(definitions));
+	oval_definition_iterator_free(definitions);
+
+	struct oval_test_iterator *tests = oval_definition_model_get_tests(model);
+	oscap_cache_write_u32(buf, _remaining(tests));
+	while (oval_test_iterator_has_more(tests))
+		_write_test(buf, oval_test_iterator_next(tests));
+	oval_test_iterator_free(tests);
+
+	struct oval_object_iterator *objects = oval_definition_model_get_objects(model);
+	oscap_cache_write_u32(buf, _remaining(objects));
+	while (oval_object_iterator_has_more(objects))
+		_write_object(buf, oval_object_iterator_next(objects));
+	oval_object_iterator_free(objects);
+
+	struct oval_state_iterator *states = oval_definition_model_get_states(model);
+	oscap_cache_write_u32(buf, _remaining(states));
+	while (oval_state_iterator_has_more(states))
+		_write_state(buf, oval_state_iterator_next(states));
+	oval_state_iterator_free(states);
+
+	struct oval_variable_iterator *variables = oval_definition_model_get_variables(model);
+	oscap_cache_write_u32(buf, _remaining(variables));
+	while (oval_variable_iterator_has_more(variables))
+		_write_variable(buf, oval_variable_iterator_next(variables));
+	oval_variable_iterator_free(variables);
+}
+
+struct oval_definition_model *oval_definition_model_cache_read(struct oscap_cache_reader *reader)
+{
+	struct oval_definition_model *model = oval_definition_model_new();
+	if (model == NULL)
+		return NULL;
+
+	_read_generator(reader, oval_definition_model_get_generator(model));
+
+	uint32_t count = oscap_cache_read_count(reader, 7 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i)
+		_read_definition(reader, model);
+
+	count = oscap_cache_read_count(reader, 10 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i)
+		_read_test(reader, model);
+
+	count = oscap_cache_read_count(reader, 7 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i)
+		_read_object(reader, model);
+
+	count = oscap_cache_read_count(reader, 8 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i)
+		_read_state(reader, model);
+
+	count = oscap_cache_read_count(reader, 6 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i)
+		_read_variable(reader, model);
+
+	if (reader->failed) {
+		oval_definition_model_free(model);
+		return NULL;
+	}
+	return model;
+}
@@ -40,10 +40,12 @@
 #include "oval_parser_impl.h"
 #include "adt/oval_string_map_impl.h"
 #include "oval_system_characteristics_impl.h"
+#include "collectVarRefs_impl.h"
 #if defined(OVAL_PROBES_ENABLED)
 # include "oval_probe_impl.h"
 #endif
 #include "common/util.h"
+#include "common/list.h"
 #include "common/debug_priv.h"
 #include "common/_error.h"
 #include "common/elements.h"
@@ -243,12 +245,21 @@ static inline int _oval_definition_model_merge_source(struct oval_definition_mod
 
 struct oval_definition_model *oval_definition_model_import_source(struct oscap_source *source)
 {
-        struct oval_definition_model *model = oval_definition_model_new();
+	struct oval_definition_model *model = oscap_source_cache_load(source, OSCAP_CONTENT_CACHE_OVAL,
+			(oscap_content_cache_read_func) oval_definition_model_cache_read, (oscap_destruct_func) oval_definition_model_free);
+	if (model != NULL)
+		return model;
+
+        model = oval_definition_model_new();
 	int ret = _oval_definition_model_merge_source(model, source);
         if (ret == -1 ) {
                 oval_definition_model_free(model);
                 model = NULL;
-        }
+        } else if (ret == 0) {
+		// Content with warnings isn't stored so that they are reported on every run
+		oscap_source_cache_store(source, OSCAP_CONTENT_CACHE_OVAL,
+				(oscap_content_cache_write_func) oval_definition_model_cache_write, model);
+	}
 	return model;
 }
 
@@ -581,6 +592,68 @@ static void _fp_set_recurse(struct oval_definition_model *model, struct oval_set
 	oval_setobject_iterator_free(subset_itr);
 }
 
+static struct oval_string_map *_oval_definition_model_prune_map(struct oval_string_map *map,
+		struct oval_string_map *reachable, oscap_destruct_func free_func, int *removed)
+{
+	struct oval_string_map *pruned = oval_string_map_new();
+	struct oval_string_iterator *keys = (struct oval_string_iterator *) oval_string_map_keys(map);
+	while (oval_string_iterator_has_more(keys)) {
+		char *key = oval_string_iterator_next(keys);
+		void *item = oval_string_map_get_value(map, key);
+		if (oval_string_map_get_value(reachable, key) != NULL) {
+			oval_string_map_put(pruned, key, item);
+		} else {
+			free_func(item);
+			(*removed)++;
+		}
+	}
+	oval_string_iterator_free(keys);
+	oval_string_map_free(map, NULL);
+	oval_string_map_free(reachable, NULL);
+	return pruned;
+}
+
+int oval_definition_model_prune(struct oval_definition_model *model, struct oscap_htable *definition_ids)
+{
+	__attribute__nonnull__(model);
+
+	struct oval_refs refs = {
+		.definitions = oval_string_map_new(),
+		.tests = oval_string_map_new(),
+		.objects = oval_string_map_new(),
+		.states = oval_string_map_new(),
+		.variables = oval_string_map_new(),
+	};
+	struct oscap_htable_iterator *hit = oscap_htable_iterator_new(definition_ids);
+	while (oscap_htable_iterator_has_more(hit)) {
+		struct oval_definition *definition = oval_definition_model_get_definition(model, oscap_htable_iterator_next_key(hit));
+		if (definition != NULL)
+			oval_def_collect_refs(definition, &refs);
+	}
+	oscap_htable_iterator_free(hit);
+	/* External variables depend on nothing, XCCDF binds its check-exports to them */
+	struct oval_variable_iterator *var_itr = oval_definition_model_get_variables(model);
+	while (oval_variable_iterator_has_more(var_itr)) {
+		struct oval_variable *variable = oval_variable_iterator_next(var_itr);
+		if (oval_variable_get_type(variable) == OVAL_VARIABLE_EXTERNAL)
+			oval_string_map_put(refs.variables, oval_variable_get_id(variable), variable);
+	}
+	oval_variable_iterator_free(var_itr);
+
+	/* Nothing refers to the removed items from the reachable ones */
+	int removed = 0;
+	model->definition_map = _oval_definition_model_prune_map(model->definition_map, refs.definitions, (oscap_destruct_func) oval_definition_free, &removed);
+	model->test_map = _oval_definition_model_prune_map(model->test_map, refs.tests, (oscap_destruct_func) oval_test_free, &removed);
+	model->object_map = _oval_definition_model_prune_map(model->object_map, refs.objects, (oscap_destruct_func) oval_object_free, &removed);
+	model->state_map = _oval_definition_model_prune_map(model->state_map, refs.states, (oscap_destruct_func) oval_state_free, &removed);
+	model->variable_map = _oval_definition_model_prune_map(model->variable_map, refs.variables, (oscap_destruct_func) oval_variable_free, &removed);
+	if (model->vardef_map != NULL) {
+		oval_string_map_free(model->vardef_map, (oscap_destruct_func) oval_string_map_free0);
+		model->vardef_map = NULL;
+	}
+	return removed;
+}
+
 void oval_definition_model_optimize_by_filter_propagation(struct oval_definition_model *model)
 {
 	struct oval_object_iterator *obj_itr;
@@ -137,6 +137,13 @@ struct oval_string_iterator *oval_definition_get_notes(struct oval_definition *d
 	    oval_collection_iterator(definition->notes);
 }
 
+const char *oval_definition_get_anyxml(struct oval_definition *definition)
+{
+	__attribute__nonnull__(definition);
+
+	return definition->anyxml;
+}
+
 struct oval_criteria_node *oval_definition_get_criteria(struct oval_definition
 							*definition)
 {
@@ -296,6 +303,13 @@ void oval_definition_set_description(struct oval_definition *definition, char *d
 	definition->description = (description == NULL) ? NULL : oscap_strdup(description);
 }
 
+void oval_definition_set_anyxml(struct oval_definition *definition, const char *anyxml)
+{
+	__attribute__nonnull__(definition);
+	free(definition->anyxml);
+	definition->anyxml = oscap_strdup(anyxml);
+}
+
 void oval_definition_set_criteria(struct oval_definition *definition, struct oval_criteria_node *criteria)
 {
 	__attribute__nonnull__(definition);
@@ -86,6 +86,8 @@ int oval_reference_parse_tag(xmlTextReaderPtr, struct oval_parser_context *, ova
 
 int oval_definition_parse_tag(xmlTextReaderPtr reader, struct oval_parser_context *context, void *);
 xmlNode *oval_definition_to_dom(struct oval_definition *, xmlDoc *, xmlNode *);
+const char *oval_definition_get_anyxml(struct oval_definition *);
+void oval_definition_set_anyxml(struct oval_definition *, const char *);
 
 int oval_object_parse_tag(xmlTextReaderPtr reader, struct oval_parser_context *context, void *);
 xmlNode *oval_object_to_dom(struct oval_object *, xmlDoc *, xmlNode *);
@@ -123,6 +125,8 @@ int oval_behavior_parse_tag(xmlTextReaderPtr, struct oval_parser_context *,
 
 int oval_entity_parse_tag(xmlTextReaderPtr, struct oval_parser_context *, oscap_consumer_func, void *);
 xmlNode *oval_entity_to_dom(struct oval_entity *, xmlDoc *, xmlNode *);
+bool oval_entity_get_xsi_nil(const struct oval_entity *entity);
+void oval_entity_set_xsi_nil(struct oval_entity *entity, bool xsi_nil);
 
 int oval_record_field_parse_tag(xmlTextReaderPtr, struct oval_parser_context *,
 				oscap_consumer_func, void *, oval_record_field_type_t);
@@ -159,10 +163,23 @@ void oval_message_to_dom(struct oval_message *, xmlDoc *, xmlNode *);
 /* generator */
 int oval_generator_parse_tag(xmlTextReader *, struct oval_parser_context *, void *user);
 xmlNode *oval_generator_to_dom(struct oval_generator *, xmlDocPtr, xmlNode *);
+struct oscap_htable_iterator;
+struct oscap_htable_iterator *oval_generator_get_platform_schema_versions(struct oval_generator *);
+const char *oval_generator_get_anyxml(struct oval_generator *);
+void oval_generator_set_anyxml(struct oval_generator *, const char *);
 
 /* definition_model */
 xmlNode *oval_definition_model_to_dom(struct oval_definition_model *definition_model, xmlDocPtr doc, xmlNode * parent);
 void oval_definition_model_optimize_by_filter_propagation(struct oval_definition_model *);
+/* Drop everything the given definitions don't depend on, the ids are the keys
+ * of the table. Returns the number of removed items. */
+struct oscap_htable;
+int oval_definition_model_prune(struct oval_definition_model *model, struct oscap_htable *definition_ids);
+/* Serialization for the content cache, see common/oscap_content_cache.h */
+struct oscap_buffer;
+struct oscap_cache_reader;
+void oval_definition_model_cache_write(struct oscap_buffer *buf, struct oval_definition_model *model);
+struct oval_definition_model *oval_definition_model_cache_read(struct oscap_cache_reader *reader);
 
 struct oval_definition *oval_definition_model_get_new_definition(struct oval_definition_model *, const char *);
 struct oval_test       *oval_definition_model_get_new_test(struct oval_definition_model *, const char *);
@@ -46,6 +46,7 @@
 #include "common/debug_priv.h"
 #include "common/elements.h"
 #include "common/_error.h"
+#include "common/oscap_intern.h"
 
 /***************************************************************************/
 /* Variable definitions
@@ -73,9 +74,6 @@ struct oval_consume_varref_context {
 /* End of variable definitions
  * */
 /***************************************************************************/
-static inline bool oval_entity_get_xsi_nil(const struct oval_entity *entity);
-static inline void oval_entity_set_xsi_nil(struct oval_entity *entity, bool xsi_nil);
-
 
 bool oval_entity_iterator_has_more(struct oval_entity_iterator *oc_entity)
 {
@@ -131,7 +129,7 @@ int oval_entity_get_mask(struct oval_entity *entity)
 	return entity->mask;
 }
 
-static inline bool oval_entity_get_xsi_nil(const struct oval_entity *entity)
+bool oval_entity_get_xsi_nil(const struct oval_entity *entity)
 {
 	__attribute__nonnull__(entity);
 	return entity->xsi_nil;
@@ -209,8 +207,7 @@ void oval_entity_free(struct oval_entity *entity)
 
 	if (entity->value != NULL)
 		oval_value_free(entity->value);
-	if (entity->name != NULL)
-		free(entity->name);
+	oscap_intern_release(entity->name);
 
 	entity->name = NULL;
 	entity->value = NULL;
@@ -242,7 +239,7 @@ void oval_entity_set_mask(struct oval_entity *entity, int mask)
 	entity->mask = mask;
 }
 
-static inline void oval_entity_set_xsi_nil(struct oval_entity *entity, bool xsi_nil)
+void oval_entity_set_xsi_nil(struct oval_entity *entity, bool xsi_nil)
 {
 	__attribute__nonnull__(entity);
 	entity->xsi_nil = xsi_nil;
@@ -269,9 +266,9 @@ void oval_entity_set_value(struct oval_entity *entity, struct oval_value *value)
 void oval_entity_set_name(struct oval_entity *entity, char *name)
 {
 	__attribute__nonnull__(entity);
-	if (entity->name != NULL)
-		free(entity->name);
-	entity->name = (name == NULL) ? NULL : oscap_strdup(name);
+	const char *interned = oscap_intern(name);
+	oscap_intern_release(entity->name);
+	entity->name = (char *) interned;
 }
 
 static void oval_consume_varref(char *varref, void *user)
@@ -115,6 +115,16 @@ char *oval_generator_get_timestamp(struct oval_generator *generator)
 	return generator->timestamp;
 }
 
+struct oscap_htable_iterator *oval_generator_get_platform_schema_versions(struct oval_generator *generator)
+{
+	return oscap_htable_iterator_new(generator->platform_schema_versions);
+}
+
+const char *oval_generator_get_anyxml(struct oval_generator *generator)
+{
+	return generator->anyxml;
+}
+
 const char *oval_generator_get_platform_schema_version (struct oval_generator *generator, const char *platform)
 {
 	char *platform_schema_version = oscap_htable_get(generator->platform_schema_versions, platform);
@@ -149,6 +159,12 @@ void oval_generator_set_timestamp(struct oval_generator *generator, const char *
 	generator->timestamp = oscap_strdup(timestamp);
 }
 
+void oval_generator_set_anyxml(struct oval_generator *generator, const char *anyxml)
+{
+	free(generator->anyxml);
+	generator->anyxml = oscap_strdup(anyxml);
+}
+
 void oval_generator_update_timestamp(struct oval_generator *generator)
 {
 	time_t et;
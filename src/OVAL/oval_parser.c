@@ -76,8 +76,8 @@ char *oval_determine_document_schema_version_priv(xmlTextReader *reader, oscap_d
 	char *version = NULL;
 
 	/* find root element */
-	while (xmlTextReaderRead(reader) == 1
-	       && xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT);
+	while (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT
+	       && xmlTextReaderRead(reader) == 1);
 	/* verify document type */
 	switch (doc_type) {
 	case OSCAP_DOCUMENT_OVAL_DEFINITIONS:
@@ -167,6 +167,118 @@ int oval_probe_query_object(oval_probe_session_t *psess, struct oval_object *obj
 	return 0;
 }
 
+/*
+ * Objects made of plain entities don't depend on anything else and can be
+ * collected in any order. Objects with variables, sets or filters need other
+ * objects to be evaluated first and are left to oval_probe_query_object().
+ */
+static bool _object_is_self_contained(struct oval_object *object)
+{
+	bool ret = true;
+	struct oval_object_content_iterator *cont_itr;
+
+	cont_itr = oval_object_get_object_contents(object);
+	while (ret && oval_object_content_iterator_has_more(cont_itr)) {
+		struct oval_object_content *cont;
+
+		cont = oval_object_content_iterator_next(cont_itr);
+		if (oval_object_content_get_type(cont) != OVAL_OBJECTCONTENT_ENTITY
+		    || oval_entity_get_varref_type(oval_object_content_get_entity(cont)) != OVAL_ENTITY_VARREF_NONE)
+			ret = false;
+	}
+	oval_object_content_iterator_free(cont_itr);
+
+	return ret;
+}
+
+static void _criteria_collect_objects(struct oval_criteria_node *node, struct oval_string_map *defs, struct oval_string_map *objs)
+{
+	struct oval_criteria_node_iterator *node_itr;
+	struct oval_definition *def;
+	struct oval_test *test;
+	struct oval_object *object;
+
+	if (node == NULL)
+		return;
+
+	switch (oval_criteria_node_get_type(node)) {
+	case OVAL_NODETYPE_CRITERIA:
+		node_itr = oval_criteria_node_get_subnodes(node);
+		while (oval_criteria_node_iterator_has_more(node_itr))
+			_criteria_collect_objects(oval_criteria_node_iterator_next(node_itr), defs, objs);
+		oval_criteria_node_iterator_free(node_itr);
+		break;
+	case OVAL_NODETYPE_CRITERION:
+		test = oval_criteria_node_get_test(node);
+		object = test ? oval_test_get_object(test) : NULL;
+		/* oval_probe_query_test() refuses such tests, skip them here as well */
+		if (object == NULL || oval_test_get_subtype(test) != oval_object_get_subtype(object))
+			break;
+		if (_object_is_self_contained(object))
+			oval_string_map_put(objs, oval_object_get_id(object), object);
+		break;
+	case OVAL_NODETYPE_EXTENDDEF:
+		def = oval_criteria_node_get_definition(node);
+		if (def == NULL || oval_string_map_get_value(defs, oval_definition_get_id(def)) != NULL)
+			break;
+		oval_string_map_put(defs, oval_definition_get_id(def), def);
+		_criteria_collect_objects(oval_definition_get_criteria(def), defs, objs);
+		break;
+	default:
+		break;
+	}
+}
+
+int oval_probe_query_definitions(oval_probe_session_t *sess, struct oval_definition_model *model, unsigned int max_threads)
+{
+	struct oval_definition_iterator *def_itr;
+	struct oval_string_map *defs, *objs;
+	struct oval_iterator *obj_itr;
+	struct oval_syschar **sysc;
+	size_t count = 0, size = 64;
+	int ret;
+
+	defs = oval_string_map_new();
+	objs = oval_string_map_new();
+
+	def_itr = oval_definition_model_get_definitions(model);
+	while (oval_definition_iterator_has_more(def_itr)) {
+		struct oval_definition *def = oval_definition_iterator_next(def_itr);
+
+		if (oval_string_map_get_value(defs, oval_definition_get_id(def)) != NULL)
+			continue;
+		oval_string_map_put(defs, oval_definition_get_id(def), def);
+		_criteria_collect_objects(oval_definition_get_criteria(def), defs, objs);
+	}
+	oval_definition_iterator_free(def_itr);
+
+	sysc = malloc(size * sizeof(struct oval_syschar *));
+	obj_itr = oval_string_map_values(objs);
+	while (oval_collection_iterator_has_more(obj_itr)) {
+		struct oval_object *object = oval_collection_iterator_next(obj_itr);
+
+		/* already collected by a previous evaluation */
+		if (oval_syschar_model_get_syschar(sess->sys_model, oval_object_get_id(object)) != NULL)
+			continue;
+		if (oval_probe_handler_get(sess->ph, oval_object_get_subtype(object)) == NULL)
+			continue;
+		if (count == size) {
+			size *= 2;
+			sysc = realloc(sysc, size * sizeof(struct oval_syschar *));
+		}
+		sysc[count++] = oval_syschar_new(sess->sys_model, object);
+	}
+	oval_collection_iterator_free(obj_itr);
+
+	dI("Collecting %zu self-contained objects in parallel.", count);
+	ret = oval_probe_ext_eval_batch(sess->pext, sysc, count, max_threads);
+
+	free(sysc);
+	oval_string_map_free(objs, NULL);
+	oval_string_map_free(defs, NULL);
+	return ret;
+}
+
 int oval_probe_query_sysinfo(oval_probe_session_t *sess, struct oval_sysinfo **out_sysinfo)
 {
 	struct oval_sysinfo *sysinf;
@@ -47,6 +47,7 @@
 #include "oval_sexp.h"
 #include "probe-table.h"
 #include "_oval_probe_handler.h"
+#include "_oval_probe_session.h"
 
 #define __ERRBUF_SIZE 128
 
@@ -432,7 +433,6 @@ static int oval_probe_comm(SEAP_CTX_t *ctx, oval_pd_t *pd, const SEXP_t *s_iobj,
 		return -1;
 	}
 
-	ctx->subtype = pd->subtype;
 	for (retry = 0;;) {
 		/*
 		 * Establish connection to probe. The connection may be
@@ -440,6 +440,7 @@ static int oval_probe_comm(SEAP_CTX_t *ctx, oval_pd_t *pd, const SEXP_t *s_iobj,
 		 * by the probe context handling functions.
 		 */
 		if (pd->sd == -1) {
+			ctx->subtype = pd->subtype;
 			pd->sd = SEAP_connect(ctx);
 
 			if (pd->sd < 0) {
@@ -795,6 +796,47 @@ int oval_probe_sys_handler(oval_subtype_t type, void *ptr, int act, ...)
         return(ret);
 }
 
+/*
+ * Look up the probe descriptor of the given subtype, adding a new one to the
+ * table if the probe wasn't used yet. Returns 1 if there is no probe for the
+ * subtype.
+ */
+static int oval_probe_ext_getpd(oval_pext_t *pext, oval_subtype_t subtype, oval_pd_t **out_pd)
+{
+	oval_pd_t *pd = oval_pdtbl_get(pext->pdtbl, subtype);
+
+	if (pd == NULL) {
+		char         probe_uri[PATH_MAX + 1];
+		size_t       probe_urilen;
+
+		if (!probe_table_exists(subtype))
+			return (1);
+
+		probe_urilen = snprintf(probe_uri, sizeof probe_uri, "%s://%s",
+				OVAL_PROBE_SCHEME, oval_subtype_get_text(subtype));
+
+		if (probe_urilen >= sizeof probe_uri) {
+			oscap_seterr (OSCAP_EFAMILY_GLIBC, "probe URI too long");
+			return (-1);
+		}
+
+		dI("Starting probe on URI '%s'.", probe_uri);
+
+		if (oval_pdtbl_add(pext->pdtbl, subtype, -1, probe_uri) != 0)
+			return (1);
+
+		pd = oval_pdtbl_get(pext->pdtbl, subtype);
+
+		if (pd == NULL) {
+			oscap_seterr (OSCAP_EFAMILY_OVAL, "internal error");
+			return (-1);
+		}
+	}
+
+	*out_pd = pd;
+	return (0);
+}
+
 int oval_probe_ext_handler(oval_subtype_t type, void *ptr, int act, ...)
 {
         int          ret = 0;
@@ -815,45 +857,16 @@ int oval_probe_ext_handler(oval_subtype_t type, void *ptr, int act, ...)
 		flags = va_arg(ap, int);
 		obj = oval_syschar_get_object(sys);
 		oval_subtype_t obj_subtype = oval_object_get_subtype(obj);
-		pd = oval_pdtbl_get(pext->pdtbl, obj_subtype);
-
-                if (pd == NULL) {
-                        char         probe_uri[PATH_MAX + 1];
-                        size_t       probe_urilen;
-
-			if (!probe_table_exists(obj_subtype)) {
-				oval_syschar_add_new_message(sys, "OVAL object not supported", OVAL_MESSAGE_LEVEL_WARNING);
-				oval_syschar_set_flag(sys, SYSCHAR_FLAG_NOT_COLLECTED);
-				va_end(ap);
-				return (1);
-			}
-
-			probe_urilen = snprintf(probe_uri, sizeof probe_uri, "%s://%s",
-					OVAL_PROBE_SCHEME, oval_subtype_get_text(obj_subtype));
-
-                        if (probe_urilen >= sizeof probe_uri) {
-                                oscap_seterr (OSCAP_EFAMILY_GLIBC, "probe URI too long");
-				va_end(ap);
-                                return (-1);
-                        }
-
-                        dI("Starting probe on URI '%s'.", probe_uri);
 
-                        if (oval_pdtbl_add(pext->pdtbl, obj_subtype, -1, probe_uri) != 0) {
+		ret = oval_probe_ext_getpd(pext, obj_subtype, &pd);
+		if (ret != 0) {
+			if (ret == 1) {
 				oval_syschar_add_new_message(sys, "OVAL object not supported", OVAL_MESSAGE_LEVEL_WARNING);
 				oval_syschar_set_flag(sys, SYSCHAR_FLAG_NOT_COLLECTED);
-				va_end(ap);
-                                return (1);
 			}
-
-			pd = oval_pdtbl_get(pext->pdtbl, obj_subtype);
-
-                        if (pd == NULL) {
-                                oscap_seterr (OSCAP_EFAMILY_OVAL, "internal error");
-				va_end(ap);
-                                return (-1);
-                        }
-                }
+			va_end(ap);
+			return (ret);
+		}
 
 		ret = oval_probe_ext_eval(pext->pdtbl->ctx, pd, pext, sys, flags);
 
@@ -960,10 +973,18 @@ int oval_probe_ext_init(oval_pext_t *pext)
         return(ret);
 }
 
-int oval_probe_ext_eval(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext, struct oval_syschar *syschar, int flags)
+/*
+ * Evaluate one object. If model_lock isn't NULL, it is held while the object
+ * is converted to and from S-expressions, because the syschar model is shared
+ * with the other collection lanes. The probe itself is queried unlocked.
+ */
+static int oval_probe_ext_eval_locked(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext,
+		struct oval_syschar *syschar, int flags, pthread_mutex_t *model_lock)
 {
         SEXP_t *s_obj, *s_sys;
 	struct oval_object *object;
+	struct oval_collection_cache *cache;
+	struct oval_collection_cache_slot *slot = NULL;
 	int ret;
 
 	if (syschar == NULL) {
@@ -972,13 +993,26 @@ int oval_probe_ext_eval(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext, struc
 	}
 
 	object = oval_syschar_get_object(syschar);
+	if (model_lock != NULL)
+		pthread_mutex_lock(model_lock);
 	ret = oval_object_to_sexp(pext->sess_ptr, oval_subtype_to_str(oval_object_get_subtype(object)), syschar, &s_obj);
+	if (model_lock != NULL)
+		pthread_mutex_unlock(model_lock);
 
 	if (ret != 0)
 		return (1);
 
+	cache = ((oval_probe_session_t *) pext->sess_ptr)->cache;
+	if (cache != NULL && !(flags & OVAL_PDFLAG_NOREPLY)
+	    && (s_sys = oval_collection_cache_get(cache, pd->subtype, s_obj, &slot)) != NULL) {
+		SEXP_free(s_obj);
+		goto convert;
+	}
+
 	ret = oval_probe_comm(ctx, pd, s_obj, flags, &s_sys);
 	SEXP_free(s_obj);
+	if (slot != NULL)
+		oval_collection_cache_put(cache, slot, ret == 0 ? s_sys : NULL);
 
 	if (ret != 0) {
 		switch (errno) {
@@ -1013,12 +1047,153 @@ int oval_probe_ext_eval(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext, struc
         /*
 	 * Convert the received S-exp to OVAL system characteristic.
 	 */
+convert:
+	if (model_lock != NULL)
+		pthread_mutex_lock(model_lock);
 	ret = oval_sexp_to_sysch(s_sys, syschar);
+	if (model_lock != NULL)
+		pthread_mutex_unlock(model_lock);
 	SEXP_free(s_sys);
 
 	return (ret);
 }
 
+int oval_probe_ext_eval(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext, struct oval_syschar *syschar, int flags)
+{
+	return oval_probe_ext_eval_locked(ctx, pd, pext, syschar, flags, NULL);
+}
+
+/*
+ * All objects of one probe type. A lane is collected by a single thread, one
+ * request at a time, because replies on a probe descriptor are not matched
+ * to the requests by their ID.
+ */
+struct oval_probe_ext_lane {
+	oval_pd_t *pd;
+	struct oval_syschar **sysc;
+	size_t count;
+};
+
+struct oval_probe_ext_batch {
+	oval_pext_t *pext;
+	struct oval_probe_ext_lane *lanes;
+	size_t lane_count;
+	size_t next_lane;
+	pthread_mutex_t lock; /* guards next_lane and the syschar model */
+};
+
+static void *oval_probe_ext_lane_worker(void *arg)
+{
+	struct oval_probe_ext_batch *batch = arg;
+
+	for (;;) {
+		struct oval_probe_ext_lane *lane;
+
+		pthread_mutex_lock(&batch->lock);
+		if (batch->next_lane == batch->lane_count) {
+			pthread_mutex_unlock(&batch->lock);
+			break;
+		}
+		lane = &batch->lanes[batch->next_lane++];
+		pthread_mutex_unlock(&batch->lock);
+
+		for (size_t i = 0; i < lane->count; ++i) {
+			/*
+			 * Objects which fail here keep the unknown flag and are
+			 * collected again by oval_probe_query_object().
+			 */
+			if (oval_probe_ext_eval_locked(batch->pext->pdtbl->ctx, lane->pd, batch->pext,
+					lane->sysc[i], 0, &batch->lock) < 0) {
+				dW("Parallel collection of %s objects stopped after %zu of %zu objects.",
+				   oval_subtype_get_text(lane->pd->subtype), i, lane->count);
+				break;
+			}
+		}
+	}
+	/* Errors are reported again by the sequential collection. */
+	oscap_clearerr();
+	return NULL;
+}
+
+int oval_probe_ext_eval_batch(oval_pext_t *pext, struct oval_syschar **sysc, size_t count, unsigned int max_threads)
+{
+	struct oval_probe_ext_batch batch;
+	size_t thread_count;
+	pthread_t *threads;
+
+	if (count == 0)
+		return (0);
+	if (oval_probe_ext_init(pext) != 0)
+		return (-1);
+
+	batch.pext = pext;
+	batch.lanes = calloc(count, sizeof(struct oval_probe_ext_lane));
+	batch.lane_count = 0;
+	batch.next_lane = 0;
+
+	/*
+	 * Group the objects by probe and make sure the probes are running. The
+	 * probe descriptor table is only modified here, in the calling thread.
+	 */
+	for (size_t i = 0; i < count; ++i) {
+		oval_subtype_t subtype = oval_object_get_subtype(oval_syschar_get_object(sysc[i]));
+		struct oval_probe_ext_lane *lane = NULL;
+		oval_pd_t *pd;
+
+		for (size_t l = 0; l < batch.lane_count; ++l) {
+			if (batch.lanes[l].pd->subtype == subtype) {
+				lane = &batch.lanes[l];
+				break;
+			}
+		}
+		if (lane == NULL) {
+			if (oval_probe_ext_getpd(pext, subtype, &pd) != 0)
+				continue;
+			if (pd->sd == -1) {
+				pext->pdtbl->ctx->subtype = pd->subtype;
+				pd->sd = SEAP_connect(pext->pdtbl->ctx);
+				if (pd->sd < 0) {
+					dW("Can't connect to the %s probe, leaving its objects to the sequential collection.",
+					   oval_subtype_get_text(subtype));
+					pd->sd = -1;
+					continue;
+				}
+			}
+			lane = &batch.lanes[batch.lane_count++];
+			lane->pd = pd;
+			lane->sysc = malloc(count * sizeof(struct oval_syschar *));
+			lane->count = 0;
+		}
+		lane->sysc[lane->count++] = sysc[i];
+	}
+	oscap_clearerr();
+
+	thread_count = batch.lane_count < max_threads ? batch.lane_count : max_threads;
+	dI("Collecting %zu objects of %zu probe types in %zu threads.", count, batch.lane_count, thread_count);
+
+	pthread_mutex_init(&batch.lock, NULL);
+	threads = malloc(thread_count * sizeof(pthread_t));
+	size_t started = 0;
+	for (; started < thread_count; ++started) {
+		if (pthread_create(&threads[started], NULL, oval_probe_ext_lane_worker, &batch) != 0) {
+			dW("Can't start a collection thread: %s.", strerror(errno));
+			break;
+		}
+	}
+	/* The calling thread takes the remaining lanes if no thread started. */
+	if (started == 0)
+		oval_probe_ext_lane_worker(&batch);
+	for (size_t t = 0; t < started; ++t)
+		pthread_join(threads[t], NULL);
+	free(threads);
+	pthread_mutex_destroy(&batch.lock);
+
+	for (size_t l = 0; l < batch.lane_count; ++l)
+		free(batch.lanes[l].sysc);
+	free(batch.lanes);
+	return (0);
+}
+
 int oval_probe_ext_reset(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext)
 {
         SEAP_cmd_exec(ctx, pd->sd, SEAP_EXEC_RECV, PROBECMD_RESET, NULL, SEAP_CMDTYPE_SYNC, NULL, NULL);
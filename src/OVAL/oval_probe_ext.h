@@ -58,6 +58,11 @@ oval_pext_t *oval_pext_new(void);
 void oval_pext_free(oval_pext_t *pext);
 int oval_probe_ext_init(oval_pext_t *pext);
 int oval_probe_ext_eval(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext, struct oval_syschar *syschar, int flags);
+/*
+ * Collect the given syschars, running up to max_threads probes of different
+ * types at once. Syschars which couldn't be collected keep the unknown flag.
+ */
+int oval_probe_ext_eval_batch(oval_pext_t *pext, struct oval_syschar **sysc, size_t count, unsigned int max_threads);
 int oval_probe_ext_reset(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext);
 int oval_probe_ext_abort(SEAP_CTX_t *ctx, oval_pd_t *pd, oval_pext_t *pext);
 
@@ -50,6 +50,28 @@
 
 int oval_probe_query_test(oval_probe_session_t *sess, struct oval_test *test);
 
+/*
+ * Collect the objects of all tests in the model which don't depend on other
+ * objects or variables, running up to max_threads probes at once. Objects
+ * that failed keep the unknown flag so that oval_probe_query_test() collects
+ * them again.
+ */
+int oval_probe_query_definitions(oval_probe_session_t *sess, struct oval_definition_model *model, unsigned int max_threads);
+
+/*
+ * Use the persistent collection cache configured by OSCAP_COLLECTION_CACHE_DIR
+ * or stop using it. The cache is used by default when it's configured.
+ */
+void oval_probe_session_set_collection_cache(oval_probe_session_t *sess, bool enabled);
+
+/*
+ * Drop the snapshots of the system which the probes share during a scan
+ * (process table, kernel parameters, directory listings), so that the
+ * objects collected from now on see the changes made to the system, e.g.
+ * by a remediation.
+ */
+void oval_probe_system_changed(void);
+
 
 extern probe_ncache_t *OSCAP_GSYM(ncache);
 
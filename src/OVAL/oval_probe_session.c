@@ -39,6 +39,8 @@
 #include "common/_error.h"
 #include "common/bfind.h"
 #include "common/debug_priv.h"
+#include "common/oscap_intern.h"
+#include "common/oscap_pcre.h"
 
 
 #include "public/oval_definitions.h"
@@ -47,6 +49,9 @@
 #include "oval_probe_impl.h"
 #include "oval_probe_ext.h"
 #include "probe-table.h"
+#if !defined(OS_WINDOWS)
+#include "oval_fts_walk.h"
+#endif
 #include "oval_types.h"
 #include "crapi/crapi.h"
 
@@ -133,6 +138,7 @@ static void oval_probe_session_init(oval_probe_session_t *sess, struct oval_sysc
         sess->pext = oval_pext_new();
         sess->pext->model    = &sess->sys_model;
         sess->pext->sess_ptr = sess;
+        sess->varref_values = oval_string_map_new();
 
         __init_once();
 
@@ -155,6 +161,10 @@ oval_probe_session_t *oval_probe_session_new(struct oval_syschar_model *model)
 {
         oval_probe_session_t *sess = malloc(sizeof(oval_probe_session_t));
         oval_probe_session_init(sess, model);
+        sess->cache = oval_collection_cache_new_from_env();
+#if !defined(OS_WINDOWS)
+	oval_walk_cache_acquire();
+#endif
         return sess;
 }
 
@@ -167,6 +177,7 @@ static void oval_probe_session_free(oval_probe_session_t *sess)
 
 	oval_phtbl_free(sess->ph);
 	oval_pext_free(sess->pext);
+	oval_string_map_free(sess->varref_values, (oscap_destruct_func) SEXP_free);
 }
 
 void oval_probe_session_reinit(oval_probe_session_t *sess, struct oval_syschar_model *model)
@@ -174,14 +185,43 @@ void oval_probe_session_reinit(oval_probe_session_t *sess, struct oval_syschar_m
 	oval_probe_session_free(sess);
 
 	oval_probe_session_init(sess, model);
+#if !defined(OS_WINDOWS)
+	/* the session starts with new probes, they shouldn't see the listings of the old ones */
+	oval_walk_cache_clear();
+#endif
 }
 
 void oval_probe_session_destroy(oval_probe_session_t *sess)
 {
+	oscap_pcre_cache_log_stats();
+	oscap_intern_log_stats();
+#if !defined(OS_WINDOWS)
+	oval_walk_cache_log_stats();
+	oval_walk_cache_release();
+#endif
 	oval_probe_session_free(sess);
+	oval_collection_cache_free(sess->cache);
 	free(sess);
 }
 
+void oval_probe_session_set_collection_cache(oval_probe_session_t *sess, bool enabled)
+{
+	if (!enabled) {
+		oval_collection_cache_free(sess->cache);
+		sess->cache = NULL;
+	} else if (sess->cache == NULL) {
+		sess->cache = oval_collection_cache_new_from_env();
+	}
+}
+
+void oval_probe_system_changed(void)
+{
+#if !defined(OS_WINDOWS)
+	/* the probes drop their snapshots when the walk cache generation changes */
+	oval_walk_cache_clear();
+#endif
+}
+
 int oval_probe_session_reset(oval_probe_session_t *sess, struct oval_syschar_model *sysch)
 {
         oval_ph_t *ph;
@@ -194,6 +234,13 @@ int oval_probe_session_reset(oval_probe_session_t *sess, struct oval_syschar_mod
         if (ph->func(OVAL_SUBTYPE_ALL, ph->uptr, PROBE_HANDLER_ACT_RESET) != 0) {
                 return(-1);
         }
+#if !defined(OS_WINDOWS)
+	/* the next scan shouldn't see the directories listed by the previous one */
+	oval_walk_cache_clear();
+#endif
+	/* the variables may get other values in the next scan */
+	oval_string_map_free(sess->varref_values, (oscap_destruct_func) SEXP_free);
+	sess->varref_values = oval_string_map_new();
         if (sysch != NULL)
                 sess->sys_model = sysch;
 
@@ -43,6 +43,7 @@
 #include <assert.h>
 
 #include "oval_probe_impl.h"
+#include "_oval_probe_session.h"
 #include "oval_sexp.h"
 #include "probes/public/probe-api.h"
 #include "oval_definitions_impl.h"
@@ -50,6 +51,7 @@
 #include "adt/oval_string_map_impl.h"
 #include "common/debug_priv.h"
 #include "common/_error.h"
+#include "common/oscap_intern.h"
 #include "public/oval_schema_version.h"
 
 
@@ -156,10 +158,63 @@ static SEXP_t *oval_entity_to_sexp(struct oval_entity *ent)
 	return (elm);
 }
 
+/*
+ * Return a new reference to the list of the values of the variable converted
+ * to the datatype dt. The lists are memoized in the probe session, so that all
+ * the objects and states which reference a variable share one list instead of
+ * converting its values again for every reference. On failure NULL is returned
+ * and *bad_val is set to the value which couldn't be converted.
+ */
+static SEXP_t *oval_varref_values_to_sexp(oval_probe_session_t *sess, struct oval_variable *var, oval_datatype_t dt,
+					  unsigned int *val_cnt, struct oval_value **bad_val)
+{
+	const char *var_id = oval_variable_get_id(var);
+	const size_t key_len = strlen(var_id) + 16;
+	char *key;
+	SEXP_t *val_lst;
+	struct oval_value_iterator *val_itr;
+
+	key = malloc(key_len);
+	snprintf(key, key_len, "%d:%s", dt, var_id);
+	val_lst = oval_string_map_get_value(sess->varref_values, key);
+	if (val_lst != NULL) {
+		free(key);
+		*val_cnt = SEXP_list_length(val_lst);
+		return SEXP_ref(val_lst);
+	}
+
+	val_lst = SEXP_list_new(NULL);
+	*val_cnt = 0;
+
+	val_itr = oval_variable_get_values(var);
+	while (oval_value_iterator_has_more(val_itr)) {
+		struct oval_value *val;
+		SEXP_t *vs;
+
+		val = oval_value_iterator_next(val_itr);
+		vs = oval_value_to_sexp(val, dt);
+		if (vs == NULL) {
+			*bad_val = val;
+			oval_value_iterator_free(val_itr);
+			SEXP_free(val_lst);
+			free(key);
+			return NULL;
+		}
+		SEXP_list_add(val_lst, vs);
+		SEXP_free(vs);
+		++(*val_cnt);
+	}
+	oval_value_iterator_free(val_itr);
+
+	oval_string_map_put(sess->varref_values, key, SEXP_ref(val_lst));
+	free(key);
+	return val_lst;
+}
+
 static int oval_varref_attr_to_sexp(void *sess, struct oval_entity *entity, struct oval_syschar *syschar, SEXP_t **out_sexp)
 {
 	unsigned int val_cnt = 0;
-	SEXP_t *val_lst, *val_sexp, *varref, *id_sexp, *val_cnt_sexp;
+	SEXP_t *val_lst, *varref, *id_sexp, *val_cnt_sexp;
 	oval_datatype_t dt;
 	struct oval_variable *var;
 	struct oval_value_iterator *vit;
@@ -200,26 +255,15 @@ static int oval_varref_attr_to_sexp(void *sess, struct oval_entity *entity, stru
 		return ret;
 	}
 
-	val_lst = SEXP_list_new(NULL);
-
-	while (oval_value_iterator_has_more(vit)) {
-		val = oval_value_iterator_next(vit);
-
-		dt = oval_entity_get_datatype(entity);
-		val_sexp = oval_value_to_sexp(val, dt);
-		if (val_sexp == NULL) {
-			oval_syschar_add_new_message(syschar, "Failed to convert variable value.", OVAL_MESSAGE_LEVEL_ERROR);
-			oval_syschar_set_flag(syschar, SYSCHAR_FLAG_ERROR);
-			SEXP_free(val_lst);
-			oval_value_iterator_free(vit);
-			return -1;
-		}
+	oval_value_iterator_free(vit);
 
-		SEXP_list_add(val_lst, val_sexp);
-		SEXP_free(val_sexp);
-		++val_cnt;
+	dt = oval_entity_get_datatype(entity);
+	val_lst = oval_varref_values_to_sexp(sess, var, dt, &val_cnt, &val);
+	if (val_lst == NULL) {
+		oval_syschar_add_new_message(syschar, "Failed to convert variable value.", OVAL_MESSAGE_LEVEL_ERROR);
+		oval_syschar_set_flag(syschar, SYSCHAR_FLAG_ERROR);
+		return -1;
 	}
-	oval_value_iterator_free(vit);
 
 	id_sexp = SEXP_string_newf("%s", oval_variable_get_id(var));
 	val_cnt_sexp = SEXP_number_newu(val_cnt);
@@ -236,8 +280,9 @@ static int oval_varref_attr_to_sexp(void *sess, struct oval_entity *entity, stru
 
 static int oval_varref_elm_to_sexp(void *sess, struct oval_variable *var, oval_datatype_t dt, SEXP_t **out_sexp, struct oval_syschar *syschar)
 {
+	unsigned int val_cnt;
 	SEXP_t *val_lst;
-	struct oval_value_iterator *val_itr;
+	struct oval_value *val;
 	oval_syschar_collection_flag_t flag;
 
 	if (oval_probe_query_variable(sess, var) != 0)
@@ -260,27 +305,13 @@ static int oval_varref_elm_to_sexp(void *sess, struct oval_variable *var, oval_d
 		return 0;
 	}
 
-	val_lst = SEXP_list_new(NULL);
-
-	val_itr = oval_variable_get_values(var);
-	while (oval_value_iterator_has_more(val_itr)) {
-		struct oval_value *val;
-		SEXP_t *vs;
-
-		val = oval_value_iterator_next(val_itr);
-		vs = oval_value_to_sexp(val, dt);
-		if (vs == NULL) {
-			oscap_seterr(OSCAP_EFAMILY_OVAL, "Failed to convert OVAL value to SEXP: "
-                                       "datatype: %s, text: %s.", oval_datatype_get_text(dt),
-                                       oval_value_get_text(val));
-			oval_value_iterator_free(val_itr);
-			SEXP_free(val_lst);
-			return -1;
-		}
-		SEXP_list_add(val_lst, vs);
-		SEXP_free(vs);
+	val_lst = oval_varref_values_to_sexp(sess, var, dt, &val_cnt, &val);
+	if (val_lst == NULL) {
+		oscap_seterr(OSCAP_EFAMILY_OVAL, "Failed to convert OVAL value to SEXP: "
+			     "datatype: %s, text: %s.", oval_datatype_get_text(dt),
+			     oval_value_get_text(val));
+		return -1;
 	}
-	oval_value_iterator_free(val_itr);
 
 	*out_sexp = val_lst;
 	return 0;
@@ -815,6 +846,7 @@ static struct oval_message *oval_sexp_to_msg(const SEXP_t *msg)
 static struct oval_sysent *oval_sexp_to_sysent(struct oval_syschar_model *model, struct oval_sysitem *item, SEXP_t * sexp, struct oval_string_map *mask_map)
 {
 	char *key;
+	const char *name;
 	oval_syschar_status_t status;
 	oval_datatype_t dt;
 	struct oval_sysent *ent;
@@ -854,11 +886,19 @@ static struct oval_sysent *oval_sexp_to_sysent(struct oval_syschar_model *model,
 	status = probe_ent_getstatus(sexp);
 	dt = probe_ent_getdatatype(sexp);
 
+	/*
+	 * Entity names and boolean values repeat in every item, they're shared
+	 * through the string pool. String values are taken over as returned by
+	 * SEXP_string_cstr() without copying them once more.
+	 */
+	name = oscap_intern(key);
+	free(key);
+
 	ent = oval_sysent_new(model);
-	oval_sysent_set_name(ent, key);
+	oval_sysent_take_interned_name(ent, name);
 	oval_sysent_set_status(ent, status);
 	oval_sysent_set_datatype(ent, dt);
-	if (mask_map == NULL || oval_string_map_get_value(mask_map, key) == NULL)
+	if (mask_map == NULL || oval_string_map_get_value(mask_map, name) == NULL)
 		oval_sysent_set_mask(ent, 0);
 	else
 		oval_sysent_set_mask(ent, 1);
@@ -888,8 +928,10 @@ static struct oval_sysent *oval_sexp_to_sysent(struct oval_syschar_model *model,
 
 		switch (dt) {
 		case OVAL_DATATYPE_BOOLEAN:
-			snprintf(val, sizeof(val), "%s", SEXP_number_getb(sval) ? "true" : "false");
-			break;
+			oval_sysent_take_interned_value(ent,
+				oscap_intern(SEXP_number_getb(sval) ? "true" : "false"));
+			SEXP_free(sval);
+			return ent;
 		case OVAL_DATATYPE_FLOAT:
 			snprintf(val, sizeof(val), "%f", SEXP_number_getf(sval));
 			break;
@@ -909,7 +951,7 @@ static struct oval_sysent *oval_sexp_to_sysent(struct oval_syschar_model *model,
 				snprintf(val, sizeof(val), "%" PRIu64, SEXP_number_getu_64(sval));
 				break;
 			default:
-				dE("Unexpected SEXP number datatype: %d, name: '%s'.", sndt, key);
+				dE("Unexpected SEXP number datatype: %d, name: '%s'.", sndt, name);
 				valp = NULL;
 				break;
 			}
@@ -924,14 +966,15 @@ static struct oval_sysent *oval_sexp_to_sysent(struct oval_syschar_model *model,
 			break;
 		default:
 			dE("Unexpected OVAL datatype: %d, '%s', name: '%s'.",
-			   dt, oval_datatype_get_text(dt), key);
+			   dt, oval_datatype_get_text(dt), name);
 			valp = NULL;
 			break;
 		}
 
-		oval_sysent_set_value(ent, valp);
-		if (valp != val)
-			free(valp);
+		if (valp == val)
+			oval_sysent_set_value(ent, valp);
+		else
+			oval_sysent_take_value(ent, valp);
                 SEXP_free(sval);
 	}
 
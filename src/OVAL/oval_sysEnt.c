@@ -44,12 +44,14 @@
 #include "common/util.h"
 #include "common/debug_priv.h"
 #include "common/elements.h"
+#include "common/oscap_intern.h"
 
 typedef struct oval_sysent {
 	struct oval_syschar_model *model;
 	char *name;
 	char *value;
 	struct oval_collection *record_fields;
+	bool interned_value;	///< value is a reference to an oscap_intern() string
 	int mask;
 	oval_datatype_t datatype;
 	oval_syschar_status_t status;
@@ -64,6 +66,7 @@ struct oval_sysent *oval_sysent_new(struct oval_syschar_model *model)
 	sysent->name = NULL;
 	sysent->value = NULL;
 	sysent->record_fields = NULL;
+	sysent->interned_value = false;
 	sysent->status = SYSCHAR_STATUS_UNKNOWN;
 	sysent->datatype = OVAL_DATATYPE_UNKNOWN;
 	sysent->mask = 0;
@@ -77,12 +80,15 @@ struct oval_sysent *oval_sysent_clone(struct oval_syschar_model *new_model, stru
 
 	char *old_value = oval_sysent_get_value(old_item);
 	if (old_value) {
-		oval_sysent_set_value(new_item, old_value);
+		if (old_item->interned_value)
+			oval_sysent_take_interned_value(new_item, oscap_intern_ref(old_value));
+		else
+			oval_sysent_set_value(new_item, old_value);
 	}
 
 	char *old_name = oval_sysent_get_name(old_item);
 	if (old_name) {
-		oval_sysent_set_name(new_item, oscap_strdup(old_name));
+		oval_sysent_take_interned_name(new_item, oscap_intern_ref(old_name));
 	}
 
 	oval_sysent_set_datatype(new_item, oval_sysent_get_datatype(old_item));
@@ -97,9 +103,10 @@ void oval_sysent_free(struct oval_sysent *sysent)
 	if (sysent == NULL)
 		return;
 
-	if (sysent->name != NULL)
-		free(sysent->name);
-	if (sysent->value != NULL)
+	oscap_intern_release(sysent->name);
+	if (sysent->interned_value)
+		oscap_intern_release(sysent->value);
+	else
 		free(sysent->value);
 	if (sysent->record_fields)
 		oval_collection_free_items(sysent->record_fields, (oscap_destruct_func) oval_record_field_free);
@@ -172,11 +179,16 @@ int oval_sysent_get_mask(struct oval_sysent *sysent)
 }
 
 void oval_sysent_set_name(struct oval_sysent *sysent, char *name)
+{
+	oval_sysent_take_interned_name(sysent, oscap_intern(name));
+	free(name);
+}
+
+void oval_sysent_take_interned_name(struct oval_sysent *sysent, const char *name)
 {
 	__attribute__nonnull__(sysent);
-	if (sysent->name != NULL)
-		free(sysent->name);
-	sysent->name = name;
+	oscap_intern_release(sysent->name);
+	sysent->name = (char *) name;
 }
 
 void oval_sysent_set_status(struct oval_sysent *sysent, oval_syschar_status_t status)
@@ -198,11 +210,25 @@ void oval_sysent_set_mask(struct oval_sysent *sysent, int mask)
 }
 
 void oval_sysent_set_value(struct oval_sysent *sysent, char *value)
+{
+	oval_sysent_take_value(sysent, oscap_strdup(value));
+}
+
+void oval_sysent_take_value(struct oval_sysent *sysent, char *value)
 {
 	__attribute__nonnull__(sysent);
-	if (sysent->value != NULL)
+	if (sysent->interned_value)
+		oscap_intern_release(sysent->value);
+	else
 		free(sysent->value);
-	sysent->value = oscap_strdup(value);
+	sysent->value = value;
+	sysent->interned_value = false;
+}
+
+void oval_sysent_take_interned_value(struct oval_sysent *sysent, const char *value)
+{
+	oval_sysent_take_value(sysent, (char *) value);
+	sysent->interned_value = true;
 }
 
 void oval_sysent_add_record_field(struct oval_sysent *sysent, struct oval_record_field *rf)
@@ -83,7 +83,7 @@ struct oval_syschar_model *oval_syschar_model_new(struct oval_definition_model *
         newmodel->schema = oscap_strdup(OVAL_SYS_SCHEMA_LOCATION);
 
 	/* check possible allocation problems */
-	if ((newmodel->syschar_map == NULL) || (newmodel->sysitem_map == NULL) ) {
+	if ((newmodel->syschar_map == NULL) || (newmodel->sysitem_map == NULL)) {
 		oval_syschar_model_free(newmodel);
 		return NULL;
 	}
@@ -306,7 +306,8 @@ struct oval_sysitem *oval_syschar_model_get_new_sysitem(struct oval_syschar_mode
 }
 
 xmlNode *oval_syschar_model_to_dom(struct oval_syschar_model * syschar_model, xmlDocPtr doc, xmlNode * parent, 
-			           oval_syschar_resolver resolver, void *user_arg, bool export_syschar)
+			           oval_syschar_resolver resolver, void *user_arg, bool export_syschar,
+			           xmlTextWriterPtr writer)
 {
 
 	xmlNodePtr root_node = NULL;
@@ -332,15 +333,19 @@ xmlNode *oval_syschar_model_to_dom(struct oval_syschar_model * syschar_model, xm
 	xmlSetNs(root_node, ns_lin);
 	xmlSetNs(root_node, ns_win);
 	xmlSetNs(root_node, ns_syschar);
+	if (writer)
+		oscap_xml_writer_start_node(writer, root_node);
 
         /* Always report the generator */
 	oval_generator_to_dom(syschar_model->generator, doc, root_node);
 
         /* Report sysinfo */
 	oval_sysinfo_to_dom(oval_syschar_model_get_sysinfo(syschar_model), doc, root_node);
+	if (writer)
+		oscap_xml_writer_flush_children(writer, doc, root_node);
 
 	if (!export_syschar) {
-		return root_node;
+		goto finish;
 	}
 
 	struct oval_smc *resolved_smc = NULL;
@@ -360,6 +365,8 @@ xmlNode *oval_syschar_model_to_dom(struct oval_syschar_model * syschar_model, xm
 	struct oval_string_map *sysitem_map = oval_string_map_new();
 	if (oval_syschar_iterator_has_more(syschars)) {
 		xmlNode *tag_objects = xmlNewTextChild(root_node, ns_syschar, BAD_CAST "collected_objects", NULL);
+		if (writer)
+			oscap_xml_writer_start_node(writer, tag_objects);
 
 		while (oval_syschar_iterator_has_more(syschars)) {
 			struct oval_syschar *syschar = oval_syschar_iterator_next(syschars);
@@ -368,6 +375,8 @@ xmlNode *oval_syschar_model_to_dom(struct oval_syschar_model * syschar_model, xm
 			    || oval_object_get_base_obj(object)) /* Skip internal objects */
 				continue;
 			oval_syschar_to_dom(syschar, doc, tag_objects);
+			if (writer)
+				oscap_xml_writer_flush_children(writer, doc, tag_objects);
 			struct oval_sysitem_iterator *sysitems = oval_syschar_get_sysitem(syschar);
 			while (oval_sysitem_iterator_has_more(sysitems)) {
 				struct oval_sysitem *sysitem = oval_sysitem_iterator_next(sysitems);
@@ -375,6 +384,8 @@ xmlNode *oval_syschar_model_to_dom(struct oval_syschar_model * syschar_model, xm
 			}
 			oval_sysitem_iterator_free(sysitems);
 		}
+		if (writer)
+			oscap_xml_writer_end_node(writer);
 	}
 	oval_smc_free0(resolved_smc);
 	oval_syschar_iterator_free(syschars);
@@ -382,15 +393,29 @@ xmlNode *oval_syschar_model_to_dom(struct oval_syschar_model * syschar_model, xm
 	struct oval_iterator *sysitems = oval_string_map_values(sysitem_map);
 	if (oval_collection_iterator_has_more(sysitems)) {
 		xmlNode *tag_items = xmlNewTextChild(root_node, ns_syschar, BAD_CAST "system_data", NULL);
+		if (writer)
+			oscap_xml_writer_start_node(writer, tag_items);
 		while (oval_collection_iterator_has_more(sysitems)) {
 			struct oval_sysitem *sysitem = (struct oval_sysitem *)
 			    oval_collection_iterator_next(sysitems);
 			oval_sysitem_to_dom(sysitem, doc, tag_items);
+			if (writer)
+				oscap_xml_writer_flush_children(writer, doc, tag_items);
 		}
+		if (writer)
+			oscap_xml_writer_end_node(writer);
 	}
 	oval_collection_iterator_free(sysitems);
 	oval_string_map_free(sysitem_map, NULL);
 
+finish:
+	if (writer) {
+		/* Everything has been written, drop the empty element skeleton */
+		oscap_xml_writer_end_node(writer);
+		xmlUnlinkNode(root_node);
+		xmlFreeNode(root_node);
+		return NULL;
+	}
 	return root_node;
 }
 
@@ -407,7 +432,7 @@ int oval_syschar_model_export(struct oval_syschar_model *model, const char *file
 		return -1;
 	}
 
-	oval_syschar_model_to_dom(model, doc, NULL, NULL, NULL, true);
+	oval_syschar_model_to_dom(model, doc, NULL, NULL, NULL, true, NULL);
 	return oscap_xml_save_filename_free(file, doc);
 }
 
@@ -31,6 +31,7 @@
 #ifndef OVAL_SYSCHAR_IMPL
 #define OVAL_SYSCHAR_IMPL
 
+#include <libxml/xmlwriter.h>
 #include "public/oval_system_characteristics.h"
 #include "oval_parser_impl.h"
 #include "adt/oval_smc_impl.h"
@@ -62,10 +63,19 @@ typedef void (*oval_sysent_consumer) (struct oval_sysent *, void *client);
 int oval_sysent_parse_tag(xmlTextReaderPtr, struct oval_parser_context *, oval_sysent_consumer, void *);
 void oval_sysent_to_dom(struct oval_sysent *sysent, xmlDoc * doc, xmlNode * tag_parent);
 void oval_sysent_to_print(struct oval_sysent *, char *, int);
+/*
+ * Entity names are always interned, so they can be compared by their addresses.
+ * These take over a reference returned by oscap_intern() instead of a copy.
+ */
+void oval_sysent_take_interned_name(struct oval_sysent *sysent, const char *name);
+void oval_sysent_take_interned_value(struct oval_sysent *sysent, const char *value);
+/* Like oval_sysent_set_value(), but takes over the allocated value instead of copying it */
+void oval_sysent_take_value(struct oval_sysent *sysent, char *value);
 
 /* syschar_model */
 typedef bool oval_syschar_resolver(struct oval_syschar *, void *);
-xmlNode *oval_syschar_model_to_dom(struct oval_syschar_model *, xmlDocPtr, xmlNode *, oval_syschar_resolver, void *, bool);
+/* With a writer, the element is streamed to it as it is built and NULL is returned */
+xmlNode *oval_syschar_model_to_dom(struct oval_syschar_model *, xmlDocPtr, xmlNode *, oval_syschar_resolver, void *, bool, xmlTextWriterPtr);
 void oval_syschar_model_reset(struct oval_syschar_model *model);
 
 struct oval_syschar *oval_syschar_model_get_new_syschar(struct oval_syschar_model *, struct oval_object *);
@@ -71,6 +71,8 @@ struct SEAP_synchelper {
         pthread_cond_t  cond;
         pthread_mutex_t mtx;
         int signaled;
+        int canceled;
+        struct SEAP_synchelper *next; /* in the list of waiting commands of the descriptor */
 };
 
 #define SEAP_CMDTBL_LARGE 0x01
@@ -129,4 +131,12 @@ SEXP_t *SEAP_cmd_exec(SEAP_CTX_t    *ctx,
                        SEAP_cmdfn_t   func,
                        void          *funcarg);
 
+/*
+ * Wake up all threads waiting for the reply to a synchronous command sent
+ * through the descriptor and make the new synchronous commands fail with
+ * ECANCELED. Used when nobody is going to receive the replies anymore,
+ * i.e. after the thread reading from the descriptor has been stopped.
+ */
+int SEAP_cmd_cancel_sync(SEAP_CTX_t *ctx, int sd);
+
 #endif /* _SEAP_COMMAND_H */
@@ -116,6 +116,8 @@ void      SEXP_rawval_lblk_free (uintptr_t lblkp, void (*func) (SEXP_t *));
 void      SEXP_rawval_lblk_free1 (uintptr_t lblkp, void (*func) (SEXP_t *));
 
 #define SEXP_LBLK_ALIGN (16 > sizeof(void *) ? 16 : sizeof(void *))
+/* Size of the block header, the member array follows it */
+#define SEXP_LBLK_HDRSIZE ((sizeof(struct SEXP_val_lblk) + SEXP_LBLK_ALIGN - 1) & ~(SEXP_LBLK_ALIGN - 1))
 #define SEXP_LBLKP_MASK (UINTPTR_MAX << 4)
 #define SEXP_LBLKS_MASK 0x0f
 
@@ -25,6 +25,7 @@
 #endif
 
 #include <stdlib.h>
+#include <stdbool.h>
 
 #include "_sexp-types.h"
 #include "_seap-types.h"
@@ -34,6 +35,21 @@
 #include "../probe/probe_main.h"
 #include "oval_definitions.h"
 
+/* Capacity of each ring, the probe protocol keeps only a few messages in flight */
+#define SCH_QUEUE_RING_SIZE 256
+
+
+/*
+ * Both ends of the queue pair share the same sch_queuedata_t. The library
+ * side descriptor is the one which started the probe thread, the probe side
+ * descriptor is added by SEAP_add_probe() and has no probe thread argument.
+ * Deciding by descriptor rather than by the calling thread lets any library
+ * thread talk to the probe.
+ */
+static inline bool sch_queue_is_library_side(SEAP_desc_t *desc)
+{
+	return desc->arg != NULL;
+}
 
 int sch_queue_connect(SEAP_desc_t *desc)
 {
@@ -49,7 +65,18 @@ int sch_queue_connect(SEAP_desc_t *desc)
 	pthread_cond_init(&data->to_probe_cond, NULL);
 	pthread_mutex_init(&data->to_probe_mutex, NULL);
 
-	data->parent_thread_id = pthread_self();
+	data->to_probe_ring = NULL;
+	data->from_probe_ring = NULL;
+	if (getenv("OSCAP_PROBE_LEGACY_QUEUE") == NULL) {
+		data->to_probe_ring = oscap_ring_new(SCH_QUEUE_RING_SIZE);
+		data->from_probe_ring = oscap_ring_new(SCH_QUEUE_RING_SIZE);
+		if (data->to_probe_ring == NULL || data->from_probe_ring == NULL) {
+			oscap_ring_free(data->to_probe_ring, NULL);
+			oscap_ring_free(data->from_probe_ring, NULL);
+			data->to_probe_ring = NULL;
+			data->from_probe_ring = NULL;
+		}
+	}
 
 	struct probe_common_main_argument *arg = malloc(sizeof(struct probe_common_main_argument));
 	arg->subtype = desc->subtype;
@@ -76,7 +103,13 @@ SEXP_t *sch_queue_recvsexp(SEAP_desc_t *desc)
 	pthread_mutex_t *mutex;
 	pthread_cond_t *cond;
 	int *cnt;
-	if (pthread_equal(pthread_self(), data->parent_thread_id)) {
+	if (data->to_probe_ring != NULL) {
+		if (sch_queue_is_library_side(desc))
+			return oscap_ring_pop(data->from_probe_ring);
+		else
+			return oscap_ring_pop(data->to_probe_ring);
+	}
+	if (sch_queue_is_library_side(desc)) {
 		queue = data->from_probe_queue;
 		mutex = &data->from_probe_mutex;
 		cond = &data->from_probe_cond;
@@ -104,7 +137,7 @@ ssize_t sch_queue_sendsexp(SEAP_desc_t *desc, SEXP_t *sexp, uint32_t flags)
 	pthread_mutex_t *mutex;
 	pthread_cond_t *cond;
 	int *cnt;
-	if (pthread_equal(pthread_self(), data->parent_thread_id)) {
+	if (sch_queue_is_library_side(desc)) {
 		queue = data->to_probe_queue;
 		mutex = &data->to_probe_mutex;
 		cond = &data->to_probe_cond;
@@ -117,6 +150,13 @@ ssize_t sch_queue_sendsexp(SEAP_desc_t *desc, SEXP_t *sexp, uint32_t flags)
 	}
 	/* We want to send a SEXP, but the receiver expects a list of SEXPs. */
 	SEXP_t *sexp_list = SEXP_list_new(sexp, NULL);
+	if (data->to_probe_ring != NULL) {
+		if (sch_queue_is_library_side(desc))
+			oscap_ring_push(data->to_probe_ring, sexp_list);
+		else
+			oscap_ring_push(data->from_probe_ring, sexp_list);
+		return 0;
+	}
 	pthread_mutex_lock(mutex);
 	oscap_queue_add(queue, (void *) sexp_list);
 	(*cnt)++;
@@ -141,6 +181,8 @@ int sch_queue_close(SEAP_desc_t *desc, uint32_t flags)
 		dE("Return code of %s_probe main thread is %d.", subtype_str, ret);
 	}
 cleanup:
+	oscap_ring_free(data->to_probe_ring, (oscap_destruct_func) SEXP_free);
+	oscap_ring_free(data->from_probe_ring, (oscap_destruct_func) SEXP_free);
 	oscap_queue_free(data->to_probe_queue, NULL);
 	oscap_queue_free(data->from_probe_queue, NULL);
 	free(data);
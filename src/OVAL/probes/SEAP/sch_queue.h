@@ -25,11 +25,18 @@
 
 #include "util.h"
 #include "oscap_queue.h"
+#include "oscap_ring.h"
 #include "seap-descriptor.h"
 
 typedef struct {
 	pthread_t probe_thread_id;
-	pthread_t parent_thread_id;
+	/*
+	 * Lock-free rings used by default. If they can't be created, or
+	 * OSCAP_PROBE_LEGACY_QUEUE is set, they are NULL and the mutex
+	 * protected queues below are used instead.
+	 */
+	struct oscap_ring *to_probe_ring;
+	struct oscap_ring *from_probe_ring;
 	struct oscap_queue *to_probe_queue;
 	struct oscap_queue *from_probe_queue;
 	pthread_cond_t to_probe_cond;
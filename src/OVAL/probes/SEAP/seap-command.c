@@ -211,6 +211,71 @@ static SEXP_t *__SEAP_cmd_sync_handler (SEXP_t *res, void *arg)
         return (NULL);
 }
 
+static int __SEAP_cmd_sync_register (SEAP_desc_t *dsc, struct SEAP_synchelper *h)
+{
+        int ret = 0;
+
+        (void) pthread_mutex_lock (&dsc->sync_lock);
+
+        if (dsc->sync_canceled) {
+                errno = ECANCELED;
+                ret = -1;
+        } else {
+                h->next = dsc->sync_waiting;
+                dsc->sync_waiting = h;
+        }
+
+        (void) pthread_mutex_unlock (&dsc->sync_lock);
+
+        return (ret);
+}
+
+/*
+ * h->mtx must not be locked by the caller, SEAP_cmd_cancel_sync() locks
+ * it while holding the list lock
+ */
+static void __SEAP_cmd_sync_unregister (SEAP_desc_t *dsc, struct SEAP_synchelper *h)
+{
+        struct SEAP_synchelper **hp;
+
+        (void) pthread_mutex_lock (&dsc->sync_lock);
+
+        for (hp = &dsc->sync_waiting; *hp != NULL; hp = &(*hp)->next) {
+                if (*hp == h) {
+                        *hp = h->next;
+                        break;
+                }
+        }
+
+        (void) pthread_mutex_unlock (&dsc->sync_lock);
+}
+
+int SEAP_cmd_cancel_sync (SEAP_CTX_t *ctx, int sd)
+{
+        SEAP_desc_t *dsc;
+        struct SEAP_synchelper *h;
+
+        dsc = SEAP_desc_get (ctx->sd_table, sd);
+
+        if (dsc == NULL)
+                return (-1);
+
+        (void) pthread_mutex_lock (&dsc->sync_lock);
+
+        dsc->sync_canceled = true;
+
+        for (h = dsc->sync_waiting; h != NULL; h = h->next) {
+                (void) pthread_mutex_lock (&h->mtx);
+                h->canceled = 1;
+                (void) pthread_cond_signal (&h->cond);
+                (void) pthread_mutex_unlock (&h->mtx);
+        }
+
+        (void) pthread_mutex_unlock (&dsc->sync_lock);
+
+        return (0);
+}
+
 SEXP_t *SEAP_cmd_exec (SEAP_CTX_t    *ctx,
                        int            sd,
                        uint32_t       flags,
@@ -321,6 +386,16 @@ SEXP_t *SEAP_cmd_exec (SEAP_CTX_t    *ctx,
 
                         h.args = NULL;
                         h.signaled = 0;
+                        h.canceled = 0;
+
+                        if (!(flags & SEAP_EXEC_RECV) &&
+                            __SEAP_cmd_sync_register (dsc, &h) != 0) {
+                                dD("Can't wait for a reply: sd=%u: canceled.", sd);
+                                pthread_cond_destroy (&(h.cond));
+                                pthread_mutex_destroy (&(h.mtx));
+                                SEAP_packet_free(packet);
+                                return (NULL);
+                        }
 
                         if (pthread_mutex_lock (&(h.mtx)) != 0)
                                 abort ();
@@ -338,16 +413,22 @@ SEXP_t *SEAP_cmd_exec (SEAP_CTX_t    *ctx,
                                    rec->code, (void *)dsc->cmd_w_table, sd);
                                 SEAP_cmdrec_free (rec);
 				SEAP_packet_free(packet);
+                                pthread_mutex_unlock (&(h.mtx));
+                                __SEAP_cmd_sync_unregister (dsc, &h);
                                 return (NULL);
                         case -1:
                                 dD("Can't register async command handler: id=%u, tbl=%p, sd=%u: errno=%u, %s.",
                                    rec->code, (void *)dsc->cmd_w_table, sd, errno, strerror (errno));
                                 SEAP_cmdrec_free (rec);
 				SEAP_packet_free(packet);
+                                pthread_mutex_unlock (&(h.mtx));
+                                __SEAP_cmd_sync_unregister (dsc, &h);
                                 return (NULL);
                         default:
                                 SEAP_cmdrec_free (rec);
 				SEAP_packet_free(packet);
+                                pthread_mutex_unlock (&(h.mtx));
+                                __SEAP_cmd_sync_unregister (dsc, &h);
                                 errno = EDOOFUS;
                                 return (NULL);
                         }
@@ -357,6 +438,8 @@ SEXP_t *SEAP_cmd_exec (SEAP_CTX_t    *ctx,
                                         dD("FAIL: errno=%u, %s.", errno, strerror (errno));
                                         SEAP_cmdtbl_del(dsc->cmd_w_table, rec);
                                         SEAP_packet_free(packet);
+                                        pthread_mutex_unlock (&(h.mtx));
+                                        __SEAP_cmd_sync_unregister (dsc, &h);
                                 }
                                 return (NULL);
                         }
@@ -415,12 +498,14 @@ SEXP_t *SEAP_cmd_exec (SEAP_CTX_t    *ctx,
                                  * Someone else does receiving of events for us.
                                  * Just wait for the condition to be signaled.
                                  */
-                                if (pthread_cond_wait(&h.cond, &h.mtx) != 0) {
-                                        /*
-                                         * Fatal error - don't know how to handle
-                                         * this so let's just call abort()...
-                                         */
-                                        abort();
+                                while (!h.signaled && !h.canceled) {
+                                        if (pthread_cond_wait(&h.cond, &h.mtx) != 0) {
+                                                /*
+                                                 * Fatal error - don't know how to handle
+                                                 * this so let's just call abort()...
+                                                 */
+                                                abort();
+                                        }
                                 }
                         }
 
@@ -437,6 +522,14 @@ SEXP_t *SEAP_cmd_exec (SEAP_CTX_t    *ctx,
                          * SEAP_cmdtbl_del(dsc->cmd_w_table, rec);
                          */
                         pthread_mutex_unlock (&(h.mtx));
+                        __SEAP_cmd_sync_unregister (dsc, &h);
+
+                        if (h.canceled && !h.signaled) {
+                                /* no reply is coming, don't leave h in the wait queue */
+                                dD("Canceled while waiting for a reply: id=%u, sd=%u.", cmdptr->id, sd);
+                                SEAP_cmdtbl_del(dsc->cmd_w_table, rec);
+                                errno = ECANCELED;
+                        }
                         pthread_cond_destroy (&(h.cond));
                         pthread_mutex_destroy (&(h.mtx));
                         SEAP_packet_free(packet);
@@ -66,9 +66,13 @@ int SEAP_desc_add(SEAP_desctable_t *sd_table, SEAP_scheme_t scheme,
                 sd_dsc->next_cid = 0;
                 sd_dsc->cmd_c_table = SEAP_cmdtbl_new ();
                 sd_dsc->cmd_w_table = SEAP_cmdtbl_new ();
+		sd_dsc->sync_waiting = NULL;
+		sd_dsc->sync_canceled = false;
+		pthread_mutex_init(&sd_dsc->sync_lock, NULL);
 		sd_dsc->msg_queue = NULL;
 		sd_dsc->err_queue = rbt_i32_new();
 		sd_dsc->cmd_queue = NULL;
+		sd_dsc->arg = NULL;
 
 		SEAP_packetq_init(&sd_dsc->pck_queue);
 
@@ -126,6 +130,7 @@ void SEAP_desc_free(SEAP_desc_t *dsc)
 	SEAP_packetq_free(&dsc->pck_queue);
         pthread_mutex_destroy(&(dsc->r_lock));
         pthread_mutex_destroy(&(dsc->w_lock));
+	pthread_mutex_destroy(&dsc->sync_lock);
 	rbt_i32_free_cb(dsc->err_queue, __SEAP_desc_errqueue_free_cb);
 	free(dsc);
 }
@@ -26,6 +26,7 @@
 
 #include <errno.h>
 #include <pthread.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include "oval_types.h"
 #include "generic/bitmap.h"
@@ -58,6 +59,9 @@ typedef struct {
         SEAP_cmdid_t   next_cid;
         SEAP_cmdtbl_t *cmd_c_table; /* Local SEAP commands */
         SEAP_cmdtbl_t *cmd_w_table; /* Waiting SEAP commands */
+        pthread_mutex_t sync_lock;
+        struct SEAP_synchelper *sync_waiting; /* Threads waiting for a reply */
+        bool sync_canceled;
     oval_subtype_t subtype;
 	struct probe_common_main_argument *arg;
 } SEAP_desc_t;
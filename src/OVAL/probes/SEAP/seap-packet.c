@@ -661,6 +661,8 @@ int SEAP_packet_recv (SEAP_CTX_t *ctx, int sd, SEAP_packet_t **packet)
 eloop_exit:
 
 	sexp_buffer = sch_queue_recvsexp(dsc);
+	/* Another thread may read from this descriptor next */
+	DESC_RUNLOCK(dsc);
 	SEXP_VALIDATE(sexp_buffer);
 
 	(*packet) = NULL;
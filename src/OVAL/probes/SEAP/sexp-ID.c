@@ -44,7 +44,7 @@
 #include "_sexp-rawptr.h"
 #include "_sexp-ID.h"
 
-#include "MurmurHash3.h"
+#include "common/MurmurHash3.h"
 
 static SEXP_ID_t SEXP_ID_hash(void *buf, size_t len, SEXP_ID_t seed, int part)
 {
@@ -106,10 +106,14 @@ uintptr_t SEXP_rawval_lblk_new (uint8_t sz)
 {
         _A(sz < 16);
 
+        /*
+         * The member array is allocated in one piece with the block header,
+         * right after it. This halves the number of allocations per block.
+         */
         struct SEXP_val_lblk *lblk = oscap_aligned_malloc(
-                sizeof(struct SEXP_val_lblk),
+                SEXP_LBLK_HDRSIZE + sizeof(SEXP_t) * (1 << sz),
                 SEXP_LBLK_ALIGN);
-        lblk->memb = malloc(sizeof(SEXP_t) * (1 << sz));
+        lblk->memb = (SEXP_t *)((uint8_t *)lblk + SEXP_LBLK_HDRSIZE);
 
         lblk->nxsz = ((uintptr_t)(NULL) & SEXP_LBLKP_MASK) | ((uintptr_t)sz & SEXP_LBLKS_MASK);
         lblk->refs = 1;
@@ -519,7 +523,6 @@ void SEXP_rawval_lblk_free (uintptr_t lblkp, void (*func) (SEXP_t *))
                         func (lblk->memb + lblk->real);
                 }
 
-                free(lblk->memb);
                 oscap_aligned_free(lblk);
 
                 if (next != NULL)
@@ -541,7 +544,6 @@ void SEXP_rawval_lblk_free1 (uintptr_t lblkp, void (*func) (SEXP_t *))
                         func (lblk->memb + lblk->real);
                 }
 
-                free(lblk->memb);
                 oscap_aligned_free(lblk);
         }
 
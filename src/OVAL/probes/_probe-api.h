@@ -32,6 +32,7 @@
 #define _PROBE_API_H
 
 #include <stdarg.h>
+#include <stdbool.h>
 #include "public/probe-api.h"
 #include "probe/ncache.h"
 #include "probe/rcache.h"
@@ -48,6 +49,24 @@ struct id_desc_t {
 	int item_id_ctr;	///< id counter
 };
 
+/*
+ * Validity tokens of collected objects. While some collection cache needs
+ * them, the collected objects get a fifth element, a list of tokens which
+ * describe the state of the files and directories the result was read from.
+ * A token stays valid as long as the node isn't replaced and its content,
+ * its metadata and (for directories) its entries don't change.
+ */
+void probe_tokens_enable(bool enable);
+bool probe_tokens_enabled(void);
+void probe_cobj_track_tokens(SEXP_t *cobj);
+bool probe_cobj_tracks_tokens(const SEXP_t *cobj);
+SEXP_t *probe_cobj_get_tokens(const SEXP_t *cobj);
+void probe_cobj_move_tokens(SEXP_t *dst, const SEXP_t *src);
+/* Record the current state of path, if cobj tracks the tokens */
+int probe_cobj_add_token(SEXP_t *cobj, const char *path);
+SEXP_t *probe_token_new_path(const char *path);
+bool probe_token_valid(const SEXP_t *token);
+
 #define SEAP_LOCK pthread_mutex_lock (&globals.seap_lock)
 #define SEAP_UNLOCK pthread_mutex_unlock (&globals.seap_lock)
 
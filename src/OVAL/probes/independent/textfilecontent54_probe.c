@@ -43,6 +43,9 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/mman.h>
 
 #include "_seap.h"
 #include <probe-api.h>
@@ -118,15 +121,238 @@ struct pfdata {
 	SEXP_t *instance_ent;
 	probe_ctx *ctx;
 	oscap_pcre_t *compiled_regex;
+	bool line_bound;
 };
 
-static int process_file(const char *prefix, const char *path, const char *file, struct pfdata *pfd, oval_schema_version_t over, struct oscap_list *blocked_paths)
+/*
+ * Files up to this size are read into a single buffer. Larger files are
+ * scanned line by line if the pattern can't match across lines, otherwise
+ * they are memory-mapped.
+ */
+#define TFC54_LARGE_FILE_SIZE (16 * 1024 * 1024)
+#define TFC54_READ_BUF_SIZE 4096
+
+/*
+ * Check whether every match of the pattern lies within a single line, so
+ * that matching the lines separately gives the same items as matching the
+ * whole file. The check is conservative, anything that can match a newline
+ * or depends on the position in the whole file rejects the pattern.
+ */
+static bool pattern_is_line_bound(const char *pattern, oscap_pcre_options_t opts)
+{
+	if ((opts & OSCAP_PCRE_OPTS_DOTALL) || !(opts & OSCAP_PCRE_OPTS_MULTILINE))
+		return false;
+
+	for (const char *p = pattern; *p != '\0'; ++p) {
+		switch (*p) {
+		case '\n':
+		case '\r':
+			return false;
+		case '\\':
+			/* newline and whitespace escapes, character codes,
+			 * properties, subject anchors and back references */
+			if (*(p + 1) == '\0' || strchr("nrfsSDWHvVRXNAzZGxcoepPCQ0123456789g", *(p + 1)) != NULL)
+				return false;
+			++p;
+			break;
+		case '[':
+			/* negated classes match newlines */
+			if (*(p + 1) == '^')
+				return false;
+			/* a ']' right after the opening bracket is a literal */
+			if (*(p + 1) == ']')
+				++p;
+			/* POSIX classes ([:space:] etc.), escapes and control
+			 * characters inside the class may match a newline, only
+			 * plain printable characters and ranges are accepted */
+			for (++p; *p != ']'; ++p) {
+				if (*p == '\\' || (unsigned char) *p < 0x20)
+					return false;
+				if (*p == '[' && strchr(":.=", *(p + 1)) != NULL)
+					return false;
+			}
+			break;
+		case '(':
+			if (*(p + 1) == '*')
+				return false;
+			if (*(p + 1) == '?') {
+				/* inline options, singleline and extended mode or unsetting
+				 * multiline change the meaning of the rest of the pattern */
+				for (const char *o = p + 2; *o != '\0' && *o != ':' && *o != ')'; ++o) {
+					if (strchr("sx-^", *o) != NULL)
+						return false;
+					if (strchr("imnJU", *o) == NULL)
+						break;
+				}
+			}
+			break;
+		}
+	}
+	return true;
+}
+
+static void report_file_error(struct pfdata *pfd, const char *func, const char *path)
 {
-	int ret = 0, path_len, file_len, cur_inst = 0, fd = -1, substr_cnt,
-		buf_size = 0, buf_used = 0, ofs = 0, buf_inc = 4096;
+	SEXP_t *msg;
+
+	msg = probe_msg_creatf(OVAL_MESSAGE_LEVEL_ERROR, "%s(): '%s' %s.", func, path, strerror(errno));
+	probe_cobj_add_msg(probe_ctx_getresult(pfd->ctx), msg);
+	SEXP_free(msg);
+	probe_cobj_set_flag(probe_ctx_getresult(pfd->ctx), SYSCHAR_FLAG_ERROR);
+}
+
+/*
+ * Read the whole file into one buffer. The size from fstat() is used as
+ * the initial size, the buffer is doubled for files which are larger than
+ * reported (e.g. the files in /proc report zero size).
+ */
+static int read_file(int fd, const struct stat *st, char **buf_out, size_t *len_out)
+{
+	size_t buf_size = (size_t) st->st_size + 1;
+	size_t buf_used = 0;
+	char *buf;
+
+	if (buf_size < TFC54_READ_BUF_SIZE)
+		buf_size = TFC54_READ_BUF_SIZE;
+	buf = malloc(buf_size);
+	if (buf == NULL)
+		return PROBE_ENOMEM;
+
+	for (;;) {
+		ssize_t n = read(fd, buf + buf_used, buf_size - buf_used);
+		if (n == -1) {
+			if (errno == EINTR)
+				continue;
+			free(buf);
+			return -1;
+		}
+		if (n == 0)
+			break;
+		buf_used += n;
+		if (buf_used == buf_size) {
+			void *new_buf = realloc(buf, buf_size * 2);
+			if (new_buf == NULL) {
+				dE("Can't re-allocate memory for file-processing buffer");
+				free(buf);
+				return PROBE_ENOMEM;
+			}
+			buf = new_buf;
+			buf_size *= 2;
+		}
+	}
+
+	*buf_out = buf;
+	*len_out = buf_used;
+	return 0;
+}
+
+/*
+ * Collect the items for all matches of the pattern in the buffer. The
+ * instance counter is kept by the caller as it spans all lines of the
+ * file in the line by line mode. The buffer isn't NUL-terminated, the
+ * whole length is matched including any NUL bytes, so the content after
+ * a NUL byte is matched the same way in all three reading modes.
+ */
+static int process_buffer(const char *buf, size_t len, int *cur_inst, const char *path, const char *file,
+			  const char *whole_path, struct pfdata *pfd, oval_schema_version_t over)
+{
+	int ofs = 0, substr_cnt;
 	char **substrs = NULL;
+	SEXP_t *next_inst;
+
+	do {
+		int want_instance;
+
+		next_inst = SEXP_number_newi_32(*cur_inst + 1);
+
+		if (probe_entobj_cmp(pfd->instance_ent, next_inst) == OVAL_RESULT_TRUE)
+			want_instance = 1;
+		else
+			want_instance = 0;
+
+		SEXP_free(next_inst);
+		substr_cnt = oscap_pcre_get_substrings_len(buf, len, &ofs, pfd->compiled_regex, want_instance, &substrs);
+
+		if (substr_cnt < 0) {
+			SEXP_t *msg;
+			msg = probe_msg_creatf(OVAL_MESSAGE_LEVEL_ERROR,
+				"Regular expression pattern match failed in file %s with error %d.",
+				whole_path, substr_cnt);
+			probe_cobj_add_msg(probe_ctx_getresult(pfd->ctx), msg);
+			SEXP_free(msg);
+			probe_cobj_set_flag(probe_ctx_getresult(pfd->ctx), SYSCHAR_FLAG_ERROR);
+			return -3;
+		}
+
+		if (substr_cnt > 0) {
+			++(*cur_inst);
+
+			if (want_instance) {
+				int k;
+				SEXP_t *item;
+
+				item = create_item(path, file, pfd->pattern,
+						*cur_inst, substrs, substr_cnt, over);
+
+				for (k = 0; k < substr_cnt; ++k)
+					free(substrs[k]);
+				free(substrs);
+				int pic_ret = probe_item_collect(pfd->ctx, item);
+				if (pic_ret == 2 || pic_ret == -1)
+					return -4;
+			}
+		}
+	} while (substr_cnt > 0 && (size_t) ofs <= len);
+
+	/* coverity[leaked_storage] - substrs is not leaked */
+	return 0;
+}
+
+static int process_lines(int fd, const char *path, const char *file, const char *whole_path,
+			 struct pfdata *pfd, oval_schema_version_t over)
+{
+	int ret = 0, cur_inst = 0;
+	char *line = NULL;
+	size_t line_size = 0;
+	ssize_t line_len;
+	FILE *fp;
+
+	fp = fdopen(fd, "r");
+	if (fp == NULL) {
+		report_file_error(pfd, "fdopen", whole_path);
+		close(fd);
+		return -1;
+	}
+
+	errno = 0;
+	while ((line_len = getline(&line, &line_size, fp)) != -1) {
+		if (line_len > 0 && line[line_len - 1] == '\n')
+			line[--line_len] = '\0';
+		if (line_len > INT_MAX) {
+			dE("Line in file '%s' is too long to be matched.", whole_path);
+			ret = -1;
+			break;
+		}
+		ret = process_buffer(line, line_len, &cur_inst, path, file, whole_path, pfd, over);
+		if (ret != 0)
+			break;
+	}
+	if (ret == 0 && ferror(fp)) {
+		report_file_error(pfd, "read", whole_path);
+		ret = -2;
+	}
+
+	free(line);
+	fclose(fp);
+	return ret;
+}
+
+static int process_file(const char *prefix, const char *path, const char *file, struct pfdata *pfd, oval_schema_version_t over, struct oscap_list *blocked_paths)
+{
+	int ret = 0, path_len, file_len, cur_inst = 0, fd = -1;
 	char *whole_path = NULL, *whole_path_with_prefix = NULL, *buf = NULL;
-	SEXP_t *next_inst = NULL;
+	size_t buf_len = 0;
+	bool mapped = false;
 	struct stat st;
 
 	if (file == NULL)
@@ -165,106 +391,69 @@ static int process_file(const char *prefix, const char *path, const char *file,
 
 	fd = open(whole_path_with_prefix, O_RDONLY);
 	if (fd == -1) {
-		SEXP_t *msg;
-
-		msg = probe_msg_creatf(OVAL_MESSAGE_LEVEL_ERROR, "open(): '%s' %s.", whole_path, strerror(errno));
-		probe_cobj_add_msg(probe_ctx_getresult(pfd->ctx), msg);
-		SEXP_free(msg);
-		probe_cobj_set_flag(probe_ctx_getresult(pfd->ctx), SYSCHAR_FLAG_ERROR);
+		report_file_error(pfd, "open", whole_path);
 		ret = -1;
 		goto cleanup;
 	}
 
-	do {
-		buf_size += buf_inc;
-		void *new_buf = realloc(buf, buf_size);
-		if (new_buf == NULL) {
-			dE("Can't re-allocate memory for file-processing buffer");
-			ret = PROBE_ENOMEM;
-			goto cleanup;
-		}
-		buf = new_buf;
-		ret = read(fd, buf + buf_used, buf_inc);
-		if (ret == -1) {
+	if (st.st_size > TFC54_LARGE_FILE_SIZE && pfd->line_bound) {
+		dD("Matching '%s' line by line.", whole_path);
+		ret = process_lines(fd, path, file, whole_path, pfd, over);
+		fd = -1; // closed by process_lines()
+		goto cleanup;
+	}
+
+	if (st.st_size > TFC54_LARGE_FILE_SIZE) {
+		if ((uintmax_t) st.st_size > INT_MAX) {
 			SEXP_t *msg;
 
-			msg = probe_msg_creatf(OVAL_MESSAGE_LEVEL_ERROR, "read(): '%s' %s.", whole_path, strerror(errno));
+			msg = probe_msg_creatf(OVAL_MESSAGE_LEVEL_ERROR,
+				"File '%s' is too large to be matched by a multi-line pattern.", whole_path);
 			probe_cobj_add_msg(probe_ctx_getresult(pfd->ctx), msg);
 			SEXP_free(msg);
 			probe_cobj_set_flag(probe_ctx_getresult(pfd->ctx), SYSCHAR_FLAG_ERROR);
-			ret = -2;
+			ret = -1;
 			goto cleanup;
 		}
-		buf_used += ret;
-	} while (ret == buf_inc);
-
-	if (buf_used == buf_size) {
-		void *new_buf = realloc(buf, ++buf_size);
-		if (new_buf == NULL) {
-			dE("Can't re-allocate memory");
-			ret = PROBE_ENOMEM;
-			goto cleanup;
+		buf = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (buf != MAP_FAILED) {
+			(void) posix_madvise(buf, st.st_size, POSIX_MADV_SEQUENTIAL);
+			buf_len = st.st_size;
+			mapped = true;
+		} else {
+			dD("mmap() failed for '%s': %s, reading the file instead.", whole_path, strerror(errno));
+			buf = NULL;
 		}
-		buf = new_buf;
 	}
-	buf[buf_used++] = '\0';
-
-	do {
-		int want_instance;
 
-		next_inst = SEXP_number_newi_32(cur_inst + 1);
-
-		if (probe_entobj_cmp(pfd->instance_ent, next_inst) == OVAL_RESULT_TRUE)
-			want_instance = 1;
-		else
-			want_instance = 0;
-
-		SEXP_free(next_inst);
-		substr_cnt = oscap_pcre_get_substrings(buf, &ofs, pfd->compiled_regex, want_instance, &substrs);
-
-		if (substr_cnt < 0) {
-			SEXP_t *msg;
-			msg = probe_msg_creatf(OVAL_MESSAGE_LEVEL_ERROR,
-				"Regular expression pattern match failed in file %s with error %d.",
-				whole_path, substr_cnt);
-			probe_cobj_add_msg(probe_ctx_getresult(pfd->ctx), msg);
-			SEXP_free(msg);
-			probe_cobj_set_flag(probe_ctx_getresult(pfd->ctx), SYSCHAR_FLAG_ERROR);
-			ret = -3;
+	if (!mapped) {
+		ret = read_file(fd, &st, &buf, &buf_len);
+		if (ret == -1) {
+			report_file_error(pfd, "read", whole_path);
+			ret = -2;
+		}
+		if (ret != 0)
+			goto cleanup;
+		if (buf_len > INT_MAX) {
+			dE("File '%s' is too large to be matched.", whole_path);
+			ret = -1;
 			goto cleanup;
 		}
+	}
 
-		if (substr_cnt > 0) {
-			++cur_inst;
-
-			if (want_instance) {
-				int k;
-				SEXP_t *item;
-
-				item = create_item(path, file, pfd->pattern,
-						cur_inst, substrs, substr_cnt, over);
-
-				for (k = 0; k < substr_cnt; ++k)
-					free(substrs[k]);
-				free(substrs);
-				int pic_ret = probe_item_collect(pfd->ctx, item);
-				if (pic_ret == 2 || pic_ret == -1) {
-					ret = -4;
-					break;
-				}
-			}
-		}
-	} while (substr_cnt > 0 && ofs < buf_used);
+	ret = process_buffer(buf, buf_len, &cur_inst, path, file, whole_path, pfd, over);
 
  cleanup:
 	if (fd != -1)
 		close(fd);
-	free(buf);
+	if (mapped)
+		munmap(buf, buf_len);
+	else
+		free(buf);
 	if (whole_path != NULL)
 		free(whole_path);
 	free(whole_path_with_prefix);
 
-	/* coverity[leaked_storage] - substrs is not leaked */
 	return ret;
 }
 
@@ -346,7 +535,7 @@ int textfilecontent54_probe_main(probe_ctx *ctx, void *arg)
 			pfd.re_opts |= OSCAP_PCRE_OPTS_DOTALL;
 	}
 
-	pfd.compiled_regex = oscap_pcre_compile(pfd.pattern, pfd.re_opts, &error, &errorffset);
+	pfd.compiled_regex = oscap_pcre_compile_cached(pfd.pattern, pfd.re_opts, &error, &errorffset);
 	if (pfd.compiled_regex == NULL) {
 		SEXP_t *msg;
 
@@ -358,6 +547,8 @@ int textfilecontent54_probe_main(probe_ctx *ctx, void *arg)
 		goto cleanup;
 	}
 
+	pfd.line_bound = pattern_is_line_bound(pfd.pattern, pfd.re_opts);
+
 	const char *prefix = getenv("OSCAP_PROBE_ROOT");
 
 	if ((ofts = oval_fts_open_prefixed(prefix, path_ent, file_ent, filepath_ent, bh_ent, probe_ctx_getresult(ctx))) != NULL) {
@@ -151,7 +151,7 @@ static int process_file(const char *prefix, const char *path, const char *filena
 	oscap_pcre_t *re = NULL;
 	char *error;
 
-	re = oscap_pcre_compile(pfd->pattern, OSCAP_PCRE_OPTS_UTF8, &error, &erroffset);
+	re = oscap_pcre_compile_cached(pfd->pattern, OSCAP_PCRE_OPTS_UTF8, &error, &erroffset);
 	if (re == NULL) {
 		oscap_pcre_err_free(error);
 		return -1;
@@ -39,6 +39,7 @@
 #include "probe/entcmp.h"
 #include "debug_priv.h"
 #include "oval_fts.h"
+#include "oval_fts_walk.h"
 #if defined(OS_SOLARIS)
 #include "fts_sun.h"
 #include <sys/mntent.h>
@@ -66,9 +67,10 @@ static OVAL_FTS *OVAL_FTS_new()
 static void OVAL_FTS_free(OVAL_FTS *ofts)
 {
 	if (ofts->ofts_match_path_fts != NULL)
-		fts_close(ofts->ofts_match_path_fts);
+		oval_walk_close(ofts->ofts_match_path_fts);
 	if (ofts->ofts_recurse_path_fts != NULL)
-		fts_close(ofts->ofts_recurse_path_fts);
+		oval_walk_close(ofts->ofts_recurse_path_fts);
+	oval_walkent_free(ofts->ofts_exact_ent);
 
 	free(ofts);
 	return;
@@ -89,7 +91,7 @@ static int pathlen_from_ftse(int fts_pathlen, int fts_namelen)
 	return pathlen;
 }
 
-static OVAL_FTSENT *OVAL_FTSENT_new(OVAL_FTS *ofts, FTSENT *fts_ent)
+static OVAL_FTSENT *OVAL_FTSENT_new(OVAL_FTS *ofts, OVAL_WALKENT *fts_ent)
 {
 	OVAL_FTSENT *ofts_ent = calloc(1, sizeof(OVAL_FTSENT));
 
@@ -409,7 +411,7 @@ static int process_pattern_match(const char *path, oscap_pcre_t **regex_out)
 		pattern = strdup(path);
 	}
 
-	regex = oscap_pcre_compile(pattern, 0, &errptr, &errofs);
+	regex = oscap_pcre_compile_cached(pattern, OSCAP_PCRE_OPTS_PARTIAL, &errptr, &errofs);
 	if (regex == NULL) {
 		dE("Failed to validate the pattern: oscap_pcre_compile(): "
 		   "error offset: %d, error: '%s', pattern: '%s'.\n",
@@ -512,6 +514,93 @@ static int process_pattern_match(const char *path, oscap_pcre_t **regex_out)
 #undef TEST_PATH1
 #undef TEST_PATH2
 
+/* A filename which can be looked up in the directory instead of listing it */
+static bool exact_filename(SEXP_t *filename)
+{
+	if (probe_ent_getoperation(filename, OVAL_OPERATION_EQUALS) != OVAL_OPERATION_EQUALS)
+		return false;
+	/* several values of a variable are matched in the directory order */
+	return probe_ent_getvals(filename, NULL) == 1;
+}
+
+/*
+ * Find the only item an object with an exact filepath, or an exact path
+ * and filename, can have. ofts->ofts_exact_ent holds the stat'ed root and
+ * it's replaced by the item, or NULL. The checks are the ones the walks in
+ * oval_fts_read_match_path() and oval_fts_read_recurse_path() do.
+ */
+static void oval_fts_lookup_exact(OVAL_FTS *ofts, const char *filename)
+{
+	OVAL_WALKENT *root = ofts->ofts_exact_ent, *child;
+	const size_t shift = ofts->prefix ? strlen(ofts->prefix) : 0;
+	char *child_path;
+	size_t base;
+	SEXP_t *stmp;
+	oval_result_t ores;
+
+	ofts->ofts_exact_ent = NULL;
+	/* the result depends on the entries of the directory */
+	if (ofts->tokens && root->fts_info == FTS_D)
+		probe_cobj_add_token(ofts->result, root->fts_path);
+
+	/* a filepath never matches a directory, a path matches directories only */
+	if (ofts->ofts_sfilepath == NULL && root->fts_info != FTS_D)
+		goto out;
+	if (ofts->filesystem == OVAL_RECURSE_FS_LOCAL
+	    && !OVAL_FTS_localp(ofts, root->fts_path, &root->fts_statp->st_dev)) {
+		dI("Don't recurse into non-local filesystems, skipping '%s'.", root->fts_path);
+		goto out;
+	}
+
+	stmp = SEXP_string_newf("%s", root->fts_path + shift);
+	if (ofts->ofts_sfilepath)
+		ores = probe_entobj_cmp(ofts->ofts_sfilepath, stmp);
+	else
+		ores = probe_entobj_cmp(ofts->ofts_spath, stmp);
+	SEXP_free(stmp);
+	if (ores != OVAL_RESULT_TRUE)
+		goto out;
+
+	if (ofts->ofts_sfilepath) {
+		ofts->ofts_exact_ent = root;
+		return;
+	}
+
+	/* no entry of a directory has such a name */
+	if (filename[0] == '\0' || strchr(filename, '/') != NULL
+	    || strcmp(filename, ".") == 0 || strcmp(filename, "..") == 0)
+		goto out;
+
+	/* the path is built the same way the walk builds it */
+	base = root->fts_pathlen;
+	if (base > 0 && root->fts_path[base - 1] == '/')
+		base--;
+	child_path = malloc(base + 1 + strlen(filename) + 1);
+	memcpy(child_path, root->fts_path, base);
+	child_path[base] = '/';
+	strcpy(child_path + base + 1, filename);
+	child = oval_walk_stat(child_path, 1);
+	free(child_path);
+	/* directories aren't collected as files */
+	if (child == NULL || child->fts_info == FTS_D) {
+		oval_walkent_free(child);
+		goto out;
+	}
+
+	stmp = SEXP_string_newf("%s", child->fts_name);
+	ores = probe_entobj_cmp(ofts->ofts_sfilename, stmp);
+	SEXP_free(stmp);
+	if (ores == OVAL_RESULT_TRUE)
+		ofts->ofts_exact_ent = child;
+	else {
+		if (ores == OVAL_RESULT_ERROR)
+			probe_cobj_set_flag(ofts->result, SYSCHAR_FLAG_ERROR);
+		oval_walkent_free(child);
+	}
+out:
+	oval_walkent_free(root);
+}
+
 OVAL_FTS *oval_fts_open(SEXP_t *path, SEXP_t *filename, SEXP_t *filepath, SEXP_t *behaviors, SEXP_t* result)
 {
 	return oval_fts_open_prefixed(NULL, path, filename, filepath, behaviors, result);
@@ -528,8 +617,7 @@ OVAL_FTS *oval_fts_open_prefixed(const char *prefix, SEXP_t *path, SEXP_t *filen
 
 	SEXP_t *r0;
 
-	int mtc_fts_options = FTS_PHYSICAL | FTS_COMFOLLOW | FTS_NOCHDIR;
-	int rec_fts_options = FTS_PHYSICAL | FTS_COMFOLLOW | FTS_NOCHDIR;
+	int rec_walk_options = 0;
 	int max_depth   = -1;
 	int direction   = -1;
 	int recurse     = -1;
@@ -538,6 +626,7 @@ OVAL_FTS *oval_fts_open_prefixed(const char *prefix, SEXP_t *path, SEXP_t *filen
 	uint32_t path_op;
 	bool nilfilename = false;
 	oscap_pcre_t *regex = NULL;
+	OVAL_WALKENT *exact_ent = NULL;
 	struct stat st;
 
 	if ((path != NULL || filename != NULL || filepath == NULL)
@@ -651,7 +740,7 @@ OVAL_FTS *oval_fts_open_prefixed(const char *prefix, SEXP_t *path, SEXP_t *filen
 			filesystem = OVAL_RECURSE_FS_ALL;
 		} else if (strcmp(cstr_buff, "defined") == 0) {
 			filesystem = OVAL_RECURSE_FS_DEFINED;
-			rec_fts_options |= FTS_XDEV;
+			rec_walk_options |= OVAL_WALK_XDEV;
 		} else {
 			dE("Invalid recurse filesystem: %s", cstr_buff);
 			SEXP_free(r0);
@@ -689,9 +778,34 @@ OVAL_FTS *oval_fts_open_prefixed(const char *prefix, SEXP_t *path, SEXP_t *filen
 		paths[0] = path_with_prefix;
 	}
 	dI("Opening file '%s'.", paths[0]);
+	/* The result depends on this path even if it doesn't exist (yet). */
+	if (result != NULL && probe_cobj_tracks_tokens(result))
+		probe_cobj_add_token(result, paths[0]);
+
+	/*
+	 * An exact filepath, or an exact path with an exact filename and no
+	 * recursion, names the only possible item. It's stat'ed directly then,
+	 * without listing any directory. A filepath which turns out to be
+	 * a directory is walked as before.
+	 */
+	if (path_op == OVAL_OPERATION_EQUALS
+	    && (filepath != NULL
+		|| (direction == OVAL_RECURSE_DIRECTION_NONE && !nilfilename && exact_filename(filename)))) {
+		exact_ent = oval_walk_stat(paths[0], 0);
+		if (exact_ent == NULL) {
+			dD("stat() failed: errno: %d, '%s'.", errno, strerror(errno));
+			free((void *) paths[0]);
+			return NULL;
+		}
+		if (filepath != NULL && exact_ent->fts_info == FTS_D) {
+			oval_walkent_free(exact_ent);
+			exact_ent = NULL;
+		}
+	}
+
 	/* Fail if the provided path doensn't actually exist. Symlinks
 	   without targets are accepted. */
-	if (lstat(paths[0], &st) == -1) {
+	if (exact_ent == NULL && lstat(paths[0], &st) == -1) {
 		if (errno) {
 			dD("lstat() failed: errno: %d, '%s'.",
 			   errno, strerror(errno));
@@ -704,49 +818,46 @@ OVAL_FTS *oval_fts_open_prefixed(const char *prefix, SEXP_t *path, SEXP_t *filen
 	ofts = OVAL_FTS_new();
 	ofts->prefix = prefix;
 
-	/* reset errno as fts_open() doesn't do it itself. */
-	errno = 0;
-	ofts->ofts_match_path_fts = fts_open((char * const *) paths, mtc_fts_options, NULL);
-	free((void *) paths[0]);
-	/* fts_open() doesn't return NULL for all errors (e.g. nonexistent paths),
-	   so check errno to detect it. Far from being perfect. */
-	if (ofts->ofts_match_path_fts == NULL || errno != 0) {
-		dE("fts_open() failed, errno: %d \"%s\".", errno, strerror(errno));
-		OVAL_FTS_free(ofts);
-		oscap_pcre_free(regex);
-		return (NULL);
+	if (exact_ent != NULL) {
+		ofts->ofts_exact = true;
+		ofts->ofts_exact_ent = exact_ent;
+	} else {
+		ofts->ofts_match_path_fts = oval_walk_open(paths[0], 0);
+		if (ofts->ofts_match_path_fts == NULL) {
+			dE("oval_walk_open() failed, errno: %d \"%s\".", errno, strerror(errno));
+			free((void *) paths[0]);
+			OVAL_FTS_free(ofts);
+			oscap_pcre_free(regex);
+			return (NULL);
+		}
 	}
+	free((void *) paths[0]);
 
-	ofts->ofts_recurse_path_fts_opts = rec_fts_options;
+	ofts->ofts_recurse_path_walk_opts = rec_walk_options;
 	ofts->ofts_path_op = path_op;
-	if (regex != NULL) {
+	if (regex != NULL)
 		ofts->ofts_path_regex = regex;
-		oscap_pcre_optimize(regex);
-	}
 
 	if (filesystem == OVAL_RECURSE_FS_LOCAL) {
 #if defined(OS_SOLARIS)
 		ofts->localdevs = NULL;
 #else
-		ofts->localdevs = fsdev_init();
+		/* the table is shared by all walks of the scan */
+		ofts->localdevs = oval_walk_localdevs_get();
 		if (ofts->localdevs == NULL) {
-			dE("fsdev_init() failed.");
-			/* One dummy read to get rid of an uninitialized
-			 * value in the FTS data before calling
-			 * fts_close() on it. */
-			fts_read(ofts->ofts_match_path_fts);
+			dE("oval_walk_localdevs_get() failed.");
 			oval_fts_close(ofts);
 			return (NULL);
 		}
 #endif
-	} else if (filesystem == OVAL_RECURSE_FS_DEFINED) {
+	} else if (filesystem == OVAL_RECURSE_FS_DEFINED && !ofts->ofts_exact) {
 		/* store the device id for future comparison */
-		FTSENT *fts_ent;
+		OVAL_WALKENT *fts_ent;
 
-		fts_ent = fts_read(ofts->ofts_match_path_fts);
+		fts_ent = oval_walk_read(ofts->ofts_match_path_fts);
 		if (fts_ent != NULL) {
 			ofts->ofts_recurse_path_devid = fts_ent->fts_statp->st_dev;
-			fts_set(ofts->ofts_match_path_fts, fts_ent, FTS_AGAIN);
+			oval_walk_set(ofts->ofts_match_path_fts, fts_ent, FTS_AGAIN);
 		}
 	}
 
@@ -772,11 +883,22 @@ OVAL_FTS *oval_fts_open_prefixed(const char *prefix, SEXP_t *path, SEXP_t *filen
 #endif
 
 	ofts->result = result;
+	ofts->tokens = result != NULL && probe_cobj_tracks_tokens(result);
+
+	if (ofts->ofts_exact)
+		oval_fts_lookup_exact(ofts, nilfilename ? NULL : cstr_file);
 
 	return (ofts);
 }
 
-static inline int _oval_fts_is_local(OVAL_FTS *ofts, FTSENT *fts_ent) {
+/* Directories are recorded before their entries are read */
+static inline void _oval_fts_add_token(OVAL_FTS *ofts, OVAL_WALKENT *fts_ent)
+{
+	if (ofts->tokens && (fts_ent->fts_info == FTS_D || fts_ent->fts_info == FTS_DNR))
+		probe_cobj_add_token(ofts->result, fts_ent->fts_path);
+}
+
+static inline int _oval_fts_is_local(OVAL_FTS *ofts, OVAL_WALKENT *fts_ent) {
 # if defined(OS_SOLARIS)
 	/* pseudo filesystems will be skipped */
 	/* don't recurse into remote fs if local is specified */
@@ -795,23 +917,24 @@ static inline int _oval_fts_is_local(OVAL_FTS *ofts, FTSENT *fts_ent) {
 }
 
 /* find the first matching path or filepath */
-static FTSENT *oval_fts_read_match_path(OVAL_FTS *ofts)
+static OVAL_WALKENT *oval_fts_read_match_path(OVAL_FTS *ofts)
 {
-	FTSENT *fts_ent = NULL;
+	OVAL_WALKENT *fts_ent = NULL;
 	SEXP_t *stmp;
 	oval_result_t ores;
 
 	/* iterate until a match is found or all elements have been traversed */
 	for (;;) {
-		fts_ent = fts_read(ofts->ofts_match_path_fts);
+		fts_ent = oval_walk_read(ofts->ofts_match_path_fts);
 		if (fts_ent == NULL)
 			return NULL;
+		_oval_fts_add_token(ofts, fts_ent);
 		switch (fts_ent->fts_info) {
 		case FTS_DP:
 			continue;
 		case FTS_DC:
 			dW("Filesystem tree cycle detected at '%s'.", fts_ent->fts_path);
-			fts_set(ofts->ofts_match_path_fts, fts_ent, FTS_SKIP);
+			oval_walk_set(ofts->ofts_match_path_fts, fts_ent, FTS_SKIP);
 			continue;
 		}
 
@@ -826,19 +949,19 @@ static FTSENT *oval_fts_read_match_path(OVAL_FTS *ofts)
 #if defined(OSCAP_FTS_DEBUG)
 			dD("Only the target of a symlink gets reported, skipping '%s'.", fts_ent->fts_path, fts_ent->fts_name);
 #endif
-			fts_set(ofts->ofts_match_path_fts, fts_ent, FTS_FOLLOW);
+			oval_walk_set(ofts->ofts_match_path_fts, fts_ent, FTS_FOLLOW);
 			continue;
 		}
 		if (_oval_fts_is_local(ofts, fts_ent)) {
 			dI("Don't recurse into non-local filesystems, skipping '%s'.", fts_ent->fts_path);
-			fts_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
+			oval_walk_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
 			continue;
 		}
 		/* don't recurse beyond the initial filesystem */
 		if (ofts->filesystem == OVAL_RECURSE_FS_DEFINED
 		    && (fts_ent->fts_info == FTS_D || fts_ent->fts_info == FTS_SL)
 		    && ofts->ofts_recurse_path_devid != fts_ent->fts_statp->st_dev) {
-			fts_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
+			oval_walk_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
 			continue;
 		}
 
@@ -854,7 +977,7 @@ static FTSENT *oval_fts_read_match_path(OVAL_FTS *ofts)
 				switch (ret) {
 				case OSCAP_PCRE_ERR_NOMATCH:
 					dD("Partial match optimization: PCRE_ERROR_NOMATCH, skipping.");
-					fts_set(ofts->ofts_match_path_fts, fts_ent, FTS_SKIP);
+					oval_walk_set(ofts->ofts_match_path_fts, fts_ent, FTS_SKIP);
 					continue;
 				case OSCAP_PCRE_ERR_PARTIAL:
 					dD("Partial match optimization: PCRE_ERROR_PARTIAL, continuing.");
@@ -885,7 +1008,7 @@ static FTSENT *oval_fts_read_match_path(OVAL_FTS *ofts)
 		if (ofts->ofts_path_op == OVAL_OPERATION_EQUALS) {
 			/* At this point the comparison result isn't OVAL_RESULT_TRUE. Since
 			we passed the exact path (from filepath or path elements) to
-			fts_open() we surely know that we can't find other items that would
+			oval_walk_open() we surely know that we can't find other items that would
 			be equal. Therefore we can terminate the matching. This can happen
 			if the filepath or path element references a variable that has
 			multiple different values. */
@@ -903,16 +1026,16 @@ static FTSENT *oval_fts_read_match_path(OVAL_FTS *ofts)
 	    ofts->ofts_sfilename == NULL &&
 	    ofts->ofts_sfilepath == NULL)
 	{
-		fts_set(ofts->ofts_match_path_fts, fts_ent, FTS_SKIP);
+		oval_walk_set(ofts->ofts_match_path_fts, fts_ent, FTS_SKIP);
 	}
 
 	return fts_ent;
 }
 
 /* find the first matching file or directory */
-static FTSENT *oval_fts_read_recurse_path(OVAL_FTS *ofts)
+static OVAL_WALKENT *oval_fts_read_recurse_path(OVAL_FTS *ofts)
 {
-	FTSENT *out_fts_ent = NULL;
+	OVAL_WALKENT *out_fts_ent = NULL;
 	/* the condition below is correct because ofts_sfilepath is NULL here */
 	bool collect_dirs = (ofts->ofts_sfilename == NULL);
 
@@ -930,52 +1053,44 @@ static FTSENT *oval_fts_read_recurse_path(OVAL_FTS *ofts)
 
 		/* initialize separate fts for recursion */
 		if (ofts->ofts_recurse_path_fts == NULL) {
-			char * const paths[2] = { ofts->ofts_match_path_fts_ent->fts_path, NULL };
+			const char *path = ofts->ofts_match_path_fts_ent->fts_path;
 
 #if defined(OSCAP_FTS_DEBUG)
-			dD("fts_open args: path: \"%s\", options: %d.",
-				paths[0], ofts->ofts_recurse_path_fts_opts);
+			dD("oval_walk_open args: path: \"%s\", options: %d.",
+				path, ofts->ofts_recurse_path_walk_opts);
 #endif
-			/* reset errno as fts_open() doesn't do it itself. */
-			errno = 0;
-			ofts->ofts_recurse_path_fts = fts_open(paths,
-				ofts->ofts_recurse_path_fts_opts, NULL);
-			/* fts_open() doesn't return NULL for all errors
-			   (e.g. nonexistent paths), so check errno to detect it.
-			   Far from being perfect. */
-			if (ofts->ofts_recurse_path_fts == NULL || errno != 0) {
-				dE("fts_open() failed, errno: %d \"%s\".",
+			ofts->ofts_recurse_path_fts = oval_walk_open(path,
+				ofts->ofts_recurse_path_walk_opts);
+			if (ofts->ofts_recurse_path_fts == NULL) {
+				dE("oval_walk_open() failed, errno: %d \"%s\".",
 					errno, strerror(errno));
 #if !defined(OSCAP_FTS_DEBUG)
-				dE("fts_open args: path: \"%s\", options: %d.",
-					paths[0], ofts->ofts_recurse_path_fts_opts);
+				dE("oval_walk_open args: path: \"%s\", options: %d.",
+					path, ofts->ofts_recurse_path_walk_opts);
 #endif
-				if (ofts->ofts_recurse_path_fts != NULL) {
-					fts_close(ofts->ofts_recurse_path_fts);
-					ofts->ofts_recurse_path_fts = NULL;
-				}
 				return (NULL);
 			}
 		}
 
 		/* iterate until a match is found or all elements have been traversed */
 		while (out_fts_ent == NULL) {
-			FTSENT *fts_ent;
+			OVAL_WALKENT *fts_ent;
 
-			fts_ent = fts_read(ofts->ofts_recurse_path_fts);
+			fts_ent = oval_walk_read(ofts->ofts_recurse_path_fts);
 			if (fts_ent == NULL) {
-				fts_close(ofts->ofts_recurse_path_fts);
+				oval_walk_close(ofts->ofts_recurse_path_fts);
 				ofts->ofts_recurse_path_fts = NULL;
 
 				return NULL;
 			}
+			_oval_fts_add_token(ofts, fts_ent);
 
 			switch (fts_ent->fts_info) {
 			case FTS_DP:
 				continue;
 			case FTS_DC:
 				dW("Filesystem tree cycle detected at '%s'.", fts_ent->fts_path);
-				fts_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
+				oval_walk_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
 				continue;
 			}
 
@@ -1018,7 +1133,7 @@ static FTSENT *oval_fts_read_recurse_path(OVAL_FTS *ofts)
 				/* limit recursion depth */
 				if (ofts->direction == OVAL_RECURSE_DIRECTION_NONE
 				    || (ofts->max_depth != -1 && fts_ent->fts_level > ofts->max_depth)) {
-					fts_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
+					oval_walk_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
 					continue;
 				}
 
@@ -1026,17 +1141,17 @@ static FTSENT *oval_fts_read_recurse_path(OVAL_FTS *ofts)
 				switch (fts_ent->fts_info) {
 				case FTS_D:
 					if (!(ofts->recurse & OVAL_RECURSE_DIRS) && !(ofts->recurse & OVAL_RECURSE_SYMLINKS && ofts->following)) {
-						fts_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
+						oval_walk_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
 						continue;
 					}
 					ofts->following = 0;
 					break;
 				case FTS_SL:
 					if (!(ofts->recurse & OVAL_RECURSE_SYMLINKS)) {
-						fts_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
+						oval_walk_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
 						continue;
 					}
-					fts_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_FOLLOW);
+					oval_walk_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_FOLLOW);
 					ofts->following = 1;
 					break;
 				default:
@@ -1044,14 +1159,14 @@ static FTSENT *oval_fts_read_recurse_path(OVAL_FTS *ofts)
 				}
 			}
 			if (_oval_fts_is_local(ofts, fts_ent)) {
-				fts_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
+				oval_walk_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
 				continue;
 			}
 			/* don't recurse beyond the initial filesystem */
 			if (ofts->filesystem == OVAL_RECURSE_FS_DEFINED
 			    && (fts_ent->fts_info == FTS_D || fts_ent->fts_info == FTS_SL)
 			    && ofts->ofts_recurse_path_devid != fts_ent->fts_statp->st_dev) {
-				fts_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
+				oval_walk_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
 				continue;
 			}
 		}
@@ -1067,41 +1182,33 @@ static FTSENT *oval_fts_read_recurse_path(OVAL_FTS *ofts)
 		while (ofts->max_depth == -1 || ofts->ofts_recurse_path_curdepth <= ofts->max_depth) {
 			/* initialize separate fts for recursion */
 			if (ofts->ofts_recurse_path_fts == NULL) {
-				char * const paths[2] = { ofts->ofts_recurse_path_curpth, NULL };
+				const char *path = ofts->ofts_recurse_path_curpth;
 
 #if defined(OSCAP_FTS_DEBUG)
-				dD("fts_open args: path: \"%s\", options: %d.",
-					paths[0], ofts->ofts_recurse_path_fts_opts);
+				dD("oval_walk_open args: path: \"%s\", options: %d.",
+					path, ofts->ofts_recurse_path_walk_opts);
 #endif
-				/* reset errno as fts_open() doesn't do it itself. */
-				errno = 0;
-				/* fts_open() doesn't return NULL for all errors
-				   (e.g. nonexistent paths), so check errno to
-				   detect it. Far from being perfect. */
-				ofts->ofts_recurse_path_fts = fts_open(paths,
-					ofts->ofts_recurse_path_fts_opts, NULL);
-				if (ofts->ofts_recurse_path_fts == NULL || errno != 0) {
-					dE("fts_open() failed, errno: %d \"%s\".",
+				ofts->ofts_recurse_path_fts = oval_walk_open(path,
+					ofts->ofts_recurse_path_walk_opts);
+				if (ofts->ofts_recurse_path_fts == NULL) {
+					dE("oval_walk_open() failed, errno: %d \"%s\".",
 						errno, strerror(errno));
 #if !defined(OSCAP_FTS_DEBUG)
-					dE("fts_open args: path: \"%s\", options: %d.",
-						paths[0], ofts->ofts_recurse_path_fts_opts);
+					dE("oval_walk_open args: path: \"%s\", options: %d.",
+						path, ofts->ofts_recurse_path_walk_opts);
 #endif
-					if (ofts->ofts_recurse_path_fts != NULL) {
-						fts_close(ofts->ofts_recurse_path_fts);
-						ofts->ofts_recurse_path_fts = NULL;
-					}
 					return (NULL);
 				}
 			}
 
 			/* iterate until a match is found or all elements have been traversed */
 			while (out_fts_ent == NULL) {
-				FTSENT *fts_ent;
+				OVAL_WALKENT *fts_ent;
 
-				fts_ent = fts_read(ofts->ofts_recurse_path_fts);
+				fts_ent = oval_walk_read(ofts->ofts_recurse_path_fts);
 				if (fts_ent == NULL)
 					break;
+				_oval_fts_add_token(ofts, fts_ent);
 
 				/*
 				   it would be more accurate to obtain the device
@@ -1133,7 +1240,7 @@ static FTSENT *oval_fts_read_recurse_path(OVAL_FTS *ofts)
 					/* only fts root is collected */
 					if (fts_ent->fts_level == 0 && fts_ent->fts_info == FTS_D) {
 						out_fts_ent = fts_ent;
-						fts_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
+						oval_walk_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
 						break;
 					}
 				} else {
@@ -1148,16 +1255,16 @@ static FTSENT *oval_fts_read_recurse_path(OVAL_FTS *ofts)
 				}
 
 				if (fts_ent->fts_info == FTS_SL)
-					fts_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_FOLLOW);
+					oval_walk_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_FOLLOW);
 				/* limit recursion only to fts root */
 				else if (fts_ent->fts_level > 0)
-					fts_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
+					oval_walk_set(ofts->ofts_recurse_path_fts, fts_ent, FTS_SKIP);
 			}
 
 			if (out_fts_ent != NULL)
 				break;
 
-			fts_close(ofts->ofts_recurse_path_fts);
+			oval_walk_close(ofts->ofts_recurse_path_fts);
 			ofts->ofts_recurse_path_fts = NULL;
 
 			if (!strcmp(ofts->ofts_recurse_path_curpth, "/"))
@@ -1180,7 +1287,7 @@ static FTSENT *oval_fts_read_recurse_path(OVAL_FTS *ofts)
 
 OVAL_FTSENT *oval_fts_read(OVAL_FTS *ofts)
 {
-	FTSENT *fts_ent;
+	OVAL_WALKENT *fts_ent;
 
 #if defined(OSCAP_FTS_DEBUG)
 	dD("ofts: %p.", ofts);
@@ -1189,6 +1296,20 @@ OVAL_FTSENT *oval_fts_read(OVAL_FTS *ofts)
 	if (ofts == NULL)
 		return NULL;
 
+	if (ofts->ofts_exact) {
+		OVAL_FTSENT *ofts_ent;
+
+		/* the only item was looked up by oval_fts_open_prefixed() */
+		if ((fts_ent = ofts->ofts_exact_ent) == NULL)
+			return NULL;
+		if (ofts->tokens && fts_ent->fts_info != FTS_D)
+			probe_cobj_add_token(ofts->result, fts_ent->fts_path);
+		ofts_ent = OVAL_FTSENT_new(ofts, fts_ent);
+		oval_walkent_free(fts_ent);
+		ofts->ofts_exact_ent = NULL;
+		return ofts_ent;
+	}
+
 	for (;;) {
 		if (ofts->ofts_match_path_fts_ent == NULL) {
 			ofts->ofts_match_path_fts_ent = oval_fts_read_match_path(ofts);
@@ -1220,6 +1341,9 @@ OVAL_FTSENT *oval_fts_read(OVAL_FTS *ofts)
 		}
 	}
 
+	if (ofts->tokens && fts_ent->fts_info != FTS_D)
+		probe_cobj_add_token(ofts->result, fts_ent->fts_path);
+
 	return OVAL_FTSENT_new(ofts, fts_ent);
 }
 
@@ -1243,7 +1367,7 @@ int oval_fts_close(OVAL_FTS *ofts)
 	if (ofts->ofts_sfilepath != NULL)
 		SEXP_free(ofts->ofts_sfilepath);
 
-	fsdev_free(ofts->localdevs);
+	oval_walk_localdevs_put(ofts->localdevs);
 
 	OVAL_FTS_free(ofts);
 #if defined(OS_SOLARIS)
@@ -31,6 +31,7 @@
 #include <fts.h>
 #endif
 #include "fsdev.h"
+#include "oval_fts_walk.h"
 #include "common/oscap_pcre.h"
 
 #define ENT_GET_AREF(ent, dst, attr_name, mandatory)			\
@@ -68,16 +69,20 @@
 
 typedef struct {
 	/* oval_fts_read_match_path() state */
-	FTS *ofts_match_path_fts;
-	FTSENT *ofts_match_path_fts_ent;
+	OVAL_WALK *ofts_match_path_fts;
+	OVAL_WALKENT *ofts_match_path_fts_ent;
 	/* oval_fts_read_recurse_path() state */
-	FTS *ofts_recurse_path_fts;
-	int ofts_recurse_path_fts_opts;
+	OVAL_WALK *ofts_recurse_path_fts;
+	int ofts_recurse_path_walk_opts;
 	int ofts_recurse_path_curdepth;
 	char *ofts_recurse_path_pthcpy;
 	char *ofts_recurse_path_curpth;
 	dev_t ofts_recurse_path_devid;
 
+	/* exact path lookup, used instead of the walks when possible */
+	bool ofts_exact;
+	OVAL_WALKENT *ofts_exact_ent;
+
 	oscap_pcre_t *ofts_path_regex;
 	uint32_t ofts_path_op;
 
@@ -94,6 +99,7 @@ typedef struct {
 
 	fsdev_t *localdevs;
 	const char *prefix;
+	bool tokens; /* record validity tokens in result */
 } OVAL_FTS;
 
 #define OVAL_RECURSE_DIRECTION_NONE 0 /* default */
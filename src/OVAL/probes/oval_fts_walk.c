@@ -0,0 +1,665 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "oscap_platforms.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#if defined(OS_LINUX)
+#include <sys/vfs.h>
+#endif
+#ifdef OSCAP_THREAD_SAFE
+#include <pthread.h>
+#endif
+
+#include "common/list.h"
+#include "debug_priv.h"
+#include "oval_fts_walk.h"
+
+#ifndef O_DIRECTORY
+#define O_DIRECTORY 0
+#endif
+#ifndef O_CLOEXEC
+#define O_CLOEXEC 0
+#endif
+
+#define OVAL_WALK_CACHE_ENTRIES_DEFAULT 100000
+#define OVAL_WALK_SIGLEN 6
+
+struct oval_walk_dirent {
+	struct stat st;
+	int err;		/* errno of lstat(2), 0 if it succeeded */
+	size_t name;		/* offset of the name in the names buffer */
+	size_t namelen;
+};
+
+/* Entries of a directory in the order readdir(3) returned them */
+struct oval_walk_dir {
+	uint64_t sig[OVAL_WALK_SIGLEN];
+	struct oval_walk_dirent *ents;
+	size_t count;
+	char *names;
+	unsigned int refcount;
+};
+
+/* A directory the walk is in, the topmost one is the parent of the current entry */
+struct oval_walk_frame {
+	struct oval_walk_dir *dir;
+	size_t next;
+	size_t pathlen;
+	dev_t dev;
+	ino_t ino;
+	short level;
+};
+
+struct oval_walk {
+	OVAL_WALKENT ent;
+	char *path;
+	size_t path_size;
+	struct oval_walk_frame *frames;
+	size_t depth;
+	size_t frames_size;
+	dev_t root_dev;
+	int options;
+	bool started;
+	bool finished;
+};
+
+struct oval_walk_localdevs {
+	fsdev_t devs; /* has to be the first member */
+	unsigned int refcount;
+};
+
+static struct oval_walk_cache {
+	unsigned int users;
+	struct oscap_htable *dirs;
+	size_t entries;
+	size_t max_entries;
+	struct oval_walk_localdevs *localdevs;
+	unsigned long hits;
+	unsigned long misses;
+	unsigned long stale;
+	unsigned long generation;
+} oval_walk_cache;
+
+#ifdef OSCAP_THREAD_SAFE
+static pthread_mutex_t oval_walk_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+#define OVAL_WALK_CACHE_LOCK() (void)pthread_mutex_lock(&oval_walk_cache_lock)
+#define OVAL_WALK_CACHE_UNLOCK() (void)pthread_mutex_unlock(&oval_walk_cache_lock)
+#else
+#define OVAL_WALK_CACHE_LOCK() do {} while (0)
+#define OVAL_WALK_CACHE_UNLOCK() do {} while (0)
+#endif
+
+/*
+ * The part of the directory stat data which changes whenever an entry
+ * is added to the directory, removed from it or renamed.
+ */
+static void _oval_walk_sig(const struct stat *st, uint64_t sig[OVAL_WALK_SIGLEN])
+{
+	sig[0] = (uint64_t) st->st_dev;
+	sig[1] = (uint64_t) st->st_ino;
+#if defined(OS_LINUX) || defined(OS_SOLARIS)
+	sig[2] = (uint64_t) st->st_mtim.tv_sec;
+	sig[3] = (uint64_t) st->st_mtim.tv_nsec;
+	sig[4] = (uint64_t) st->st_ctim.tv_sec;
+	sig[5] = (uint64_t) st->st_ctim.tv_nsec;
+#elif defined(OS_FREEBSD) || defined(OS_APPLE)
+	sig[2] = (uint64_t) st->st_mtimespec.tv_sec;
+	sig[3] = (uint64_t) st->st_mtimespec.tv_nsec;
+	sig[4] = (uint64_t) st->st_ctimespec.tv_sec;
+	sig[5] = (uint64_t) st->st_ctimespec.tv_nsec;
+#else
+	sig[2] = (uint64_t) st->st_mtime;
+	sig[3] = 0;
+	sig[4] = (uint64_t) st->st_ctime;
+	sig[5] = 0;
+#endif
+}
+
+/*
+ * Directories of pseudo filesystems don't change their stat data when
+ * their entries come and go, so they can't be cached.
+ */
+static bool _oval_walk_cacheable(int fd)
+{
+#if defined(OS_LINUX)
+	struct statfs sfs;
+
+	if (fstatfs(fd, &sfs) != 0)
+		return false;
+	switch ((unsigned long) sfs.f_type) {
+	case 0x9fa0:     /* PROC_SUPER_MAGIC */
+	case 0x62656572: /* SYSFS_MAGIC */
+	case 0x27e0eb:   /* CGROUP_SUPER_MAGIC */
+	case 0x63677270: /* CGROUP2_SUPER_MAGIC */
+		return false;
+	}
+#endif
+	return true;
+}
+
+static void _oval_walk_dir_free(struct oval_walk_dir *dir)
+{
+	free(dir->ents);
+	free(dir->names);
+	free(dir);
+}
+
+/* Has to be called with the cache lock held */
+static void _oval_walk_dir_unref(void *ptr)
+{
+	struct oval_walk_dir *dir = ptr;
+
+	if (--dir->refcount == 0)
+		_oval_walk_dir_free(dir);
+}
+
+static void _oval_walk_dir_release(struct oval_walk_dir *dir)
+{
+	OVAL_WALK_CACHE_LOCK();
+	_oval_walk_dir_unref(dir);
+	OVAL_WALK_CACHE_UNLOCK();
+}
+
+static struct oval_walk_dir *_oval_walk_dir_read(int fd, const uint64_t sig[OVAL_WALK_SIGLEN])
+{
+	struct oval_walk_dir *dir;
+	struct dirent *de;
+	size_t ents_size = 0, names_size = 0, names_len = 0;
+	DIR *dp;
+
+	if ((dp = fdopendir(fd)) == NULL) {
+		close(fd);
+		return NULL;
+	}
+	dir = calloc(1, sizeof(struct oval_walk_dir));
+	memcpy(dir->sig, sig, sizeof(dir->sig));
+	dir->refcount = 1;
+
+	while ((de = readdir(dp)) != NULL) {
+		if (de->d_name[0] == '.' &&
+		    (de->d_name[1] == '\0' || (de->d_name[1] == '.' && de->d_name[2] == '\0')))
+			continue;
+
+		size_t namelen = strlen(de->d_name);
+		if (dir->count == ents_size) {
+			ents_size = ents_size ? ents_size * 2 : 16;
+			dir->ents = realloc(dir->ents, ents_size * sizeof(struct oval_walk_dirent));
+		}
+		if (names_len + namelen + 1 > names_size) {
+			while (names_len + namelen + 1 > names_size)
+				names_size = names_size ? names_size * 2 : 256;
+			dir->names = realloc(dir->names, names_size);
+		}
+
+		struct oval_walk_dirent *ent = &dir->ents[dir->count++];
+		ent->name = names_len;
+		ent->namelen = namelen;
+		memcpy(dir->names + names_len, de->d_name, namelen + 1);
+		names_len += namelen + 1;
+
+		if (fstatat(dirfd(dp), de->d_name, &ent->st, AT_SYMLINK_NOFOLLOW) != 0) {
+			ent->err = errno;
+			memset(&ent->st, 0, sizeof(struct stat));
+		} else {
+			ent->err = 0;
+		}
+	}
+	closedir(dp);
+
+	return dir;
+}
+
+/* Return the entries of the directory at path, from the cache if they are still valid */
+static struct oval_walk_dir *_oval_walk_dir_get(const char *path)
+{
+	struct oval_walk_dir *dir;
+	uint64_t sig[OVAL_WALK_SIGLEN];
+	struct stat st;
+	int fd;
+
+	if ((fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC)) == -1)
+		return NULL;
+	if (fstat(fd, &st) != 0) {
+		close(fd);
+		return NULL;
+	}
+	_oval_walk_sig(&st, sig);
+
+	OVAL_WALK_CACHE_LOCK();
+	if (oval_walk_cache.dirs != NULL) {
+		dir = oscap_htable_get(oval_walk_cache.dirs, path);
+		if (dir != NULL) {
+			if (memcmp(dir->sig, sig, sizeof(sig)) == 0) {
+				dir->refcount++;
+				oval_walk_cache.hits++;
+				OVAL_WALK_CACHE_UNLOCK();
+				close(fd);
+				return dir;
+			}
+			oscap_htable_detach(oval_walk_cache.dirs, path);
+			oval_walk_cache.entries -= dir->count;
+			oval_walk_cache.stale++;
+			_oval_walk_dir_unref(dir);
+		}
+		oval_walk_cache.misses++;
+	}
+	OVAL_WALK_CACHE_UNLOCK();
+
+	bool cacheable = _oval_walk_cacheable(fd);
+	if ((dir = _oval_walk_dir_read(fd, sig)) == NULL)
+		return NULL;
+	if (!cacheable)
+		return dir;
+
+	OVAL_WALK_CACHE_LOCK();
+	if (oval_walk_cache.dirs != NULL
+	    && oval_walk_cache.entries + dir->count <= oval_walk_cache.max_entries
+	    && oscap_htable_add(oval_walk_cache.dirs, path, dir)) {
+		oval_walk_cache.entries += dir->count;
+		dir->refcount++;
+	}
+	OVAL_WALK_CACHE_UNLOCK();
+
+	return dir;
+}
+
+static unsigned short _oval_walk_info(OVAL_WALK *walk, const struct stat *st)
+{
+	if (S_ISDIR(st->st_mode)) {
+		for (size_t i = 0; walk != NULL && i < walk->depth; i++) {
+			if (walk->frames[i].dev == st->st_dev && walk->frames[i].ino == st->st_ino)
+				return FTS_DC;
+		}
+		return FTS_D;
+	}
+	if (S_ISLNK(st->st_mode))
+		return FTS_SL;
+	if (S_ISREG(st->st_mode))
+		return FTS_F;
+	return FTS_DEFAULT;
+}
+
+static unsigned short _oval_walk_stat(OVAL_WALK *walk, OVAL_WALKENT *ent, bool follow)
+{
+	struct stat *st = &ent->fts_stat;
+
+	if (follow) {
+		if (stat(ent->fts_path, st) != 0) {
+			int err = errno;
+
+			if (err == ENOENT && lstat(ent->fts_path, st) == 0) {
+				errno = 0;
+				return FTS_SLNONE;
+			}
+			memset(st, 0, sizeof(struct stat));
+			errno = err;
+			return FTS_NS;
+		}
+	} else if (lstat(ent->fts_path, st) != 0) {
+		memset(st, 0, sizeof(struct stat));
+		return FTS_NS;
+	}
+
+	return _oval_walk_info(walk, st);
+}
+
+static void _oval_walk_reserve(OVAL_WALK *walk, size_t len)
+{
+	if (len + 1 > walk->path_size) {
+		while (len + 1 > walk->path_size)
+			walk->path_size *= 2;
+		walk->path = realloc(walk->path, walk->path_size);
+	}
+}
+
+OVAL_WALK *oval_walk_open(const char *path, int options)
+{
+	OVAL_WALK *walk = calloc(1, sizeof(OVAL_WALK));
+	size_t len = strlen(path);
+
+	walk->path_size = 256;
+	walk->path = malloc(walk->path_size);
+	_oval_walk_reserve(walk, len);
+	memcpy(walk->path, path, len + 1);
+	walk->options = options;
+
+	OVAL_WALKENT *ent = &walk->ent;
+	/* the root is named by its last path component, like in fts_open(3) */
+	char *name = strrchr(walk->path, '/');
+	if (name == NULL || len == 1)
+		name = walk->path;
+	else
+		name++;
+	ent->fts_path = walk->path;
+	ent->fts_pathlen = len;
+	ent->fts_name = name;
+	ent->fts_namelen = len - (size_t) (name - walk->path);
+	ent->fts_level = 0;
+	ent->fts_statp = &ent->fts_stat;
+	ent->fts_instr = FTS_NOINSTR;
+	ent->fts_info = _oval_walk_stat(walk, ent, true);
+	if (ent->fts_info == FTS_NS) {
+		int err = errno;
+
+		oval_walk_close(walk);
+		errno = err;
+		return NULL;
+	}
+	walk->root_dev = ent->fts_stat.st_dev;
+
+	return walk;
+}
+
+/* Enter the directory of the current entry */
+static int _oval_walk_push(OVAL_WALK *walk)
+{
+	OVAL_WALKENT *ent = &walk->ent;
+	struct oval_walk_dir *dir;
+
+	if ((dir = _oval_walk_dir_get(ent->fts_path)) == NULL)
+		return -1;
+
+	if (walk->depth == walk->frames_size) {
+		walk->frames_size = walk->frames_size ? walk->frames_size * 2 : 16;
+		walk->frames = realloc(walk->frames, walk->frames_size * sizeof(struct oval_walk_frame));
+	}
+	struct oval_walk_frame *frame = &walk->frames[walk->depth++];
+	frame->dir = dir;
+	frame->next = 0;
+	frame->pathlen = ent->fts_pathlen;
+	frame->dev = ent->fts_stat.st_dev;
+	frame->ino = ent->fts_stat.st_ino;
+	frame->level = ent->fts_level;
+
+	return 0;
+}
+
+/* Move to the next entry of the innermost directory which has any left */
+static OVAL_WALKENT *_oval_walk_next(OVAL_WALK *walk)
+{
+	OVAL_WALKENT *ent = &walk->ent;
+
+	while (walk->depth > 0) {
+		struct oval_walk_frame *frame = &walk->frames[walk->depth - 1];
+
+		if (frame->next == frame->dir->count) {
+			_oval_walk_dir_release(frame->dir);
+			walk->depth--;
+			continue;
+		}
+
+		const struct oval_walk_dirent *de = &frame->dir->ents[frame->next++];
+		/* don't double the slash if the directory path ends with one */
+		size_t base = frame->pathlen;
+		if (base > 0 && walk->path[base - 1] == '/')
+			base--;
+
+		_oval_walk_reserve(walk, base + 1 + de->namelen);
+		walk->path[base] = '/';
+		memcpy(walk->path + base + 1, frame->dir->names + de->name, de->namelen + 1);
+
+		ent->fts_path = walk->path;
+		ent->fts_pathlen = base + 1 + de->namelen;
+		ent->fts_name = walk->path + base + 1;
+		ent->fts_namelen = de->namelen;
+		ent->fts_level = frame->level + 1;
+		ent->fts_instr = FTS_NOINSTR;
+		if (de->err != 0) {
+			memset(&ent->fts_stat, 0, sizeof(struct stat));
+			ent->fts_info = FTS_NS;
+		} else {
+			ent->fts_stat = de->st;
+			ent->fts_info = _oval_walk_info(walk, &ent->fts_stat);
+		}
+
+		return ent;
+	}
+
+	walk->finished = true;
+	return NULL;
+}
+
+OVAL_WALKENT *oval_walk_read(OVAL_WALK *walk)
+{
+	OVAL_WALKENT *ent = &walk->ent;
+
+	if (walk->finished)
+		return NULL;
+	if (!walk->started) {
+		walk->started = true;
+		return ent;
+	}
+
+	switch (ent->fts_instr) {
+	case FTS_AGAIN:
+		ent->fts_instr = FTS_NOINSTR;
+		ent->fts_info = _oval_walk_stat(walk, ent, ent->fts_level == 0);
+		return ent;
+	case FTS_FOLLOW:
+		ent->fts_instr = FTS_NOINSTR;
+		if (ent->fts_info == FTS_SL || ent->fts_info == FTS_SLNONE) {
+			ent->fts_info = _oval_walk_stat(walk, ent, true);
+			return ent;
+		}
+		break;
+	}
+
+	if (ent->fts_info == FTS_D && ent->fts_instr != FTS_SKIP
+	    && !((walk->options & OVAL_WALK_XDEV) && ent->fts_stat.st_dev != walk->root_dev)) {
+		if (_oval_walk_push(walk) != 0) {
+			/* the directory is reported again, like fts_read(3) does */
+			ent->fts_info = FTS_DNR;
+			return ent;
+		}
+	}
+
+	return _oval_walk_next(walk);
+}
+
+OVAL_WALKENT *oval_walk_stat(const char *path, short level)
+{
+	OVAL_WALKENT *ent = calloc(1, sizeof(OVAL_WALKENT));
+	size_t len = strlen(path);
+
+	ent->fts_path = strdup(path);
+	ent->fts_pathlen = len;
+	char *name = strrchr(ent->fts_path, '/');
+	if (name == NULL || (level == 0 && len == 1))
+		name = ent->fts_path;
+	else
+		name++;
+	ent->fts_name = name;
+	ent->fts_namelen = len - (size_t) (name - ent->fts_path);
+	ent->fts_level = level;
+	ent->fts_statp = &ent->fts_stat;
+	ent->fts_instr = FTS_NOINSTR;
+	ent->fts_info = _oval_walk_stat(NULL, ent, level == 0);
+	if (ent->fts_info == FTS_NS) {
+		int err = errno;
+
+		oval_walkent_free(ent);
+		errno = err;
+		return NULL;
+	}
+
+	return ent;
+}
+
+void oval_walkent_free(OVAL_WALKENT *ent)
+{
+	if (ent == NULL)
+		return;
+	free(ent->fts_path);
+	free(ent);
+}
+
+int oval_walk_set(OVAL_WALK *walk, OVAL_WALKENT *ent, int instr)
+{
+	(void) walk;
+
+	if (ent == NULL)
+		return -1;
+	ent->fts_instr = instr;
+	return 0;
+}
+
+void oval_walk_close(OVAL_WALK *walk)
+{
+	if (walk == NULL)
+		return;
+	while (walk->depth > 0)
+		_oval_walk_dir_release(walk->frames[--walk->depth].dir);
+	free(walk->frames);
+	free(walk->path);
+	free(walk);
+}
+
+/* Has to be called with the cache lock held */
+static void _oval_walk_localdevs_unref(struct oval_walk_localdevs *localdevs)
+{
+	if (--localdevs->refcount == 0) {
+		free(localdevs->devs.ids);
+		free(localdevs);
+	}
+}
+
+/* Has to be called with the cache lock held */
+static void _oval_walk_cache_drop(void)
+{
+	if (oval_walk_cache.dirs != NULL) {
+		oscap_htable_free(oval_walk_cache.dirs, _oval_walk_dir_unref);
+		oval_walk_cache.dirs = NULL;
+	}
+	oval_walk_cache.entries = 0;
+	if (oval_walk_cache.localdevs != NULL) {
+		_oval_walk_localdevs_unref(oval_walk_cache.localdevs);
+		oval_walk_cache.localdevs = NULL;
+	}
+}
+
+void oval_walk_cache_acquire(void)
+{
+	OVAL_WALK_CACHE_LOCK();
+	if (oval_walk_cache.users++ == 0) {
+		const char *entries_env = getenv("OSCAP_PROBE_WALK_CACHE_ENTRIES");
+		long entries = OVAL_WALK_CACHE_ENTRIES_DEFAULT;
+
+		if (entries_env != NULL)
+			entries = strtol(entries_env, NULL, 10);
+		oval_walk_cache.max_entries = entries > 0 ? (size_t) entries : 0;
+		oval_walk_cache.hits = oval_walk_cache.misses = oval_walk_cache.stale = 0;
+		oval_walk_cache.generation++;
+		if (oval_walk_cache.max_entries > 0)
+			oval_walk_cache.dirs = oscap_htable_new();
+	}
+	OVAL_WALK_CACHE_UNLOCK();
+}
+
+void oval_walk_cache_clear(void)
+{
+	OVAL_WALK_CACHE_LOCK();
+	if (oval_walk_cache.users > 0) {
+		_oval_walk_cache_drop();
+		oval_walk_cache.generation++;
+		if (oval_walk_cache.max_entries > 0)
+			oval_walk_cache.dirs = oscap_htable_new();
+	}
+	OVAL_WALK_CACHE_UNLOCK();
+}
+
+void oval_walk_cache_release(void)
+{
+	OVAL_WALK_CACHE_LOCK();
+	if (oval_walk_cache.users > 0 && --oval_walk_cache.users == 0)
+		_oval_walk_cache_drop();
+	OVAL_WALK_CACHE_UNLOCK();
+}
+
+void oval_walk_cache_log_stats(void)
+{
+	OVAL_WALK_CACHE_LOCK();
+	dI("Directory walk cache: %lu hits, %lu misses, %lu stale, %zu of %zu entries used.",
+	   oval_walk_cache.hits, oval_walk_cache.misses, oval_walk_cache.stale,
+	   oval_walk_cache.entries, oval_walk_cache.max_entries);
+	OVAL_WALK_CACHE_UNLOCK();
+}
+
+unsigned long oval_walk_cache_generation(void)
+{
+	unsigned long generation;
+
+	OVAL_WALK_CACHE_LOCK();
+	generation = oval_walk_cache.generation;
+	OVAL_WALK_CACHE_UNLOCK();
+
+	return generation;
+}
+
+fsdev_t *oval_walk_localdevs_get(void)
+{
+	struct oval_walk_localdevs *localdevs;
+	fsdev_t *lfs;
+
+	OVAL_WALK_CACHE_LOCK();
+	if ((localdevs = oval_walk_cache.localdevs) != NULL) {
+		localdevs->refcount++;
+		OVAL_WALK_CACHE_UNLOCK();
+		return &localdevs->devs;
+	}
+	OVAL_WALK_CACHE_UNLOCK();
+
+	if ((lfs = fsdev_init()) == NULL)
+		return NULL;
+	localdevs = malloc(sizeof(struct oval_walk_localdevs));
+	localdevs->devs = *lfs;
+	localdevs->refcount = 1;
+	free(lfs);
+
+	OVAL_WALK_CACHE_LOCK();
+	if (oval_walk_cache.users > 0 && oval_walk_cache.localdevs == NULL) {
+		oval_walk_cache.localdevs = localdevs;
+		localdevs->refcount++;
+	}
+	OVAL_WALK_CACHE_UNLOCK();
+
+	return &localdevs->devs;
+}
+
+void oval_walk_localdevs_put(fsdev_t *localdevs)
+{
+	if (localdevs == NULL)
+		return;
+	OVAL_WALK_CACHE_LOCK();
+	_oval_walk_localdevs_unref((struct oval_walk_localdevs *) localdevs);
+	OVAL_WALK_CACHE_UNLOCK();
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#ifndef OVAL_FTS_WALK_H
+#define OVAL_FTS_WALK_H
+
+#include "oscap_platforms.h"
+
+#include <stddef.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#if defined(OS_SOLARIS) || defined(OS_AIX)
+#include "fts_sun.h"
+#else
+#include <fts.h>
+#endif
+#include "fsdev.h"
+
+/*
+ * Directory tree walk used by OVAL FTS. It visits the nodes in the same
+ * order and reports them with the same FTS_* codes as fts_read(3) opened
+ * with FTS_PHYSICAL | FTS_COMFOLLOW | FTS_NOCHDIR, except that directories
+ * aren't visited again in postorder (FTS_DP).
+ *
+ * While a walk cache user exists, the entries of the directories read
+ * by the walks and their lstat(2) data are shared by all walks of the
+ * scan, so that the probes looking into the same trees read every
+ * directory only once. A cached directory is read again if its stat
+ * data show that the list of its entries has changed.
+ */
+
+#define OVAL_WALK_XDEV 0x01 /* don't descend into directories on other devices */
+
+typedef struct {
+	char *fts_path;          /* path of the node, starts with the walk root */
+	size_t fts_pathlen;
+	char *fts_name;          /* last component of the path */
+	size_t fts_namelen;
+	unsigned short fts_info; /* FTS_D, FTS_F, FTS_SL, ... */
+	short fts_level;         /* depth, 0 for the root */
+	struct stat *fts_statp;
+	int fts_instr;           /* set by oval_walk_set() */
+	struct stat fts_stat;
+} OVAL_WALKENT;
+
+typedef struct oval_walk OVAL_WALK;
+
+/**
+ * Start a walk of the tree rooted at path. The root is followed if it
+ * is a symlink.
+ * @param path root of the walk
+ * @param options OVAL_WALK_* flags
+ * @return the walk or NULL with errno set if the root doesn't exist
+ */
+OVAL_WALK *oval_walk_open(const char *path, int options);
+
+/**
+ * Return the next node of the walk. The entry is valid until the next call.
+ * @return the entry or NULL when the walk is finished
+ */
+OVAL_WALKENT *oval_walk_read(OVAL_WALK *walk);
+
+/**
+ * Same as fts_set(3), instr is one of FTS_SKIP, FTS_FOLLOW or FTS_AGAIN.
+ * The instruction is stored in the entry, so the walk may be NULL.
+ */
+int oval_walk_set(OVAL_WALK *walk, OVAL_WALKENT *ent, int instr);
+
+void oval_walk_close(OVAL_WALK *walk);
+
+/**
+ * Stat a single node and describe it the way a walk reports it at the
+ * given level, without reading any directory: the root (level 0) is
+ * followed if it is a symlink, the nodes below it aren't.
+ * Release the entry by oval_walkent_free().
+ * @return the entry or NULL with errno set if the node can't be stat'ed
+ */
+OVAL_WALKENT *oval_walk_stat(const char *path, short level);
+
+void oval_walkent_free(OVAL_WALKENT *ent);
+
+/**
+ * Register a user of the scan-wide walk cache. The cache is filled only
+ * while it has at least one user and it is dropped with its last user.
+ */
+void oval_walk_cache_acquire(void);
+
+void oval_walk_cache_release(void);
+
+/**
+ * Drop the cached directories and the local device table, e.g. when
+ * a new scan starts.
+ */
+void oval_walk_cache_clear(void);
+
+void oval_walk_cache_log_stats(void);
+
+/**
+ * Return a number which changes whenever the cache is cleared, so that
+ * the probes can tell when to drop their own per-scan snapshots.
+ */
+unsigned long oval_walk_cache_generation(void);
+
+/**
+ * Return the table of local filesystem devices. The table is read once
+ * per scan while the walk cache is in use.
+ * Release the table by oval_walk_localdevs_put().
+ * @return the table or NULL on error
+ */
+fsdev_t *oval_walk_localdevs_get(void);
+
+void oval_walk_localdevs_put(fsdev_t *localdevs);
+
+#endif /* OVAL_FTS_WALK_H */
@@ -224,6 +224,38 @@ void probe_item_resetidctr(struct id_desc_t *id_desc)
 	id_desc->item_id_ctr = 1;
 }
 
+/*
+ * Whether the results collected so far decide the result of the entity check
+ * or of the state operator, so that the other entities needn't be compared
+ */
+static bool probe_chk_decided(oval_check_t ochk, oval_result_t ores, int true_cnt)
+{
+	switch (ochk) {
+	case OVAL_CHECK_ALL:
+		return ores == OVAL_RESULT_FALSE;
+	case OVAL_CHECK_AT_LEAST_ONE:
+	case OVAL_CHECK_NONE_EXIST:
+	case OVAL_CHECK_NONE_SATISFY:
+		return ores == OVAL_RESULT_TRUE;
+	case OVAL_CHECK_ONLY_ONE:
+		return true_cnt > 1;
+	default:
+		return false;
+	}
+}
+
+static bool probe_opr_decided(oval_operator_t oopr, oval_result_t ores)
+{
+	switch (oopr) {
+	case OVAL_OPERATOR_AND:
+		return ores == OVAL_RESULT_FALSE;
+	case OVAL_OPERATOR_OR:
+		return ores == OVAL_RESULT_TRUE;
+	default:
+		return false;
+	}
+}
+
 bool probe_item_filtered(const SEXP_t *item, const SEXP_t *filters)
 {
 	bool filtered = false;
@@ -241,15 +273,29 @@ bool probe_item_filtered(const SEXP_t *item, const SEXP_t *filters)
 		ste = SEXP_list_nth(filter, 2);
 		ste_res = SEXP_list_new(NULL);
 
+		r0 = probe_ent_getattrval(ste, "operator");
+		if (r0 == NULL)
+			oopr = OVAL_OPERATOR_AND;
+		else
+			oopr = SEXP_number_geti_32(r0);
+		SEXP_free(r0);
+
 		SEXP_sublist_foreach(felm, ste, 2, SEXP_LIST_END) {
 			SEXP_t *ielm, *elm_res;
 			char *elm_name;
 			oval_check_t ochk;
-			int i;
+			int i, true_cnt = 0;
 
 			elm_res = SEXP_list_new(NULL);
 			elm_name = probe_ent_getname(felm);
 
+			r0 = probe_ent_getattrval(felm, "entity_check");
+			if (r0 == NULL)
+				ochk = OVAL_CHECK_ALL;
+			else
+				ochk = SEXP_number_geti_32(r0);
+			SEXP_free(r0);
+
 			for (i = 1;; ++i) {
 				ielm = probe_obj_getent(item, elm_name, i);
 
@@ -261,37 +307,32 @@ bool probe_item_filtered(const SEXP_t *item, const SEXP_t *filters)
 
 				SEXP_free(ielm);
 				SEXP_free(r0);
-			}
-
-			if (SEXP_list_length(elm_res) > 0) {
-				r0 = probe_ent_getattrval(felm, "entity_check");
 
-				if (r0 == NULL)
-					ochk = OVAL_CHECK_ALL;
-				else
-					ochk = SEXP_number_geti_32(r0);
-
-				SEXP_free(r0);
+				if (ores == OVAL_RESULT_TRUE)
+					++true_cnt;
+				if (probe_chk_decided(ochk, ores, true_cnt))
+					break;
+			}
 
+			if (SEXP_list_length(elm_res) > 0)
 				ores = probe_ent_result_bychk(elm_res, ochk);
-			} else {
+			else
 				ores = OVAL_RESULT_FALSE;
-			}
+
 			SEXP_list_add(ste_res, r0 = SEXP_number_newi_32(ores));
 			SEXP_free(r0);
 			SEXP_free(elm_res);
 			free(elm_name);
+
+			if (probe_opr_decided(oopr, ores)) {
+				SEXP_free(felm);
+				break;
+			}
 		}
 
-		r0 = probe_ent_getattrval(ste, "operator");
-		if (r0 == NULL)
-			oopr = OVAL_OPERATOR_AND;
-		else
-			oopr = SEXP_number_geti_32(r0);
 		ores = probe_ent_result_byopr(ste_res, oopr);
 		SEXP_free(ste);
 		SEXP_free(ste_res);
-		SEXP_free(r0);
 
 		if ((ores == OVAL_RESULT_TRUE && ofact == OVAL_FILTER_ACTION_EXCLUDE)
 		    || (ores == OVAL_RESULT_FALSE && ofact == OVAL_FILTER_ACTION_INCLUDE)) {
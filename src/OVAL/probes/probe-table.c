@@ -317,10 +317,10 @@ static const probe_table_entry_t probe_table[] = {
 	{OVAL_UNIX_PASSWORD, NULL, password_probe_main, NULL, password_probe_offline_mode_supported},
 #endif
 #ifdef OPENSCAP_PROBE_UNIX_PROCESS
-	{OVAL_UNIX_PROCESS, NULL, process_probe_main, NULL, NULL},
+	{OVAL_UNIX_PROCESS, process_probe_init, process_probe_main, process_probe_fini, NULL},
 #endif
 #ifdef OPENSCAP_PROBE_UNIX_PROCESS58
-	{OVAL_UNIX_PROCESS58, NULL, process58_probe_main, NULL, process58_probe_offline_mode_supported},
+	{OVAL_UNIX_PROCESS58, process58_probe_init, process58_probe_main, process58_probe_fini, process58_probe_offline_mode_supported},
 #endif
 #ifdef OPENSCAP_PROBE_UNIX_ROUTINGTABLE
 	{OVAL_UNIX_ROUTINGTABLE, NULL, routingtable_probe_main, NULL, NULL},
@@ -335,7 +335,7 @@ static const probe_table_entry_t probe_table[] = {
 	{OVAL_UNIX_SYMLINK, NULL, symlink_probe_main, NULL, symlink_probe_offline_mode_supported},
 #endif
 #ifdef OPENSCAP_PROBE_UNIX_SYSCTL
-	{OVAL_UNIX_SYSCTL, NULL, sysctl_probe_main, NULL, sysctl_probe_offline_mode_supported},
+	{OVAL_UNIX_SYSCTL, sysctl_probe_init, sysctl_probe_main, sysctl_probe_fini, sysctl_probe_offline_mode_supported},
 #endif
 #ifdef OPENSCAP_PROBE_UNIX_UNAME
 	{OVAL_UNIX_UNAME, NULL, uname_probe_main, NULL, NULL},
@@ -0,0 +1,222 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "_probe-api.h"
+
+/*
+ * validity tokens
+ */
+
+/* Number of collection caches which need the tokens */
+static int probe_tokens_users = 0;
+#if !defined(HAVE_ATOMIC_FUNCTIONS)
+static pthread_mutex_t probe_tokens_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+void probe_tokens_enable(bool enable)
+{
+#if defined(HAVE_ATOMIC_FUNCTIONS)
+	__sync_fetch_and_add(&probe_tokens_users, enable ? 1 : -1);
+#else
+	pthread_mutex_lock(&probe_tokens_lock);
+	probe_tokens_users += enable ? 1 : -1;
+	pthread_mutex_unlock(&probe_tokens_lock);
+#endif
+}
+
+bool probe_tokens_enabled(void)
+{
+#if defined(HAVE_ATOMIC_FUNCTIONS)
+	return __sync_fetch_and_add(&probe_tokens_users, 0) > 0;
+#else
+	int users;
+
+	pthread_mutex_lock(&probe_tokens_lock);
+	users = probe_tokens_users;
+	pthread_mutex_unlock(&probe_tokens_lock);
+	return users > 0;
+#endif
+}
+
+void probe_cobj_track_tokens(SEXP_t *cobj)
+{
+	SEXP_t *tokens;
+
+	if (probe_cobj_tracks_tokens(cobj))
+		return;
+	tokens = SEXP_list_new(NULL);
+	SEXP_list_add(cobj, tokens);
+	SEXP_free(tokens);
+}
+
+bool probe_cobj_tracks_tokens(const SEXP_t *cobj)
+{
+	return SEXP_list_length(cobj) > 4;
+}
+
+SEXP_t *probe_cobj_get_tokens(const SEXP_t *cobj)
+{
+	return SEXP_list_nth(cobj, 5);
+}
+
+void probe_cobj_move_tokens(SEXP_t *dst, const SEXP_t *src)
+{
+	SEXP_t *src_tokens, *dst_tokens, *token;
+
+	src_tokens = probe_cobj_get_tokens(src);
+	if (src_tokens == NULL)
+		return;
+	probe_cobj_track_tokens(dst);
+	dst_tokens = SEXP_listref_nth(dst, 5);
+	SEXP_list_foreach(token, src_tokens)
+		SEXP_list_add(dst_tokens, token);
+	SEXP_free(dst_tokens);
+	SEXP_free(src_tokens);
+}
+
+#define PROBE_TOKEN_FOLLOW 0x01
+#define PROBE_TOKEN_EXISTS 0x02
+#define PROBE_TOKEN_SIGLEN 7
+
+/*
+ * The part of the stat data which changes whenever the node is replaced or
+ * its content, its metadata or (for directories) the list of entries changes.
+ */
+static void probe_token_sig(const struct stat *st, uint64_t sig[PROBE_TOKEN_SIGLEN])
+{
+	sig[0] = (uint64_t) st->st_dev;
+	sig[1] = (uint64_t) st->st_ino;
+	sig[2] = (uint64_t) st->st_size;
+#if defined(OS_LINUX) || defined(OS_SOLARIS)
+	sig[3] = (uint64_t) st->st_mtim.tv_sec;
+	sig[4] = (uint64_t) st->st_mtim.tv_nsec;
+	sig[5] = (uint64_t) st->st_ctim.tv_sec;
+	sig[6] = (uint64_t) st->st_ctim.tv_nsec;
+#elif defined(OS_FREEBSD) || defined(OS_APPLE)
+	sig[3] = (uint64_t) st->st_mtimespec.tv_sec;
+	sig[4] = (uint64_t) st->st_mtimespec.tv_nsec;
+	sig[5] = (uint64_t) st->st_ctimespec.tv_sec;
+	sig[6] = (uint64_t) st->st_ctimespec.tv_nsec;
+#else
+	sig[3] = (uint64_t) st->st_mtime;
+	sig[4] = 0;
+	sig[5] = (uint64_t) st->st_ctime;
+	sig[6] = 0;
+#endif
+}
+
+static int probe_token_stat(const char *path, bool follow, struct stat *st)
+{
+#if defined(OS_WINDOWS)
+	return stat(path, st);
+#else
+	return follow ? stat(path, st) : lstat(path, st);
+#endif
+}
+
+/*
+ * A token is a single string: a flags byte, the stat signature and the path.
+ * Nodes which don't exist are recorded too, so that creating them invalidates
+ * the token.
+ */
+static SEXP_t *probe_token_new(const char *path, bool follow, struct stat *st)
+{
+	uint8_t buf[1 + PROBE_TOKEN_SIGLEN * sizeof(uint64_t) + PATH_MAX];
+	uint64_t sig[PROBE_TOKEN_SIGLEN] = { 0 };
+	size_t path_len = strlen(path);
+
+	if (path_len > PATH_MAX)
+		return NULL;
+	buf[0] = follow ? PROBE_TOKEN_FOLLOW : 0;
+	memset(st, 0, sizeof(*st));
+	if (probe_token_stat(path, follow, st) == 0) {
+		buf[0] |= PROBE_TOKEN_EXISTS;
+		probe_token_sig(st, sig);
+	}
+	memcpy(buf + 1, sig, sizeof(sig));
+	memcpy(buf + 1 + sizeof(sig), path, path_len);
+	return SEXP_string_new(buf, 1 + sizeof(sig) + path_len);
+}
+
+int probe_cobj_add_token(SEXP_t *cobj, const char *path)
+{
+	SEXP_t *tokens, *token;
+	struct stat st;
+
+	tokens = SEXP_listref_nth(cobj, 5);
+	if (tokens == NULL)
+		return 0;
+	token = probe_token_new(path, false, &st);
+	if (token == NULL) {
+		SEXP_free(tokens);
+		return -1;
+	}
+	SEXP_list_add(tokens, token);
+	SEXP_free(token);
+#if !defined(OS_WINDOWS)
+	/* The content comes from wherever the link points to */
+	if (S_ISLNK(st.st_mode)) {
+		token = probe_token_new(path, true, &st);
+		SEXP_list_add(tokens, token);
+		SEXP_free(token);
+	}
+#endif
+	SEXP_free(tokens);
+	return 0;
+}
+
+SEXP_t *probe_token_new_path(const char *path)
+{
+	struct stat st;
+
+	return probe_token_new(path, false, &st);
+}
+
+bool probe_token_valid(const SEXP_t *token)
+{
+	uint8_t buf[1 + PROBE_TOKEN_SIGLEN * sizeof(uint64_t) + PATH_MAX + 1];
+	uint64_t sig[PROBE_TOKEN_SIGLEN], cur_sig[PROBE_TOKEN_SIGLEN];
+	size_t len;
+	struct stat st;
+
+	len = SEXP_string_length(token);
+	if (len <= 1 + sizeof(sig) || len >= sizeof(buf))
+		return false;
+	SEXP_string_cstr_r(token, (char *) buf, sizeof(buf));
+	memcpy(sig, buf + 1, sizeof(sig));
+
+	if (probe_token_stat((char *) buf + 1 + sizeof(sig), buf[0] & PROBE_TOKEN_FOLLOW, &st) != 0)
+		return !(buf[0] & PROBE_TOKEN_EXISTS);
+	if (!(buf[0] & PROBE_TOKEN_EXISTS))
+		return false;
+	probe_token_sig(&st, cur_sig);
+	return memcmp(sig, cur_sig, sizeof(sig)) == 0;
+}
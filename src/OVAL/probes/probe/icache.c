@@ -93,6 +93,11 @@ static void probe_icache_item_setID(SEXP_t *item, SEXP_ID_t item_ID)
         return;
 }
 
+void probe_icache_item_renew_id(SEXP_t *item)
+{
+	probe_icache_item_setID(item, 0);
+}
+
 static int icache_lookup(rbt_t *tree, int64_t item_id, probe_iqpair_t *pair) {
 
 	probe_citem_t *cached = NULL;
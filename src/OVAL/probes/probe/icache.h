@@ -63,4 +63,10 @@ int probe_icache_add(probe_icache_t *cache, SEXP_t *cobj, SEXP_t *item);
 int probe_icache_nop(probe_icache_t *cache);
 void probe_icache_free(probe_icache_t *cache);
 
+/*
+ * Give the item a new ID from the same sequence as the cached items, e.g.
+ * when it was restored from an earlier run.
+ */
+void probe_icache_item_renew_id(SEXP_t *item);
+
 #endif /* ICACHE_H */
@@ -42,20 +42,14 @@
 #include "input_handler.h"
 #include "common/compat_pthread_barrier.h"
 
-static void pthread_attr_cleanup_handler(void *arg)
-{
-	pthread_attr_destroy(arg);
-}
-
 /*
  * The input handler waits for incomming eval requests and either returns
- * a result immediately if it is found in the result cache or spawns a new
- * worker thread which takes care of evaluating the request, caching the
- * result and sending it to the requestee.
+ * a result immediately if it is found in the result cache or passes the
+ * request to the worker pool. A worker thread takes care of evaluating
+ * the request, caching the result and sending it to the requestee.
  */
 void *probe_input_handler(void *arg)
 {
-        pthread_attr_t pth_attr;
         probe_t       *probe = (probe_t *)arg;
 
         int probe_ret, cstate; /* XXX */
@@ -75,16 +69,6 @@ void *probe_input_handler(void *arg)
 
         TH_CANCEL_OFF;
 
-        if (pthread_attr_init(&pth_attr))
-                return (NULL);
-
-        if (pthread_attr_setdetachstate(&pth_attr, PTHREAD_CREATE_JOINABLE)) {
-                pthread_attr_destroy(&pth_attr);
-                return (NULL);
-        }
-
-	pthread_cleanup_push(pthread_attr_cleanup_handler, (void *)&pth_attr);
-        
         switch (errno = pthread_barrier_wait(&OSCAP_GSYM(th_barrier)))
         {
         case 0:
@@ -157,14 +141,12 @@ void *probe_input_handler(void *arg)
 					SEXP_free(skip_flag);
 					SEXP_free(obj_mask);
 
-					probe_pwpair_t *pair = malloc(sizeof(probe_pwpair_t));
-					pair->probe = probe;
-					pair->pth = probe_worker_new();
-					pair->pth->sid = SEAP_msg_id(seap_request);
-					pair->pth->msg = seap_request;
-					pair->pth->msg_handler = &probe_worker;
+					probe_worker_t *pth = probe_worker_new();
+					pth->sid = SEAP_msg_id(seap_request);
+					pth->msg = seap_request;
+					pth->msg_handler = &probe_worker;
 
-					if (rbt_i32_add(probe->workers, pair->pth->sid, pair->pth, NULL) != 0) {
+					if (rbt_i32_add(probe->workers, pth->sid, pth, NULL) != 0) {
 						/*
 							* Getting here means that there is already a
 							* thread handling the message with the given
@@ -172,24 +154,21 @@ void *probe_input_handler(void *arg)
 							*/
 						dW("Attempt to evaluate an object "
 							"(ID=%u) " // TODO: 64b IDs
-							"which is already being evaluated by another thread.", pair->pth->sid);
+							"which is already being evaluated by another thread.", pth->sid);
 
-						free(pair->pth);
-						free(pair);
+						free(pth);
 						SEAP_msg_free(seap_request);
 					} else {
 						/* OK */
 
-						if (pthread_create(&pair->pth->tid, &pth_attr, &probe_worker_runfn, pair))
+						if (probe_worker_pool_add(probe->pool, pth) != 0)
 						{
-							dE("Cannot start a new worker thread: %d, %s.", errno, strerror(errno));
+							dE("Cannot pass the object (ID=%u) to a worker thread.", pth->sid);
 
-							if (rbt_i32_del(probe->workers, pair->pth->sid, NULL) != 0)
-								dE("rbt_i32_del: failed to remove worker thread (ID=%u)", pair->pth->sid);
+							if (rbt_i32_del(probe->workers, pth->sid, NULL) != 0)
+								dE("rbt_i32_del: failed to remove worker thread (ID=%u)", pth->sid);
 
-							SEAP_msg_free(pair->pth->msg);
-							free(pair->pth);
-							free(pair);
+							free(pth);
 
 							probe_ret = PROBE_EUNKNOWN;
 							probe_out = NULL;
@@ -251,6 +230,5 @@ void *probe_input_handler(void *arg)
 		SEAP_msg_free(seap_request);
 	} /* main loop */
 
-        pthread_cleanup_pop(1);
         return (NULL);
 }
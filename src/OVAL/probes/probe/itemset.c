@@ -0,0 +1,172 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdlib.h>
+#include <string.h>
+#include <sexp.h>
+
+#include "_sexp-ID.h"
+#include "itemset.h"
+
+#define ITEMSET_MIN_SLOTS 16
+
+static size_t itemset_slot_cnt(size_t count)
+{
+	size_t slot_cnt = ITEMSET_MIN_SLOTS;
+
+	/* keep the load factor at 1/2 at most */
+	while (slot_cnt < 2 * count)
+		slot_cnt *= 2;
+
+	return slot_cnt;
+}
+
+probe_itemset_t *probe_itemset_new(size_t hint)
+{
+	probe_itemset_t *set = malloc(sizeof(probe_itemset_t));
+
+	set->count = 0;
+	set->alloc = hint > 0 ? hint : 1;
+	set->ent = malloc(set->alloc * sizeof(probe_itemset_ent_t));
+	set->slot_cnt = itemset_slot_cnt(hint);
+	set->slot = calloc(set->slot_cnt, sizeof(uint32_t));
+
+	return set;
+}
+
+void probe_itemset_free(probe_itemset_t *set)
+{
+	if (set == NULL)
+		return;
+
+	for (size_t i = 0; i < set->count; ++i)
+		SEXP_free(set->ent[i].item);
+
+	free(set->ent);
+	free(set->slot);
+	free(set);
+}
+
+uint64_t probe_itemset_hash(const SEXP_t *item)
+{
+	SEXP_t rest, *rest_r;
+	uint64_t hash;
+
+	rest_r = SEXP_list_rest_r(&rest, item);
+	if (rest_r == NULL)
+		return 0;
+	hash = SEXP_ID_v(rest_r);
+	SEXP_free_r(&rest);
+
+	return hash;
+}
+
+static bool itemset_item_eq(const SEXP_t *a, const SEXP_t *b)
+{
+	SEXP_t rest_a, rest_b, *rest_ra, *rest_rb;
+	bool eq;
+
+	/* items shared by the item cache are the most common case */
+	if (SEXP_eq(a, b))
+		return true;
+
+	rest_ra = SEXP_list_rest_r(&rest_a, a);
+	rest_rb = SEXP_list_rest_r(&rest_b, b);
+	eq = rest_ra != NULL && rest_rb != NULL && SEXP_deepcmp(rest_ra, rest_rb);
+	if (rest_ra != NULL)
+		SEXP_free_r(&rest_a);
+	if (rest_rb != NULL)
+		SEXP_free_r(&rest_b);
+
+	return eq;
+}
+
+/*
+ * Return the slot of the item or the empty slot where it belongs
+ */
+static uint32_t *itemset_slot(const probe_itemset_t *set, const SEXP_t *item, uint64_t hash)
+{
+	size_t mask = set->slot_cnt - 1;
+	size_t i = hash & mask;
+
+	for (;;) {
+		uint32_t *slot = &set->slot[i];
+		if (*slot == 0)
+			return slot;
+
+		const probe_itemset_ent_t *ent = &set->ent[*slot - 1];
+		if (ent->hash == hash && itemset_item_eq(ent->item, item))
+			return slot;
+
+		i = (i + 1) & mask;
+	}
+}
+
+static void itemset_grow(probe_itemset_t *set)
+{
+	free(set->slot);
+	set->slot_cnt *= 2;
+	set->slot = calloc(set->slot_cnt, sizeof(uint32_t));
+
+	size_t mask = set->slot_cnt - 1;
+	for (size_t e = 0; e < set->count; ++e) {
+		size_t i = set->ent[e].hash & mask;
+
+		while (set->slot[i] != 0)
+			i = (i + 1) & mask;
+		set->slot[i] = e + 1;
+	}
+}
+
+probe_itemset_ent_t *probe_itemset_add(probe_itemset_t *set, SEXP_t *item, uint64_t hash, bool *added)
+{
+	uint32_t *slot = itemset_slot(set, item, hash);
+
+	if (*slot != 0) {
+		*added = false;
+		return &set->ent[*slot - 1];
+	}
+
+	if (set->count == set->alloc) {
+		set->alloc *= 2;
+		set->ent = realloc(set->ent, set->alloc * sizeof(probe_itemset_ent_t));
+	}
+
+	probe_itemset_ent_t *ent = &set->ent[set->count++];
+	ent->item = SEXP_ref(item);
+	ent->hash = hash;
+	ent->filtered = -1;
+	*slot = set->count;
+
+	if (2 * set->count > set->slot_cnt)
+		itemset_grow(set);
+
+	*added = true;
+	return ent;
+}
+
+probe_itemset_ent_t *probe_itemset_find(const probe_itemset_t *set, const SEXP_t *item, uint64_t hash)
+{
+	uint32_t *slot = itemset_slot(set, item, hash);
+
+	return *slot != 0 ? &set->ent[*slot - 1] : NULL;
+}
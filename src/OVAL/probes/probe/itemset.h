@@ -0,0 +1,70 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#ifndef ITEMSET_H
+#define ITEMSET_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <sexp.h>
+
+/*
+ * Set of collected items used by the set operations. Two items are the same
+ * element of the set if they differ in their IDs and attributes only, which
+ * is how the item cache tells the items apart too, so the set operations
+ * don't depend on the items being shared by the item cache. Every item is
+ * hashed once, when it is added, and the set keeps the insertion order.
+ */
+
+typedef struct {
+	SEXP_t   *item;
+	uint64_t  hash;
+	int8_t    filtered; /* -1 until the filters are evaluated, then 0 or 1 */
+} probe_itemset_ent_t;
+
+typedef struct {
+	probe_itemset_ent_t *ent; /* in the insertion order */
+	size_t    count;
+	size_t    alloc;
+	uint32_t *slot;           /* index into ent + 1, 0 for an empty slot */
+	size_t    slot_cnt;       /* a power of 2 */
+} probe_itemset_t;
+
+probe_itemset_t *probe_itemset_new(size_t hint);
+void probe_itemset_free(probe_itemset_t *set);
+
+/*
+ * Hash of the content of the item, i.e. of the item without its name list
+ */
+uint64_t probe_itemset_hash(const SEXP_t *item);
+
+/*
+ * Add a reference to the item unless an equal item is already in the set.
+ * @param added set to true if the item was added
+ * @return the entry of the item or of the equal item, valid until the next
+ *         item is added
+ */
+probe_itemset_ent_t *probe_itemset_add(probe_itemset_t *set, SEXP_t *item, uint64_t hash, bool *added);
+
+/*
+ * @return the entry of an item equal to the given one or NULL
+ */
+probe_itemset_ent_t *probe_itemset_find(const probe_itemset_t *set, const SEXP_t *item, uint64_t hash);
+
+#endif /* ITEMSET_H */
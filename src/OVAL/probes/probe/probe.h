@@ -52,6 +52,8 @@
  */
 #define OSCAP_PROBE_COLLECT_UNLIMITED 0
 
+typedef struct probe_worker_pool probe_worker_pool_t;
+
 typedef struct {
 	pthread_rwlock_t rwlock;
 	uint32_t         flags;
@@ -68,6 +70,7 @@ typedef struct {
 	pthread_t th_signal;
 
         rbt_t    *workers;
+        probe_worker_pool_t *pool;
         uint32_t  max_threads;
         uint32_t  max_chdepth;
 
@@ -143,6 +143,8 @@ static void probe_common_main_cleanup(void *arg)
 	dD("probe_common_main_cleanup started");
 
 	probe_t *probe = (probe_t *)arg;
+	/* The input thread can be waiting for a place in the worker queue */
+	probe_worker_pool_shutdown(probe->pool);
 	/* Cancel probe_input_handler thread */
 	if (pthread_cancel(probe->th_input) != 0) {
 		dE("Cannot cancel the probe input thread.");
@@ -156,6 +158,14 @@ static void probe_common_main_cleanup(void *arg)
 	}
 	dD("probe_input_handler thread has joined with status %ld", (long) status);
 
+	/*
+	 * Nobody receives the replies to the commands sent by the workers
+	 * (e.g. object evaluation for sets) anymore, don't let them wait.
+	 */
+	SEAP_cmd_cancel_sync(probe->SEAP_ctx, probe->sd);
+	/* The workers use probe_arg, wait for them before it's released */
+	probe_worker_pool_free(probe->pool);
+
 	probe_fini_function_t fini_function = probe_table_get_fini_function(probe->subtype);
 	if (fini_function != NULL) {
 		fini_function(probe->probe_arg);
@@ -243,6 +253,12 @@ void *probe_common_main(void *arg)
 	 * Create input handler (detached)
 	 */
         probe.workers   = rbt_i32_new();
+        probe.max_threads = PROBE_WORKER_DEFAULT_MAX_THREADS;
+        probe.max_chdepth = PROBE_WORKER_DEFAULT_MAX_CHDEPTH;
+        probe.pool      = probe_worker_pool_new(&probe, probe.max_threads);
+
+        if (probe.pool == NULL)
+                fail(ENOMEM, "probe_worker_pool_new", __LINE__ - 3);
 
 	probe_init_function_t init_function = probe_table_get_init_function(probe.subtype);
 	if (init_function != NULL) {
@@ -45,8 +45,11 @@ extern int chroot(const char *);
 #endif
 
 #include "probe-api.h"
+#include "_probe-api.h"
 #include "common/debug_priv.h"
+#include "oscap_error.h"
 #include "entcmp.h"
+#include "itemset.h"
 
 #include "worker.h"
 #include "probe-table.h"
@@ -72,58 +75,48 @@ static void preload_libraries_before_chroot()
 	pthread_join(t, NULL);
 }
 
-void *probe_worker_runfn(void *arg)
+/*
+ * Evaluate the object in the message, cache the result and send it to
+ * the requestee. The worker and its message are freed.
+ */
+static void probe_worker_handle(probe_t *probe, probe_worker_t *pth)
 {
-	dD("probe_worker_runfn has started");
-	probe_pwpair_t *pair = (probe_pwpair_t *)arg;
-
 	SEXP_t *probe_res, *obj, *oid;
 	int     probe_ret;
+	void   *registered;
 
-#if defined(HAVE_PTHREAD_SETNAME_NP)
-# if defined(OS_APPLE)
-	pthread_setname_np("probe_worker");
-# else
-	pthread_setname_np(pthread_self(), "probe_worker");
-# endif
-#endif
-	dD("handling SEAP message ID %u", pair->pth->sid);
+	dD("handling SEAP message ID %u", pth->sid);
+
+	if (rbt_i32_get(probe->workers, pth->sid, &registered) != 0) {
+		dW("message not found in the probe thread tree, probably canceled before it was handled");
+		SEAP_msg_free(pth->msg);
+		free(pth);
+		return;
+	}
 	//
 	probe_ret = -1;
-	probe_res = pair->pth->msg_handler(pair->probe, pair->pth->msg, &probe_ret);
+	probe_res = pth->msg_handler(probe, pth->msg, &probe_ret);
 	//
 	dD("handler result = %p, return code = %d", probe_res, probe_ret);
 
 	/* Assuming that the red-black tree API is doing locking for us... */
-	if (rbt_i32_del(pair->probe->workers, pair->pth->sid, NULL) != 0) {
+	if (rbt_i32_del(probe->workers, pth->sid, NULL) != 0) {
 		dW("thread not found in the probe thread tree, probably canceled by an external signal");
 		/*
 		 * XXX: this is a possible deadlock; we can't send anything from
 		 * here because the signal handler replied to the message
 		 */
-		arg = NULL;
-
-                SEAP_msg_free(pair->pth->msg);
+                SEAP_msg_free(pth->msg);
                 SEXP_free(probe_res);
-                free(pair);
-
-		dD("probe_worker_runfn has finished");
-                return (NULL);
+                free(pth);
+                return;
 	} else {
-                SEXP_t *items;
-
 		dD("probe thread deleted");
 
-		obj = SEAP_msg_get(pair->pth->msg);
+		obj = SEAP_msg_get(pth->msg);
 		oid = probe_obj_getattrval(obj, "id");
-                items = probe_cobj_get_items(probe_res);
-
-                if (items != NULL) {
-                        SEXP_list_sort(items, SEXP_refcmp);
-                        SEXP_free(items);
-                }
 
-		if (probe_rcache_sexp_add(pair->probe->rcache, oid, probe_res) != 0) {
+		if (probe_rcache_sexp_add(probe->rcache, oid, probe_res) != 0) {
 			/* TODO */
 			abort();
 		}
@@ -136,7 +129,7 @@ void *probe_worker_runfn(void *arg)
 		 * Something bad happened. A hint of the cause is stored as a error code in
 		 * probe_ret (should be). We'll send it to the library using a SEAP error packet.
 		 */
-		if (SEAP_replyerr(pair->probe->SEAP_ctx, pair->probe->sd, pair->pth->msg, probe_ret) == -1) {
+		if (SEAP_replyerr(probe->SEAP_ctx, probe->sd, pth->msg, probe_ret) == -1) {
 			int ret = errno;
 
 			dE("An error ocured while sending error status. errno=%u, %s.", errno, strerror(errno));
@@ -154,7 +147,7 @@ void *probe_worker_runfn(void *arg)
 		seap_reply = SEAP_msg_new();
 		SEAP_msg_set(seap_reply, probe_res);
 
-		if (SEAP_reply(pair->probe->SEAP_ctx, pair->probe->sd, seap_reply, pair->pth->msg) == -1) {
+		if (SEAP_reply(probe->SEAP_ctx, probe->sd, seap_reply, pth->msg) == -1) {
 			int ret = errno;
 
 			SEAP_msg_free(seap_reply);
@@ -167,15 +160,158 @@ void *probe_worker_runfn(void *arg)
                 SEXP_free(probe_res);
 	}
 
-        SEAP_msg_free(pair->pth->msg);
-        free(pair->pth);
-	free(pair);
-	pthread_detach(pthread_self());
+        SEAP_msg_free(pth->msg);
+        free(pth);
+}
+
+static void *probe_worker_runfn(void *arg)
+{
+	probe_worker_pool_t *pool = (probe_worker_pool_t *)arg;
+	probe_worker_t *pth;
+
+	dD("probe_worker_runfn has started");
+#if defined(HAVE_PTHREAD_SETNAME_NP)
+# if defined(OS_APPLE)
+	pthread_setname_np("probe_worker");
+# else
+	pthread_setname_np(pthread_self(), "probe_worker");
+# endif
+#endif
+	pthread_mutex_lock(&pool->queue_mutex);
+
+	for (;;) {
+		while (pool->queue_cnt == 0 && !pool->shutdown) {
+			++pool->thread_idle;
+			pthread_cond_wait(&pool->queue_notempty, &pool->queue_mutex);
+			--pool->thread_idle;
+		}
+		if (pool->shutdown)
+			break;
+
+		pth = pool->queue[pool->queue_beg];
+		pool->queue_beg = (pool->queue_beg + 1) % PROBE_WORKER_QUEUE_CAPACITY;
+		--pool->queue_cnt;
+		pthread_cond_signal(&pool->queue_notfull);
+		pthread_mutex_unlock(&pool->queue_mutex);
+
+		probe_worker_handle(pool->probe, pth);
+		/* Errors of one object must not show up with the next one */
+		oscap_clearerr();
 
+		pthread_mutex_lock(&pool->queue_mutex);
+	}
+
+	pthread_mutex_unlock(&pool->queue_mutex);
 	dD("probe_worker_runfn has finished");
 	return (NULL);
 }
 
+probe_worker_pool_t *probe_worker_pool_new(probe_t *probe, uint32_t max_threads)
+{
+	probe_worker_pool_t *pool = malloc(sizeof(probe_worker_pool_t));
+
+	if (pool == NULL)
+		return (NULL);
+
+	pool->probe = probe;
+	pool->queue_beg = 0;
+	pool->queue_end = 0;
+	pool->queue_cnt = 0;
+	pool->thread_cnt = 0;
+	pool->thread_max = max_threads > 0 ? max_threads : 1;
+	pool->thread_idle = 0;
+	pool->shutdown = false;
+	pool->threads = malloc(sizeof(pthread_t) * pool->thread_max);
+
+	if (pool->threads == NULL) {
+		free(pool);
+		return (NULL);
+	}
+
+	pthread_mutex_init(&pool->queue_mutex, NULL);
+	pthread_cond_init(&pool->queue_notempty, NULL);
+	pthread_cond_init(&pool->queue_notfull, NULL);
+
+	return (pool);
+}
+
+int probe_worker_pool_add(probe_worker_pool_t *pool, probe_worker_t *pth)
+{
+	pthread_mutex_lock(&pool->queue_mutex);
+
+	while (pool->queue_cnt == PROBE_WORKER_QUEUE_CAPACITY && !pool->shutdown)
+		pthread_cond_wait(&pool->queue_notfull, &pool->queue_mutex);
+
+	if (pool->shutdown) {
+		pthread_mutex_unlock(&pool->queue_mutex);
+		return (-1);
+	}
+
+	/*
+	 * Start another thread only if the idle ones can't take all
+	 * the waiting messages.
+	 */
+	if (pool->thread_idle <= pool->queue_cnt && pool->thread_cnt < pool->thread_max) {
+		if ((errno = pthread_create(&pool->threads[pool->thread_cnt], NULL, &probe_worker_runfn, pool)) != 0) {
+			dE("Cannot start a new worker thread: %d, %s.", errno, strerror(errno));
+
+			if (pool->thread_cnt == 0) {
+				pthread_mutex_unlock(&pool->queue_mutex);
+				return (-1);
+			}
+		} else {
+			++pool->thread_cnt;
+		}
+	}
+
+	pool->queue[pool->queue_end] = pth;
+	pool->queue_end = (pool->queue_end + 1) % PROBE_WORKER_QUEUE_CAPACITY;
+	++pool->queue_cnt;
+
+	pthread_cond_signal(&pool->queue_notempty);
+	pthread_mutex_unlock(&pool->queue_mutex);
+
+	return (0);
+}
+
+void probe_worker_pool_shutdown(probe_worker_pool_t *pool)
+{
+	pthread_mutex_lock(&pool->queue_mutex);
+	pool->shutdown = true;
+	pthread_cond_broadcast(&pool->queue_notempty);
+	pthread_cond_broadcast(&pool->queue_notfull);
+	pthread_mutex_unlock(&pool->queue_mutex);
+}
+
+void probe_worker_pool_free(probe_worker_pool_t *pool)
+{
+	probe_worker_t *pth;
+
+	if (pool == NULL)
+		return;
+
+	probe_worker_pool_shutdown(pool);
+
+	for (uint32_t i = 0; i < pool->thread_cnt; ++i)
+		pthread_join(pool->threads[i], NULL);
+
+	while (pool->queue_cnt > 0) {
+		pth = pool->queue[pool->queue_beg];
+		pool->queue_beg = (pool->queue_beg + 1) % PROBE_WORKER_QUEUE_CAPACITY;
+		--pool->queue_cnt;
+
+		rbt_i32_del(pool->probe->workers, pth->sid, NULL);
+		SEAP_msg_free(pth->msg);
+		free(pth);
+	}
+
+	pthread_mutex_destroy(&pool->queue_mutex);
+	pthread_cond_destroy(&pool->queue_notempty);
+	pthread_cond_destroy(&pool->queue_notfull);
+	free(pool->threads);
+	free(pool);
+}
+
 probe_worker_t *probe_worker_new(void)
 {
 	probe_worker_t *pth = malloc(sizeof(probe_worker_t));
@@ -483,118 +619,198 @@ static SEXP_t *probe_prepare_filters(probe_t *probe, SEXP_t *obj)
 	return filters;
 }
 
+/*
+ * An operand of a set operation: the distinct items of a collected object.
+ * The items of an object referenced by a set are filtered by the filters of
+ * the set. The filters are evaluated on demand, at most once per distinct
+ * item, and only for the items which can change the result.
+ */
+struct probe_set_operand {
+	probe_itemset_t *items;
+	oval_syschar_collection_flag_t flag;
+	bool kept; /* an item which passes the filters was found */
+};
+
+/*
+ * Load the items of a collected object. With filtering, the items which don't
+ * exist are left out and an item with an invalid status makes the whole
+ * operation fail, an error object is returned in *err_cobj then.
+ */
+static int probe_set_operand_load(struct probe_set_operand *opd, SEXP_t *cobj, bool filtering, SEXP_t **err_cobj)
+{
+	SEXP_t *items, *item;
+	SEXP_list_it *sit;
+	bool added;
+
+	items = probe_cobj_get_items(cobj);
+	opd->items = probe_itemset_new(SEXP_list_length(items));
+	opd->flag = probe_cobj_get_flag(cobj);
+	opd->kept = false;
+
+	sit = SEXP_list_it_new(items);
+	while ((item = SEXP_list_it_next(sit)) != NULL) {
+		if (filtering) {
+			oval_syschar_status_t item_status = probe_ent_getstatus(item);
+
+			if (item_status == SYSCHAR_STATUS_DOES_NOT_EXIST)
+				continue;
+			if (item_status == SYSCHAR_STATUS_NOT_COLLECTED) {
+				SEXP_t *r0, *r1;
+
+				r0 = probe_msg_creatf(OVAL_MESSAGE_LEVEL_ERROR,
+						      "Supplied item has an invalid status: %d.", item_status);
+				r1 = SEXP_list_new(r0, NULL);
+				*err_cobj = probe_cobj_new(SYSCHAR_FLAG_ERROR, r1, NULL, NULL);
+				SEXP_free(r0);
+				SEXP_free(r1);
+				SEXP_list_it_free(sit);
+				SEXP_free(items);
+				return -1;
+			}
+		}
+		probe_itemset_add(opd->items, item, probe_itemset_hash(item), &added);
+	}
+	SEXP_list_it_free(sit);
+	SEXP_free(items);
+
+	return 0;
+}
+
+static bool probe_set_ent_kept(struct probe_set_operand *opd, probe_itemset_ent_t *ent, SEXP_t *filters)
+{
+	if (ent->filtered < 0)
+		ent->filtered = filters != NULL && probe_item_filtered(ent->item, filters);
+	if (!ent->filtered)
+		opd->kept = true;
+	return !ent->filtered;
+}
+
+/*
+ * The flag of a filtered operand: if the collected information is complete
+ * but all the items are filtered out, it is SYSCHAR_FLAG_DOES_NOT_EXIST.
+ * The filters are evaluated only until an item which passes them is found.
+ */
+static oval_syschar_collection_flag_t probe_set_operand_flag(struct probe_set_operand *opd, bool filtering, SEXP_t *filters)
+{
+	if (!filtering || opd->flag != SYSCHAR_FLAG_COMPLETE)
+		return opd->flag;
+
+	for (size_t i = 0; i < opd->items->count && !opd->kept; ++i)
+		probe_set_ent_kept(opd, &opd->items->ent[i], filters);
+
+	return opd->kept ? SYSCHAR_FLAG_COMPLETE : SYSCHAR_FLAG_DOES_NOT_EXIST;
+}
+
 /**
- * Combine two collections of items using an operation.
- * @param cobj1 item collection
- * @param cobj2 item collection
+ * Combine two collections of items using an operation. The items are matched
+ * by their content, see itemset.h.
+ * @param cobj0 item collection
+ * @param cobj1 item collection or NULL if the set has one operand only
  * @param op operation
+ * @param filters filters of a set of object references, NULL for a set of sets
  * @return the result of the operation
  */
-static SEXP_t *probe_set_combine(SEXP_t *cobj0, SEXP_t *cobj1, oval_setobject_operation_t op)
+static SEXP_t *probe_set_combine(SEXP_t *cobj0, SEXP_t *cobj1, oval_setobject_operation_t op, SEXP_t *filters)
 {
-        SEXP_t *set0, *set1, *res_cobj, *cobj0_mask, *cobj1_mask, *res_mask;
-        register int cmp;
-        register SEXP_t *item0, *item1, *res;
-        register SEXP_list_it *sit0, *sit1;
+	SEXP_t *res, *res_cobj, *res_mask, *err_cobj = NULL;
+	struct probe_set_operand opd0, opd1;
 	oval_syschar_collection_flag_t res_flag;
+	bool filtering = filters != NULL;
+	size_t i;
+
+	if (cobj0 == NULL || cobj1 == NULL) {
+		if (!filtering)
+			return SEXP_ref(cobj0 == NULL ? cobj1 : cobj0);
+		if (cobj0 == NULL)
+			cobj0 = cobj1;
+		cobj1 = NULL;
+	}
 
-	if (cobj0 == NULL)
-		return SEXP_ref(cobj1);
-	if (cobj1 == NULL)
-		return SEXP_ref(cobj0);
-
-        set0 = probe_cobj_get_items(cobj0);
-        set1 = probe_cobj_get_items(cobj1);
-        cobj0_mask = probe_cobj_get_mask(cobj0);
-        cobj1_mask = probe_cobj_get_mask(cobj1);
-
-        /* prepare storage for results */
-        res = SEXP_list_new(NULL);
-        res_flag = probe_cobj_combine_flags(probe_cobj_get_flag(cobj0),
-                                            probe_cobj_get_flag(cobj1), op);
-        res_mask = SEXP_list_join(cobj0_mask, cobj1_mask);
-
-        /* prepare iterators & first items */
-        sit0  = SEXP_list_it_new(set0);
-        sit1  = SEXP_list_it_new(set1);
-        item0 = SEXP_list_it_next(sit0);
-        item1 = SEXP_list_it_next(sit1);
-
-        /* perform the set operation */
-        switch(op) {
-        case OVAL_SET_OPERATION_UNION:
-                while (item0 != NULL && item1 != NULL) {
-                        cmp = SEXP_refcmp(item0, item1);
-
-                        if (cmp < 0) {
-                                SEXP_list_add(res, item0);
-                                item0 = SEXP_list_it_next(sit0);
-                        } else if (cmp > 0) {
-                                SEXP_list_add(res, item1);
-                                item1 = SEXP_list_it_next(sit1);
-                        } else {
-                                SEXP_list_add(res, item0);
-                                item0 = SEXP_list_it_next(sit0);
-                                item1 = SEXP_list_it_next(sit1);
-                        }
-                }
+	if (filters != NULL && SEXP_list_length(filters) == 0)
+		filters = NULL;
 
-                if (item0 != NULL) {
-                        do {
-                                SEXP_list_add(res, item0);
-                        } while((item0 = SEXP_list_it_next(sit0)) != NULL);
-                } else if (item1 != NULL) {
-                        do {
-                                SEXP_list_add(res, item1);
-                        } while((item1 = SEXP_list_it_next(sit1)) != NULL);
-                }
+	opd1.items = NULL;
+	if (probe_set_operand_load(&opd0, cobj0, filtering, &err_cobj) != 0)
+		goto fail;
+	if (cobj1 != NULL && probe_set_operand_load(&opd1, cobj1, filtering, &err_cobj) != 0)
+		goto fail;
 
-                break;
-        case OVAL_SET_OPERATION_INTERSECTION:
-                while (item0 != NULL && item1 != NULL) {
-                        cmp = SEXP_refcmp(item0, item1);
-
-                        if (cmp < 0)
-                                item0 = SEXP_list_it_next(sit0);
-                        else if (cmp > 0)
-                                item1 = SEXP_list_it_next(sit1);
-                        else {
-                                SEXP_list_add(res, item0);
-                                item0 = SEXP_list_it_next(sit0);
-                                item1 = SEXP_list_it_next(sit1);
-                        }
-                }
+	res = SEXP_list_new(NULL);
 
-                break;
-        case OVAL_SET_OPERATION_COMPLEMENT:
-                while (item0 != NULL && item1 != NULL) {
-                        cmp = SEXP_refcmp(item0, item1);
-
-                        if (cmp < 0) {
-                                SEXP_list_add(res, item0);
-                                item0 = SEXP_list_it_next(sit0);
-                        } else if (cmp > 0) {
-                                item1 = SEXP_list_it_next(sit1);
-                        } else {
-                                item0 = SEXP_list_it_next(sit0);
-                                item1 = SEXP_list_it_next(sit1);
-                        }
-                }
+	if (cobj1 == NULL) {
+		/* an object and its filters */
+		for (i = 0; i < opd0.items->count; ++i) {
+			probe_itemset_ent_t *ent0 = &opd0.items->ent[i];
 
-                if (item0 != NULL) {
-                        do {
-                                SEXP_list_add(res, item0);
-                        } while((item0 = SEXP_list_it_next(sit0)) != NULL);
-                }
+			if (probe_set_ent_kept(&opd0, ent0, filters))
+				SEXP_list_add(res, ent0->item);
+		}
+		res_flag = probe_set_operand_flag(&opd0, filtering, filters);
+		res_mask = probe_cobj_get_mask(cobj0);
+	} else {
+		SEXP_t *cobj0_mask, *cobj1_mask;
 
-                break;
-        default:
-                dE("Unknown set operation: %d", op);
-                abort();
-        }
+		/*
+		 * Equal items have equal content, so an item passes the filters
+		 * in both operands or in none of them.
+		 */
+		switch (op) {
+		case OVAL_SET_OPERATION_UNION:
+			for (i = 0; i < opd0.items->count; ++i) {
+				probe_itemset_ent_t *ent0 = &opd0.items->ent[i];
+
+				if (probe_set_ent_kept(&opd0, ent0, filters))
+					SEXP_list_add(res, ent0->item);
+			}
+			for (i = 0; i < opd1.items->count; ++i) {
+				probe_itemset_ent_t *ent1 = &opd1.items->ent[i];
+				probe_itemset_ent_t *ent0 = probe_itemset_find(opd0.items, ent1->item, ent1->hash);
+
+				if (ent0 != NULL) {
+					ent1->filtered = ent0->filtered;
+					if (!ent1->filtered)
+						opd1.kept = true;
+				} else if (probe_set_ent_kept(&opd1, ent1, filters)) {
+					SEXP_list_add(res, ent1->item);
+				}
+			}
+			break;
+		case OVAL_SET_OPERATION_INTERSECTION:
+			for (i = 0; i < opd0.items->count; ++i) {
+				probe_itemset_ent_t *ent0 = &opd0.items->ent[i];
+				probe_itemset_ent_t *ent1 = probe_itemset_find(opd1.items, ent0->item, ent0->hash);
+
+				if (ent1 == NULL)
+					continue;
+				if (probe_set_ent_kept(&opd0, ent0, filters))
+					SEXP_list_add(res, ent0->item);
+				ent1->filtered = ent0->filtered;
+				if (!ent1->filtered)
+					opd1.kept = true;
+			}
+			break;
+		case OVAL_SET_OPERATION_COMPLEMENT:
+			for (i = 0; i < opd0.items->count; ++i) {
+				probe_itemset_ent_t *ent0 = &opd0.items->ent[i];
+
+				if (probe_set_ent_kept(&opd0, ent0, filters)
+				    && probe_itemset_find(opd1.items, ent0->item, ent0->hash) == NULL)
+					SEXP_list_add(res, ent0->item);
+			}
+			break;
+		default:
+			dE("Unknown set operation: %d", op);
+			abort();
+		}
 
-        SEXP_list_it_free(sit0);
-        SEXP_list_it_free(sit1);
+		res_flag = probe_cobj_combine_flags(probe_set_operand_flag(&opd0, filtering, filters),
+						    probe_set_operand_flag(&opd1, filtering, filters), op);
+		cobj0_mask = probe_cobj_get_mask(cobj0);
+		cobj1_mask = probe_cobj_get_mask(cobj1);
+		res_mask = SEXP_list_join(cobj0_mask, cobj1_mask);
+		SEXP_free(cobj0_mask);
+		SEXP_free(cobj1_mask);
+	}
 
 	/*
 	 * If the collected information is complete but all the items are
@@ -605,82 +821,95 @@ static SEXP_t *probe_set_combine(SEXP_t *cobj0, SEXP_t *cobj1, oval_setobject_op
 
 	res_cobj = probe_cobj_new(res_flag, NULL, res, res_mask);
 
-	SEXP_free(set0);
-	SEXP_free(set1);
 	SEXP_free(res);
 	SEXP_free(res_mask);
-	SEXP_free(cobj0_mask);
-	SEXP_free(cobj1_mask);
-
-	// todo: variables
+	probe_itemset_free(opd0.items);
+	probe_itemset_free(opd1.items);
 
 	return (res_cobj);
+ fail:
+	probe_itemset_free(opd0.items);
+	probe_itemset_free(opd1.items);
+	return (err_cobj);
 }
 
-/**
- * Apply a set of filters to a collected object.
- * @param cobj item collection
- * @param filter set (list) of filters
- * @return collection of items without items that match any of the filters in the input set
+/*
+ * Union of the collected objects of all the combinations of the variable
+ * values of an object. The items are added to one set, so that every item
+ * is hashed once however many combinations there are.
  */
-static SEXP_t *probe_set_apply_filters(SEXP_t *cobj, SEXP_t *filters)
-{
-	SEXP_t *result_items, *items, *item, *mask;
-	oval_syschar_status_t item_status;
+struct probe_set_union {
+	SEXP_t *first; /* the only object as long as there is one */
+	SEXP_t *tokens_cobj;
+	probe_itemset_t *items;
 	oval_syschar_collection_flag_t flag;
+};
 
-	result_items = SEXP_list_new(NULL);
-	flag = probe_cobj_get_flag(cobj);
-	items = probe_cobj_get_items(cobj);
-        mask = probe_cobj_get_mask(cobj);
+static void probe_set_union_init(struct probe_set_union *u)
+{
+	u->first = NULL;
+	u->tokens_cobj = NULL;
+	u->items = NULL;
+	u->flag = SYSCHAR_FLAG_UNKNOWN;
+}
 
-	SEXP_list_foreach(item, items) {
-		item_status = probe_ent_getstatus(item);
+static void probe_set_union_add_items(struct probe_set_union *u, SEXP_t *cobj)
+{
+	SEXP_t *items, *item;
+	SEXP_list_it *sit;
+	bool added;
 
-		switch (item_status) {
-		case SYSCHAR_STATUS_DOES_NOT_EXIST:
-			continue;
-		case SYSCHAR_STATUS_ERROR:
-			break;
-		case SYSCHAR_STATUS_NOT_COLLECTED:
-			{
-				SEXP_t *r0, *r1;
+	items = probe_cobj_get_items(cobj);
+	sit = SEXP_list_it_new(items);
+	while ((item = SEXP_list_it_next(sit)) != NULL)
+		probe_itemset_add(u->items, item, probe_itemset_hash(item), &added);
+	SEXP_list_it_free(sit);
+	SEXP_free(items);
 
-                                r0 = probe_msg_creatf(OVAL_MESSAGE_LEVEL_ERROR,
-                                                      "Supplied item has an invalid status: %d.", item_status);
-				r1 = SEXP_list_new(r0, NULL);
-				cobj = probe_cobj_new(SYSCHAR_FLAG_ERROR, r1, NULL, NULL);
-				SEXP_free(items);
-				SEXP_free(item);
-				SEXP_free(result_items);
-				SEXP_free(r0);
-				SEXP_free(r1);
-				SEXP_free(mask);
-				return cobj;
-			}
-		default:
-			break;
-		}
+	/* the union doesn't carry the tokens over */
+	probe_cobj_move_tokens(u->tokens_cobj, cobj);
+}
 
-		if (!probe_item_filtered(item, filters)) {
-			SEXP_list_add(result_items, item);
-		}
+static void probe_set_union_add(struct probe_set_union *u, SEXP_t *cobj)
+{
+	if (u->first == NULL && u->items == NULL) {
+		u->first = SEXP_ref(cobj);
+		u->flag = probe_cobj_get_flag(cobj);
+		return;
+	}
+	if (u->items == NULL) {
+		u->items = probe_itemset_new(0);
+		u->tokens_cobj = probe_cobj_new(SYSCHAR_FLAG_UNKNOWN, NULL, NULL, NULL);
+		probe_set_union_add_items(u, u->first);
+		SEXP_free(u->first);
+		u->first = NULL;
 	}
+	probe_set_union_add_items(u, cobj);
+	u->flag = probe_cobj_combine_flags(u->flag, probe_cobj_get_flag(cobj), OVAL_SET_OPERATION_UNION);
+}
 
-	/*
-	 * If the collected information is complete but all the items are
-	 * filtered out, the flag is set to SYSCHAR_FLAG_DOES_NOT_EXIST
-	 */
-	if (flag == SYSCHAR_FLAG_COMPLETE
-	    && SEXP_list_length(result_items) == 0)
-		flag = SYSCHAR_FLAG_DOES_NOT_EXIST;
+static SEXP_t *probe_set_union_finish(struct probe_set_union *u, SEXP_t *mask)
+{
+	SEXP_t *res, *res_cobj;
 
-	cobj = probe_cobj_new(flag, NULL, result_items, mask);
-	SEXP_free(items);
-	SEXP_free(result_items);
-	SEXP_free(mask);
+	if (u->items == NULL)
+		return u->first;
 
-	return cobj;
+	res = SEXP_list_new(NULL);
+	for (size_t i = 0; i < u->items->count; ++i)
+		SEXP_list_add(res, u->items->ent[i].item);
+
+	if (u->flag == SYSCHAR_FLAG_COMPLETE && SEXP_list_length(res) == 0)
+		u->flag = SYSCHAR_FLAG_DOES_NOT_EXIST;
+
+	res_cobj = probe_cobj_new(u->flag, NULL, res, mask);
+	probe_cobj_move_tokens(res_cobj, u->tokens_cobj);
+
+	SEXP_free(res);
+	SEXP_free(u->tokens_cobj);
+	probe_itemset_free(u->items);
+
+	return res_cobj;
 }
 
 /**
@@ -900,23 +1129,6 @@ static SEXP_t *probe_set_eval(probe_t *probe, SEXP_t *set, size_t depth)
 
 	_A((s_subset_i > 0 && o_subset_i == 0) || (s_subset_i == 0 && o_subset_i > 0));
 
-	if (o_subset_i > 0) {
-		for (s_subset_i = 0; s_subset_i < o_subset_i; ++s_subset_i) {
-			s_subset[s_subset_i] = probe_set_apply_filters(o_subset[s_subset_i], filters_a);
-
-#ifndef NDEBUG
-			if (s_subset[s_subset_i] == NULL) {
-                                Omsg = probe_msg_creatf(OVAL_MESSAGE_LEVEL_ERROR,
-							"%s: apply_filters returned NULL: set=%p, filters=%p.",
-							__FUNCTION__, o_subset[s_subset_i], filters_a);
-				goto eval_fail;
-			}
-#endif
-			SEXP_free(o_subset[s_subset_i]);
-                        o_subset[s_subset_i] = NULL;
-		}
-	}
-
 #ifndef NDEBUG
         {
                 unsigned int i;
@@ -939,13 +1151,18 @@ static SEXP_t *probe_set_eval(probe_t *probe, SEXP_t *set, size_t depth)
         dD("OP= %d", op_num);
 #endif
 
-	SEXP_free(filters_a);
-	result = probe_set_combine(s_subset[0], s_subset[1], op_num);
+	if (o_subset_i > 0)
+		result = probe_set_combine(o_subset[0], o_subset[1], op_num, filters_a);
+	else
+		result = probe_set_combine(s_subset[0], s_subset[1], op_num, NULL);
 
 	_A(result != NULL);
 
+	SEXP_free(filters_a);
 	SEXP_free(s_subset[0]);
 	SEXP_free(s_subset[1]);
+	SEXP_free(o_subset[0]);
+	SEXP_free(o_subset[1]);
 
         dD("=== RESULT ===");
         dO(OSCAP_DEBUGOBJ_SEXP, result);
@@ -1124,6 +1341,8 @@ SEXP_t *probe_worker(probe_t *probe, SEAP_msg_t *msg_in, int *ret)
                          */
 			probe_out = probe_cobj_new(SYSCHAR_FLAG_UNKNOWN, NULL, NULL, mask);
 			SEXP_free(mask);
+			if (probe_tokens_enabled())
+				probe_cobj_track_tokens(probe_out);
 			
                         pctx.probe_in  = probe_in;
                         pctx.probe_out = probe_out;
@@ -1155,6 +1374,7 @@ SEXP_t *probe_worker(probe_t *probe, SEAP_msg_t *msg_in, int *ret)
 			 * create ctx, iterate through all variable combinations
 			 */
 			struct probe_varref_ctx *ctx;
+			struct probe_set_union u;
 
 			dD("handling varrefs in object");
 
@@ -1169,13 +1389,16 @@ SEXP_t *probe_worker(probe_t *probe, SEAP_msg_t *msg_in, int *ret)
 			}
 
 			SEXP_free(varrefs);
+			probe_set_union_init(&u);
 
 			do {
-				SEXP_t *cobj, *r0;
+				SEXP_t *cobj;
                                 /*
                                  * Prepare the collected object
                                  */
 				cobj = probe_cobj_new(SYSCHAR_FLAG_UNKNOWN, NULL, NULL, mask);
+				if (probe_tokens_enabled())
+					probe_cobj_track_tokens(cobj);
 
                                 pctx.probe_in  = ctx->pi2;
                                 pctx.probe_out = cobj;
@@ -1191,13 +1414,12 @@ SEXP_t *probe_worker(probe_t *probe, SEAP_msg_t *msg_in, int *ret)
                                 probe_icache_nop(probe->icache);
 
 				probe_cobj_compute_flag(cobj);
-				r0 = probe_out;
-				probe_out = probe_set_combine(r0, cobj, OVAL_SET_OPERATION_UNION);
+				probe_set_union_add(&u, cobj);
 				SEXP_free(cobj);
-				SEXP_free(r0);
 			} while (*ret == 0
 				 && probe_varref_iterate_ctx(ctx));
 
+			probe_out = probe_set_union_finish(&u, mask);
 			SEXP_free(mask);
 			probe_varref_destroy_ctx(ctx);
 		}
@@ -35,6 +35,10 @@
 # define PROBE_WORKER_DEFAULT_MAX_CHDEPTH 8 /**< maximum depth of a worker thread chain */
 #endif
 
+#ifndef PROBE_WORKER_QUEUE_CAPACITY
+# define PROBE_WORKER_QUEUE_CAPACITY 256 /**< maximum number of messages waiting for a worker thread */
+#endif
+
 typedef struct {
 	SEAP_msgid_t sid; /**< SEAP message handled by this thread */
 	pthread_t    tid; /**< thread ID */
@@ -42,13 +46,49 @@ typedef struct {
 	SEAP_msg_t  *msg; /**< the message being handled */
 } probe_worker_t;
 
-typedef struct {
+/*
+ * Worker threads of a probe. The threads are started as needed, up to
+ * the given limit, and they stay around to handle further messages until
+ * the pool is freed. Messages which don't have a thread yet wait in
+ * a bounded queue.
+ */
+struct probe_worker_pool {
 	probe_t        *probe;
-	probe_worker_t *pth;
-} probe_pwpair_t;
+
+	pthread_mutex_t queue_mutex;
+	pthread_cond_t  queue_notempty;
+	pthread_cond_t  queue_notfull;
+
+	probe_worker_t *queue[PROBE_WORKER_QUEUE_CAPACITY];
+	uint32_t        queue_beg;
+	uint32_t        queue_end;
+	uint32_t        queue_cnt;
+
+	pthread_t      *threads;
+	uint32_t        thread_cnt;
+	uint32_t        thread_max;
+	uint32_t        thread_idle;
+	bool            shutdown;
+};
 
 probe_worker_t *probe_worker_new(void);
-void *probe_worker_runfn(void *arg);
 SEXP_t *probe_worker(probe_t *probe, SEAP_msg_t *msg_in, int *ret);
 
+probe_worker_pool_t *probe_worker_pool_new(probe_t *probe, uint32_t max_threads);
+/*
+ * Queue the message for a worker thread, waiting while the queue is full.
+ * The message has to be registered in probe->workers already, a message
+ * removed from there before a thread gets to it is dropped.
+ */
+int probe_worker_pool_add(probe_worker_pool_t *pool, probe_worker_t *pth);
+/*
+ * Stop accepting messages and wake up everybody waiting for the queue.
+ * The running workers finish their messages, the queued ones are dropped.
+ */
+void probe_worker_pool_shutdown(probe_worker_pool_t *pool);
+/*
+ * Shut the pool down, wait for the worker threads and free the pool.
+ */
+void probe_worker_pool_free(probe_worker_pool_t *pool);
+
 #endif /* WORKER_H */
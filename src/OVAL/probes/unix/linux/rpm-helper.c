@@ -24,6 +24,14 @@
 #include <config.h>
 #endif
 
+#include <limits.h>
+#include <regex.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "_probe-api.h"
+
 #ifdef RPM46_FOUND
 int rpmErrorCb (rpmlogRec rec, rpmlogCallbackData data)
 {
@@ -51,3 +59,459 @@ void rpmLibsPreload()
 	const char* rcfiles = "";
 	rpmReadConfigFiles(rcfiles, NULL);
 }
+
+/*
+ * Shared index of the rpm database
+ */
+
+struct rpm_index {
+	unsigned int refs;
+	struct rpm_pkg *pkgs;	/* sorted by name and offset */
+	struct rpm_pkg **by_offset;	/* the same packages sorted by offset only */
+	size_t count;
+	char *root;		/* root directory of the database */
+	SEXP_t *tokens;		/* state of the database files when read */
+};
+
+static const char *rpm_index_db_files[] = {
+	"", "rpmdb.sqlite", "rpmdb.sqlite-wal", "Packages", "Packages.db", NULL
+};
+
+static const char rpm_index_keyid_regex[] = "Key ID [a-fA-F0-9]{16}";
+
+static const char rpm_index_format[] =
+	"%{NAME}\n%{EPOCH}\n%{VERSION}\n%{RELEASE}\n%{ARCH}\n"
+	"%|SIGGPG?{%{SIGGPG:pgpsig}}:{%{SIGPGP:pgpsig}}|";
+
+static pthread_mutex_t rpm_index_mutex = PTHREAD_MUTEX_INITIALIZER;
+static unsigned int rpm_index_users = 0;
+static struct rpm_index *rpm_index_current = NULL;
+
+static void rpm_index_free(struct rpm_index *index)
+{
+	for (size_t i = 0; i < index->count; ++i)
+		free(index->pkgs[i].name);
+	free(index->pkgs);
+	free(index->by_offset);
+	free(index->root);
+	SEXP_free(index->tokens);
+	free(index);
+}
+
+static const char *rpm_index_root(rpmts ts)
+{
+	const char *root = rpmtsRootDir(ts);
+
+	return root != NULL ? root : "/";
+}
+
+static SEXP_t *rpm_index_tokens(rpmts ts)
+{
+	const char *root = rpm_index_root(ts);
+	char *dbpath = rpmExpand("%{?_dbpath}", NULL);
+	char path[PATH_MAX];
+	SEXP_t *tokens = SEXP_list_new(NULL);
+
+	if (strcmp(root, "/") == 0)
+		root = "";
+	for (int i = 0; rpm_index_db_files[i] != NULL; ++i) {
+		SEXP_t *token;
+
+		snprintf(path, sizeof(path), "%s%s/%s", root, dbpath, rpm_index_db_files[i]);
+		token = probe_token_new_path(path);
+		if (token == NULL) {
+			SEXP_free(tokens);
+			tokens = NULL;
+			break;
+		}
+		SEXP_list_add(tokens, token);
+		SEXP_free(token);
+	}
+	free(dbpath);
+	return tokens;
+}
+
+static bool rpm_index_valid(const struct rpm_index *index, rpmts ts)
+{
+	SEXP_t *token;
+	bool valid = true;
+
+	if (index->tokens == NULL || strcmp(index->root, rpm_index_root(ts)) != 0)
+		return false;
+	SEXP_list_foreach(token, index->tokens) {
+		if (!probe_token_valid(token)) {
+			valid = false;
+			SEXP_free(token);
+			break;
+		}
+	}
+	return valid;
+}
+
+/*
+ * Split the output of rpm_index_format and store all strings of the package
+ * in a single allocation starting at pkg->name
+ */
+static int rpm_index_pkg_fill(struct rpm_pkg *pkg, char *fmt, regex_t *keyid_regex)
+{
+	char *field[6], *keyid = "0", *epoch;
+	size_t keyid_len = 1, len;
+	regmatch_t keyid_match[1];
+	int i;
+
+	field[0] = fmt;
+	for (i = 1; i < 6; ++i) {
+		field[i] = strchr(field[i - 1], '\n');
+		if (field[i] == NULL)
+			return -1;
+		*field[i]++ = '\0';
+	}
+
+	if (regexec(keyid_regex, field[5], 1, keyid_match, 0) == 0
+	    && keyid_match[0].rm_so >= 0 && keyid_match[0].rm_eo >= 0) {
+		keyid = field[5] + keyid_match[0].rm_so + strlen("Key ID ");
+		keyid_len = field[5] + keyid_match[0].rm_eo - keyid;
+	} else {
+		dD("Failed to extract the Key ID value: regex=\"%s\", string=\"%s\"",
+		   rpm_index_keyid_regex, field[5]);
+	}
+	epoch = oscap_streq(field[1], "(none)") ? "0" : field[1];
+
+	/* name, epoch, version, release, arch, evr, keyid, extended_name */
+	len = strlen(field[0]) + strlen(field[1]) + strlen(field[2]) + strlen(field[3]) + strlen(field[4]) + 5
+	    + strlen(epoch) + strlen(field[2]) + strlen(field[3]) + 3
+	    + keyid_len + 1
+	    + strlen(field[0]) + strlen(epoch) + strlen(field[2]) + strlen(field[3]) + strlen(field[4]) + 5;
+	pkg->name = malloc(len);
+	if (pkg->name == NULL)
+		return -1;
+
+	pkg->epoch = stpcpy(pkg->name, field[0]) + 1;
+	pkg->version = stpcpy(pkg->epoch, field[1]) + 1;
+	pkg->release = stpcpy(pkg->version, field[2]) + 1;
+	pkg->arch = stpcpy(pkg->release, field[3]) + 1;
+	pkg->evr = stpcpy(pkg->arch, field[4]) + 1;
+	pkg->signature_keyid = pkg->evr + sprintf(pkg->evr, "%s:%s-%s", epoch, field[2], field[3]) + 1;
+	memcpy(pkg->signature_keyid, keyid, keyid_len);
+	pkg->signature_keyid[keyid_len] = '\0';
+	pkg->extended_name = pkg->signature_keyid + keyid_len + 1;
+	sprintf(pkg->extended_name, "%s-%s:%s-%s.%s", field[0], epoch, field[2], field[3], field[4]);
+	return 0;
+}
+
+static int rpm_index_pkg_cmp(const void *a, const void *b)
+{
+	const struct rpm_pkg *pa = a, *pb = b;
+	int ret = strcmp(pa->name, pb->name);
+
+	if (ret != 0)
+		return ret;
+	return (pa->offset > pb->offset) - (pa->offset < pb->offset);
+}
+
+static int rpm_index_offset_cmp(const void *a, const void *b)
+{
+	const struct rpm_pkg *pa = *(struct rpm_pkg * const *) a, *pb = *(struct rpm_pkg * const *) b;
+
+	return (pa->offset > pb->offset) - (pa->offset < pb->offset);
+}
+
+static struct rpm_index *rpm_index_read(rpmts ts)
+{
+	struct rpm_index *index;
+	rpmdbMatchIterator match;
+	regex_t keyid_regex;
+	size_t alloc = 0;
+	Header pkgh;
+
+	if (regcomp(&keyid_regex, rpm_index_keyid_regex, REG_EXTENDED) != 0) {
+		dE("regcomp(%s) failed.", rpm_index_keyid_regex);
+		return NULL;
+	}
+
+	index = calloc(1, sizeof(struct rpm_index));
+	index->refs = 1;
+	index->root = strdup(rpm_index_root(ts));
+	/* Taken first, a change made while reading invalidates the snapshot */
+	index->tokens = rpm_index_tokens(ts);
+
+	match = rpmtsInitIterator(ts, RPMDBI_PACKAGES, NULL, 0);
+	while (match != NULL && (pkgh = rpmdbNextIterator(match)) != NULL) {
+		struct rpm_pkg *pkg;
+		errmsg_t rpmerr = NULL;
+		char *fmt;
+
+		if (index->count == alloc) {
+			void *new_pkgs;
+
+			alloc = alloc == 0 ? 1024 : alloc * 2;
+			new_pkgs = realloc(index->pkgs, alloc * sizeof(struct rpm_pkg));
+			if (new_pkgs == NULL)
+				goto fail;
+			index->pkgs = new_pkgs;
+		}
+
+		pkg = index->pkgs + index->count;
+		pkg->offset = rpmdbGetIteratorOffset(match);
+		fmt = headerFormat(pkgh, rpm_index_format, &rpmerr);
+		if (fmt == NULL || rpm_index_pkg_fill(pkg, fmt, &keyid_regex) != 0) {
+			dE("Can't read the package header: %s", rpmerr != NULL ? rpmerr : "unknown error");
+			free(fmt);
+			goto fail;
+		}
+		free(fmt);
+		index->count++;
+	}
+	if (match != NULL)
+		rpmdbFreeIterator(match);
+	regfree(&keyid_regex);
+
+	qsort(index->pkgs, index->count, sizeof(struct rpm_pkg), rpm_index_pkg_cmp);
+	/* The headers found by other database iterators are looked up by their offsets */
+	index->by_offset = malloc((index->count > 0 ? index->count : 1) * sizeof(struct rpm_pkg *));
+	if (index->by_offset == NULL)
+		goto fail_sorted;
+	for (size_t i = 0; i < index->count; ++i)
+		index->by_offset[i] = index->pkgs + i;
+	qsort(index->by_offset, index->count, sizeof(struct rpm_pkg *), rpm_index_offset_cmp);
+	dI("Read %zu packages from the rpm database.", index->count);
+	return index;
+fail:
+	if (match != NULL)
+		rpmdbFreeIterator(match);
+	regfree(&keyid_regex);
+fail_sorted:
+	rpm_index_free(index);
+	return NULL;
+}
+
+void rpm_index_acquire(void)
+{
+	pthread_mutex_lock(&rpm_index_mutex);
+	rpm_index_users++;
+	pthread_mutex_unlock(&rpm_index_mutex);
+}
+
+void rpm_index_release(void)
+{
+	struct rpm_index *index = NULL;
+
+	pthread_mutex_lock(&rpm_index_mutex);
+	if (rpm_index_users > 0 && --rpm_index_users == 0) {
+		index = rpm_index_current;
+		rpm_index_current = NULL;
+	}
+	pthread_mutex_unlock(&rpm_index_mutex);
+	rpm_index_put(index);
+}
+
+struct rpm_index *rpm_index_get(rpmts ts)
+{
+	struct rpm_index *index, *stale = NULL;
+
+	pthread_mutex_lock(&rpm_index_mutex);
+	if (rpm_index_current != NULL && !rpm_index_valid(rpm_index_current, ts)) {
+		dD("The rpm database has changed, reading it again.");
+		stale = rpm_index_current;
+		rpm_index_current = NULL;
+	}
+	if (rpm_index_current == NULL)
+		rpm_index_current = rpm_index_read(ts);
+	index = rpm_index_current;
+	if (index != NULL)
+		index->refs++;
+	pthread_mutex_unlock(&rpm_index_mutex);
+
+	rpm_index_put(stale);
+	return index;
+}
+
+void rpm_index_put(struct rpm_index *index)
+{
+	bool last;
+
+	if (index == NULL)
+		return;
+	pthread_mutex_lock(&rpm_index_mutex);
+	last = --index->refs == 0;
+	pthread_mutex_unlock(&rpm_index_mutex);
+	if (last)
+		rpm_index_free(index);
+}
+
+int rpm_index_find(const struct rpm_index *index, const char *name, oval_operation_t op,
+		const struct rpm_pkg ***pkgs)
+{
+	size_t lo = 0, hi = index->count, i;
+	regex_t re;
+	int count = 0;
+
+	*pkgs = NULL;
+	switch (op) {
+	case OVAL_OPERATION_EQUALS:
+		/* lower bound of the name */
+		while (lo < hi) {
+			size_t mid = lo + (hi - lo) / 2;
+			if (strcmp(index->pkgs[mid].name, name) < 0)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		for (hi = lo; hi < index->count && strcmp(index->pkgs[hi].name, name) == 0; ++hi)
+			;
+		if (hi == lo)
+			return 0;
+		*pkgs = malloc((hi - lo) * sizeof(struct rpm_pkg *));
+		for (i = lo; i < hi; ++i)
+			(*pkgs)[count++] = index->pkgs + i;
+		break;
+	case OVAL_OPERATION_NOT_EQUAL:
+		if (index->count == 0)
+			return 0;
+		*pkgs = malloc(index->count * sizeof(struct rpm_pkg *));
+		for (i = 0; i < index->count; ++i)
+			(*pkgs)[count++] = index->pkgs + i;
+		break;
+	case OVAL_OPERATION_PATTERN_MATCH:
+		/* the same kind of regex as RPMMIRE_REGEX */
+		if (regcomp(&re, name, REG_EXTENDED | REG_NOSUB) != 0) {
+			dE("regcomp(%s) failed.", name);
+			return -1;
+		}
+		for (i = 0; i < index->count; ++i) {
+			if (regexec(&re, index->pkgs[i].name, 0, NULL, 0) != 0)
+				continue;
+			if (*pkgs == NULL)
+				*pkgs = malloc((index->count - i) * sizeof(struct rpm_pkg *));
+			(*pkgs)[count++] = index->pkgs + i;
+		}
+		regfree(&re);
+		break;
+	default:
+		return -1;
+	}
+
+	return count;
+}
+
+const struct rpm_pkg *rpm_index_find_offset(const struct rpm_index *index, unsigned int offset)
+{
+	struct rpm_pkg key = { .offset = offset }, *keyp = &key, **found;
+
+	found = bsearch(&keyp, index->by_offset, index->count, sizeof(struct rpm_pkg *), rpm_index_offset_cmp);
+	return found != NULL ? *found : NULL;
+}
+
+size_t rpm_index_packages(const struct rpm_index *index, const struct rpm_pkg **pkgs)
+{
+	*pkgs = index->pkgs;
+	return index->count;
+}
+
+#define RPM_INDEX_FILTER_MAX 8
+
+struct rpm_index_filter_rule {
+	rpmTag tag;
+	oval_operation_t op;
+	char *value;
+	regex_t re;
+};
+
+struct rpm_index_filter {
+	struct rpm_index_filter_rule rules[RPM_INDEX_FILTER_MAX];
+	int count;
+};
+
+struct rpm_index_filter *rpm_index_filter_new(void)
+{
+	return calloc(1, sizeof(struct rpm_index_filter));
+}
+
+int rpm_index_filter_add(struct rpm_index_filter *filter, rpmTag tag, oval_operation_t op, const char *value)
+{
+	struct rpm_index_filter_rule *rule;
+
+	if (op != OVAL_OPERATION_EQUALS && op != OVAL_OPERATION_PATTERN_MATCH)
+		return 0;
+	if (filter->count == RPM_INDEX_FILTER_MAX)
+		return -1;
+	switch (tag) {
+	case RPMTAG_NAME:
+	case RPMTAG_EPOCH:
+	case RPMTAG_VERSION:
+	case RPMTAG_RELEASE:
+	case RPMTAG_ARCH:
+		break;
+	default:
+		return -1;
+	}
+
+	rule = filter->rules + filter->count;
+	rule->tag = tag;
+	rule->op = op;
+	if (op == OVAL_OPERATION_PATTERN_MATCH) {
+		if (regcomp(&rule->re, value, REG_EXTENDED | REG_NOSUB) != 0) {
+			dE("regcomp(%s) failed.", value);
+			return -1;
+		}
+		rule->value = NULL;
+	} else {
+		rule->value = strdup(value);
+	}
+	filter->count++;
+	return 0;
+}
+
+bool rpm_index_filter_match(const struct rpm_index_filter *filter, const struct rpm_pkg *pkg)
+{
+	for (int i = 0; i < filter->count; ++i) {
+		const struct rpm_index_filter_rule *rule = filter->rules + i;
+		const char *field;
+
+		switch (rule->tag) {
+		case RPMTAG_NAME:
+			field = pkg->name;
+			break;
+		case RPMTAG_EPOCH:
+			field = oscap_streq(pkg->epoch, "(none)") ? "0" : pkg->epoch;
+			break;
+		case RPMTAG_VERSION:
+			field = pkg->version;
+			break;
+		case RPMTAG_RELEASE:
+			field = pkg->release;
+			break;
+		default:
+			field = pkg->arch;
+			break;
+		}
+
+		if (rule->op == OVAL_OPERATION_PATTERN_MATCH) {
+			if (regexec(&rule->re, field, 0, NULL, 0) != 0)
+				return false;
+		} else if (strcmp(field, rule->value) != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void rpm_index_filter_free(struct rpm_index_filter *filter)
+{
+	if (filter == NULL)
+		return;
+	for (int i = 0; i < filter->count; ++i) {
+		if (filter->rules[i].op == OVAL_OPERATION_PATTERN_MATCH)
+			regfree(&filter->rules[i].re);
+		else
+			free(filter->rules[i].value);
+	}
+	free(filter);
+}
+
+rpmdbMatchIterator rpm_index_pkg_iterator(rpmts ts, const struct rpm_pkg *pkg)
+{
+	unsigned int offset = pkg->offset;
+
+	return rpmtsInitIterator(ts, RPMDBI_PACKAGES, &offset, sizeof(offset));
+}
@@ -34,8 +34,10 @@
 #include <rpm/header.h>
 
 #include <pthread.h>
+#include <stdbool.h>
 #include "common/util.h"
 #include "common/debug_priv.h"
+#include "oval_definitions.h"
 #include "pthread.h"
 
 struct rpm_probe_global {
@@ -99,4 +101,92 @@ int rpmVerifyFile(const rpmts ts, const rpmfi fi,
  */
 void rpmLibsPreload(void);
 
+/**
+ * A package in the shared index of the rpm database. The strings are
+ * formatted the same way the probes report them.
+ */
+struct rpm_pkg {
+	unsigned int offset;	/**< header instance in the rpm database */
+	char *name;
+	char *epoch;		/**< "(none)" if the package has no epoch */
+	char *version;
+	char *release;
+	char *arch;
+	char *evr;		/**< epoch:version-release, the epoch defaults to 0 */
+	char *signature_keyid;	/**< "0" if there is no signature */
+	char *extended_name;	/**< name-epoch:version-release.arch */
+};
+
+/**
+ * Snapshot of the rpm database shared by all RPM probes. The snapshot is
+ * read once and kept while any RPM probe is running, it's read again only
+ * when the database files change.
+ */
+struct rpm_index;
+
+/**
+ * Register an RPM probe as a user of the index, called by probe_init
+ */
+void rpm_index_acquire(void);
+
+/**
+ * Unregister an RPM probe, the snapshot is dropped with the last user
+ */
+void rpm_index_release(void);
+
+/**
+ * Get a reference to the current snapshot of the database opened by ts,
+ * the caller has to hold the lock of ts. Returns NULL on error.
+ */
+struct rpm_index *rpm_index_get(rpmts ts);
+
+/**
+ * Drop a reference returned by rpm_index_get()
+ */
+void rpm_index_put(struct rpm_index *index);
+
+/**
+ * Find the packages whose name matches name using op, which is one of
+ * OVAL_OPERATION_EQUALS, OVAL_OPERATION_NOT_EQUAL (all packages, the name
+ * is checked by the caller) or OVAL_OPERATION_PATTERN_MATCH (POSIX extended
+ * regex). The matches are ordered by name, *pkgs is allocated and has to be
+ * freed by the caller. Returns the number of matches or -1 on error.
+ */
+int rpm_index_find(const struct rpm_index *index, const char *name, oval_operation_t op,
+		const struct rpm_pkg ***pkgs);
+
+/**
+ * Find the package with the given header instance, or NULL
+ */
+const struct rpm_pkg *rpm_index_find_offset(const struct rpm_index *index, unsigned int offset);
+
+/**
+ * Return the packages of the index, ordered by name
+ */
+size_t rpm_index_packages(const struct rpm_index *index, const struct rpm_pkg **pkgs);
+
+/**
+ * Filter of index packages, the counterpart of rpmdbSetIteratorRE()
+ */
+struct rpm_index_filter;
+
+struct rpm_index_filter *rpm_index_filter_new(void);
+
+/**
+ * Require the NAME, EPOCH, VERSION, RELEASE or ARCH tag to be equal to value
+ * (OVAL_OPERATION_EQUALS, like RPMMIRE_STRCMP) or to match the POSIX extended
+ * regex value (OVAL_OPERATION_PATTERN_MATCH, like RPMMIRE_REGEX). A missing
+ * epoch is compared as 0. Returns -1 on error.
+ */
+int rpm_index_filter_add(struct rpm_index_filter *filter, rpmTag tag, oval_operation_t op, const char *value);
+
+bool rpm_index_filter_match(const struct rpm_index_filter *filter, const struct rpm_pkg *pkg);
+
+void rpm_index_filter_free(struct rpm_index_filter *filter);
+
+/**
+ * Return an iterator over the header of the package
+ */
+rpmdbMatchIterator rpm_index_pkg_iterator(rpmts ts, const struct rpm_pkg *pkg);
+
 #endif
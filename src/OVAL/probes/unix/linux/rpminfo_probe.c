@@ -57,7 +57,6 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
-#include <regex.h>
 
 /* RPM headers */
 #include "rpm-helper.h"
@@ -77,204 +76,21 @@ struct rpminfo_req {
         oval_operation_t op;
 };
 
-struct rpminfo_rep {
-        char *name;
-        char *arch;
-        char *epoch;
-        char *release;
-        char *version;
-        char *evr;
-        char *signature_keyid;
-	char extended_name[1024];
-};
-
 #define RPMINFO_LOCK	RPM_MUTEX_LOCK(&g_rpm->mutex)
 
 #define RPMINFO_UNLOCK	RPM_MUTEX_UNLOCK(&g_rpm->mutex)
 
-static const char g_keyid_regex_string[] = "Key ID [a-fA-F0-9]{16}";
-
-static void __rpminfo_rep_free (struct rpminfo_rep *ptr)
-{
-        free (ptr->name);
-        free (ptr->arch);
-        free (ptr->epoch);
-        free (ptr->release);
-        free (ptr->version);
-        free (ptr->evr);
-        free (ptr->signature_keyid);
-}
-
-static void pkgh2rep(Header h, struct rpminfo_rep *r, regex_t *keyid_regex)
-{
-        errmsg_t rpmerr;
-        char *str, *sid;
-	char *epoch_override = NULL;
-        size_t len;
-	regmatch_t keyid_match[1];
-
-	if (h == NULL || r == NULL) {
-		return;
-	}
-
-        r->name = headerFormat (h, "%{NAME}", &rpmerr);
-        r->arch = headerFormat (h, "%{ARCH}", &rpmerr);
-        r->epoch = headerFormat (h, "%{EPOCH}", &rpmerr);
-        r->release = headerFormat (h, "%{RELEASE}", &rpmerr);
-        r->version = headerFormat (h, "%{VERSION}", &rpmerr);
-	epoch_override = oscap_streq(r->epoch, "(none)") ? "0" : r->epoch;
-	snprintf(r->extended_name, 1024, "%s-%s:%s-%s.%s", r->name, epoch_override, r->version, r->release, r->arch);
-
-	len = (strlen(epoch_override) +
-               strlen (r->release) +
-               strlen (r->version) + 2);
-
-        str = malloc (sizeof (char) * (len + 1));
-        snprintf (str, len + 1, "%s:%s-%s",
-		epoch_override,
-                  r->version,
-                  r->release);
-
-        r->evr = str;
-
-        str = headerFormat (h, "%|SIGGPG?{%{SIGGPG:pgpsig}}:{%{SIGPGP:pgpsig}}|", &rpmerr);
-
-	if (regexec(keyid_regex, str, 1, keyid_match, 0) != 0) {
-		sid = NULL;
-		dD("Failed to extract the Key ID value: regex=\"%s\", string=\"%s\"",
-		   g_keyid_regex_string, str);
-	} else {
-		size_t keyid_start, keyid_length;
-
-		if (keyid_match[0].rm_so < 0 || keyid_match[0].rm_eo < 0)
-			sid = NULL;
-		else {
-			keyid_start = keyid_match[0].rm_so + strlen("Key ID ");
-			keyid_length = keyid_match[0].rm_eo - keyid_start;
-			sid = str + keyid_start;
-			sid[keyid_length] = '\0';
-		}
-	}
-
-        r->signature_keyid = strdup(sid != NULL ? sid : "0");
-        free (str);
-}
-
 /*
- * req - Structure containing the name of the package.
- * rep - Pointer to rpminfo_rep structure pointer. An
- *       array of rpminfo_rep structures will be allocated
- *       here.
- *
- * The return value on error is -1. Otherwise the number of
- * rpminfo_rep structures allocated in *rep is returned.
+ * Get the current snapshot of the rpm database, shared with the other RPM
+ * probes. Returns -1 on error.
  */
-static int get_rpminfo(struct rpminfo_req *req, struct rpminfo_rep **rep, struct rpm_probe_global *g_rpm)
+static int get_rpm_index(struct rpm_probe_global *g_rpm, struct rpm_index **index)
 {
-	rpmdbMatchIterator match;
-	Header pkgh;
-	int ret = 0, i;
-	regex_t keyid_regex;
-
-	if (regcomp(&keyid_regex, g_keyid_regex_string, REG_EXTENDED) != 0) {
-		dE("regcomp(%s) failed.", g_keyid_regex_string);
-		return -1;
-	}
-
-        RPMINFO_LOCK;
-
-        ret = -1;
-
-        switch (req->op) {
-        case OVAL_OPERATION_EQUALS:
-		match = rpmtsInitIterator(g_rpm->rpmts, RPMTAG_NAME, (const void *)req->name, 0);
-
-                if (match == NULL) {
-                        ret = 0;
-                        goto ret;
-                }
-
-                ret = rpmdbGetIteratorCount (match);
-
-                break;
-	case OVAL_OPERATION_NOT_EQUAL:
-		match = rpmtsInitIterator(g_rpm->rpmts, RPMDBI_PACKAGES, NULL, 0);
-                if (match == NULL) {
-                        ret = 0;
-                        goto ret;
-                }
-
-                if (rpmdbSetIteratorRE (match, RPMTAG_NAME, RPMMIRE_GLOB, "*") != 0)
-                {
-                        ret = -1;
-                        goto ret;
-                }
-
-                break;
-        case OVAL_OPERATION_PATTERN_MATCH:
-		match = rpmtsInitIterator(g_rpm->rpmts, RPMDBI_PACKAGES, NULL, 0);
-
-                if (match == NULL) {
-                        ret = 0;
-                        goto ret;
-                }
-
-                if (rpmdbSetIteratorRE (match, RPMTAG_NAME, RPMMIRE_REGEX,
-                                        (const char *)req->name) != 0)
-                {
-                        ret = -1;
-                        goto ret;
-                }
-
-                break;
-        default:
-                /* not supported */
-                ret = -1;
-                goto ret;
-        }
-
-        if (ret != -1) {
-                /*
-                 * We can allocate all memory needed now because we know the number
-                 * of results.
-                 */
-                void *new_rep = realloc (*rep, sizeof (struct rpminfo_rep) * ret);
-                if (new_rep == NULL) {
-                        ret = -2;
-                        goto ret;
-                }
-                (*rep) = new_rep;
-                for (i = 0; i < ret; ++i) {
-                        pkgh = rpmdbNextIterator (match);
-
-                        if (pkgh != NULL)
-			pkgh2rep(pkgh, (*rep) + i, &keyid_regex);
-                        else {
-                                /* XXX: emit warning */
-                                memset((*rep) + i, 0, sizeof(struct rpminfo_rep));
-                                break;
-                        }
-                }
-        } else {
-                ret = 0;
+	RPMINFO_LOCK;
+	*index = rpm_index_get(g_rpm->rpmts);
+	RPMINFO_UNLOCK;
 
-                while ((pkgh = rpmdbNextIterator (match)) != NULL) {
-                        void *new_rep = realloc (*rep, sizeof (struct rpminfo_rep) * ++ret);
-                        if (new_rep == NULL) {
-                                ret = -2;
-                                goto ret;
-                        }
-                        (*rep) = new_rep;
-                        pkgh2rep(pkgh, (*rep) + (ret - 1), &keyid_regex);
-                }
-        }
-
-	match = rpmdbFreeIterator (match);
-ret:
-        RPMINFO_UNLOCK;
-
-	regfree(&keyid_regex);
-        return (ret);
+	return *index != NULL ? 0 : -1;
 }
 
 int rpminfo_probe_offline_mode_supported()
@@ -307,6 +123,7 @@ void *rpminfo_probe_init(void)
 
 	g_rpm->rpmts = rpmtsCreate();
 	pthread_mutex_init (&(g_rpm->mutex), NULL);
+	rpm_index_acquire();
 
 	return ((void *)g_rpm);
 }
@@ -327,6 +144,7 @@ void rpminfo_probe_fini (void *ptr)
 	if (r->rpmts == NULL)
 		return;
 
+	rpm_index_release();
         rpmtsFree(r->rpmts);
         pthread_mutex_destroy (&(r->mutex));
 
@@ -334,7 +152,7 @@ void rpminfo_probe_fini (void *ptr)
         return;
 }
 
-static int collect_rpm_files(SEXP_t *item, const struct rpminfo_rep *rep, struct rpm_probe_global *g_rpm)
+static int collect_rpm_files(SEXP_t *item, const struct rpm_pkg *pkg, struct rpm_probe_global *g_rpm)
 {
 	SEXP_t *value;
 	rpmdbMatchIterator ts;
@@ -343,29 +161,11 @@ static int collect_rpm_files(SEXP_t *item, const struct rpminfo_rep *rep, struct
 	rpmTag tag[2] = { RPMTAG_BASENAMES, RPMTAG_DIRNAMES };
 	int i, ret = 0;
 
-	ts = rpmtsInitIterator(g_rpm->rpmts, RPMDBI_PACKAGES, NULL, 0);
-	if (ts == NULL) {
-		return -1;
-	}
+	RPMINFO_LOCK;
 
-	if (rpmdbSetIteratorRE(ts, RPMTAG_NAME, RPMMIRE_STRCMP, rep->name) != 0) {
-		ret = -1;
-		goto cleanup;
-	}
-	char *epoch_override = oscap_streq(rep->epoch, "(none)") ? "0" : rep->epoch;
-	if (rpmdbSetIteratorRE(ts, RPMTAG_EPOCH, RPMMIRE_STRCMP, epoch_override) != 0) {
-		ret = -1;
-		goto cleanup;
-	}
-	if (rpmdbSetIteratorRE(ts, RPMTAG_VERSION, RPMMIRE_STRCMP, rep->version) != 0) {
-		ret = -1;
-		goto cleanup;
-	}
-	if (rpmdbSetIteratorRE(ts, RPMTAG_RELEASE, RPMMIRE_STRCMP, rep->release) != 0) {
-		ret = -1;
-		goto cleanup;
-	}
-	if (rpmdbSetIteratorRE(ts, RPMTAG_ARCH, RPMMIRE_STRCMP, rep->arch) != 0) {
+	/* The header is looked up directly by its offset found in the index */
+	ts = rpm_index_pkg_iterator(g_rpm->rpmts, pkg);
+	if (ts == NULL) {
 		ret = -1;
 		goto cleanup;
 	}
@@ -394,8 +194,9 @@ static int collect_rpm_files(SEXP_t *item, const struct rpminfo_rep *rep, struct
 		}
 
 	}
-cleanup:
 	ts = rpmdbFreeIterator(ts);
+cleanup:
+	RPMINFO_UNLOCK;
 	return ret;
 }
 
@@ -403,10 +204,11 @@ int rpminfo_probe_main(probe_ctx *ctx, void *arg)
 {
 	SEXP_t *val, *item, *ent, *probe_in;
 	oval_schema_version_t over;
-	int rpmret, i;
+	int rpmret, i, ret = 0;
 
         struct rpminfo_req request_st;
-        struct rpminfo_rep *reply_st;
+        const struct rpm_pkg **reply_st;
+        struct rpm_index *index = NULL;
 
 	// arg is NULL if regex compilation failed
 	if (arg == NULL) {
@@ -489,13 +291,17 @@ int rpminfo_probe_main(probe_ctx *ctx, void *arg)
 
         reply_st  = NULL;
 
-        /* get info from RPM db */
-	switch (rpmret = get_rpminfo(&request_st, &reply_st, g_rpm)) {
+        /* get info from the shared index of the RPM db */
+	rpmret = get_rpm_index(g_rpm, &index);
+	if (rpmret == 0)
+		rpmret = rpm_index_find(index, request_st.name, request_st.op, &reply_st);
+
+	switch (rpmret) {
         case 0: /* Not found */
                 dI("Package \"%s\" not found.", request_st.name);
                 break;
         case -1: /* Error */
-                dD("get_rpminfo failed");
+                dD("rpm_index_find failed");
 
                 item = probe_item_create(OVAL_LINUX_RPM_INFO, NULL,
                                          "name", OVAL_DATATYPE_STRING, request_st.name,
@@ -511,7 +317,7 @@ int rpminfo_probe_main(probe_ctx *ctx, void *arg)
                         SEXP_t *name;
 
                         for (i = 0; i < rpmret; ++i) {
-				name = SEXP_string_newf("%s", reply_st[i].name);
+				name = SEXP_string_newf("%s", reply_st[i]->name);
 
 				if (probe_entobj_cmp(ent, name) != OVAL_RESULT_TRUE) {
 					SEXP_free(name);
@@ -520,12 +326,12 @@ int rpminfo_probe_main(probe_ctx *ctx, void *arg)
 
                                 item = probe_item_create(OVAL_LINUX_RPM_INFO, NULL,
                                                          "name",    OVAL_DATATYPE_SEXP, name,
-                                                         "arch",    OVAL_DATATYPE_STRING, reply_st[i].arch,
-                                                         "epoch",   OVAL_DATATYPE_STRING, reply_st[i].epoch,
-                                                         "release", OVAL_DATATYPE_STRING, reply_st[i].release,
-                                                         "version", OVAL_DATATYPE_STRING, reply_st[i].version,
-                                                         "evr",     OVAL_DATATYPE_EVR_STRING, reply_st[i].evr,
-                                                         "signature_keyid", OVAL_DATATYPE_STRING, reply_st[i].signature_keyid,
+                                                         "arch",    OVAL_DATATYPE_STRING, reply_st[i]->arch,
+                                                         "epoch",   OVAL_DATATYPE_STRING, reply_st[i]->epoch,
+                                                         "release", OVAL_DATATYPE_STRING, reply_st[i]->release,
+                                                         "version", OVAL_DATATYPE_STRING, reply_st[i]->version,
+                                                         "evr",     OVAL_DATATYPE_EVR_STRING, reply_st[i]->evr,
+                                                         "signature_keyid", OVAL_DATATYPE_STRING, reply_st[i]->signature_keyid,
                                                          NULL);
 
 				/* OVAL 5.10 added extended_name and filepaths behavior */
@@ -533,8 +339,8 @@ int rpminfo_probe_main(probe_ctx *ctx, void *arg)
 					SEXP_t *value, *bh_value;
 					value = probe_entval_from_cstr(
 							OVAL_DATATYPE_STRING,
-							reply_st[i].extended_name,
-							strlen(reply_st[i].extended_name)
+							reply_st[i]->extended_name,
+							strlen(reply_st[i]->extended_name)
 					);
 					probe_item_ent_add(item, "extended_name", NULL, value);
 					SEXP_free(value);
@@ -548,7 +354,7 @@ int rpminfo_probe_main(probe_ctx *ctx, void *arg)
 						if (bh_value != NULL) {
 							if (SEXP_strcmp(bh_value, "true") == 0) {
 								/* collect package files */
-								collect_rpm_files(item, &reply_st[i], g_rpm);
+								collect_rpm_files(item, reply_st[i], g_rpm);
 
 							}
 							SEXP_free(bh_value);
@@ -560,20 +366,19 @@ int rpminfo_probe_main(probe_ctx *ctx, void *arg)
 
 
 				SEXP_free(name);
-                                __rpminfo_rep_free (&(reply_st[i]));
 
 				if (probe_item_collect(ctx, item) < 0) {
-					SEXP_free(ent);
-					return PROBE_EUNKNOWN;
+					ret = PROBE_EUNKNOWN;
+					break;
 				}
                         }
-
-                        free (reply_st);
                 }
         }
 
+	free(reply_st);
+	rpm_index_put(index);
 	SEXP_free(ent);
         free(request_st.name);
 
-        return 0;
+        return ret;
 }
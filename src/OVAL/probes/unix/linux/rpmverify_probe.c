@@ -84,7 +84,9 @@ static int rpmverify_collect(probe_ctx *ctx,
         rpmVerifyAttrs omit = (rpmVerifyAttrs)(flags & RPMVERIFY_RPMATTRMASK);
 	Header pkgh;
 	oscap_pcre_t *re = NULL;
-	int  ret = -1;
+	struct rpm_index *index;
+	const struct rpm_pkg **pkgs = NULL;
+	int  ret = -1, count, p;
 
         /* pre-compile regex if needed */
         if (file_op == OVAL_OPERATION_PATTERN_MATCH) {
@@ -102,120 +104,94 @@ static int rpmverify_collect(probe_ctx *ctx,
 
         RPMVERIFY_LOCK;
 
-        switch (name_op) {
-        case OVAL_OPERATION_EQUALS:
-		match = rpmtsInitIterator(g_rpm->rpmts, RPMTAG_NAME, (const void *)name, 0);
-
-                if (match == NULL) {
-                        ret = 0;
-                        goto ret;
-                }
-
-                ret = rpmdbGetIteratorCount (match);
-
-                break;
-	case OVAL_OPERATION_NOT_EQUAL:
-		match = rpmtsInitIterator(g_rpm->rpmts, RPMDBI_PACKAGES, NULL, 0);
-
-                if (match == NULL) {
-                        ret = 0;
-                        goto ret;
-                }
-
-                if (rpmdbSetIteratorRE (match, RPMTAG_NAME, RPMMIRE_GLOB, "*") != 0)
-                {
-                        ret = -1;
-                        goto ret;
-                }
-
-                break;
-        case OVAL_OPERATION_PATTERN_MATCH:
-		match = rpmtsInitIterator(g_rpm->rpmts, RPMDBI_PACKAGES, NULL, 0);
-
-                if (match == NULL) {
-                        ret = 0;
-                        goto ret;
-                }
-
-                if (rpmdbSetIteratorRE (match, RPMTAG_NAME, RPMMIRE_REGEX,
-                                        (const char *)name) != 0)
-                {
-                        ret = -1;
-                        goto ret;
-                }
+	/* The packages are selected from the index shared by the RPM probes */
+	index = rpm_index_get(g_rpm->rpmts);
+	if (index == NULL) {
+		ret = -1;
+		goto ret;
+	}
 
-                break;
-        default:
-                /* not supported */
-                dE("package name: operation not supported");
-                ret = -1;
-                goto ret;
-        }
+	count = rpm_index_find(index, name, name_op, &pkgs);
+	if (count < 0) {
+		dE("package name: operation not supported");
+		ret = -1;
+		goto ret;
+	}
 
 	if (RPMTAG_BASENAMES == 0 || RPMTAG_DIRNAMES == 0) {
-		return -1;
+		ret = -1;
+		goto ret;
 	}
 
-        while ((pkgh = rpmdbNextIterator (match)) != NULL) {
-                rpmfi  fi;
-		rpmTag tag[2] = { RPMTAG_BASENAMES, RPMTAG_DIRNAMES };
-                struct rpmverify_res res;
-                errmsg_t rpmerr;
-		int i;
+	for (p = 0; p < count; ++p) {
 		SEXP_t *name_sexp;
 
-                res.name = headerFormat(pkgh, "%{NAME}", &rpmerr);
-
-		name_sexp = SEXP_string_newf("%s", res.name);
+		name_sexp = SEXP_string_newf("%s", pkgs[p]->name);
 		if (probe_entobj_cmp(name_ent, name_sexp) != OVAL_RESULT_TRUE) {
 			SEXP_free(name_sexp);
 			continue;
 		}
 		SEXP_free(name_sexp);
 
-                /*
-                 * Inspect package files & directories
-                 */
-		for (i = 0; i < 2; ++i) {
-			fi = rpmfiNew(g_rpm->rpmts, pkgh, tag[i], 1);
+		match = rpm_index_pkg_iterator(g_rpm->rpmts, pkgs[p]);
+		if (match == NULL)
+			continue;
+
+		while ((pkgh = rpmdbNextIterator (match)) != NULL) {
+			rpmfi  fi;
+			rpmTag tag[2] = { RPMTAG_BASENAMES, RPMTAG_DIRNAMES };
+			struct rpmverify_res res;
+			int i;
+
+			res.name = pkgs[p]->name;
 
-		  while (rpmfiNext(fi) != -1) {
-		    SEXP_t *filepath_sexp;
+			/*
+			 * Inspect package files & directories
+			 */
+			for (i = 0; i < 2; ++i) {
+				fi = rpmfiNew(g_rpm->rpmts, pkgh, tag[i], 1);
 
-		    res.fflags = rpmfiFFlags(fi);
-		    res.oflags = omit;
+				while (rpmfiNext(fi) != -1) {
+					SEXP_t *filepath_sexp;
 
-		    if (((res.fflags & RPMFILE_CONFIG) && (flags & RPMVERIFY_SKIP_CONFIG)) ||
-			((res.fflags & RPMFILE_GHOST)  && (flags & RPMVERIFY_SKIP_GHOST)))
-		      continue;
+					res.fflags = rpmfiFFlags(fi);
+					res.oflags = omit;
 
-		    res.file   = strdup(rpmfiFN(fi));
+					if (((res.fflags & RPMFILE_CONFIG) && (flags & RPMVERIFY_SKIP_CONFIG)) ||
+					    ((res.fflags & RPMFILE_GHOST)  && (flags & RPMVERIFY_SKIP_GHOST)))
+						continue;
 
-		    filepath_sexp = SEXP_string_newf("%s", res.file);
-		    if (probe_entobj_cmp(filepath_ent, filepath_sexp) != OVAL_RESULT_TRUE) {
-		      SEXP_free(filepath_sexp);
-		      free(res.file);
-		      continue;
-		    }
-		    SEXP_free(filepath_sexp);
+					res.file   = strdup(rpmfiFN(fi));
 
-		    if (rpmVerifyFile(g_rpm->rpmts, fi, &res.vflags, omit) != 0)
-		      res.vflags = RPMVERIFY_FAILURES;
+					filepath_sexp = SEXP_string_newf("%s", res.file);
+					if (probe_entobj_cmp(filepath_ent, filepath_sexp) != OVAL_RESULT_TRUE) {
+						SEXP_free(filepath_sexp);
+						free(res.file);
+						continue;
+					}
+					SEXP_free(filepath_sexp);
 
-		    callback(ctx, &res);
-		    free(res.file);
-		  }
+					if (rpmVerifyFile(g_rpm->rpmts, fi, &res.vflags, omit) != 0)
+						res.vflags = RPMVERIFY_FAILURES;
 
-		  rpmfiFree(fi);
+					callback(ctx, &res);
+					free(res.file);
+				}
+
+				rpmfiFree(fi);
+			}
 		}
+
+		match = rpmdbFreeIterator (match);
 	}
 
-	match = rpmdbFreeIterator (match);
         ret   = 0;
 ret:
         if (re != NULL)
                 oscap_pcre_free(re);
 
+	free(pkgs);
+	rpm_index_put(index);
         RPMVERIFY_UNLOCK;
         return (ret);
 }
@@ -251,6 +227,7 @@ void *rpmverify_probe_init(void)
 	g_rpm->rpmts = rpmtsCreate();
 
 	pthread_mutex_init(&(g_rpm->mutex), NULL);
+	rpm_index_acquire();
         return ((void *)g_rpm);
 }
 
@@ -267,6 +244,7 @@ void rpmverify_probe_fini(void *ptr)
 	if (r == NULL)
 		return;
 
+	rpm_index_release();
 	rpmtsFree(r->rpmts);
 	pthread_mutex_destroy (&(r->mutex));
 	free(r);
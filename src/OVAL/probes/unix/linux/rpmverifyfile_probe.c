@@ -97,8 +97,8 @@ struct rpmverify_res {
 
 static int rpmverify_additem(probe_ctx *ctx, struct rpmverify_res *res);
 
-/* modify passed-in iterator to test also given entity */
-static int adjust_filter(rpmdbMatchIterator iterator, SEXP_t *ent, rpmTag rpm_tag) {
+/* modify passed-in filter to test also given entity */
+static int adjust_filter(struct rpm_index_filter *filter, SEXP_t *ent, rpmTag rpm_tag) {
 	oval_operation_t ent_op;
 	char ent_str[1024];
 	int ret = 0;
@@ -107,21 +107,8 @@ static int adjust_filter(rpmdbMatchIterator iterator, SEXP_t *ent, rpmTag rpm_ta
 		ent_op = probe_ent_getoperation(ent, OVAL_OPERATION_EQUALS);
 		PROBE_ENT_STRVAL(ent, ent_str, sizeof ent_str, /* void */, strcpy(ent_str, ""););
 
-		switch (ent_op) {
-		case OVAL_OPERATION_EQUALS:
-			if (rpmdbSetIteratorRE (iterator, rpm_tag, RPMMIRE_STRCMP, ent_str) != 0)
-				ret = -1;
-
-			break;
-		case OVAL_OPERATION_PATTERN_MATCH:
-			if (rpmdbSetIteratorRE (iterator, rpm_tag, RPMMIRE_REGEX,
-						(const char *)ent_str) != 0)
-				ret = -1;
-
-			break;
-		default:
-			ret = 0;
-		}
+		if (rpm_index_filter_add(filter, rpm_tag, ent_op, ent_str) != 0)
+			ret = -1;
 	}
 	return ret;
 }
@@ -157,7 +144,7 @@ static int _compare_file_with_current_file(oval_operation_t file_op, const char
 	} else if (file_op == OVAL_OPERATION_PATTERN_MATCH) {
 		char *errmsg;
 		int erroff;
-		oscap_pcre_t *re = oscap_pcre_compile(file, OSCAP_PCRE_OPTS_UTF8, &errmsg,  &erroff);
+		oscap_pcre_t *re = oscap_pcre_compile_cached(file, OSCAP_PCRE_OPTS_UTF8, &errmsg, &erroff);
 		if (re == NULL) {
 			dE("oscap_pcre_compile pattern='%s': %s", file, errmsg);
 			ret = -1;
@@ -245,10 +232,19 @@ static int rpmverify_collect(probe_ctx *ctx,
 {
 	rpmdbMatchIterator match;
 	Header pkgh;
+	struct rpm_index *index;
+	struct rpm_index_filter *filter = NULL;
+	const struct rpm_pkg **pkgs = NULL;
+	size_t count = 0, i;
 	int  ret = -1;
 
 	RPMVERIFY_LOCK;
 
+	/* The packages are selected from the index shared by the RPM probes */
+	index = rpm_index_get(g_rpm->rpmts);
+	if (index == NULL)
+		goto ret;
+
 	if (file != NULL && file_op == OVAL_OPERATION_EQUALS) {
 		/*
 		 * When we know the exact file path we look for, we don't need to
@@ -256,39 +252,52 @@ static int rpmverify_collect(probe_ctx *ctx,
 		 * the package which provides this file, similar to `rpm -q -f`.
 		 */
 		match = rpmtsInitIterator(g_rpm->rpmts, RPMDBI_INSTFILENAMES, file, 0);
+		if (match != NULL) {
+			pkgs = malloc((rpmdbGetIteratorCount(match) + 1) * sizeof(struct rpm_pkg *));
+			while ((pkgh = rpmdbNextIterator(match)) != NULL) {
+				const struct rpm_pkg *pkg = rpm_index_find_offset(index, rpmdbGetIteratorOffset(match));
+				if (pkg != NULL)
+					pkgs[count++] = pkg;
+			}
+			match = rpmdbFreeIterator(match);
+		}
 	} else {
-		match = rpmtsInitIterator(g_rpm->rpmts, RPMDBI_PACKAGES, NULL, 0);
-	}
-	if (match == NULL) {
-		ret = 0;
-		goto ret;
+		const struct rpm_pkg *all;
+
+		count = rpm_index_packages(index, &all);
+		pkgs = malloc((count + 1) * sizeof(struct rpm_pkg *));
+		for (i = 0; i < count; ++i)
+			pkgs[i] = all + i;
 	}
 
-	if ((ret = adjust_filter(match, name_ent, RPMTAG_NAME)) == -1) {
+	filter = rpm_index_filter_new();
+	if ((ret = adjust_filter(filter, name_ent, RPMTAG_NAME)) == -1) {
 		dE("can't adjust filter with name");
 		goto ret;
 	}
-	if ((ret = adjust_filter(match, epoch_ent, RPMTAG_EPOCH)) == -1) {
+	if ((ret = adjust_filter(filter, epoch_ent, RPMTAG_EPOCH)) == -1) {
 		dE("can't adjust filter with epoch");
 		goto ret;
 	}
-	if ((ret = adjust_filter(match, version_ent, RPMTAG_VERSION)) == -1) {
+	if ((ret = adjust_filter(filter, version_ent, RPMTAG_VERSION)) == -1) {
 		dE("can't adjust filter with version");
 		goto ret;
 	}
-	if ((ret = adjust_filter(match, release_ent, RPMTAG_RELEASE)) == -1) {
+	if ((ret = adjust_filter(filter, release_ent, RPMTAG_RELEASE)) == -1) {
 		dE("can't adjust filter with version");
 		goto ret;
 	}
-	if ((ret = adjust_filter(match, arch_ent, RPMTAG_ARCH)) == -1) {
+	if ((ret = adjust_filter(filter, arch_ent, RPMTAG_ARCH)) == -1) {
 		dE("can't adjust filter with version");
 		goto ret;
 	}
 
-	while ((pkgh = rpmdbNextIterator (match)) != NULL) {
+	for (i = 0; i < count; ++i) {
 		SEXP_t *ent;
 		struct rpmverify_res res;
-		errmsg_t rpmerr;
+
+		if (!rpm_index_filter_match(filter, pkgs[i]))
+			continue;
 
 #define COMPARE_ENT(XXX) \
 		if (XXX ## _ent != NULL) { \
@@ -302,32 +311,30 @@ static int rpmverify_collect(probe_ctx *ctx,
 			SEXP_free(ent); \
 		}
 
-		res.name = headerFormat(pkgh, "%{NAME}", &rpmerr);
+		res.name = pkgs[i]->name;
 		COMPARE_ENT(name);
 
-		res.epoch = headerFormat(pkgh, "%{EPOCH}", &rpmerr);
+		res.epoch = pkgs[i]->epoch;
 		COMPARE_ENT(epoch);
 
-		res.version = headerFormat(pkgh, "%{VERSION}", &rpmerr);
+		res.version = pkgs[i]->version;
 		COMPARE_ENT(version);
-		res.release = headerFormat(pkgh, "%{RELEASE}", &rpmerr);
+		res.release = pkgs[i]->release;
 		COMPARE_ENT(release);
-		res.arch = headerFormat(pkgh, "%{ARCH}", &rpmerr);
+		res.arch = pkgs[i]->arch;
 		COMPARE_ENT(arch);
-		snprintf(res.extended_name, 1024, "%s-%s:%s-%s.%s", res.name,
-			oscap_streq(res.epoch, "(none)") ? "0" : res.epoch,
-			res.version, res.release, res.arch);
+		snprintf(res.extended_name, 1024, "%s", pkgs[i]->extended_name);
 
-		if (rpmverify_collect_package_files_or_directories(g_rpm, ctx, pkgh, file, file_op, RPMTAG_BASENAMES, &res, flags) != 0 ||
-				rpmverify_collect_package_files_or_directories(g_rpm, ctx, pkgh, file, file_op, RPMTAG_DIRNAMES, &res, flags) != 0) {
-			ret = -1;
+		match = rpm_index_pkg_iterator(g_rpm->rpmts, pkgs[i]);
+		while (match != NULL && (pkgh = rpmdbNextIterator(match)) != NULL) {
+			if (rpmverify_collect_package_files_or_directories(g_rpm, ctx, pkgh, file, file_op, RPMTAG_BASENAMES, &res, flags) != 0 ||
+					rpmverify_collect_package_files_or_directories(g_rpm, ctx, pkgh, file, file_op, RPMTAG_DIRNAMES, &res, flags) != 0) {
+				ret = -1;
+				break;
+			}
 		}
+		match = rpmdbFreeIterator(match);
 
-		free(res.name);
-		free(res.epoch);
-		free(res.version);
-		free(res.release);
-		free(res.arch);
 		if (ret == -1) {
 			goto ret;
 		}
@@ -335,7 +342,9 @@ static int rpmverify_collect(probe_ctx *ctx,
 
 	ret   = 0;
 ret:
-	match = rpmdbFreeIterator(match);
+	rpm_index_filter_free(filter);
+	free(pkgs);
+	rpm_index_put(index);
 	RPMVERIFY_UNLOCK;
 	return (ret);
 }
@@ -372,6 +381,7 @@ void *rpmverifyfile_probe_init(void)
 	g_rpm->rpmts = rpmtsCreate();
 
 	pthread_mutex_init(&(g_rpm->mutex), NULL);
+	rpm_index_acquire();
 
 	return ((void *)g_rpm);
 }
@@ -389,6 +399,7 @@ void rpmverifyfile_probe_fini(void *ptr)
 	if (r == NULL)
 		return;
 
+	rpm_index_release();
 	rpmtsFree(r->rpmts);
 	pthread_mutex_destroy (&(r->mutex));
 	free(r);
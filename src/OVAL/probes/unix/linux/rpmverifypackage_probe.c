@@ -113,8 +113,8 @@ static struct poptOption optionsTable[] = {
 
 #define CHROOT_PATH() probe_chroot_get_path(&g_rpm->chr)
 
-/* modify passed-in iterator to test also given entity */
-static int adjust_filter(rpmdbMatchIterator iterator, SEXP_t *ent, rpmTag rpm_tag) {
+/* modify passed-in filter to test also given entity */
+static int adjust_filter(struct rpm_index_filter *filter, SEXP_t *ent, rpmTag rpm_tag) {
 	oval_operation_t ent_op;
 	char ent_str[1024] = "";
 	int ret = 0;
@@ -126,21 +126,8 @@ static int adjust_filter(rpmdbMatchIterator iterator, SEXP_t *ent, rpmTag rpm_ta
 			return ret;
 		}
 
-		switch (ent_op) {
-		case OVAL_OPERATION_EQUALS:
-			if (rpmdbSetIteratorRE (iterator, rpm_tag, RPMMIRE_STRCMP, ent_str) != 0)
-				ret = -1;
-
-			break;
-		case OVAL_OPERATION_PATTERN_MATCH:
-			if (rpmdbSetIteratorRE (iterator, rpm_tag, RPMMIRE_REGEX,
-						(const char *)ent_str) != 0)
-				ret = -1;
-
-			break;
-		default:
-			ret = 0;
-		}
+		if (rpm_index_filter_add(filter, rpm_tag, ent_op, ent_str) != 0)
+			ret = -1;
 	}
 	return ret;
 }
@@ -151,8 +138,10 @@ static int rpmverify_collect(probe_ctx *ctx,
 			int (*callback)(probe_ctx *, struct rpmverify_res *),
 			struct verifypackage_global *g_rpm)
 {
-	rpmdbMatchIterator match;
-	Header pkgh;
+	struct rpm_index *index;
+	struct rpm_index_filter *filter = NULL;
+	const struct rpm_pkg *pkgs;
+	size_t count, p;
 	int  ret = -1;
 	unsigned int i, j, rpmcli_argc = 0;
 	const char * rpmcli_argv[10];
@@ -161,45 +150,49 @@ static int rpmverify_collect(probe_ctx *ctx,
 
 	RPMVERIFY_LOCK;
 
-	match = rpmtsInitIterator (g_rpm->rpm.rpmts, RPMDBI_PACKAGES, NULL, 0);
-	if (match == NULL) {
-		ret = 0;
+	/* The packages are selected from the index shared by the RPM probes */
+	index = rpm_index_get(g_rpm->rpm.rpmts);
+	if (index == NULL)
 		goto ret;
-	}
+	count = rpm_index_packages(index, &pkgs);
 
-	if ((ret = adjust_filter(match, name_ent, RPMTAG_NAME)) == -1) {
+	filter = rpm_index_filter_new();
+	if ((ret = adjust_filter(filter, name_ent, RPMTAG_NAME)) == -1) {
 		dE("can't adjust filter with name");
 		goto ret;
 	}
-	if ((ret = adjust_filter(match, epoch_ent, RPMTAG_EPOCH)) == -1) {
+	if ((ret = adjust_filter(filter, epoch_ent, RPMTAG_EPOCH)) == -1) {
 		dE("can't adjust filter with epoch");
 		goto ret;
 	}
-	if ((ret = adjust_filter(match, version_ent, RPMTAG_VERSION)) == -1) {
+	if ((ret = adjust_filter(filter, version_ent, RPMTAG_VERSION)) == -1) {
 		dE("can't adjust filter with version");
 		goto ret;
 	}
-	if ((ret = adjust_filter(match, release_ent, RPMTAG_RELEASE)) == -1) {
+	if ((ret = adjust_filter(filter, release_ent, RPMTAG_RELEASE)) == -1) {
 		dE("can't adjust filter with version");
 		goto ret;
 	}
-	if ((ret = adjust_filter(match, arch_ent, RPMTAG_ARCH)) == -1) {
+	if ((ret = adjust_filter(filter, arch_ent, RPMTAG_ARCH)) == -1) {
 		dE("can't adjust filter with version");
 		goto ret;
 	}
 
 	if (RPMTAG_BASENAMES == 0 || RPMTAG_DIRNAMES == 0) {
-		return -1;
+		ret = -1;
+		goto ret;
 	}
 
 	rpmcli_argv[0] = "probe_rpmverifypackage";
 	rpmcli_argv[1] = "--quiet";
 	rpmcli_argv[2] = "--nofiles";
 
-	while ((pkgh = rpmdbNextIterator (match)) != NULL) {
+	for (p = 0; p < count; ++p) {
 		SEXP_t *ent;
 		struct rpmverify_res res;
-		errmsg_t rpmerr;
+
+		if (!rpm_index_filter_match(filter, pkgs + p))
+			continue;
 
 #define COMPARE_ENT(XXX) \
 		if (XXX ## _ent != NULL) { \
@@ -213,21 +206,19 @@ static int rpmverify_collect(probe_ctx *ctx,
 			SEXP_free(ent); \
 		}
 
-		res.name = headerFormat(pkgh, "%{NAME}", &rpmerr);
+		res.name = pkgs[p].name;
 		COMPARE_ENT(name);
 
-		res.epoch = headerFormat(pkgh, "%{EPOCH}", &rpmerr);
+		res.epoch = pkgs[p].epoch;
 		COMPARE_ENT(epoch);
 
-		res.version = headerFormat(pkgh, "%{VERSION}", &rpmerr);
+		res.version = pkgs[p].version;
 		COMPARE_ENT(version);
-		res.release = headerFormat(pkgh, "%{RELEASE}", &rpmerr);
+		res.release = pkgs[p].release;
 		COMPARE_ENT(release);
-		res.arch = headerFormat(pkgh, "%{ARCH}", &rpmerr);
+		res.arch = pkgs[p].arch;
 		COMPARE_ENT(arch);
-		snprintf(res.extended_name, 1024, "%s-%s:%s-%s.%s", res.name,
-			oscap_streq(res.epoch, "(none)") ? "0" : res.epoch,
-			res.version, res.release, res.arch);
+		snprintf(res.extended_name, 1024, "%s", pkgs[p].extended_name);
 
 		/*
 		 * Verify package
@@ -306,16 +297,12 @@ static int rpmverify_collect(probe_ctx *ctx,
 			ret = 1;
 			goto ret;
 		}
-		free(res.name);
-		free(res.epoch);
-		free(res.version);
-		free(res.release);
-		free(res.arch);
 	}
 
-	match = rpmdbFreeIterator (match);
 	ret   = 0;
 ret:
+	rpm_index_filter_free(filter);
+	rpm_index_put(index);
 	RPMVERIFY_UNLOCK;
 	return (ret);
 }
@@ -378,6 +365,7 @@ void *rpmverifypackage_probe_init(void)
 	}
 
 	pthread_mutex_init(&(g_rpm->rpm.mutex), NULL);
+	rpm_index_acquire();
 	return ((void *)g_rpm);
 }
 
@@ -401,6 +389,7 @@ void rpmverifypackage_probe_fini(void *ptr)
 	if (r->rpm.rpmts == NULL)
 		return;
 
+	rpm_index_release();
 	rpmtsFree(r->rpm.rpmts);
 	pthread_mutex_destroy (&(r->rpm.mutex));
 
@@ -0,0 +1,534 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include "proc-snapshot.h"
+
+#if defined(OS_LINUX)
+
+#include <ctype.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#ifdef HAVE_STDIO_EXT_H
+# include <stdio_ext.h>
+#endif
+#include <sys/sysmacros.h>
+
+#ifdef HAVE_PROC_DEVNAME_H
+ #include <proc/devname.h>
+#endif
+
+#include "common/debug_priv.h"
+#include "oval_fts_walk.h"
+
+#define PROC_ENTRY_CMDLINE     0x01
+#define PROC_ENTRY_TTY         0x02
+#define PROC_ENTRY_UIDS        0x04
+#define PROC_ENTRY_EXEC_SHIELD 0x08
+
+struct proc_snapshot {
+	struct proc_entry *entries;
+	size_t count;
+	unsigned long boot;
+	int proc_fd;			/* $OSCAP_PROBE_ROOT/proc, the files are opened relative to it */
+	unsigned long generation;	/* walk cache generation the snapshot belongs to */
+	unsigned int refs;
+	pthread_mutex_t lock;		/* serializes reading of the lazy fields */
+};
+
+static pthread_mutex_t proc_snapshot_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct proc_snapshot *proc_snapshot_current = NULL;
+static unsigned int proc_snapshot_users = 0;
+
+/* Open /proc/<pid>/<name> with a single openat() relative to /proc */
+static int proc_entry_open(const struct proc_snapshot *snapshot, const struct proc_entry *entry, const char *name)
+{
+	char path[64];
+
+	snprintf(path, sizeof(path), "%d/%s", entry->pid, name);
+	return openat(snapshot->proc_fd, path, O_RDONLY | O_CLOEXEC);
+}
+
+static FILE *proc_entry_fopen(const struct proc_snapshot *snapshot, const struct proc_entry *entry, const char *name)
+{
+	FILE *fp;
+	int fd = proc_entry_open(snapshot, entry, name);
+
+	if (fd < 0)
+		return NULL;
+	fp = fdopen(fd, "r");
+	if (fp == NULL) {
+		close(fd);
+		return NULL;
+	}
+	__fsetlocking(fp, FSETLOCKING_BYCALLER);
+	return fp;
+}
+
+static unsigned long proc_snapshot_read_boot_time(int proc_fd)
+{
+	char buf[PATH_MAX];
+	unsigned long boot = 0;
+	FILE *sf;
+	int fd;
+
+	fd = openat(proc_fd, "stat", O_RDONLY | O_CLOEXEC);
+	if (fd < 0)
+		return 0;
+	sf = fdopen(fd, "r");
+	if (sf == NULL) {
+		close(fd);
+		return 0;
+	}
+	__fsetlocking(sf, FSETLOCKING_BYCALLER);
+	while (fgets(buf, sizeof(buf), sf)) {
+		if (memcmp(buf, "btime", 5) == 0) {
+			sscanf(buf, "btime %lu", &boot);
+			break;
+		}
+	}
+	fclose(sf);
+	return boot;
+}
+
+/* Parse /proc/<pid>/stat, returns false if the process should be skipped */
+static bool proc_entry_read_stat(const struct proc_snapshot *snapshot, struct proc_entry *entry)
+{
+	char buf[PATH_MAX], *tmp;
+	int fd, len, pgrp, tpgid;
+	unsigned flags;
+	unsigned long minflt, cminflt, majflt, cmajflt;
+	long cutime, cstime, cnice, nthreads, itrealvalue;
+
+	fd = proc_entry_open(snapshot, entry, "stat");
+	if (fd < 0)
+		return false;
+	len = read(fd, buf, sizeof buf - 1);
+	close(fd);
+	if (len < 40)
+		return false;
+	buf[len] = 0;
+	tmp = strrchr(buf, ')');
+	if (tmp == NULL)
+		return false;
+	*tmp = 0;
+	memset(entry->comm, 0, sizeof(entry->comm));
+	sscanf(buf, "%*d (%15c", entry->comm);
+	sscanf(tmp+2,	"%c %d %d %d %d %d "
+			"%u %lu %lu %lu %lu "
+			"%lu %lu %lu %ld %ld "
+			"%ld %ld %ld %llu",
+		&entry->state, &entry->ppid, &pgrp, &entry->session, &entry->tty_nr, &tpgid,
+		&flags, &minflt, &cminflt, &majflt, &cmajflt,
+		&entry->utime, &entry->stime, &cutime, &cstime, &entry->priority,
+		&cnice, &nthreads, &itrealvalue, &entry->start
+	);
+
+	// Skip kthreads
+	return entry->ppid != 2;
+}
+
+static void proc_entry_free(struct proc_entry *entry)
+{
+	free(entry->cmdline);
+	free(entry->tty);
+}
+
+static void proc_snapshot_free(struct proc_snapshot *snapshot)
+{
+	for (size_t i = 0; i < snapshot->count; i++)
+		proc_entry_free(&snapshot->entries[i]);
+	free(snapshot->entries);
+	if (snapshot->proc_fd >= 0)
+		close(snapshot->proc_fd);
+	pthread_mutex_destroy(&snapshot->lock);
+	free(snapshot);
+}
+
+static int proc_entry_cmp(const void *a, const void *b)
+{
+	const struct proc_entry *ea = a, *eb = b;
+
+	return (ea->pid > eb->pid) - (ea->pid < eb->pid);
+}
+
+static struct proc_snapshot *proc_snapshot_read(void)
+{
+	struct proc_snapshot *snapshot;
+	struct dirent *ent;
+	char path[PATH_MAX];
+	size_t alloc = 0;
+	int proc_fd, dir_fd;
+	DIR *d;
+
+	const char *prefix = getenv("OSCAP_PROBE_ROOT");
+	snprintf(path, PATH_MAX, "%s/proc", prefix ? prefix : "");
+	proc_fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (proc_fd < 0)
+		return NULL;
+	dir_fd = dup(proc_fd);
+	d = dir_fd < 0 ? NULL : fdopendir(dir_fd);
+	if (d == NULL) {
+		int err = errno;
+		if (dir_fd >= 0)
+			close(dir_fd);
+		close(proc_fd);
+		errno = err;
+		return NULL;
+	}
+
+	snapshot = calloc(1, sizeof(struct proc_snapshot));
+	snapshot->proc_fd = proc_fd;
+	snapshot->refs = 1;
+	pthread_mutex_init(&snapshot->lock, NULL);
+	snapshot->boot = proc_snapshot_read_boot_time(proc_fd);
+
+	while ((ent = readdir(d)) != NULL) {
+		struct proc_entry *entry;
+		int pid;
+
+		// Skip non-process dir entries
+		if (*ent->d_name < '0' || *ent->d_name > '9')
+			continue;
+		errno = 0;
+		pid = strtol(ent->d_name, NULL, 10);
+		if (errno || pid == 2) // skip err & kthreads
+			continue;
+
+		if (snapshot->count == alloc) {
+			void *new_entries;
+
+			alloc = alloc == 0 ? 512 : alloc * 2;
+			new_entries = realloc(snapshot->entries, alloc * sizeof(struct proc_entry));
+			if (new_entries == NULL) {
+				dE("Unable to allocate memory for the process table");
+				break;
+			}
+			snapshot->entries = new_entries;
+		}
+		entry = &snapshot->entries[snapshot->count];
+		memset(entry, 0, sizeof(*entry));
+		entry->pid = pid;
+		if (proc_entry_read_stat(snapshot, entry))
+			snapshot->count++;
+	}
+	closedir(d);
+
+	qsort(snapshot->entries, snapshot->count, sizeof(struct proc_entry), proc_entry_cmp);
+	dD("Read %zu processes from '%s'.", snapshot->count, path);
+	return snapshot;
+}
+
+void proc_snapshot_acquire(void)
+{
+	pthread_mutex_lock(&proc_snapshot_mutex);
+	proc_snapshot_users++;
+	pthread_mutex_unlock(&proc_snapshot_mutex);
+}
+
+void proc_snapshot_release(void)
+{
+	struct proc_snapshot *snapshot = NULL;
+
+	pthread_mutex_lock(&proc_snapshot_mutex);
+	if (proc_snapshot_users > 0 && --proc_snapshot_users == 0) {
+		snapshot = proc_snapshot_current;
+		proc_snapshot_current = NULL;
+	}
+	pthread_mutex_unlock(&proc_snapshot_mutex);
+	proc_snapshot_put(snapshot);
+}
+
+struct proc_snapshot *proc_snapshot_get(void)
+{
+	struct proc_snapshot *snapshot, *stale = NULL;
+	unsigned long generation = oval_walk_cache_generation();
+	int err = 0;
+
+	pthread_mutex_lock(&proc_snapshot_mutex);
+	if (proc_snapshot_current != NULL && proc_snapshot_current->generation != generation) {
+		dD("A new scan has started, reading the process table again.");
+		stale = proc_snapshot_current;
+		proc_snapshot_current = NULL;
+	}
+	if (proc_snapshot_current == NULL) {
+		proc_snapshot_current = proc_snapshot_read();
+		if (proc_snapshot_current != NULL)
+			proc_snapshot_current->generation = generation;
+		else
+			err = errno;
+	}
+	snapshot = proc_snapshot_current;
+	if (snapshot != NULL)
+		snapshot->refs++;
+	/* Without a registered user the snapshot lives as long as its references */
+	if (proc_snapshot_users == 0 && snapshot != NULL) {
+		proc_snapshot_current = NULL;
+		snapshot->refs--;
+	}
+	pthread_mutex_unlock(&proc_snapshot_mutex);
+
+	proc_snapshot_put(stale);
+	if (snapshot == NULL)
+		errno = err;
+	return snapshot;
+}
+
+void proc_snapshot_put(struct proc_snapshot *snapshot)
+{
+	bool last;
+
+	if (snapshot == NULL)
+		return;
+	pthread_mutex_lock(&proc_snapshot_mutex);
+	last = --snapshot->refs == 0;
+	pthread_mutex_unlock(&proc_snapshot_mutex);
+	if (last)
+		proc_snapshot_free(snapshot);
+}
+
+size_t proc_snapshot_entries(struct proc_snapshot *snapshot, struct proc_entry **entries)
+{
+	*entries = snapshot->entries;
+	return snapshot->count;
+}
+
+unsigned long proc_snapshot_boot_time(const struct proc_snapshot *snapshot)
+{
+	return snapshot->boot;
+}
+
+static char *proc_entry_read_cmdline(const struct proc_snapshot *snapshot, const struct proc_entry *entry)
+{
+	char *cmdline = NULL;
+	size_t length = 0, alloc = 0;
+	int fd = proc_entry_open(snapshot, entry, "cmdline");
+
+	if (fd < 0)
+		return NULL;
+
+	for (;;) {
+		ssize_t read_size;
+
+		if (alloc - length < 1024) {
+			char *new_cmdline;
+
+			alloc = alloc == 0 ? 1024 : alloc * 2;
+			new_cmdline = realloc(cmdline, alloc + 1);
+			if (new_cmdline == NULL) {
+				free(cmdline);
+				close(fd);
+				return NULL;
+			}
+			cmdline = new_cmdline;
+		}
+		read_size = read(fd, cmdline + length, alloc - length);
+		if (read_size < 0) {
+			free(cmdline);
+			close(fd);
+			return NULL;
+		}
+		if (read_size == 0)
+			break;
+		length += read_size;
+	}
+	close(fd);
+
+	if (length == 0) { // empty file
+		free(cmdline);
+		return NULL;
+	}
+	cmdline[length] = '\0';
+
+	// Skip multiple trailing zeros
+	ssize_t i = length - 1;
+	while ((i > 0) && (cmdline[i] == '\0'))
+		--i;
+
+	// Program and args are separated by '\0'
+	// Replace them with spaces ' '
+	while (i >= 0) {
+		char chr = cmdline[i];
+		if ((chr == '\0') || (chr == '\n')) {
+			cmdline[i] = ' ';
+		} else if (!isprint(chr)) { // "ps" replace non-printable characters with '.' (LC_ALL=C)
+			cmdline[i] = '.';
+		}
+		--i;
+	}
+	return cmdline;
+}
+
+const char *proc_entry_cmdline(struct proc_snapshot *snapshot, struct proc_entry *entry)
+{
+	pthread_mutex_lock(&snapshot->lock);
+	if (!(entry->loaded & PROC_ENTRY_CMDLINE)) {
+		entry->cmdline = proc_entry_read_cmdline(snapshot, entry);
+		entry->loaded |= PROC_ENTRY_CMDLINE;
+	}
+	pthread_mutex_unlock(&snapshot->lock);
+	return entry->cmdline;
+}
+
+#if !defined(HAVE_PROC_DEVNAME_H) || !defined(HAVE_DEV_TO_TTY)
+/*
+ * Name the terminal by its device number the way dev_to_tty() of procps
+ * abbreviates the common ones, "?" if the process has none.
+ */
+static void proc_tty_name(char *buf, size_t size, unsigned int tty_nr)
+{
+	unsigned int maj = major(tty_nr), min = minor(tty_nr);
+
+	if (tty_nr == 0)
+		snprintf(buf, size, "?");
+	else if (maj >= 136 && maj <= 143)
+		snprintf(buf, size, "pts/%u", min + (maj - 136) * 256);
+	else if (maj == 4 && min < 64)
+		snprintf(buf, size, "tty%u", min);
+	else if (maj == 4)
+		snprintf(buf, size, "ttyS%u", min - 64);
+	else
+		snprintf(buf, size, "%u:%u", maj, min);
+}
+#endif
+
+const char *proc_entry_tty(struct proc_snapshot *snapshot, struct proc_entry *entry)
+{
+	pthread_mutex_lock(&snapshot->lock);
+	if (!(entry->loaded & PROC_ENTRY_TTY)) {
+		char tty_dev[128];
+
+#if defined(HAVE_PROC_DEVNAME_H) && defined(HAVE_DEV_TO_TTY)
+		/* dev_to_tty() isn't reentrant, the snapshot lock serializes it */
+		dev_to_tty(tty_dev, sizeof(tty_dev), (dev_t) entry->tty_nr, entry->pid, ABBREV_DEV);
+#else
+		proc_tty_name(tty_dev, sizeof(tty_dev), entry->tty_nr);
+#endif
+		entry->tty = strdup(tty_dev);
+		entry->loaded |= PROC_ENTRY_TTY;
+	}
+	pthread_mutex_unlock(&snapshot->lock);
+	return entry->tty;
+}
+
+static void proc_entry_read_uids(const struct proc_snapshot *snapshot, struct proc_entry *entry)
+{
+	char buf[PATH_MAX];
+	FILE *sf;
+
+	entry->ruid = -1;
+	entry->euid = -1;
+	entry->loginuid = -1;
+
+	sf = proc_entry_fopen(snapshot, entry, "status");
+	if (sf) {
+		int line = 0;
+		while (fgets(buf, sizeof(buf), sf)) {
+			if (line == 0) {
+				line++;
+				continue;
+			}
+			if (memcmp(buf, "Uid:", 4) == 0) {
+				sscanf(buf, "Uid: %d %d", &entry->ruid, &entry->euid);
+				break;
+			}
+		}
+		fclose(sf);
+	}
+
+	sf = proc_entry_fopen(snapshot, entry, "loginuid");
+	if (sf) {
+		if (fscanf(sf, "%u", &entry->loginuid) < 1) {
+			dW("fscanf failed from /proc/%d/loginuid", entry->pid);
+		}
+		fclose(sf);
+	}
+}
+
+void proc_entry_uids(struct proc_snapshot *snapshot, struct proc_entry *entry,
+		int *ruid, int *euid, unsigned int *loginuid)
+{
+	pthread_mutex_lock(&snapshot->lock);
+	if (!(entry->loaded & PROC_ENTRY_UIDS)) {
+		proc_entry_read_uids(snapshot, entry);
+		entry->loaded |= PROC_ENTRY_UIDS;
+	}
+	pthread_mutex_unlock(&snapshot->lock);
+	*ruid = entry->ruid;
+	*euid = entry->euid;
+	*loginuid = entry->loginuid;
+}
+
+/* get exec shield status according to http://people.redhat.com/sgrubb/files/lsexec */
+static int proc_entry_read_exec_shield(const struct proc_snapshot *snapshot, const struct proc_entry *entry)
+{
+	char buf[PATH_MAX];
+	FILE *sf;
+	long unsigned low, high, inode;
+	long long unsigned offset;
+	int dev_min, dev_maj;
+	char perm[3], trim;
+	int ret = -1, read_items;
+
+	sf = proc_entry_fopen(snapshot, entry, "maps");
+	if (sf) {
+		while (fgets(buf, 500, sf)) {
+			read_items = sscanf(
+				buf, "%lx-%lx rw%s %llx %x:%x %lu %c\n",
+				&low, &high, perm, &offset, &dev_min,
+				&dev_maj, &inode, &trim
+			);
+			if (read_items == 7) {
+				if (perm[0] == 'x' && offset != 0) {
+					ret = 0;
+				}
+				else {
+					ret = 1;
+				}
+			}
+		}
+		fclose(sf);
+	}
+
+	return ret;
+}
+
+int proc_entry_exec_shield(struct proc_snapshot *snapshot, struct proc_entry *entry)
+{
+	pthread_mutex_lock(&snapshot->lock);
+	if (!(entry->loaded & PROC_ENTRY_EXEC_SHIELD)) {
+		entry->exec_shield = proc_entry_read_exec_shield(snapshot, entry);
+		entry->loaded |= PROC_ENTRY_EXEC_SHIELD;
+	}
+	pthread_mutex_unlock(&snapshot->lock);
+	return entry->exec_shield;
+}
+
+#endif /* OS_LINUX */
@@ -0,0 +1,119 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+#ifndef OPENSCAP_PROC_SNAPSHOT_H
+#define OPENSCAP_PROC_SNAPSHOT_H
+
+#include "oscap_platforms.h"
+
+#if defined(OS_LINUX)
+
+#include <stddef.h>
+
+/**
+ * A process in the snapshot. The fields parsed from /proc/<pid>/stat are
+ * filled when the snapshot is read, the others are read on the first call
+ * of their proc_entry_*() function.
+ */
+struct proc_entry {
+	int pid;
+	int ppid;
+	int session;
+	int tty_nr;
+	char state;
+	char comm[16];		/**< command name, at most 15 characters */
+	long priority;
+	unsigned long utime;	/**< in clock ticks */
+	unsigned long stime;
+	unsigned long long start; /**< clock ticks after boot */
+
+	unsigned int loaded;	/**< PROC_ENTRY_* flags of the fields read so far */
+	char *cmdline;
+	char *tty;
+	int ruid;
+	int euid;
+	unsigned int loginuid;
+	int exec_shield;
+};
+
+/**
+ * Snapshot of the process table shared by the process probes. The table
+ * is read once per scan, i.e. again after the probe session is reset or
+ * the system is changed by a remediation (oval_probe_system_changed()).
+ * Kernel threads aren't included.
+ */
+struct proc_snapshot;
+
+/**
+ * Register a probe as a user of the snapshot, called by probe_init
+ */
+void proc_snapshot_acquire(void);
+
+/**
+ * Unregister a probe, the snapshot is dropped with the last user
+ */
+void proc_snapshot_release(void);
+
+/**
+ * Get a reference to the snapshot of $OSCAP_PROBE_ROOT/proc.
+ * Returns NULL with errno set if the directory can't be opened.
+ */
+struct proc_snapshot *proc_snapshot_get(void);
+
+/**
+ * Drop a reference returned by proc_snapshot_get()
+ */
+void proc_snapshot_put(struct proc_snapshot *snapshot);
+
+/**
+ * Return the processes of the snapshot, ordered by PID
+ */
+size_t proc_snapshot_entries(struct proc_snapshot *snapshot, struct proc_entry **entries);
+
+/**
+ * Return the boot time in seconds since the epoch, 0 if it's unknown
+ */
+unsigned long proc_snapshot_boot_time(const struct proc_snapshot *snapshot);
+
+/**
+ * Return the command line with the arguments separated by spaces and the
+ * non-printable characters replaced by dots, like ps(1) shows it. Returns
+ * NULL if the command line is empty or can't be read.
+ */
+const char *proc_entry_cmdline(struct proc_snapshot *snapshot, struct proc_entry *entry);
+
+/**
+ * Return the name of the controlling terminal, "?" if there is none
+ */
+const char *proc_entry_tty(struct proc_snapshot *snapshot, struct proc_entry *entry);
+
+/**
+ * Read the real and effective UID and the login UID of the process,
+ * the values which can't be read are set to -1
+ */
+void proc_entry_uids(struct proc_snapshot *snapshot, struct proc_entry *entry,
+		int *ruid, int *euid, unsigned int *loginuid);
+
+/**
+ * Return the exec shield status: -1 not detected, 0 disabled, 1 enabled
+ */
+int proc_entry_exec_shield(struct proc_snapshot *snapshot, struct proc_entry *entry);
+
+#endif /* OS_LINUX */
+
+#endif /* OPENSCAP_PROC_SNAPSHOT_H */
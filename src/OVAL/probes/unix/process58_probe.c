@@ -102,12 +102,10 @@ extern char const *_cap_names[];
 #include "probe/entcmp.h"
 #include "common/debug_priv.h"
 #include <ctype.h>
-#include "common/oscap_buffer.h"
 #include "process58_probe.h"
+#include "proc-snapshot.h"
 #include "oscap_helpers.h"
 
-#define CHUNK_SIZE 1024
-
 /* Convenience structure for the results being reported */
 struct result_info {
         const char *command_line;
@@ -154,77 +152,6 @@ static void report_finding(struct result_info *res, probe_ctx *ctx)
 
 #if defined(OS_LINUX)
 
-static unsigned long ticks, boot;
-
-static void get_boot_time(void)
-{
-	char buf[PATH_MAX];
-	FILE *sf;
-	int line;
-
-	boot = 0;
-	const char *prefix = getenv("OSCAP_PROBE_ROOT");
-	snprintf(buf, sizeof(buf), "%s/proc/stat", prefix ? prefix : "");
-	sf = fopen(buf, "rt");
-	if (sf == NULL)
-		return;
-
-	line = 0;
-	__fsetlocking(sf, FSETLOCKING_BYCALLER);
-	while (fgets(buf, sizeof(buf), sf)) {
-		if (line == 0) {
-			line++;
-			continue;
-		}
-		if (memcmp(buf, "btime", 5) == 0) {
-			sscanf(buf, "btime %lu", &boot);
-			break;
-		}
-	}
-	fclose(sf);
-}
-
-static int get_uids(int pid, struct result_info *r)
-{
-	char buf[PATH_MAX];
-	FILE *sf;
-
-	r->ruid = -1;
-	r->user_id = -1;
-	r->loginuid = -1;
-
-	const char *prefix = getenv("OSCAP_PROBE_ROOT");
-
-	snprintf(buf, sizeof(buf), "%s/proc/%d/status", prefix ? prefix : "", pid);
-	sf = fopen(buf, "rt");
-	if (sf) {
-		int line = 0;
-		__fsetlocking(sf, FSETLOCKING_BYCALLER);
-		while (fgets(buf, sizeof(buf), sf)) {
-			if (line == 0) {
-				line++;
-				continue;
-			}
-			if (memcmp(buf, "Uid:", 4) == 0) {
-				sscanf(buf, "Uid: %d %d", &r->ruid, &r->user_id);
-				break;
-			}
-		}
-		fclose(sf);
-	}
-
-	snprintf(buf, sizeof(buf), "%s/proc/%d/loginuid", prefix ? prefix : "", pid);
-	sf = fopen(buf, "rt");
-	if (sf) {
-		if (fscanf(sf, "%u", &r->loginuid) < 1) {
-			dW("fscanf failed from %s", buf);
-		}
-		fclose(sf);
-	}
-
-	return 0;
-}
-
 static char *convert_time(unsigned long long t, char *tbuf, int tb_size)
 {
 	unsigned d,h,m,s;
@@ -356,106 +283,6 @@ exit:
 #endif
 }
 
-/* get exec shield status according to http://people.redhat.com/sgrubb/files/lsexec
- * return value: -1 - not detected, 0 - disabled, 1 - enabled */
-static int get_exec_shield_status(int pid) {
-	char buf[PATH_MAX];
-	FILE *sf;
-	long unsigned low, high, inode;
-	long long unsigned offset;
-	int dev_min, dev_maj;
-	char perm[3], trim;
-	int ret = -1, read_items;
-
-	const char *prefix = getenv("OSCAP_PROBE_ROOT");
-	snprintf(buf, sizeof(buf), "%s/proc/%d/maps", prefix ? prefix : "", pid);
-	sf = fopen(buf, "rt");
-	if (sf) {
-		while (fgets(buf, 500, sf)) {
-			read_items = sscanf(
-				buf, "%lx-%lx rw%s %llx %x:%x %lu %c\n",
-				&low, &high, perm, &offset, &dev_min,
-				&dev_maj, &inode, &trim
-			);
-			if (read_items == 7) {
-				if (perm[0] == 'x' && offset != 0) {
-					ret = 0;
-				}
-				else {
-					ret = 1;
-				}
-			}
-		}
-		fclose(sf);
-	}
-
-	return ret;
-}
-
-/**
- * Parse /proc/%d/cmdline file
- * @param filepath Path to file ~ use preallocated buffer for the path
- * @param buffer output buffer with non-zero size
- * @return ps-like command info or NULL
- */
-static inline bool get_process_cmdline(const char* filepath, struct oscap_buffer* const buffer){
-
-	int fd = open(filepath, O_RDONLY, 0);
-
-	if (fd < 0) {
-		return false;
-	}
-
-	oscap_buffer_clear(buffer);
-
-
-
-	for(;;) {
-		char chunk[CHUNK_SIZE];
-		// Read data, store to buffer
-		ssize_t read_size = read(fd, chunk, CHUNK_SIZE);
-		if (read_size < 0) {
-			close(fd);
-			return false;
-		}
-		oscap_buffer_append_binary_data(buffer, chunk, read_size);
-
-		// If reach end of file, then end the loop
-		if (CHUNK_SIZE != read_size) {
-			break;
-		}
-	}
-
-	close(fd);
-
-	int length = oscap_buffer_get_length(buffer);
-	char* buffer_mem = oscap_buffer_get_raw(buffer);
-
-	if ( length == 0 ) { // empty file
-		return false;
-	} else {
-
-		// Skip multiple trailing zeros
-		int i = length - 1;
-		while ( (i > 0) && (buffer_mem[i] == '\0') ) {
-			--i;
-		}
-
-		// Program and args are separated by '\0'
-		// Replace them with spaces ' '
-		while( i >= 0 ){
-			char chr = buffer_mem[i];
-			if ( ( chr == '\0') || ( chr == '\n' ) ) {
-				buffer_mem[i] = ' ';
-			} else if ( !isprint(chr) ) { // "ps" replace non-printable characters with '.' (LC_ALL=C)
-				buffer_mem[i] = '.';
-			}
-			--i;
-		}
-	}
-	return true;
-}
-
 /**
  * Make "[%s] <defunct>" from cmd string - inplace
  * @param cmd_buffer @see read_process() > cmd_buffer
@@ -471,22 +298,22 @@ static inline char *make_defunc_str(char* const cmd_buffer){
 
 static int read_process(SEXP_t *cmd_ent, SEXP_t *pid_ent, probe_ctx *ctx)
 {
-	char buf[PATH_MAX];
 	int max_cap_id;
-	DIR *d;
-	struct dirent *ent;
+	unsigned long ticks, boot;
+	struct proc_snapshot *snapshot;
+	struct proc_entry *entries;
+	size_t count, i;
 	oval_schema_version_t oval_version;
 
 	const char *prefix = getenv("OSCAP_PROBE_ROOT");
-	snprintf(buf, PATH_MAX, "%s/proc", prefix ? prefix : "");
-	d = opendir(buf);
-	if (d == NULL) {
+	snapshot = proc_snapshot_get();
+	if (snapshot == NULL) {
 		return prefix ? PROBE_ESUCCESS : PROBE_EACCESS;
 	}
 
 	// Get the time tick hertz
 	ticks = (unsigned long)sysconf(_SC_CLK_TCK);
-	get_boot_time();
+	boot = proc_snapshot_boot_time(snapshot);
 
 	oval_version = probe_obj_get_platform_schema_version(probe_ctx_getobject(ctx));
 	if (oval_schema_version_cmp(oval_version, OVAL_SCHEMA_VERSION(5.11)) < 0) {
@@ -495,82 +322,37 @@ static int read_process(SEXP_t *cmd_ent, SEXP_t *pid_ent, probe_ctx *ctx)
 		max_cap_id = OVAL_5_11_MAX_CAP_ID;
 	}
 
-	struct oscap_buffer *cmdline_buffer = oscap_buffer_new();
-	
 	char cmd_buffer[1 + 15 + 11 + 1]; // Format:" [ cmd:15 ] <defunc>"
 	cmd_buffer[0] = '[';
 
-	// Scan the directories
-	bool any_pid_dir_found = false;
-	while (( ent = readdir(d) )) {
-		int fd, len;
-		char *tmp, state, tty_dev[128];
-		int pid, ppid, pgrp, session, tty_nr, tpgid;
-		unsigned flags, sched_policy;
-		unsigned long minflt, cminflt, majflt, cmajflt, uutime, ustime;
-		long cutime, cstime, priority, cnice, nthreads, itrealvalue;
-		unsigned long long start;
+	// Scan the process table
+	count = proc_snapshot_entries(snapshot, &entries);
+	for (i = 0; i < count; i++) {
+		struct proc_entry *pe = &entries[i];
+		unsigned sched_policy;
 		SEXP_t *cmd_sexp = NULL, *pid_sexp = NULL;
 
-		// Skip non-process58 dir entries
-		if(*ent->d_name<'0' || *ent->d_name>'9')
-			continue;
-		errno = 0;
-		pid = strtol(ent->d_name, NULL, 10);
-		if (errno || pid == 2) // skip err & kthreads
-			continue;
-
-		// Parse up the stat file for the proc
-		snprintf(buf, PATH_MAX, "%s/proc/%d/stat", prefix ? prefix : "", pid);
-		fd = open(buf, O_RDONLY, 0);
-		if (fd < 0)
-			continue;
-		len = read(fd, buf, sizeof buf - 1);
-		close(fd);
-		if (len < 40)
-			continue;
-		buf[len] = 0;
-		tmp = strrchr(buf, ')');
-		if (tmp)
-			*tmp = 0;
-		else
-			continue;
-		memset(cmd_buffer + 1, 0, sizeof(cmd_buffer)-1); // clear cmd after starting '['
-		sscanf(buf, "%d (%15c", &ppid, cmd_buffer + 1);
-		sscanf(tmp+2,	"%c %d %d %d %d %d "
-				"%u %lu %lu %lu %lu "
-				"%lu %lu %lu %ld %ld "
-				"%ld %ld %ld %llu",
-			&state, &ppid, &pgrp, &session, &tty_nr, &tpgid,
-			&flags, &minflt, &cminflt, &majflt, &cmajflt,
-			&uutime, &ustime, &cutime, &cstime, &priority,
-			&cnice, &nthreads, &itrealvalue, &start
-		);
-
-		// Skip kthreads
-		if (ppid == 2)
+		// The pid is cheap to check, the command line is read only if it matches
+		pid_sexp = SEXP_number_newu_32(pe->pid);
+		if (pid_sexp != NULL && probe_entobj_cmp(pid_ent, pid_sexp) != OVAL_RESULT_TRUE) {
+			SEXP_free(pid_sexp);
 			continue;
+		}
 
 		const char* cmd;
-		if (state == 'Z') { // zombie
+		strcpy(cmd_buffer + 1, pe->comm);
+		if (pe->state == 'Z') { // zombie
 			cmd = make_defunc_str(cmd_buffer);
 		} else {
-			snprintf(buf, PATH_MAX, "%s/proc/%d/cmdline", prefix ? prefix : "", pid);
-			if (get_process_cmdline(buf, cmdline_buffer)) {
-				cmd = oscap_buffer_get_raw(cmdline_buffer); // use full cmdline
-			} else {
+			cmd = proc_entry_cmdline(snapshot, pe); // use full cmdline
+			if (cmd == NULL)
 				cmd = cmd_buffer + 1;
-			}
 		}
 
-		any_pid_dir_found = true;
 		cmd_sexp = SEXP_string_newf("%s", cmd);
-		pid_sexp = SEXP_number_newu_32(pid);
-		if ((cmd_sexp == NULL || probe_entobj_cmp(cmd_ent, cmd_sexp) == OVAL_RESULT_TRUE) &&
-		    (pid_sexp == NULL || probe_entobj_cmp(pid_ent, pid_sexp) == OVAL_RESULT_TRUE)
-		) {
+		if (cmd_sexp == NULL || probe_entobj_cmp(cmd_ent, cmd_sexp) == OVAL_RESULT_TRUE) {
 			struct result_info r;
-			unsigned long t = uutime/ticks + ustime/ticks;
+			unsigned long t = pe->utime/ticks + pe->stime/ticks;
 			char tbuf[32], sbuf[32], *selinux_domain_label, **posix_capabilities;
 			int tday,tyear;
 			time_t s_time;
@@ -578,7 +360,7 @@ static int read_process(SEXP_t *cmd_ent, SEXP_t *pid_ent, probe_ctx *ctx)
 			const char *fmt;
 
 			// Now get scheduler policy
-			sched_policy = sched_getscheduler(pid);
+			sched_policy = sched_getscheduler(pe->pid);
 			switch (sched_policy) {
 				case SCHED_OTHER:
 					r.scheduling_class = "TS";
@@ -607,7 +389,7 @@ static int read_process(SEXP_t *cmd_ent, SEXP_t *pid_ent, probe_ctx *ctx)
 			now = localtime(&s_time);
 			tyear = now->tm_year;
 			tday = now->tm_yday;
-			s_time = boot + (start / ticks);
+			s_time = boot + (pe->start / ticks);
 			proc = localtime(&s_time);
 
 			// Select format based on how long we've been running
@@ -625,25 +407,24 @@ static int read_process(SEXP_t *cmd_ent, SEXP_t *pid_ent, probe_ctx *ctx)
 
 			r.command_line = cmd;
 			r.exec_time = convert_time(t, tbuf, sizeof(tbuf));
-			r.pid = pid;
-			r.ppid = ppid;
-			r.priority = priority;
+			r.pid = pe->pid;
+			r.ppid = pe->ppid;
+			r.priority = pe->priority;
 			r.start_time = sbuf;
 
-			dev_to_tty(tty_dev, sizeof(tty_dev), (dev_t) tty_nr, pid, ABBREV_DEV);
-			r.tty = tty_dev;
+			r.tty = proc_entry_tty(snapshot, pe);
 
-			r.exec_shield = (get_exec_shield_status(pid) > 0);
+			r.exec_shield = (proc_entry_exec_shield(snapshot, pe) > 0);
 
-			selinux_domain_label = get_selinux_label(pid);
+			selinux_domain_label = get_selinux_label(pe->pid);
 			r.selinux_domain_label = selinux_domain_label;
 
-			posix_capabilities = get_posix_capability(pid, max_cap_id);
+			posix_capabilities = get_posix_capability(pe->pid, max_cap_id);
 			r.posix_capability = posix_capabilities;
 
-			r.session_id = session;
+			r.session_id = pe->session;
 
-			get_uids(pid, &r);
+			proc_entry_uids(snapshot, pe, &r.ruid, &r.user_id, &r.loginuid);
 			report_finding(&r, ctx);
 
 			if (selinux_domain_label != NULL)
@@ -659,18 +440,17 @@ static int read_process(SEXP_t *cmd_ent, SEXP_t *pid_ent, probe_ctx *ctx)
 		SEXP_free(cmd_sexp);
 		SEXP_free(pid_sexp);
 	}
-        closedir(d);
-	oscap_buffer_free(cmdline_buffer);
+	proc_snapshot_put(snapshot);
 
-	if (!any_pid_dir_found) {
-		dW("No data about processes could be read from '%s'.", buf);
+	if (count == 0) {
+		dW("No data about processes could be read from '%s/proc'.", prefix ? prefix : "");
 	}
 	// In offline mode, empty /proc might be a normal situation and doesn't
 	// have to mean permissions problems
 	if (prefix)
 		return PROBE_ESUCCESS;
 	else
-		return any_pid_dir_found ? PROBE_ESUCCESS : PROBE_EACCESS;
+		return count > 0 ? PROBE_ESUCCESS : PROBE_EACCESS;
 }
 
 int process58_probe_offline_mode_supported(void)
@@ -678,6 +458,17 @@ int process58_probe_offline_mode_supported(void)
 	return PROBE_OFFLINE_OWN;
 }
 
+void *process58_probe_init(void)
+{
+	proc_snapshot_acquire();
+	return NULL;
+}
+
+void process58_probe_fini(void *arg)
+{
+	proc_snapshot_release();
+}
+
 int process58_probe_main(probe_ctx *ctx, void *arg)
 {
 	SEXP_t *command_line_ent, *pid_ent;
@@ -858,3 +649,14 @@ int process58_probe_main(probe_ctx *ctx, void *arg)
 	return 0;
 }
 #endif /* __linux */
+
+#if !defined(OS_LINUX)
+void *process58_probe_init(void)
+{
+	return NULL;
+}
+
+void process58_probe_fini(void *arg)
+{
+}
+#endif
@@ -56,6 +56,7 @@
 #include "probe/entcmp.h"
 #include "common/debug_priv.h"
 #include "process_probe.h"
+#include "proc-snapshot.h"
 #include "oscap_helpers.h"
 
 #if defined(OS_FREEBSD)
@@ -120,63 +121,6 @@ static void report_finding(struct result_info *res, probe_ctx *ctx)
 
 #if defined(OS_LINUX)
 
-static unsigned long ticks, boot;
-
-static void get_boot_time(void)
-{
-	char buf[100];
-	FILE *sf;
-	int line;
-
-	boot = 0;
-	sf = fopen("/proc/stat", "rt");
-	if (sf == NULL)
-		return;
-
-	line = 0;
-	__fsetlocking(sf, FSETLOCKING_BYCALLER);
-	while (fgets(buf, sizeof(buf), sf)) {
-		if (line == 0) {
-			line++;
-			continue;
-		}
-		if (memcmp(buf, "btime", 5) == 0) {
-			sscanf(buf, "btime %lu", &boot);
-			break;
-		}
-	}
-	fclose(sf);
-}
-
-static int get_uids(int pid, struct result_info *r)
-{
-	char buf[100];
-	FILE *sf;
-
-	r->ruid = -1;
-	r->user_id = -1;
-
-	snprintf(buf, sizeof(buf), "/proc/%d/status", pid);
-	sf = fopen(buf, "rt");
-	if (sf) {
-		int line = 0;
-		__fsetlocking(sf, FSETLOCKING_BYCALLER);
-		while (fgets(buf, sizeof(buf), sf)) {
-			if (line == 0) {
-				line++;
-				continue;
-			}
-			if (memcmp(buf, "Uid:", 4) == 0) {
-				sscanf(buf, "Uid: %d %d", &r->ruid, &r->user_id);
-				break;
-			}
-		}
-		fclose(sf);
-	}
-
-	return 0;
-}
-
 static char *convert_time(unsigned long long t, char *tbuf, int tb_size)
 {
 	unsigned d,h,m,s;
@@ -197,83 +141,40 @@ static char *convert_time(unsigned long long t, char *tbuf, int tb_size)
 
 static int read_process(SEXP_t *cmd_ent, probe_ctx *ctx)
 {
-	int err = 1;
-	DIR *d;
-	struct dirent *ent;
+	unsigned long ticks, boot;
+	struct proc_snapshot *snapshot;
+	struct proc_entry *entries;
+	size_t count, i;
 
-	d = opendir("/proc");
-	if (d == NULL)
-		return err;
+	snapshot = proc_snapshot_get();
+	if (snapshot == NULL)
+		return 1;
 
 	// Get the time tick hertz
 	ticks = (unsigned long)sysconf(_SC_CLK_TCK);
-	get_boot_time();
+	boot = proc_snapshot_boot_time(snapshot);
 
-	// Scan the directories
-	while (( ent = readdir(d) )) {
-		int fd, len;
-		char buf[256];
-		char *tmp, cmd[16], state, tty_dev[128];
-		int pid, ppid, pgrp, session, tty_nr, tpgid;
-		unsigned flags, sched_policy;
-		unsigned long minflt, cminflt, majflt, cmajflt, uutime, ustime;
-		long cutime, cstime, priority, cnice, nthreads, itrealvalue;
-		unsigned long long start;
+	// Scan the process table
+	count = proc_snapshot_entries(snapshot, &entries);
+	for (i = 0; i < count; i++) {
+		struct proc_entry *pe = &entries[i];
+		unsigned sched_policy;
 		SEXP_t *cmd_sexp;
 
-		// Skip non-process dir entries
-		if(*ent->d_name<'0' || *ent->d_name>'9')
-			continue;
-		errno = 0;
-		pid = strtol(ent->d_name, NULL, 10);
-		if (errno || pid == 2) // skip err & kthreads
-			continue;
-
-		// Parse up the stat file for the proc
-		snprintf(buf, 32, "/proc/%d/stat", pid);
-		fd = open(buf, O_RDONLY, 0);
-		if (fd < 0)
-			continue;
-		len = read(fd, buf, sizeof buf - 1);
-		close(fd);
-		if (len < 40)
-			continue;
-		buf[len] = 0;
-		tmp = strrchr(buf, ')');
-		if (tmp)
-			*tmp = 0;
-		else
-			continue;
-		memset(cmd, 0, sizeof(cmd));
-		sscanf(buf, "%d (%15c", &ppid, cmd);
-		sscanf(tmp+2,	"%c %d %d %d %d %d "
-				"%u %lu %lu %lu %lu "
-				"%lu %lu %lu %ld %ld "
-				"%ld %ld %ld %llu",
-			&state, &ppid, &pgrp, &session, &tty_nr, &tpgid,
-			&flags, &minflt, &cminflt, &majflt, &cmajflt,
-			&uutime, &ustime, &cutime, &cstime, &priority,
-			&cnice, &nthreads, &itrealvalue, &start
-		);
-
-		// Skip kthreads
-		if (ppid == 2)
-			continue;
-
-		err = 0; // If we get this far, no permission problems
-		dI("Have command: %s", cmd);
-		cmd_sexp = SEXP_string_newf("%s", cmd);
+		dI("Have command: %s", pe->comm);
+		cmd_sexp = SEXP_string_newf("%s", pe->comm);
 		if (probe_entobj_cmp(cmd_ent, cmd_sexp) == OVAL_RESULT_TRUE) {
 			struct result_info r;
-			unsigned long t = uutime/ticks + ustime/ticks;
+			unsigned long t = pe->utime/ticks + pe->stime/ticks;
 			char tbuf[32], sbuf[32];
 			int tday,tyear;
+			unsigned int loginuid;
 			time_t s_time;
 			struct tm *proc, *now;
 			const char *fmt;
 
 			// Now get scheduler policy
-			sched_policy = sched_getscheduler(pid);
+			sched_policy = sched_getscheduler(pe->pid);
 			switch (sched_policy) {
 				case SCHED_OTHER:
 					r.scheduling_class = "TS";
@@ -302,7 +203,7 @@ static int read_process(SEXP_t *cmd_ent, probe_ctx *ctx)
 			now = localtime(&s_time);
 			tyear = now->tm_year;
 			tday = now->tm_yday;
-			s_time = boot + (start / ticks);
+			s_time = boot + (pe->start / ticks);
 			proc = localtime(&s_time);
 
 			// Select format based on how long we've been running
@@ -318,24 +219,35 @@ static int read_process(SEXP_t *cmd_ent, probe_ctx *ctx)
 				fmt = "%H:%M:%S";
 			strftime(sbuf, sizeof(sbuf), fmt, proc);
 
-			r.command = cmd;
+			r.command = pe->comm;
 			r.exec_time = convert_time(t, tbuf, sizeof(tbuf));
-			r.pid = pid;
-			r.ppid = ppid;
-			r.priority = priority;
+			r.pid = pe->pid;
+			r.ppid = pe->ppid;
+			r.priority = pe->priority;
 			r.start_time = sbuf;
 
-                        dev_to_tty(tty_dev, sizeof(tty_dev), (dev_t) tty_nr, pid, ABBREV_DEV);
-                        r.tty = tty_dev;
+			r.tty = proc_entry_tty(snapshot, pe);
 
-			get_uids(pid, &r);
+			proc_entry_uids(snapshot, pe, &r.ruid, &r.user_id, &loginuid);
 			report_finding(&r, ctx);
 		}
 		SEXP_free(cmd_sexp);
 	}
-        closedir(d);
+	proc_snapshot_put(snapshot);
 
-	return err;
+	// No process could be read, probably a permission problem
+	return count == 0;
+}
+
+void *process_probe_init(void)
+{
+	proc_snapshot_acquire();
+	return NULL;
+}
+
+void process_probe_fini(void *arg)
+{
+	proc_snapshot_release();
 }
 
 int process_probe_main(probe_ctx *ctx, void *arg)
@@ -675,3 +587,14 @@ int process_probe_main(probe_ctx *ctx, void *arg)
 	return 0;
 }
 #endif /* __linux */
+
+#if !defined(OS_LINUX)
+void *process_probe_init(void)
+{
+	return NULL;
+}
+
+void process_probe_fini(void *arg)
+{
+}
+#endif
@@ -25,6 +25,10 @@
 
 #include "probe-api.h"
 
+void *process_probe_init(void);
+
 int process_probe_main(probe_ctx *ctx, void *arg);
 
+void process_probe_fini(void *arg);
+
 #endif /* OPENSCAP_PROCESS_PROBE_H */
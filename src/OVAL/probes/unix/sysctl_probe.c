@@ -49,260 +49,440 @@
 #if defined(OS_LINUX)
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
 #include <string.h>
 #include <ctype.h>
 #include <errno.h>
 #include <limits.h>
 #include <dirent.h>
-#include "oval_fts.h"
+#include <pthread.h>
+#include "oval_fts_walk.h"
 #include "common/debug_priv.h"
 
 #define PROC_SYS_DIR "/proc/sys"
 #define PROC_SYS_MAXDEPTH 7
 
+/*
+ * All readable nodes under /proc/sys sorted by their MIB names. The table
+ * is read once per scan and shared by the objects that can't be looked up
+ * directly.
+ */
+struct sysctl_entry {
+        char *mib;
+        char *path;
+};
+
+struct sysctl_snapshot {
+        struct sysctl_entry *entries;
+        size_t count;
+        unsigned long generation;
+        unsigned int refs;
+};
+
+struct sysctl_probe_global {
+        pthread_mutex_t mutex;
+        struct sysctl_snapshot *snapshot;
+};
+
 int sysctl_probe_offline_mode_supported(void)
 {
         return PROBE_OFFLINE_OWN;
 }
 
-int sysctl_probe_main(probe_ctx *ctx, void *probe_arg)
+static int sysctl_entry_cmp(const void *a, const void *b)
 {
-        OVAL_FTS    *ofts;
-        OVAL_FTSENT *ofts_ent;
+        return strcmp(((const struct sysctl_entry *)a)->mib, ((const struct sysctl_entry *)b)->mib);
+}
 
-        SEXP_t *name_entity, *probe_in;
-        SEXP_t *r0, *r1, *r2, *r3;
-        SEXP_t *ent_attrs, *bh_entity, *path_entity, *filename_entity;
-        oval_schema_version_t over;
-        int over_cmp;
+static void sysctl_snapshot_free(struct sysctl_snapshot *snapshot)
+{
+        for (size_t i = 0; i < snapshot->count; ++i) {
+                free(snapshot->entries[i].mib);
+                free(snapshot->entries[i].path);
+        }
+        free(snapshot->entries);
+        free(snapshot);
+}
 
-        const char *ipv6_conf_path = "/proc/sys/net/ipv6/conf/";
-        size_t ipv6_conf_path_len = strlen(ipv6_conf_path);
+static struct sysctl_snapshot *sysctl_snapshot_read(const char *root)
+{
+        struct sysctl_snapshot *snapshot;
+        OVAL_WALK *walk;
+        OVAL_WALKENT *ent;
+        size_t alloc = 0, rootlen = strlen(root);
 
-        probe_in    = probe_ctx_getobject(ctx);
-        name_entity = probe_obj_getent(probe_in, "name", 1);
-        over        = probe_obj_get_platform_schema_version(probe_in);
-        over_cmp    = oval_schema_version_cmp(over, OVAL_SCHEMA_VERSION(5.10));
+        if ((walk = oval_walk_open(root, 0)) == NULL)
+                return NULL;
 
-        if (name_entity == NULL) {
-                dE("Missing \"name\" entity in the input object");
-                return (PROBE_ENOENT);
+        snapshot = calloc(1, sizeof(struct sysctl_snapshot));
+        snapshot->refs = 1;
+
+        while ((ent = oval_walk_read(walk)) != NULL) {
+                switch (ent->fts_info) {
+                case FTS_SL:
+                        oval_walk_set(walk, ent, FTS_FOLLOW);
+                        continue;
+                case FTS_D:
+                        if (ent->fts_level > PROC_SYS_MAXDEPTH)
+                                oval_walk_set(walk, ent, FTS_SKIP);
+                        continue;
+                case FTS_DC:
+                case FTS_DNR:
+                case FTS_NS:
+                        continue;
+                }
+                if (ent->fts_level == 0)
+                        continue;
+
+                if (snapshot->count == alloc) {
+                        alloc = alloc == 0 ? 2048 : alloc * 2;
+                        snapshot->entries = realloc(snapshot->entries, alloc * sizeof(struct sysctl_entry));
+                }
+
+                struct sysctl_entry *entry = &snapshot->entries[snapshot->count++];
+                entry->path = strdup(ent->fts_path);
+                entry->mib = strdup(ent->fts_path + rootlen + 1);
+                for (char *c = entry->mib; *c != '\0'; ++c) {
+                        if (*c == '/')
+                                *c = '.';
+                }
         }
+        oval_walk_close(walk);
 
-        /*
-         * prepare behaviors
-         */
-        ent_attrs = probe_attr_creat("max_depth",           r0 = SEXP_string_newf("%d", PROC_SYS_MAXDEPTH),
-                                     "recurse_direction",   r1 = SEXP_string_new("down", 4),
-                                     "recurse_file_system", r2 = SEXP_string_new("all", 3),
-                                     "recurse", r3 = SEXP_string_new("symlinks and directories", 24),
-                                     NULL);
-        bh_entity = probe_ent_creat1("behaviors", ent_attrs, NULL);
-        SEXP_free(r0);
-        SEXP_free(r1);
-        SEXP_free(r2);
-        SEXP_free(r3);
-        SEXP_free(ent_attrs);
+        qsort(snapshot->entries, snapshot->count, sizeof(struct sysctl_entry), sysctl_entry_cmp);
+        dD("Read %zu sysctl names from '%s'.", snapshot->count, root);
 
-        /*
-         * prepare path, filename
-         */
-        ent_attrs = probe_attr_creat("operation", r0 = SEXP_number_newi(OVAL_OPERATION_EQUALS),
-                                     NULL);
-        path_entity = probe_ent_creat1("path", ent_attrs, r1 = SEXP_string_new(PROC_SYS_DIR, strlen(PROC_SYS_DIR)));
-        SEXP_free(r0);
-        SEXP_free(r1);
-        SEXP_free(ent_attrs);
-
-        ent_attrs = probe_attr_creat("operation", r0 = SEXP_number_newi(OVAL_OPERATION_PATTERN_MATCH),
-                                     NULL);
-        filename_entity = probe_ent_creat1("filename", ent_attrs, r1 = SEXP_string_new(".*", 2));
-        SEXP_free(r0);
-        SEXP_free(r1);
-        SEXP_free(ent_attrs);
+        return snapshot;
+}
+
+static void sysctl_snapshot_put(struct sysctl_probe_global *g, struct sysctl_snapshot *snapshot)
+{
+        bool last;
+
+        if (snapshot == NULL)
+                return;
+        pthread_mutex_lock(&g->mutex);
+        last = --snapshot->refs == 0;
+        pthread_mutex_unlock(&g->mutex);
+        if (last)
+                sysctl_snapshot_free(snapshot);
+}
+
+/*
+ * Get the snapshot of the current scan, it's read again once the probe
+ * session starts a new scan.
+ */
+static struct sysctl_snapshot *sysctl_snapshot_get(struct sysctl_probe_global *g, const char *root)
+{
+        struct sysctl_snapshot *snapshot, *stale = NULL;
+        unsigned long generation = oval_walk_cache_generation();
+
+        pthread_mutex_lock(&g->mutex);
+        if (g->snapshot != NULL && g->snapshot->generation != generation) {
+                stale = g->snapshot;
+                g->snapshot = NULL;
+        }
+        if (g->snapshot == NULL) {
+                g->snapshot = sysctl_snapshot_read(root);
+                if (g->snapshot != NULL)
+                        g->snapshot->generation = generation;
+        }
+        snapshot = g->snapshot;
+        if (snapshot != NULL)
+                snapshot->refs++;
+        pthread_mutex_unlock(&g->mutex);
+
+        sysctl_snapshot_put(g, stale);
+        return snapshot;
+}
+
+void *sysctl_probe_init(void)
+{
+        struct sysctl_probe_global *g = calloc(1, sizeof(struct sysctl_probe_global));
+
+        pthread_mutex_init(&g->mutex, NULL);
+        return g;
+}
+
+void sysctl_probe_fini(void *probe_arg)
+{
+        struct sysctl_probe_global *g = probe_arg;
+
+        if (g == NULL)
+                return;
+        sysctl_snapshot_put(g, g->snapshot);
+        pthread_mutex_destroy(&g->mutex);
+        free(g);
+}
+
+/*
+ * Find the node of a MIB name without reading the whole tree. Returns 0 and
+ * the path if the name denotes a node, 1 if the name can't be resolved this
+ * way (a component of the path may contain a dot, e.g. a VLAN interface)
+ * and -1 if no node can have such a name.
+ */
+static int sysctl_lookup_direct(const char *root, const char *mib, char *path, size_t path_size)
+{
+        struct stat st;
+        size_t rootlen = strlen(root), miblen = strlen(mib);
+        int depth = 0;
+
+        if (miblen == 0 || mib[0] == '.' || mib[miblen - 1] == '.' ||
+            strchr(mib, '/') != NULL || strstr(mib, "..") != NULL)
+                return -1;
+        if (rootlen + 1 + miblen + 1 > path_size)
+                return 1;
+
+        memcpy(path, root, rootlen);
+        path[rootlen] = '/';
+        for (size_t i = 0; i <= miblen; ++i) {
+                char c = mib[i];
+                if (c == '.') {
+                        c = '/';
+                        ++depth;
+                }
+                path[rootlen + 1 + i] = c;
+        }
+        if (depth > PROC_SYS_MAXDEPTH)
+                return 1;
+        if (stat(path, &st) != 0 || !S_ISREG(st.st_mode))
+                return 1;
+
+        return 0;
+}
+
+static void sysctl_collect(probe_ctx *ctx, const char *mib, const char *mibpath, int over_cmp)
+{
+        FILE   *fp;
+        SEXP_t *item, *se_mib;
+        char    sysval[8192];
+        char   *sysvals[512];
+        long i, l;
+        size_t s;
+        struct stat file_stat;
+
+        /* Skip write-only files, eg. /proc/sys/net/ipv4/route/flush */
+        if (stat(mibpath, &file_stat) == -1) {
+                dE("Stat failed on %s: %u, %s", mibpath, errno, strerror(errno));
+                return;
+        }
+        /* the sysctl utility uses same condition in sysctl.c in ReadSetting() */
+        if ((file_stat.st_mode & S_IRUSR) == 0) {
+                dD("Skipping write-only file %s", mibpath);
+                return;
+        }
+
+        dD("MIB: %s", mib);
+        se_mib = SEXP_string_new(mib, strlen(mib));
 
         /*
-         * collect sysctls
-         *  XXX: use direct access for the "equals" op
+         * read sysctl value
          */
-        const char *prefix = getenv("OSCAP_PROBE_ROOT");
-        ofts = oval_fts_open_prefixed(prefix, path_entity, filename_entity, NULL, bh_entity, probe_ctx_getresult(ctx));
-
-        if (ofts == NULL) {
-                SEXP_free(path_entity);
-                SEXP_free(filename_entity);
-                SEXP_free(bh_entity);
-                SEXP_free(name_entity);
-
-                if (prefix != NULL) {
-                        DIR *d = opendir(prefix);
-                        if (d != NULL) {
-                                closedir(d);
-                                return PROBE_ESUCCESS;
-                        }
-                        dW("Can't open prefix directory '%s': %s", prefix, strerror(errno));
-                }
+        fp = fopen(mibpath, "r");
 
-                dE("oval_fts_open_prefixed(%s, %s, %s, ...) failed", prefix, PROC_SYS_DIR, ".*");
-                return PROBE_EFATAL;
+        if (fp == NULL) {
+                dE("Can't read sysctl value from \"%s\": %u, %s",
+                   mibpath, errno, strerror(errno));
+                goto fail_item;
         }
 
-        while ((ofts_ent = oval_fts_read(ofts)) != NULL) {
-                SEXP_t *se_mib;
-                char    mibpath[PATH_MAX], *mib;
-                size_t  miblen, mibstart;
-                struct stat file_stat;
+        l = fread(sysval, 1, sizeof sysval - 1, fp);
+
+        if (ferror(fp)) {
+                size_t miblen = strlen(mib);
 
-                if (prefix != NULL) {
-                        snprintf(mibpath, sizeof mibpath, "%s/%s/%s", prefix, ofts_ent->path, ofts_ent->file);
+                /* Linux 4.1.0 introduced a per-NIC IPv6 stable_secret file.
+                 * The stable_secret file cannot be read until it is set,
+                 * so we skip it when it is not readable. Otherwise we collect it.
+                 */
+                if (strncmp(mib, "net.ipv6.conf.", 14) == 0 && miblen > 14 &&
+                    strcmp(mib + miblen - 14, ".stable_secret") == 0) {
+                        dD("Skipping file %s", mibpath);
+                        SEXP_free(se_mib);
+                        fclose(fp);
+                        return;
                 } else {
-                        snprintf(mibpath, sizeof mibpath, "%s/%s", ofts_ent->path, ofts_ent->file);
+                        dE("An error occurred when reading from \"%s\" (fp=%p): l=%ld, %u, %s",
+                           mibpath, fp, l, errno, strerror(errno));
+                        goto fail_item;
                 }
+        }
 
-                /* Skip write-only files, eg. /proc/sys/net/ipv4/route/flush */
-                if (stat(mibpath, &file_stat) == -1) {
-                        dE("Stat failed on %s: %u, %s", mibpath, errno, strerror(errno));
-                        oval_ftsent_free(ofts_ent);
-                        continue;
-                }
-                /* the sysctl utility uses same condition in sysctl.c in ReadSetting() */
-                if ((file_stat.st_mode & S_IRUSR) == 0) {
-                        dD("Skipping write-only file %s", mibpath);
-                        oval_ftsent_free(ofts_ent);
-                        continue;
-                }
+        fclose(fp);
 
-                mibstart = 0;
-                mibstart += prefix != NULL ? strlen(prefix)+1 : 0;
-                mibstart += strlen(PROC_SYS_DIR)+1;
-                mib    = strdup(mibpath + mibstart);
-                miblen = strlen(mib);
+        /* Skip empty values as sysctl tool does.
+         * See https://bugzilla.redhat.com/show_bug.cgi?id=1473207
+         */
+        if (l == 0) {
+                dD("Skipping file '%s' because it has no value.", mibpath);
+                SEXP_free(se_mib);
+                return;
+        }
 
-                while (miblen > 0) {
-                        if(mib[miblen - 1] == '/')
-                                mib[miblen - 1] = '.';
-                        --miblen;
+        /*
+         * sanitize the value
+         *  - only printable and whitespace chars allowed
+         *  - remove the last '\n'
+         */
+        sysvals[0] = sysval;
+
+        for(s = 0, i = 0; i < l && s < sizeof sysvals/sizeof(char *) - 1; ++i) {
+                if ((!isprint(sysval[i]) && !isspace(sysval[i]))
+                    || (over_cmp >= 0 && sysval[i] == '\n' /* OVAL 5.10 and above */))
+                {
+                        sysval[i] = '\0';
+                        sysvals[++s] = sysval + i + 1;
                 }
+        }
 
-                dD("MIB: %s", mib);
-                se_mib = SEXP_string_new(mib, strlen(mib));
-                free(mib);
+        if (sysval[l - 1] == '\n')
+                sysval[l - 1] = '\0';
+        else
+                sysval[l] = '\0';
+
+        if (strlen(sysvals[s]) == 0)
+                sysvals[s] = NULL;
+        else
+                sysvals[++s] = NULL;
+
+        if (over_cmp >= 0) {
+                /* Only in OVAL 5.10 and above */
+                item = probe_item_create(OVAL_UNIX_SYSCTL, NULL,
+                                         "name",  OVAL_DATATYPE_SEXP,   se_mib,
+                                         "value", OVAL_DATATYPE_STRING_M, sysvals,
+                                         NULL);
+        } else {
+                item = probe_item_create(OVAL_UNIX_SYSCTL, NULL,
+                                         "name",  OVAL_DATATYPE_SEXP,   se_mib,
+                                         "value", OVAL_DATATYPE_STRING, sysval,
+                                         NULL);
+        }
 
-                if (probe_entobj_cmp(name_entity, se_mib) == OVAL_RESULT_TRUE) {
-                        FILE   *fp;
-                        SEXP_t *item;
-                        char    sysval[8192];
-                        char   *sysvals[512];
-                        long i, l;
-                        size_t s;
-
-                        dD("MIB match");
-
-                        /*
-                         * read sysctl value
-                         */
-                        fp = fopen(mibpath, "r");
-
-                        if (fp == NULL) {
-                                dE("Can't read sysctl value from \"%s\": %u, %s",
-                                   mibpath, errno, strerror(errno));
-                                goto fail_item;
-                        }
+        goto add_item;
+fail_item:
+        item = probe_item_create(OVAL_UNIX_SYSCTL, NULL, NULL);
+        probe_item_setstatus(item, SYSCHAR_STATUS_ERROR);
+add_item:
+        probe_item_collect(ctx, item);
+        SEXP_free(se_mib);
+}
 
-                        l = fread(sysval, 1, sizeof sysval - 1, fp);
-
-                        if (ferror(fp)) {
-                                /* Linux 4.1.0 introduced a per-NIC IPv6 stable_secret file.
-                                 * The stable_secret file cannot be read until it is set,
-                                 * so we skip it when it is not readable. Otherwise we collect it.
-                                 */
-                                if (strncmp(ofts_ent->path, ipv6_conf_path, ipv6_conf_path_len) == 0 &&
-                                                strcmp(ofts_ent->file, "stable_secret") == 0) {
-                                        dD("Skipping file %s", mibpath);
-                                        oval_ftsent_free(ofts_ent);
-                                        SEXP_free(se_mib);
-                                        fclose(fp);
-                                        continue;
-                                } else {
-                                        dE("An error occurred when reading from \"%s\" (fp=%p): l=%ld, %u, %s",
-                                                mibpath, fp, l, errno, strerror(errno));
-                                        goto fail_item;
-                                }
-                        }
+/* Collect the node if its MIB name matches the object */
+static void sysctl_collect_matching(probe_ctx *ctx, SEXP_t *name_entity, const char *mib, const char *mibpath, int over_cmp)
+{
+        SEXP_t *se_mib = SEXP_string_new(mib, strlen(mib));
 
-                        fclose(fp);
+        if (probe_entobj_cmp(name_entity, se_mib) == OVAL_RESULT_TRUE) {
+                dD("MIB match");
+                sysctl_collect(ctx, mib, mibpath, over_cmp);
+        }
+        SEXP_free(se_mib);
+}
 
-                        /* Skip empty values as sysctl tool does.
-                         * See https://bugzilla.redhat.com/show_bug.cgi?id=1473207
-                         */
-                        if (l == 0) {
-                                dD("Skipping file '%s' because it has no value.", mibpath);
-                                oval_ftsent_free(ofts_ent);
-                                SEXP_free(se_mib);
-                                continue;
-                        }
+static int sysctl_name_cmp(const void *a, const void *b)
+{
+        return strcmp(*(char * const *)a, *(char * const *)b);
+}
 
-                        /*
-                         * sanitize the value
-                         *  - only printable and whitespace chars allowed
-                         *  - remove the last '\n'
-                         */
-                        sysvals[0] = sysval;
-
-                        for(s = 0, i = 0; i < l && s < sizeof sysvals/sizeof(char *) - 1; ++i) {
-                                if ((!isprint(sysval[i]) && !isspace(sysval[i]))
-                                    || (over_cmp >= 0 && sysval[i] == '\n' /* OVAL 5.10 and above */))
-                                {
-                                        sysval[i] = '\0';
-                                        sysvals[++s] = sysval + i + 1;
-                                }
-                        }
+int sysctl_probe_main(probe_ctx *ctx, void *probe_arg)
+{
+        struct sysctl_probe_global *g = probe_arg;
+        struct sysctl_snapshot *snapshot = NULL;
+        SEXP_t *name_entity, *probe_in;
+        oval_schema_version_t over;
+        int over_cmp;
+        char root[PATH_MAX];
+        char **names = NULL;
+        size_t name_cnt = 0;
+        int ret = 0;
 
-                        if (sysval[l - 1] == '\n')
-                                sysval[l - 1] = '\0';
-                        else
-                                sysval[l] = '\0';
-
-                        if (strlen(sysvals[s]) == 0)
-                                sysvals[s] = NULL;
-                        else
-                                sysvals[++s] = NULL;
-
-                        if (over_cmp >= 0) {
-                                /* Only in OVAL 5.10 and above */
-                                item = probe_item_create(OVAL_UNIX_SYSCTL, NULL,
-                                                         "name",  OVAL_DATATYPE_SEXP,   se_mib,
-                                                         "value", OVAL_DATATYPE_STRING_M, sysvals,
-                                                         NULL);
-                        } else {
-                                item = probe_item_create(OVAL_UNIX_SYSCTL, NULL,
-                                                         "name",  OVAL_DATATYPE_SEXP,   se_mib,
-                                                         "value", OVAL_DATATYPE_STRING, sysval,
-                                                         NULL);
-                        }
+        probe_in    = probe_ctx_getobject(ctx);
+        name_entity = probe_obj_getent(probe_in, "name", 1);
+        over        = probe_obj_get_platform_schema_version(probe_in);
+        over_cmp    = oval_schema_version_cmp(over, OVAL_SCHEMA_VERSION(5.10));
 
-                        goto add_item;
-                fail_item:
-                        if (fp != NULL)
-                                fclose(fp);
+        if (name_entity == NULL) {
+                dE("Missing \"name\" entity in the input object");
+                return (PROBE_ENOENT);
+        }
 
-                        item = probe_item_create(OVAL_UNIX_SYSCTL, NULL, NULL);
-                        probe_item_setstatus(item, SYSCHAR_STATUS_ERROR);
-                add_item:
-                        probe_item_collect(ctx, item);
+        const char *prefix = getenv("OSCAP_PROBE_ROOT");
+        snprintf(root, sizeof root, "%s%s", prefix != NULL ? prefix : "", PROC_SYS_DIR);
+
+        /*
+         * With the "equals" operation the names are known, so their nodes
+         * are looked up directly. Everything else is matched against the
+         * snapshot of the whole tree.
+         */
+        if (probe_ent_getoperation(name_entity, OVAL_OPERATION_EQUALS) == OVAL_OPERATION_EQUALS) {
+                SEXP_t *vals = NULL, *val;
+
+                probe_ent_getvals(name_entity, &vals);
+                names = calloc(SEXP_list_length(vals) + 1, sizeof(char *));
+                SEXP_list_foreach(val, vals) {
+                        char *name = SEXP_string_cstr(val);
+                        if (name != NULL)
+                                names[name_cnt++] = name;
                 }
+                SEXP_free(vals);
+                /* a variable may have the same value more than once */
+                qsort(names, name_cnt, sizeof(char *), sysctl_name_cmp);
 
-                oval_ftsent_free(ofts_ent);
-                SEXP_free(se_mib);
-        }
+                for (size_t i = 0; i < name_cnt; ++i) {
+                        char mibpath[PATH_MAX];
 
-        oval_fts_close(ofts);
-        SEXP_free(path_entity);
-        SEXP_free(filename_entity);
-        SEXP_free(bh_entity);
+                        if (i > 0 && strcmp(names[i], names[i - 1]) == 0)
+                                continue;
+                        switch (sysctl_lookup_direct(root, names[i], mibpath, sizeof mibpath)) {
+                        case 0:
+                                sysctl_collect_matching(ctx, name_entity, names[i], mibpath, over_cmp);
+                                break;
+                        case 1: {
+                                struct sysctl_entry key = { .mib = names[i] }, *entry;
+
+                                if (snapshot == NULL && (snapshot = sysctl_snapshot_get(g, root)) == NULL)
+                                        goto fail;
+                                entry = bsearch(&key, snapshot->entries, snapshot->count,
+                                                sizeof(struct sysctl_entry), sysctl_entry_cmp);
+                                if (entry != NULL)
+                                        sysctl_collect_matching(ctx, name_entity, entry->mib, entry->path, over_cmp);
+                                break;
+                        }
+                        default:
+                                break;
+                        }
+                }
+        } else {
+                if ((snapshot = sysctl_snapshot_get(g, root)) == NULL)
+                        goto fail;
+                for (size_t i = 0; i < snapshot->count; ++i) {
+                        sysctl_collect_matching(ctx, name_entity, snapshot->entries[i].mib,
+                                                snapshot->entries[i].path, over_cmp);
+                }
+        }
+        goto cleanup;
+
+fail:
+        ret = PROBE_EFATAL;
+        if (prefix != NULL) {
+                DIR *d = opendir(prefix);
+                if (d != NULL) {
+                        closedir(d);
+                        ret = PROBE_ESUCCESS;
+                        goto cleanup;
+                }
+                dW("Can't open prefix directory '%s': %s", prefix, strerror(errno));
+        }
+        dE("Can't read the sysctl names from '%s'.", root);
+cleanup:
+        sysctl_snapshot_put(g, snapshot);
+        for (size_t i = 0; i < name_cnt; ++i)
+                free(names[i]);
+        free(names);
         SEXP_free(name_entity);
 
-        return (0);
+        return ret;
 }
 
 #elif defined(OS_FREEBSD)
@@ -312,6 +492,15 @@ int sysctl_probe_offline_mode_supported(void)
         return PROBE_OFFLINE_NONE;
 }
 
+void *sysctl_probe_init(void)
+{
+        return NULL;
+}
+
+void sysctl_probe_fini(void *probe_arg)
+{
+}
+
 int sysctl_probe_main(probe_ctx *ctx, void *probe_arg)
 {
         FILE *fp;
@@ -397,6 +586,15 @@ int sysctl_probe_offline_mode_supported(void)
         return PROBE_OFFLINE_NONE;
 }
 
+void *sysctl_probe_init(void)
+{
+        return NULL;
+}
+
+void sysctl_probe_fini(void *probe_arg)
+{
+}
+
 int sysctl_probe_main(probe_ctx *ctx, void *probe_arg)
 {
         return(PROBE_EOPNOTSUPP);
@@ -27,6 +27,10 @@
 
 int sysctl_probe_offline_mode_supported(void);
 
+void *sysctl_probe_init(void);
+
 int sysctl_probe_main(probe_ctx *ctx, void *arg);
 
+void sysctl_probe_fini(void *arg);
+
 #endif /* OPENSCAP_SYSCTL_PROBE_H */
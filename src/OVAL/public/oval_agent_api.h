@@ -73,6 +73,13 @@ OSCAP_API struct oval_definition_model* oval_agent_get_definition_model(oval_age
  */
 OSCAP_API void oval_agent_set_product_name(oval_agent_session_t *, char *);
 
+/**
+ * Set whether the persistent collection cache configured by the
+ * OSCAP_COLLECTION_CACHE_DIR environment variable shall be used by the
+ * given session. The cache is used by default when it's configured.
+ */
+OSCAP_API void oval_agent_set_collection_cache(oval_agent_session_t *ag_sess, bool enabled);
+
 /**
  * Probe the system and evaluate specified definition
  * @return 0 on success; -1 error; 1 warning
@@ -28,6 +28,7 @@
 #include <config.h>
 #endif
 
+#include <stdlib.h>
 #include <string.h>
 #include <inttypes.h>
 
@@ -42,6 +43,7 @@
 #include "oval_system_characteristics.h"
 #include "common/_error.h"
 #include "common/debug_priv.h"
+#include "common/oscap_pcre.h"
 
 #include "oval_cmp_basic_impl.h"
 #include "oval_cmp_evr_string_impl.h"
@@ -161,3 +163,138 @@ oval_result_t oval_str_cmp_str(char *state_data, oval_datatype_t state_data_type
 	oscap_seterr(OSCAP_EFAMILY_OVAL, "Invalid OVAL data type: %d.", state_data_type);
 	return OVAL_RESULT_ERROR;
 }
+
+struct oval_cmp_value {
+	char *text;
+	oval_datatype_t datatype;
+	oval_operation_t operation;
+	bool parsed;				///< data holds the state value, otherwise compare the text
+	union {
+		intmax_t integer;
+		double floating;
+		bool boolean;
+		oscap_pcre_t *regex;
+		struct oval_evr evr;
+		struct oval_version version;
+		struct oval_ipaddr ipaddr;
+	} data;
+};
+
+static inline bool cstr_to_bool(const char *cstr)
+{
+	return strcmp(cstr, "true") == 0 || strcmp(cstr, "1") == 0;
+}
+
+struct oval_cmp_value *oval_cmp_value_new(char *state_data, oval_datatype_t state_data_type, oval_operation_t operation)
+{
+	struct oval_cmp_value *value = calloc(1, sizeof(struct oval_cmp_value));
+	value->text = state_data;
+	value->datatype = state_data_type;
+	value->operation = operation;
+
+	/* Values which can't be parsed are compared as text, oval_str_cmp_str() reports the errors */
+	switch (state_data_type) {
+	case OVAL_DATATYPE_STRING:
+		if (operation == OVAL_OPERATION_PATTERN_MATCH) {
+			char *err = NULL;
+			int errofs;
+			value->data.regex = oscap_pcre_compile_cached(state_data, OSCAP_PCRE_OPTS_UTF8, &err, &errofs);
+			value->parsed = value->data.regex != NULL;
+			oscap_pcre_err_free(err);
+		}
+		break;
+	case OVAL_DATATYPE_INTEGER:
+		value->parsed = cstr_to_intmax(state_data, &value->data.integer);
+		break;
+	case OVAL_DATATYPE_FLOAT:
+		value->parsed = cstr_to_double(state_data, &value->data.floating);
+		break;
+	case OVAL_DATATYPE_BOOLEAN:
+		value->data.boolean = cstr_to_bool(state_data);
+		value->parsed = true;
+		break;
+	case OVAL_DATATYPE_EVR_STRING:
+		oval_evr_parse(state_data, &value->data.evr);
+		value->parsed = true;
+		break;
+	case OVAL_DATATYPE_VERSION:
+		oval_version_parse(state_data, &value->data.version);
+		value->parsed = true;
+		break;
+	case OVAL_DATATYPE_IPV4ADDR:
+		value->parsed = oval_ipaddr_parse(AF_INET, state_data, &value->data.ipaddr) == 0;
+		break;
+	case OVAL_DATATYPE_IPV6ADDR:
+		value->parsed = oval_ipaddr_parse(AF_INET6, state_data, &value->data.ipaddr) == 0;
+		break;
+	default:
+		break;
+	}
+	return value;
+}
+
+oval_result_t oval_cmp_value_cmp_str(const struct oval_cmp_value *value, const char *sys_data)
+{
+	if (!value->parsed)
+		return oval_str_cmp_str(value->text, value->datatype, sys_data, value->operation);
+
+	switch (value->datatype) {
+	case OVAL_DATATYPE_STRING:
+		return oval_string_regex_match(value->data.regex, value->text, sys_data);
+	case OVAL_DATATYPE_INTEGER: {
+		intmax_t syschar_val;
+
+		if (!cstr_to_intmax(sys_data, &syschar_val)) {
+			dW(
+				"Conversion of the string \"%s\" to an integer (%zu bits) failed: %s",
+				sys_data, sizeof(intmax_t)*8, strerror(errno));
+			return OVAL_RESULT_ERROR;
+		}
+		return oval_int_cmp(value->data.integer, syschar_val, value->operation);
+	}
+	case OVAL_DATATYPE_FLOAT: {
+		double sys_val;
+
+		if (!cstr_to_double(sys_data, &sys_val)) {
+			dW(
+				"Conversion of the string \"%s\" to a floating type (double) failed: %s",
+				sys_data, strerror(errno));
+			return OVAL_RESULT_ERROR;
+		}
+		return oval_float_cmp(value->data.floating, sys_val, value->operation);
+	}
+	case OVAL_DATATYPE_BOOLEAN:
+		return oval_boolean_cmp(value->data.boolean, cstr_to_bool(sys_data), value->operation);
+	case OVAL_DATATYPE_EVR_STRING:
+		return oval_evr_string_cmp_parsed(&value->data.evr, sys_data, value->operation);
+	case OVAL_DATATYPE_VERSION:
+		return oval_versiontype_cmp_parsed(&value->data.version, sys_data, value->operation);
+	case OVAL_DATATYPE_IPV4ADDR:
+	case OVAL_DATATYPE_IPV6ADDR:
+		return oval_ipaddr_cmp_parsed(&value->data.ipaddr, sys_data, value->operation);
+	default:
+		return oval_str_cmp_str(value->text, value->datatype, sys_data, value->operation);
+	}
+}
+
+void oval_cmp_value_free(struct oval_cmp_value *value)
+{
+	if (value == NULL)
+		return;
+	if (value->parsed) {
+		switch (value->datatype) {
+		case OVAL_DATATYPE_STRING:
+			oscap_pcre_free(value->data.regex);
+			break;
+		case OVAL_DATATYPE_EVR_STRING:
+			oval_evr_clear(&value->data.evr);
+			break;
+		case OVAL_DATATYPE_VERSION:
+			oval_version_clear(&value->data.version);
+			break;
+		default:
+			break;
+		}
+	}
+	free(value);
+}
@@ -122,13 +122,13 @@ static int istrcmp(const char *st1, const char *st2)
 
 static oval_result_t strregcomp(const char *pattern, const char *test_str)
 {
-	int ret;
-	oval_result_t result = OVAL_RESULT_ERROR;
+	oval_result_t result;
 	oscap_pcre_t *re;
 	char *err;
 	int errofs;
 
-	re = oscap_pcre_compile(pattern, OSCAP_PCRE_OPTS_UTF8, &err, &errofs);
+	/* The same patterns are compared against many items, use the cache */
+	re = oscap_pcre_compile_cached(pattern, OSCAP_PCRE_OPTS_UTF8, &err, &errofs);
 	if (re == NULL) {
 		dE("Unable to compile regex pattern '%s', "
 				"oscap_pcre_compile() returned error (offset: %d): '%s'.\n", pattern, errofs, err);
@@ -136,19 +136,25 @@ static oval_result_t strregcomp(const char *pattern, const char *test_str)
 		return OVAL_RESULT_ERROR;
 	}
 
-	ret = oscap_pcre_exec(re, test_str, strlen(test_str), 0, 0, NULL, 0);
+	result = oval_string_regex_match(re, pattern, test_str);
+	oscap_pcre_free(re);
+	return result;
+}
+
+oval_result_t oval_string_regex_match(oscap_pcre_t *re, const char *pattern, const char *syschar)
+{
+	int ret;
+
+	syschar = syschar ? syschar : "";
+	ret = oscap_pcre_exec(re, syschar, strlen(syschar), 0, 0, NULL, 0);
 	if (ret > OSCAP_PCRE_ERR_NOMATCH ) {
-		result = OVAL_RESULT_TRUE;
+		return OVAL_RESULT_TRUE;
 	} else if (ret == OSCAP_PCRE_ERR_NOMATCH) {
-		result = OVAL_RESULT_FALSE;
-	} else {
-		dE("Unable to match regex pattern '%s' on string '%s', "
-				"oscap_pcre_exec() returned error: %d.\n", pattern, test_str, ret);
-		result = OVAL_RESULT_ERROR;
+		return OVAL_RESULT_FALSE;
 	}
-
-	oscap_pcre_free(re);
-	return result;
+	dE("Unable to match regex pattern '%s' on string '%s', "
+			"oscap_pcre_exec() returned error: %d.\n", pattern, syschar, ret);
+	return OVAL_RESULT_ERROR;
 }
 
 oval_result_t oval_string_cmp(const char *state, const char *syschar, oval_operation_t operation)
@@ -26,6 +26,7 @@
 #include "../common/util.h"
 #include "oval_definitions.h"
 #include "oval_types.h"
+#include "common/oscap_pcre.h"
 
 
 oval_result_t oval_boolean_cmp(const bool state, const bool syschar, oval_operation_t operation);
@@ -36,6 +37,15 @@ oval_result_t oval_float_cmp(const double state_val, const double sys_val, oval_
 
 oval_result_t oval_string_cmp(const char *state, const char *syschar, oval_operation_t operation);
 
+/**
+ * Match a string against a pattern compiled in advance, as the pattern match
+ * operation of oval_string_cmp() does.
+ * @param re compiled pattern
+ * @param pattern the pattern, used in error messages
+ * @param syschar string captured from system
+ */
+oval_result_t oval_string_regex_match(oscap_pcre_t *re, const char *pattern, const char *syschar);
+
 oval_result_t oval_binary_cmp(const char *state, const char *syschar, oval_operation_t operation);
 
 
@@ -58,16 +58,12 @@ static int risdigit(int c) {
 #endif
 
 static inline int rpmevrcmp(const char *a, const char *b);
+static int evrcmp(const struct oval_evr *a, const struct oval_evr *b);
 static int compare_values(const char *str1, const char *str2);
 static void parseEVR(char *evr, const char **ep, const char **vp, const char **rp);
 
-oval_result_t oval_evr_string_cmp(const char *state, const char *sys, oval_operation_t operation)
+static oval_result_t evr_result(int result, oval_operation_t operation)
 {
-	if (state == NULL || sys == NULL) {
-		return OVAL_RESULT_ERROR;
-	}
-	int result = rpmevrcmp(sys, state);
-
 	if (operation == OVAL_OPERATION_EQUALS) {
 		return ((result == 0) ? OVAL_RESULT_TRUE : OVAL_RESULT_FALSE);
 	} else if (operation == OVAL_OPERATION_NOT_EQUAL) {
@@ -86,30 +82,65 @@ oval_result_t oval_evr_string_cmp(const char *state, const char *sys, oval_opera
 	return OVAL_RESULT_ERROR;
 }
 
+oval_result_t oval_evr_string_cmp(const char *state, const char *sys, oval_operation_t operation)
+{
+	if (state == NULL || sys == NULL) {
+		return OVAL_RESULT_ERROR;
+	}
+	return evr_result(rpmevrcmp(sys, state), operation);
+}
+
+void oval_evr_parse(const char *evr, struct oval_evr *parsed)
+{
+	parsed->epoch = NULL;
+	parsed->version = NULL;
+	parsed->release = NULL;
+	parsed->buffer = oscap_strdup(evr);
+	parseEVR(parsed->buffer, &parsed->epoch, &parsed->version, &parsed->release);
+}
+
+void oval_evr_clear(struct oval_evr *parsed)
+{
+	free(parsed->buffer);
+	parsed->buffer = NULL;
+}
+
+oval_result_t oval_evr_string_cmp_parsed(const struct oval_evr *state, const char *sys, oval_operation_t operation)
+{
+	if (sys == NULL) {
+		return OVAL_RESULT_ERROR;
+	}
+	struct oval_evr sys_evr;
+	oval_evr_parse(sys, &sys_evr);
+	int result = evrcmp(&sys_evr, state);
+	oval_evr_clear(&sys_evr);
+	return evr_result(result, operation);
+}
+
 static inline int rpmevrcmp(const char *a, const char *b)
 {
 	/* This mimics rpmevrcmp which is not exported by rpmlib version 4.
 	 * Code inspired by rpm.labelCompare() from rpm4/python/header-py.c
 	 */
-	const char *a_epoch = NULL, *a_version = NULL, *a_release = NULL;
-	const char *b_epoch = NULL, *b_version = NULL, *b_release = NULL;
-	char *a_copy, *b_copy;
+	struct oval_evr a_evr, b_evr;
 	int result;
 
-	a_copy = oscap_strdup(a);
-	b_copy = oscap_strdup(b);
-	parseEVR(a_copy, &a_epoch, &a_version, &a_release);
-	parseEVR(b_copy, &b_epoch, &b_version, &b_release);
+	oval_evr_parse(a, &a_evr);
+	oval_evr_parse(b, &b_evr);
+	result = evrcmp(&a_evr, &b_evr);
+	oval_evr_clear(&a_evr);
+	oval_evr_clear(&b_evr);
+	return result;
+}
 
-	result = compare_values(a_epoch, b_epoch);
+static int evrcmp(const struct oval_evr *a, const struct oval_evr *b)
+{
+	int result = compare_values(a->epoch, b->epoch);
 	if (!result) {
-		result = compare_values(a_version, b_version);
+		result = compare_values(a->version, b->version);
 		if (!result)
-			result = compare_values(a_release, b_release);
+			result = compare_values(a->release, b->release);
 	}
-
-	free(a_copy);
-	free(b_copy);
 	return result;
 }
 
@@ -458,20 +489,48 @@ oval_result_t oval_debian_evr_string_cmp(const char *state, const char *sys, ova
 	return OVAL_RESULT_ERROR;
 }
 
+void oval_version_parse(const char *version, struct oval_version *parsed)
+{
+	size_t idx = 0;
+
+	parsed->count = 0;
+	parsed->fields = malloc((strlen(version) + 1) * sizeof(int));
+	/* Split the same way oval_versiontype_cmp() walks the state version */
+	while (version[idx]) {
+		parsed->fields[parsed->count++] = atoi(&version[idx]);
+		++idx;
+		while ((version[idx]) && (isdigit(version[idx])))
+			++idx;
+		if ((version[idx]) && (!isdigit(version[idx])))
+			++idx;
+	}
+}
+
+void oval_version_clear(struct oval_version *parsed)
+{
+	free(parsed->fields);
+	parsed->fields = NULL;
+	parsed->count = 0;
+}
+
 oval_result_t oval_versiontype_cmp(const char *state, const char *syschar, oval_operation_t operation)
 {
-	int state_idx = 0;
+	struct oval_version state_version;
+
+	oval_version_parse(state, &state_version);
+	oval_result_t result = oval_versiontype_cmp_parsed(&state_version, syschar, operation);
+	oval_version_clear(&state_version);
+	return result;
+}
+
+oval_result_t oval_versiontype_cmp_parsed(const struct oval_version *state, const char *syschar, oval_operation_t operation)
+{
+	size_t state_idx = 0;
 	int sys_idx = 0;
-	int result = -1;
-	/* int is_equal = 1; */
-	for (state_idx = 0, sys_idx = 0; (((state[state_idx]) || (syschar[sys_idx])) && (result == -1));) {	// keep going as long as there is data in either the state or sysitem
+	for (state_idx = 0, sys_idx = 0; ((state_idx < state->count) || (syschar[sys_idx]));) {	// keep going as long as there is data in either the state or sysitem
 		int tmp_state_int, tmp_sys_int;
-		tmp_state_int = atoi(&state[state_idx]);	// look at the current data field (if we're at the end, atoi should return 0)
-		tmp_sys_int = atoi(&syschar[sys_idx]);
-                /* o rly?
-		if (tmp_state_int != tmp_sys_int)
-			is_equal = 0;	// we might need this later (if we don't terminate early)
-                */
+		tmp_state_int = state_idx < state->count ? state->fields[state_idx] : 0;	// past the last field of the state compare with 0
+		tmp_sys_int = atoi(&syschar[sys_idx]);	// look at the current data field (if we're at the end, atoi should return 0)
 		if (operation == OVAL_OPERATION_EQUALS) {
 			if (tmp_state_int != tmp_sys_int)
 				return (OVAL_RESULT_FALSE);
@@ -495,12 +554,7 @@ oval_result_t oval_versiontype_cmp(const char *state, const char *syschar, oval_
 			return OVAL_RESULT_ERROR;
 		}
 
-		if (state[state_idx])
-			++state_idx;
-		/* move to the next field within the version string (if there is one) */
-		while ((state[state_idx]) && (isdigit(state[state_idx])))
-			++state_idx;
-		if ((state[state_idx]) && (!isdigit(state[state_idx])))
+		if (state_idx < state->count)
 			++state_idx;
 
 		if (syschar[sys_idx])
@@ -47,8 +47,50 @@
  */
 oval_result_t oval_evr_string_cmp(const char *state, const char *sys, oval_operation_t operation);
 
+/**
+ * EVR string split into its epoch, version and release.
+ */
+struct oval_evr {
+	char *buffer;		///< copy of the string the parts point to
+	const char *epoch;
+	const char *version;
+	const char *release;
+};
+
+/**
+ * Split an EVR string. Release the result by oval_evr_clear().
+ */
+void oval_evr_parse(const char *evr, struct oval_evr *parsed);
+
+void oval_evr_clear(struct oval_evr *parsed);
+
+/**
+ * Same as oval_evr_string_cmp() with the state EVR string parsed in advance.
+ */
+oval_result_t oval_evr_string_cmp_parsed(const struct oval_evr *state, const char *sys, oval_operation_t operation);
+
 oval_result_t oval_versiontype_cmp(const char *state, const char *syschar, oval_operation_t operation);
 
+/**
+ * Numeric fields of a version string, in the order oval_versiontype_cmp() compares them.
+ */
+struct oval_version {
+	int *fields;
+	size_t count;
+};
+
+/**
+ * Split a version string. Release the result by oval_version_clear().
+ */
+void oval_version_parse(const char *version, struct oval_version *parsed);
+
+void oval_version_clear(struct oval_version *parsed);
+
+/**
+ * Same as oval_versiontype_cmp() with the state version parsed in advance.
+ */
+oval_result_t oval_versiontype_cmp_parsed(const struct oval_version *state, const char *syschar, oval_operation_t operation);
+
 oval_result_t oval_debian_evr_string_cmp(const char *state, const char *sys, oval_operation_t operation);
 
 /*
@@ -40,5 +40,27 @@
  */
 oval_result_t oval_str_cmp_str(char *state_data, oval_datatype_t state_data_type, const char *sys_data, oval_operation_t operation);
 
+/**
+ * State value prepared to be compared with many values collected from the system.
+ * Numbers, EVR strings, versions and IP addresses are parsed and patterns are
+ * compiled once, instead of in each comparison.
+ */
+struct oval_cmp_value;
+
+/**
+ * Prepare a state value for comparisons by oval_cmp_value_cmp_str().
+ * @param state_data the state value, it has to outlive the prepared value
+ * @param state_data_type type of the state value
+ * @param operation type of comparison operation
+ */
+struct oval_cmp_value *oval_cmp_value_new(char *state_data, oval_datatype_t state_data_type, oval_operation_t operation);
+
+/**
+ * Same as oval_str_cmp_str() with the state value prepared in advance.
+ */
+oval_result_t oval_cmp_value_cmp_str(const struct oval_cmp_value *value, const char *sys_data);
+
+void oval_cmp_value_free(struct oval_cmp_value *value);
+
 
 #endif
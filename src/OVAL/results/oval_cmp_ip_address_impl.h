@@ -49,5 +49,25 @@
  */
 oval_result_t oval_ipaddr_cmp(int af, const char *s1, const char *s2, oval_operation_t op);
 
+/**
+ * IP address or address set parsed by oval_ipaddr_parse().
+ */
+struct oval_ipaddr {
+	int af;
+	uint32_t mask;			///< netmask (IPv4) or prefix length (IPv6)
+	unsigned char addr[16];		///< struct in_addr or struct in6_addr
+};
+
+/**
+ * Parse an IP address of the given family in advance of comparing it with oval_ipaddr_cmp_parsed().
+ * @returns 0 on success, -1 if the address is malformed
+ */
+int oval_ipaddr_parse(int af, const char *s, struct oval_ipaddr *parsed);
+
+/**
+ * Same as oval_ipaddr_cmp() with the state address parsed in advance.
+ */
+oval_result_t oval_ipaddr_cmp_parsed(const struct oval_ipaddr *state, const char *s2, oval_operation_t op);
+
 
 #endif
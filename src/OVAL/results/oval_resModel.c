@@ -249,7 +249,7 @@ int oval_results_model_eval(struct oval_results_model *res_model)
 
 static xmlNode *oval_results_to_dom(struct oval_results_model *results_model,
 				    struct oval_directives_model *directives_model, 
-				    xmlDocPtr doc, xmlNode * parent)
+				    xmlDocPtr doc, xmlNode * parent, xmlTextWriterPtr writer)
 {
 	xmlNode *root_node;
 	struct oval_result_directives * dirs;
@@ -268,6 +268,8 @@ static xmlNode *oval_results_to_dom(struct oval_results_model *results_model,
 
 	xmlSetNs(root_node, ns_common);
 	xmlSetNs(root_node, ns_results);
+	if (writer)
+		oscap_xml_writer_start_node(writer, root_node);
 
 	/* Report generator */
 	oval_generator_to_dom(results_model->generator, doc, root_node);
@@ -276,6 +278,8 @@ static xmlNode *oval_results_to_dom(struct oval_results_model *results_model,
 	 * directives model(if provided) */
 	dirs_model = (directives_model) ? directives_model : results_model->directives_model;
 	oval_directives_model_to_dom(dirs_model, doc, root_node);
+	if (writer)
+		oscap_xml_writer_flush_children(writer, doc, root_node);
 
 	dirs = oval_directives_model_get_defdirs(dirs_model);
 
@@ -283,15 +287,23 @@ static xmlNode *oval_results_to_dom(struct oval_results_model *results_model,
 	if(oval_result_directives_get_included(dirs)) {
 		struct oval_definition_model *definition_model = oval_results_model_get_definition_model(results_model);
 		oval_definition_model_to_dom(definition_model, doc, root_node);
+		if (writer)
+			oscap_xml_writer_flush_children(writer, doc, root_node);
 	}
 
 	xmlNode *results_node = xmlNewTextChild(root_node, ns_results, BAD_CAST "results", NULL);
+	if (writer)
+		oscap_xml_writer_start_node(writer, results_node);
 	struct oval_result_system_iterator *systems = oval_results_model_get_systems(results_model);
 	while (oval_result_system_iterator_has_more(systems)) {
 		struct oval_result_system *sys = oval_result_system_iterator_next(systems);
-		oval_result_system_to_dom(sys, results_model, dirs_model, doc, results_node);
+		oval_result_system_to_dom(sys, results_model, dirs_model, doc, results_node, writer);
 	}
 	oval_result_system_iterator_free(systems);
+	if (writer) {
+		oscap_xml_writer_end_node(writer);
+		oscap_xml_writer_end_node(writer);
+	}
 
 	return root_node;
 }
@@ -306,10 +318,40 @@ struct oscap_source *oval_results_model_export_source(struct oval_results_model
 		return NULL;
 	}
 
-	oval_results_to_dom(results_model, directives_model, doc, NULL);
+	oval_results_to_dom(results_model, directives_model, doc, NULL, NULL);
 	return oscap_source_new_from_xmlDoc(doc, name);
 }
 
+int oval_results_model_write(struct oval_results_model *results_model, struct oval_directives_model *directives_model, xmlTextWriterPtr writer)
+{
+	__attribute__nonnull__(results_model);
+
+	/* The document only holds the element being built and its ancestors,
+	 * everything complete is written out and freed right away. */
+	xmlDocPtr doc = xmlNewDoc(BAD_CAST "1.0");
+	if (doc == NULL) {
+		oscap_setxmlerr(xmlGetLastError());
+		return -1;
+	}
+	oval_results_to_dom(results_model, directives_model, doc, NULL, writer);
+	xmlFreeDoc(doc);
+	return xmlTextWriterFlush(writer) < 0 ? -1 : 0;
+}
+
+int oval_results_model_export_stream(struct oval_results_model *results_model, struct oval_directives_model *directives_model, const char *file)
+{
+	xmlTextWriterPtr writer = oscap_xml_writer_new_filename(file);
+	if (writer == NULL) {
+		return -1;
+	}
+	if (oval_results_model_write(results_model, directives_model, writer) != 0) {
+		oscap_xml_writer_close(writer);
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Could not export OVAL Results to %s.", file);
+		return -1;
+	}
+	return oscap_xml_writer_close(writer) == 1 ? 0 : -1;
+}
+
 int oval_results_model_export(struct oval_results_model *results_model,
 			      struct oval_directives_model *directives_model,
 			      const char *file)
@@ -36,6 +36,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <errno.h>
+#include <pthread.h>
 
 #include "oval_definitions.h"
 #include "oval_agent_api.h"
@@ -49,6 +51,7 @@
 
 #include "common/debug_priv.h"
 #include "common/_error.h"
+#include "common/elements.h"
 #include "common/util.h"
 #include "common/list.h"
 
@@ -374,6 +377,137 @@ int oval_result_system_eval_definition(struct oval_result_system *sys, const cha
 	return 0;
 }
 
+struct oval_result_eval_job {
+	struct oval_result_test *test;
+	struct err_queue *errors;		///< errors set by the evaluation, in the evaluating thread
+};
+
+struct oval_result_eval_batch {
+	struct oval_result_eval_job *jobs;
+	size_t count;
+	size_t next;
+	pthread_mutex_t lock;			///< guards next
+};
+
+static void *_oval_result_system_eval_worker(void *arg)
+{
+	struct oval_result_eval_batch *batch = arg;
+
+	for (;;) {
+		pthread_mutex_lock(&batch->lock);
+		size_t idx = batch->next < batch->count ? batch->next++ : batch->count;
+		pthread_mutex_unlock(&batch->lock);
+		if (idx == batch->count)
+			break;
+		oval_result_test_eval(batch->jobs[idx].test);
+		batch->jobs[idx].errors = oscap_err_detach();
+	}
+	return NULL;
+}
+
+static bool _oval_result_definition_ptr_eq(void *a, void *b)
+{
+	return a == b;
+}
+
+static void _oval_result_system_collect_criteria(struct oval_result_criteria_node *node, struct oscap_list *visited, struct oscap_list *tests);
+
+static void _oval_result_system_collect_definition(struct oval_result_definition *definition, struct oscap_list *visited, struct oscap_list *tests)
+{
+	if (definition == NULL || oval_result_definition_get_result(definition) != OVAL_RESULT_NOT_EVALUATED)
+		return;
+	if (oscap_list_contains(visited, definition, _oval_result_definition_ptr_eq))
+		return;
+	oscap_list_add(visited, definition);
+	_oval_result_system_collect_criteria(oval_result_definition_get_criteria(definition), visited, tests);
+}
+
+/*
+ * Walk the criteria the way oval_result_criteria_node_eval() does, collecting
+ * the objects of the tests which haven't been evaluated yet.
+ */
+static void _oval_result_system_collect_criteria(struct oval_result_criteria_node *node, struct oscap_list *visited, struct oscap_list *tests)
+{
+	if (node == NULL || oval_result_criteria_node_get_result(node) != OVAL_RESULT_NOT_EVALUATED)
+		return;
+
+	switch (oval_result_criteria_node_get_type(node)) {
+	case OVAL_NODETYPE_CRITERIA: {
+		struct oval_result_criteria_node_iterator *subnodes = oval_result_criteria_node_get_subnodes(node);
+		while (oval_result_criteria_node_iterator_has_more(subnodes))
+			_oval_result_system_collect_criteria(oval_result_criteria_node_iterator_next(subnodes), visited, tests);
+		oval_result_criteria_node_iterator_free(subnodes);
+		} break;
+	case OVAL_NODETYPE_CRITERION: {
+		struct oval_result_test *test = oval_result_criteria_node_get_test(node);
+		if (oval_result_test_get_result(test) == OVAL_RESULT_NOT_EVALUATED && !oval_result_test_is_collected(test)) {
+			/* unknown tests aren't collected by the evaluation either */
+			if (oval_test_get_subtype(oval_result_test_get_test(test)) != OVAL_INDEPENDENT_UNKNOWN)
+				oval_result_test_collect(test);
+			oscap_list_add(tests, test);
+		}
+		} break;
+	case OVAL_NODETYPE_EXTENDDEF:
+		_oval_result_system_collect_definition(oval_result_criteria_node_get_extends(node), visited, tests);
+		break;
+	default:
+		break;
+	}
+}
+
+int oval_result_system_eval_definitions(struct oval_result_system *sys, struct oval_result_definition **definitions, size_t count, unsigned int max_threads)
+{
+	struct oscap_list *visited = oscap_list_new();
+	struct oscap_list *tests = oscap_list_new();
+
+	/* Probes are queried from this thread only, in the same order as by a sequential evaluation */
+	for (size_t i = 0; i < count; i++)
+		_oval_result_system_collect_definition(definitions[i], visited, tests);
+	oscap_list_free(visited, NULL);
+
+	struct oval_result_eval_batch batch = {
+		.count = oscap_list_get_itemcount(tests),
+		.next = 0,
+	};
+	batch.jobs = calloc(batch.count, sizeof(struct oval_result_eval_job));
+	struct oscap_iterator *tests_it = oscap_iterator_new(tests);
+	for (size_t i = 0; oscap_iterator_has_more(tests_it); i++)
+		batch.jobs[i].test = oscap_iterator_next(tests_it);
+	oscap_iterator_free(tests_it);
+	oscap_list_free(tests, NULL);
+
+	unsigned int thread_count = (size_t) max_threads < batch.count ? max_threads : (unsigned int) batch.count;
+	pthread_t *threads = malloc(thread_count * sizeof(pthread_t));
+	unsigned int started = 0;
+	/* Keep the errors set so far out of the way of the ones of the tests */
+	struct err_queue *errors = oscap_err_detach();
+	pthread_mutex_init(&batch.lock, NULL);
+	dI("Evaluating %zu tests in %u threads.", batch.count, thread_count);
+	for (; thread_count > 1 && started < thread_count; started++) {
+		if (pthread_create(&threads[started], NULL, _oval_result_system_eval_worker, &batch) != 0) {
+			dW("Can't start an evaluation thread: %s.", strerror(errno));
+			break;
+		}
+	}
+	/* The calling thread evaluates everything left if no thread started. */
+	if (started == 0)
+		_oval_result_system_eval_worker(&batch);
+	for (unsigned int t = 0; t < started; t++)
+		pthread_join(threads[t], NULL);
+	free(threads);
+	pthread_mutex_destroy(&batch.lock);
+
+	oscap_err_attach(errors);
+	for (size_t i = 0; i < batch.count; i++)
+		oscap_err_attach(batch.jobs[i].errors);
+	free(batch.jobs);
+
+	/* The tests are evaluated, what remains is to combine their results */
+	for (size_t i = 0; i < count; i++)
+		oval_result_definition_eval(definitions[i]);
+	return 0;
+}
+
 struct oval_result_definition *oval_result_system_prepare_definition(struct oval_result_system *sys, const char *id)
 {
         struct oval_results_model *res_model;
@@ -435,7 +569,7 @@ static void _oval_result_definition_to_dom_based_on_directives(struct oval_resul
 xmlNode *oval_result_system_to_dom(struct oval_result_system * sys,
 				   struct oval_results_model * results_model,
 				   struct oval_directives_model * directives_model, 
-				   xmlDocPtr doc, xmlNode * parent) {
+				   xmlDocPtr doc, xmlNode * parent, xmlTextWriterPtr writer) {
 
 	struct oval_result_directives * directives;
 	struct oval_result_directives * class_dirs;
@@ -443,6 +577,8 @@ xmlNode *oval_result_system_to_dom(struct oval_result_system * sys,
 
 	xmlNs *ns_results = xmlSearchNsByHref(doc, parent, OVAL_RESULTS_NAMESPACE);
 	xmlNode *system_node = xmlNewTextChild(parent, ns_results, BAD_CAST "system", NULL);
+	if (writer)
+		oscap_xml_writer_start_node(writer, system_node);
 
 	struct oval_smc *tstmap = oval_smc_new();
 
@@ -450,6 +586,8 @@ xmlNode *oval_result_system_to_dom(struct oval_result_system * sys,
 	struct oval_definition_iterator *oval_definitions = oval_definition_model_get_definitions(definition_model);
 	if(oval_definition_iterator_has_more(oval_definitions)) {
 		xmlNode *definitions_node = xmlNewTextChild(system_node, ns_results, BAD_CAST "definitions", NULL);
+		if (writer)
+			oscap_xml_writer_start_node(writer, definitions_node);
 		while(oval_definition_iterator_has_more(oval_definitions)) {
 			struct oval_definition *oval_definition = oval_definition_iterator_next(oval_definitions);
 
@@ -473,7 +611,11 @@ xmlNode *oval_result_system_to_dom(struct oval_result_system * sys,
 					_oval_result_definition_to_dom_based_on_directives(rslt_definition, directives, doc, definitions_node, tstmap);
 				}
 			}
+			if (writer)
+				oscap_xml_writer_flush_children(writer, doc, definitions_node);
 		}
+		if (writer)
+			oscap_xml_writer_end_node(writer);
 	}
 	oval_definition_iterator_free(oval_definitions);
 
@@ -486,11 +628,15 @@ xmlNode *oval_result_system_to_dom(struct oval_result_system * sys,
 	struct oval_smc_iterator *result_tests = oval_smc_iterator_new(tstmap);
 	if (oval_smc_iterator_has_more(result_tests)) {
 		xmlNode *tests_node = xmlNewTextChild(system_node, ns_results, BAD_CAST "tests", NULL);
+		if (writer)
+			oscap_xml_writer_start_node(writer, tests_node);
 		while (oval_smc_iterator_has_more(result_tests)) {
 			struct oval_state_iterator *ste_itr;
 			struct oval_result_test *result_test = oval_smc_iterator_next(result_tests);
 			/* report the test */
 			oval_result_test_to_dom(result_test, doc, tests_node);
+			if (writer)
+				oscap_xml_writer_flush_children(writer, doc, tests_node);
 			struct oval_test *oval_test = oval_result_test_get_test(result_test);
 			/* collect the objects that are referenced from reported test */
 			/* look for objects in path: test->object ...  */
@@ -525,12 +671,14 @@ xmlNode *oval_result_system_to_dom(struct oval_result_system * sys,
 			}
 			oval_state_iterator_free(ste_itr);
 		}
+		if (writer)
+			oscap_xml_writer_end_node(writer);
 	}
 	oval_smc_iterator_free(result_tests);
 
 	bool export_sys_char = oval_results_model_get_export_system_characteristics(results_model);
 	oval_syschar_model_to_dom(syschar_model, doc, system_node, 
-				  (oval_syschar_resolver *) _oval_result_system_resolve_syschar, sysmap, export_sys_char);
+				  (oval_syschar_resolver *) _oval_result_system_resolve_syschar, sysmap, export_sys_char, writer);
 
 	oval_string_map_free(sysmap, NULL);
 	oval_string_map_free(objmap, NULL);
@@ -538,6 +686,12 @@ xmlNode *oval_result_system_to_dom(struct oval_result_system * sys,
 	oval_string_map_free(varmap, NULL);
 	oval_smc_free0(tstmap);
 
+	if (writer) {
+		oscap_xml_writer_end_node(writer);
+		xmlUnlinkNode(system_node);
+		xmlFreeNode(system_node);
+		return NULL;
+	}
 	return system_node;
 }
 
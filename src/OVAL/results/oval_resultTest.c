@@ -33,8 +33,10 @@
 #include <config.h>
 #endif
 
+#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <pthread.h>
 #include "oval_agent_api_impl.h"
 #ifdef OVAL_PROBES_ENABLED
 #include "oval_probe_impl.h"
@@ -49,6 +51,7 @@
 #include "common/util.h"
 #include "common/debug_priv.h"
 #include "common/_error.h"
+#include "common/oscap_intern.h"
 
 typedef struct oval_result_test {
 	struct oval_result_system *system;
@@ -59,8 +62,22 @@ typedef struct oval_result_test {
 	struct oval_collection *bindings;
 	int instance;
 	bool bindings_initialized;
+	bool collected;			///< the object of the test has been queried, see oval_result_test_collect()
+	int collect_status;
 } oval_result_test_t;
 
+/*
+ * Local variables are computed on demand during the evaluation. Tests
+ * evaluated in parallel by oval_result_system_eval_definitions() share them.
+ */
+static pthread_mutex_t oval_result_test_variable_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Items are shared by the tests of their object, tests evaluated in parallel
+ * may copy the mask attribute of their states to the same item entity.
+ */
+static pthread_mutex_t oval_result_test_mask_lock = PTHREAD_MUTEX_INITIALIZER;
+
 struct oval_result_test *oval_result_test_new(struct oval_result_system *sys, char *tstid)
 {
 	oval_result_test_t *test = (oval_result_test_t *)
@@ -78,6 +95,8 @@ struct oval_result_test *oval_result_test_new(struct oval_result_system *sys, ch
 	test->items = oval_collection_new();
 	test->bindings = oval_collection_new();
 	test->bindings_initialized = false;
+	test->collected = false;
+	test->collect_status = 0;
 	return test;
 }
 
@@ -386,7 +405,10 @@ static inline oval_result_t _evaluate_sysent_with_variable(struct oval_syschar_m
 	oval_syschar_collection_flag_t flag;
 	oval_result_t ent_val_res;
 
-	if (0 != oval_syschar_model_compute_variable(syschar_model, state_entity_var)) {
+	pthread_mutex_lock(&oval_result_test_variable_lock);
+	int ret = oval_syschar_model_compute_variable(syschar_model, state_entity_var);
+	pthread_mutex_unlock(&oval_result_test_variable_lock);
+	if (ret != 0) {
 		return -1;
 	}
 
@@ -509,186 +531,315 @@ static oval_result_t _evaluate_sysent_record(struct oval_syschar_model *syschar_
 	return ores_get_result_byopr(&record_ores, OVAL_OPERATOR_AND);
 }
 
-static inline oval_result_t _evaluate_sysent(struct oval_syschar_model *syschar_model, struct oval_sysent *item_entity, struct oval_entity *state_entity, oval_operation_t state_entity_operation, struct oval_state_content *content)
+/*
+ * A state entity prepared for the evaluation of many items. The value is
+ * parsed, or its pattern compiled, once per test rather than once per item.
+ */
+struct oval_state_plan_entity {
+	struct oval_state_content *content;
+	struct oval_entity *entity;
+	const char *name;			///< interned name of the item entities to compare with
+	const char *error;			///< internal error reported instead of the comparison
+	oval_operation_t operation;
+	oval_check_t entity_check;
+	oval_existence_t check_existence;
+	bool mask;
+	struct oval_variable *variable;		///< the entity refers to a variable
+	oval_check_t var_check;
+	bool record;				///< the entity is of the record type
+	struct oval_cmp_value *value;		///< otherwise its value prepared for comparison
+	size_t *slots;				///< indexes of the item entities with the name
+	size_t slot_count;
+};
+
+struct oval_state_plan {
+	struct oval_state *state;
+	oval_operator_t operator;
+	struct oval_state_plan_entity *entities;
+	size_t entity_count;
+};
+
+/*
+ * States of a test together with the entities of the item being evaluated.
+ * Items collected for one object have their entities in the same order, the
+ * slots of the state entities are searched again only if the order changes.
+ */
+struct oval_test_plan {
+	struct oval_state_plan *states;
+	size_t state_count;
+	struct oval_sysent **sysents;		///< entities of the current item
+	size_t sysent_count;
+	size_t sysent_capacity;
+	struct oval_status_counter counter;	///< statuses of the entities of the current item
+	const char **layout;			///< entity names the slots were searched for
+	size_t layout_count;
+};
+
+static void _oval_state_plan_entity_init(struct oval_state_plan_entity *ent, struct oval_state *state, struct oval_state_content *content)
 {
-	if (oval_sysent_get_status(item_entity) == SYSCHAR_STATUS_DOES_NOT_EXIST) {
-		return OVAL_RESULT_FALSE;
-	} else if (oval_entity_get_varref_type(state_entity) == OVAL_ENTITY_VARREF_ATTRIBUTE) {
-		struct oval_variable *state_entity_var;
-		if ((state_entity_var = oval_entity_get_variable(state_entity)) == NULL) {
-			oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL variable");
-			return -1;
-		}
-		const char *sys_data = oval_sysent_get_value(item_entity);
-		oval_check_t var_check = oval_state_content_get_var_check(content);
+	ent->content = content;
+	if (content == NULL) {
+		ent->error = "OVAL internal error: found NULL state content";
+		return;
+	}
+	if ((ent->entity = oval_state_content_get_entity(content)) == NULL) {
+		ent->error = "OVAL internal error: found NULL entity";
+		return;
+	}
+	const char *name = oval_entity_get_name(ent->entity);
+	if (name == NULL) {
+		ent->error = "OVAL internal error: found NULL entity name";
+		return;
+	}
 
-		return _evaluate_sysent_with_variable(syschar_model,
-				state_entity_var, sys_data,
-				state_entity_operation, var_check);
+	if (oscap_streq(name, "line") &&
+		oval_state_get_subtype(state) == (oval_subtype_t) OVAL_INDEPENDENT_TEXT_FILE_CONTENT) {
+		/* Hack: textfilecontent_state/line shall be compared against textfilecontent_item/text.
+		 *
+		 * textfilecontent_test and textfilecontent54_test share the same syschar
+		 * (textfilecontent_item). In OVAL 5.3 and below this syschar did not hold any usable
+		 * information ('text' ent). In OVAL 5.4 textfilecontent_test was deprecated. But the
+		 * 'text' ent has been added to textfilecontent_item, making it potentially usable. */
+		oval_schema_version_t over = oval_state_get_platform_schema_version(state);
+		if (oval_schema_version_cmp(over, OVAL_SCHEMA_VERSION(5.4)) >= 0) {
+			/* The OVAL-5.3 does not have textfilecontent_item/text */
+			name = "text";
+		}
+	}
+	/* Entity names are interned, the slots can be found by comparing the addresses */
+	ent->name = oscap_intern(name);
+	ent->entity_check = oval_state_content_get_ent_check(content);
+	ent->check_existence = oval_state_content_get_check_existence(content);
+	ent->operation = oval_entity_get_operation(ent->entity);
+	ent->mask = oval_entity_get_mask(ent->entity);
+
+	if (oval_entity_get_varref_type(ent->entity) == OVAL_ENTITY_VARREF_ATTRIBUTE) {
+		if ((ent->variable = oval_entity_get_variable(ent->entity)) == NULL)
+			ent->error = "OVAL internal error: found NULL variable";
+		ent->var_check = oval_state_content_get_var_check(content);
+	} else if (oval_entity_get_datatype(ent->entity) == OVAL_DATATYPE_RECORD) {
+		ent->record = true;
 	} else {
-		struct oval_value *state_entity_val;
-		char *state_entity_val_text;
-		oval_datatype_t state_entity_val_datatype;
-
-		oval_datatype_t state_entity_type = oval_entity_get_datatype(state_entity);
-		if (state_entity_type == OVAL_DATATYPE_RECORD) {
-			if (state_entity_operation != OVAL_OPERATION_EQUALS) {
-				dE("The only allowed operation for comparing record types is 'equals'.");
-				return OVAL_RESULT_ERROR;
-			}
-			return _evaluate_sysent_record(syschar_model, content, item_entity);
+		struct oval_value *value = oval_entity_get_value(ent->entity);
+		char *text;
+		if (value == NULL) {
+			ent->error = "OVAL internal error: found NULL entity value";
+		} else if ((text = oval_value_get_text(value)) == NULL) {
+			ent->error = "OVAL internal error: found NULL entity value text";
 		} else {
-			if ((state_entity_val = oval_entity_get_value(state_entity)) == NULL) {
-				oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL entity value");
-				return -1;
-			}
-			if ((state_entity_val_text = oval_value_get_text(state_entity_val)) == NULL) {
-				oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL entity value text");
-				return -1;
+			ent->value = oval_cmp_value_new(text, oval_value_get_datatype(value), ent->operation);
+		}
+	}
+}
+
+static struct oval_test_plan *oval_test_plan_new(struct oval_test *test)
+{
+	struct oval_test_plan *plan = calloc(1, sizeof(struct oval_test_plan));
+	struct oval_state_iterator *ste_itr = oval_test_get_states(test);
+	while (oval_state_iterator_has_more(ste_itr)) {
+		oval_state_iterator_next(ste_itr);
+		plan->state_count++;
+	}
+	oval_state_iterator_free(ste_itr);
+	plan->states = calloc(plan->state_count, sizeof(struct oval_state_plan));
+
+	size_t idx = 0;
+	ste_itr = oval_test_get_states(test);
+	while (oval_state_iterator_has_more(ste_itr) && idx < plan->state_count) {
+		struct oval_state_plan *ste_plan = &plan->states[idx++];
+		ste_plan->state = oval_state_iterator_next(ste_itr);
+		ste_plan->operator = oval_state_get_operator(ste_plan->state);
+
+		struct oval_state_content_iterator *contents_itr = oval_state_get_contents(ste_plan->state);
+		while (oval_state_content_iterator_has_more(contents_itr)) {
+			oval_state_content_iterator_next(contents_itr);
+			ste_plan->entity_count++;
+		}
+		oval_state_content_iterator_free(contents_itr);
+		ste_plan->entities = calloc(ste_plan->entity_count, sizeof(struct oval_state_plan_entity));
+
+		size_t ent_idx = 0;
+		contents_itr = oval_state_get_contents(ste_plan->state);
+		while (oval_state_content_iterator_has_more(contents_itr) && ent_idx < ste_plan->entity_count) {
+			struct oval_state_content *content = oval_state_content_iterator_next(contents_itr);
+			_oval_state_plan_entity_init(&ste_plan->entities[ent_idx++], ste_plan->state, content);
+		}
+		oval_state_content_iterator_free(contents_itr);
+	}
+	oval_state_iterator_free(ste_itr);
+	return plan;
+}
+
+static void oval_test_plan_free(struct oval_test_plan *plan)
+{
+	for (size_t i = 0; i < plan->state_count; i++) {
+		struct oval_state_plan *ste_plan = &plan->states[i];
+		for (size_t j = 0; j < ste_plan->entity_count; j++) {
+			oval_cmp_value_free(ste_plan->entities[j].value);
+			oscap_intern_release(ste_plan->entities[j].name);
+			free(ste_plan->entities[j].slots);
+		}
+		free(ste_plan->entities);
+	}
+	free(plan->states);
+	free(plan->sysents);
+	free(plan->layout);
+	free(plan);
+}
+
+static void _oval_test_plan_find_slots(struct oval_test_plan *plan)
+{
+	for (size_t i = 0; i < plan->state_count; i++) {
+		struct oval_state_plan *ste_plan = &plan->states[i];
+		for (size_t j = 0; j < ste_plan->entity_count; j++) {
+			struct oval_state_plan_entity *ent = &ste_plan->entities[j];
+			if (ent->name == NULL)
+				continue;
+			ent->slot_count = 0;
+			for (size_t slot = 0; slot < plan->sysent_count; slot++) {
+				if (oval_sysent_get_name(plan->sysents[slot]) == ent->name) {
+					if (ent->slot_count == 0)
+						ent->slots = realloc(ent->slots, plan->sysent_count * sizeof(size_t));
+					ent->slots[ent->slot_count++] = slot;
+				}
 			}
-			state_entity_val_datatype = oval_value_get_datatype(state_entity_val);
+		}
+	}
+	for (size_t slot = 0; slot < plan->sysent_count; slot++)
+		plan->layout[slot] = oval_sysent_get_name(plan->sysents[slot]);
+	plan->layout_count = plan->sysent_count;
+}
 
-			const char *sys_data = oval_sysent_get_value(item_entity);
-			return oval_str_cmp_str(state_entity_val_text, state_entity_val_datatype, sys_data, state_entity_operation);
+static bool oval_test_plan_load_item(struct oval_test_plan *plan, struct oval_sysitem *item)
+{
+	plan->sysent_count = 0;
+	oval_status_counter_clear(&plan->counter);
+
+	struct oval_sysent_iterator *item_entities_itr = oval_sysitem_get_sysents(item);
+	while (oval_sysent_iterator_has_more(item_entities_itr)) {
+		struct oval_sysent *item_entity = oval_sysent_iterator_next(item_entities_itr);
+		if (item_entity == NULL) {
+			oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL sysent");
+			oval_sysent_iterator_free(item_entities_itr);
+			return false;
+		}
+		oval_status_counter_add_status(&plan->counter, oval_sysent_get_status(item_entity));
+		if (plan->sysent_count == plan->sysent_capacity) {
+			plan->sysent_capacity = plan->sysent_capacity ? 2 * plan->sysent_capacity : 32;
+			plan->sysents = realloc(plan->sysents, plan->sysent_capacity * sizeof(struct oval_sysent *));
+			plan->layout = realloc(plan->layout, plan->sysent_capacity * sizeof(const char *));
 		}
+		plan->sysents[plan->sysent_count++] = item_entity;
 	}
+	oval_sysent_iterator_free(item_entities_itr);
+
+	/* Entity names are interned, equal names have equal addresses */
+	bool same_layout = plan->layout_count == plan->sysent_count;
+	for (size_t slot = 0; same_layout && slot < plan->sysent_count; slot++)
+		same_layout = oval_sysent_get_name(plan->sysents[slot]) == plan->layout[slot];
+	if (!same_layout)
+		_oval_test_plan_find_slots(plan);
+	return true;
 }
 
-static oval_result_t eval_item(struct oval_syschar_model *syschar_model, struct oval_sysitem *cur_sysitem, struct oval_state *state)
+static inline oval_result_t _evaluate_sysent(struct oval_syschar_model *syschar_model, struct oval_sysent *item_entity, const struct oval_state_plan_entity *ent)
+{
+	if (oval_sysent_get_status(item_entity) == SYSCHAR_STATUS_DOES_NOT_EXIST) {
+		return OVAL_RESULT_FALSE;
+	} else if (ent->error != NULL) {
+		oscap_seterr(OSCAP_EFAMILY_OVAL, "%s", ent->error);
+		return -1;
+	} else if (ent->variable != NULL) {
+		const char *sys_data = oval_sysent_get_value(item_entity);
+
+		return _evaluate_sysent_with_variable(syschar_model,
+				ent->variable, sys_data,
+				ent->operation, ent->var_check);
+	} else if (ent->record) {
+		if (ent->operation != OVAL_OPERATION_EQUALS) {
+			dE("The only allowed operation for comparing record types is 'equals'.");
+			return OVAL_RESULT_ERROR;
+		}
+		return _evaluate_sysent_record(syschar_model, ent->content, item_entity);
+	} else {
+		const char *sys_data = oval_sysent_get_value(item_entity);
+		return oval_cmp_value_cmp_str(ent->value, sys_data);
+	}
+}
+
+/*
+ * Evaluate the item loaded by oval_test_plan_load_item() against a state
+ */
+static oval_result_t eval_item(struct oval_syschar_model *syschar_model, struct oval_test_plan *plan, struct oval_state_plan *ste_plan, struct oval_sysitem *cur_sysitem)
 {
-	struct oval_state_content_iterator *state_contents_itr;
 	struct oresults ste_ores;
-	oval_operator_t operator;
 	oval_result_t result = OVAL_RESULT_ERROR;
 
 	ores_clear(&ste_ores);
 
-	state_contents_itr = oval_state_get_contents(state);
-	while (oval_state_content_iterator_has_more(state_contents_itr)) {
-		struct oval_state_content *content;
-		struct oval_entity *state_entity;
-		char *state_entity_name;
-		oval_operation_t state_entity_operation;
-		oval_check_t entity_check;
-		oval_existence_t check_existence;
+	for (size_t i = 0; i < ste_plan->entity_count; i++) {
+		struct oval_state_plan_entity *ent = &ste_plan->entities[i];
 		oval_result_t ste_ent_res;
-		struct oval_sysent_iterator *item_entities_itr;
 		struct oresults ent_ores;
-		struct oval_status_counter counter;
-		bool found_matching_item;
-
-		if ((content = oval_state_content_iterator_next(state_contents_itr)) == NULL) {
-			oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL state content");
-			goto fail;
-		}
-		if ((state_entity = oval_state_content_get_entity(content)) == NULL) {
-			oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL entity");
-			goto fail;
-		}
-		if ((state_entity_name = oval_entity_get_name(state_entity)) == NULL) {
-			oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL entity name");
-			goto fail;
-		}
 
-		if (oscap_streq(state_entity_name, "line") &&
-			oval_state_get_subtype(state) == (oval_subtype_t) OVAL_INDEPENDENT_TEXT_FILE_CONTENT) {
-			/* Hack: textfilecontent_state/line shall be compared against textfilecontent_item/text.
-			 *
-			 * textfilecontent_test and textfilecontent54_test share the same syschar
-			 * (textfilecontent_item). In OVAL 5.3 and below this syschar did not hold any usable
-			 * information ('text' ent). In OVAL 5.4 textfilecontent_test was deprecated. But the
-			 * 'text' ent has been added to textfilecontent_item, making it potentially usable. */
-			oval_schema_version_t over = oval_state_get_platform_schema_version(state);
-			if (oval_schema_version_cmp(over, OVAL_SCHEMA_VERSION(5.4)) >= 0) {
-				/* The OVAL-5.3 does not have textfilecontent_item/text */
-				state_entity_name = "text";
-			}
+		if (ent->name == NULL) {
+			oscap_seterr(OSCAP_EFAMILY_OVAL, "%s", ent->error);
+			return OVAL_RESULT_ERROR;
 		}
 
-		entity_check = oval_state_content_get_ent_check(content);
-		check_existence = oval_state_content_get_check_existence(content);
-		state_entity_operation = oval_entity_get_operation(state_entity);
-
 		ores_clear(&ent_ores);
-		found_matching_item = false;
-		oval_status_counter_clear(&counter);
 
-		item_entities_itr = oval_sysitem_get_sysents(cur_sysitem);
-		while (oval_sysent_iterator_has_more(item_entities_itr)) {
-			struct oval_sysent *item_entity;
+		for (size_t j = 0; j < ent->slot_count; j++) {
+			struct oval_sysent *item_entity = plan->sysents[ent->slots[j]];
 			oval_result_t ent_val_res;
-			char *item_entity_name;
-			oval_syschar_status_t item_status;
-
-			item_entity = oval_sysent_iterator_next(item_entities_itr);
-			if (item_entity == NULL) {
-				oscap_seterr(OSCAP_EFAMILY_OVAL, "OVAL internal error: found NULL sysent");
-				oval_sysent_iterator_free(item_entities_itr);
-				goto fail;
-			}
-			item_status = oval_sysent_get_status(item_entity);
-			oval_status_counter_add_status(&counter, item_status);
-
-			item_entity_name = oval_sysent_get_name(item_entity);
-			if (strcmp(item_entity_name, state_entity_name))
-				continue;
-
-			found_matching_item = true;
 
 			/* copy mask attribute from state to item */
-			if (oval_entity_get_mask(state_entity))
+			if (ent->mask) {
+				pthread_mutex_lock(&oval_result_test_mask_lock);
 				oval_sysent_set_mask(item_entity,1);
+				pthread_mutex_unlock(&oval_result_test_mask_lock);
+			}
 
-			ent_val_res = _evaluate_sysent(syschar_model, item_entity, state_entity,
-					state_entity_operation, content);
+			ent_val_res = _evaluate_sysent(syschar_model, item_entity, ent);
 			if (ent_val_res == OVAL_RESULT_TRUE) {
 				dI("Entity '%s'='%s' of item '%s' matches corresponding entity in state '%s'.",
 						oval_sysent_get_name(item_entity),
 						oval_sysent_get_value(item_entity),
-						oval_sysitem_get_id(cur_sysitem), oval_state_get_id(state));
+						oval_sysitem_get_id(cur_sysitem), oval_state_get_id(ste_plan->state));
 			}
 			if (ent_val_res == OVAL_RESULT_ERROR) {
 				dI("Comparing entity '%s'='%s' of item '%s' to corresponding entity in state '%s' was not successful.",
 						oval_sysent_get_name(item_entity),
 						oval_sysent_get_value(item_entity),
-						oval_sysitem_get_id(cur_sysitem), oval_state_get_id(state));
+						oval_sysitem_get_id(cur_sysitem), oval_state_get_id(ste_plan->state));
 			}
 			if (((signed) ent_val_res) == -1) {
-				oval_sysent_iterator_free(item_entities_itr);
-				goto fail;
+				return OVAL_RESULT_ERROR;
 			}
 
 			ores_add_res(&ent_ores, ent_val_res);
 		}
-		oval_sysent_iterator_free(item_entities_itr);
 
-		if (!found_matching_item)
+		if (ent->slot_count == 0)
 			dW("Entity name '%s' from state (id: '%s') not found in item (id: '%s').",
-			   state_entity_name, oval_state_get_id(state), oval_sysitem_get_id(cur_sysitem));
+			   ent->name, oval_state_get_id(ste_plan->state), oval_sysitem_get_id(cur_sysitem));
 
-		oval_result_t cres = oval_status_counter_get_result(&counter, check_existence);
+		oval_result_t cres = oval_status_counter_get_result(&plan->counter, ent->check_existence);
 		/* The entity check results are only relevant when the check existence is satisfied */
 		if (cres == OVAL_RESULT_TRUE) {
-			ste_ent_res = ores_get_result_bychk(&ent_ores, entity_check);
+			ste_ent_res = ores_get_result_bychk(&ent_ores, ent->entity_check);
 			ores_add_res(&ste_ores, ste_ent_res);
 		} else {
 			ores_add_res(&ste_ores, cres);
 		}
 	}
-	oval_state_content_iterator_free(state_contents_itr);
 
-	operator = oval_state_get_operator(state);
-	result = ores_get_result_byopr(&ste_ores, operator);
+	result = ores_get_result_byopr(&ste_ores, ste_plan->operator);
 	dI("Item '%s' compared to state '%s' with result %s.",
-			   oval_sysitem_get_id(cur_sysitem), oval_state_get_id(state),
+			   oval_sysitem_get_id(cur_sysitem), oval_state_get_id(ste_plan->state),
 			   oval_result_get_text(result));
 
 	return result;
-
- fail:
-	oval_state_content_iterator_free(state_contents_itr);
-
-	return OVAL_RESULT_ERROR;
 }
 
 #define ITEMMAP (struct oval_string_map    *)args[2]
@@ -711,6 +862,7 @@ static oval_result_t eval_check_state(struct oval_test *test, void **args)
 {
 	struct oval_syschar_model *syschar_model;
 	struct oval_result_item_iterator *ritems_itr;
+	struct oval_test_plan *plan;
 	struct oresults item_ores;
 	oval_result_t result;
 	oval_check_t ste_check;
@@ -728,13 +880,14 @@ static oval_result_t eval_check_state(struct oval_test *test, void **args)
 		free(state_names);
 	}
 
+	/* States are prepared once and evaluated against all the items */
+	plan = oval_test_plan_new(test);
 	ritems_itr = oval_result_test_get_items(TEST);
 	while (oval_result_item_iterator_has_more(ritems_itr)) {
 		struct oval_result_item *ritem;
 		struct oval_sysitem *item;
 		oval_syschar_status_t item_status;
 		struct oresults ste_ores;
-		struct oval_state_iterator *ste_itr;
 		oval_result_t item_res;
 
 		ritem = oval_result_item_iterator_next(ritems_itr);
@@ -759,22 +912,20 @@ static oval_result_t eval_check_state(struct oval_test *test, void **args)
 
 		ores_clear(&ste_ores);
 
-		ste_itr = oval_test_get_states(test);
-		while (oval_state_iterator_has_more(ste_itr)) {
-			struct oval_state *ste;
+		bool loaded = oval_test_plan_load_item(plan, item);
+		for (size_t i = 0; i < plan->state_count; i++) {
 			oval_result_t ste_res;
 
-			ste = oval_state_iterator_next(ste_itr);
-			ste_res = eval_item(syschar_model, item, ste);
+			ste_res = loaded ? eval_item(syschar_model, plan, &plan->states[i], item) : OVAL_RESULT_ERROR;
 			ores_add_res(&ste_ores, ste_res);
 		}
-		oval_state_iterator_free(ste_itr);
 
 		item_res = ores_get_result_byopr(&ste_ores, ste_opr);
 		ores_add_res(&item_ores, item_res);
 		oval_result_item_set_result(ritem, item_res);
 	}
 	oval_result_item_iterator_free(ritems_itr);
+	oval_test_plan_free(plan);
 
 	result = ores_get_result_bychk(&item_ores, ste_check);
 
@@ -1024,14 +1175,9 @@ static oval_result_t _oval_result_test_result(struct oval_result_test *rtest, vo
 	char * object_id = oval_object_get_id(object);
 
 	struct oval_result_system *sys = oval_result_test_get_system(rtest);
-	struct oval_results_model *results_model = oval_result_system_get_results_model(sys);
-	struct oval_probe_session *probe_session = oval_results_model_get_probe_session(results_model);
-	if (probe_session != NULL) {
-		/* probe test */
-		int ret = oval_probe_query_test(probe_session, test);
-		if (ret != 0) {
-			return ret;
-		}
+	int ret = oval_result_test_collect(rtest);
+	if (ret != 0) {
+		return ret;
 	}
 
 	struct oval_syschar_model *syschar_model = oval_result_system_get_syschar_model(sys);
@@ -1060,6 +1206,8 @@ static void _oval_result_test_initialize_bindings(struct oval_result_test *rslt_
 	struct oval_state_iterator *ste_itr;
 	struct oval_iterator *var_itr;
 
+	/* The values of the variables may be being computed by another test */
+	pthread_mutex_lock(&oval_result_test_variable_lock);
 	vm = oval_string_map_new();
 
 	/* Gather bindings pertaining to the referenced states */
@@ -1130,10 +1278,36 @@ static void _oval_result_test_initialize_bindings(struct oval_result_test *rslt_
 	}
 
 	oval_string_map_free(vm, NULL);
+	pthread_mutex_unlock(&oval_result_test_variable_lock);
 
 	rslt_test->bindings_initialized = true;
 }
 
+int oval_result_test_collect(struct oval_result_test *rtest)
+{
+	__attribute__nonnull__(rtest);
+
+#if defined(OVAL_PROBES_ENABLED)
+	if (!rtest->collected) {
+		struct oval_results_model *results_model = oval_result_system_get_results_model(rtest->system);
+		struct oval_probe_session *probe_session = oval_results_model_get_probe_session(results_model);
+		if (probe_session != NULL) {
+			/* probe test */
+			rtest->collect_status = oval_probe_query_test(probe_session, rtest->test);
+		}
+		rtest->collected = true;
+	}
+#endif
+	return rtest->collect_status;
+}
+
+bool oval_result_test_is_collected(const struct oval_result_test *rtest)
+{
+	__attribute__nonnull__(rtest);
+
+	return rtest->collected;
+}
+
 oval_result_t oval_result_test_eval(struct oval_result_test *rtest)
 {
 	__attribute__nonnull__(rtest);
@@ -43,7 +43,19 @@
 
 
 int oval_result_system_parse_tag(xmlTextReaderPtr, struct oval_parser_context *, void *);
-xmlNode *oval_result_system_to_dom(struct oval_result_system *, struct oval_results_model *, struct oval_directives_model *, xmlDocPtr, xmlNode *);
+/**
+ * Stream the oval_results element to an open writer. Only the part being
+ * serialized is kept as DOM, so memory doesn't grow with the number of items.
+ * @return 0 on success, -1 on failure
+ */
+int oval_results_model_write(struct oval_results_model *, struct oval_directives_model *, xmlTextWriterPtr writer);
+/**
+ * Same as oval_results_model_export(), but streams the document to the file
+ * by oval_results_model_write() instead of building it in memory first.
+ */
+int oval_results_model_export_stream(struct oval_results_model *, struct oval_directives_model *, const char *file);
+/* With a writer, the element is streamed to it as it is built and NULL is returned */
+xmlNode *oval_result_system_to_dom(struct oval_result_system *, struct oval_results_model *, struct oval_directives_model *, xmlDocPtr, xmlNode *, xmlTextWriterPtr);
 
 struct oval_result_test *oval_result_system_get_new_test(struct oval_result_system *, struct oval_test *, int variable_instance);
 
@@ -107,5 +119,22 @@ const char *oval_result_test_get_id(const struct oval_result_test *test);
 
 struct oval_result_definition *oval_result_system_prepare_definition(struct oval_result_system *sys, const char *id);
 
+/*
+ * Collect the object of the test and the objects of the variables its states
+ * refer to, unless it has been done already.
+ * @returns the status of oval_probe_query_test(), 0 if nothing was collected
+ */
+int oval_result_test_collect(struct oval_result_test *rtest);
+
+bool oval_result_test_is_collected(const struct oval_result_test *rtest);
+
+/*
+ * Evaluate the definitions, running the evaluation of the tests they consist
+ * of in up to max_threads threads. The objects are collected beforehand in
+ * the order oval_result_definition_eval() would collect them one by one, so
+ * the results are the same as if the definitions were evaluated in sequence.
+ */
+int oval_result_system_eval_definitions(struct oval_result_system *sys, struct oval_result_definition **definitions, size_t count, unsigned int max_threads);
+
 
 #endif				/* OVAL_RESULTS_IMPL_H_ */
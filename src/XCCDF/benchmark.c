@@ -53,17 +53,26 @@ struct xccdf_backref {
 
 struct xccdf_benchmark *xccdf_benchmark_import_source(struct oscap_source *source)
 {
-	xmlTextReader *reader = oscap_source_get_xmlTextReader(source);
-
-	while (xmlTextReaderRead(reader) == 1 && xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT) ;
-	struct xccdf_benchmark *benchmark = xccdf_benchmark_new();
-	const bool parse_result = xccdf_benchmark_parse(XITEM(benchmark), reader);
-	xmlFreeTextReader(reader);
-
-	if (!parse_result) { // parsing fatal error
-		oscap_seterr(OSCAP_EFAMILY_XML, "Failed to import XCCDF content from '%s'.", oscap_source_readable_origin(source));
-		xccdf_benchmark_free(benchmark);
-		return NULL;
+	struct xccdf_benchmark *benchmark = oscap_source_cache_load(source, OSCAP_CONTENT_CACHE_XCCDF,
+			(oscap_content_cache_read_func) xccdf_benchmark_cache_read, (oscap_destruct_func) xccdf_benchmark_free);
+	if (benchmark == NULL) {
+		xmlTextReader *reader = oscap_source_get_xmlTextReader(source);
+
+		while (xmlTextReaderRead(reader) == 1 && xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT) ;
+		benchmark = xccdf_benchmark_new();
+		const bool parse_result = xccdf_benchmark_parse(XITEM(benchmark), reader);
+		xmlFreeTextReader(reader);
+
+		if (!parse_result) { // parsing fatal error
+			oscap_seterr(OSCAP_EFAMILY_XML, "Failed to import XCCDF content from '%s'.", oscap_source_readable_origin(source));
+			xccdf_benchmark_free(benchmark);
+			return NULL;
+		}
+		// TestResults aren't serialized, the cache is meant for the content being evaluated
+		if (oscap_list_get_itemcount(XITEM(benchmark)->sub.benchmark.results) == 0) {
+			oscap_source_cache_store(source, OSCAP_CONTENT_CACHE_XCCDF,
+					(oscap_content_cache_write_func) xccdf_benchmark_cache_write, benchmark);
+		}
 	}
 
 	// This is sadly the only place where we can pass origin file information
@@ -0,0 +1,768 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Serialization of XCCDF Benchmark for the content cache. The payload
+ * follows the item tree in document order and the reader rebuilds it the
+ * same way the parser does: items are created with their parent set and
+ * registered in the benchmark before their children. The reader adds every
+ * object to its parent as soon as it's created, so a malformed entry is
+ * disposed of by freeing the benchmark.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdlib.h>
+
+#include "item.h"
+#include "helpers.h"
+#include "CPE/cpedict_priv.h"
+#include "CPE/cpelang_priv.h"
+#include "common/oscap_content_cache.h"
+
+static void _write_text_opt(struct oscap_buffer *buf, const struct oscap_text *text)
+{
+	oscap_cache_write_bool(buf, text != NULL);
+	if (text != NULL)
+		oscap_cache_write_text(buf, text);
+}
+
+static struct oscap_text *_read_text_opt(struct oscap_cache_reader *reader)
+{
+	return oscap_cache_read_bool(reader) ? oscap_cache_read_text(reader) : NULL;
+}
+
+static uint16_t _pack_flags(const struct xccdf_flags *flags)
+{
+	return flags->selected
+		| flags->hidden << 1
+		| flags->resolved << 2
+		| flags->abstract << 3
+		| flags->prohibit_changes << 4
+		| flags->interactive << 5
+		| flags->multiple << 6;
+}
+
+static void _unpack_flags(uint16_t bits, struct xccdf_flags *flags)
+{
+	flags->selected = bits & 1;
+	flags->hidden = (bits >> 1) & 1;
+	flags->resolved = (bits >> 2) & 1;
+	flags->abstract = (bits >> 3) & 1;
+	flags->prohibit_changes = (bits >> 4) & 1;
+	flags->interactive = (bits >> 5) & 1;
+	flags->multiple = (bits >> 6) & 1;
+}
+
+static uint16_t _pack_defflags(const struct xccdf_defflags *flags)
+{
+	return flags->selected
+		| flags->hidden << 1
+		| flags->resolved << 2
+		| flags->abstract << 3
+		| flags->prohibit_changes << 4
+		| flags->interactive << 5
+		| flags->multiple << 6
+		| flags->weight << 7
+		| flags->role << 8
+		| flags->severity << 9;
+}
+
+static void _unpack_defflags(uint16_t bits, struct xccdf_defflags *flags)
+{
+	flags->selected = bits & 1;
+	flags->hidden = (bits >> 1) & 1;
+	flags->resolved = (bits >> 2) & 1;
+	flags->abstract = (bits >> 3) & 1;
+	flags->prohibit_changes = (bits >> 4) & 1;
+	flags->interactive = (bits >> 5) & 1;
+	flags->multiple = (bits >> 6) & 1;
+	flags->weight = (bits >> 7) & 1;
+	flags->role = (bits >> 8) & 1;
+	flags->severity = (bits >> 9) & 1;
+}
+
+/* Requires of rules and groups are lists of lists of ids */
+static void _write_requires(struct oscap_buffer *buf, struct oscap_list *requires)
+{
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(requires));
+	struct oscap_iterator *it = oscap_iterator_new(requires);
+	while (oscap_iterator_has_more(it))
+		oscap_cache_write_string_list(buf, oscap_iterator_next(it));
+	oscap_iterator_free(it);
+}
+
+static void _read_requires(struct oscap_cache_reader *reader, struct oscap_list *requires)
+{
+	uint32_t count = oscap_cache_read_count(reader, sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct oscap_list *ids = oscap_list_new();
+		oscap_list_add(requires, ids);
+		oscap_cache_read_string_list(reader, ids);
+	}
+}
+
+static void _write_item_base(struct oscap_buffer *buf, const struct xccdf_item_base *base)
+{
+	oscap_cache_write_str(buf, base->id);
+	oscap_cache_write_str(buf, base->cluster_id);
+	oscap_cache_write_str(buf, base->extends);
+	oscap_cache_write_float(buf, base->weight);
+	oscap_cache_write_text_list(buf, base->title);
+	oscap_cache_write_text_list(buf, base->description);
+	oscap_cache_write_text_list(buf, base->question);
+	oscap_cache_write_text_list(buf, base->rationale);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(base->warnings));
+	struct oscap_iterator *it = oscap_iterator_new(base->warnings);
+	while (oscap_iterator_has_more(it)) {
+		const struct xccdf_warning *warning = oscap_iterator_next(it);
+		_write_text_opt(buf, warning->text);
+		oscap_cache_write_u32(buf, warning->category);
+	}
+	oscap_iterator_free(it);
+
+	oscap_cache_write_str(buf, base->version);
+	oscap_cache_write_str(buf, base->version_update);
+	oscap_cache_write_str(buf, base->version_time);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(base->statuses));
+	it = oscap_iterator_new(base->statuses);
+	while (oscap_iterator_has_more(it)) {
+		const struct xccdf_status *status = oscap_iterator_next(it);
+		oscap_cache_write_u32(buf, status->status);
+		oscap_cache_write_u64(buf, (uint64_t) status->date);
+	}
+	oscap_iterator_free(it);
+
+	oscap_cache_write_reference_list(buf, base->dc_statuses);
+	oscap_cache_write_reference_list(buf, base->references);
+	oscap_cache_write_string_list(buf, base->platforms);
+	oscap_cache_write_u32(buf, _pack_flags(&base->flags));
+	oscap_cache_write_u32(buf, _pack_defflags(&base->defined_flags));
+	oscap_cache_write_string_list(buf, base->metadata);
+}
+
+static void _read_item_base(struct oscap_cache_reader *reader, struct xccdf_item_base *base)
+{
+	base->id = oscap_cache_read_str(reader);
+	base->cluster_id = oscap_cache_read_str(reader);
+	base->extends = oscap_cache_read_str(reader);
+	base->weight = oscap_cache_read_float(reader);
+	oscap_cache_read_text_list(reader, base->title);
+	oscap_cache_read_text_list(reader, base->description);
+	oscap_cache_read_text_list(reader, base->question);
+	oscap_cache_read_text_list(reader, base->rationale);
+
+	uint32_t count = oscap_cache_read_count(reader, 1 + sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct xccdf_warning *warning = xccdf_warning_new();
+		oscap_list_add(base->warnings, warning);
+		warning->text = _read_text_opt(reader);
+		warning->category = oscap_cache_read_u32(reader);
+	}
+
+	base->version = oscap_cache_read_str(reader);
+	base->version_update = oscap_cache_read_str(reader);
+	base->version_time = oscap_cache_read_str(reader);
+
+	count = oscap_cache_read_count(reader, sizeof(uint32_t) + sizeof(uint64_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct xccdf_status *status = xccdf_status_new();
+		oscap_list_add(base->statuses, status);
+		status->status = oscap_cache_read_u32(reader);
+		status->date = (time_t) oscap_cache_read_u64(reader);
+	}
+
+	oscap_cache_read_reference_list(reader, base->dc_statuses);
+	oscap_cache_read_reference_list(reader, base->references);
+	oscap_cache_read_string_list(reader, base->platforms);
+	_unpack_flags(oscap_cache_read_u32(reader), &base->flags);
+	_unpack_defflags(oscap_cache_read_u32(reader), &base->defined_flags);
+	oscap_cache_read_string_list(reader, base->metadata);
+}
+
+static void _write_check(struct oscap_buffer *buf, const struct xccdf_check *check)
+{
+	oscap_cache_write_u32(buf, check->oper);
+	oscap_cache_write_str(buf, check->id);
+	oscap_cache_write_str(buf, check->system);
+	oscap_cache_write_str(buf, check->selector);
+	oscap_cache_write_str(buf, check->content);
+	oscap_cache_write_u8(buf, check->flags.multicheck
+			| check->flags.def_multicheck << 1
+			| check->flags.negate << 2
+			| check->flags.def_negate << 3);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(check->imports));
+	OSCAP_FOR(xccdf_check_import, import, xccdf_check_get_imports(check)) {
+		oscap_cache_write_str(buf, import->name);
+		oscap_cache_write_str(buf, import->xpath);
+		oscap_cache_write_str(buf, import->content);
+	}
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(check->exports));
+	OSCAP_FOR(xccdf_check_export, export, xccdf_check_get_exports(check)) {
+		oscap_cache_write_str(buf, export->name);
+		oscap_cache_write_str(buf, export->value);
+	}
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(check->content_refs));
+	OSCAP_FOR(xccdf_check_content_ref, ref, xccdf_check_get_content_refs(check)) {
+		oscap_cache_write_str(buf, ref->href);
+		oscap_cache_write_str(buf, ref->name);
+	}
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(check->children));
+	OSCAP_FOR(xccdf_check, child, xccdf_check_get_children(check))
+		_write_check(buf, child);
+}
+
+static void _read_check(struct oscap_cache_reader *reader, struct oscap_list *checks)
+{
+	struct xccdf_check *check = xccdf_check_new();
+	oscap_list_add(checks, check);
+
+	check->oper = oscap_cache_read_u32(reader);
+	check->id = oscap_cache_read_str(reader);
+	check->system = oscap_cache_read_str(reader);
+	check->selector = oscap_cache_read_str(reader);
+	check->content = oscap_cache_read_str(reader);
+	uint8_t bits = oscap_cache_read_u8(reader);
+	check->flags.multicheck = bits & 1;
+	check->flags.def_multicheck = (bits >> 1) & 1;
+	check->flags.negate = (bits >> 2) & 1;
+	check->flags.def_negate = (bits >> 3) & 1;
+
+	uint32_t count = oscap_cache_read_count(reader, 3 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct xccdf_check_import *import = xccdf_check_import_new();
+		oscap_list_add(check->imports, import);
+		import->name = oscap_cache_read_str(reader);
+		import->xpath = oscap_cache_read_str(reader);
+		import->content = oscap_cache_read_str(reader);
+	}
+	count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct xccdf_check_export *export = xccdf_check_export_new();
+		oscap_list_add(check->exports, export);
+		export->name = oscap_cache_read_str(reader);
+		export->value = oscap_cache_read_str(reader);
+	}
+	count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct xccdf_check_content_ref *ref = xccdf_check_content_ref_new();
+		oscap_list_add(check->content_refs, ref);
+		ref->href = oscap_cache_read_str(reader);
+		ref->name = oscap_cache_read_str(reader);
+	}
+
+	count = oscap_cache_read_count(reader, 5 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i)
+		_read_check(reader, check->children);
+}
+
+static void _write_rule(struct oscap_buffer *buf, const struct xccdf_rule_item *rule)
+{
+	oscap_cache_write_str(buf, rule->impact_metric);
+	oscap_cache_write_u32(buf, rule->role);
+	oscap_cache_write_u32(buf, rule->severity);
+	_write_requires(buf, rule->requires_);
+	oscap_cache_write_string_list(buf, rule->conflicts);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(rule->profile_notes));
+	struct oscap_iterator *it = oscap_iterator_new(rule->profile_notes);
+	while (oscap_iterator_has_more(it)) {
+		const struct xccdf_profile_note *note = oscap_iterator_next(it);
+		_write_text_opt(buf, note->text);
+		oscap_cache_write_str(buf, note->reftag);
+	}
+	oscap_iterator_free(it);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(rule->idents));
+	it = oscap_iterator_new(rule->idents);
+	while (oscap_iterator_has_more(it)) {
+		const struct xccdf_ident *ident = oscap_iterator_next(it);
+		oscap_cache_write_str(buf, ident->id);
+		oscap_cache_write_str(buf, ident->system);
+	}
+	oscap_iterator_free(it);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(rule->checks));
+	it = oscap_iterator_new(rule->checks);
+	while (oscap_iterator_has_more(it))
+		_write_check(buf, oscap_iterator_next(it));
+	oscap_iterator_free(it);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(rule->fixes));
+	it = oscap_iterator_new(rule->fixes);
+	while (oscap_iterator_has_more(it)) {
+		const struct xccdf_fix *fix = oscap_iterator_next(it);
+		oscap_cache_write_bool(buf, fix->reboot);
+		oscap_cache_write_u32(buf, fix->strategy);
+		oscap_cache_write_u32(buf, fix->disruption);
+		oscap_cache_write_u32(buf, fix->complexity);
+		oscap_cache_write_str(buf, fix->id);
+		oscap_cache_write_str(buf, fix->content);
+		oscap_cache_write_str(buf, fix->system);
+		oscap_cache_write_str(buf, fix->platform);
+	}
+	oscap_iterator_free(it);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(rule->fixtexts));
+	it = oscap_iterator_new(rule->fixtexts);
+	while (oscap_iterator_has_more(it)) {
+		const struct xccdf_fixtext *fixtext = oscap_iterator_next(it);
+		_write_text_opt(buf, fixtext->text);
+		oscap_cache_write_bool(buf, fixtext->reboot);
+		oscap_cache_write_u32(buf, fixtext->strategy);
+		oscap_cache_write_u32(buf, fixtext->disruption);
+		oscap_cache_write_u32(buf, fixtext->complexity);
+		oscap_cache_write_str(buf, fixtext->fixref);
+	}
+	oscap_iterator_free(it);
+}
+
+static void _read_rule(struct oscap_cache_reader *reader, struct xccdf_rule_item *rule)
+{
+	rule->impact_metric = oscap_cache_read_str(reader);
+	rule->role = oscap_cache_read_u32(reader);
+	rule->severity = oscap_cache_read_u32(reader);
+	_read_requires(reader, rule->requires_);
+	oscap_cache_read_string_list(reader, rule->conflicts);
+
+	uint32_t count = oscap_cache_read_count(reader, 1 + sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct xccdf_profile_note *note = xccdf_profile_note_new();
+		oscap_list_add(rule->profile_notes, note);
+		note->text = _read_text_opt(reader);
+		note->reftag = oscap_cache_read_str(reader);
+	}
+
+	count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct xccdf_ident *ident = xccdf_ident_new();
+		oscap_list_add(rule->idents, ident);
+		ident->id = oscap_cache_read_str(reader);
+		ident->system = oscap_cache_read_str(reader);
+	}
+
+	count = oscap_cache_read_count(reader, 5 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i)
+		_read_check(reader, rule->checks);
+
+	count = oscap_cache_read_count(reader, 1 + 7 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct xccdf_fix *fix = xccdf_fix_new();
+		oscap_list_add(rule->fixes, fix);
+		fix->reboot = oscap_cache_read_bool(reader);
+		fix->strategy = oscap_cache_read_u32(reader);
+		fix->disruption = oscap_cache_read_u32(reader);
+		fix->complexity = oscap_cache_read_u32(reader);
+		fix->id = oscap_cache_read_str(reader);
+		fix->content = oscap_cache_read_str(reader);
+		fix->system = oscap_cache_read_str(reader);
+		fix->platform = oscap_cache_read_str(reader);
+	}
+
+	count = oscap_cache_read_count(reader, 2 + 4 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct xccdf_fixtext *fixtext = xccdf_fixtext_new();
+		oscap_list_add(rule->fixtexts, fixtext);
+		fixtext->text = _read_text_opt(reader);
+		fixtext->reboot = oscap_cache_read_bool(reader);
+		fixtext->strategy = oscap_cache_read_u32(reader);
+		fixtext->disruption = oscap_cache_read_u32(reader);
+		fixtext->complexity = oscap_cache_read_u32(reader);
+		fixtext->fixref = oscap_cache_read_str(reader);
+	}
+}
+
+static void _write_value(struct oscap_buffer *buf, const struct xccdf_value_item *value)
+{
+	oscap_cache_write_u32(buf, value->type);
+	oscap_cache_write_u32(buf, value->interface_hint);
+	oscap_cache_write_u32(buf, value->oper);
+	oscap_cache_write_string_list(buf, value->sources);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(value->instances));
+	struct oscap_iterator *it = oscap_iterator_new(value->instances);
+	while (oscap_iterator_has_more(it)) {
+		const struct xccdf_value_instance *inst = oscap_iterator_next(it);
+		oscap_cache_write_str(buf, inst->selector);
+		oscap_cache_write_u32(buf, inst->type);
+		oscap_cache_write_str(buf, inst->value);
+		oscap_cache_write_str(buf, inst->defval);
+		oscap_cache_write_string_list(buf, inst->choices);
+		oscap_cache_write_float(buf, inst->lower_bound);
+		oscap_cache_write_float(buf, inst->upper_bound);
+		oscap_cache_write_str(buf, inst->match);
+		oscap_cache_write_u8(buf, inst->flags.value_given
+				| inst->flags.defval_given << 1
+				| inst->flags.must_match_given << 2
+				| inst->flags.must_match << 3);
+	}
+	oscap_iterator_free(it);
+}
+
+static void _read_value(struct oscap_cache_reader *reader, struct xccdf_item *value)
+{
+	value->sub.value.type = oscap_cache_read_u32(reader);
+	value->sub.value.interface_hint = oscap_cache_read_u32(reader);
+	value->sub.value.oper = oscap_cache_read_u32(reader);
+	oscap_cache_read_string_list(reader, value->sub.value.sources);
+
+	uint32_t count = oscap_cache_read_count(reader, 7 * sizeof(uint32_t) + 2 * sizeof(float) + 1);
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct xccdf_value_instance *inst = xccdf_value_new_instance(XVALUE(value));
+		oscap_list_add(value->sub.value.instances, inst);
+		inst->selector = oscap_cache_read_str(reader);
+		inst->type = oscap_cache_read_u32(reader);
+		inst->value = oscap_cache_read_str(reader);
+		inst->defval = oscap_cache_read_str(reader);
+		oscap_cache_read_string_list(reader, inst->choices);
+		inst->lower_bound = oscap_cache_read_float(reader);
+		inst->upper_bound = oscap_cache_read_float(reader);
+		inst->match = oscap_cache_read_str(reader);
+		uint8_t bits = oscap_cache_read_u8(reader);
+		inst->flags.value_given = bits & 1;
+		inst->flags.defval_given = (bits >> 1) & 1;
+		inst->flags.must_match_given = (bits >> 2) & 1;
+		inst->flags.must_match = (bits >> 3) & 1;
+	}
+}
+
+static void _write_profile(struct oscap_buffer *buf, const struct xccdf_profile_item *profile)
+{
+	oscap_cache_write_str(buf, profile->note_tag);
+	oscap_cache_write_bool(buf, profile->tailoring);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(profile->selects));
+	struct oscap_iterator *it = oscap_iterator_new(profile->selects);
+	while (oscap_iterator_has_more(it)) {
+		const struct xccdf_select *select = oscap_iterator_next(it);
+		oscap_cache_write_str(buf, select->item);
+		oscap_cache_write_bool(buf, select->selected);
+		oscap_cache_write_text_list(buf, select->remarks);
+	}
+	oscap_iterator_free(it);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(profile->setvalues));
+	it = oscap_iterator_new(profile->setvalues);
+	while (oscap_iterator_has_more(it)) {
+		const struct xccdf_setvalue *setvalue = oscap_iterator_next(it);
+		oscap_cache_write_str(buf, setvalue->item);
+		oscap_cache_write_str(buf, setvalue->value);
+	}
+	oscap_iterator_free(it);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(profile->refine_values));
+	it = oscap_iterator_new(profile->refine_values);
+	while (oscap_iterator_has_more(it)) {
+		const struct xccdf_refine_value *refine = oscap_iterator_next(it);
+		oscap_cache_write_str(buf, refine->item);
+		oscap_cache_write_str(buf, refine->selector);
+		oscap_cache_write_u32(buf, refine->oper);
+		oscap_cache_write_text_list(buf, refine->remarks);
+	}
+	oscap_iterator_free(it);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(profile->refine_rules));
+	it = oscap_iterator_new(profile->refine_rules);
+	while (oscap_iterator_has_more(it)) {
+		const struct xccdf_refine_rule *refine = oscap_iterator_next(it);
+		oscap_cache_write_str(buf, refine->item);
+		oscap_cache_write_str(buf, refine->selector);
+		oscap_cache_write_u32(buf, refine->role);
+		oscap_cache_write_u32(buf, refine->severity);
+		oscap_cache_write_float(buf, refine->weight);
+		oscap_cache_write_text_list(buf, refine->remarks);
+	}
+	oscap_iterator_free(it);
+}
+
+static void _read_profile(struct oscap_cache_reader *reader, struct xccdf_profile_item *profile)
+{
+	profile->note_tag = oscap_cache_read_str(reader);
+	profile->tailoring = oscap_cache_read_bool(reader);
+
+	uint32_t count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t) + 1);
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct xccdf_select *select = xccdf_select_new();
+		oscap_list_add(profile->selects, select);
+		select->item = oscap_cache_read_str(reader);
+		select->selected = oscap_cache_read_bool(reader);
+		oscap_cache_read_text_list(reader, select->remarks);
+	}
+
+	count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct xccdf_setvalue *setvalue = xccdf_setvalue_new();
+		oscap_list_add(profile->setvalues, setvalue);
+		setvalue->item = oscap_cache_read_str(reader);
+		setvalue->value = oscap_cache_read_str(reader);
+	}
+
+	count = oscap_cache_read_count(reader, 4 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct xccdf_refine_value *refine = xccdf_refine_value_new();
+		oscap_list_add(profile->refine_values, refine);
+		refine->item = oscap_cache_read_str(reader);
+		refine->selector = oscap_cache_read_str(reader);
+		refine->oper = oscap_cache_read_u32(reader);
+		oscap_cache_read_text_list(reader, refine->remarks);
+	}
+
+	count = oscap_cache_read_count(reader, 5 * sizeof(uint32_t) + sizeof(float));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct xccdf_refine_rule *refine = xccdf_refine_rule_new();
+		oscap_list_add(profile->refine_rules, refine);
+		refine->item = oscap_cache_read_str(reader);
+		refine->selector = oscap_cache_read_str(reader);
+		refine->role = oscap_cache_read_u32(reader);
+		refine->severity = oscap_cache_read_u32(reader);
+		refine->weight = oscap_cache_read_float(reader);
+		oscap_cache_read_text_list(reader, refine->remarks);
+	}
+}
+
+static void _write_item(struct oscap_buffer *buf, const struct xccdf_item *item);
+
+static void _write_items(struct oscap_buffer *buf, struct oscap_list *items)
+{
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(items));
+	struct oscap_iterator *it = oscap_iterator_new(items);
+	while (oscap_iterator_has_more(it))
+		_write_item(buf, oscap_iterator_next(it));
+	oscap_iterator_free(it);
+}
+
+static void _write_item(struct oscap_buffer *buf, const struct xccdf_item *item)
+{
+	oscap_cache_write_u32(buf, item->type);
+	_write_item_base(buf, &item->item);
+	switch (item->type) {
+	case XCCDF_RULE:
+		_write_rule(buf, &item->sub.rule);
+		break;
+	case XCCDF_GROUP:
+		_write_requires(buf, item->sub.group.requires_);
+		oscap_cache_write_string_list(buf, item->sub.group.conflicts);
+		_write_items(buf, item->sub.group.values);
+		_write_items(buf, item->sub.group.content);
+		break;
+	case XCCDF_VALUE:
+		_write_value(buf, &item->sub.value);
+		break;
+	case XCCDF_PROFILE:
+		_write_profile(buf, &item->sub.profile);
+		break;
+	default:
+		assert(false);
+	}
+}
+
+static void _read_items(struct oscap_cache_reader *reader, struct xccdf_item *parent, struct oscap_list *items);
+
+static void _read_item(struct oscap_cache_reader *reader, struct xccdf_item *parent, struct oscap_list *items)
+{
+	struct xccdf_item *item = NULL;
+	xccdf_type_t type = oscap_cache_read_u32(reader);
+
+	switch (type) {
+	case XCCDF_RULE:
+		item = xccdf_rule_new_internal(parent);
+		break;
+	case XCCDF_GROUP:
+		item = xccdf_group_new_internal(parent);
+		break;
+	case XCCDF_VALUE:
+		item = xccdf_value_new_internal(parent, 0);
+		break;
+	case XCCDF_PROFILE:
+		item = xccdf_profile_new_internal(parent);
+		break;
+	default:
+		reader->failed = true;
+		return;
+	}
+	oscap_list_add(items, item);
+
+	_read_item_base(reader, &item->item);
+	if (reader->failed)
+		return;
+	/* the parser registers items in the same order, before their children */
+	if (item->item.id != NULL)
+		xccdf_benchmark_register_item(xccdf_item_get_benchmark(item), item);
+
+	switch (type) {
+	case XCCDF_RULE:
+		_read_rule(reader, &item->sub.rule);
+		break;
+	case XCCDF_GROUP:
+		_read_requires(reader, item->sub.group.requires_);
+		oscap_cache_read_string_list(reader, item->sub.group.conflicts);
+		_read_items(reader, item, item->sub.group.values);
+		_read_items(reader, item, item->sub.group.content);
+		break;
+	case XCCDF_VALUE:
+		_read_value(reader, item);
+		break;
+	case XCCDF_PROFILE:
+		_read_profile(reader, &item->sub.profile);
+		break;
+	default:
+		break;
+	}
+}
+
+static void _read_items(struct oscap_cache_reader *reader, struct xccdf_item *parent, struct oscap_list *items)
+{
+	uint32_t count = oscap_cache_read_count(reader, sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i)
+		_read_item(reader, parent, items);
+}
+
+void xccdf_benchmark_cache_write(struct oscap_buffer *buf, const struct xccdf_benchmark *benchmark)
+{
+	const struct xccdf_item *bench = XITEM(benchmark);
+
+	_write_item_base(buf, &bench->item);
+	oscap_cache_write_str(buf, xccdf_version_info_get_version(bench->sub.benchmark.schema_version));
+	oscap_cache_write_str(buf, bench->sub.benchmark.style);
+	oscap_cache_write_str(buf, bench->sub.benchmark.style_href);
+	oscap_cache_write_str(buf, bench->sub.benchmark.lang);
+	oscap_cache_write_text_list(buf, bench->sub.benchmark.front_matter);
+	oscap_cache_write_text_list(buf, bench->sub.benchmark.rear_matter);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(bench->sub.benchmark.notices));
+	struct oscap_iterator *it = oscap_iterator_new(bench->sub.benchmark.notices);
+	while (oscap_iterator_has_more(it)) {
+		const struct xccdf_notice *notice = oscap_iterator_next(it);
+		oscap_cache_write_str(buf, notice->id);
+		_write_text_opt(buf, notice->text);
+	}
+	oscap_iterator_free(it);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(bench->sub.benchmark.plain_texts));
+	it = oscap_iterator_new(bench->sub.benchmark.plain_texts);
+	while (oscap_iterator_has_more(it)) {
+		const struct xccdf_plain_text *plain = oscap_iterator_next(it);
+		oscap_cache_write_str(buf, plain->id);
+		oscap_cache_write_str(buf, plain->text);
+	}
+	oscap_iterator_free(it);
+
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(bench->sub.benchmark.models));
+	it = oscap_iterator_new(bench->sub.benchmark.models);
+	while (oscap_iterator_has_more(it)) {
+		const struct xccdf_model *model = oscap_iterator_next(it);
+		oscap_cache_write_str(buf, model->system);
+		oscap_cache_write_u32(buf, oscap_htable_itemcount(model->params));
+		struct oscap_htable_iterator *hit = oscap_htable_iterator_new(model->params);
+		while (oscap_htable_iterator_has_more(hit)) {
+			const char *name;
+			void *value;
+			oscap_htable_iterator_next_kv(hit, &name, &value);
+			oscap_cache_write_str(buf, name);
+			oscap_cache_write_str(buf, value);
+		}
+		oscap_htable_iterator_free(hit);
+	}
+	oscap_iterator_free(it);
+
+	oscap_cache_write_bool(buf, bench->sub.benchmark.cpe_list != NULL);
+	if (bench->sub.benchmark.cpe_list != NULL)
+		cpe_dict_model_cache_write(buf, bench->sub.benchmark.cpe_list);
+	oscap_cache_write_bool(buf, bench->sub.benchmark.cpe_lang_model != NULL);
+	if (bench->sub.benchmark.cpe_lang_model != NULL)
+		cpe_lang_model_cache_write(buf, bench->sub.benchmark.cpe_lang_model);
+
+	_write_items(buf, bench->sub.benchmark.profiles);
+	_write_items(buf, bench->sub.benchmark.values);
+	_write_items(buf, bench->sub.benchmark.content);
+}
+
+struct xccdf_benchmark *xccdf_benchmark_cache_read(struct oscap_cache_reader *reader)
+{
+	struct xccdf_benchmark *benchmark = xccdf_benchmark_new();
+	struct xccdf_item *bench = XITEM(benchmark);
+
+	_read_item_base(reader, &bench->item);
+	const char *version = oscap_cache_read_cstr(reader);
+	if (version != NULL) {
+		bench->sub.benchmark.schema_version = xccdf_version_info_find(version);
+		if (bench->sub.benchmark.schema_version == NULL)
+			reader->failed = true;
+	}
+	bench->sub.benchmark.style = oscap_cache_read_str(reader);
+	bench->sub.benchmark.style_href = oscap_cache_read_str(reader);
+	bench->sub.benchmark.lang = oscap_cache_read_str(reader);
+	oscap_cache_read_text_list(reader, bench->sub.benchmark.front_matter);
+	oscap_cache_read_text_list(reader, bench->sub.benchmark.rear_matter);
+
+	uint32_t count = oscap_cache_read_count(reader, sizeof(uint32_t) + 1);
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct xccdf_notice *notice = xccdf_notice_new();
+		oscap_list_add(bench->sub.benchmark.notices, notice);
+		notice->id = oscap_cache_read_str(reader);
+		oscap_text_free(notice->text);
+		notice->text = _read_text_opt(reader);
+	}
+
+	count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct xccdf_plain_text *plain = xccdf_plain_text_new();
+		oscap_list_add(bench->sub.benchmark.plain_texts, plain);
+		plain->id = oscap_cache_read_str(reader);
+		plain->text = oscap_cache_read_str(reader);
+	}
+
+	/* the models are stored including the implied default one */
+	oscap_list_free(bench->sub.benchmark.models, (oscap_destruct_func) xccdf_model_free);
+	bench->sub.benchmark.models = oscap_list_new();
+	count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct xccdf_model *model = xccdf_model_new();
+		oscap_list_add(bench->sub.benchmark.models, model);
+		model->system = oscap_cache_read_str(reader);
+		uint32_t params = oscap_cache_read_count(reader, 2 * sizeof(uint32_t));
+		for (uint32_t j = 0; j < params && !reader->failed; ++j) {
+			const char *name = oscap_cache_read_cstr(reader);
+			char *value = oscap_cache_read_str(reader);
+			if (name == NULL || value == NULL || !oscap_htable_add(model->params, name, value))
+				free(value);
+		}
+	}
+
+	if (oscap_cache_read_bool(reader))
+		bench->sub.benchmark.cpe_list = cpe_dict_model_cache_read(reader);
+	if (oscap_cache_read_bool(reader))
+		bench->sub.benchmark.cpe_lang_model = cpe_lang_model_cache_read(reader);
+
+	_read_items(reader, bench, bench->sub.benchmark.profiles);
+	_read_items(reader, bench, bench->sub.benchmark.values);
+	_read_items(reader, bench, bench->sub.benchmark.content);
+
+	if (reader->failed) {
+		xccdf_benchmark_free(benchmark);
+		return NULL;
+	}
+	return benchmark;
+}
@@ -121,7 +121,7 @@ bool xccdf_is_supported_namespace(xmlNs *ns)
 
 char *xccdf_detect_version_priv(xmlTextReader *reader)
 {
-	while (xmlTextReaderRead(reader) == 1 && xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT);
+	while (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT && xmlTextReaderRead(reader) == 1);
 	const struct xccdf_version_info *ver_info = xccdf_detect_version_parser(reader);
 	if (ver_info == NULL) {
 		return NULL;
@@ -40,6 +40,7 @@
 #include "helpers.h"
 #include "xccdf_impl.h"
 #include "common/util.h"
+#include "common/oscap_intern.h"
 #include "common/oscap_pcre.h"
 #include "oscap_helpers.h"
 
@@ -1289,7 +1290,7 @@ struct xccdf_instance * xccdf_instance_clone(const struct xccdf_instance * insta
 struct xccdf_rule_result * xccdf_rule_result_clone(const struct xccdf_rule_result * result)
 {
 	struct xccdf_rule_result * clone = calloc(1, sizeof(struct xccdf_rule_result));
-	clone->idref = oscap_strdup(result->idref);
+	clone->idref = oscap_intern_ref(result->idref);
 	clone->role = result->role;
 	clone->time = oscap_strdup(result->time);
 	clone->weight = result->weight;
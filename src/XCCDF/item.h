@@ -342,7 +342,7 @@ struct xccdf_fixtext {
 };
 
 struct xccdf_rule_result {
-	char *idref;
+	const char *idref;	///< interned, rule results of all test results share it
 	xccdf_role_t role;
 	char *time;
 	float weight;
@@ -436,6 +436,11 @@ void xccdf_item_print(struct xccdf_item *item, int depth);
 void xccdf_item_dump(struct xccdf_item *item, int depth);
 struct xccdf_item* xccdf_item_get_benchmark_internal(struct xccdf_item* item);
 bool xccdf_benchmark_parse(struct xccdf_item *benchmark, xmlTextReaderPtr reader);
+struct oscap_buffer;
+struct oscap_cache_reader;
+/* Serialization for the content cache, see cache.c */
+void xccdf_benchmark_cache_write(struct oscap_buffer *buf, const struct xccdf_benchmark *benchmark);
+struct xccdf_benchmark *xccdf_benchmark_cache_read(struct oscap_cache_reader *reader);
 void xccdf_benchmark_dump(struct xccdf_benchmark *benchmark);
 int xccdf_benchmark_include_tailored_profiles(struct xccdf_benchmark *benchmark);
 struct oscap_htable_iterator *xccdf_benchmark_get_cluster_items(struct xccdf_benchmark *benchmark, const char *cluster_id);
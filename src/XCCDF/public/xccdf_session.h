@@ -309,6 +309,28 @@ OSCAP_API void xccdf_session_set_custom_oval_eval_fn(struct xccdf_session *sessi
  */
 OSCAP_API bool xccdf_session_set_product_cpe(struct xccdf_session *session, const char *product_cpe);
 
+/**
+ * Set whether the collection cache configured by OSCAP_COLLECTION_CACHE_DIR
+ * shall be used by the OVAL sessions created later on.
+ * @memberof xccdf_session
+ * @param session XCCDF Session
+ * @param enabled whether to use the collection cache or not.
+ */
+OSCAP_API void xccdf_session_set_collection_cache(struct xccdf_session *session, bool enabled);
+
+/**
+ * Set whether the OVAL definitions which aren't referenced by the rules
+ * selected for the evaluation shall be dropped from the OVAL sessions before
+ * the evaluation. The tests, objects, states and variables used only by them
+ * are dropped as well, they aren't collected and the OVAL results don't list
+ * them. The pruning takes place in xccdf_session_evaluate(), the session
+ * is then suitable for a single evaluation only.
+ * @memberof xccdf_session
+ * @param session XCCDF Session
+ * @param enabled whether to prune the OVAL definitions or not.
+ */
+OSCAP_API void xccdf_session_set_oval_pruning(struct xccdf_session *session, bool enabled);
+
 /**
  * Set whether the System Characteristics shall be exported in result files.
  * @memberof xccdf_session
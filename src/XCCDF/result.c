@@ -76,6 +76,7 @@
 #include "common/_error.h"
 #include "oscap_text.h"
 #include "common/debug_priv.h"
+#include "common/oscap_intern.h"
 #include "source/oscap_source_priv.h"
 #include "oscap_helpers.h"
 
@@ -605,7 +606,7 @@ struct xccdf_rule_result *xccdf_rule_result_new(void)
 void xccdf_rule_result_free(struct xccdf_rule_result *rr)
 {
 	if (rr != NULL) {
-		free(rr->idref);
+		oscap_intern_release(rr->idref);
 		free(rr->version);
 		free(rr->time);
 
@@ -626,7 +627,8 @@ OSCAP_ACCESSOR_SIMPLE(xccdf_level_t, xccdf_rule_result, severity)
 OSCAP_ACCESSOR_SIMPLE(xccdf_test_result_type_t, xccdf_rule_result, result)
 OSCAP_ACCESSOR_STRING(xccdf_rule_result, time)
 OSCAP_ACCESSOR_STRING(xccdf_rule_result, version)
-OSCAP_ACCESSOR_STRING(xccdf_rule_result, idref)
+OSCAP_GETTER(const char*, xccdf_rule_result, idref)
+OSCAP_SETTER_GENERIC(xccdf_rule_result, const char *, idref, oscap_intern_release, oscap_intern)
 OSCAP_IGETINS(xccdf_ident, xccdf_rule_result, idents, ident)
 OSCAP_IGETINS(xccdf_fix, xccdf_rule_result, fixes, fix)
 OSCAP_IGETINS(xccdf_check, xccdf_rule_result, checks, check)
@@ -1399,7 +1401,7 @@ static struct xccdf_rule_result *xccdf_rule_result_new_parse(xmlTextReaderPtr re
 
 	struct xccdf_rule_result *rr = xccdf_rule_result_new();
 
-	rr->idref    = xccdf_attribute_copy(reader, XCCDFA_IDREF);
+	rr->idref    = oscap_intern(xccdf_attribute_get(reader, XCCDFA_IDREF));
 	rr->role     = oscap_string_to_enum(XCCDF_ROLE_MAP, xccdf_attribute_get(reader, XCCDFA_ROLE));
 	rr->time     = xccdf_attribute_copy(reader, XCCDFA_TIME);
 	rr->version  = xccdf_attribute_copy(reader, XCCDFA_VERSION);
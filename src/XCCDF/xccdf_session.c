@@ -19,6 +19,9 @@
  */
 #include <string.h>
 #include <limits.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <pthread.h>
 
 #ifdef HAVE_CONFIG_H
 #include <config.h>
@@ -48,6 +51,7 @@
 #include "DS/ds_sds_session_priv.h"
 #include "DS/rds_priv.h"
 #include "DS/sds_priv.h"
+#include "OVAL/oval_definitions_impl.h"
 #include "OVAL/results/oval_results_impl.h"
 #include "source/xslt_priv.h"
 #include "source/signature_priv.h"
@@ -96,6 +100,8 @@ struct xccdf_session {
 		struct oval_agent_session **agents;	///< OVAL Agent Session
 		xccdf_policy_engine_eval_fn user_eval_fn;///< Custom OVAL engine callback
 		char *product_cpe;			///< CPE of scanner product.
+		bool without_collection_cache;		///< Shall the collection cache be skipped?
+		bool prune;				///< Shall the definitions the evaluation doesn't need be dropped?
 		struct oscap_source* arf_report;	///< ARF report
 		struct oscap_htable *result_sources;    ///< mapping 'filepath' to oscap_source for OVAL results
 		struct oscap_htable *results_mapping;    ///< mapping OVAL filename to filepath for OVAL results
@@ -131,6 +137,7 @@ static int _xccdf_session_autonegotiate_tailoring_file(struct xccdf_session *ses
 static void _oval_content_resources_free(struct oval_content_resource **resources);
 static void _xccdf_session_free_oval_agents(struct xccdf_session *session);
 static void _xccdf_session_free_oval_result_sources(struct xccdf_session *session);
+static int _build_oval_result_sources(struct xccdf_session *session);
 
 static const char *oscap_productname = "cpe:/a:open-scap:oscap";
 static const char *oval_sysname = "http://oval.mitre.org/XMLSchema/oval-definitions-5";
@@ -240,6 +247,9 @@ static struct oscap_source* xccdf_session_create_arf_source(struct xccdf_session
 	if (session->oval.arf_report != NULL) {
 		return session->oval.arf_report;
 	}
+	if (_build_oval_result_sources(session) != 0) {
+		return NULL;
+	}
 
 	struct oscap_source *sds_source = NULL;
 
@@ -263,6 +273,9 @@ static struct oscap_source *xccdf_session_extract_arf_source(struct xccdf_sessio
 	char *tailoring_doc_timestamp = NULL;
 	xmlDoc *sds_doc = NULL;
 
+	if (_build_oval_result_sources(session) != 0) {
+		return NULL;
+	}
 	if (xccdf_session_is_sds(session)) {
 		sds_doc = oscap_source_pop_xmlDoc(session->source);
 	} else {
@@ -520,6 +533,16 @@ bool xccdf_session_set_product_cpe(struct xccdf_session *session, const char *pr
 	return true;
 }
 
+void xccdf_session_set_collection_cache(struct xccdf_session *session, bool enabled)
+{
+	session->oval.without_collection_cache = !enabled;
+}
+
+void xccdf_session_set_oval_pruning(struct xccdf_session *session, bool enabled)
+{
+	session->oval.prune = enabled;
+}
+
 void xccdf_session_set_without_sys_chars_export(struct xccdf_session *session, bool without_sys_chars)
 {
 	session->export.without_sys_chars = without_sys_chars;
@@ -878,7 +901,10 @@ int xccdf_session_load_xccdf(struct xccdf_session *session)
 				return 1;
 			}
 		}
-		if (session->validate_signature || session->enforce_signature) {
+		// Data streams without signatures are accepted unless the signature is
+		// enforced, telling that there is none doesn't need the full DOM.
+		if (session->enforce_signature || (session->validate_signature &&
+				ds_sds_session_may_be_signed(xccdf_session_get_ds_sds_session(session)))) {
 			if (oscap_signature_validate(session->source, session->signature_ctx, session->enforce_signature)) {
 				oscap_seterr(OSCAP_EFAMILY_OSCAP, "Invalid signature in %s (%s) content in %s",
 						oscap_document_type_to_string(oscap_source_get_scap_type(session->source)),
@@ -1170,6 +1196,125 @@ static void _xccdf_session_free_oval_agents(struct xccdf_session *session)
 	}
 }
 
+/* Number of threads importing OVAL files, unless OSCAP_CONTENT_LOAD_THREADS says otherwise */
+#define OVAL_IMPORT_THREADS_DEFAULT 4
+
+struct oval_import_job {
+	struct oscap_source *source;
+	struct oval_definition_model *model;
+	struct err_queue *errors;		///< errors set by the import, in the importing thread
+	bool sequential;			///< the source is shared with an earlier job
+};
+
+struct oval_import_batch {
+	struct oval_import_job *jobs;
+	size_t count;
+	size_t next;
+	pthread_mutex_t lock;			///< guards next
+};
+
+static void _oval_import_job_run(struct oval_import_job *job)
+{
+	job->model = oval_definition_model_import_source(job->source);
+	job->errors = oscap_err_detach();
+}
+
+static void *_xccdf_session_oval_import_worker(void *arg)
+{
+	struct oval_import_batch *batch = arg;
+
+	for (;;) {
+		pthread_mutex_lock(&batch->lock);
+		size_t idx = batch->next;
+		while (idx < batch->count && batch->jobs[idx].sequential)
+			idx++;
+		batch->next = idx < batch->count ? idx + 1 : idx;
+		pthread_mutex_unlock(&batch->lock);
+		if (idx == batch->count)
+			break;
+		_oval_import_job_run(&batch->jobs[idx]);
+	}
+	return NULL;
+}
+
+static unsigned int _oval_import_thread_count(size_t count)
+{
+	long threads = OVAL_IMPORT_THREADS_DEFAULT;
+	const char *threads_env = getenv("OSCAP_CONTENT_LOAD_THREADS");
+	if (threads_env != NULL)
+		threads = strtol(threads_env, NULL, 10);
+#ifdef _SC_NPROCESSORS_ONLN
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (threads_env == NULL && cpus > 0 && cpus < threads)
+		threads = cpus;
+#endif
+	if (threads < 1)
+		threads = 1;
+	return (size_t) threads < count ? (unsigned int) threads : (unsigned int) count;
+}
+
+/*
+ * The OVAL files are independent of each other, import them concurrently.
+ * Errors of each import are kept with its job so that the caller can report
+ * them in the order of the files, just like a sequential import would.
+ */
+static struct oval_import_job *_xccdf_session_import_oval(struct oval_content_resource **contents, size_t count)
+{
+	struct oval_import_batch batch = {
+		.jobs = calloc(count, sizeof(struct oval_import_job)),
+		.count = count,
+		.next = 0,
+	};
+	/* Keep the errors set so far out of the way of the ones of the imports */
+	struct err_queue *errors = oscap_err_detach();
+	for (size_t i = 0; i < count; i++) {
+		batch.jobs[i].source = contents[i]->source;
+		for (size_t j = 0; j < i; j++) {
+			if (batch.jobs[j].source == batch.jobs[i].source) {
+				batch.jobs[i].sequential = true;
+				break;
+			}
+		}
+	}
+
+	unsigned int thread_count = _oval_import_thread_count(count);
+	pthread_t *threads = malloc(thread_count * sizeof(pthread_t));
+	unsigned int started = 0;
+	pthread_mutex_init(&batch.lock, NULL);
+	if (thread_count > 1) {
+		dI("Importing %zu OVAL files in %u threads.", count, thread_count);
+		for (; started < thread_count; started++) {
+			if (pthread_create(&threads[started], NULL, _xccdf_session_oval_import_worker, &batch) != 0) {
+				dW("Can't start an OVAL import thread: %s.", strerror(errno));
+				break;
+			}
+		}
+	}
+	/* The calling thread imports everything left if no thread started. */
+	if (started == 0)
+		_xccdf_session_oval_import_worker(&batch);
+	for (unsigned int t = 0; t < started; t++)
+		pthread_join(threads[t], NULL);
+	free(threads);
+	pthread_mutex_destroy(&batch.lock);
+
+	for (size_t i = 0; i < count; i++) {
+		if (batch.jobs[i].sequential)
+			_oval_import_job_run(&batch.jobs[i]);
+	}
+	oscap_err_attach(errors);
+	return batch.jobs;
+}
+
+static void _oval_import_jobs_free(struct oval_import_job *jobs, size_t from, size_t count)
+{
+	for (size_t i = from; i < count; i++) {
+		oval_definition_model_free(jobs[i].model);
+		oscap_err_discard(jobs[i].errors);
+	}
+	free(jobs);
+}
+
 int xccdf_session_load_oval(struct xccdf_session *session)
 {
 	struct oval_content_resource **contents = NULL;
@@ -1200,12 +1345,21 @@ int xccdf_session_load_oval(struct xccdf_session *session)
 		}
 	}
 
-	for (int idx=0; contents[idx]; idx++) {
-		/* file -> def_model */
-		struct oval_definition_model *tmp_def_model = oval_definition_model_import_source(contents[idx]->source);
+	size_t count = 0;
+	while (contents[count])
+		count++;
+	/* files -> def_models */
+	struct oval_import_job *jobs = _xccdf_session_import_oval(contents, count);
+
+	for (size_t idx = 0; idx < count; idx++) {
+		struct oval_definition_model *tmp_def_model = jobs[idx].model;
+		jobs[idx].model = NULL;
+		oscap_err_attach(jobs[idx].errors);
+		jobs[idx].errors = NULL;
 		if (tmp_def_model == NULL) {
 			oscap_seterr(OSCAP_EFAMILY_OSCAP, "Failed to create OVAL definition model from: '%s'.",
 				oscap_source_readable_origin(contents[idx]->source));
+			_oval_import_jobs_free(jobs, idx, count);
 			return 1;
 		}
 
@@ -1214,6 +1368,7 @@ int xccdf_session_load_oval(struct xccdf_session *session)
 		if (tmp_sess == NULL) {
 			oscap_seterr(OSCAP_EFAMILY_OSCAP, "Failed to create new OVAL agent session for: '%s'.", contents[idx]->href);
 			oval_definition_model_free(tmp_def_model);
+			_oval_import_jobs_free(jobs, idx, count);
 			return 2;
 		}
 
@@ -1233,11 +1388,14 @@ int xccdf_session_load_oval(struct xccdf_session *session)
 		/* store our name in the generated documents */
 		oval_agent_set_product_name(tmp_sess, session->oval.product_cpe != NULL ?
 				session->oval.product_cpe : (char *) oscap_productname);
+		if (session->oval.without_collection_cache)
+			oval_agent_set_collection_cache(tmp_sess, false);
 
 		/* remember sessions */
 		void *new_oval_agents = realloc(session->oval.agents, (idx + 2) * sizeof(struct oval_agent_session *));
 		if (new_oval_agents == NULL) {
 			oval_agent_destroy_session(tmp_sess);
+			_oval_import_jobs_free(jobs, idx, count);
 			return -1;
 		}
 		session->oval.agents = new_oval_agents;
@@ -1252,6 +1410,7 @@ int xccdf_session_load_oval(struct xccdf_session *session)
 		else
 			xccdf_policy_model_register_engine_oval(session->xccdf.policy_model, tmp_sess);
 	}
+	_oval_import_jobs_free(jobs, count, count);
 	return 0;
 }
 
@@ -1365,6 +1524,113 @@ int xccdf_session_load_tailoring(struct xccdf_session *session)
 	return xccdf_policy_model_set_tailoring(session->xccdf.policy_model, tailoring) ? 0 : 1;
 }
 
+struct oval_check_refs {
+	struct oscap_htable *names;	///< href -> table of definition ids referenced in the file
+	struct oscap_htable *whole;	///< hrefs of files which are referenced as a whole
+};
+
+static void _xccdf_check_collect_oval_refs(struct xccdf_check *check, struct oval_check_refs *refs)
+{
+	if (xccdf_check_get_complex(check)) {
+		struct xccdf_check_iterator *children = xccdf_check_get_children(check);
+		while (xccdf_check_iterator_has_more(children))
+			_xccdf_check_collect_oval_refs(xccdf_check_iterator_next(children), refs);
+		xccdf_check_iterator_free(children);
+		return;
+	}
+	if (oscap_strcmp(xccdf_check_get_system(check), oval_sysname) != 0)
+		return;
+
+	struct xccdf_check_content_ref_iterator *content_refs = xccdf_check_get_content_refs(check);
+	while (xccdf_check_content_ref_iterator_has_more(content_refs)) {
+		struct xccdf_check_content_ref *content_ref = xccdf_check_content_ref_iterator_next(content_refs);
+		const char *href = xccdf_check_content_ref_get_href(content_ref);
+		const char *name = xccdf_check_content_ref_get_name(content_ref);
+		if (href == NULL)
+			continue;
+		// Checks without a name evaluate every definition in the file
+		if (name == NULL) {
+			oscap_htable_add(refs->whole, href, (void *) true);
+			continue;
+		}
+		struct oscap_htable *names = oscap_htable_get(refs->names, href);
+		if (names == NULL) {
+			names = oscap_htable_new();
+			oscap_htable_add(refs->names, href, names);
+		}
+		oscap_htable_add(names, name, (void *) true);
+	}
+	xccdf_check_content_ref_iterator_free(content_refs);
+}
+
+static void _xccdf_item_collect_oval_refs(struct xccdf_policy *policy, struct xccdf_item *item, struct oval_check_refs *refs)
+{
+	const char *id = xccdf_item_get_id(item);
+
+	switch (xccdf_item_get_type(item)) {
+	case XCCDF_RULE: {
+		// Follows the rule selection of _xccdf_policy_rule_evaluate(), conservatively
+		if (oscap_htable_get(policy->skip_rules, id) != NULL)
+			return;
+		if (oscap_htable_itemcount(policy->rules) > 0) {
+			if (oscap_htable_get(policy->rules, id) == NULL)
+				return;
+		} else if (!xccdf_policy_is_item_selected(policy, id)) {
+			return;
+		}
+		struct xccdf_check_iterator *checks = xccdf_rule_get_checks((struct xccdf_rule *) item);
+		while (xccdf_check_iterator_has_more(checks))
+			_xccdf_check_collect_oval_refs(xccdf_check_iterator_next(checks), refs);
+		xccdf_check_iterator_free(checks);
+		break;
+	}
+	case XCCDF_GROUP: {
+		struct xccdf_item_iterator *children = xccdf_group_get_content((struct xccdf_group *) item);
+		while (xccdf_item_iterator_has_more(children))
+			_xccdf_item_collect_oval_refs(policy, xccdf_item_iterator_next(children), refs);
+		xccdf_item_iterator_free(children);
+		break;
+	}
+	default:
+		break;
+	}
+}
+
+/*
+ * Drop the OVAL definitions which aren't referenced by the rules about to be
+ * evaluated together with the tests, objects, states and variables only they
+ * depend on. Nothing is collected for them and the results don't list them.
+ */
+static void _xccdf_session_prune_oval(struct xccdf_session *session, struct xccdf_policy *policy)
+{
+	if (session->oval.agents == NULL)
+		return;
+
+	struct oval_check_refs refs = {
+		.names = oscap_htable_new(),
+		.whole = oscap_htable_new(),
+	};
+	struct xccdf_benchmark *benchmark = xccdf_policy_model_get_benchmark(session->xccdf.policy_model);
+	struct xccdf_item_iterator *items = xccdf_benchmark_get_content(benchmark);
+	while (xccdf_item_iterator_has_more(items))
+		_xccdf_item_collect_oval_refs(policy, xccdf_item_iterator_next(items), &refs);
+	xccdf_item_iterator_free(items);
+
+	struct oscap_htable *no_names = oscap_htable_new();
+	for (int i = 0; session->oval.agents[i]; i++) {
+		const char *href = oval_agent_get_filename(session->oval.agents[i]);
+		if (oscap_htable_get(refs.whole, href) != NULL)
+			continue;
+		struct oscap_htable *names = oscap_htable_get(refs.names, href);
+		struct oval_definition_model *def_model = oval_agent_get_definition_model(session->oval.agents[i]);
+		int removed = oval_definition_model_prune(def_model, names != NULL ? names : no_names);
+		dI("Removed %d OVAL items not needed by the evaluation from '%s'.", removed, href);
+	}
+	oscap_htable_free0(no_names);
+	oscap_htable_free(refs.names, (oscap_destruct_func) oscap_htable_free0);
+	oscap_htable_free0(refs.whole);
+}
+
 int xccdf_session_evaluate(struct xccdf_session *session)
 {
 	struct xccdf_policy *policy = xccdf_session_get_xccdf_policy(session);
@@ -1388,6 +1654,9 @@ int xccdf_session_evaluate(struct xccdf_session *session)
 	if (session->reference_parameter) {
 		xccdf_policy_set_reference_filter(policy, session->reference_parameter);
 	}
+	if (session->oval.prune) {
+		_xccdf_session_prune_oval(session, policy);
+	}
 	session->xccdf.result = xccdf_policy_evaluate(policy);
 	if (session->xccdf.result == NULL)
 		return 1;
@@ -1642,6 +1911,15 @@ static char *_xccdf_session_get_unique_oval_result_filename(struct xccdf_session
 	return name;
 }
 
+static void _xccdf_session_add_arf_report_id(struct xccdf_session *session, struct oval_agent_session *oval_session)
+{
+	static int counter = 0;
+	char *report_id = oscap_sprintf("oval%d", counter++);
+	if (!oscap_htable_add(session->oval.arf_report_mapping, oval_agent_get_filename(oval_session), report_id)) {
+		free(report_id);
+	}
+}
+
 static char *_xccdf_session_export_oval_result_file(struct xccdf_session *session, struct oval_agent_session *oval_session)
 {
 	/* get result model and session name */
@@ -1669,11 +1947,14 @@ static char *_xccdf_session_export_oval_result_file(struct xccdf_session *sessio
 		return NULL;
 	}
 
-	struct oscap_source *source = oval_results_model_export_source(res_model, NULL, name);
-	if (source == NULL) {
+	/* The file is streamed from the results model, its DOM is loaded
+	 * only when something (the HTML report) asks for it. */
+	if (oval_results_model_export_stream(res_model, NULL, name) != 0) {
+		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Could not save file: %s", name);
 		free(name);
 		return NULL;
 	}
+	struct oscap_source *source = oscap_source_new_from_file(name);
 	if (oscap_htable_add(session->oval.result_sources, name, source) == false) {
 		// The source is already there, but it shouldn't be
 		oscap_seterr(OSCAP_EFAMILY_OSCAP, "Internal error: attempted to export file %s twice", name);
@@ -1683,16 +1964,12 @@ static char *_xccdf_session_export_oval_result_file(struct xccdf_session *sessio
 		return NULL;
 	}
 
-	static int counter = 0;
-	char *report_id = oscap_sprintf("oval%d", counter++);
 	const char *original_name = oval_agent_get_filename(oval_session);
 	char *results_file_name = oscap_strdup(name);
 	if (!oscap_htable_add(session->oval.results_mapping, original_name, results_file_name)){
 		free(results_file_name);
 	}
-	if (!oscap_htable_add(session->oval.arf_report_mapping, original_name, report_id)) {
-		free(report_id);
-	};
+	_xccdf_session_add_arf_report_id(session, oval_session);
 
 	/* validate OVAL Results */
 	if (session->validate && session->full_validation) {
@@ -1714,8 +1991,10 @@ static int _build_oval_result_sources(struct xccdf_session *session)
 
 	/* Export OVAL results */
 	session->oval.result_sources = oscap_htable_new();
-	session->oval.results_mapping = oscap_htable_new();
-	session->oval.arf_report_mapping = oscap_htable_new();
+	if (session->oval.results_mapping == NULL)
+		session->oval.results_mapping = oscap_htable_new();
+	if (session->oval.arf_report_mapping == NULL)
+		session->oval.arf_report_mapping = oscap_htable_new();
 	if (session->oval.agents) {
 		for (int i = 0; session->oval.agents[i]; i++) {
 			char *filename = _xccdf_session_export_oval_result_file(session, session->oval.agents[i]);
@@ -1745,21 +2024,32 @@ static int _build_oval_result_sources(struct xccdf_session *session)
 	return 0;
 }
 
+/*
+ * Assign the ARF report IDs to the OVAL results without exporting them,
+ * the streamed ARF serializes the results models directly.
+ */
+static void _build_arf_report_mapping(struct xccdf_session *session)
+{
+	if (session->oval.arf_report_mapping == NULL)
+		session->oval.arf_report_mapping = oscap_htable_new();
+	if (session->oval.agents) {
+		for (int i = 0; session->oval.agents[i]; i++)
+			_xccdf_session_add_arf_report_id(session, session->oval.agents[i]);
+	}
+
+	struct oscap_htable_iterator *cpe_it = xccdf_policy_model_get_cpe_oval_sessions(session->xccdf.policy_model);
+	while (oscap_htable_iterator_has_more(cpe_it))
+		_xccdf_session_add_arf_report_id(session, oscap_htable_iterator_next_value(cpe_it));
+	oscap_htable_iterator_free(cpe_it);
+}
+
 int xccdf_session_export_oval(struct xccdf_session *session)
 {
-	if (_build_oval_result_sources(session) != 0) {
+	/* Building the sources saves the files, the ARF and the HTML report
+	 * build them on their own when they need them */
+	if (session->export.oval_results && _build_oval_result_sources(session) != 0) {
 		return 1;
 	}
-	struct oscap_htable_iterator *hit = oscap_htable_iterator_new(session->oval.result_sources);
-	while (oscap_htable_iterator_has_more(hit)) {
-		struct oscap_source *source = oscap_htable_iterator_next_value(hit);
-		if (oscap_source_save_as(source, NULL) != 0) {
-			oscap_seterr(OSCAP_EFAMILY_OSCAP, "Could not save file: %s", oscap_source_readable_origin(source));
-			oscap_htable_iterator_free(hit);
-			return 1;
-		}
-	}
-	oscap_htable_iterator_free(hit);
 
 	/* Export variables */
 	if (session->export.oval_variables && session->oval.agents != NULL) {
@@ -1822,9 +2112,69 @@ int xccdf_session_export_check_engine_plugins(struct xccdf_session *session)
 	return ret;
 }
 
+static struct oscap_htable *_xccdf_session_get_oval_results_models(struct xccdf_session *session)
+{
+	/* Keyed the same way as session->oval.arf_report_mapping */
+	struct oscap_htable *models = oscap_htable_new();
+	if (session->oval.agents) {
+		for (int i = 0; session->oval.agents[i]; i++) {
+			oscap_htable_add(models, oval_agent_get_filename(session->oval.agents[i]),
+					oval_agent_get_results_model(session->oval.agents[i]));
+		}
+	}
+
+	struct oscap_htable_iterator *cpe_it = xccdf_policy_model_get_cpe_oval_sessions(session->xccdf.policy_model);
+	while (oscap_htable_iterator_has_more(cpe_it)) {
+		struct oval_agent_session *value = oscap_htable_iterator_next_value(cpe_it);
+		oscap_htable_add(models, oval_agent_get_filename(value), oval_agent_get_results_model(value));
+	}
+	oscap_htable_iterator_free(cpe_it);
+	return models;
+}
+
+/**
+ * Write the ARF file without building the result data stream in memory.
+ * That's possible unless the tailoring has to be injected to the source
+ * data stream or the HTML report needs the DOM.
+ */
+static int _xccdf_session_stream_arf(struct xccdf_session *session)
+{
+	_build_arf_report_mapping(session);
+
+	struct oscap_source *sds_source = NULL;
+	if (xccdf_session_is_sds(session)) {
+		sds_source = session->source;
+	} else {
+		xmlDocPtr sds_doc = ds_sds_compose_xmlDoc_from_xccdf_source(session->source);
+		sds_source = oscap_source_new_from_xmlDoc(sds_doc, NULL);
+	}
+
+	struct oscap_htable *models = _xccdf_session_get_oval_results_models(session);
+	int ret = ds_rds_export_stream(sds_source, session->xccdf.result_source, models,
+			session->oval.arf_report_mapping, session->export.arf_file);
+	oscap_htable_free0(models);
+	if (!xccdf_session_is_sds(session)) {
+		oscap_source_free(sds_source);
+	}
+	if (ret != 0) {
+		return 1;
+	}
+
+	if (session->full_validation) {
+		struct oscap_source *arf_source = oscap_source_new_from_file(session->export.arf_file);
+		ret = oscap_source_validate(arf_source, _reporter, NULL) != 0;
+		oscap_source_free(arf_source);
+	}
+	return ret;
+}
+
 int xccdf_session_export_arf(struct xccdf_session *session)
 {
 	if (session->export.arf_file != NULL) {
+		if (session->oval.arf_report == NULL && session->tailoring.user_file == NULL) {
+			return _xccdf_session_stream_arf(session);
+		}
+
 		struct oscap_source* arf_source = xccdf_session_create_arf_source(session);
 		if (arf_source == NULL) {
 			return 1;
@@ -2029,6 +2379,11 @@ int xccdf_session_export_all(struct xccdf_session *session)
 		goto cleanup;
 	}
 
+	if (session->export.report_file == NULL && session->tailoring.user_file == NULL) {
+		ret = _xccdf_session_stream_arf(session);
+		goto cleanup;
+	}
+
 	arf_source = xccdf_session_extract_arf_source(session);
 	if (arf_source == NULL) {
 		ret = 1;
@@ -1911,6 +1911,9 @@ struct xccdf_policy * xccdf_policy_new(struct xccdf_policy_model * model, struct
 	policy->reference_filter.title = NULL;
 
 	benchmark = xccdf_policy_model_get_benchmark(model);
+	/* Every item of the benchmark gets its final selection state. */
+	oscap_htable_reserve(policy->selected_final,
+		oscap_htable_itemcount(XITEM(benchmark)->sub.benchmark.items_dict));
 
 	if (profile) {
 		_xccdf_policy_add_profile_selectors(policy, benchmark, profile);
@@ -48,6 +48,9 @@
 #include "xccdf_policy_model_priv.h"
 #include "public/xccdf_policy.h"
 #include "oscap_helpers.h"
+#if defined(OVAL_PROBES_ENABLED)
+#include "OVAL/oval_probe_impl.h"
+#endif
 
 static int _rule_add_info_message(struct xccdf_rule_result *rr, ...)
 {
@@ -578,6 +581,10 @@ int xccdf_policy_rule_result_remediate(struct xccdf_policy *policy, struct xccdf
 			xccdf_rule_result_set_result(rr, XCCDF_RESULT_ERROR);
 			_rule_add_info_message(rr, "Failed to verify applied fix: Missing xccdf:check.");
 		} else {
+#if defined(OVAL_PROBES_ENABLED)
+			/* The probes must not answer from what they saw before the fix */
+			oval_probe_system_changed();
+#endif
 			int new_result = xccdf_policy_check_evaluate(policy, check);
 			if (new_result == XCCDF_RESULT_PASS)
 				xccdf_rule_result_set_result(rr, XCCDF_RESULT_FIXED);
@@ -58,4 +58,30 @@ struct oscap_err_t {
 __attribute__((format (printf, 5, 6)))
 void __oscap_seterr(const char *file, uint32_t line, const char *func, oscap_errfamily_t family, const char *fmt, ...);
 
+/**
+ * Number of errors set so far by any thread. Tells whether an operation
+ * raised an error even if the errors were there before it started.
+ */
+unsigned int oscap_err_count(void);
+
+struct err_queue;
+
+/**
+ * Take the errors of the calling thread, leaving its queue empty. Used to hand
+ * the errors of a worker thread over to the thread which started it.
+ * @returns the errors or NULL if there are none, pass them to oscap_err_attach()
+ */
+struct err_queue *oscap_err_detach(void);
+
+/**
+ * Append the errors taken by oscap_err_detach() to the errors of the calling
+ * thread, in the order they were set.
+ */
+void oscap_err_attach(struct err_queue *errors);
+
+/**
+ * Dispose the errors taken by oscap_err_detach() without reporting them.
+ */
+void oscap_err_discard(struct err_queue *errors);
+
 #endif				/* _OSCAP_ERROR_H */
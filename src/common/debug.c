@@ -311,6 +311,13 @@ void oscap_print_env_vars()
 		"OSCAP_PROBE_MEMORY_USAGE_RATIO",
 		"OSCAP_PROBE_MAX_COLLECTED_ITEMS",
 		"OSCAP_PROBE_IGNORE_PATHS",
+		"OSCAP_PROBE_WALK_CACHE_ENTRIES",
+		"OSCAP_PROBE_COLLECTION_THREADS",
+		"OSCAP_EVALUATION_THREADS",
+		"OSCAP_PROBE_LEGACY_QUEUE",
+		"OSCAP_COLLECTION_CACHE_DIR",
+		"OSCAP_CONTENT_CACHE_DIR",
+		"OSCAP_CONTENT_LOAD_THREADS",
 		NULL
 	};
 	dI("Using environment variables:");
@@ -28,7 +28,10 @@
 #include <config.h>
 #endif
 
+#include <stdio.h>
 #include <string.h>
+#include <errno.h>
+#include <stdint.h>
 #include <fcntl.h>
 #ifdef OS_WINDOWS
 #include <io.h>
@@ -268,3 +271,129 @@ xmlNs *lookup_xsi_ns(xmlDoc *doc)
 	}
 	return ns_xsi;
 }
+
+static int _xml_writer_fd_write(void *context, const char *buffer, int len)
+{
+	int fd = (int) (intptr_t) context;
+	int written = 0;
+	while (written < len) {
+		ssize_t ret = write(fd, buffer + written, len - written);
+		if (ret == -1) {
+			if (errno == EINTR)
+				continue;
+			return -1;
+		}
+		written += ret;
+	}
+	return written;
+}
+
+static int _xml_writer_fd_close(void *context)
+{
+	return close((int) (intptr_t) context);
+}
+
+xmlTextWriterPtr oscap_xml_writer_new_filename(const char *filename)
+{
+	int fd;
+	xmlOutputCloseCallback close_cb = _xml_writer_fd_close;
+
+	if (strcmp(filename, "-") == 0) {
+		fd = fileno(stdout);
+		close_cb = NULL;
+	} else {
+		fd = oscap_open_writable(filename);
+		if (fd == -1)
+			return NULL;
+	}
+
+	xmlOutputBufferPtr buff = xmlOutputBufferCreateIO(_xml_writer_fd_write, close_cb, (void *) (intptr_t) fd, NULL);
+	if (buff == NULL) {
+		if (close_cb != NULL)
+			close(fd);
+		oscap_setxmlerr(xmlGetLastError());
+		return NULL;
+	}
+
+	xmlTextWriterPtr writer = xmlNewTextWriter(buff);
+	if (writer == NULL) {
+		xmlOutputBufferClose(buff);
+		oscap_setxmlerr(xmlGetLastError());
+		return NULL;
+	}
+	if (xmlTextWriterStartDocument(writer, NULL, "UTF-8", NULL) < 0) {
+		xmlFreeTextWriter(writer);
+		oscap_seterr(OSCAP_EFAMILY_XML, "Could not write to %s.", filename);
+		return NULL;
+	}
+	return writer;
+}
+
+int oscap_xml_writer_close(xmlTextWriterPtr writer)
+{
+	int ret = xmlTextWriterEndDocument(writer);
+	xmlFreeTextWriter(writer);
+	if (ret < 0) {
+		oscap_seterr(OSCAP_EFAMILY_XML, "Could not write the XML document: %s.", strerror(errno));
+		return -1;
+	}
+	return 1;
+}
+
+int oscap_xml_writer_start_node(xmlTextWriterPtr writer, xmlNodePtr node)
+{
+	if (xmlTextWriterStartElementNS(writer, node->ns ? node->ns->prefix : NULL, node->name, NULL) < 0)
+		return -1;
+	for (xmlNsPtr ns = node->nsDef; ns != NULL; ns = ns->next) {
+		int ret = ns->prefix != NULL ?
+			xmlTextWriterWriteAttributeNS(writer, BAD_CAST "xmlns", ns->prefix, NULL, ns->href) :
+			xmlTextWriterWriteAttribute(writer, BAD_CAST "xmlns", ns->href);
+		if (ret < 0)
+			return -1;
+	}
+	for (xmlAttrPtr attr = node->properties; attr != NULL; attr = attr->next) {
+		xmlChar *value = xmlNodeListGetString(node->doc, attr->children, 1);
+		int ret = xmlTextWriterWriteAttributeNS(writer, attr->ns ? attr->ns->prefix : NULL, attr->name, NULL, value);
+		xmlFree(value);
+		if (ret < 0)
+			return -1;
+	}
+	// Each element goes on its own line, as the DOM based export does
+	return xmlTextWriterWriteRaw(writer, BAD_CAST "\n") < 0 ? -1 : 0;
+}
+
+int oscap_xml_writer_end_node(xmlTextWriterPtr writer)
+{
+	if (xmlTextWriterEndElement(writer) < 0)
+		return -1;
+	return xmlTextWriterWriteRaw(writer, BAD_CAST "\n") < 0 ? -1 : 0;
+}
+
+int oscap_xml_writer_write_node(xmlTextWriterPtr writer, xmlDocPtr doc, xmlNodePtr node)
+{
+	xmlBufferPtr buffer = xmlBufferCreate();
+	if (buffer == NULL)
+		return -1;
+	int ret = 0;
+	if (xmlNodeDump(buffer, doc, node, 0, 1) < 0
+			|| xmlTextWriterWriteRaw(writer, xmlBufferContent(buffer)) < 0
+			|| xmlTextWriterWriteRaw(writer, BAD_CAST "\n") < 0)
+		ret = -1;
+	xmlBufferFree(buffer);
+	return ret;
+}
+
+int oscap_xml_writer_flush_children(xmlTextWriterPtr writer, xmlDocPtr doc, xmlNodePtr parent)
+{
+	int ret = 0;
+	xmlNodePtr child = parent->children;
+	while (child != NULL) {
+		xmlNodePtr next = child->next;
+		if (ret == 0 && oscap_xml_writer_write_node(writer, doc, child) != 0)
+			ret = -1;
+		xmlUnlinkNode(child);
+		xmlFreeNode(child);
+		child = next;
+	}
+	return ret;
+}
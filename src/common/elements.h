@@ -78,4 +78,49 @@ int oscap_xml_save_filename_free(const char *filename, xmlDocPtr doc);
 
 xmlNs *lookup_xsi_ns(xmlDoc *doc);
 
+/**
+ * Create an XML text writer streaming to the file of the given filename.
+ * The file is opened the same way oscap_xml_save_filename() opens it,
+ * "-" stands for the standard output.
+ * @param filename path to the file
+ * @return the writer with the XML declaration written, NULL on failure (oscap_seterr is set appropriatly).
+ */
+xmlTextWriterPtr oscap_xml_writer_new_filename(const char *filename);
+
+/**
+ * Close all open elements, flush and dispose the writer.
+ * @param writer the writer created by oscap_xml_writer_new_filename()
+ * @return 1 on success, -1 on failure (oscap_seterr is set appropriatly).
+ */
+int oscap_xml_writer_close(xmlTextWriterPtr writer);
+
+/**
+ * Write the start tag of a DOM element, including its namespace declarations
+ * and attributes, and leave the element open in the writer. The element's
+ * children can be written afterwards by oscap_xml_writer_flush_children().
+ * @return 0 on success, -1 on failure
+ */
+int oscap_xml_writer_start_node(xmlTextWriterPtr writer, xmlNodePtr node);
+
+/**
+ * Write the end tag of the element opened last.
+ * @return 0 on success, -1 on failure
+ */
+int oscap_xml_writer_end_node(xmlTextWriterPtr writer);
+
+/**
+ * Serialize a DOM subtree. Namespaces the node inherits from its ancestors
+ * must be declared, with the same prefixes, by elements open in the writer.
+ * @return 0 on success, -1 on failure
+ */
+int oscap_xml_writer_write_node(xmlTextWriterPtr writer, xmlDocPtr doc, xmlNodePtr node);
+
+/**
+ * Serialize the children of a DOM element, then unlink and free them.
+ * This lets a large document be produced in chunks, keeping in memory only
+ * the ancestors of the chunk being built.
+ * @return 0 on success, -1 on failure
+ */
+int oscap_xml_writer_flush_children(xmlTextWriterPtr writer, xmlDocPtr doc, xmlNodePtr parent);
+
 #endif
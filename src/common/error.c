@@ -42,6 +42,7 @@ static pthread_once_t __once = PTHREAD_ONCE_INIT;
 #else
 struct err_queue *q = NULL;
 #endif
+static unsigned int err_count = 0;
 
 #ifdef OSCAP_THREAD_SAFE
 static void oscap_errkey_init(void)
@@ -83,6 +84,7 @@ static inline void _push_err(struct oscap_err_t *err)
 #endif
 	}
 	(void)err_queue_push(q, err);
+	__atomic_add_fetch(&err_count, 1, __ATOMIC_RELAXED);
 }
 
 void __oscap_setxmlerr(const char *file, uint32_t line, const char *func, xmlErrorPtr error)
@@ -147,6 +149,48 @@ void oscap_clearerr(void)
 	err_queue_free(q, (oscap_destruct_func) oscap_err_free);
 }
 
+struct err_queue *oscap_err_detach(void)
+{
+#ifdef OSCAP_THREAD_SAFE
+	(void)pthread_once(&__once, oscap_errkey_init);
+	struct err_queue *detached = pthread_getspecific(__key);
+	(void)pthread_setspecific(__key, NULL);
+#else
+	struct err_queue *detached = q;
+	q = NULL;
+#endif
+	return detached;
+}
+
+void oscap_err_attach(struct err_queue *errors)
+{
+	if (errors == NULL)
+		return;
+#ifdef OSCAP_THREAD_SAFE
+	(void)pthread_once(&__once, oscap_errkey_init);
+	struct err_queue *q = pthread_getspecific(__key);
+#endif
+	if (q == NULL) {
+		q = err_queue_new();
+#ifdef OSCAP_THREAD_SAFE
+		(void)pthread_setspecific(__key, q);
+#endif
+	}
+	while (!err_queue_is_empty(errors))
+		(void)err_queue_push(q, err_queue_pop_first(errors));
+	err_queue_free(errors, NULL);
+}
+
+void oscap_err_discard(struct err_queue *errors)
+{
+	err_queue_free(errors, (oscap_destruct_func) oscap_err_free);
+}
+
+unsigned int oscap_err_count(void)
+{
+	return __atomic_load_n(&err_count, __ATOMIC_RELAXED);
+}
+
 bool oscap_err(void)
 {
 #ifdef OSCAP_THREAD_SAFE
@@ -30,6 +30,7 @@
 #include <stdarg.h>
 
 #include "list.h"
+#include "MurmurHash3.h"
 static inline bool _oscap_iterator_has_more_internal(const struct oscap_iterator *it);
 
 struct oscap_list *oscap_list_new(void)
@@ -391,28 +392,73 @@ OSCAP_ITERATOR_REMOVE(oscap_stringlist, oscap_stringlist_free)
     /*OSCAP_ITERATOR_RESET(oscap_string)*/
 
 
-#define OSCAP_DEFAULT_HSIZE 389
-static inline unsigned int oscap_htable_hash(const char *str, size_t htable_size)
+#define OSCAP_DEFAULT_HSIZE 16
+#define OSCAP_HTABLE_HASH_SEED 0x5eed0a11
+// Maximum load factor (including detached items) in percents.
+#define OSCAP_HTABLE_MAX_LOAD 70
+
+// Marker of slots whose item has been detached. Lookups have to probe past
+// such slots, but new items can be stored into them.
+static char oscap_htable_deleted_key;
+#define OSCAP_HTABLE_DELETED (&oscap_htable_deleted_key)
+
+static inline bool oscap_htable_slot_used(const struct oscap_htable_item *slot)
+{
+	return slot->key != NULL && slot->key != OSCAP_HTABLE_DELETED;
+}
+
+static inline uint32_t oscap_htable_hash(const char *str)
+{
+	uint32_t h;
+	MurmurHash3_x86_32(str, (int) strlen(str), OSCAP_HTABLE_HASH_SEED, &h);
+	return h;
+}
+
+/* Smallest power of two number of slots able to hold count items. */
+static size_t oscap_htable_slots_for(size_t count)
 {
-	unsigned h = 0;
-	unsigned char *p;
-	for (p = (unsigned char *)str; *p != '\0'; p++)
-		h = (97 * h) + *p;
-	return h % htable_size;
+	size_t hsize = OSCAP_DEFAULT_HSIZE;
+	while (hsize * OSCAP_HTABLE_MAX_LOAD / 100 <= count)
+		hsize <<= 1;
+	return hsize;
+}
+
+/* Move all items to a new table of the given size, dropping detached slots. */
+static bool oscap_htable_rehash(struct oscap_htable *htable, size_t hsize)
+{
+	struct oscap_htable_item *table = calloc(hsize, sizeof(struct oscap_htable_item));
+	if (table == NULL)
+		return false;
+
+	const size_t mask = hsize - 1;
+	for (size_t i = 0; i < htable->hsize; ++i) {
+		struct oscap_htable_item *slot = &htable->table[i];
+		if (!oscap_htable_slot_used(slot))
+			continue;
+		size_t pos = slot->hash & mask;
+		while (table[pos].key != NULL)
+			pos = (pos + 1) & mask;
+		table[pos] = *slot;
+	}
+
+	free(htable->table);
+	htable->table = table;
+	htable->hsize = hsize;
+	htable->deleted = 0;
+	return true;
 }
 
 struct oscap_htable *oscap_htable_new1(oscap_compare_func cmp, size_t hsize)
 {
 	struct oscap_htable *t;
-    
-    assert(hsize > 0);
 
 	t = malloc(sizeof(struct oscap_htable));
 	if (t == NULL)
 		return NULL;
-	t->hsize = hsize;
+	t->hsize = oscap_htable_slots_for(hsize);
 	t->itemcount = 0;
-	t->table = calloc(hsize, sizeof(struct oscap_htable_item *));
+	t->deleted = 0;
+	t->table = calloc(t->hsize, sizeof(struct oscap_htable_item));
 	if (t->table == NULL) {
 		free(t);
 		return NULL;
@@ -423,18 +469,16 @@ struct oscap_htable *oscap_htable_new1(oscap_compare_func cmp, size_t hsize)
 
 struct oscap_htable * oscap_htable_clone(const struct oscap_htable * table, oscap_clone_func cloner)
 {
-	struct oscap_htable *t = oscap_htable_new();
+	struct oscap_htable *t = oscap_htable_new1(table->cmp, table->itemcount);
 	if (t == NULL)
 		return NULL;
 
 	for (size_t i = 0; i < table->hsize; ++i) {
-		struct oscap_htable_item *item = table->table[i];
-		while (item != NULL) {
+		const struct oscap_htable_item *item = &table->table[i];
+		if (oscap_htable_slot_used(item))
 			oscap_htable_add(t, item->key, (void *) cloner(item->value));
-			item = item->next;
-		}
 	}
-	
+
 	return t;
 }
 
@@ -449,20 +493,28 @@ static int oscap_htable_cmp(const char *s1, const char *s2)
 
 struct oscap_htable *oscap_htable_new(void)
 {
-	return oscap_htable_new1(oscap_htable_cmp, OSCAP_DEFAULT_HSIZE);
+	return oscap_htable_new1(oscap_htable_cmp, 0);
 }
 
-static struct oscap_htable_item *oscap_htable_lookup(struct oscap_htable *htable, const char *key)
+bool oscap_htable_reserve(struct oscap_htable *htable, size_t count)
 {
 	__attribute__nonnull__(htable);
-	if (key == NULL)
-		return NULL;
-	unsigned int hashcode = oscap_htable_hash(key, htable->hsize);
-	struct oscap_htable_item *htitem = htable->table[hashcode];
-	while (htitem != NULL) {
-		if (htable->cmp(htitem->key, key) == 0)
-			return htitem;
-		htitem = htitem->next;
+	size_t hsize = oscap_htable_slots_for(count);
+	if (hsize <= htable->hsize)
+		return true;
+	return oscap_htable_rehash(htable, hsize);
+}
+
+static struct oscap_htable_item *oscap_htable_lookup(struct oscap_htable *htable, const char *key, uint32_t hash)
+{
+	const size_t mask = htable->hsize - 1;
+	size_t pos = hash & mask;
+	struct oscap_htable_item *slot;
+	while ((slot = &htable->table[pos])->key != NULL) {
+		if (slot->key != OSCAP_HTABLE_DELETED && slot->hash == hash &&
+		    htable->cmp(slot->key, key) == 0)
+			return slot;
+		pos = (pos + 1) & mask;
 	}
 	return NULL;
 }
@@ -470,39 +522,45 @@ static struct oscap_htable_item *oscap_htable_lookup(struct oscap_htable *htable
 bool oscap_htable_add(struct oscap_htable * htable, const char *key, void *item)
 {
 	__attribute__nonnull__(htable);
-	/*
-	   unsigned int hashcode = oscap_htable_hash(key, htable->hsize);
-	   struct oscap_htable_item* htitem = htable->table[hashcode];
-	   while(htitem != NULL)
-	   {
-	   if( (*(htable->cmp))(htitem->key, key) == 0) return false;
-	   if(htitem->next == NULL) break;
-	   htitem = htitem->next;
-	   }
-	   // htitem points to the last item
-	 */
-	if (oscap_htable_lookup(htable, key) != NULL)
+	if (key == NULL)
+		return false;
+	const uint32_t hash = oscap_htable_hash(key);
+	if (oscap_htable_lookup(htable, key, hash) != NULL)
 		return false;
-	unsigned int hashcode = oscap_htable_hash(key, htable->hsize);
-	struct oscap_htable_item *newhtitem;
-	newhtitem = malloc(sizeof(struct oscap_htable_item));
-	newhtitem->key = oscap_strdup(key);
-	newhtitem->value = item;
-	newhtitem->next = htable->table[hashcode];
-	htable->table[hashcode] = newhtitem;
+
+	if ((htable->itemcount + htable->deleted + 1) * 100 > htable->hsize * OSCAP_HTABLE_MAX_LOAD) {
+		/* Detached slots are dropped by the rehash, grow only if really needed */
+		if (!oscap_htable_rehash(htable, oscap_htable_slots_for(htable->itemcount + 1)))
+			return false;
+	}
+
+	const size_t mask = htable->hsize - 1;
+	size_t pos = hash & mask;
+	while (oscap_htable_slot_used(&htable->table[pos]))
+		pos = (pos + 1) & mask;
+	struct oscap_htable_item *slot = &htable->table[pos];
+	if (slot->key == OSCAP_HTABLE_DELETED)
+		htable->deleted--;
+	slot->key = oscap_strdup(key);
+	slot->value = item;
+	slot->hash = hash;
 	htable->itemcount++;
 	return true;
 }
 
 void *oscap_htable_detach(struct oscap_htable *htable, const char *key)
 {
-	struct oscap_htable_item *htitem = oscap_htable_lookup(htable, key);
+	__attribute__nonnull__(htable);
+	if (key == NULL)
+		return NULL;
+	struct oscap_htable_item *htitem = oscap_htable_lookup(htable, key, oscap_htable_hash(key));
 	if (htitem) {
 		void *val = htitem->value;
 		free(htitem->key);
-		htitem->key = NULL;
+		htitem->key = OSCAP_HTABLE_DELETED;
 		htitem->value = NULL;
 		htable->itemcount--;
+		htable->deleted++;
 		return val;
 	}
 	return NULL;
@@ -511,7 +569,9 @@ void *oscap_htable_detach(struct oscap_htable *htable, const char *key)
 void *oscap_htable_get(struct oscap_htable *htable, const char *key)
 {
 	__attribute__nonnull__(htable);
-	struct oscap_htable_item *htitem = oscap_htable_lookup(htable, key);
+	if (key == NULL)
+		return NULL;
+	struct oscap_htable_item *htitem = oscap_htable_lookup(htable, key, oscap_htable_hash(key));
 	return htitem ? htitem->value : NULL;
 }
 
@@ -520,6 +580,29 @@ size_t oscap_htable_itemcount(struct oscap_htable *htable)
 	return htable->itemcount;
 }
 
+void oscap_htable_get_stats(const struct oscap_htable *htable, struct oscap_htable_stats *stats)
+{
+	__attribute__nonnull__(htable);
+	__attribute__nonnull__(stats);
+	const size_t mask = htable->hsize - 1;
+	size_t total_probe = 0;
+
+	memset(stats, 0, sizeof(struct oscap_htable_stats));
+	stats->capacity = htable->hsize;
+	stats->itemcount = htable->itemcount;
+	stats->deleted = htable->deleted;
+	for (size_t i = 0; i < htable->hsize; ++i) {
+		const struct oscap_htable_item *slot = &htable->table[i];
+		if (!oscap_htable_slot_used(slot))
+			continue;
+		size_t probe = ((i - (slot->hash & mask)) & mask) + 1;
+		total_probe += probe;
+		if (probe > stats->max_probe)
+			stats->max_probe = probe;
+	}
+	stats->avg_probe = htable->itemcount ? (double) total_probe / htable->itemcount : 0.0;
+}
+
 void oscap_print_depth(int);
 
 void oscap_htable_dump(struct oscap_htable *htable, oscap_dump_func dumper, int depth)
@@ -529,34 +612,26 @@ void oscap_htable_dump(struct oscap_htable *htable, oscap_dump_func dumper, int
 		return;
 	}
 	printf(" (hash table, %u item%s)\n", (unsigned)htable->itemcount, (htable->itemcount == 1 ? "" : "s"));
-	int i;
-	for (i = 0; i < (int)htable->hsize; ++i) {
-		struct oscap_htable_item *item = htable->table[i];
-		while (item) {
-			oscap_print_depth(depth);
-			printf("'%s':\n", item->key);
-			dumper(item->value, depth + 1);
-			item = item->next;
-		}
+	for (size_t i = 0; i < htable->hsize; ++i) {
+		struct oscap_htable_item *item = &htable->table[i];
+		if (!oscap_htable_slot_used(item))
+			continue;
+		oscap_print_depth(depth);
+		printf("'%s':\n", item->key);
+		dumper(item->value, depth + 1);
 	}
 }
 
 void oscap_htable_free(struct oscap_htable *htable, oscap_destruct_func destructor)
 {
 	if (htable) {
-		size_t ht;
-		struct oscap_htable_item *cur, *next;
-
-		for (ht = 0; ht < htable->hsize; ++ht) {
-			cur = htable->table[ht];
-			while (cur) {
-				next = cur->next;
-				free(cur->key);
-				if (destructor)
-					destructor(cur->value);
-				free(cur);
-				cur = next;
-			}
+		for (size_t i = 0; i < htable->hsize; ++i) {
+			struct oscap_htable_item *cur = &htable->table[i];
+			if (!oscap_htable_slot_used(cur))
+				continue;
+			free(cur->key);
+			if (destructor)
+				destructor(cur->value);
 		}
 
 		free(htable->table);
@@ -571,8 +646,7 @@ void oscap_htable_free0(struct oscap_htable *htable)
 
 struct oscap_htable_iterator {
 	struct oscap_htable *htable;	// Table we iterate through
-	struct oscap_htable_item *cur;	// The current item
-	size_t hpos;			// Line on which we are now
+	size_t hpos;			// Slot to be examined next
 };
 
 struct oscap_htable_iterator *
@@ -580,7 +654,6 @@ oscap_htable_iterator_new(struct oscap_htable *htable)
 {
 	struct oscap_htable_iterator *hit = calloc(1, sizeof(struct oscap_htable_iterator));
 	hit->htable = htable;
-	hit->cur = NULL;
 	hit->hpos = 0;
 	return hit;
 }
@@ -591,22 +664,11 @@ oscap_htable_iterator_has_more(struct oscap_htable_iterator *hit)
 	__attribute__nonnull__(hit);
 	if (hit->htable == NULL)
 		return false;
-	size_t i = hit->hpos;
-	if (hit->cur != NULL) {
-		if (hit->cur->next != NULL)
+	while (hit->hpos < hit->htable->hsize) {
+		if (oscap_htable_slot_used(&hit->htable->table[hit->hpos]))
 			return true;
-		if (i + 1 >= hit->htable->hsize)
-			return false;
-		i++;
-	}
-	for (; i < hit->htable->hsize; i++) {
-		if (hit->htable->table[i] == NULL)
-			continue;
-		if (i != hit->hpos)
-			hit->hpos = i - 1;
-		return true;
+		hit->hpos++;
 	}
-	hit->hpos = i;
 	return false;
 }
 
@@ -614,25 +676,11 @@ const struct oscap_htable_item *
 oscap_htable_iterator_next(struct oscap_htable_iterator *hit)
 {
 	__attribute__nonnull__(hit);
-	if (hit->cur != NULL) {
-		if (hit->cur->next != NULL) {
-			hit->cur = hit->cur->next;
-			return hit->cur;
-		}
-		if (hit->hpos + 1 >= hit->htable->hsize) {
-			assert(false);
-			return NULL;
-		}
-		hit->hpos++;
-	}
-	for (; hit->hpos < hit->htable->hsize; hit->hpos++) {
-		if (hit->htable->table[hit->hpos] == NULL)
-			continue;
-		hit->cur = hit->htable->table[hit->hpos];
-		return hit->cur;
+	if (!oscap_htable_iterator_has_more(hit)) {
+		assert(false); // no more item found
+		return NULL;
 	}
-	assert(false); // no more item found
-	return NULL;
+	return &hit->htable->table[hit->hpos++];
 }
 
 const char *
@@ -663,7 +711,6 @@ void
 oscap_htable_iterator_reset(struct oscap_htable_iterator *hit)
 {
 	__attribute__nonnull__(hit);
-	hit->cur = NULL;
 	hit->hpos = 0;
 }
 
@@ -30,6 +30,7 @@
 
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "util.h"
 #include "public/oscap.h"
@@ -168,25 +169,39 @@ void *oscap_list_find(struct oscap_list *list, void *what, oscap_cmp_func compar
 
 // Comparison function.
 typedef int (*oscap_compare_func) (const char *, const char *);
-// Hash table item.
+// Hash table item (one slot of the open-addressing table).
 struct oscap_htable_item {
-	struct oscap_htable_item *next;	// Next item.
-	char *key;		// Item key.
+	char *key;		// Item key, NULL for an unused slot.
 	void *value;		// Item value.
+	uint32_t hash;		// Cached hash of the key.
 };
 
 // Hash table.
 struct oscap_htable {
-	size_t hsize;		// Size of the hash table.
+	size_t hsize;		// Number of slots, always a power of two.
 	size_t itemcount;	// Number of elements in the hash table.
-	struct oscap_htable_item **table;	// The table itself.
+	size_t deleted;		// Number of slots occupied by detached items.
+	struct oscap_htable_item *table;	// The table itself.
 	oscap_compare_func cmp;	// Funcion used to compare keys (e.g. strcmp).
 };
 
+// Hash table statistics.
+struct oscap_htable_stats {
+	size_t capacity;	// Number of slots.
+	size_t itemcount;	// Number of elements in the hash table.
+	size_t deleted;		// Number of slots occupied by detached items.
+	size_t max_probe;	// Longest probe sequence of a stored key.
+	double avg_probe;	// Average probe sequence length of stored keys.
+};
+
 /*
  * Create a new hash table.
- * @param cmp Pointer to a function used as the key comparator.
- * @hsize Size of the hash table.
+ *
+ * The table uses open addressing with linear probing and grows automatically
+ * when its load factor gets too high, so hsize is only a capacity hint.
+ * @param cmp Pointer to a function used as the key comparator. It has to
+ * consider two keys equal only if they are the same string.
+ * @hsize Expected number of items.
  * @internal
  * @return new hash table
  */
@@ -201,6 +216,21 @@ struct oscap_htable *oscap_htable_new1(oscap_compare_func cmp, size_t hsize);
  */
 struct oscap_htable *oscap_htable_new(void);
 
+/*
+ * Make room for at least the given number of items without further resizing.
+ * @param htable Hash table
+ * @param count Expected number of items
+ * @return True on success, false if the memory could not be allocated.
+ */
+bool oscap_htable_reserve(struct oscap_htable *htable, size_t count);
+
+/*
+ * Collect statistics about the distribution of keys in the hash table.
+ * @param htable Hash table
+ * @param stats Structure to be filled
+ */
+void oscap_htable_get_stats(const struct oscap_htable *htable, struct oscap_htable_stats *stats);
+
 /*
  * Do a Deep Copy of a hashtable and all of its items
  *
@@ -251,6 +281,7 @@ struct oscap_htable_iterator;
 
 /**
  * Create new iterator through hash table. No ordering is defined for items.
+ * Items may be detached from the table while iterating, but no items may be added.
  * @param htable Hash table to iterate through.
  * @return the iterator
  */
@@ -100,6 +100,11 @@ void oscap_buffer_append_binary_data(struct oscap_buffer *s, const char *data, c
 	s->data[s->length] = '\0';
 }
 
+void oscap_buffer_append_char(struct oscap_buffer *s, char c)
+{
+	oscap_buffer_append_binary_data(s, &c, 1);
+}
+
 void oscap_buffer_append_string(struct oscap_buffer *s, const char *t)
 {
 	if (t == NULL)
@@ -0,0 +1,575 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#ifdef HAVE_MMAN_H
+#include <sys/mman.h>
+#endif
+#include <unistd.h>
+#include <openssl/evp.h>
+
+#include "oscap_content_cache.h"
+#include "oscap.h"
+#include "oscap_helpers.h"
+#include "debug_priv.h"
+#include "util.h"
+
+#define OSCAP_CONTENT_CACHE_MAGIC "OSCAPMC1"
+#define OSCAP_CONTENT_CACHE_FORMAT 2
+#define OSCAP_CONTENT_CACHE_NULL_STR UINT32_MAX
+
+struct oscap_content_cache_header {
+	char magic[8];
+	uint32_t format;
+	uint32_t kind;
+	uint8_t key[OSCAP_CONTENT_CACHE_DIGEST_SIZE];
+	char version[32];               ///< Version of the library which stored the entry
+	uint64_t payload_size;
+	uint8_t checksum[OSCAP_CONTENT_CACHE_DIGEST_SIZE];      ///< Digest of the payload
+};
+
+struct oscap_content_cache_entry {
+	void *data;
+	size_t size;
+	const uint8_t *payload;
+	size_t payload_size;
+};
+
+static const char *_oscap_content_cache_suffix(oscap_content_cache_kind_t kind)
+{
+	switch (kind) {
+	case OSCAP_CONTENT_CACHE_SDS_MAP:    return "sds";
+	case OSCAP_CONTENT_CACHE_XCCDF:      return "xccdf";
+	case OSCAP_CONTENT_CACHE_OVAL:       return "oval";
+	case OSCAP_CONTENT_CACHE_CPE_DICT:   return "cpedict";
+	case OSCAP_CONTENT_CACHE_CPE_LANG:   return "cpelang";
+	default:                             return "bin";
+	}
+}
+
+static char *_oscap_content_cache_path(const char *dir, oscap_content_cache_kind_t kind, const uint8_t key[OSCAP_CONTENT_CACHE_DIGEST_SIZE])
+{
+	char name[2 * OSCAP_CONTENT_CACHE_DIGEST_SIZE + 16];
+	int len = 0;
+
+	for (int i = 0; i < OSCAP_CONTENT_CACHE_DIGEST_SIZE; ++i)
+		len += snprintf(name + len, sizeof(name) - len, "%02x", key[i]);
+	snprintf(name + len, sizeof(name) - len, ".%s", _oscap_content_cache_suffix(kind));
+	return oscap_path_join(dir, name);
+}
+
+static void _oscap_content_cache_version(char version[32])
+{
+	memset(version, 0, 32);
+	strncpy(version, oscap_get_version(), 31);
+}
+
+/*
+ * Anybody who can write to the cache can make oscap load arbitrary content,
+ * the directory has to be private to the user.
+ */
+static bool _oscap_content_cache_dir_is_private(const char *dir)
+{
+	struct stat st;
+
+	if (stat(dir, &st) != 0 || !S_ISDIR(st.st_mode)) {
+		dW("The content cache directory '%s' isn't usable.", dir);
+		return false;
+	}
+	if (!oscap_stat_is_private(&st)) {
+		dW("Not using the content cache directory '%s', it isn't owned by the user "
+		   "or it is writable by others.", dir);
+		return false;
+	}
+	return true;
+}
+
+const char *oscap_content_cache_dir(void)
+{
+	const char *dir = getenv("OSCAP_CONTENT_CACHE_DIR");
+
+	if (dir == NULL || *dir == '\0')
+		return NULL;
+	return dir;
+}
+
+void oscap_content_cache_digest(const void *data, size_t size, uint8_t digest[OSCAP_CONTENT_CACHE_DIGEST_SIZE])
+{
+	EVP_Digest(data, size, digest, NULL, EVP_sha256(), NULL);
+}
+
+void oscap_content_cache_key(const uint8_t digest[OSCAP_CONTENT_CACHE_DIGEST_SIZE], const char *extra, uint8_t key[OSCAP_CONTENT_CACHE_DIGEST_SIZE])
+{
+	uint8_t input[OSCAP_CONTENT_CACHE_DIGEST_SIZE];
+	EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+
+	/* the key may be the digest itself */
+	memcpy(input, digest, sizeof(input));
+	EVP_DigestInit_ex(ctx, EVP_sha256(), NULL);
+	EVP_DigestUpdate(ctx, input, sizeof(input));
+	if (extra != NULL)
+		EVP_DigestUpdate(ctx, extra, strlen(extra));
+	EVP_DigestFinal_ex(ctx, key, NULL);
+	EVP_MD_CTX_free(ctx);
+}
+
+struct oscap_content_cache_entry *oscap_content_cache_open(oscap_content_cache_kind_t kind, const uint8_t key[OSCAP_CONTENT_CACHE_DIGEST_SIZE])
+{
+#ifdef HAVE_MMAN_H
+	const char *dir = oscap_content_cache_dir();
+	struct oscap_content_cache_header header;
+	char version[32];
+	uint8_t checksum[OSCAP_CONTENT_CACHE_DIGEST_SIZE];
+	struct stat st;
+
+	if (dir == NULL || !_oscap_content_cache_dir_is_private(dir))
+		return NULL;
+
+	char *path = _oscap_content_cache_path(dir, kind, key);
+	int fd = open(path, O_RDONLY | O_CLOEXEC | O_NOFOLLOW);
+	if (fd < 0) {
+		dD("No content cache entry '%s'.", path);
+		free(path);
+		return NULL;
+	}
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || (size_t) st.st_size < sizeof(header)) {
+		dW("Ignoring the content cache entry '%s', it isn't a valid entry.", path);
+		close(fd);
+		free(path);
+		return NULL;
+	}
+	if (!oscap_stat_is_private(&st)) {
+		dW("Ignoring the content cache entry '%s', it isn't owned by the user or it is writable by others.", path);
+		close(fd);
+		free(path);
+		return NULL;
+	}
+	void *data = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		dW("Can't map the content cache entry '%s': %s", path, strerror(errno));
+		free(path);
+		return NULL;
+	}
+
+	memcpy(&header, data, sizeof(header));
+	_oscap_content_cache_version(version);
+	const uint8_t *payload = (const uint8_t *) data + sizeof(header);
+	size_t payload_size = st.st_size - sizeof(header);
+	const char *problem = NULL;
+
+	if (memcmp(header.magic, OSCAP_CONTENT_CACHE_MAGIC, sizeof(header.magic)) != 0
+	    || header.format != OSCAP_CONTENT_CACHE_FORMAT)
+		problem = "it has an unknown format";
+	else if (header.kind != (uint32_t) kind || memcmp(header.key, key, sizeof(header.key)) != 0)
+		problem = "it belongs to other content";
+	else if (memcmp(header.version, version, sizeof(version)) != 0)
+		problem = "it was stored by another version of the library";
+	else if (header.payload_size != payload_size)
+		problem = "it is truncated";
+	else {
+		oscap_content_cache_digest(payload, payload_size, checksum);
+		if (memcmp(checksum, header.checksum, sizeof(checksum)) != 0)
+			problem = "it is corrupted";
+	}
+	if (problem != NULL) {
+		dW("Ignoring the content cache entry '%s', %s.", path, problem);
+		munmap(data, st.st_size);
+		free(path);
+		return NULL;
+	}
+
+	dD("Using the content cache entry '%s'.", path);
+	free(path);
+	struct oscap_content_cache_entry *entry = malloc(sizeof(struct oscap_content_cache_entry));
+	entry->data = data;
+	entry->size = st.st_size;
+	entry->payload = payload;
+	entry->payload_size = payload_size;
+	return entry;
+#else
+	return NULL;
+#endif
+}
+
+void oscap_content_cache_close(struct oscap_content_cache_entry *entry)
+{
+	if (entry == NULL)
+		return;
+#ifdef HAVE_MMAN_H
+	munmap(entry->data, entry->size);
+#endif
+	free(entry);
+}
+
+static bool _oscap_content_cache_write_all(int fd, const void *data, size_t len)
+{
+	const char *p = data;
+	size_t done = 0;
+
+	while (done < len) {
+		ssize_t w = write(fd, p + done, len - done);
+		if (w < 0 && errno == EINTR)
+			continue;
+		if (w <= 0)
+			return false;
+		done += w;
+	}
+	return true;
+}
+
+int oscap_content_cache_store(oscap_content_cache_kind_t kind, const uint8_t key[OSCAP_CONTENT_CACHE_DIGEST_SIZE], const struct oscap_buffer *payload)
+{
+	const char *dir = oscap_content_cache_dir();
+	struct oscap_content_cache_header header;
+	int ret = -1;
+
+	if (dir == NULL)
+		return -1;
+	if (mkdir(dir, 0700) != 0 && errno != EEXIST) {
+		dW("Can't create the content cache directory '%s': %s", dir, strerror(errno));
+		return -1;
+	}
+	if (!_oscap_content_cache_dir_is_private(dir))
+		return -1;
+
+	const char *data = oscap_buffer_get_raw(payload);
+	size_t len = oscap_buffer_get_length(payload);
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, OSCAP_CONTENT_CACHE_MAGIC, sizeof(header.magic));
+	header.format = OSCAP_CONTENT_CACHE_FORMAT;
+	header.kind = kind;
+	memcpy(header.key, key, sizeof(header.key));
+	_oscap_content_cache_version(header.version);
+	header.payload_size = len;
+	oscap_content_cache_digest(data, len, header.checksum);
+
+	char *path = _oscap_content_cache_path(dir, kind, key);
+	char *tmp_path = oscap_sprintf("%s.XXXXXX", path);
+	/* write a new file and rename it, concurrent readers see either version,
+	 * mkstemp() creates the file private to the user */
+	int fd = mkstemp(tmp_path);
+	if (fd >= 0) {
+		bool written = _oscap_content_cache_write_all(fd, &header, sizeof(header))
+			&& _oscap_content_cache_write_all(fd, data, len);
+		if (close(fd) == 0 && written && rename(tmp_path, path) == 0)
+			ret = 0;
+		else
+			unlink(tmp_path);
+	}
+	if (ret != 0)
+		dW("Can't store the content cache entry '%s': %s", path, strerror(errno));
+	else
+		dI("Stored the content cache entry '%s'.", path);
+	free(tmp_path);
+	free(path);
+	return ret;
+}
+
+void oscap_cache_write_u8(struct oscap_buffer *buf, uint8_t value)
+{
+	oscap_buffer_append_binary_data(buf, (const char *) &value, sizeof(value));
+}
+
+void oscap_cache_write_u32(struct oscap_buffer *buf, uint32_t value)
+{
+	oscap_buffer_append_binary_data(buf, (const char *) &value, sizeof(value));
+}
+
+void oscap_cache_write_u64(struct oscap_buffer *buf, uint64_t value)
+{
+	oscap_buffer_append_binary_data(buf, (const char *) &value, sizeof(value));
+}
+
+void oscap_cache_write_int(struct oscap_buffer *buf, int value)
+{
+	int64_t v = value;
+	oscap_buffer_append_binary_data(buf, (const char *) &v, sizeof(v));
+}
+
+void oscap_cache_write_float(struct oscap_buffer *buf, float value)
+{
+	oscap_buffer_append_binary_data(buf, (const char *) &value, sizeof(value));
+}
+
+void oscap_cache_write_bool(struct oscap_buffer *buf, bool value)
+{
+	oscap_cache_write_u8(buf, value ? 1 : 0);
+}
+
+void oscap_cache_write_str(struct oscap_buffer *buf, const char *str)
+{
+	if (str == NULL) {
+		oscap_cache_write_u32(buf, OSCAP_CONTENT_CACHE_NULL_STR);
+		return;
+	}
+	size_t len = strlen(str);
+	oscap_cache_write_u32(buf, len);
+	/* keep the terminator, the reader can hand out pointers into the entry */
+	oscap_buffer_append_binary_data(buf, str, len + 1);
+}
+
+void oscap_cache_write_text(struct oscap_buffer *buf, const struct oscap_text *text)
+{
+	oscap_cache_write_str(buf, text->lang);
+	oscap_cache_write_str(buf, text->text);
+	oscap_cache_write_u8(buf, text->traits.override_given
+			| text->traits.html << 1
+			| text->traits.can_override << 2
+			| text->traits.can_substitute << 3
+			| text->traits.overrides << 4);
+}
+
+void oscap_cache_write_reference(struct oscap_buffer *buf, const struct oscap_reference *ref)
+{
+	oscap_cache_write_str(buf, ref->title);
+	oscap_cache_write_str(buf, ref->creator);
+	oscap_cache_write_str(buf, ref->subject);
+	oscap_cache_write_str(buf, ref->description);
+	oscap_cache_write_str(buf, ref->publisher);
+	oscap_cache_write_str(buf, ref->contributor);
+	oscap_cache_write_str(buf, ref->date);
+	oscap_cache_write_str(buf, ref->type);
+	oscap_cache_write_str(buf, ref->format);
+	oscap_cache_write_str(buf, ref->identifier);
+	oscap_cache_write_str(buf, ref->source);
+	oscap_cache_write_str(buf, ref->language);
+	oscap_cache_write_str(buf, ref->relation);
+	oscap_cache_write_str(buf, ref->coverage);
+	oscap_cache_write_str(buf, ref->rights);
+	oscap_cache_write_bool(buf, ref->is_dublincore);
+	oscap_cache_write_str(buf, ref->href);
+}
+
+void oscap_cache_write_string_list(struct oscap_buffer *buf, struct oscap_list *list)
+{
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(list));
+	struct oscap_iterator *it = oscap_iterator_new(list);
+	while (oscap_iterator_has_more(it))
+		oscap_cache_write_str(buf, oscap_iterator_next(it));
+	oscap_iterator_free(it);
+}
+
+void oscap_cache_write_text_list(struct oscap_buffer *buf, struct oscap_list *list)
+{
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(list));
+	struct oscap_iterator *it = oscap_iterator_new(list);
+	while (oscap_iterator_has_more(it))
+		oscap_cache_write_text(buf, oscap_iterator_next(it));
+	oscap_iterator_free(it);
+}
+
+void oscap_cache_write_reference_list(struct oscap_buffer *buf, struct oscap_list *list)
+{
+	oscap_cache_write_u32(buf, oscap_list_get_itemcount(list));
+	struct oscap_iterator *it = oscap_iterator_new(list);
+	while (oscap_iterator_has_more(it))
+		oscap_cache_write_reference(buf, oscap_iterator_next(it));
+	oscap_iterator_free(it);
+}
+
+void oscap_cache_reader_init(struct oscap_cache_reader *reader, const struct oscap_content_cache_entry *entry)
+{
+	reader->p = entry->payload;
+	reader->end = entry->payload + entry->payload_size;
+	reader->failed = false;
+}
+
+static bool _read(struct oscap_cache_reader *reader, void *dst, size_t len)
+{
+	if (reader->failed || (size_t) (reader->end - reader->p) < len) {
+		reader->failed = true;
+		memset(dst, 0, len);
+		return false;
+	}
+	memcpy(dst, reader->p, len);
+	reader->p += len;
+	return true;
+}
+
+uint8_t oscap_cache_read_u8(struct oscap_cache_reader *reader)
+{
+	uint8_t value;
+	_read(reader, &value, sizeof(value));
+	return value;
+}
+
+uint32_t oscap_cache_read_u32(struct oscap_cache_reader *reader)
+{
+	uint32_t value;
+	_read(reader, &value, sizeof(value));
+	return value;
+}
+
+uint64_t oscap_cache_read_u64(struct oscap_cache_reader *reader)
+{
+	uint64_t value;
+	_read(reader, &value, sizeof(value));
+	return value;
+}
+
+int oscap_cache_read_int(struct oscap_cache_reader *reader)
+{
+	int64_t value;
+	_read(reader, &value, sizeof(value));
+	if (value < INT_MIN || value > INT_MAX) {
+		reader->failed = true;
+		return 0;
+	}
+	return (int) value;
+}
+
+float oscap_cache_read_float(struct oscap_cache_reader *reader)
+{
+	float value;
+	_read(reader, &value, sizeof(value));
+	return value;
+}
+
+bool oscap_cache_read_bool(struct oscap_cache_reader *reader)
+{
+	return oscap_cache_read_u8(reader) != 0;
+}
+
+const char *oscap_cache_read_cstr(struct oscap_cache_reader *reader)
+{
+	uint32_t len = oscap_cache_read_u32(reader);
+
+	if (reader->failed || len == OSCAP_CONTENT_CACHE_NULL_STR)
+		return NULL;
+	if ((size_t) (reader->end - reader->p) <= len || reader->p[len] != '\0'
+	    || memchr(reader->p, '\0', len) != NULL) {
+		reader->failed = true;
+		return NULL;
+	}
+	const char *str = (const char *) reader->p;
+	reader->p += len + 1;
+	return str;
+}
+
+char *oscap_cache_read_str(struct oscap_cache_reader *reader)
+{
+	return oscap_strdup(oscap_cache_read_cstr(reader));
+}
+
+uint32_t oscap_cache_read_count(struct oscap_cache_reader *reader, size_t min_size)
+{
+	uint32_t count = oscap_cache_read_u32(reader);
+
+	if (min_size == 0)
+		min_size = 1;
+	if (reader->failed || (size_t) (reader->end - reader->p) / min_size < count) {
+		reader->failed = true;
+		return 0;
+	}
+	return count;
+}
+
+struct oscap_text *oscap_cache_read_text(struct oscap_cache_reader *reader)
+{
+	const char *lang = oscap_cache_read_cstr(reader);
+	const char *text = oscap_cache_read_cstr(reader);
+	uint8_t bits = oscap_cache_read_u8(reader);
+
+	if (reader->failed)
+		return NULL;
+	struct oscap_text_traits traits = {
+		.override_given = bits & 1,
+		.html = (bits >> 1) & 1,
+		.can_override = (bits >> 2) & 1,
+		.can_substitute = (bits >> 3) & 1,
+		.overrides = (bits >> 4) & 1,
+	};
+	return oscap_text_new_full(traits, text, lang);
+}
+
+struct oscap_reference *oscap_cache_read_reference(struct oscap_cache_reader *reader)
+{
+	struct oscap_reference *ref = oscap_reference_new();
+
+	ref->title = oscap_cache_read_str(reader);
+	ref->creator = oscap_cache_read_str(reader);
+	ref->subject = oscap_cache_read_str(reader);
+	ref->description = oscap_cache_read_str(reader);
+	ref->publisher = oscap_cache_read_str(reader);
+	ref->contributor = oscap_cache_read_str(reader);
+	ref->date = oscap_cache_read_str(reader);
+	ref->type = oscap_cache_read_str(reader);
+	ref->format = oscap_cache_read_str(reader);
+	ref->identifier = oscap_cache_read_str(reader);
+	ref->source = oscap_cache_read_str(reader);
+	ref->language = oscap_cache_read_str(reader);
+	ref->relation = oscap_cache_read_str(reader);
+	ref->coverage = oscap_cache_read_str(reader);
+	ref->rights = oscap_cache_read_str(reader);
+	ref->is_dublincore = oscap_cache_read_bool(reader);
+	ref->href = oscap_cache_read_str(reader);
+	if (reader->failed) {
+		oscap_reference_free(ref);
+		return NULL;
+	}
+	return ref;
+}
+
+bool oscap_cache_read_string_list(struct oscap_cache_reader *reader, struct oscap_list *list)
+{
+	uint32_t count = oscap_cache_read_count(reader, sizeof(uint32_t));
+
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		char *str = oscap_cache_read_str(reader);
+		if (str != NULL)
+			oscap_list_add(list, str);
+	}
+	return !reader->failed;
+}
+
+bool oscap_cache_read_text_list(struct oscap_cache_reader *reader, struct oscap_list *list)
+{
+	uint32_t count = oscap_cache_read_count(reader, 2 * sizeof(uint32_t) + 1);
+
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct oscap_text *text = oscap_cache_read_text(reader);
+		if (text != NULL)
+			oscap_list_add(list, text);
+	}
+	return !reader->failed;
+}
+
+bool oscap_cache_read_reference_list(struct oscap_cache_reader *reader, struct oscap_list *list)
+{
+	uint32_t count = oscap_cache_read_count(reader, 16 * sizeof(uint32_t) + 1);
+
+	for (uint32_t i = 0; i < count && !reader->failed; ++i) {
+		struct oscap_reference *ref = oscap_cache_read_reference(reader);
+		if (ref != NULL)
+			oscap_list_add(list, ref);
+	}
+	return !reader->failed;
+}
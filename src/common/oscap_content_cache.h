@@ -0,0 +1,146 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef OSCAP_CONTENT_CACHE_H_
+#define OSCAP_CONTENT_CACHE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "list.h"
+#include "oscap_buffer.h"
+#include "text_priv.h"
+#include "reference_priv.h"
+
+/*
+ * Persistent cache of parsed SCAP content, kept in the directory given by
+ * the OSCAP_CONTENT_CACHE_DIR environment variable. An entry holds a binary
+ * serialization of a model built from a document and is keyed by the SHA-256
+ * digest of the document, so that the document doesn't have to be parsed
+ * again as long as it doesn't change. The directory and the entries have to
+ * be owned by the user and mustn't be writable by others, otherwise they
+ * are ignored.
+ *
+ * Every entry starts with a header telling the format, the kind of the
+ * entry, its key, the version of the library which stored it and a checksum
+ * of the payload. Entries which don't match in any of these are ignored.
+ * The data are kept in the native byte order, the cache is local to the host.
+ */
+
+#define OSCAP_CONTENT_CACHE_DIGEST_SIZE 32
+
+typedef enum {
+	OSCAP_CONTENT_CACHE_SDS_MAP = 1,        ///< Map of a Source DataStream file
+	OSCAP_CONTENT_CACHE_XCCDF,              ///< XCCDF Benchmark
+	OSCAP_CONTENT_CACHE_OVAL,               ///< OVAL definition model
+	OSCAP_CONTENT_CACHE_CPE_DICT,           ///< CPE dictionary
+	OSCAP_CONTENT_CACHE_CPE_LANG,           ///< CPE language model
+} oscap_content_cache_kind_t;
+
+struct oscap_content_cache_entry;
+
+/*
+ * Directory of the cache or NULL if the cache isn't used
+ */
+const char *oscap_content_cache_dir(void);
+
+/*
+ * Compute the digest of the data
+ */
+void oscap_content_cache_digest(const void *data, size_t size, uint8_t digest[OSCAP_CONTENT_CACHE_DIGEST_SIZE]);
+
+/*
+ * Derive a key from the digest of a document and a string which tells
+ * what the entry depends on besides the document
+ */
+void oscap_content_cache_key(const uint8_t digest[OSCAP_CONTENT_CACHE_DIGEST_SIZE], const char *extra, uint8_t key[OSCAP_CONTENT_CACHE_DIGEST_SIZE]);
+
+/*
+ * Map the entry of given kind and key into memory. Returns NULL if there is
+ * no such entry or if it can't be used.
+ */
+struct oscap_content_cache_entry *oscap_content_cache_open(oscap_content_cache_kind_t kind, const uint8_t key[OSCAP_CONTENT_CACHE_DIGEST_SIZE]);
+
+void oscap_content_cache_close(struct oscap_content_cache_entry *entry);
+
+/*
+ * Store the payload as the entry of given kind and key. The entry is
+ * replaced atomically, concurrent readers see either version.
+ */
+int oscap_content_cache_store(oscap_content_cache_kind_t kind, const uint8_t key[OSCAP_CONTENT_CACHE_DIGEST_SIZE], const struct oscap_buffer *payload);
+
+/*
+ * Serialization of the payload. Strings are stored with their length,
+ * NULL is distinct from an empty string.
+ */
+void oscap_cache_write_u8(struct oscap_buffer *buf, uint8_t value);
+void oscap_cache_write_u32(struct oscap_buffer *buf, uint32_t value);
+void oscap_cache_write_u64(struct oscap_buffer *buf, uint64_t value);
+void oscap_cache_write_int(struct oscap_buffer *buf, int value);
+void oscap_cache_write_float(struct oscap_buffer *buf, float value);
+void oscap_cache_write_bool(struct oscap_buffer *buf, bool value);
+void oscap_cache_write_str(struct oscap_buffer *buf, const char *str);
+void oscap_cache_write_text(struct oscap_buffer *buf, const struct oscap_text *text);
+void oscap_cache_write_reference(struct oscap_buffer *buf, const struct oscap_reference *ref);
+/* The list holds strings */
+void oscap_cache_write_string_list(struct oscap_buffer *buf, struct oscap_list *list);
+/* The list holds oscap_text */
+void oscap_cache_write_text_list(struct oscap_buffer *buf, struct oscap_list *list);
+/* The list holds oscap_reference */
+void oscap_cache_write_reference_list(struct oscap_buffer *buf, struct oscap_list *list);
+
+/*
+ * Deserialization of the payload. Reading past the end of the payload or
+ * reading malformed data sets the failed flag and further reads return
+ * zeroes and NULLs, so the flag can be checked once at the end.
+ */
+struct oscap_cache_reader {
+	const uint8_t *p;
+	const uint8_t *end;
+	bool failed;
+};
+
+/* Functions (de)serializing a model, see oscap_source_cache_load() */
+typedef void *(*oscap_content_cache_read_func)(struct oscap_cache_reader *reader);
+typedef void (*oscap_content_cache_write_func)(struct oscap_buffer *buf, const void *model);
+
+void oscap_cache_reader_init(struct oscap_cache_reader *reader, const struct oscap_content_cache_entry *entry);
+uint8_t oscap_cache_read_u8(struct oscap_cache_reader *reader);
+uint32_t oscap_cache_read_u32(struct oscap_cache_reader *reader);
+uint64_t oscap_cache_read_u64(struct oscap_cache_reader *reader);
+int oscap_cache_read_int(struct oscap_cache_reader *reader);
+float oscap_cache_read_float(struct oscap_cache_reader *reader);
+bool oscap_cache_read_bool(struct oscap_cache_reader *reader);
+/* The string points into the entry, it's valid until the entry is closed */
+const char *oscap_cache_read_cstr(struct oscap_cache_reader *reader);
+/* A copy of the string */
+char *oscap_cache_read_str(struct oscap_cache_reader *reader);
+/*
+ * Read a count of elements written by oscap_cache_write_u32(), each of them
+ * takes at least min_size bytes. Counts which can't fit fail the reader.
+ */
+uint32_t oscap_cache_read_count(struct oscap_cache_reader *reader, size_t min_size);
+struct oscap_text *oscap_cache_read_text(struct oscap_cache_reader *reader);
+struct oscap_reference *oscap_cache_read_reference(struct oscap_cache_reader *reader);
+bool oscap_cache_read_string_list(struct oscap_cache_reader *reader, struct oscap_list *list);
+bool oscap_cache_read_text_list(struct oscap_cache_reader *reader, struct oscap_list *list);
+bool oscap_cache_read_reference_list(struct oscap_cache_reader *reader, struct oscap_list *list);
+
+#endif
@@ -0,0 +1,230 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef OSCAP_THREAD_SAFE
+#include <pthread.h>
+#endif
+
+#include "MurmurHash3.h"
+#include "debug_priv.h"
+#include "oscap_intern.h"
+
+/*
+ * The pool is split into shards by the string hash, each shard is a chained
+ * hash table with its own lock, so that threads interning different strings
+ * rarely wait for each other. The interned string is stored right behind its
+ * entry header, which lets oscap_intern_release() find the entry from
+ * the string pointer.
+ */
+#define OSCAP_INTERN_SHARDS 16
+#define OSCAP_INTERN_INITIAL_BUCKETS 64
+#define OSCAP_INTERN_SEED 0x6f736361
+
+struct oscap_intern_entry {
+	struct oscap_intern_entry *next;
+	uint32_t hash;
+	size_t refcount;
+	size_t len;
+	char str[];
+};
+
+struct oscap_intern_shard {
+	struct oscap_intern_entry **buckets;
+	size_t bucket_count;
+	size_t count;
+	size_t references;
+	size_t bytes;
+	size_t saved_bytes;
+#ifdef OSCAP_THREAD_SAFE
+	pthread_mutex_t lock;
+#endif
+};
+
+#ifdef OSCAP_THREAD_SAFE
+#define OSCAP_INTERN_SHARD_INIT { NULL, 0, 0, 0, 0, 0, PTHREAD_MUTEX_INITIALIZER }
+#define OSCAP_INTERN_LOCK(shard) (void)pthread_mutex_lock(&(shard)->lock)
+#define OSCAP_INTERN_UNLOCK(shard) (void)pthread_mutex_unlock(&(shard)->lock)
+#else
+#define OSCAP_INTERN_SHARD_INIT { NULL, 0, 0, 0, 0, 0 }
+#define OSCAP_INTERN_LOCK(shard) do {} while (0)
+#define OSCAP_INTERN_UNLOCK(shard) do {} while (0)
+#endif
+
+static struct oscap_intern_shard oscap_intern_pool[OSCAP_INTERN_SHARDS] = {
+	OSCAP_INTERN_SHARD_INIT, OSCAP_INTERN_SHARD_INIT, OSCAP_INTERN_SHARD_INIT, OSCAP_INTERN_SHARD_INIT,
+	OSCAP_INTERN_SHARD_INIT, OSCAP_INTERN_SHARD_INIT, OSCAP_INTERN_SHARD_INIT, OSCAP_INTERN_SHARD_INIT,
+	OSCAP_INTERN_SHARD_INIT, OSCAP_INTERN_SHARD_INIT, OSCAP_INTERN_SHARD_INIT, OSCAP_INTERN_SHARD_INIT,
+	OSCAP_INTERN_SHARD_INIT, OSCAP_INTERN_SHARD_INIT, OSCAP_INTERN_SHARD_INIT, OSCAP_INTERN_SHARD_INIT,
+};
+
+static inline struct oscap_intern_entry *_oscap_intern_entry(const char *str)
+{
+	return (struct oscap_intern_entry *) (str - offsetof(struct oscap_intern_entry, str));
+}
+
+static inline struct oscap_intern_shard *_oscap_intern_shard(uint32_t hash)
+{
+	/* The low bits pick the bucket, use the high ones for the shard */
+	return &oscap_intern_pool[hash >> 28];
+}
+
+/* Has to be called with the shard lock held */
+static int _oscap_intern_grow(struct oscap_intern_shard *shard)
+{
+	size_t bucket_count = shard->bucket_count ? shard->bucket_count * 2 : OSCAP_INTERN_INITIAL_BUCKETS;
+	struct oscap_intern_entry **buckets = calloc(bucket_count, sizeof(*buckets));
+
+	if (buckets == NULL)
+		return -1;
+	for (size_t i = 0; i < shard->bucket_count; i++) {
+		struct oscap_intern_entry *entry = shard->buckets[i];
+		while (entry != NULL) {
+			struct oscap_intern_entry *next = entry->next;
+			size_t idx = entry->hash & (bucket_count - 1);
+			entry->next = buckets[idx];
+			buckets[idx] = entry;
+			entry = next;
+		}
+	}
+	free(shard->buckets);
+	shard->buckets = buckets;
+	shard->bucket_count = bucket_count;
+	return 0;
+}
+
+const char *oscap_intern(const char *str)
+{
+	if (str == NULL)
+		return NULL;
+
+	size_t len = strlen(str);
+	uint32_t hash;
+	MurmurHash3_x86_32(str, (int) len, OSCAP_INTERN_SEED, &hash);
+	struct oscap_intern_shard *shard = _oscap_intern_shard(hash);
+	struct oscap_intern_entry *entry = NULL;
+
+	OSCAP_INTERN_LOCK(shard);
+	if (shard->bucket_count > 0) {
+		entry = shard->buckets[hash & (shard->bucket_count - 1)];
+		while (entry != NULL &&
+		       (entry->hash != hash || entry->len != len || memcmp(entry->str, str, len) != 0))
+			entry = entry->next;
+	}
+	if (entry != NULL) {
+		entry->refcount++;
+		shard->references++;
+		shard->saved_bytes += len + 1;
+		OSCAP_INTERN_UNLOCK(shard);
+		return entry->str;
+	}
+
+	if (shard->count >= shard->bucket_count && _oscap_intern_grow(shard) != 0) {
+		OSCAP_INTERN_UNLOCK(shard);
+		return NULL;
+	}
+	entry = malloc(sizeof(*entry) + len + 1);
+	if (entry == NULL) {
+		OSCAP_INTERN_UNLOCK(shard);
+		return NULL;
+	}
+	memcpy(entry->str, str, len + 1);
+	entry->hash = hash;
+	entry->len = len;
+	entry->refcount = 1;
+	size_t idx = hash & (shard->bucket_count - 1);
+	entry->next = shard->buckets[idx];
+	shard->buckets[idx] = entry;
+	shard->count++;
+	shard->references++;
+	shard->bytes += len + 1;
+	OSCAP_INTERN_UNLOCK(shard);
+	return entry->str;
+}
+
+const char *oscap_intern_ref(const char *str)
+{
+	if (str == NULL)
+		return NULL;
+
+	struct oscap_intern_entry *entry = _oscap_intern_entry(str);
+	struct oscap_intern_shard *shard = _oscap_intern_shard(entry->hash);
+
+	OSCAP_INTERN_LOCK(shard);
+	entry->refcount++;
+	shard->references++;
+	shard->saved_bytes += entry->len + 1;
+	OSCAP_INTERN_UNLOCK(shard);
+	return str;
+}
+
+void oscap_intern_release(const char *str)
+{
+	if (str == NULL)
+		return;
+
+	struct oscap_intern_entry *entry = _oscap_intern_entry(str);
+	struct oscap_intern_shard *shard = _oscap_intern_shard(entry->hash);
+
+	OSCAP_INTERN_LOCK(shard);
+	shard->references--;
+	if (--entry->refcount > 0) {
+		shard->saved_bytes -= entry->len + 1;
+		OSCAP_INTERN_UNLOCK(shard);
+		return;
+	}
+	struct oscap_intern_entry **link = &shard->buckets[entry->hash & (shard->bucket_count - 1)];
+	while (*link != entry)
+		link = &(*link)->next;
+	*link = entry->next;
+	shard->count--;
+	shard->bytes -= entry->len + 1;
+	OSCAP_INTERN_UNLOCK(shard);
+	free(entry);
+}
+
+void oscap_intern_get_stats(struct oscap_intern_stats *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+	for (int i = 0; i < OSCAP_INTERN_SHARDS; i++) {
+		struct oscap_intern_shard *shard = &oscap_intern_pool[i];
+		OSCAP_INTERN_LOCK(shard);
+		stats->strings += shard->count;
+		stats->references += shard->references;
+		stats->bytes += shard->bytes;
+		stats->saved_bytes += shard->saved_bytes;
+		OSCAP_INTERN_UNLOCK(shard);
+	}
+}
+
+void oscap_intern_log_stats(void)
+{
+	struct oscap_intern_stats stats;
+
+	oscap_intern_get_stats(&stats);
+	dI("String pool: %zu strings (%zu bytes) shared by %zu references, %zu bytes saved.",
+	   stats.strings, stats.bytes, stats.references, stats.saved_bytes);
+}
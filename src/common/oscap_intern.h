@@ -0,0 +1,64 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef OSCAP_INTERN_H_
+#define OSCAP_INTERN_H_
+
+#include <stddef.h>
+
+/**
+ * Return the process-wide copy of str, adding it to the pool first if needed.
+ * Equal strings are interned to the same pointer, so interned strings can be
+ * compared by their addresses. Every returned reference has to be released
+ * by oscap_intern_release(). The pool is safe to use from multiple threads.
+ * @param str string to intern, may be NULL
+ * @return interned string, NULL if str is NULL
+ */
+const char *oscap_intern(const char *str);
+
+/**
+ * Take another reference to a string returned by oscap_intern().
+ * This doesn't look the string up, so it is cheaper than oscap_intern().
+ * @param str interned string, may be NULL
+ * @return str
+ */
+const char *oscap_intern_ref(const char *str);
+
+/**
+ * Release a reference to an interned string. The string is removed from
+ * the pool when its last reference is released.
+ * @param str interned string, may be NULL
+ */
+void oscap_intern_release(const char *str);
+
+struct oscap_intern_stats {
+	size_t strings;		///< distinct strings in the pool
+	size_t references;	///< references held to them
+	size_t bytes;		///< bytes taken by the strings
+	size_t saved_bytes;	///< bytes the references would take as private copies
+};
+
+void oscap_intern_get_stats(struct oscap_intern_stats *stats);
+
+/**
+ * Write the string pool size and the heap it saves to the debug log.
+ */
+void oscap_intern_log_stats(void);
+
+#endif
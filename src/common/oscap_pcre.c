@@ -25,31 +25,187 @@
 #endif
 
 #include <memory.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef OSCAP_THREAD_SAFE
+#include <pthread.h>
+#endif
 
 #define OSCAP_PCRE_EXEC_RECURSION_LIMIT_DEFAULT 3500
+#define OSCAP_PCRE_CACHE_SIZE 256
 
 #ifdef HAVE_PCRE2
 #define PCRE2_CODE_UNIT_WIDTH 8
 #define PCRE2_ERR_BUF_SIZE 127
+#define OSCAP_PCRE_JIT_STACK_START (32 * 1024)
+#define OSCAP_PCRE_JIT_STACK_MAX (1024 * 1024)
+#define OSCAP_PCRE_JIT_STACK_PER_DEPTH 4
+#define OSCAP_PCRE_MATCH_DATA_PAIRS 20
+#define OSCAP_PCRE_LIMITED_JIT_STACKS 4
 #include <pcre2.h>
 #else
 #include <pcre.h>
 #endif
 
 #include "debug_priv.h"
+#include "list.h"
+#include "oscap_helpers.h"
 #include "oscap_pcre.h"
 
 
 struct oscap_pcre {
 #ifdef HAVE_PCRE2
 	pcre2_code_8           *re;
-	pcre2_match_context_8  *re_ctx;
+	uint32_t                depth_limit; // 0 means the library default
+	uint32_t                pairs;       // capture groups + the whole match
 #else
 	pcre                   *re;
 	struct pcre_extra      *re_extra;
 #endif
+	bool                    optimized; // prepared for partial matching
+	bool                    cached;    // owned by the regex cache
+	unsigned int            refcount;  // references held by the cache and its users
+};
+
+#ifdef HAVE_PCRE2
+/*
+ * Matching state reused by all matches done by one thread. The match data
+ * is only used until the ovector is copied out of it and matches on one
+ * thread never overlap, so a single block shared by all patterns is
+ * enough. It grows to the largest capture count matched so far and is
+ * never shrunk, so it is only reallocated while new patterns with more
+ * groups show up. The match context gets the depth limit and the JIT
+ * stack for each match. Stacks for limited patterns are kept per limit,
+ * patterns are usually limited to one of a few values.
+ */
+struct oscap_pcre_limited_jit_stack {
+	pcre2_jit_stack_8      *stack;
+	uint32_t                depth;              // depth limit the stack was sized for
+};
+
+struct oscap_pcre_thread_state {
+	pcre2_match_data_8     *mdata;
+	uint32_t                mdata_pairs;
+	pcre2_match_context_8  *mctx;
+	pcre2_jit_stack_8      *jit_stack;          // for patterns without depth limit
+	struct oscap_pcre_limited_jit_stack limited[OSCAP_PCRE_LIMITED_JIT_STACKS];
+	unsigned int            limited_next;       // slot replaced when no limit matches
 };
 
+static uint32_t oscap_pcre_default_depth_limit;
+
+#ifdef OSCAP_THREAD_SAFE
+static pthread_key_t __key;
+static pthread_once_t __once = PTHREAD_ONCE_INIT;
+#else
+static struct oscap_pcre_thread_state *__state = NULL;
+#endif
+
+static void oscap_pcre_thread_state_free(void *ptr)
+{
+	struct oscap_pcre_thread_state *state = ptr;
+	if (state == NULL)
+		return;
+	if (state->mdata != NULL)
+		pcre2_match_data_free_8(state->mdata);
+	if (state->mctx != NULL)
+		pcre2_match_context_free_8(state->mctx);
+	if (state->jit_stack != NULL)
+		pcre2_jit_stack_free_8(state->jit_stack);
+	for (int i = 0; i < OSCAP_PCRE_LIMITED_JIT_STACKS; i++) {
+		if (state->limited[i].stack != NULL)
+			pcre2_jit_stack_free_8(state->limited[i].stack);
+	}
+	free(state);
+}
+
+static void oscap_pcre_init(void)
+{
+	if (pcre2_config_8(PCRE2_CONFIG_DEPTHLIMIT, &oscap_pcre_default_depth_limit) < 0)
+		oscap_pcre_default_depth_limit = UINT32_MAX;
+#ifdef OSCAP_THREAD_SAFE
+	(void)pthread_key_create(&__key, oscap_pcre_thread_state_free);
+#endif
+}
+
+static struct oscap_pcre_thread_state *oscap_pcre_get_thread_state(uint32_t pairs)
+{
+	struct oscap_pcre_thread_state *state;
+#ifdef OSCAP_THREAD_SAFE
+	(void)pthread_once(&__once, oscap_pcre_init);
+	state = pthread_getspecific(__key);
+#else
+	if (__state == NULL)
+		oscap_pcre_init();
+	state = __state;
+#endif
+	if (state == NULL) {
+		state = calloc(1, sizeof(struct oscap_pcre_thread_state));
+		if (state == NULL)
+			return NULL;
+		state->mctx = pcre2_match_context_create_8(NULL);
+		if (state->mctx == NULL) {
+			oscap_pcre_thread_state_free(state);
+			return NULL;
+		}
+		state->jit_stack = pcre2_jit_stack_create_8(OSCAP_PCRE_JIT_STACK_START, OSCAP_PCRE_JIT_STACK_MAX, NULL);
+#ifdef OSCAP_THREAD_SAFE
+		(void)pthread_setspecific(__key, state);
+#else
+		__state = state;
+#endif
+	}
+	if (state->mdata == NULL || state->mdata_pairs < pairs) {
+		uint32_t new_pairs = pairs > OSCAP_PCRE_MATCH_DATA_PAIRS ? pairs : OSCAP_PCRE_MATCH_DATA_PAIRS;
+		pcre2_match_data_8 *mdata = pcre2_match_data_create_8(new_pairs, NULL);
+		if (mdata == NULL)
+			return NULL;
+		if (state->mdata != NULL)
+			pcre2_match_data_free_8(state->mdata);
+		state->mdata = mdata;
+		state->mdata_pairs = new_pairs;
+	}
+	return state;
+}
+
+/*
+ * The JIT ignores the depth limit, so patterns with a limit run on a JIT
+ * stack sized proportionally to it. Matches exhausting that stack are
+ * repeated by the interpreter, which enforces the exact limit.
+ */
+static void oscap_pcre_prepare_match(struct oscap_pcre_thread_state *state, uint32_t depth_limit)
+{
+	pcre2_jit_stack_8 *stack = state->jit_stack;
+	if (depth_limit != 0) {
+		struct oscap_pcre_limited_jit_stack *limited = NULL;
+		for (int i = 0; i < OSCAP_PCRE_LIMITED_JIT_STACKS; i++) {
+			if (state->limited[i].stack != NULL && state->limited[i].depth == depth_limit) {
+				limited = &state->limited[i];
+				break;
+			}
+		}
+		if (limited == NULL) {
+			size_t max = (size_t) depth_limit * OSCAP_PCRE_JIT_STACK_PER_DEPTH;
+			if (max > OSCAP_PCRE_JIT_STACK_MAX)
+				max = OSCAP_PCRE_JIT_STACK_MAX;
+			limited = &state->limited[state->limited_next];
+			state->limited_next = (state->limited_next + 1) % OSCAP_PCRE_LIMITED_JIT_STACKS;
+			if (limited->stack != NULL)
+				pcre2_jit_stack_free_8(limited->stack);
+			limited->stack = pcre2_jit_stack_create_8(
+				max < OSCAP_PCRE_JIT_STACK_START ? max : OSCAP_PCRE_JIT_STACK_START, max, NULL);
+			limited->depth = depth_limit;
+		}
+		stack = limited->stack;
+	}
+	/* Without a JIT stack PCRE2 uses a small one on the machine stack */
+	pcre2_jit_stack_assign_8(state->mctx, NULL, stack);
+	pcre2_set_depth_limit_8(state->mctx, depth_limit ? depth_limit : oscap_pcre_default_depth_limit);
+}
+#endif
+
 
 static inline int _oscap_pcre_opts_to_pcre(oscap_pcre_options_t opts)
 {
@@ -138,38 +294,58 @@ oscap_pcre_t *oscap_pcre_compile(const char *pattern, oscap_pcre_options_t optio
                                  char **errptr, int *erroffset)
 {
 	oscap_pcre_t *res = malloc(sizeof(oscap_pcre_t));
+	res->optimized = false;
+	res->cached = false;
+	res->refcount = 1;
+	// Partial matching is a match-time option, it only affects the optimization
+	int compile_opts = _oscap_pcre_opts_to_pcre(options & ~OSCAP_PCRE_OPTS_PARTIAL);
 #ifdef HAVE_PCRE2
 	int errno;
 	PCRE2_SIZE erroffset2;
-	res->re_ctx = NULL;
+	res->depth_limit = 0;
+	res->pairs = 1;
 	dD("pcre2_compile_8: patt=%s", pattern);
-	res->re = pcre2_compile_8((PCRE2_SPTR)pattern, PCRE2_ZERO_TERMINATED, _oscap_pcre_opts_to_pcre(options), &errno, &erroffset2, NULL);
+	res->re = pcre2_compile_8((PCRE2_SPTR)pattern, PCRE2_ZERO_TERMINATED, compile_opts, &errno, &erroffset2, NULL);
 	if (res->re == NULL) {
 		PCRE2_UCHAR8 errmsg[PCRE2_ERR_BUF_SIZE];
 		pcre2_get_error_message_8(errno, errmsg, PCRE2_ERR_BUF_SIZE);
 		dW("pcre2_compile_8: error (at offset %d): %s", erroffset2, errmsg);
 		*erroffset = erroffset2;
 		*errptr = strdup((const char*)errmsg);
+	} else {
+		uint32_t capture_count;
+		if (pcre2_pattern_info_8(res->re, PCRE2_INFO_CAPTURECOUNT, &capture_count) == 0)
+			res->pairs = capture_count + 1;
+		/* JIT is optional, pcre2_match_8() uses the interpreter if it's not available */
+		int rc = pcre2_jit_compile_8(res->re, PCRE2_JIT_COMPLETE);
+		if (rc < 0 && rc != PCRE2_ERROR_JIT_BADOPTION)
+			dD("pcre2_jit_compile_8: rc=%d, using the interpreter", rc);
 	}
 #else
 	res->re_extra = NULL;
 	dD("pcre_compile: patt=%s", pattern);
-	res->re = pcre_compile(pattern, _oscap_pcre_opts_to_pcre(options), (const char **)errptr, erroffset, NULL);
+	res->re = pcre_compile(pattern, compile_opts, (const char **)errptr, erroffset, NULL);
 	if (res->re == NULL)
 		dW("pcre_compile: error (at offset %d): %s", *erroffset, *errptr);
 #endif
 	if (res->re == NULL) {
 		free(res);
-		res = NULL;
+		return NULL;
 	}
+	if (options & OSCAP_PCRE_OPTS_PARTIAL)
+		oscap_pcre_optimize(res);
 	return res;
 }
 
 void oscap_pcre_optimize(oscap_pcre_t *opcre)
 {
+	if (opcre->optimized)
+		return;
+	opcre->optimized = true;
 #ifdef HAVE_PCRE2
-	// This is a NOOP for PCRE2 as all patterns are optimized
-	// unless the library configured differently.
+	// Patterns are JIT-compiled for complete matches already,
+	// add the partial matching mode used by path prefix checks.
+	(void)pcre2_jit_compile_8(opcre->re, PCRE2_JIT_COMPLETE | PCRE2_JIT_PARTIAL_SOFT);
 #else
 	const char *errptr = NULL;
 	pcre_extra *extra = pcre_study(opcre->re, 0, &errptr);
@@ -184,10 +360,7 @@ void oscap_pcre_optimize(oscap_pcre_t *opcre)
 void oscap_pcre_set_match_limit_recursion(oscap_pcre_t *opcre, unsigned long limit)
 {
 #ifdef HAVE_PCRE2
-	if (opcre->re_ctx == NULL) {
-		opcre->re_ctx = pcre2_match_context_create_8(NULL);
-	}
-	pcre2_set_depth_limit_8(opcre->re_ctx, limit);
+	opcre->depth_limit = limit > UINT32_MAX ? UINT32_MAX : (uint32_t) limit;
 #else
 	if (opcre->re_extra == NULL) {
 		opcre->re_extra = calloc(1, sizeof(struct pcre_extra));
@@ -197,55 +370,283 @@ void oscap_pcre_set_match_limit_recursion(oscap_pcre_t *opcre, unsigned long lim
 #endif
 }
 
-int oscap_pcre_exec(const oscap_pcre_t *opcre, const char *subject,
-                    int length, int startoffset, oscap_pcre_options_t options,
-                    int *ovector, int ovecsize)
+/*
+ * The depth limit is passed to the match instead of being stored in the
+ * object, so that objects shared through the cache are never modified.
+ * Zero means the limit set by oscap_pcre_set_match_limit_recursion().
+ */
+static int _oscap_pcre_exec(const oscap_pcre_t *opcre, const char *subject,
+                            int length, int startoffset, oscap_pcre_options_t options,
+                            int *ovector, int ovecsize, unsigned long depth_limit)
 {
 	int rc = 0;
 #ifdef HAVE_PCRE2
 	// The ovecsize is multiplied by 3 in the code for compatibility with PCRE1
 	int ovecsize2 = ovecsize/3;
-	pcre2_match_data_8 *mdata = pcre2_match_data_create_8(ovecsize2, NULL);
-	dD("pcre2_match_8: subj=%s", subject);
-	rc = pcre2_match_8(opcre->re, (PCRE2_SPTR8)subject, length, startoffset, _oscap_pcre_opts_to_pcre(options), mdata, opcre->re_ctx);
+	// PCRE2 match data holds at least one pair
+	uint32_t pairs = ovecsize2 > 0 ? ovecsize2 : 1;
+	// The match data only has to hold the groups the pattern has, the
+	// vector is checked against the requested size below
+	struct oscap_pcre_thread_state *state = oscap_pcre_get_thread_state(opcre->pairs);
+	if (state == NULL)
+		return OSCAP_PCRE_ERR_UNKNOWN;
+	if (depth_limit == 0)
+		depth_limit = opcre->depth_limit;
+	oscap_pcre_prepare_match(state, depth_limit > UINT32_MAX ? UINT32_MAX : (uint32_t) depth_limit);
+	dD("pcre2_match_8: subj=%.*s", length, subject);
+	rc = pcre2_match_8(opcre->re, (PCRE2_SPTR8)subject, length, startoffset, _oscap_pcre_opts_to_pcre(options), state->mdata, state->mctx);
+	if (rc == PCRE2_ERROR_JIT_STACKLIMIT) {
+		dD("pcre2_match_8: JIT stack exhausted, using the interpreter");
+		rc = pcre2_match_8(opcre->re, (PCRE2_SPTR8)subject, length, startoffset, _oscap_pcre_opts_to_pcre(options) | PCRE2_NO_JIT, state->mdata, state->mctx);
+	}
 	dD("pcre2_match_8: rc=%d, ", rc);
+	// The shared match data can be larger than requested, report
+	// a too small vector the same way a dedicated one would
+	if (rc > (int) pairs)
+		rc = 0;
 	if (rc > PCRE2_ERROR_NOMATCH) {
-		PCRE2_SIZE *ovecp = pcre2_get_ovector_pointer_8(mdata);
-		uint32_t ovecp_count = pcre2_get_ovector_count_8(mdata);
-		dD("pcre2_match_8: pcre2_get_ovector_count_8=%d", ovecp_count);
-		for (int i = 0; i < rc; i++) {
-			if (i < ovecsize2) {
-				ovector[i*2] = ovecp[i*2];
-				ovector[i*2+1] = ovecp[i*2+1];
-			}
+		PCRE2_SIZE *ovecp = pcre2_get_ovector_pointer_8(state->mdata);
+		int count = rc > 0 ? rc : (int) pairs;
+		for (int i = 0; i < count && i < ovecsize2; i++) {
+			ovector[i*2] = ovecp[i*2];
+			ovector[i*2+1] = ovecp[i*2+1];
 		}
 	}
-	pcre2_match_data_free_8(mdata);
 #else
-	dD("pcre_exec: subj=%s", subject);
-	rc = pcre_exec(opcre->re, opcre->re_extra, subject, length, startoffset, _oscap_pcre_opts_to_pcre(options), ovector, ovecsize);
+	struct pcre_extra *extra = opcre->re_extra;
+	struct pcre_extra limited_extra;
+	if (depth_limit != 0) {
+		if (extra != NULL)
+			limited_extra = *extra;
+		else
+			memset(&limited_extra, 0, sizeof(limited_extra));
+		limited_extra.match_limit_recursion = depth_limit;
+		limited_extra.flags |= PCRE_EXTRA_MATCH_LIMIT_RECURSION;
+		extra = &limited_extra;
+	}
+	dD("pcre_exec: subj=%.*s", length, subject);
+	rc = pcre_exec(opcre->re, extra, subject, length, startoffset, _oscap_pcre_opts_to_pcre(options), ovector, ovecsize);
 	dD("pcre_exec: rc=%d, ", rc);
 #endif
 	return rc >= 0 ? rc : _pcre_error_to_oscap_pcre(rc);
 }
 
-void oscap_pcre_free(oscap_pcre_t *opcre)
+int oscap_pcre_exec(const oscap_pcre_t *opcre, const char *subject,
+                    int length, int startoffset, oscap_pcre_options_t options,
+                    int *ovector, int ovecsize)
+{
+	return _oscap_pcre_exec(opcre, subject, length, startoffset, options, ovector, ovecsize, 0);
+}
+
+static void _oscap_pcre_destroy(oscap_pcre_t *opcre)
 {
-	if (opcre != NULL) {
 #ifdef HAVE_PCRE2
-		if (opcre->re_ctx != NULL)
-			pcre2_match_context_free_8(opcre->re_ctx);
-		pcre2_code_free_8(opcre->re);
+	pcre2_code_free_8(opcre->re);
 #else
-		if (opcre->re_extra != NULL)
-			free(opcre->re_extra);
-		pcre_free(opcre->re);
+	if (opcre->re_extra != NULL)
+		free(opcre->re_extra);
+	pcre_free(opcre->re);
 #endif
-		free(opcre);
+	free(opcre);
+}
+
+/*
+ * Process-wide cache of compiled expressions. The entries form a list
+ * ordered from the most to the least recently used one, the index maps
+ * "options:pattern" keys to the entries.
+ */
+struct oscap_pcre_cache_entry {
+	char *key;
+	oscap_pcre_t *opcre;
+	struct oscap_pcre_cache_entry *prev;
+	struct oscap_pcre_cache_entry *next;
+};
+
+static struct oscap_pcre_cache {
+	struct oscap_htable *index;
+	struct oscap_pcre_cache_entry *head;
+	struct oscap_pcre_cache_entry *tail;
+	size_t count;
+	unsigned long hits;
+	unsigned long misses;
+	unsigned long evictions;
+} oscap_pcre_cache;
+
+#ifdef OSCAP_THREAD_SAFE
+static pthread_mutex_t oscap_pcre_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+#define OSCAP_PCRE_CACHE_LOCK() (void)pthread_mutex_lock(&oscap_pcre_cache_lock)
+#define OSCAP_PCRE_CACHE_UNLOCK() (void)pthread_mutex_unlock(&oscap_pcre_cache_lock)
+#else
+#define OSCAP_PCRE_CACHE_LOCK() do {} while (0)
+#define OSCAP_PCRE_CACHE_UNLOCK() do {} while (0)
+#endif
+
+/* Has to be called with the cache lock held */
+static void _oscap_pcre_release(oscap_pcre_t *opcre)
+{
+	if (--opcre->refcount == 0)
+		_oscap_pcre_destroy(opcre);
+}
+
+static void _oscap_pcre_cache_unlink(struct oscap_pcre_cache_entry *entry)
+{
+	if (entry->prev != NULL)
+		entry->prev->next = entry->next;
+	else
+		oscap_pcre_cache.head = entry->next;
+	if (entry->next != NULL)
+		entry->next->prev = entry->prev;
+	else
+		oscap_pcre_cache.tail = entry->prev;
+	entry->prev = entry->next = NULL;
+}
+
+static void _oscap_pcre_cache_push(struct oscap_pcre_cache_entry *entry)
+{
+	entry->prev = NULL;
+	entry->next = oscap_pcre_cache.head;
+	if (oscap_pcre_cache.head != NULL)
+		oscap_pcre_cache.head->prev = entry;
+	oscap_pcre_cache.head = entry;
+	if (oscap_pcre_cache.tail == NULL)
+		oscap_pcre_cache.tail = entry;
+}
+
+static void _oscap_pcre_cache_drop(struct oscap_pcre_cache_entry *entry)
+{
+	_oscap_pcre_cache_unlink(entry);
+	oscap_htable_detach(oscap_pcre_cache.index, entry->key);
+	oscap_pcre_cache.count--;
+	_oscap_pcre_release(entry->opcre);
+	free(entry->key);
+	free(entry);
+}
+
+static void oscap_pcre_cache_free(void)
+{
+	OSCAP_PCRE_CACHE_LOCK();
+	while (oscap_pcre_cache.head != NULL)
+		_oscap_pcre_cache_drop(oscap_pcre_cache.head);
+	oscap_htable_free0(oscap_pcre_cache.index);
+	oscap_pcre_cache.index = NULL;
+	OSCAP_PCRE_CACHE_UNLOCK();
+}
+
+oscap_pcre_t *oscap_pcre_compile_cached(const char *pattern, oscap_pcre_options_t options,
+                                        char **errptr, int *erroffset)
+{
+	char *key = oscap_sprintf("%x:%s", (unsigned int) options, pattern);
+
+	OSCAP_PCRE_CACHE_LOCK();
+	if (oscap_pcre_cache.index == NULL) {
+		oscap_pcre_cache.index = oscap_htable_new();
+		oscap_htable_reserve(oscap_pcre_cache.index, OSCAP_PCRE_CACHE_SIZE + 1);
+		atexit(oscap_pcre_cache_free);
+	}
+	struct oscap_pcre_cache_entry *entry = oscap_htable_get(oscap_pcre_cache.index, key);
+	if (entry != NULL) {
+		oscap_pcre_cache.hits++;
+		if (entry != oscap_pcre_cache.head) {
+			_oscap_pcre_cache_unlink(entry);
+			_oscap_pcre_cache_push(entry);
+		}
+		entry->opcre->refcount++;
+		oscap_pcre_t *res = entry->opcre;
+		OSCAP_PCRE_CACHE_UNLOCK();
+		free(key);
+		return res;
+	}
+	oscap_pcre_cache.misses++;
+	OSCAP_PCRE_CACHE_UNLOCK();
+
+	/* Compile outside of the lock, failures aren't cached */
+	oscap_pcre_t *res = oscap_pcre_compile(pattern, options, errptr, erroffset);
+	if (res == NULL) {
+		free(key);
+		return NULL;
+	}
+	res->cached = true;
+
+	OSCAP_PCRE_CACHE_LOCK();
+	entry = oscap_htable_get(oscap_pcre_cache.index, key);
+	if (entry != NULL) {
+		/* Another thread has been faster, use its object */
+		entry->opcre->refcount++;
+		oscap_pcre_t *winner = entry->opcre;
+		OSCAP_PCRE_CACHE_UNLOCK();
+		free(key);
+		_oscap_pcre_destroy(res);
+		return winner;
 	}
+	entry = malloc(sizeof(struct oscap_pcre_cache_entry));
+	entry->key = key;
+	entry->opcre = res;
+	res->refcount++;
+	oscap_htable_add(oscap_pcre_cache.index, key, entry);
+	_oscap_pcre_cache_push(entry);
+	if (++oscap_pcre_cache.count > OSCAP_PCRE_CACHE_SIZE) {
+		_oscap_pcre_cache_drop(oscap_pcre_cache.tail);
+		oscap_pcre_cache.evictions++;
+	}
+	OSCAP_PCRE_CACHE_UNLOCK();
+	return res;
+}
+
+void oscap_pcre_cache_log_stats(void)
+{
+	OSCAP_PCRE_CACHE_LOCK();
+	dI("Regex cache: %lu hits, %lu misses, %lu evictions, %zu of %d entries used.",
+	   oscap_pcre_cache.hits, oscap_pcre_cache.misses, oscap_pcre_cache.evictions,
+	   oscap_pcre_cache.count, OSCAP_PCRE_CACHE_SIZE);
+	OSCAP_PCRE_CACHE_UNLOCK();
+}
+
+void oscap_pcre_free(oscap_pcre_t *opcre)
+{
+	if (opcre == NULL)
+		return;
+	if (opcre->cached) {
+		OSCAP_PCRE_CACHE_LOCK();
+		_oscap_pcre_release(opcre);
+		OSCAP_PCRE_CACHE_UNLOCK();
+	} else {
+		_oscap_pcre_destroy(opcre);
+	}
+}
+
+static unsigned long oscap_pcre_recursion_limit = OSCAP_PCRE_EXEC_RECURSION_LIMIT_DEFAULT;
+#ifdef OSCAP_THREAD_SAFE
+static pthread_once_t __limit_once = PTHREAD_ONCE_INIT;
+#else
+static bool __limit_initialized = false;
+#endif
+
+static void oscap_pcre_recursion_limit_init(void)
+{
+	char *limit_str = getenv("OSCAP_PCRE_EXEC_RECURSION_LIMIT");
+	if (limit_str != NULL)
+		if (sscanf(limit_str, "%lu", &oscap_pcre_recursion_limit) <= 0)
+			dW("Unable to parse OSCAP_PCRE_EXEC_RECURSION_LIMIT value");
+}
+
+static unsigned long oscap_pcre_get_recursion_limit(void)
+{
+#ifdef OSCAP_THREAD_SAFE
+	(void)pthread_once(&__limit_once, oscap_pcre_recursion_limit_init);
+#else
+	if (!__limit_initialized) {
+		oscap_pcre_recursion_limit_init();
+		__limit_initialized = true;
+	}
+#endif
+	return oscap_pcre_recursion_limit;
 }
 
 int oscap_pcre_get_substrings(char *str, int *ofs, oscap_pcre_t *re, int want_substrs, char ***substrings) {
+	return oscap_pcre_get_substrings_len(str, strlen(str), ofs, re, want_substrs, substrings);
+}
+
+int oscap_pcre_get_substrings_len(const char *str, size_t str_len, int *ofs, oscap_pcre_t *re, int want_substrs, char ***substrings) {
 	int i, ret, rc;
 	int ovector[60], ovector_len = sizeof (ovector) / sizeof (ovector[0]);
 	char **substrs;
@@ -256,22 +657,15 @@ int oscap_pcre_get_substrings(char *str, int *ofs, oscap_pcre_t *re, int want_su
 		ovector[i] = -1;
 	}
 
-	unsigned long limit = OSCAP_PCRE_EXEC_RECURSION_LIMIT_DEFAULT;
-	char *limit_str = getenv("OSCAP_PCRE_EXEC_RECURSION_LIMIT");
-	if (limit_str != NULL)
-		if (sscanf(limit_str, "%lu", &limit) <= 0)
-			dW("Unable to parse OSCAP_PCRE_EXEC_RECURSION_LIMIT value");
-	oscap_pcre_set_match_limit_recursion(re, limit);
-	size_t str_len = strlen(str);
 #if defined(OS_SOLARIS)
-	rc = oscap_pcre_exec(re, str, str_len, *ofs, OSCAP_PCRE_OPTS_NO_UTF8_CHECK, ovector, ovector_len);
+	rc = _oscap_pcre_exec(re, str, str_len, *ofs, OSCAP_PCRE_OPTS_NO_UTF8_CHECK, ovector, ovector_len, oscap_pcre_get_recursion_limit());
 #else
-	rc = oscap_pcre_exec(re, str, str_len, *ofs, 0, ovector, ovector_len);
+	rc = _oscap_pcre_exec(re, str, str_len, *ofs, 0, ovector, ovector_len, oscap_pcre_get_recursion_limit());
 #endif
 
 	if (rc < OSCAP_PCRE_ERR_NOMATCH) {
 		if (str_len < 100)
-			dE("Function oscap_pcre_exec() failed to match a regular expression with return code %d on string '%s'.", rc, str);
+			dE("Function oscap_pcre_exec() failed to match a regular expression with return code %d on string '%.*s'.", rc, (int) str_len, str);
 		else
 			dE("Function oscap_pcre_exec() failed to match a regular expression with return code %d on string '%.100s' (truncated, showing first 100 characters).", rc, str);
 		return rc;
@@ -23,6 +23,8 @@
 #ifndef OSCAP_PCRE_
 #define OSCAP_PCRE_
 
+#include <stddef.h>
+
 typedef struct oscap_pcre oscap_pcre_t;
 
 typedef enum {
@@ -47,6 +49,7 @@ typedef enum {
 
 /**
  * Compile a regular expression string into PCRE object and returns it.
+ * With PCRE2 the pattern is also JIT-compiled if the library supports it.
  * Caller is responsible for freeing the returned object or the error message
  * if the result is NULL (USE oscap_pcre_err_free()!).
  * @param pattern expresstion string
@@ -59,9 +62,33 @@ typedef enum {
 oscap_pcre_t* oscap_pcre_compile(const char *pattern, oscap_pcre_options_t options,
                                  char **errptr, int *erroffset);
 
+/**
+ * Return a compiled regular expression from the process-wide cache, compiling
+ * and caching it first if needed. The cache is keyed by the pattern and the
+ * options and keeps the most recently used expressions only. The returned
+ * object is shared: it must not be modified (oscap_pcre_set_match_limit_recursion,
+ * oscap_pcre_optimize) and it is released by oscap_pcre_free() as usual.
+ * Pass OSCAP_PCRE_OPTS_PARTIAL to get an object prepared for partial matching.
+ * Compilation errors are reported the same way as by oscap_pcre_compile().
+ * @param pattern expresstion string
+ * @param options compile options
+ * @param errptr a return value for a string representation of error
+ * @param erroffset the offset in the expression where the problem was detected
+ * @return a PCRE object
+ * NULL on failure
+ */
+oscap_pcre_t *oscap_pcre_compile_cached(const char *pattern, oscap_pcre_options_t options,
+                                        char **errptr, int *erroffset);
+
+/**
+ * Write the regular expression cache hit and miss counters to the debug log.
+ */
+void oscap_pcre_cache_log_stats(void);
+
 /**
  * Execute the compiled regular expression against a string subject and returns
- * matches count (or a negative error code).
+ * matches count (or a negative error code). The match data and the JIT stack
+ * are cached per thread, so the compiled object can be shared by threads.
  * @param opcre the oscap_pcre_t object
  * @param subject target string
  * @param length target string length
@@ -77,7 +104,8 @@ int oscap_pcre_exec(const oscap_pcre_t *opcre, const char *subject,
                     int *ovector, int ovecsize);
 
 /**
- * Free the compiled regular expression object.
+ * Free the compiled regular expression object. Objects returned by
+ * oscap_pcre_compile_cached() are only released, the cache frees them.
  * @param opcre the oscap_pcre_t object
  */
 void oscap_pcre_free(oscap_pcre_t *opcre);
@@ -92,6 +120,8 @@ void oscap_pcre_set_match_limit_recursion(oscap_pcre_t *opcre, unsigned long lim
 
 /**
  * Optimize the compiled regular expression object to increase matching speed.
+ * With PCRE2 this adds JIT support for partial matching. Objects compiled
+ * with OSCAP_PCRE_OPTS_PARTIAL are optimized already.
  * @param opcre the oscap_pcre_t object
  */
 void oscap_pcre_optimize(oscap_pcre_t *opcre);
@@ -109,6 +139,20 @@ void oscap_pcre_optimize(oscap_pcre_t *opcre);
  */
 int oscap_pcre_get_substrings(char *str, int *ofs, oscap_pcre_t *re, int want_substrs, char ***substrings);
 
+/**
+ * Same as oscap_pcre_get_substrings(), but the subject doesn't have to be
+ * NUL-terminated, e.g. it can be a memory-mapped file.
+ * @param str subject string
+ * @param str_len length of the subject, at most INT_MAX
+ * @param ofs starting offset in str
+ * @param re compiled regular expression
+ * @param want_substrs if non-zero, substrings will be returned
+ * @param substrings contains returned substrings
+ * @return count of matched substrings, 0 if no match
+ * negative value on failure
+ */
+int oscap_pcre_get_substrings_len(const char *str, size_t str_len, int *ofs, oscap_pcre_t *re, int want_substrs, char ***substrings);
+
 /**
  * Free the error message returned by oscap_pcre_compile. DON'T USE REGULAR free()!
  * @param err the message
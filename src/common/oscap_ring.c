@@ -0,0 +1,174 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdlib.h>
+#include "oscap_ring.h"
+
+#ifdef HAVE_SYS_EVENTFD_H
+
+#include <errno.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+/* Number of polls before a waiting side goes to sleep */
+#define OSCAP_RING_SPIN 256
+
+/*
+ * One end of the ring. pos is only written by the owning side, waiting is
+ * set by the owning side before it sleeps on efd, which is then signalled by
+ * the other side. Both ends live on separate cache lines.
+ */
+struct oscap_ring_end {
+	uint32_t pos;
+	uint32_t waiting;
+	int efd;
+} __attribute__((aligned(64)));
+
+struct oscap_ring {
+	struct oscap_ring_end head; /* consumer */
+	struct oscap_ring_end tail; /* producer */
+	uint32_t mask;
+	void **slots;
+};
+
+struct oscap_ring *oscap_ring_new(size_t capacity)
+{
+	uint32_t size = 2;
+	while (size < capacity && size < (1U << 30))
+		size <<= 1;
+
+	struct oscap_ring *ring;
+	if (posix_memalign((void **) &ring, 64, sizeof(struct oscap_ring)) != 0)
+		return NULL;
+	ring->head.pos = ring->tail.pos = 0;
+	ring->head.waiting = ring->tail.waiting = 0;
+	ring->head.efd = eventfd(0, EFD_CLOEXEC);
+	ring->tail.efd = eventfd(0, EFD_CLOEXEC);
+	ring->mask = size - 1;
+	ring->slots = malloc(size * sizeof(void *));
+	if (ring->head.efd < 0 || ring->tail.efd < 0 || ring->slots == NULL) {
+		oscap_ring_free(ring, NULL);
+		return NULL;
+	}
+	return ring;
+}
+
+/*
+ * Wait until the position of the other end moves away from seen. The store
+ * of the waiting flag and the load of the position are sequentially
+ * consistent, as are the position store and the flag load in
+ * _oscap_ring_wake(), so at least one side sees the other one and the wakeup
+ * can't get lost.
+ */
+static void _oscap_ring_wait(struct oscap_ring_end *self, const uint32_t *other_pos, uint32_t seen)
+{
+	for (int i = 0; i < OSCAP_RING_SPIN; ++i) {
+		if (__atomic_load_n(other_pos, __ATOMIC_ACQUIRE) != seen)
+			return;
+	}
+
+	__atomic_store_n(&self->waiting, 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(other_pos, __ATOMIC_SEQ_CST) == seen) {
+		uint64_t cnt;
+		/* read(2) is a cancellation point, just like pthread_cond_wait() */
+		while (read(self->efd, &cnt, sizeof(cnt)) < 0 && errno == EINTR)
+			;
+	}
+	__atomic_store_n(&self->waiting, 0, __ATOMIC_RELAXED);
+}
+
+static void _oscap_ring_wake(struct oscap_ring_end *other)
+{
+	if (__atomic_load_n(&other->waiting, __ATOMIC_SEQ_CST)) {
+		uint64_t one = 1;
+		while (write(other->efd, &one, sizeof(one)) < 0 && errno == EINTR)
+			;
+	}
+}
+
+void oscap_ring_push(struct oscap_ring *ring, void *data)
+{
+	uint32_t tail = __atomic_load_n(&ring->tail.pos, __ATOMIC_RELAXED);
+	uint32_t head;
+
+	/* The ring is full when the consumer is a whole lap behind. */
+	while (tail - (head = __atomic_load_n(&ring->head.pos, __ATOMIC_ACQUIRE)) > ring->mask)
+		_oscap_ring_wait(&ring->tail, &ring->head.pos, head);
+
+	ring->slots[tail & ring->mask] = data;
+	__atomic_store_n(&ring->tail.pos, tail + 1, __ATOMIC_SEQ_CST);
+	_oscap_ring_wake(&ring->head);
+}
+
+void *oscap_ring_pop(struct oscap_ring *ring)
+{
+	uint32_t head = __atomic_load_n(&ring->head.pos, __ATOMIC_RELAXED);
+
+	while (__atomic_load_n(&ring->tail.pos, __ATOMIC_ACQUIRE) == head)
+		_oscap_ring_wait(&ring->head, &ring->tail.pos, head);
+
+	void *data = ring->slots[head & ring->mask];
+	__atomic_store_n(&ring->head.pos, head + 1, __ATOMIC_SEQ_CST);
+	_oscap_ring_wake(&ring->tail);
+	return data;
+}
+
+void oscap_ring_free(struct oscap_ring *ring, oscap_destruct_func destructor)
+{
+	if (ring == NULL)
+		return;
+	if (ring->slots != NULL && destructor != NULL) {
+		for (uint32_t i = ring->head.pos; i != ring->tail.pos; ++i)
+			destructor(ring->slots[i & ring->mask]);
+	}
+	if (ring->head.efd >= 0)
+		close(ring->head.efd);
+	if (ring->tail.efd >= 0)
+		close(ring->tail.efd);
+	free(ring->slots);
+	free(ring);
+}
+
+#else
+
+struct oscap_ring *oscap_ring_new(size_t capacity)
+{
+	return NULL;
+}
+
+void oscap_ring_push(struct oscap_ring *ring, void *data)
+{
+	abort();
+}
+
+void *oscap_ring_pop(struct oscap_ring *ring)
+{
+	abort();
+}
+
+void oscap_ring_free(struct oscap_ring *ring, oscap_destruct_func destructor)
+{
+}
+
+#endif
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef OSCAP_RING_H
+#define OSCAP_RING_H
+
+#include <stddef.h>
+#include "util.h"
+
+/*
+ * Bounded single-producer/single-consumer ring of pointers. Pushing and
+ * popping doesn't take any lock. A side which has to wait spins for a while
+ * and then sleeps until the other side signals it, the signal is only sent
+ * when somebody is actually waiting. Multiple producers (or consumers) are
+ * fine as long as they serialize among themselves.
+ */
+struct oscap_ring;
+
+/*
+ * Create a ring holding at least capacity items. Returns NULL if the ring
+ * isn't supported on this platform or it can't be set up, callers are
+ * expected to fall back to oscap_queue.
+ */
+struct oscap_ring *oscap_ring_new(size_t capacity);
+
+/*
+ * Append an item, waiting while the ring is full
+ */
+void oscap_ring_push(struct oscap_ring *ring, void *data);
+
+/*
+ * Remove the oldest item, waiting while the ring is empty. The wait is
+ * a cancellation point.
+ */
+void *oscap_ring_pop(struct oscap_ring *ring);
+
+/*
+ * Dispose the ring and the items left in it
+ */
+void oscap_ring_free(struct oscap_ring *ring, oscap_destruct_func destructor);
+
+#endif //OSCAP_RING_H
@@ -45,6 +45,7 @@
 #include <windows.h>
 #else
 #include <libgen.h>
+#include <unistd.h>
 #include <strings.h>
 #endif
 
@@ -474,3 +475,12 @@ bool oscap_path_startswith(const char *path, const char *prefix)
 	free(prefix_split);
 	return res;
 }
+
+bool oscap_stat_is_private(const struct stat *st)
+{
+#ifdef OS_WINDOWS
+	return true;
+#else
+	return st->st_uid == geteuid() && (st->st_mode & (S_IWGRP | S_IWOTH)) == 0;
+#endif
+}
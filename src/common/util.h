@@ -548,4 +548,15 @@ int oscap_open_writable(const char *filename);
  */
 bool oscap_path_startswith(const char *path, const char *prefix);
 
+struct stat;
+/**
+ * Check that a file which is trusted by oscap without further checks, e.g.
+ * an entry of a cache, can be modified only by the current user. The file
+ * has to be owned by the effective user and it mustn't be writable by the
+ * group or others.
+ * @param st status of the file
+ * @return true if the file is private to the user
+ */
+bool oscap_stat_is_private(const struct stat *st);
+
 #endif              /* OSCAP_UTIL_H_ */
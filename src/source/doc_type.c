@@ -31,22 +31,11 @@
 #include "common/public/oscap.h"
 #include "doc_type_priv.h"
 
-int oscap_determine_document_type_reader(xmlTextReader *reader, oscap_document_type_t *doc_type)
+int oscap_determine_document_type_name(const char *elm_name, oscap_document_type_t *doc_type)
 {
-        const char* elm_name = NULL;
         *doc_type = 0;
 
-        /* find root element */
-        while (xmlTextReaderRead(reader) == 1
-               && xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT);
-
-        /* identify document type */
-        elm_name = (const char *) xmlTextReaderConstLocalName(reader);
-        if (!elm_name) {
-                oscap_setxmlerr(xmlGetLastError());
-                return -1;
-        }
-        else if (!strcmp("oval_definitions", elm_name)) {
+        if (!strcmp("oval_definitions", elm_name)) {
                 *doc_type = OSCAP_DOCUMENT_OVAL_DEFINITIONS;
         }
         else if (!strcmp("oval_directives", elm_name)) {
@@ -97,3 +86,21 @@ int oscap_determine_document_type_reader(xmlTextReader *reader, oscap_document_t
 
         return 0;
 }
+
+int oscap_determine_document_type_reader(xmlTextReader *reader, oscap_document_type_t *doc_type)
+{
+        const char* elm_name = NULL;
+        *doc_type = 0;
+
+        /* find root element */
+        while (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT
+               && xmlTextReaderRead(reader) == 1);
+
+        /* identify document type */
+        elm_name = (const char *) xmlTextReaderConstLocalName(reader);
+        if (!elm_name) {
+                oscap_setxmlerr(xmlGetLastError());
+                return -1;
+        }
+        return oscap_determine_document_type_name(elm_name, doc_type);
+}
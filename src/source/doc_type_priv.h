@@ -40,4 +40,12 @@
  */
 int oscap_determine_document_type_reader(xmlTextReader *reader, oscap_document_type_t *doc_type);
 
+/**
+ * Determines the SCAP type of a document from the local name of its root element.
+ * @param elm_name local name of the root element
+ * @param doc_type determined document type (output parameter)
+ * @returns -1 if the name isn't known, 0 otherwise
+ */
+int oscap_determine_document_type_name(const char *elm_name, oscap_document_type_t *doc_type);
+
 #endif
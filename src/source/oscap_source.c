@@ -26,6 +26,10 @@
 
 #include <string.h>
 #include <fcntl.h>
+#include <sys/stat.h>
+#ifdef HAVE_MMAN_H
+#include <sys/mman.h>
+#endif
 #ifdef OS_WINDOWS
 #include <io.h>
 #else
@@ -46,6 +50,8 @@
 #include "doc_type_priv.h"
 #include "oscap_source.h"
 #include "common/oscap_string.h"
+#include "common/oscap_content_cache.h"
+#include "oscap_helpers.h"
 #include "oscap_source_priv.h"
 #include "OVAL/oval_parser_impl.h"
 #include "OVAL/public/oval_definitions.h"
@@ -71,10 +77,22 @@ struct oscap_source {
 		char *filepath;                         ///< Filepath (if originated from file)
 		char *memory;                           ///< Memory buffer (if originated from memory)
 		size_t memory_size;                     ///< Size of the memory buffer (if originated from memory)
+		bool bzip_known;                        ///< Whether the bzip2 check of the file has been done
+		bool bzip;                              ///< Whether the file is bzip2 compressed (if bzip_known)
 	} origin;                                       ///
 	struct {
 		xmlDoc *doc;                            /// DOM
 	} xml;
+	struct {
+		xmlDoc *(*load)(void *arg);             ///< Builds the DOM on demand, if set
+		void *arg;
+		void (*arg_free)(void *arg);
+	} deferred;
+	struct {
+		bool known;
+		uint8_t value[OSCAP_CONTENT_CACHE_DIGEST_SIZE]; ///< Digest of the document, see oscap_source_get_digest()
+	} digest;
+	unsigned int cache_err_count;                   ///< oscap_err_count() before the document was parsed
 };
 
 struct oscap_source *oscap_source_new_from_file(const char *filepath)
@@ -97,7 +115,12 @@ struct oscap_source *oscap_source_clone(struct oscap_source *old)
 	new->origin.filepath = oscap_strdup(old->origin.filepath);
 	new->origin.memory = oscap_strdup(old->origin.memory);
 	new->origin.memory_size = old->origin.memory_size;
-	new->xml.doc = xmlCopyDoc(old->xml.doc, true);
+	new->origin.bzip_known = old->origin.bzip_known;
+	new->origin.bzip = old->origin.bzip;
+	// The clone doesn't share the loader of a deferred source, it gets the DOM
+	xmlDoc *doc = old->deferred.load != NULL ? oscap_source_get_xmlDoc(old) : old->xml.doc;
+	new->xml.doc = xmlCopyDoc(doc, true);
+	new->digest = old->digest;
 	return new;
 }
 
@@ -140,6 +163,21 @@ struct oscap_source *oscap_source_new_from_xmlDoc(xmlDoc *doc, const char *filep
 	return source;
 }
 
+struct oscap_source *oscap_source_new_deferred(const char *filepath, oscap_document_type_t scap_type,
+		const uint8_t digest[OSCAP_CONTENT_CACHE_DIGEST_SIZE], xmlDoc *(*load)(void *arg), void *arg, void (*arg_free)(void *arg))
+{
+	struct oscap_source *source = (struct oscap_source *) calloc(1, sizeof(struct oscap_source));
+	source->scap_type = scap_type;
+	source->origin.type = OSCAP_SRC_FROM_XML_DOM;
+	source->origin.filepath = oscap_strdup(filepath ? filepath : "NONEXISTENT");
+	source->deferred.load = load;
+	source->deferred.arg = arg;
+	source->deferred.arg_free = arg_free;
+	source->digest.known = true;
+	memcpy(source->digest.value, digest, sizeof(source->digest.value));
+	return source;
+}
+
 void oscap_source_free(struct oscap_source *source)
 {
 	if (source != NULL) {
@@ -149,6 +187,9 @@ void oscap_source_free(struct oscap_source *source)
 			xmlFreeDoc(source->xml.doc);
 		}
 		free(source->origin.version);
+		if (source->deferred.arg_free != NULL) {
+			source->deferred.arg_free(source->deferred.arg);
+		}
 		free(source);
 	}
 }
@@ -187,10 +228,64 @@ xmlTextReader *oscap_source_get_xmlTextReader(struct oscap_source *source)
 	return reader;
 }
 
+const char *oscap_source_get_unparsed_filepath(struct oscap_source *source)
+{
+	if (source->origin.type != OSCAP_SRC_FROM_USER_XML_FILE || source->xml.doc != NULL) {
+		return NULL;
+	}
+	if (!source->origin.bzip_known) {
+		int fd = open(source->origin.filepath, O_RDONLY);
+		if (fd == -1) {
+			return NULL;
+		}
+		source->origin.bzip = bz2_fd_is_bzip(fd);
+		source->origin.bzip_known = true;
+		close(fd);
+	}
+	return source->origin.bzip ? NULL : source->origin.filepath;
+}
+
+static void _ignore_xml_error(void *user, xmlErrorPtr error)
+{
+}
+
+/**
+ * Get an xmlTextReader streaming the file this resource originates from,
+ * which allows to look at the beginning of the document without building
+ * the DOM. The reader is returned positioned on the root element. Returns
+ * NULL if the DOM is built already or if the document doesn't start with
+ * an element, in which case the DOM reports the error.
+ */
+static xmlTextReader *_oscap_source_get_stream_reader(struct oscap_source *source)
+{
+	const char *filepath = oscap_source_get_unparsed_filepath(source);
+	if (filepath == NULL) {
+		return NULL;
+	}
+
+	xmlTextReader *reader = xmlReaderForFile(filepath, NULL, 0);
+	if (reader == NULL) {
+		return NULL;
+	}
+	xmlTextReaderSetStructuredErrorHandler(reader, _ignore_xml_error, NULL);
+	int ret;
+	while ((ret = xmlTextReaderRead(reader)) == 1 && xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT)
+		;
+	if (ret != 1) {
+		xmlFreeTextReader(reader);
+		return NULL;
+	}
+	return reader;
+}
+
 oscap_document_type_t oscap_source_get_scap_type(struct oscap_source *source)
 {
 	if (source->scap_type == OSCAP_DOCUMENT_UNKNOWN) {
-		xmlTextReader *reader = oscap_source_get_xmlTextReader(source);
+		// The type is given by the root element, no need to build the DOM
+		xmlTextReader *reader = _oscap_source_get_stream_reader(source);
+		if (reader == NULL) {
+			reader = oscap_source_get_xmlTextReader(source);
+		}
 		if (reader == NULL) {
 			// the oscap error is already set
 			return OSCAP_DOCUMENT_UNKNOWN;
@@ -210,6 +305,83 @@ const char *oscap_source_get_filepath(struct oscap_source *source)
 	return source->origin.filepath;
 }
 
+bool oscap_source_get_digest(struct oscap_source *source, uint8_t digest[OSCAP_CONTENT_CACHE_DIGEST_SIZE])
+{
+	if (!source->digest.known) {
+		if (source->origin.memory != NULL) {
+			oscap_content_cache_digest(source->origin.memory, source->origin.memory_size, source->digest.value);
+			source->digest.known = true;
+		}
+#ifdef HAVE_MMAN_H
+		else if (source->origin.type == OSCAP_SRC_FROM_USER_XML_FILE) {
+			struct stat st;
+			int fd = open(source->origin.filepath, O_RDONLY);
+			if (fd == -1) {
+				return false;
+			}
+			if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+				void *data = st.st_size > 0 ? mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) : NULL;
+				if (data != MAP_FAILED) {
+					oscap_content_cache_digest(data, st.st_size, source->digest.value);
+					source->digest.known = true;
+					if (data != NULL) {
+						munmap(data, st.st_size);
+					}
+				}
+			}
+			close(fd);
+		}
+#endif
+	}
+	if (source->digest.known) {
+		memcpy(digest, source->digest.value, sizeof(source->digest.value));
+	}
+	return source->digest.known;
+}
+
+void *oscap_source_cache_load(struct oscap_source *source, oscap_content_cache_kind_t kind,
+		oscap_content_cache_read_func read, oscap_destruct_func free_model)
+{
+	uint8_t key[OSCAP_CONTENT_CACHE_DIGEST_SIZE];
+	source->cache_err_count = oscap_err_count();
+	if (oscap_content_cache_dir() == NULL || !oscap_source_get_digest(source, key)) {
+		return NULL;
+	}
+	struct oscap_content_cache_entry *entry = oscap_content_cache_open(kind, key);
+	if (entry == NULL) {
+		return NULL;
+	}
+	struct oscap_cache_reader reader;
+	oscap_cache_reader_init(&reader, entry);
+	void *model = read(&reader);
+	if (model != NULL && reader.p != reader.end) {
+		/* The payload is ours only if the reader consumed it exactly */
+		free_model(model);
+		model = NULL;
+	}
+	oscap_content_cache_close(entry);
+	if (model == NULL) {
+		dW("Malformed content cache entry of '%s', parsing the document.", oscap_source_readable_origin(source));
+	}
+	return model;
+}
+
+void oscap_source_cache_store(struct oscap_source *source, oscap_content_cache_kind_t kind,
+		oscap_content_cache_write_func write, const void *model)
+{
+	uint8_t key[OSCAP_CONTENT_CACHE_DIGEST_SIZE];
+	if (model == NULL || oscap_content_cache_dir() == NULL || !oscap_source_get_digest(source, key)) {
+		return;
+	}
+	if (oscap_err_count() != source->cache_err_count) {
+		return;
+	}
+	struct oscap_buffer *payload = oscap_buffer_new();
+	write(payload, model);
+	oscap_content_cache_store(kind, key, payload);
+	oscap_buffer_free(payload);
+}
+
 static void xmlErrorCb(struct oscap_string *buffer, const char * format, ...)
 {
 	va_list ap;
@@ -267,7 +439,10 @@ xmlDoc *oscap_source_get_xmlDoc(struct oscap_source *source)
 	struct oscap_string *xml_error_string = oscap_string_new();
 	xmlSetGenericErrorFunc(xml_error_string, (xmlGenericErrorFunc)xmlErrorCb);
 
-	if (source->xml.doc == NULL) {
+	if (source->xml.doc == NULL && source->deferred.load != NULL) {
+		source->xml.doc = source->deferred.load(source->deferred.arg);
+	}
+	else if (source->xml.doc == NULL) {
 		if (source->origin.memory != NULL) {
 			if (bz2_memory_is_bzip(source->origin.memory, source->origin.memory_size)) {
 #ifdef BZIP2_FOUND
@@ -396,7 +571,10 @@ int oscap_source_validate_schematron(struct oscap_source *source, const char *ou
 const char *oscap_source_get_schema_version(struct oscap_source *source)
 {
 	if (source->origin.version == NULL) {
-		xmlTextReader *reader = oscap_source_get_xmlTextReader(source);
+		xmlTextReader *reader = _oscap_source_get_stream_reader(source);
+		if (reader == NULL) {
+			reader = oscap_source_get_xmlTextReader(source);
+		}
 		if (reader == NULL) {
 			return NULL;
 		}
@@ -26,9 +26,12 @@
 #include <config.h>
 #endif
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <libxml/parser.h>
 #include <libxml/xmlreader.h>
 
+#include "common/oscap_content_cache.h"
 #include "common/util.h"
 #include "oscap.h"
 #include "oscap_source.h"
@@ -58,6 +61,61 @@ struct oscap_source *oscap_source_new_take_memory(char *buffer, size_t size, con
  */
 struct oscap_source *oscap_source_new_from_xmlDoc(xmlDoc *doc, const char *filepath);
 
+/**
+ * Build new oscap_source whose DOM is built by the load callback when it's
+ * needed first. The type of the document has to be known in advance and the
+ * digest identifies the document for the content cache, so that models can be
+ * imported from the cache without building the DOM at all.
+ * @memberof oscap_source
+ * @param filepath Suggested filename for the file or NULL
+ * @param scap_type Type of the document
+ * @param digest Digest of the document, see oscap_source_get_digest()
+ * @param load Callback building the DOM, it sets the oscap error on failure
+ * @param arg Argument of the callback, owned by oscap_source
+ * @param arg_free Destructor of the argument
+ * @returns newly created oscap_source
+ */
+struct oscap_source *oscap_source_new_deferred(const char *filepath, oscap_document_type_t scap_type,
+		const uint8_t digest[OSCAP_CONTENT_CACHE_DIGEST_SIZE], xmlDoc *(*load)(void *arg), void *arg, void (*arg_free)(void *arg));
+
+/**
+ * Get the digest of the document this resource represents, which is used as
+ * the key of the content cache. The digest is known for resources originating
+ * from files and memory and for deferred ones.
+ * @memberof oscap_source
+ * @param source Resource
+ * @param digest the digest (output parameter)
+ * @returns true if the digest is known
+ */
+bool oscap_source_get_digest(struct oscap_source *source, uint8_t digest[OSCAP_CONTENT_CACHE_DIGEST_SIZE]);
+
+/**
+ * Rebuild a model of the document from the content cache.
+ * @memberof oscap_source
+ * @param source Resource
+ * @param kind Kind of the model
+ * @param read Function reading the model from the cache entry
+ * @param free_model Destructor of the model, for entries with trailing data
+ * @returns the model or NULL if the cache isn't used or it doesn't hold
+ * a usable entry for this document
+ */
+void *oscap_source_cache_load(struct oscap_source *source, oscap_content_cache_kind_t kind,
+		oscap_content_cache_read_func read, oscap_destruct_func free_model);
+
+/**
+ * Store a model imported from this resource in the content cache, so that
+ * oscap_source_cache_load() finds it next time. Does nothing if the cache
+ * isn't used or if any error was raised since oscap_source_cache_load() was
+ * called, as the errors wouldn't be reported when loading from the cache.
+ * @memberof oscap_source
+ * @param source Resource
+ * @param kind Kind of the model
+ * @param write Function serializing the model
+ * @param model The model
+ */
+void oscap_source_cache_store(struct oscap_source *source, oscap_content_cache_kind_t kind,
+		oscap_content_cache_write_func write, const void *model);
+
 /**
  * Get an xmlTextReader assigned with this resource. The reader needs to be
  * disposed by caller.
@@ -67,6 +125,16 @@ struct oscap_source *oscap_source_new_from_xmlDoc(xmlDoc *doc, const char *filep
  */
 xmlTextReader *oscap_source_get_xmlTextReader(struct oscap_source *source);
 
+/**
+ * Get the path of the file this resource originates from, as long as its DOM
+ * representation hasn't been built and the file isn't compressed. The file
+ * can then be parsed in a more efficient way than by building its DOM.
+ * @memberof oscap_source
+ * @param source Resource
+ * @returns path of the file or NULL
+ */
+const char *oscap_source_get_unparsed_filepath(struct oscap_source *source);
+
 /**
  * Get a DOM representation of this resource. The document ins still owned
  * by oscap_source.
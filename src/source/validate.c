@@ -127,11 +127,17 @@ static inline int oscap_validate_xml(struct oscap_source *source, const char *sc
 
 	xmlSchemaSetValidStructuredErrors(ctxt, (xmlStructuredErrorFunc) oscap_xml_validity_handler, &context);
 
-	doc = oscap_source_get_xmlDoc(source);
-	if (!doc)
-		goto cleanup;
-
-	result = xmlSchemaValidateDoc(ctxt, doc);
+	const char *filepath = oscap_source_get_unparsed_filepath(source);
+	if (filepath != NULL) {
+		/* Validate while parsing the file, the DOM isn't needed */
+		result = xmlSchemaValidateFile(ctxt, filepath, 0);
+	} else {
+		doc = oscap_source_get_xmlDoc(source);
+		if (!doc)
+			goto cleanup;
+
+		result = xmlSchemaValidateDoc(ctxt, doc);
+	}
 
 	/*
 	 * xmlSchemaValidateFile() returns "-1" if document is not well formed
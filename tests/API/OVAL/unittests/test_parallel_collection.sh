@@ -0,0 +1,24 @@
+#!/usr/bin/env bash
+. $builddir/tests/test_common.sh
+
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+sequential=$(mktemp ${name}.seq.XXXXXX)
+parallel=$(mktemp ${name}.par.XXXXXX)
+txt="/tmp/test_parallel_collection.txt"
+
+echo "key=value" > "$txt"
+export TEST_PARALLEL_COLLECTION=1
+
+$OSCAP oval eval --results $sequential $srcdir/${name}.oval.xml
+OSCAP_PROBE_COLLECTION_THREADS=4 $OSCAP oval eval --results $parallel $srcdir/${name}.oval.xml
+
+for result in $sequential $parallel; do
+	assert_exists 2 '/oval_results/results/system/definitions/definition[@result="true"]'
+	assert_exists 5 '/oval_results/results/system/tests/test[@result="true"]'
+	assert_exists 5 '/oval_results/results/system/oval_system_characteristics/collected_objects/object[@flag="complete"]'
+	assert_exists 0 '/oval_results/results/system/oval_system_characteristics/collected_objects/object[@flag="error"]'
+done
+
+rm -f "$txt" $sequential $parallel
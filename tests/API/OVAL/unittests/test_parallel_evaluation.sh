@@ -0,0 +1,29 @@
+#!/usr/bin/env bash
+. $builddir/tests/test_common.sh
+
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+sequential=$(mktemp ${name}.seq.XXXXXX)
+parallel=$(mktemp ${name}.par.XXXXXX)
+txt="/tmp/test_parallel_evaluation.txt"
+
+printf "key=value\nkey=value2\n" > "$txt"
+
+$OSCAP oval eval --results $sequential $srcdir/${name}.oval.xml
+OSCAP_EVALUATION_THREADS=4 $OSCAP oval eval --results $parallel $srcdir/${name}.oval.xml
+
+result=$parallel
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:1"][@result="true"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:2"][@result="true"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:3"][@result="true"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:4"][@result="false"]'
+assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:5"][@result="unknown"]'
+assert_exists 6 '/oval_results/results/system/tests/test'
+# The mask of the state shared by the items of the object is copied to them
+assert_exists 2 '/oval_results/results/system/oval_system_characteristics/system_data/*/*[local-name()="subexpression"][@mask="true"][not(text())]'
+
+# Apart from the time of the evaluation, the results are the same
+diff <(grep -v "timestamp" $sequential) <(grep -v "timestamp" $parallel)
+
+rm -f "$txt" $sequential $parallel
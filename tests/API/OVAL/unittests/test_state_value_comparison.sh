@@ -0,0 +1,47 @@
+#!/usr/bin/env bash
+
+# State values are prepared for the comparisons once per test, unless they
+# refer to a variable. Both ways have to give the same results.
+
+. $builddir/tests/test_common.sh
+
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+result=$(mktemp ${name}.out.XXXXXX)
+echo "result file: $result"
+
+$OSCAP oval analyse --results $result $srcdir/$name.oval.xml $srcdir/$name.syschar.xml
+[ -f $result ]
+
+assert_exists 22 '/oval_results/results/system/definitions/definition'
+# oval:x:def:N has the state value in the state, oval:x:def:1NN in a variable
+function assert_result {
+	assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:'$1'"][@result="'$3'"]'
+	assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:'$2'"][@result="'$3'"]'
+}
+
+# version "greater than": 1.10.2 vs 1.9.5
+assert_result 1 101 true
+# version "less than": 1.10.2 vs 1.9.5
+assert_result 2 102 false
+# evr_string "less than": 1:2.3-4.el8 vs 1:2.3-10.el8
+assert_result 3 103 true
+# evr_string "equals": 0:1.0-1 vs 0:1.0-1
+assert_result 4 104 true
+# ipv4_address "subset of": 192.168.1.10 vs 192.168.1.0/24
+assert_result 5 105 true
+# ipv4_address "equals": 192.168.1.10 vs 300.1.1.1
+assert_result 6 106 error
+# ipv6_address "subset of": fe80::1 vs fe80::/64
+assert_result 7 107 true
+# ipv6_address "subset of": fe81::1 vs fe80::/64
+assert_result 8 108 false
+# string "pattern match": abc123 vs ^abc[0-9]+$
+assert_result 9 109 true
+# string "pattern match": abc123 vs ^[0-9]+$
+assert_result 10 110 false
+# string "pattern match": abc123 vs (
+assert_result 11 111 error
+
+rm $result
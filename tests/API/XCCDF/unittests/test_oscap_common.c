@@ -29,6 +29,7 @@
 #include "common/list.h"
 #include "common/util.h"
 #include "common/_error.h"
+#include "common/oscap_pcre.h"
 #include "oscap_assert.h"
 
 #define SEEN_LEN 9
@@ -234,6 +235,73 @@ static void _test_hit_multiple_items1(void)
 	oscap_htable_free0(h);
 }
 
+static void _test_htable_grow_and_detach(void)
+{
+	struct oscap_htable *h = oscap_htable_new1(_htable_cmp, 1);
+	char key[32];
+	for (int i = 0; i < 5000; i++) {
+		snprintf(key, sizeof(key), "rule_%d", i);
+		oscap_assert(oscap_htable_add(h, key, (void *) (intptr_t) (i + 1)));
+	}
+	oscap_assert(!oscap_htable_add(h, "rule_42", NULL));
+	for (int i = 0; i < 5000; i += 2) {
+		snprintf(key, sizeof(key), "rule_%d", i);
+		oscap_assert(oscap_htable_detach(h, key) == (void *) (intptr_t) (i + 1));
+		oscap_assert(oscap_htable_get(h, key) == NULL);
+	}
+	for (int i = 1; i < 5000; i += 2) {
+		snprintf(key, sizeof(key), "rule_%d", i);
+		oscap_assert(oscap_htable_get(h, key) == (void *) (intptr_t) (i + 1));
+	}
+	oscap_assert(oscap_htable_add(h, "rule_0", NULL));
+	oscap_assert(oscap_htable_itemcount(h) == 2501);
+
+	int count = 0;
+	struct oscap_htable_iterator *hit = oscap_htable_iterator_new(h);
+	while (oscap_htable_iterator_has_more(hit)) {
+		oscap_assert(oscap_htable_iterator_next_key(hit) != NULL);
+		count++;
+	}
+	oscap_htable_iterator_free(hit);
+	oscap_assert(count == 2501);
+
+	struct oscap_htable_stats stats;
+	oscap_htable_get_stats(h, &stats);
+	oscap_assert(stats.itemcount == 2501);
+	oscap_assert(stats.capacity > stats.itemcount + stats.deleted);
+	oscap_assert(stats.max_probe >= 1);
+	oscap_htable_free0(h);
+}
+
+static void _test_pcre_cache(void)
+{
+	char *err = NULL;
+	int erroffset = 0;
+	oscap_pcre_t *a = oscap_pcre_compile_cached("^.*\\.conf$", 0, &err, &erroffset);
+	oscap_pcre_t *b = oscap_pcre_compile_cached("^.*\\.conf$", 0, &err, &erroffset);
+	oscap_pcre_t *c = oscap_pcre_compile_cached("^.*\\.conf$", OSCAP_PCRE_OPTS_PARTIAL, &err, &erroffset);
+	oscap_assert(a != NULL && a == b);
+	oscap_assert(c != NULL && c != a);
+	oscap_pcre_free(a);
+	oscap_assert(oscap_pcre_exec(b, "/etc/ssh/sshd.conf", 18, 0, 0, NULL, 0) >= 0);
+	oscap_assert(oscap_pcre_exec(c, "/etc", 4, 0, OSCAP_PCRE_OPTS_PARTIAL, NULL, 0) == OSCAP_PCRE_ERR_PARTIAL);
+	oscap_pcre_free(b);
+	oscap_pcre_free(c);
+
+	oscap_assert(oscap_pcre_compile_cached("(", 0, &err, &erroffset) == NULL);
+	oscap_pcre_err_free(err);
+
+	/* Handles stay valid after being evicted from the cache */
+	char pattern[32];
+	oscap_pcre_t *first = oscap_pcre_compile_cached("^rule_0$", 0, &err, &erroffset);
+	for (int i = 1; i < 1000; i++) {
+		snprintf(pattern, sizeof(pattern), "^rule_%d$", i);
+		oscap_pcre_free(oscap_pcre_compile_cached(pattern, 0, &err, &erroffset));
+	}
+	oscap_assert(oscap_pcre_exec(first, "rule_0", 6, 0, 0, NULL, 0) >= 0);
+	oscap_pcre_free(first);
+}
+
 static bool _test_list_remove_ptreq(void *a, void *b)
 {
 	return a == b;
@@ -328,6 +396,8 @@ int main(int argc, char *argv[])
 	_test_hit_empty1();
 	_test_hit_single_item1();
 	_test_hit_multiple_items1();
+	_test_htable_grow_and_detach();
+	_test_pcre_cache();
 
 	_test_list_remove();
 
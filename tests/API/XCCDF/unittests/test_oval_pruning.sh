@@ -0,0 +1,47 @@
+#!/usr/bin/env bash
+. $builddir/tests/test_common.sh
+
+set -e
+set -o pipefail
+
+# Definitions which the selected rules don't reach are dropped only with
+# --oval-pruning, external variables are always kept.
+name=$(basename $0 .sh)
+result=$(mktemp -t ${name}.out.XXXXXX)
+stderr=$(mktemp -t ${name}.out.XXXXXX)
+
+echo "Stderr file = $stderr"
+echo "Result file = $result"
+
+assert_common() {
+	assert_exists 1 '//rule-result'
+	assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_1"]/result[text()="pass"]'
+	assert_exists 1 '//oval_definitions/definitions/definition[@id="oval:x:def:1"]'
+	assert_exists 1 '//oval_definitions/tests/*[@id="oval:x:tst:1"]'
+	assert_exists 1 '//oval_definitions/objects/*[@id="oval:x:obj:1"]'
+	assert_exists 1 '//oval_definitions/variables/external_variable[@id="oval:x:var:2"]'
+	assert_exists 1 '//oval_definitions/variables/external_variable[@id="oval:x:var:4"]'
+	assert_exists 1 '//results/system/definitions/definition[@definition_id="oval:x:def:1"][@result="true"]'
+}
+
+$OSCAP xccdf eval --results-arf $result $srcdir/${name}.xccdf.xml 2> $stderr
+[ -f $stderr ]; [ ! -s $stderr ]
+$OSCAP ds rds-validate $result
+assert_common
+assert_exists 1 '//oval_definitions/definitions/definition[@id="oval:x:def:2"]'
+assert_exists 1 '//oval_definitions/tests/*[@id="oval:x:tst:2"]'
+assert_exists 1 '//oval_definitions/objects/*[@id="oval:x:obj:2"]'
+assert_exists 1 '//oval_definitions/variables/*[@id="oval:x:var:3"]'
+
+$OSCAP xccdf eval --oval-pruning --results-arf $result $srcdir/${name}.xccdf.xml 2> $stderr
+[ -f $stderr ]; [ ! -s $stderr ]
+$OSCAP ds rds-validate $result
+assert_common
+assert_exists 0 '//oval_definitions/definitions/definition[@id="oval:x:def:2"]'
+assert_exists 0 '//oval_definitions/tests/*[@id="oval:x:tst:2"]'
+assert_exists 0 '//oval_definitions/objects/*[@id="oval:x:obj:2"]'
+assert_exists 0 '//oval_definitions/variables/*[@id="oval:x:var:3"]'
+assert_exists 0 '//results/system/definitions/definition[@definition_id="oval:x:def:2"]'
+assert_exists 0 '//collected_objects/object[@id="oval:x:obj:2"]'
+
+rm $result $stderr
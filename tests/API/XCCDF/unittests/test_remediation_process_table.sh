@@ -0,0 +1,41 @@
+#!/usr/bin/env bash
+. $builddir/tests/test_common.sh
+
+set -e
+set -o pipefail
+
+# The fix of every rule starts a process and the check of the rule has to see
+# it, although the process table has already been read for the previous rule.
+probecheck "process58" || exit 255
+
+name=$(basename $0 .sh)
+result=$(mktemp -t ${name}.out.XXXXXX)
+stderr=$(mktemp -t ${name}.out.XXXXXX)
+ret=0
+
+stop_processes() {
+	pkill -x -f 'sleep 8640[12]' || :
+}
+trap stop_processes EXIT
+stop_processes
+
+$OSCAP xccdf eval --results $result $srcdir/${name}.xccdf.xml 2> $stderr || ret=$?
+[ $ret -eq 2 ]
+
+echo "Stderr file = $stderr"
+echo "Result file = $result"
+[ -f $stderr ]; [ ! -s $stderr ]; :> $stderr
+
+assert_exists 2 '//rule-result/result[text()="fail"]'
+:> $result
+
+$OSCAP xccdf eval --remediate --results $result $srcdir/${name}.xccdf.xml 2> $stderr
+[ -f $stderr ]; [ ! -s $stderr ]; rm $stderr
+
+$OSCAP xccdf validate --skip-schematron $result
+
+assert_exists 2 '//rule-result'
+assert_exists 2 '//rule-result/result[text()="fixed"]'
+assert_exists 0 '//rule-result/message[starts-with(text(), "Failed to verify applied fix")]'
+
+rm $result
@@ -666,6 +666,50 @@ function xccdf_eval_1_multiset_syschar(){
 	done
 }
 
+#
+# Evaluate XCCDF while exporting two values from XCCDF document to a single OVAL
+# variable referenced by an object filter. The second variable set has to be
+# used to collect the object again, the values of the first one mustn't be
+# reused after the session is reset.
+#
+function xccdf_eval_3_multiset_filter(){
+	local oval_result="filter_by_variable-oval.xml.result.xml"
+	local xccdf_result=$(mktemp -t ${FUNCNAME}.xml.XXXXXX)
+	local stderr=$(mktemp -t ${FUNCNAME}.err.XXXXXX)
+	local profile="xccdf_moc.elpmaxe.www_profile_12"
+	local file300="testing_file_300y.xml"
+	local file600="testing_file_600y.xml"
+	echo "Stderr file = $stderr"
+
+	cp $srcdir/testing_file_300.xml $file300
+	cp $srcdir/testing_file_600.xml $file600
+	for f in $oval_result $xccdf_result; do
+		[ ! -f $f ] || rm $f
+	done
+
+	$OSCAP xccdf eval --profile $profile \
+		--oval-results --results $xccdf_result \
+		$srcdir/test_xccdf_variable_instance.xccdf.xml 2> $stderr
+	[ -f $stderr ]; [ ! -s $stderr ]
+	$OSCAP oval validate --schematron $oval_result
+	local result="$xccdf_result"
+	assert_exists 2 '/Benchmark/TestResult/rule-result/result[text()!="notselected"]'
+	assert_exists 1 '/Benchmark/TestResult/rule-result[@idref="xccdf_moc.elpmaxe.www_rule_15"]/result[text()="pass"]'
+	assert_exists 1 '/Benchmark/TestResult/rule-result[@idref="xccdf_moc.elpmaxe.www_rule_16"]/result[text()="pass"]'
+	result="$oval_result"
+	assert_exists 2 '/oval_results/results/system/definitions/definition[@definition_id="oval:com.example.www:def:1" and @result="true"]'
+	assert_exists 1 '/oval_results/results/system/definitions/definition[@definition_id="oval:com.example.www:def:1" and @variable_instance="2"]'
+	assert_exists 2 '/oval_results/results/system/oval_system_characteristics/system_data/ind-sys:xmlfilecontent_item'
+	assert_exists 1 '/oval_results/results/system/oval_system_characteristics/system_data/ind-sys:xmlfilecontent_item[ind-sys:filename/text()="'$file300'" and ind-sys:value_of/text()="300"]'
+	assert_exists 1 '/oval_results/results/system/oval_system_characteristics/system_data/ind-sys:xmlfilecontent_item[ind-sys:filename/text()="'$file600'" and ind-sys:value_of/text()="600"]'
+	rm $stderr
+	rm $xccdf_result
+	rm $oval_result
+	for f in $file300 $file600; do
+		chmod u+w $f ; rm $f
+	done
+}
+
 test_init test_api_xccdf_variable_instance.log
 
 test_run "Export from XCCDF to variables: 1x2 values (multival)" xccdf_export_1_multival
@@ -681,5 +725,6 @@ test_run "Export from XCCDF to variables: 3x3 the last is subset (multiset,multi
 
 test_run "Evaluate XCCDF: 2x1 values (multiset)" xccdf_eval_2_multiset
 test_run "Evaluate XCCDF: 2x1 values (multiset) in syschar" xccdf_eval_1_multiset_syschar
+test_run "Evaluate XCCDF: 2x1 values (multiset) in object filter" xccdf_eval_3_multiset_filter
 
 test_exit
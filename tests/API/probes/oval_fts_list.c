@@ -8,6 +8,7 @@
 #include <string.h>
 #include "sexp.h"
 #include "oval_fts.h"
+#include "oval_fts_walk.h"
 #include "probe-api.h"
 #include <stddef.h>
 #include <assert.h>
@@ -167,12 +168,35 @@ static int create_behaviors_sexpr(char *arg_max_depth, char *arg_recurse, char *
 	return 0;
 }
 
-int main(int argc, char *argv[])
+static char *list_files(SEXP_t *path, SEXP_t *filename, SEXP_t *filepath, SEXP_t *behaviors)
 {
 	OVAL_FTS    *ofts;
 	OVAL_FTSENT *ofts_ent;
+	SEXP_t *result;
+	char *buf = NULL;
+	size_t buf_len = 0;
+	FILE *out = open_memstream(&buf, &buf_len);
+
+	result = probe_cobj_new(SYSCHAR_FLAG_UNKNOWN, NULL, NULL, NULL);
+	ofts = oval_fts_open_prefixed(NULL, path, filename, filepath, behaviors, result);
 
-	SEXP_t *path, *filename, *behaviors, *filepath, *result;
+	if (ofts != NULL) {
+		while ((ofts_ent = oval_fts_read(ofts)) != NULL) {
+			fprintf(out, "%s/%s\n", ofts_ent->path, ofts_ent->file ? ofts_ent->file : "");
+			oval_ftsent_free(ofts_ent);
+		}
+
+		oval_fts_close(ofts);
+	}
+	SEXP_free(result);
+	fclose(out);
+
+	return buf;
+}
+
+int main(int argc, char *argv[])
+{
+	SEXP_t *path, *filename, *behaviors, *filepath;
 
 	int ret = 0;
 
@@ -211,29 +235,31 @@ int main(int argc, char *argv[])
 		return ret;
 
 
-	result    = probe_cobj_new(SYSCHAR_FLAG_UNKNOWN, NULL, NULL, NULL);
-
 	fprintf(stderr,
 		"path=%p\n"
 		"filename=%p\n"
 		"filepath=%p\n"
 		"behaviors=%p\n", path, filename, filepath, behaviors);
 
-	ofts = oval_fts_open_prefixed(NULL, path, filename, filepath, behaviors, result);
-
-	if (ofts != NULL) {
-		while ((ofts_ent = oval_fts_read(ofts)) != NULL) {
-			printf("%s/%s\n", ofts_ent->path, ofts_ent->file ? ofts_ent->file : "");
-			oval_ftsent_free(ofts_ent);
-		}
-
-		oval_fts_close(ofts);
+	/* The second listing is served by the directory walk cache
+	 * and has to be the same as the first one. */
+	oval_walk_cache_acquire();
+	char *first = list_files(path, filename, filepath, behaviors);
+	char *second = list_files(path, filename, filepath, behaviors);
+	oval_walk_cache_release();
+
+	printf("%s", first);
+	if (strcmp(first, second) != 0) {
+		fprintf(stderr, "The cached listing differs:\n%s", second);
+		ret = 1;
 	}
+	free(first);
+	free(second);
 
 	SEXP_free(path);
 	SEXP_free(filename);
 	SEXP_free(filepath);
 	SEXP_free(behaviors);
 
-	return 0;
+	return ret;
 }
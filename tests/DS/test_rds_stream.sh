@@ -0,0 +1,53 @@
+#!/usr/bin/env bash
+
+# The ARF written by 'oscap xccdf eval --results-arf' is streamed unless
+# the HTML report needs the DOM. Both ways have to give the same document.
+
+. $builddir/tests/test_common.sh
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+tmpdir=$(make_temp_dir /tmp ${name})
+sds=${srcdir}/eval_cpe/sds.xml
+echo "Temp dir: $tmpdir"
+
+# Drop the timestamps, the namespace declarations and the formatting,
+# one element per line
+function normalize {
+	xmllint --noblanks --c14n $1 \
+		| sed -E 's/ xmlns(:[a-zA-Z0-9_-]+)?="[^"]*"//g; s/[0-9]{4}-[0-9]{2}-[0-9]{2}T[0-9:.]+([+-][0-9:]+|Z)?/TIMESTAMP/g; s/ time="[0-9]+"//g; s/></>\n</g'
+}
+
+pushd $tmpdir > /dev/null
+
+echo "Streamed ARF."
+$OSCAP xccdf eval --results-arf stream.arf.xml $sds > /dev/null || [ $? -eq 2 ]
+$OSCAP ds rds-validate stream.arf.xml
+# the OVAL results aren't exported unless asked for
+[ "$(ls *.result.xml 2> /dev/null | wc -l)" == "0" ]
+
+echo "ARF built in memory for the HTML report."
+$OSCAP xccdf eval --results-arf dom.arf.xml --report report.html $sds > /dev/null || [ $? -eq 2 ]
+$OSCAP ds rds-validate dom.arf.xml
+[ "$(ls *.result.xml 2> /dev/null | wc -l)" == "0" ]
+
+normalize stream.arf.xml > stream.txt
+normalize dom.arf.xml > dom.txt
+diff -u dom.txt stream.txt
+
+result=stream.arf.xml
+assert_exists 3 '//rule-result'
+assert_exists 1 '//rule-result[@idref="xccdf_moc.elpmaxe.www_rule_applicable_pass"]/result[text()="pass"]'
+
+echo "Streamed ARF with the OVAL results exported."
+$OSCAP xccdf eval --oval-results --results-arf oval.arf.xml $sds > /dev/null || [ $? -eq 2 ]
+$OSCAP ds rds-validate oval.arf.xml
+[ "$(ls *.result.xml | wc -l)" != "0" ]
+for file in *.result.xml; do
+	$OSCAP oval validate --results $file
+done
+normalize oval.arf.xml > oval.txt
+diff -u dom.txt oval.txt
+
+popd > /dev/null
+rm -rf $tmpdir
@@ -0,0 +1,96 @@
+#!/usr/bin/env bash
+
+# Test of the content cache kept in OSCAP_CONTENT_CACHE_DIR and filled by
+# 'oscap ds sds-cache'.
+
+. $builddir/tests/test_common.sh
+set -e -o pipefail
+
+name=$(basename $0 .sh)
+tmpdir=$(make_temp_dir /tmp ${name})
+cache=${tmpdir}/cache
+sds=${tmpdir}/sds.xml
+log=${tmpdir}/verbose.log
+stdout=${tmpdir}/stdout
+expected=${tmpdir}/expected
+cp ${srcdir}/eval_cpe/sds.xml $sds
+
+function eval_cached {
+	OSCAP_CONTENT_CACHE_DIR=$cache $OSCAP xccdf eval --verbose DEVEL --verbose-log-file $log --progress "$@" $sds > $stdout || [ $? -eq 2 ]
+}
+
+echo "Evaluating without the cache."
+$OSCAP xccdf eval --progress $sds > $expected || [ $? -eq 2 ]
+grep -q "rule_applicable_pass:pass" $expected
+
+echo "Filling the cache."
+$OSCAP ds sds-cache --cache-dir $cache $sds
+[ "$(stat -c %a $cache)" == "700" ]
+# the entries are keyed by SHA-256 digests
+ls $cache | grep -qE '^[0-9a-f]{64}\.sds$'
+ls $cache | grep -qE '^[0-9a-f]{64}\.xccdf$'
+ls $cache | grep -qE '^[0-9a-f]{64}\.oval$'
+ls $cache | grep -qE '^[0-9a-f]{64}\.cpedict$'
+[ "$(ls $cache | grep -vcE '^[0-9a-f]{64}\.(sds|xccdf|oval|cpedict|cpelang)$')" == "0" ]
+entry=$(ls $cache/*.xccdf)
+
+echo "Evaluating from the cache."
+eval_cached
+diff $expected $stdout
+grep -q "Using the content cache entry '$entry'" $log
+! grep -q "Ignoring the content cache entry" $log
+! grep -q "Stored the content cache entry" $log
+
+echo "The cache doesn't skip the schema validation."
+: > $log
+eval_cached
+grep -q "Validating SCAP Source Datastream (1.2) document from $sds" $log
+grep -q "Using the content cache entry '$entry'" $log
+
+echo "Corrupted entry is ignored."
+last=$(tail -c 1 $entry | od -An -tx1 | tr -d ' ')
+if [ "$last" == "41" ]; then byte=B; else byte=A; fi
+printf $byte | dd of=$entry bs=1 seek=$(( $(stat -c %s $entry) - 1 )) conv=notrunc 2> /dev/null
+: > $log
+eval_cached
+diff $expected $stdout
+grep -q "Ignoring the content cache entry '$entry', it is corrupted." $log
+grep -q "Stored the content cache entry '$entry'" $log
+
+echo "Truncated entry is ignored."
+truncate -s -1 $entry
+: > $log
+eval_cached
+diff $expected $stdout
+grep -q "Ignoring the content cache entry '$entry', it is truncated." $log
+
+echo "Entry writable by others is ignored."
+chmod g+w $entry
+: > $log
+eval_cached
+diff $expected $stdout
+grep -q "Ignoring the content cache entry '$entry', it isn't owned by the user or it is writable by others." $log
+# the entry is replaced by a private one
+[ "$(stat -c %a $entry)" == "600" ]
+
+echo "Directory writable by others isn't used."
+chmod 0777 $cache
+: > $log
+eval_cached
+diff $expected $stdout
+grep -q "Not using the content cache directory '$cache'" $log
+! grep -q "Using the content cache entry" $log
+! grep -q "Stored the content cache entry" $log
+chmod 0700 $cache
+
+echo "Changed content invalidates the cache."
+sed -i 's/operator="OR"/operator="AND"/' $sds
+: > $log
+eval_cached
+grep -q "rule_applicable_pass:notapplicable" $stdout
+! grep -q "Using the content cache entry" $log
+grep -q "Stored the content cache entry" $log
+$OSCAP xccdf eval --progress $sds > $expected || [ $? -eq 2 ]
+diff $expected $stdout
+
+rm -rf $tmpdir
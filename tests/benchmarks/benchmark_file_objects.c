@@ -0,0 +1,187 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Collects file_objects with exact paths, half of them given by filepath
+ * and half by path and filename, and reports how many objects per second
+ * the file probe handles. The files are spread over directories of 100
+ * files each, every object names a different file.
+ *
+ * Usage: benchmark_file_objects [number of objects]
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "oscap.h"
+#include "oscap_error.h"
+#include "oscap_source.h"
+#include "oval_definitions.h"
+#include "oval_system_characteristics.h"
+#include "oval_probe.h"
+#include "oval_probe_session.h"
+
+#define FILES_PER_DIR 100
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int create_files(const char *root, int count)
+{
+	char path[PATH_MAX];
+
+	for (int i = 0; i < count; ++i) {
+		if (i % FILES_PER_DIR == 0) {
+			snprintf(path, sizeof(path), "%s/d%d", root, i / FILES_PER_DIR);
+			if (mkdir(path, 0700) != 0)
+				return -1;
+		}
+		snprintf(path, sizeof(path), "%s/d%d/f%d", root, i / FILES_PER_DIR, i);
+		FILE *fp = fopen(path, "w");
+		if (fp == NULL)
+			return -1;
+		fclose(fp);
+	}
+	return 0;
+}
+
+static void remove_files(const char *root, int count)
+{
+	char path[PATH_MAX];
+
+	for (int i = 0; i < count; ++i) {
+		snprintf(path, sizeof(path), "%s/d%d/f%d", root, i / FILES_PER_DIR, i);
+		unlink(path);
+		if (i % FILES_PER_DIR == FILES_PER_DIR - 1 || i == count - 1) {
+			snprintf(path, sizeof(path), "%s/d%d", root, i / FILES_PER_DIR);
+			rmdir(path);
+		}
+	}
+	rmdir(root);
+}
+
+static int write_content(FILE *fp, const char *root, int count)
+{
+	fprintf(fp,
+		"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		"<oval_definitions xmlns=\"http://oval.mitre.org/XMLSchema/oval-definitions-5\""
+		" xmlns:oval=\"http://oval.mitre.org/XMLSchema/oval-common-5\""
+		" xmlns:unix-def=\"http://oval.mitre.org/XMLSchema/oval-definitions-5#unix\">\n"
+		"  <generator>\n"
+		"    <oval:product_name>benchmark</oval:product_name>\n"
+		"    <oval:schema_version>5.11.2</oval:schema_version>\n"
+		"    <oval:timestamp>2026-01-01T00:00:00</oval:timestamp>\n"
+		"  </generator>\n"
+		"  <objects>\n");
+	for (int i = 0; i < count; ++i) {
+		fprintf(fp, "    <unix-def:file_object id=\"oval:bench:obj:%d\" version=\"1\">\n", i + 1);
+		if (i % 2 == 0) {
+			fprintf(fp, "      <unix-def:filepath>%s/d%d/f%d</unix-def:filepath>\n",
+				root, i / FILES_PER_DIR, i);
+		} else {
+			fprintf(fp, "      <unix-def:path>%s/d%d</unix-def:path>\n"
+				"      <unix-def:filename>f%d</unix-def:filename>\n",
+				root, i / FILES_PER_DIR, i);
+		}
+		fprintf(fp, "    </unix-def:file_object>\n");
+	}
+	fprintf(fp, "  </objects>\n</oval_definitions>\n");
+	return ferror(fp) ? -1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+	int count = argc > 1 && atoi(argv[1]) > 0 ? atoi(argv[1]) : 10000;
+	char root[] = "/tmp/benchmark_file_objects.XXXXXX";
+	char path[] = "/tmp/benchmark_file_objects.xml.XXXXXX";
+	int ret = 1;
+
+	if (mkdtemp(root) == NULL || create_files(root, count) != 0) {
+		fprintf(stderr, "Can't create the files in '%s'.\n", root);
+		remove_files(root, count);
+		return 1;
+	}
+
+	int fd = mkstemp(path);
+	FILE *fp = fd == -1 ? NULL : fdopen(fd, "w");
+	if (fp == NULL || write_content(fp, root, count) != 0) {
+		fprintf(stderr, "Can't write the content to '%s'.\n", path);
+		remove_files(root, count);
+		return 1;
+	}
+	fclose(fp);
+
+	struct oscap_source *source = oscap_source_new_from_file(path);
+	struct oval_definition_model *def_model = oval_definition_model_import_source(source);
+	oscap_source_free(source);
+	unlink(path);
+	if (def_model == NULL) {
+		fprintf(stderr, "Can't import the content: %s\n", oscap_err_get_full_error());
+		remove_files(root, count);
+		return 1;
+	}
+	struct oval_syschar_model *sys_model = oval_syschar_model_new(def_model);
+	oval_probe_session_t *sess = oval_probe_session_new(sys_model);
+
+	int collected = 0, failed = 0, items = 0;
+	double t = now();
+	struct oval_object_iterator *objects = oval_definition_model_get_objects(def_model);
+	while (oval_object_iterator_has_more(objects)) {
+		struct oval_object *object = oval_object_iterator_next(objects);
+		struct oval_syschar *syschar = NULL;
+		if (oval_probe_query_object(sess, object, 0, &syschar) == 0) {
+			++collected;
+			struct oval_sysitem_iterator *sysitems = oval_syschar_get_sysitem(syschar);
+			while (oval_sysitem_iterator_has_more(sysitems)) {
+				oval_sysitem_iterator_next(sysitems);
+				++items;
+			}
+			oval_sysitem_iterator_free(sysitems);
+		} else {
+			++failed;
+		}
+	}
+	oval_object_iterator_free(objects);
+	double elapsed = now() - t;
+
+	printf("%d objects in %8.3f s   %10.0f objects/s   %d items   %d failed\n",
+		collected, elapsed, collected / elapsed, items, failed);
+	if (failed == 0 && items == count)
+		ret = 0;
+
+	oval_probe_session_destroy(sess);
+	oval_syschar_model_free(sys_model);
+	oval_definition_model_free(def_model);
+	oscap_cleanup();
+	remove_files(root, count);
+	return ret;
+}
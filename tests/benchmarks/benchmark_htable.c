@@ -0,0 +1,253 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Compares the open-addressing oscap_htable with the former chained
+ * implementation on the set of IDs found in real SCAP content.
+ *
+ * Usage: benchmark_htable [rounds] [datastream ...]
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <libxml/parser.h>
+#include <libxml/tree.h>
+
+#include "oscap_helpers.h"
+#include "oscap_source.h"
+#include "common/list.h"
+#include "common/util.h"
+
+#ifndef BENCHMARK_DEFAULT_CONTENT
+#define BENCHMARK_DEFAULT_CONTENT "ssg-rhel8-ds.xml.bz2"
+#endif
+
+/* The chained hash table as it was implemented before, kept as a baseline. */
+#define LEGACY_HSIZE 389
+
+struct legacy_item {
+	struct legacy_item *next;
+	char *key;
+	void *value;
+};
+
+struct legacy_htable {
+	size_t itemcount;
+	struct legacy_item *table[LEGACY_HSIZE];
+};
+
+static unsigned int legacy_hash(const char *str)
+{
+	unsigned h = 0;
+	for (const unsigned char *p = (const unsigned char *) str; *p != '\0'; p++)
+		h = (97 * h) + *p;
+	return h % LEGACY_HSIZE;
+}
+
+static struct legacy_item *legacy_lookup(struct legacy_htable *t, const char *key)
+{
+	for (struct legacy_item *it = t->table[legacy_hash(key)]; it != NULL; it = it->next) {
+		if (strcmp(it->key, key) == 0)
+			return it;
+	}
+	return NULL;
+}
+
+static bool legacy_add(struct legacy_htable *t, const char *key, void *value)
+{
+	if (legacy_lookup(t, key) != NULL)
+		return false;
+	unsigned int h = legacy_hash(key);
+	struct legacy_item *it = malloc(sizeof(struct legacy_item));
+	it->key = oscap_strdup(key);
+	it->value = value;
+	it->next = t->table[h];
+	t->table[h] = it;
+	t->itemcount++;
+	return true;
+}
+
+static void *legacy_get(struct legacy_htable *t, const char *key)
+{
+	struct legacy_item *it = legacy_lookup(t, key);
+	return it ? it->value : NULL;
+}
+
+static void legacy_free(struct legacy_htable *t)
+{
+	for (size_t i = 0; i < LEGACY_HSIZE; ++i) {
+		struct legacy_item *it = t->table[i];
+		while (it != NULL) {
+			struct legacy_item *next = it->next;
+			free(it->key);
+			free(it);
+			it = next;
+		}
+	}
+	free(t);
+}
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void collect_ids(xmlNode *node, struct oscap_htable *seen, struct oscap_list *ids)
+{
+	for (; node != NULL; node = node->next) {
+		if (node->type != XML_ELEMENT_NODE)
+			continue;
+		xmlChar *id = xmlGetProp(node, BAD_CAST "id");
+		if (id != NULL) {
+			if (oscap_htable_add(seen, (const char *) id, NULL))
+				oscap_list_add(ids, oscap_strdup((const char *) id));
+			xmlFree(id);
+		}
+		collect_ids(node->children, seen, ids);
+	}
+}
+
+static int load_ids(const char *path, struct oscap_htable *seen, struct oscap_list *ids)
+{
+	struct oscap_source *source = oscap_source_new_from_file(path);
+	char *buffer = NULL;
+	size_t size = 0;
+	if (oscap_source_get_raw_memory(source, &buffer, &size) != 0) {
+		fprintf(stderr, "Unable to load '%s'\n", path);
+		oscap_source_free(source);
+		return 1;
+	}
+	xmlDoc *doc = xmlReadMemory(buffer, size, path, NULL, XML_PARSE_HUGE);
+	free(buffer);
+	oscap_source_free(source);
+	if (doc == NULL) {
+		fprintf(stderr, "Unable to parse '%s'\n", path);
+		return 1;
+	}
+	collect_ids(xmlDocGetRootElement(doc), seen, ids);
+	xmlFreeDoc(doc);
+	return 0;
+}
+
+static void report(const char *name, const char *phase, double seconds, size_t ops)
+{
+	printf("%-10s %-8s %10.1f ns/op\n", name, phase, seconds * 1e9 / ops);
+}
+
+int main(int argc, char *argv[])
+{
+	int rounds = 50;
+	int first = 1;
+	if (argc > 1 && atoi(argv[1]) > 0) {
+		rounds = atoi(argv[1]);
+		first = 2;
+	}
+
+	struct oscap_htable *seen = oscap_htable_new();
+	struct oscap_list *id_list = oscap_list_new();
+	if (first >= argc) {
+		if (load_ids(BENCHMARK_DEFAULT_CONTENT, seen, id_list))
+			return 1;
+	}
+	for (int i = first; i < argc; ++i) {
+		if (load_ids(argv[i], seen, id_list))
+			return 1;
+	}
+
+	size_t count = oscap_list_get_itemcount(id_list);
+	if (count == 0) {
+		fprintf(stderr, "No IDs found.\n");
+		return 1;
+	}
+	char **ids = malloc(count * sizeof(char *));
+	char **misses = malloc(count * sizeof(char *));
+	size_t n = 0;
+	struct oscap_iterator *it = oscap_iterator_new(id_list);
+	while (oscap_iterator_has_more(it)) {
+		ids[n] = oscap_iterator_next(it);
+		misses[n] = oscap_sprintf("%s-missing", ids[n]);
+		n++;
+	}
+	oscap_iterator_free(it);
+	printf("%zu unique IDs, %d rounds\n", count, rounds);
+
+	volatile size_t found = 0;
+	double insert_time = 0, hit_time = 0, miss_time = 0, t;
+
+	for (int r = 0; r < rounds; ++r) {
+		struct legacy_htable *legacy = calloc(1, sizeof(struct legacy_htable));
+		t = now();
+		for (size_t i = 0; i < count; ++i)
+			legacy_add(legacy, ids[i], ids[i]);
+		insert_time += now() - t;
+		t = now();
+		for (size_t i = 0; i < count; ++i)
+			found += legacy_get(legacy, ids[i]) != NULL;
+		hit_time += now() - t;
+		t = now();
+		for (size_t i = 0; i < count; ++i)
+			found += legacy_get(legacy, misses[i]) != NULL;
+		miss_time += now() - t;
+		legacy_free(legacy);
+	}
+	report("chained", "insert", insert_time, count * rounds);
+	report("chained", "hit", hit_time, count * rounds);
+	report("chained", "miss", miss_time, count * rounds);
+
+	insert_time = hit_time = miss_time = 0;
+	struct oscap_htable_stats stats;
+	for (int r = 0; r < rounds; ++r) {
+		struct oscap_htable *htable = oscap_htable_new();
+		t = now();
+		for (size_t i = 0; i < count; ++i)
+			oscap_htable_add(htable, ids[i], ids[i]);
+		insert_time += now() - t;
+		t = now();
+		for (size_t i = 0; i < count; ++i)
+			found += oscap_htable_get(htable, ids[i]) != NULL;
+		hit_time += now() - t;
+		t = now();
+		for (size_t i = 0; i < count; ++i)
+			found += oscap_htable_get(htable, misses[i]) != NULL;
+		miss_time += now() - t;
+		oscap_htable_get_stats(htable, &stats);
+		oscap_htable_free0(htable);
+	}
+	report("open", "insert", insert_time, count * rounds);
+	report("open", "hit", hit_time, count * rounds);
+	report("open", "miss", miss_time, count * rounds);
+	printf("open table: %zu slots, %zu items, avg probe %.2f, max probe %zu\n",
+		stats.capacity, stats.itemcount, stats.avg_probe, stats.max_probe);
+
+	for (size_t i = 0; i < count; ++i)
+		free(misses[i]);
+	free(misses);
+	free(ids);
+	oscap_list_free(id_list, free);
+	oscap_htable_free0(seen);
+	return 0;
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Collects many cheap objects (uname_object and sysctl_object) one after
+ * another and reports how many objects per second the probes handle. The
+ * objects differ in their IDs only, so every one of them is a new request
+ * for the probe and the time is dominated by the request handling.
+ *
+ * Usage: benchmark_probe_objects [objects per probe]
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "oscap.h"
+#include "oscap_error.h"
+#include "oscap_source.h"
+#include "oval_definitions.h"
+#include "oval_system_characteristics.h"
+#include "oval_probe.h"
+#include "oval_probe_session.h"
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int write_content(FILE *fp, int count)
+{
+	fprintf(fp,
+		"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		"<oval_definitions xmlns=\"http://oval.mitre.org/XMLSchema/oval-definitions-5\""
+		" xmlns:oval=\"http://oval.mitre.org/XMLSchema/oval-common-5\""
+		" xmlns:unix-def=\"http://oval.mitre.org/XMLSchema/oval-definitions-5#unix\">\n"
+		"  <generator>\n"
+		"    <oval:product_name>benchmark</oval:product_name>\n"
+		"    <oval:schema_version>5.11.2</oval:schema_version>\n"
+		"    <oval:timestamp>2026-01-01T00:00:00</oval:timestamp>\n"
+		"  </generator>\n"
+		"  <objects>\n");
+	for (int i = 0; i < count; ++i) {
+		fprintf(fp, "    <unix-def:uname_object id=\"oval:bench:obj:%d\" version=\"1\"/>\n", 2 * i + 1);
+		fprintf(fp, "    <unix-def:sysctl_object id=\"oval:bench:obj:%d\" version=\"1\">\n"
+			"      <unix-def:name>kernel.hostname</unix-def:name>\n"
+			"    </unix-def:sysctl_object>\n", 2 * i + 2);
+	}
+	fprintf(fp, "  </objects>\n</oval_definitions>\n");
+	return ferror(fp) ? -1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+	int count = argc > 1 && atoi(argv[1]) > 0 ? atoi(argv[1]) : 5000;
+	char path[] = "/tmp/benchmark_probe_objects.XXXXXX";
+
+	int fd = mkstemp(path);
+	FILE *fp = fd == -1 ? NULL : fdopen(fd, "w");
+	if (fp == NULL || write_content(fp, count) != 0) {
+		fprintf(stderr, "Can't write the content to '%s'.\n", path);
+		return 1;
+	}
+	fclose(fp);
+
+	struct oscap_source *source = oscap_source_new_from_file(path);
+	struct oval_definition_model *def_model = oval_definition_model_import_source(source);
+	oscap_source_free(source);
+	unlink(path);
+	if (def_model == NULL) {
+		fprintf(stderr, "Can't import the content: %s\n", oscap_err_get_full_error());
+		return 1;
+	}
+	struct oval_syschar_model *sys_model = oval_syschar_model_new(def_model);
+	oval_probe_session_t *sess = oval_probe_session_new(sys_model);
+
+	int collected = 0, failed = 0;
+	double t = now();
+	struct oval_object_iterator *objects = oval_definition_model_get_objects(def_model);
+	while (oval_object_iterator_has_more(objects)) {
+		struct oval_object *object = oval_object_iterator_next(objects);
+		struct oval_syschar *syschar = NULL;
+		if (oval_probe_query_object(sess, object, 0, &syschar) == 0)
+			++collected;
+		else
+			++failed;
+	}
+	oval_object_iterator_free(objects);
+	double elapsed = now() - t;
+
+	printf("%d objects in %8.3f s   %10.0f objects/s   %d failed\n",
+		collected, elapsed, collected / elapsed, failed);
+
+	oval_probe_session_destroy(sess);
+	oval_syschar_model_free(sys_model);
+	oval_definition_model_free(def_model);
+	oscap_cleanup();
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Looks up every installed package by name, once with a database iterator
+ * per lookup, the way the rpm probes queried the database for each object,
+ * and once against a sorted index built by a single pass over the database,
+ * the way the shared rpm index does. A regex lookup over all packages is
+ * measured the same way.
+ *
+ * Usage: benchmark_rpm_index [root] [rounds]
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <regex.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <rpm/rpmlib.h>
+#include <rpm/rpmts.h>
+#include <rpm/rpmdb.h>
+#include <rpm/header.h>
+
+#define PKG_FORMAT "%{NAME}\n%{EPOCH}\n%{VERSION}\n%{RELEASE}\n%{ARCH}\n"
+
+struct pkg {
+	char *name;
+	char *data;
+};
+
+static int pkg_cmp(const void *a, const void *b)
+{
+	return strcmp(((const struct pkg *) a)->name, ((const struct pkg *) b)->name);
+}
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* A single pass over the database into a sorted array, like rpm_index_read() */
+static struct pkg *index_load(rpmts ts, size_t *count)
+{
+	rpmdbMatchIterator mi = rpmtsInitIterator(ts, RPMDBI_PACKAGES, NULL, 0);
+	size_t n = 0, size = 256;
+	struct pkg *pkgs = malloc(size * sizeof(struct pkg));
+	Header h;
+
+	while ((h = rpmdbNextIterator(mi)) != NULL) {
+		if (n == size)
+			pkgs = realloc(pkgs, (size *= 2) * sizeof(struct pkg));
+		pkgs[n].data = headerFormat(h, PKG_FORMAT, NULL);
+		pkgs[n].name = strndup(pkgs[n].data, strcspn(pkgs[n].data, "\n"));
+		++n;
+	}
+	rpmdbFreeIterator(mi);
+	qsort(pkgs, n, sizeof(struct pkg), pkg_cmp);
+	*count = n;
+	return pkgs;
+}
+
+static void index_free(struct pkg *pkgs, size_t count)
+{
+	for (size_t i = 0; i < count; ++i) {
+		free(pkgs[i].name);
+		free(pkgs[i].data);
+	}
+	free(pkgs);
+}
+
+/* One database query per lookup, as the probes did for each object */
+static size_t query_name(rpmts ts, const char *name)
+{
+	rpmdbMatchIterator mi = rpmtsInitIterator(ts, RPMTAG_NAME, name, 0);
+	size_t found = 0;
+	Header h;
+
+	while ((h = rpmdbNextIterator(mi)) != NULL) {
+		free(headerFormat(h, PKG_FORMAT, NULL));
+		++found;
+	}
+	rpmdbFreeIterator(mi);
+	return found;
+}
+
+static size_t query_regex(rpmts ts, const char *pattern)
+{
+	rpmdbMatchIterator mi = rpmtsInitIterator(ts, RPMDBI_PACKAGES, NULL, 0);
+	size_t found = 0;
+	Header h;
+
+	rpmdbSetIteratorRE(mi, RPMTAG_NAME, RPMMIRE_REGEX, pattern);
+	while ((h = rpmdbNextIterator(mi)) != NULL) {
+		free(headerFormat(h, PKG_FORMAT, NULL));
+		++found;
+	}
+	rpmdbFreeIterator(mi);
+	return found;
+}
+
+static size_t index_name(const struct pkg *pkgs, size_t count, const char *name)
+{
+	struct pkg key = { .name = (char *) name };
+	const struct pkg *p = bsearch(&key, pkgs, count, sizeof(struct pkg), pkg_cmp);
+	size_t found = 0;
+
+	if (p == NULL)
+		return 0;
+	while (p > pkgs && strcmp(p[-1].name, name) == 0)
+		--p;
+	for (; p < pkgs + count && strcmp(p->name, name) == 0; ++p)
+		++found;
+	return found;
+}
+
+static size_t index_regex(const struct pkg *pkgs, size_t count, const char *pattern)
+{
+	regex_t re;
+	size_t found = 0;
+
+	if (regcomp(&re, pattern, REG_EXTENDED | REG_NOSUB) != 0)
+		return 0;
+	for (size_t i = 0; i < count; ++i) {
+		if (regexec(&re, pkgs[i].name, 0, NULL, 0) == 0)
+			++found;
+	}
+	regfree(&re);
+	return found;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *root = argc > 1 ? argv[1] : "/";
+	int rounds = argc > 2 && atoi(argv[2]) > 0 ? atoi(argv[2]) : 3;
+	const char *pattern = "^(kernel|lib.*-devel|python3-.*)$";
+
+	if (rpmReadConfigFiles(NULL, NULL) != 0) {
+		fprintf(stderr, "Can't read the rpm configuration.\n");
+		return 1;
+	}
+	rpmts ts = rpmtsCreate();
+	rpmtsSetRootDir(ts, root);
+
+	size_t count;
+	struct pkg *pkgs = index_load(ts, &count);
+	if (count == 0) {
+		fprintf(stderr, "No packages found in the rpm database under '%s'.\n", root);
+		return 1;
+	}
+	printf("%zu packages under '%s', %d rounds\n", count, root, rounds);
+
+	double query_time = 0, index_time = 0, query_re_time = 0, index_re_time = 0;
+	size_t query_found = 0, index_found = 0;
+	for (int r = 0; r < rounds; ++r) {
+		double t = now();
+		for (size_t i = 0; i < count; ++i)
+			query_found += query_name(ts, pkgs[i].name);
+		query_time += now() - t;
+
+		t = now();
+		size_t index_count;
+		struct pkg *index = index_load(ts, &index_count);
+		for (size_t i = 0; i < count; ++i)
+			index_found += index_name(index, index_count, pkgs[i].name);
+		index_time += now() - t;
+
+		t = now();
+		query_found += query_regex(ts, pattern);
+		query_re_time += now() - t;
+
+		t = now();
+		index_found += index_regex(index, index_count, pattern);
+		index_re_time += now() - t;
+		index_free(index, index_count);
+	}
+
+	printf("by name:  iterator %8.3f s   index (with load) %8.3f s\n",
+		query_time / rounds, index_time / rounds);
+	printf("by regex: iterator %8.3f ms  index             %8.3f ms\n",
+		query_re_time * 1e3 / rounds, index_re_time * 1e3 / rounds);
+	if (query_found != index_found)
+		printf("warning: %zu packages found by the iterators, %zu by the index\n", query_found, index_found);
+
+	index_free(pkgs, count);
+	rpmtsFree(ts);
+	rpmFreeRpmrc();
+	return 0;
+}
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Loads a Source DataStream the way `oscap xccdf eval` does before the scan
+ * starts: the data stream is validated, the benchmark and the OVAL
+ * definitions it refers to are imported. Prints the time spent and the peak
+ * resident set size of the process. Set OSCAP_CONTENT_LOAD_THREADS=1 to
+ * compare with a sequential import of the OVAL files.
+ *
+ * Usage: benchmark_sds_load datastream.xml [profile] [--skip-validation]
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+#include "oscap.h"
+#include "oscap_error.h"
+#include "xccdf_session.h"
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *path = NULL;
+	const char *profile = NULL;
+	bool validate = true;
+
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--skip-validation") == 0)
+			validate = false;
+		else if (path == NULL)
+			path = argv[i];
+		else
+			profile = argv[i];
+	}
+	if (path == NULL) {
+		fprintf(stderr, "Usage: %s datastream.xml [profile] [--skip-validation]\n", argv[0]);
+		return 1;
+	}
+
+	double t = now();
+	struct xccdf_session *session = xccdf_session_new(path);
+	if (session == NULL) {
+		fprintf(stderr, "Can't open '%s': %s\n", path, oscap_err_get_full_error());
+		return 1;
+	}
+	xccdf_session_set_validation(session, validate, false);
+	if (xccdf_session_load(session) != 0) {
+		fprintf(stderr, "Can't load '%s': %s\n", path, oscap_err_get_full_error());
+		xccdf_session_free(session);
+		return 1;
+	}
+	if (profile != NULL && !xccdf_session_set_profile_id(session, profile)) {
+		fprintf(stderr, "No profile '%s' in '%s'\n", profile, path);
+		xccdf_session_free(session);
+		return 1;
+	}
+	double load_time = now() - t;
+
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	printf("load %8.3f s   peak RSS %8ld KiB   validation %s\n",
+		load_time, usage.ru_maxrss, validate ? "on" : "off");
+
+	xccdf_session_free(session);
+	oscap_cleanup();
+	return 0;
+}
@@ -0,0 +1,211 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Measures round trips of small obj_eval command packets between a library
+ * thread and an echoing probe thread, once over the mutex protected queue
+ * and once over the lock-free ring used by sch_queue.
+ *
+ * Usage: benchmark_seap_queue [round trips]
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "common/oscap_queue.h"
+#include "common/oscap_ring.h"
+#include "sexp.h"
+
+/* The mutex and condition variable protected queue, as used by sch_queue before. */
+struct locked_queue {
+	struct oscap_queue *queue;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	int cnt;
+};
+
+static void locked_queue_init(struct locked_queue *q)
+{
+	q->queue = oscap_queue_new();
+	pthread_mutex_init(&q->mutex, NULL);
+	pthread_cond_init(&q->cond, NULL);
+	q->cnt = 0;
+}
+
+static void locked_queue_push(struct locked_queue *q, void *data)
+{
+	pthread_mutex_lock(&q->mutex);
+	oscap_queue_add(q->queue, data);
+	q->cnt++;
+	pthread_cond_broadcast(&q->cond);
+	pthread_mutex_unlock(&q->mutex);
+}
+
+static void *locked_queue_pop(struct locked_queue *q)
+{
+	pthread_mutex_lock(&q->mutex);
+	while (q->cnt == 0)
+		pthread_cond_wait(&q->cond, &q->mutex);
+	void *data = oscap_queue_remove(q->queue);
+	q->cnt--;
+	pthread_mutex_unlock(&q->mutex);
+	return data;
+}
+
+struct channel {
+	const char *name;
+	bool ring;
+	struct oscap_ring *to_probe_ring, *from_probe_ring;
+	struct locked_queue to_probe_queue, from_probe_queue;
+};
+
+static void send_to_probe(struct channel *ch, SEXP_t *s)
+{
+	if (ch->ring)
+		oscap_ring_push(ch->to_probe_ring, s);
+	else
+		locked_queue_push(&ch->to_probe_queue, s);
+}
+
+static SEXP_t *recv_from_library(struct channel *ch)
+{
+	return ch->ring ? oscap_ring_pop(ch->to_probe_ring) : locked_queue_pop(&ch->to_probe_queue);
+}
+
+static void send_to_library(struct channel *ch, SEXP_t *s)
+{
+	if (ch->ring)
+		oscap_ring_push(ch->from_probe_ring, s);
+	else
+		locked_queue_push(&ch->from_probe_queue, s);
+}
+
+static SEXP_t *recv_from_probe(struct channel *ch)
+{
+	return ch->ring ? oscap_ring_pop(ch->from_probe_ring) : locked_queue_pop(&ch->from_probe_queue);
+}
+
+/* The shape of the packet SEAP_packet_cmd2sexp() builds for an obj_eval command. */
+static SEXP_t *obj_eval_packet(unsigned int id)
+{
+	SEXP_t *sym = SEXP_string_new("seap.cmd", 8);
+	SEXP_t *id_key = SEXP_string_new(":id", 3);
+	SEXP_t *id_val = SEXP_number_newu_16(id & 0xffff);
+	SEXP_t *class_key = SEXP_string_new(":class", 6);
+	SEXP_t *class_val = SEXP_string_new("usr", 3);
+	SEXP_t *code_key = SEXP_string_new(":code", 5);
+	SEXP_t *code_val = SEXP_number_newu_16(1);
+	SEXP_t *arg = SEXP_string_newf("oval:org.example:obj:%u", id);
+	SEXP_t *packet = SEXP_list_new(sym, id_key, id_val, class_key, class_val, code_key, code_val, arg, NULL);
+
+	SEXP_free(sym);
+	SEXP_free(id_key);
+	SEXP_free(id_val);
+	SEXP_free(class_key);
+	SEXP_free(class_val);
+	SEXP_free(code_key);
+	SEXP_free(code_val);
+	SEXP_free(arg);
+	return SEXP_list_new(packet, NULL);
+}
+
+static void *probe_thread(void *arg)
+{
+	struct channel *ch = arg;
+
+	for (;;) {
+		SEXP_t *msg = recv_from_library(ch);
+		if (msg == NULL)
+			break;
+		/* Reply with the packet, as the command handler would with its result. */
+		send_to_library(ch, msg);
+	}
+	return NULL;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+	double x = *(const double *) a, y = *(const double *) b;
+	return (x > y) - (x < y);
+}
+
+static void run(struct channel *ch, size_t rounds)
+{
+	double *latency = malloc(rounds * sizeof(double));
+	pthread_t thread;
+
+	pthread_create(&thread, NULL, probe_thread, ch);
+	double start = now();
+	for (size_t i = 0; i < rounds; ++i) {
+		SEXP_t *packet = obj_eval_packet(i);
+		double t = now();
+		send_to_probe(ch, packet);
+		SEXP_t *reply = recv_from_probe(ch);
+		latency[i] = now() - t;
+		SEXP_free(reply);
+	}
+	double total = now() - start;
+	send_to_probe(ch, NULL);
+	pthread_join(thread, NULL);
+
+	qsort(latency, rounds, sizeof(double), cmp_double);
+	printf("%-8s %10.0f round trips/s   p50 %7.2f us   p99 %7.2f us\n", ch->name,
+		rounds / total, latency[rounds / 2] * 1e6, latency[rounds * 99 / 100] * 1e6);
+	free(latency);
+}
+
+int main(int argc, char *argv[])
+{
+	size_t rounds = 200000;
+	if (argc > 1 && atol(argv[1]) > 0)
+		rounds = atol(argv[1]);
+
+	struct channel locked = { .name = "mutex", .ring = false };
+	locked_queue_init(&locked.to_probe_queue);
+	locked_queue_init(&locked.from_probe_queue);
+	run(&locked, rounds);
+	oscap_queue_free(locked.to_probe_queue.queue, NULL);
+	oscap_queue_free(locked.from_probe_queue.queue, NULL);
+
+	struct channel ring = { .name = "ring", .ring = true };
+	ring.to_probe_ring = oscap_ring_new(256);
+	ring.from_probe_ring = oscap_ring_new(256);
+	if (ring.to_probe_ring == NULL || ring.from_probe_ring == NULL) {
+		fprintf(stderr, "The lock-free ring isn't available on this platform.\n");
+		return 1;
+	}
+	run(&ring, rounds);
+	oscap_ring_free(ring.to_probe_ring, NULL);
+	oscap_ring_free(ring.from_probe_ring, NULL);
+	return 0;
+}
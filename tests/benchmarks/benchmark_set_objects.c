@@ -0,0 +1,264 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Collects file_object sets over a large tree of files and reports how long
+ * every set operation takes. Two file_objects are collected first, one with
+ * all the files and one with the files with even numbers, then the union,
+ * the intersection, the complement, a filtered object and a nested set of
+ * them are collected and the numbers of their items are checked.
+ *
+ * Usage: benchmark_set_objects [number of files]
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "oscap.h"
+#include "oscap_error.h"
+#include "oscap_source.h"
+#include "oval_definitions.h"
+#include "oval_system_characteristics.h"
+#include "oval_probe.h"
+#include "oval_probe_session.h"
+
+#define FILES_PER_DIR 100
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int create_files(const char *root, int count)
+{
+	char path[PATH_MAX];
+
+	for (int i = 0; i < count; ++i) {
+		if (i % FILES_PER_DIR == 0) {
+			snprintf(path, sizeof(path), "%s/d%d", root, i / FILES_PER_DIR);
+			if (mkdir(path, 0700) != 0)
+				return -1;
+		}
+		snprintf(path, sizeof(path), "%s/d%d/f%d", root, i / FILES_PER_DIR, i);
+		FILE *fp = fopen(path, "w");
+		if (fp == NULL)
+			return -1;
+		fclose(fp);
+	}
+	return 0;
+}
+
+static void remove_files(const char *root, int count)
+{
+	char path[PATH_MAX];
+
+	for (int i = 0; i < count; ++i) {
+		snprintf(path, sizeof(path), "%s/d%d/f%d", root, i / FILES_PER_DIR, i);
+		unlink(path);
+		if (i % FILES_PER_DIR == FILES_PER_DIR - 1 || i == count - 1) {
+			snprintf(path, sizeof(path), "%s/d%d", root, i / FILES_PER_DIR);
+			rmdir(path);
+		}
+	}
+	rmdir(root);
+}
+
+static const struct {
+	const char *name;
+	const char *content;
+} sets[] = {
+	{ "union",
+	  "      <set set_operator=\"UNION\">\n"
+	  "        <object_reference>oval:bench:obj:1</object_reference>\n"
+	  "        <object_reference>oval:bench:obj:2</object_reference>\n"
+	  "      </set>\n" },
+	{ "intersection",
+	  "      <set set_operator=\"INTERSECTION\">\n"
+	  "        <object_reference>oval:bench:obj:1</object_reference>\n"
+	  "        <object_reference>oval:bench:obj:2</object_reference>\n"
+	  "      </set>\n" },
+	{ "complement",
+	  "      <set set_operator=\"COMPLEMENT\">\n"
+	  "        <object_reference>oval:bench:obj:1</object_reference>\n"
+	  "        <object_reference>oval:bench:obj:2</object_reference>\n"
+	  "      </set>\n" },
+	{ "filter",
+	  "      <set>\n"
+	  "        <object_reference>oval:bench:obj:1</object_reference>\n"
+	  "        <filter action=\"exclude\">oval:bench:ste:1</filter>\n"
+	  "      </set>\n" },
+	{ "nested",
+	  "      <set set_operator=\"UNION\">\n"
+	  "        <set set_operator=\"INTERSECTION\">\n"
+	  "          <object_reference>oval:bench:obj:1</object_reference>\n"
+	  "          <object_reference>oval:bench:obj:2</object_reference>\n"
+	  "        </set>\n"
+	  "        <set set_operator=\"COMPLEMENT\">\n"
+	  "          <object_reference>oval:bench:obj:1</object_reference>\n"
+	  "          <object_reference>oval:bench:obj:2</object_reference>\n"
+	  "        </set>\n"
+	  "      </set>\n" },
+};
+
+#define SET_COUNT (sizeof(sets) / sizeof(sets[0]))
+
+static int expected_items(int set, int count)
+{
+	int even = (count + 1) / 2;
+
+	switch (set) {
+	case 0: return count;
+	case 1: return even;
+	case 2: return count - even;
+	case 3: return count - (count + 9) / 10 - (count + 4) / 10; /* without the files ending with 0 and 5 */
+	default: return count;
+	}
+}
+
+static int write_content(FILE *fp, const char *root)
+{
+	fprintf(fp,
+		"<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+		"<oval_definitions xmlns=\"http://oval.mitre.org/XMLSchema/oval-definitions-5\""
+		" xmlns:oval=\"http://oval.mitre.org/XMLSchema/oval-common-5\""
+		" xmlns:unix-def=\"http://oval.mitre.org/XMLSchema/oval-definitions-5#unix\">\n"
+		"  <generator>\n"
+		"    <oval:product_name>benchmark</oval:product_name>\n"
+		"    <oval:schema_version>5.11.2</oval:schema_version>\n"
+		"    <oval:timestamp>2026-01-01T00:00:00</oval:timestamp>\n"
+		"  </generator>\n"
+		"  <objects>\n");
+	fprintf(fp,
+		"    <unix-def:file_object id=\"oval:bench:obj:1\" version=\"1\">\n"
+		"      <unix-def:behaviors recurse_direction=\"down\" max_depth=\"1\"/>\n"
+		"      <unix-def:path>%s</unix-def:path>\n"
+		"      <unix-def:filename operation=\"pattern match\">^f[0-9]+$</unix-def:filename>\n"
+		"    </unix-def:file_object>\n", root);
+	fprintf(fp,
+		"    <unix-def:file_object id=\"oval:bench:obj:2\" version=\"1\">\n"
+		"      <unix-def:behaviors recurse_direction=\"down\" max_depth=\"1\"/>\n"
+		"      <unix-def:path>%s</unix-def:path>\n"
+		"      <unix-def:filename operation=\"pattern match\">^f[0-9]*[02468]$</unix-def:filename>\n"
+		"    </unix-def:file_object>\n", root);
+	for (size_t i = 0; i < SET_COUNT; ++i) {
+		fprintf(fp, "    <unix-def:file_object id=\"oval:bench:obj:%zu\" version=\"1\">\n%s"
+			"    </unix-def:file_object>\n", i + 3, sets[i].content);
+	}
+	fprintf(fp,
+		"  </objects>\n"
+		"  <states>\n"
+		"    <unix-def:file_state id=\"oval:bench:ste:1\" version=\"1\">\n"
+		"      <unix-def:filename operation=\"pattern match\">[05]$</unix-def:filename>\n"
+		"    </unix-def:file_state>\n"
+		"  </states>\n"
+		"</oval_definitions>\n");
+	return ferror(fp) ? -1 : 0;
+}
+
+static int query(oval_probe_session_t *sess, struct oval_definition_model *def_model, const char *id)
+{
+	struct oval_object *object = oval_definition_model_get_object(def_model, id);
+	struct oval_syschar *syschar = NULL;
+	int items = 0;
+
+	if (object == NULL || oval_probe_query_object(sess, object, 0, &syschar) != 0 || syschar == NULL)
+		return -1;
+
+	struct oval_sysitem_iterator *sysitems = oval_syschar_get_sysitem(syschar);
+	while (oval_sysitem_iterator_has_more(sysitems)) {
+		oval_sysitem_iterator_next(sysitems);
+		++items;
+	}
+	oval_sysitem_iterator_free(sysitems);
+	return items;
+}
+
+int main(int argc, char *argv[])
+{
+	int count = argc > 1 && atoi(argv[1]) > 0 ? atoi(argv[1]) : 20000;
+	char root[] = "/tmp/benchmark_set_objects.XXXXXX";
+	char path[] = "/tmp/benchmark_set_objects.xml.XXXXXX";
+	char id[64];
+	int ret = 0;
+
+	if (mkdtemp(root) == NULL || create_files(root, count) != 0) {
+		fprintf(stderr, "Can't create the files in '%s'.\n", root);
+		remove_files(root, count);
+		return 1;
+	}
+
+	int fd = mkstemp(path);
+	FILE *fp = fd == -1 ? NULL : fdopen(fd, "w");
+	if (fp == NULL || write_content(fp, root) != 0) {
+		fprintf(stderr, "Can't write the content to '%s'.\n", path);
+		remove_files(root, count);
+		return 1;
+	}
+	fclose(fp);
+
+	struct oscap_source *source = oscap_source_new_from_file(path);
+	struct oval_definition_model *def_model = oval_definition_model_import_source(source);
+	oscap_source_free(source);
+	unlink(path);
+	if (def_model == NULL) {
+		fprintf(stderr, "Can't import the content: %s\n", oscap_err_get_full_error());
+		remove_files(root, count);
+		return 1;
+	}
+	struct oval_syschar_model *sys_model = oval_syschar_model_new(def_model);
+	oval_probe_session_t *sess = oval_probe_session_new(sys_model);
+
+	double t = now();
+	int all = query(sess, def_model, "oval:bench:obj:1");
+	int even = query(sess, def_model, "oval:bench:obj:2");
+	printf("%-14s %8.3f s   %8d + %d items\n", "objects", now() - t, all, even);
+	if (all != count || even != (count + 1) / 2)
+		ret = 1;
+
+	for (size_t i = 0; i < SET_COUNT; ++i) {
+		snprintf(id, sizeof(id), "oval:bench:obj:%zu", i + 3);
+		t = now();
+		int items = query(sess, def_model, id);
+		double elapsed = now() - t;
+		int expected = expected_items(i, count);
+
+		printf("%-14s %8.3f s   %8d items%s\n", sets[i].name, elapsed, items,
+			items == expected ? "" : "   (unexpected)");
+		if (items != expected)
+			ret = 1;
+	}
+
+	oval_probe_session_destroy(sess);
+	oval_syschar_model_free(sys_model);
+	oval_definition_model_free(def_model);
+	oscap_cleanup();
+	remove_files(root, count);
+	return ret;
+}
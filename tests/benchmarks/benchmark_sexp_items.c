@@ -0,0 +1,221 @@
+/*
+ * Copyright 2026 Red Hat Inc., Durham, North Carolina.
+ * All Rights Reserved.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Builds a file_item for every file found under a directory, the way the
+ * file probe does, collects them into a list and frees them again. Reports
+ * the time and the number of heap allocations per item.
+ *
+ * Usage: benchmark_sexp_items [directory] [rounds]
+ */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#define _XOPEN_SOURCE 700
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include "sexp.h"
+
+#if defined(__GLIBC__)
+/* Count the heap allocations by interposing the allocator entry points. */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t nmemb, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void *__libc_memalign(size_t alignment, size_t size);
+
+static size_t alloc_count;
+
+void *malloc(size_t size)
+{
+	__atomic_add_fetch(&alloc_count, 1, __ATOMIC_RELAXED);
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t nmemb, size_t size)
+{
+	__atomic_add_fetch(&alloc_count, 1, __ATOMIC_RELAXED);
+	return __libc_calloc(nmemb, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	__atomic_add_fetch(&alloc_count, 1, __ATOMIC_RELAXED);
+	return __libc_realloc(ptr, size);
+}
+
+int posix_memalign(void **memptr, size_t alignment, size_t size)
+{
+	__atomic_add_fetch(&alloc_count, 1, __ATOMIC_RELAXED);
+	*memptr = __libc_memalign(alignment, size);
+	return *memptr == NULL ? 12 /* ENOMEM */ : 0;
+}
+#define ALLOC_COUNT() __atomic_load_n(&alloc_count, __ATOMIC_RELAXED)
+#else
+#define ALLOC_COUNT() 0
+#endif
+
+#define MAX_PATHS 200000
+
+static char *paths[MAX_PATHS];
+static size_t path_count;
+
+static int add_path(const char *path, const struct stat *st, int flag, struct FTW *ftw)
+{
+	if (path_count == MAX_PATHS)
+		return 1;
+	paths[path_count++] = strdup(path);
+	return 0;
+}
+
+/* Entity names are shared between items, like the probe name cache does. */
+static SEXP_t *names[32];
+
+static SEXP_t *name_ref(const char *name)
+{
+	size_t i;
+	for (i = 0; names[i] != NULL; ++i) {
+		if (SEXP_strcmp(names[i], name) == 0)
+			return names[i];
+	}
+	names[i] = SEXP_string_new(name, strlen(name));
+	return names[i];
+}
+
+static void add_entity(SEXP_t *item, const char *name, SEXP_t *value)
+{
+	SEXP_t entity_mem, *entity;
+
+	entity = SEXP_list_new_r(&entity_mem, name_ref(name), value, NULL);
+	SEXP_list_add(item, entity);
+	SEXP_free_r(entity);
+	SEXP_free_r(value);
+}
+
+static void add_string(SEXP_t *item, const char *name, const char *str)
+{
+	SEXP_t mem;
+	add_entity(item, name, SEXP_string_new_r(&mem, str, strlen(str)));
+}
+
+static void add_int(SEXP_t *item, const char *name, int64_t n)
+{
+	SEXP_t mem;
+	add_entity(item, name, SEXP_number_newi_64_r(&mem, n));
+}
+
+static void add_bool(SEXP_t *item, const char *name, bool b)
+{
+	SEXP_t mem;
+	add_entity(item, name, SEXP_number_newb_r(&mem, b));
+}
+
+/* The entities of a file_item, as filled in by the file probe. */
+static SEXP_t *file_item(const char *path, const struct stat *st)
+{
+	SEXP_t *name = SEXP_string_new("unix:file_item", 14);
+	SEXP_t *item = SEXP_list_new(name, NULL);
+	const char *filename = strrchr(path, '/');
+
+	SEXP_free(name);
+	add_string(item, "filepath", path);
+	add_string(item, "path", path);
+	add_string(item, "filename", filename ? filename + 1 : path);
+	add_string(item, "type", S_ISDIR(st->st_mode) ? "directory" : "regular");
+	add_int(item, "group_id", st->st_gid);
+	add_int(item, "user_id", st->st_uid);
+	add_int(item, "a_time", st->st_atime);
+	add_int(item, "c_time", st->st_ctime);
+	add_int(item, "m_time", st->st_mtime);
+	add_int(item, "size", st->st_size);
+	add_bool(item, "suid", st->st_mode & S_ISUID);
+	add_bool(item, "sgid", st->st_mode & S_ISGID);
+	add_bool(item, "sticky", st->st_mode & S_ISVTX);
+	add_bool(item, "uread", st->st_mode & S_IRUSR);
+	add_bool(item, "uwrite", st->st_mode & S_IWUSR);
+	add_bool(item, "uexec", st->st_mode & S_IXUSR);
+	add_bool(item, "gread", st->st_mode & S_IRGRP);
+	add_bool(item, "gwrite", st->st_mode & S_IWGRP);
+	add_bool(item, "gexec", st->st_mode & S_IXGRP);
+	add_bool(item, "oread", st->st_mode & S_IROTH);
+	add_bool(item, "owrite", st->st_mode & S_IWOTH);
+	add_bool(item, "oexec", st->st_mode & S_IXOTH);
+	add_bool(item, "has_extended_acl", false);
+	return item;
+}
+
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char *argv[])
+{
+	const char *dir = argc > 1 ? argv[1] : "/usr/share";
+	int rounds = argc > 2 && atoi(argv[2]) > 0 ? atoi(argv[2]) : 5;
+
+	nftw(dir, add_path, 64, FTW_PHYS);
+	if (path_count == 0) {
+		fprintf(stderr, "No files found under '%s'.\n", dir);
+		return 1;
+	}
+	struct stat *stats = malloc(path_count * sizeof(struct stat));
+	for (size_t i = 0; i < path_count; ++i) {
+		if (lstat(paths[i], &stats[i]) != 0)
+			memset(&stats[i], 0, sizeof(struct stat));
+	}
+	printf("%zu files under '%s', %d rounds\n", path_count, dir, rounds);
+
+	double build_time = 0, free_time = 0;
+	size_t build_allocs = 0;
+	for (int r = 0; r < rounds; ++r) {
+		size_t allocs = ALLOC_COUNT();
+		double t = now();
+		SEXP_t *items = SEXP_list_new(NULL);
+		for (size_t i = 0; i < path_count; ++i) {
+			SEXP_t *item = file_item(paths[i], &stats[i]);
+			SEXP_list_add(items, item);
+			SEXP_free(item);
+		}
+		build_time += now() - t;
+		build_allocs += ALLOC_COUNT() - allocs;
+		t = now();
+		SEXP_free(items);
+		free_time += now() - t;
+	}
+
+	size_t n = path_count * rounds;
+	printf("build %8.1f ns/item   free %8.1f ns/item   %6.1f allocations/item\n",
+		build_time * 1e9 / n, free_time * 1e9 / n, (double) build_allocs / n);
+
+	for (size_t i = 0; names[i] != NULL; ++i)
+		SEXP_free(names[i]);
+	for (size_t i = 0; i < path_count; ++i)
+		free(paths[i]);
+	free(stats);
+	return 0;
+}
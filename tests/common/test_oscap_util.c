@@ -28,9 +28,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include "common/util.h"
+#include "common/oscap_intern.h"
 
 int test_oscap_path_startswith(void);
 int test_oscap_strrm(void);
+int test_oscap_intern(void);
 
 int test_oscap_path_startswith()
 {
@@ -91,6 +93,40 @@ int test_oscap_strrm()
 	return 0;
 }
 
+int test_oscap_intern()
+{
+	char name[] = "filepath";
+	struct oscap_intern_stats stats;
+
+	const char *a = oscap_intern(name);
+	const char *b = oscap_intern("filepath");
+	if (a == NULL || a == name || a != b || strcmp(a, "filepath") != 0)
+		return 1;
+	const char *c = oscap_intern("path");
+	if (c == NULL || c == a)
+		return 2;
+	if (oscap_intern_ref(a) != a)
+		return 3;
+
+	oscap_intern_get_stats(&stats);
+	if (stats.strings != 2 || stats.references != 4 || stats.saved_bytes != 2 * sizeof(name))
+		return 4;
+
+	oscap_intern_release(a);
+	oscap_intern_release(a);
+	oscap_intern_release(b);
+	oscap_intern_release(c);
+	oscap_intern_get_stats(&stats);
+	if (stats.strings != 0 || stats.references != 0 || stats.bytes != 0)
+		return 5;
+
+	if (oscap_intern(NULL) != NULL)
+		return 6;
+	oscap_intern_release(NULL);
+
+	return 0;
+}
+
 int main (int argc, char *argv[])
 {
 	int retval = 0;
@@ -99,6 +135,8 @@ int main (int argc, char *argv[])
 		return retval;
 	if ((retval = test_oscap_strrm()) != 0)
 		return retval;
+	if ((retval = test_oscap_intern()) != 0)
+		return retval;
 
 	return retval;
 }
@@ -0,0 +1,58 @@
+#!/usr/bin/env bash
+
+# The names of sysctl objects with the "equals" operation are looked up
+# directly. Names which can't be mapped to a path, such as the ones of VLAN
+# interfaces, are looked up in the snapshot of the whole tree.
+
+. $builddir/tests/test_common.sh
+
+set -e -o pipefail
+
+function eval_name {
+	sed "s/%NAME%/$1/" $srcdir/test_sysctl_probe_lookup.xml.tpl > $input
+	: > $log
+	$OSCAP oval eval --verbose DEVEL --verbose-log-file $log --results $result $input 2>$stderr
+	[ ! -s $stderr ]
+}
+
+function perform_test {
+	probecheck "sysctl" || return 255
+	[ $(uname) == "Linux" ] || return 255
+
+	tmpdir=$(make_temp_dir /tmp "test_sysctl_probe_lookup")
+	input="${tmpdir}/input.xml"
+	result="${tmpdir}/result.xml"
+	stderr="${tmpdir}/stderr"
+	log="${tmpdir}/verbose.log"
+
+	mkdir -p "${tmpdir}/root/proc/sys/kernel" "${tmpdir}/root/proc/sys/net/ipv4/conf/eth0.100"
+	echo "fake.host.name.me" > "${tmpdir}/root/proc/sys/kernel/hostname"
+	echo "5.0.0" > "${tmpdir}/root/proc/sys/kernel/osrelease"
+	echo "1" > "${tmpdir}/root/proc/sys/net/ipv4/conf/eth0.100/forwarding"
+	set_chroot_offline_test_mode "${tmpdir}/root"
+
+	echo "Name looked up directly."
+	eval_name "kernel.hostname"
+	assert_exists 1 "/oval_results/results/system/oval_system_characteristics/system_data/unix-sys:sysctl_item"
+	assert_exists 1 "/oval_results/results/system/oval_system_characteristics/system_data/unix-sys:sysctl_item/unix-sys:name[text()='kernel.hostname']"
+	assert_exists 1 "/oval_results/results/system/oval_system_characteristics/system_data/unix-sys:sysctl_item/unix-sys:value[text()='fake.host.name.me']"
+	! grep -q "sysctl names from" $log
+
+	echo "Name with a dot in a component found in the snapshot."
+	eval_name "net.ipv4.conf.eth0.100.forwarding"
+	assert_exists 1 "/oval_results/results/system/oval_system_characteristics/system_data/unix-sys:sysctl_item"
+	assert_exists 1 "/oval_results/results/system/oval_system_characteristics/system_data/unix-sys:sysctl_item/unix-sys:name[text()='net.ipv4.conf.eth0.100.forwarding']"
+	assert_exists 1 "/oval_results/results/system/oval_system_characteristics/system_data/unix-sys:sysctl_item/unix-sys:value[text()='1']"
+	grep -q "Read 3 sysctl names from '${tmpdir}/root/proc/sys'." $log
+
+	echo "Missing name isn't found in the snapshot either."
+	eval_name "kernel.missing"
+	assert_exists 0 "/oval_results/results/system/oval_system_characteristics/system_data/unix-sys:sysctl_item"
+	assert_exists 1 "/oval_results/results/system/definitions/definition[@definition_id='oval:oscap:def:1'][@result='false']"
+	grep -q "Read 3 sysctl names from '${tmpdir}/root/proc/sys'." $log
+
+	unset_chroot_offline_test_mode
+	rm -rf "${tmpdir}"
+}
+
+perform_test
@@ -0,0 +1,61 @@
+#!/usr/bin/env bash
+. $builddir/tests/test_common.sh
+
+set -e -o pipefail
+
+probecheck "textfilecontent54" || exit 255
+
+name=$(basename $0 .sh)
+tmpdir=$(make_temp_dir /tmp ${name})
+tpl=${srcdir}/${name}.xml.tpl
+input=${tmpdir}/${name}.xml
+result=${tmpdir}/${name}.results.xml
+log=${tmpdir}/verbose.log
+cache=${tmpdir}/cache
+echo "Temp dir: $tmpdir"
+
+# the scanned file is kept in its own directory, writing the results
+# mustn't touch anything the cached object depends on
+mkdir ${tmpdir}/data
+sed "s@%PATH%@${tmpdir}/data@" $tpl > $input
+echo "value=1" > ${tmpdir}/data/data.txt
+
+function eval_cached {
+	: > $log
+	OSCAP_COLLECTION_CACHE_DIR=$cache $OSCAP oval eval --verbose INFO --verbose-log-file $log --results $result $input
+	$OSCAP oval validate --results $result
+	[ "$($XPATH $result 'string(/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:1"]/@result)')" == "$1" ]
+	grep -q "Collection cache '$cache': $2" $log
+}
+
+echo "Miss with an empty cache."
+eval_cached true "0 hits, 1 misses (0 stale), 1 stored."
+[ "$(stat -c %a $cache)" == "700" ]
+entry=$(ls $cache/*.cc)
+[ "$(stat -c %a $entry)" == "600" ]
+
+echo "Hit while the file doesn't change."
+eval_cached true "1 hits, 0 misses (0 stale), 0 stored."
+
+echo "Changed file invalidates the entry."
+echo "value=20" > ${tmpdir}/data/data.txt
+eval_cached false "0 hits, 1 misses (1 stale), 1 stored."
+eval_cached false "1 hits, 0 misses (0 stale), 0 stored."
+
+echo "Entry writable by others is ignored."
+chmod g+w $entry
+eval_cached false "0 hits, 1 misses (0 stale), 1 stored."
+grep -q "Ignoring the collection cache entry '$entry', it isn't owned by the user or it is writable by others." $log
+# the entry is replaced by a private one
+[ "$(stat -c %a $entry)" == "600" ]
+eval_cached false "1 hits, 0 misses (0 stale), 0 stored."
+
+echo "Directory writable by others isn't used."
+chmod 0777 $cache
+: > $log
+OSCAP_COLLECTION_CACHE_DIR=$cache $OSCAP oval eval --verbose INFO --verbose-log-file $log --results $result $input
+grep -q "Not using the collection cache directory '$cache'" $log
+! grep -q "Collection cache '$cache'" $log
+chmod 0700 $cache
+
+rm -rf $tmpdir
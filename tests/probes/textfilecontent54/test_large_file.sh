@@ -0,0 +1,37 @@
+#!/usr/bin/env bash
+. $builddir/tests/test_common.sh
+
+set -e -o pipefail
+
+probecheck "textfilecontent54" || exit 255
+
+name=$(basename $0 .sh)
+tmpdir=$(make_temp_dir /tmp ${name})
+tpl=${srcdir}/${name}.xml.tpl
+input=${tmpdir}/${name}.xml
+result=${tmpdir}/${name}.results.xml
+echo "Temp dir: $tmpdir"
+
+# prepare the environment, the file has to be larger than 16 MiB to be
+# matched line by line or memory-mapped instead of being read at once
+sed "s@%PATH%@${tmpdir}@" $tpl > $input
+awk 'BEGIN {
+	for (i = 1; i <= 400000; i++)
+		printf("entry %d lorem ipsum dolor sit amet consectetur\n", i);
+	print "needle_line value=42";
+	print "multi_start";
+	print "multi_end";
+}' > ${tmpdir}/large.log
+
+echo "Evaluating content."
+$OSCAP oval eval --results $result $input
+echo "Validating results."
+$OSCAP oval validate --results $result
+echo "Testing results values."
+[ "$($XPATH $result 'string(/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:1"]/@result)')" == "true" ]
+for i in 1 2 3; do
+	[ "$($XPATH $result 'string(/oval_results/results/system/tests/test[@test_id="oval:x:tst:'$i'"]/@result)')" == "true" ]
+	[ "$($XPATH $result 'string(/oval_results/results/system/oval_system_characteristics/collected_objects/object[@id="oval:x:obj:'$i'"]/@flag)')" == "complete" ]
+done
+
+rm -rf $tmpdir
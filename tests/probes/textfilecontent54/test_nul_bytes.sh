@@ -0,0 +1,40 @@
+#!/usr/bin/env bash
+. $builddir/tests/test_common.sh
+
+set -e -o pipefail
+
+probecheck "textfilecontent54" || exit 255
+
+name=$(basename $0 .sh)
+tmpdir=$(make_temp_dir /tmp ${name})
+tpl=${srcdir}/${name}.xml.tpl
+input=${tmpdir}/${name}.xml
+result=${tmpdir}/${name}.results.xml
+echo "Temp dir: $tmpdir"
+
+# the content after a NUL byte is matched in all reading modes, the small
+# file is read at once, the large file is matched line by line for the
+# line-bound pattern and memory-mapped for the [[:space:]] pattern which
+# can match a newline
+sed "s@%PATH%@${tmpdir}@" $tpl > $input
+printf 'head\0tail_value=7\n' > ${tmpdir}/small.bin
+awk 'BEGIN {
+	for (i = 1; i <= 400000; i++)
+		printf("entry %d lorem ipsum dolor sit amet consectetur\n", i);
+	print "multi_start";
+	print "multi_end";
+}' > ${tmpdir}/large.log
+printf 'large_head\0large_tail=9\n' >> ${tmpdir}/large.log
+
+echo "Evaluating content."
+$OSCAP oval eval --results $result $input
+echo "Validating results."
+$OSCAP oval validate --results $result
+echo "Testing results values."
+[ "$($XPATH $result 'string(/oval_results/results/system/definitions/definition[@definition_id="oval:x:def:1"]/@result)')" == "true" ]
+for i in 1 2 3; do
+	[ "$($XPATH $result 'string(/oval_results/results/system/tests/test[@test_id="oval:x:tst:'$i'"]/@result)')" == "true" ]
+	[ "$($XPATH $result 'string(/oval_results/results/system/oval_system_characteristics/collected_objects/object[@id="oval:x:obj:'$i'"]/@flag)')" == "complete" ]
+done
+
+rm -rf $tmpdir
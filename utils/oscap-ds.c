@@ -49,7 +49,7 @@
 #include <oscap_debug.h>
 #include "oscap_helpers.h"
 
-#define DS_SUBMODULES_NUM 8 /* See actual DS_SUBMODULES array
+#define DS_SUBMODULES_NUM 9 /* See actual DS_SUBMODULES array
 				initialization below. */
 static struct oscap_module* DS_SUBMODULES[DS_SUBMODULES_NUM];
 bool getopt_ds(int argc, char **argv, struct oscap_action *action);
@@ -57,6 +57,7 @@ int app_ds_sds_split(const struct oscap_action *action);
 int app_ds_sds_compose(const struct oscap_action *action);
 int app_ds_sds_add(const struct oscap_action *action);
 int app_ds_sds_validate(const struct oscap_action *action);
+int app_ds_sds_cache(const struct oscap_action *action);
 int app_ds_rds_split(const struct oscap_action *action);
 int app_ds_rds_create(const struct oscap_action *action);
 int app_ds_rds_validate(const struct oscap_action *action);
@@ -123,6 +124,24 @@ static struct oscap_module DS_SDS_VALIDATE_MODULE = {
 	.func = app_ds_sds_validate
 };
 
+static struct oscap_module DS_SDS_CACHE_MODULE = {
+	.name = "sds-cache",
+	.parent = &OSCAP_DS_MODULE,
+	.summary = "Store parsed content of given source data stream in the content cache",
+	.usage = "[options] source_datastream.xml",
+	.help =	"Loads the XCCDF, OVAL and CPE components used for the evaluation of the checklist\n"
+		"so that later runs of oscap with the same cache directory don't have to parse them.\n"
+		"\n"
+		"Options:\n"
+		"   --cache-dir <dir>             - Directory of the cache, defaults to OSCAP_CONTENT_CACHE_DIR.\n"
+		"   --datastream-id <id>          - ID of the data stream in the collection to use.\n"
+		"   --xccdf-id <id>               - ID of XCCDF in the data stream that should be cached.\n"
+		"   --skip-valid                  - Skips validating of given data stream.\n"
+		"   --skip-validation\n",
+	.opt_parser = getopt_ds,
+	.func = app_ds_sds_cache
+};
+
 static struct oscap_module DS_RDS_SPLIT_MODULE = {
 	.name = "rds-split",
 	.parent = &OSCAP_DS_MODULE,
@@ -163,6 +182,7 @@ static struct oscap_module* DS_SUBMODULES[DS_SUBMODULES_NUM] = {
 	&DS_SDS_COMPOSE_MODULE,
 	&DS_SDS_ADD_MODULE,
 	&DS_SDS_VALIDATE_MODULE,
+	&DS_SDS_CACHE_MODULE,
 	&DS_RDS_SPLIT_MODULE,
 	&DS_RDS_CREATE_MODULE,
 	&DS_RDS_VALIDATE_MODULE,
@@ -173,11 +193,13 @@ enum ds_opt {
 	DS_OPT_DATASTREAM_ID = 1,
 	DS_OPT_XCCDF_ID,
 	DS_OPT_REPORT_ID,
-	DS_OPT_LOCAL_FILES
+	DS_OPT_LOCAL_FILES,
+	DS_OPT_CACHE_DIR
 };
 
 bool getopt_ds(int argc, char **argv, struct oscap_action *action) {
 	action->doctype = OSCAP_DOCUMENT_SDS;
+	char *cache_dir = NULL;
 
 	/* Command-options */
 	const struct option long_options[] = {
@@ -189,6 +211,7 @@ bool getopt_ds(int argc, char **argv, struct oscap_action *action) {
 		{"report-id",		required_argument, NULL, DS_OPT_REPORT_ID},
 		{"fetch-remote-resources", no_argument, &action->remote_resources, 1},
 		{"local-files", required_argument, NULL, DS_OPT_LOCAL_FILES},
+		{"cache-dir", required_argument, NULL, DS_OPT_CACHE_DIR},
 	// end
 		{0, 0, 0, 0}
 	};
@@ -203,6 +226,7 @@ bool getopt_ds(int argc, char **argv, struct oscap_action *action) {
 		case DS_OPT_LOCAL_FILES:
 			action->local_files = optarg;
 			break;
+		case DS_OPT_CACHE_DIR: cache_dir = optarg; break;
 		case 0: break;
 		default: return oscap_module_usage(action->module, stderr, NULL);
 		}
@@ -243,6 +267,15 @@ bool getopt_ds(int argc, char **argv, struct oscap_action *action) {
 		action->ds_action = malloc(sizeof(struct ds_action));
 		action->ds_action->file = argv[3];
 	}
+	else if (action->module == &DS_SDS_CACHE_MODULE) {
+		if (optind + 1 != argc) {
+			oscap_module_usage(action->module, stderr, "Wrong number of parameters.\n");
+			return false;
+		}
+		action->ds_action = malloc(sizeof(struct ds_action));
+		action->ds_action->file = argv[optind];
+		action->ds_action->target = cache_dir;
+	}
 	else if (action->module == &DS_RDS_SPLIT_MODULE) {
 		if (optind + 2 != argc) {
 			oscap_module_usage(action->module, stderr, "Wrong number of parameters.\n");
@@ -440,6 +473,42 @@ cleanup:
 	return ret;
 }
 
+int app_ds_sds_cache(const struct oscap_action *action) {
+	int ret = OSCAP_ERROR;
+	struct xccdf_session *session = NULL;
+
+	if (action->ds_action->target != NULL)
+		setenv("OSCAP_CONTENT_CACHE_DIR", action->ds_action->target, 1);
+	const char *cache_dir = getenv("OSCAP_CONTENT_CACHE_DIR");
+	if (cache_dir == NULL || *cache_dir == '\0') {
+		fprintf(stderr, "No cache directory given, use --cache-dir or set OSCAP_CONTENT_CACHE_DIR.\n");
+		goto cleanup;
+	}
+
+	struct oscap_source *source = oscap_source_new_from_file(action->ds_action->file);
+	session = xccdf_session_new_from_source(source);
+	if (session == NULL) {
+		goto cleanup;
+	}
+	xccdf_session_set_validation(session, action->validate, false);
+	xccdf_session_set_datastream_id(session, action->f_datastream_id);
+	xccdf_session_set_component_id(session, action->f_xccdf_id);
+	// The check engine plugins don't parse any content
+	xccdf_session_set_loading_flags(session, XCCDF_SESSION_LOAD_XCCDF | XCCDF_SESSION_LOAD_CPE | XCCDF_SESSION_LOAD_OVAL);
+	if (xccdf_session_load(session) != 0) {
+		goto cleanup;
+	}
+
+	ret = OSCAP_OK;
+
+cleanup:
+	oscap_print_error();
+
+	free(action->ds_action);
+	xccdf_session_free(session);
+	return ret;
+}
+
 int app_ds_rds_split(const struct oscap_action *action) {
 	int ret = OSCAP_ERROR;
 	struct ds_rds_session *session = NULL;
@@ -167,6 +167,8 @@ struct oscap_action {
 	int progress;
 	int oval_results;
 	int without_sys_chars;
+	int without_collection_cache;
+	int oval_pruning;
 	int thin_results;
 	int remediate;
 	char *sce_template;
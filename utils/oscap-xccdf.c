@@ -167,6 +167,8 @@ static struct oscap_module XCCDF_EVAL = {
 		"   --thin-results                - Thin Results provides only minimal amount of information in OVAL/ARF results.\n"
 		"                                   The option --without-syschar is automatically enabled when you use Thin Results.\n"
 		"   --without-syschar             - Don't provide system characteristic in OVAL/ARF result files.\n"
+		"   --no-collection-cache         - Don't use the collection cache set by OSCAP_COLLECTION_CACHE_DIR.\n"
+		"   --oval-pruning                - Drop OVAL definitions not referenced by the selected rules.\n"
 		"   --report <file>               - Write HTML report into file.\n"
 		"   --skip-valid                  - Skip validation.\n"
 		"   --skip-validation\n"
@@ -612,6 +614,10 @@ int app_evaluate_xccdf(const struct oscap_action *action)
 		xccdf_session_set_thin_results(session, true);
 		xccdf_session_set_without_sys_chars_export(session, true);
 	}
+	if (action->without_collection_cache)
+		xccdf_session_set_collection_cache(session, false);
+	if (action->oval_pruning)
+		xccdf_session_set_oval_pruning(session, true);
 	if (xccdf_session_is_sds(session)) {
 		xccdf_session_set_datastream_id(session, action->f_datastream_id);
 		xccdf_session_set_component_id(session, action->f_xccdf_id);
@@ -1263,6 +1269,8 @@ bool getopt_xccdf(int argc, char **argv, struct oscap_action *action)
 		{"skip-schematron",     no_argument, &action->schematron, 0},
 		{"without-syschar",    no_argument, &action->without_sys_chars, 1},
 		{"thin-results",        no_argument, &action->thin_results, 1},
+		{"no-collection-cache", no_argument, &action->without_collection_cache, 1},
+		{"oval-pruning",        no_argument, &action->oval_pruning, 1},
 	// end
 		{0, 0, 0, 0}
 	};